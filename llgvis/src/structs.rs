@@ -3,8 +3,8 @@ use globed_derive::*;
 
 #[derive(Decodable, Clone)]
 pub struct PlayerLogData {
-    pub local_timestamp: f32,
-    pub timestamp: f32,
+    pub local_timestamp: f64,
+    pub timestamp: f64,
     pub position: (f32, f32),
     pub rotation: f32,
 }
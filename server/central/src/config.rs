@@ -165,6 +165,10 @@ pub struct ServerConfig {
     #[serde(default = "default_chat_burst_interval")]
     pub chat_burst_interval: u32,
 
+    // bandwidth
+    #[serde(default = "default_false")]
+    pub quantized_player_data: bool,
+
     // roles
     #[serde(default = "default_roles")]
     pub roles: Vec<ServerRole>,
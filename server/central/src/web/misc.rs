@@ -1,4 +1,9 @@
-use std::{error::Error, io::Cursor, net::IpAddr};
+use std::{
+    error::Error,
+    hash::{DefaultHasher, Hash, Hasher},
+    io::Cursor,
+    net::IpAddr,
+};
 
 use globed_shared::esp::{ByteBuffer, ByteBufferExtRead, ByteBufferExtWrite, Decodable, DecodeError, Encodable};
 use rocket::{
@@ -160,6 +165,53 @@ impl<'r> FromRequest<'r> for CloudflareIPGuard {
     }
 }
 
+// `If-None-Match` header, an etag the client got from an earlier response
+pub struct IfNoneMatchGuard<'r>(pub Option<&'r str>);
+
+#[rocket::async_trait]
+impl<'r> FromRequest<'r> for IfNoneMatchGuard<'r> {
+    type Error = &'static str;
+
+    async fn from_request(request: &'r Request<'_>) -> Outcome<Self, Self::Error> {
+        Outcome::Success(IfNoneMatchGuard(request.headers().get_one("If-None-Match")))
+    }
+}
+
+// Text response tagged with an `ETag` header. If the client already has the same etag,
+// responds with `304 Not Modified` and an empty body instead.
+
+pub struct EtagResponder {
+    body: Option<String>,
+    etag: String,
+}
+
+impl EtagResponder {
+    pub fn new(body: String, if_none_match: Option<&str>) -> Self {
+        let mut hasher = DefaultHasher::new();
+        body.hash(&mut hasher);
+        let etag = format!("\"{:016x}\"", hasher.finish());
+
+        let body = if if_none_match == Some(etag.as_str()) { None } else { Some(body) };
+
+        Self { body, etag }
+    }
+}
+
+#[rocket::async_trait]
+impl<'r> Responder<'r, 'static> for EtagResponder {
+    fn respond_to(self, _: &'r Request<'_>) -> response::Result<'static> {
+        let mut builder = Response::build();
+        builder.raw_header("ETag", self.etag);
+
+        match self.body {
+            Some(body) => builder.header(ContentType::Text).sized_body(body.len(), Cursor::new(body)),
+            None => builder.status(Status::NotModified),
+        };
+
+        builder.ok()
+    }
+}
+
 // Responder wrapper type for types that implement `esp::Encodable`.
 
 pub struct EncodableResponder {
@@ -38,6 +38,7 @@ pub async fn boot(
         admin_webhook_url: config.admin_webhook_url.clone(),
         chat_burst_limit: config.chat_burst_limit,
         chat_burst_interval: config.chat_burst_interval,
+        quantized_player_data: config.quantized_player_data,
         roles: config.roles.clone(),
     };
 
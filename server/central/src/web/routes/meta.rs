@@ -37,7 +37,7 @@ pub fn robots() -> String {
 }
 
 #[get("/servers?<protocol>")]
-pub async fn servers(state: &State<ServerState>, protocol: u16) -> WebResult<String> {
+pub async fn servers(state: &State<ServerState>, protocol: u16, if_none_match: IfNoneMatchGuard<'_>) -> WebResult<EtagResponder> {
     check_maintenance!(state);
     check_protocol!(protocol);
 
@@ -52,7 +52,7 @@ pub async fn servers(state: &State<ServerState>, protocol: u16) -> WebResult<Str
 
     let encoded = b64e::STANDARD.encode(buf.as_bytes());
 
-    Ok(encoded)
+    Ok(EtagResponder::new(encoded, if_none_match.0))
 }
 
 fn _check() -> (Status, (ContentType, String)) {
@@ -35,6 +35,7 @@ pub enum DecodeError {
     InvalidStringValue,
     NonFiniteValue,
     ChecksumMismatch,
+    InvalidVarint,
 }
 
 impl Display for DecodeError {
@@ -46,6 +47,7 @@ impl Display for DecodeError {
             Self::InvalidStringValue => f.write_str("invalid string was passed, likely not properly UTF-8 encoded"),
             Self::NonFiniteValue => f.write_str("NaN or inf was passed as a data field expecting a finite f32 or f64 value"),
             Self::ChecksumMismatch => f.write_str("data checksum was invalid"),
+            Self::InvalidVarint => f.write_str("varint was longer than 10 bytes"),
         }
     }
 }
@@ -472,6 +474,54 @@ mod tests {
         assert_eq!(out.unwrap(), string);
     }
 
+    #[test]
+    fn varint() {
+        let unsigned = [0u64, 1, 127, 128, 300, 16_384, u64::from(u32::MAX), u64::MAX];
+        let signed = [0i64, 1, -1, 63, -64, 64, -65, 128_000_000, i64::MIN, i64::MAX];
+
+        let mut buf = ByteBuffer::new();
+        for &x in &unsigned {
+            buf.write_value(&VarUint(x));
+        }
+
+        for &x in &signed {
+            buf.write_value(&VarInt(x));
+        }
+
+        let expected_len: usize = unsigned.iter().map(|&x| VarUint(x).encoded_size()).sum::<usize>()
+            + signed.iter().map(|&x| VarInt(x).encoded_size()).sum::<usize>();
+        assert_eq!(buf.len(), expected_len);
+
+        assert_eq!(VarUint(127).encoded_size(), 1);
+        assert_eq!(VarUint(128).encoded_size(), 2);
+        assert_eq!(VarInt(-64).encoded_size(), 1);
+        assert_eq!(VarUint(u64::MAX).encoded_size(), 10);
+
+        buf.set_rpos(0);
+        for &x in &unsigned {
+            assert_eq!(buf.read_value::<VarUint>().unwrap().get(), x);
+        }
+
+        for &x in &signed {
+            assert_eq!(buf.read_value::<VarInt>().unwrap().get(), x);
+        }
+
+        // 11 bytes with the continuation bit set
+        let mut buf = ByteBuffer::from_bytes(&[0xff; 11]);
+        assert!(buf.read_value::<VarUint>().is_err());
+
+        // 10 bytes, but the last one has bits past the 64th set
+        let mut overflowing = [0xff; 10];
+        overflowing[9] = 0x02;
+        let mut buf = ByteBuffer::from_bytes(&overflowing);
+        assert!(buf.read_value::<VarUint>().is_err());
+
+        // the largest value that still fits
+        overflowing[9] = 0x01;
+        let mut buf = ByteBuffer::from_bytes(&overflowing);
+        assert_eq!(buf.read_value::<VarUint>().unwrap().get(), u64::MAX);
+    }
+
     #[test]
     fn checksum() {
         let mut buf = ByteBuffer::new();
@@ -3,6 +3,13 @@ use crate::*;
 #[derive(Copy, Clone, Default, Debug)]
 pub struct FiniteF32(f32);
 
+impl FiniteF32 {
+    #[inline]
+    pub const fn get(self) -> f32 {
+        self.0
+    }
+}
+
 impl Encodable for FiniteF32 {
     fn encode(&self, buf: &mut ByteBuffer) {
         buf.write_f32(self.0);
@@ -58,6 +65,13 @@ impl Display for FiniteF32 {
 #[derive(Copy, Clone, Default, Debug)]
 pub struct FiniteF64(f64);
 
+impl FiniteF64 {
+    #[inline]
+    pub const fn get(self) -> f64 {
+        self.0
+    }
+}
+
 impl Encodable for FiniteF64 {
     fn encode(&self, buf: &mut ByteBuffer) {
         buf.write_f64(self.0);
@@ -5,6 +5,7 @@ mod fast_vec;
 mod finite;
 mod inline_string;
 mod remainder_bytes;
+mod varint;
 
 pub use bits::Bits;
 pub use either::Either;
@@ -13,3 +14,4 @@ pub use fast_vec::FastVec;
 pub use finite::{FiniteF32, FiniteF64};
 pub use inline_string::InlineString;
 pub use remainder_bytes::RemainderBytes;
+pub use varint::{VarInt, VarUint};
@@ -0,0 +1,173 @@
+use crate::*;
+
+/// max amount of bytes a LEB128-encoded `u64` can take up
+const MAX_VARINT_SIZE: usize = 10;
+
+/// Unsigned integer encoded as a LEB128 varint, 7 bits per byte. Small values take up less space,
+/// for example anything below 128 is a single byte, at the cost of up to 10 bytes for the largest values.
+#[derive(Copy, Clone, Default, Debug, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct VarUint(pub u64);
+
+/// Signed integer, zigzag encoded (so small negative values stay small) and then written as a `VarUint`.
+#[derive(Copy, Clone, Default, Debug, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct VarInt(pub i64);
+
+impl VarUint {
+    #[inline]
+    pub const fn get(self) -> u64 {
+        self.0
+    }
+
+    #[inline]
+    const fn encoded_len(value: u64) -> usize {
+        // each byte holds 7 bits, zero still takes up one byte
+        let bits = 64 - (value | 1).leading_zeros() as usize;
+        bits.div_ceil(7)
+    }
+}
+
+impl VarInt {
+    #[inline]
+    pub const fn get(self) -> i64 {
+        self.0
+    }
+
+    #[inline]
+    const fn zigzag(value: i64) -> u64 {
+        ((value << 1) ^ (value >> 63)) as u64
+    }
+
+    #[inline]
+    const fn unzigzag(value: u64) -> i64 {
+        ((value >> 1) as i64) ^ -((value & 1) as i64)
+    }
+}
+
+macro_rules! write_varint {
+    ($buf:expr, $value:expr) => {{
+        let mut value: u64 = $value;
+        while value >= 0x80 {
+            $buf.write_u8((value as u8) | 0x80);
+            value >>= 7;
+        }
+
+        $buf.write_u8(value as u8);
+    }};
+}
+
+macro_rules! read_varint {
+    ($buf:expr) => {{
+        let mut value = 0u64;
+        let mut result = Err(DecodeError::InvalidVarint);
+
+        for i in 0..MAX_VARINT_SIZE {
+            let byte = $buf.read_u8()?;
+
+            // the 10th byte only has room for the top bit of a u64, anything more would overflow
+            if i == MAX_VARINT_SIZE - 1 && byte > 1 {
+                break;
+            }
+
+            value |= u64::from(byte & 0x7f) << (i * 7);
+
+            if byte & 0x80 == 0 {
+                result = Ok(value);
+                break;
+            }
+        }
+
+        result
+    }};
+}
+
+impl Encodable for VarUint {
+    fn encode(&self, buf: &mut ByteBuffer) {
+        write_varint!(buf, self.0);
+    }
+
+    fn encode_fast(&self, buf: &mut FastByteBuffer) {
+        write_varint!(buf, self.0);
+    }
+}
+
+impl Decodable for VarUint {
+    fn decode(buf: &mut ByteBuffer) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        read_varint!(buf).map(Self)
+    }
+
+    fn decode_from_reader(buf: &mut ByteReader) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        read_varint!(buf).map(Self)
+    }
+}
+
+impl DynamicSize for VarUint {
+    fn encoded_size(&self) -> usize {
+        Self::encoded_len(self.0)
+    }
+}
+
+impl Encodable for VarInt {
+    fn encode(&self, buf: &mut ByteBuffer) {
+        write_varint!(buf, Self::zigzag(self.0));
+    }
+
+    fn encode_fast(&self, buf: &mut FastByteBuffer) {
+        write_varint!(buf, Self::zigzag(self.0));
+    }
+}
+
+impl Decodable for VarInt {
+    fn decode(buf: &mut ByteBuffer) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        read_varint!(buf).map(|x| Self(Self::unzigzag(x)))
+    }
+
+    fn decode_from_reader(buf: &mut ByteReader) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        read_varint!(buf).map(|x| Self(Self::unzigzag(x)))
+    }
+}
+
+impl DynamicSize for VarInt {
+    fn encoded_size(&self) -> usize {
+        VarUint::encoded_len(Self::zigzag(self.0))
+    }
+}
+
+macro_rules! impl_from {
+    ($wrapper:ident, $inner:ty, $($t:ty),*) => {
+        $(
+            impl From<$t> for $wrapper {
+                #[inline]
+                fn from(value: $t) -> Self {
+                    Self(<$inner>::from(value))
+                }
+            }
+        )*
+    };
+}
+
+impl_from!(VarUint, u64, u8, u16, u32, u64);
+impl_from!(VarInt, i64, i8, i16, i32, i64);
+
+impl Display for VarUint {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(f, "{}", self.0)
+    }
+}
+
+impl Display for VarInt {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(f, "{}", self.0)
+    }
+}
@@ -1,8 +1,15 @@
 #![allow(clippy::wildcard_imports, clippy::cast_possible_truncation)]
 use criterion::{black_box, criterion_group, criterion_main, Criterion};
 use esp::{ByteBuffer, ByteReader};
-use globed_game_server::{data::*, make_uninit, managers::LevelManager, new_uninit};
+use globed_game_server::{
+    client::{SessionBox, SessionCipher},
+    data::*,
+    make_uninit,
+    managers::LevelManager,
+    new_uninit,
+};
 use globed_shared::{
+    crypto_box::{aead::OsRng, ChaChaBox, SecretKey},
     generate_alphanum_string,
     rand::{self, Rng, RngCore},
 };
@@ -254,6 +261,88 @@ fn strings(c: &mut Criterion) {
     });
 }
 
-// criterion_group!(benches, buffers, structs, managers, read_value_array, strings);
-criterion_group!(benches, strings);
+fn level_data(c: &mut Criterion) {
+    const PLAYERS: usize = 100;
+
+    let players: Vec<AssociatedPlayerData> = (0..PLAYERS)
+        .map(|i| AssociatedPlayerData {
+            account_id: i as i32,
+            data: PlayerData::default(),
+        })
+        .collect();
+
+    let anchor = Point::default();
+
+    let encode_full = |buf: &mut ByteBuffer| {
+        buf.write_value(&players);
+    };
+
+    let encode_quantized = |buf: &mut ByteBuffer| {
+        buf.write_value(&anchor);
+        buf.write_length(players.len());
+        for player in &players {
+            buf.write_value(&QuantizedPlayerData {
+                anchor,
+                account_id: player.account_id,
+                data: &player.data,
+            });
+        }
+    };
+
+    let mut full = ByteBuffer::new();
+    encode_full(&mut full);
+    let mut quantized = ByteBuffer::new();
+    encode_quantized(&mut quantized);
+
+    println!(
+        "level data bytes per player: full {:.1}, quantized {:.1}",
+        full.len() as f64 / PLAYERS as f64,
+        quantized.len() as f64 / PLAYERS as f64
+    );
+
+    c.bench_function("encode-level-data-full", |b| {
+        b.iter(black_box(|| {
+            let mut buf = ByteBuffer::with_capacity(full.len());
+            encode_full(&mut buf);
+        }));
+    });
+
+    c.bench_function("encode-level-data-quantized", |b| {
+        b.iter(black_box(|| {
+            let mut buf = ByteBuffer::with_capacity(quantized.len());
+            encode_quantized(&mut buf);
+        }));
+    });
+}
+
+fn crypto(c: &mut Criterion) {
+    let client_key = SecretKey::generate(&mut OsRng);
+    let server_key = SecretKey::generate(&mut OsRng);
+    let cbox = ChaChaBox::new(&client_key.public_key(), &server_key);
+
+    let mut ciphers = vec![("xchacha20poly1305", SessionCipher::XChaCha20Poly1305)];
+    if SessionCipher::has_hardware_aes() {
+        ciphers.push(("aes256gcm", SessionCipher::Aes256Gcm));
+    }
+
+    // a typical voice packet and a big one
+    for size in [1024usize, 16384] {
+        let mut data = vec![0u8; SessionBox::PREFIX_SIZE + size];
+        rand::thread_rng().fill_bytes(&mut data);
+
+        for (name, cipher) in &ciphers {
+            let mut sbox = SessionBox::from_crypto_box(&cbox, *cipher).unwrap();
+
+            c.bench_function(&format!("session-encrypt-{name}-{size}"), |b| {
+                b.iter(|| {
+                    let (prefix, message) = data.split_at_mut(SessionBox::PREFIX_SIZE);
+                    sbox.encrypt_in_place(prefix, black_box(message)).unwrap();
+                });
+            });
+        }
+    }
+}
+
+// criterion_group!(benches, buffers, structs, managers, read_value_array, strings, level_data, crypto);
+criterion_group!(benches, strings, level_data, crypto);
 criterion_main!(benches);
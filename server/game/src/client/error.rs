@@ -8,6 +8,8 @@ pub enum PacketHandlingError {
     WrongCryptoBoxState,                   // cryptobox was either Some or None when should've been the other one
     EncryptionError,                       // failed to encrypt data
     DecryptionError,                       // failed to decrypt data
+    CompressionError,                      // failed to compress data
+    UnexpectedCompression,                 // client sent a compressed packet, only the server compresses packets
     IOError(std::io::Error),               // generic IO error
     MalformedMessage,                      // packet is missing a header
     MalformedLoginAttempt,                 // LoginPacket with cleartext credentials
@@ -75,6 +77,8 @@ impl Display for PacketHandlingError {
             Self::WrongCryptoBoxState => f.write_str("wrong crypto box state for the given operation"),
             Self::EncryptionError => f.write_str("Encryption failed"),
             Self::DecryptionError => f.write_str("Decryption failed"),
+            Self::CompressionError => f.write_str("Compression failed"),
+            Self::UnexpectedCompression => f.write_str("client sent a compressed packet"),
             Self::MalformedCiphertext => f.write_str("malformed ciphertext in an encrypted packet"),
             Self::MalformedMessage => f.write_str("malformed message structure"),
             Self::MalformedLoginAttempt => f.write_str("malformed login attempt"),
@@ -1,5 +1,6 @@
 pub mod error;
 pub mod macros;
+pub mod session_box;
 pub mod socket;
 pub mod state;
 pub mod thread;
@@ -7,6 +8,7 @@ pub mod unauthorized;
 
 pub use error::{PacketHandlingError, Result};
 pub use macros::*;
+pub use session_box::{SessionBox, SessionCipher};
 pub use socket::ClientSocket;
 pub use state::{AtomicClientThreadState, ClientThreadState};
 pub use thread::{ClientThread, ServerThreadMessage};
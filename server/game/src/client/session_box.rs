@@ -0,0 +1,202 @@
+use globed_shared::{
+    aes_gcm::Aes256Gcm,
+    crypto_box::{aead::AeadInPlace, ChaChaBox},
+    crypto_secretbox::{aead::KeyInit, XChaCha20Poly1305},
+};
+
+use super::error::{PacketHandlingError, Result};
+
+/// must match `SESSION_KEY_NONCE` in the client
+const SESSION_KEY_NONCE: [u8; 24] = *b"globed session key\0\0\0\0\0\0";
+
+// must match the client
+const DIRECTION_CLIENT: u8 = 1;
+const DIRECTION_SERVER: u8 = 2;
+
+const KEY_SIZE: usize = 32;
+const COUNTER_SIZE: usize = 4;
+const MAC_SIZE: usize = 16;
+
+/// packets with a counter this far behind the newest one are rejected
+const REPLAY_WINDOW: u32 = 64;
+
+/// must match `SessionCipher` in the client, values are also bit indices in the mask the client sends in the handshake
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+#[repr(u8)]
+pub enum SessionCipher {
+    XChaCha20Poly1305 = 0,
+    Aes256Gcm = 1,
+}
+
+impl SessionCipher {
+    /// picks AES-GCM if both the client and this machine can run it in hardware, otherwise XChaCha20-Poly1305
+    pub fn negotiate(client_ciphers: u8) -> Self {
+        if client_ciphers & (1 << Self::Aes256Gcm as u8) != 0 && Self::has_hardware_aes() {
+            Self::Aes256Gcm
+        } else {
+            Self::XChaCha20Poly1305
+        }
+    }
+
+    /// without hardware support, the software AES fallback is a lot slower than chacha
+    pub fn has_hardware_aes() -> bool {
+        #[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
+        return std::is_x86_feature_detected!("aes") && std::is_x86_feature_detected!("pclmulqdq");
+
+        #[cfg(target_arch = "aarch64")]
+        return std::arch::is_aarch64_feature_detected!("aes") && std::arch::is_aarch64_feature_detected!("pmull");
+
+        #[allow(unreachable_code)]
+        false
+    }
+}
+
+enum SessionAead {
+    XChaCha20Poly1305(XChaCha20Poly1305),
+    Aes256Gcm(Aes256Gcm),
+}
+
+/// Symmetric box used for encrypted UDP packets instead of the `ChaChaBox`, with either XChaCha20-Poly1305 or AES-256-GCM.
+/// The nonce is made from the sending direction and a counter, and only the counter is sent over the wire,
+/// so the prefix is `[counter: u32 BE][mac: 16 bytes]` instead of a random 24-byte nonce and the mac.
+pub struct SessionBox {
+    aead: SessionAead,
+    send_direction: u8,
+    recv_direction: u8,
+    send_counter: u32,
+    /// bit `i` is set if the packet `highest_received - i` was received
+    received_mask: u64,
+    highest_received: u32,
+}
+
+impl SessionBox {
+    pub const PREFIX_SIZE: usize = COUNTER_SIZE + MAC_SIZE;
+
+    /// derives the session key from the handshake box, same as `CryptoBox::deriveSessionKey` in the client
+    pub fn from_crypto_box(cbox: &ChaChaBox, cipher: SessionCipher) -> Result<Self> {
+        Self::with_directions(cbox, cipher, DIRECTION_SERVER, DIRECTION_CLIENT)
+    }
+
+    /// the client end of the same session, for tools that talk to the server like a game client (see `globed-loadtest`)
+    pub fn from_crypto_box_client(cbox: &ChaChaBox, cipher: SessionCipher) -> Result<Self> {
+        Self::with_directions(cbox, cipher, DIRECTION_CLIENT, DIRECTION_SERVER)
+    }
+
+    fn with_directions(cbox: &ChaChaBox, cipher: SessionCipher, send_direction: u8, recv_direction: u8) -> Result<Self> {
+        // the key is the encryption of zeroes with a reserved nonce, regular packets always use random nonces
+        let mut key = [0u8; KEY_SIZE];
+        cbox.encrypt_in_place_detached(&SESSION_KEY_NONCE.into(), b"", &mut key)
+            .map_err(|_| PacketHandlingError::EncryptionError)?;
+
+        let aead = match cipher {
+            SessionCipher::XChaCha20Poly1305 => SessionAead::XChaCha20Poly1305(XChaCha20Poly1305::new(&key.into())),
+            SessionCipher::Aes256Gcm => SessionAead::Aes256Gcm(Aes256Gcm::new(&key.into())),
+        };
+
+        Ok(Self {
+            aead,
+            send_direction,
+            recv_direction,
+            send_counter: 0,
+            received_mask: 0,
+            highest_received: 0,
+        })
+    }
+
+    /// `[direction, 0 ..., counter (big endian)]`, 24 bytes for XChaCha20 and 12 for AES-GCM
+    fn make_nonce<const N: usize>(direction: u8, counter: u32) -> [u8; N] {
+        let mut nonce = [0u8; N];
+        nonce[0] = direction;
+        nonce[N - COUNTER_SIZE..].copy_from_slice(&counter.to_be_bytes());
+        nonce
+    }
+
+    pub fn cipher(&self) -> SessionCipher {
+        match self.aead {
+            SessionAead::XChaCha20Poly1305(_) => SessionCipher::XChaCha20Poly1305,
+            SessionAead::Aes256Gcm(_) => SessionCipher::Aes256Gcm,
+        }
+    }
+
+    /// encrypts `message` in place, and writes the counter and the mac into `prefix` (must be `PREFIX_SIZE` bytes long)
+    pub fn encrypt_in_place(&mut self, prefix: &mut [u8], message: &mut [u8]) -> Result<()> {
+        let counter = self.send_counter;
+
+        // wrapping around would reuse nonces
+        self.send_counter = counter.checked_add(1).ok_or(PacketHandlingError::EncryptionError)?;
+
+        let tag = match &self.aead {
+            SessionAead::XChaCha20Poly1305(aead) => {
+                aead.encrypt_in_place_detached(&Self::make_nonce::<24>(self.send_direction, counter).into(), b"", message)
+            }
+            SessionAead::Aes256Gcm(aead) => {
+                aead.encrypt_in_place_detached(&Self::make_nonce::<12>(self.send_direction, counter).into(), b"", message)
+            }
+        }
+        .map_err(|_| PacketHandlingError::EncryptionError)?;
+
+        prefix[..COUNTER_SIZE].copy_from_slice(&counter.to_be_bytes());
+        prefix[COUNTER_SIZE..Self::PREFIX_SIZE].copy_from_slice(&tag);
+
+        Ok(())
+    }
+
+    /// decrypts the message in place, `data` must start with the prefix. returns the plaintext,
+    /// or `None` if the packet was already received or is too old.
+    pub fn decrypt_in_place<'a>(&mut self, data: &'a mut [u8]) -> Result<Option<&'a [u8]>> {
+        if data.len() < Self::PREFIX_SIZE {
+            return Err(PacketHandlingError::MalformedCiphertext);
+        }
+
+        let (prefix, message) = data.split_at_mut(Self::PREFIX_SIZE);
+
+        let mut counter = [0u8; COUNTER_SIZE];
+        counter.copy_from_slice(&prefix[..COUNTER_SIZE]);
+        let counter = u32::from_be_bytes(counter);
+
+        if self.is_replay(counter) {
+            return Ok(None);
+        }
+
+        let mut mac = [0u8; MAC_SIZE];
+        mac.copy_from_slice(&prefix[COUNTER_SIZE..]);
+
+        match &self.aead {
+            SessionAead::XChaCha20Poly1305(aead) => {
+                aead.decrypt_in_place_detached(&Self::make_nonce::<24>(self.recv_direction, counter).into(), b"", message, &mac.into())
+            }
+            SessionAead::Aes256Gcm(aead) => {
+                aead.decrypt_in_place_detached(&Self::make_nonce::<12>(self.recv_direction, counter).into(), b"", message, &mac.into())
+            }
+        }
+        .map_err(|_| PacketHandlingError::DecryptionError)?;
+
+        // only remember the counter once we know the packet is genuine
+        self.mark_received(counter);
+
+        Ok(Some(message))
+    }
+
+    fn is_replay(&self, counter: u32) -> bool {
+        if self.received_mask == 0 || counter > self.highest_received {
+            return false;
+        }
+
+        let age = self.highest_received - counter;
+        age >= REPLAY_WINDOW || (self.received_mask >> age) & 1 != 0
+    }
+
+    fn mark_received(&mut self, counter: u32) {
+        if self.received_mask == 0 {
+            self.highest_received = counter;
+            self.received_mask = 1;
+        } else if counter > self.highest_received {
+            let shift = counter - self.highest_received;
+            self.received_mask = if shift >= REPLAY_WINDOW { 0 } else { self.received_mask << shift };
+            self.received_mask |= 1;
+            self.highest_received = counter;
+        } else {
+            self.received_mask |= 1u64 << (self.highest_received - counter);
+        }
+    }
+}
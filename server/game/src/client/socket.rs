@@ -22,6 +22,7 @@ use globed_shared::{
 use super::{
     error::{PacketHandlingError, Result},
     macros::*,
+    session_box::{SessionBox, SessionCipher},
 };
 use crate::{data::*, server::GameServer};
 
@@ -31,6 +32,8 @@ pub struct ClientSocket {
     pub tcp_peer: SocketAddrV4,
     pub udp_peer: Option<SocketAddrV4>,
     crypto_box: OnceLock<ChaChaBox>,
+    /// used for encrypted udp packets instead of `crypto_box`, if the client supports it
+    session_box: Option<SessionBox>,
     game_server: &'static GameServer,
 }
 
@@ -38,6 +41,9 @@ pub struct ClientSocket {
 const NONCE_SIZE: usize = 24;
 const MAC_SIZE: usize = 16;
 
+/// tcp packets that are at least this big get compressed with lz4 before encryption
+const COMPRESSION_THRESHOLD: usize = 8192;
+
 const MAX_PACKET_SIZE: usize = 65536;
 pub const INLINE_BUFFER_SIZE: usize = 164;
 
@@ -48,6 +54,7 @@ impl ClientSocket {
             tcp_peer,
             udp_peer: None,
             crypto_box: OnceLock::new(),
+            session_box: None,
             game_server,
         }
     }
@@ -101,6 +108,20 @@ impl ClientSocket {
         Ok(())
     }
 
+    /// must be called after `init_crypto_box`
+    pub fn init_session_box(&mut self, cipher: SessionCipher) -> Result<()> {
+        let cbox = self.crypto_box.get().ok_or(PacketHandlingError::WrongCryptoBoxState)?;
+        self.session_box = Some(SessionBox::from_crypto_box(cbox, cipher)?);
+
+        Ok(())
+    }
+
+    /// bytes an encrypted udp packet takes up besides its body: the header, and then either the counter + mac of the
+    /// session box or the nonce + mac of the crypto box
+    pub fn encrypted_udp_overhead(&self) -> usize {
+        PacketHeader::SIZE + if self.session_box.is_some() { SessionBox::PREFIX_SIZE } else { NONCE_SIZE + MAC_SIZE }
+    }
+
     pub fn set_udp_peer(&mut self, udp_peer: SocketAddrV4) {
         self.udp_peer.replace(udp_peer);
     }
@@ -136,6 +157,19 @@ impl ClientSocket {
         Ok(ByteReader::from_bytes(&message[ciphertext_start..]))
     }
 
+    /// decrypts a udp packet, using the session box if there is one. returns `None` if the packet is a duplicate.
+    pub fn decrypt_udp<'a>(&mut self, message: &'a mut [u8]) -> Result<Option<ByteReader<'a>>> {
+        let Some(sbox) = self.session_box.as_mut() else {
+            return self.decrypt(message).map(Some);
+        };
+
+        if message.len() < PacketHeader::SIZE {
+            return Err(PacketHandlingError::MalformedCiphertext);
+        }
+
+        Ok(sbox.decrypt_in_place(&mut message[PacketHeader::SIZE..])?.map(ByteReader::from_bytes))
+    }
+
     // packet encoding and sending functions
 
     #[cfg(debug_assertions)]
@@ -189,13 +223,20 @@ impl ClientSocket {
             self.print_packet::<P>(true, Some(if P::ENCRYPTED { "fast + encrypted" } else { "fast" }));
         }
 
+        if P::SHOULD_USE_TCP && packet_size >= COMPRESSION_THRESHOLD {
+            return self.send_packet_compressed::<P, _>(packet_size, encode_fn).await;
+        }
+
         if P::ENCRYPTED {
             // gs_inline_encode! doesn't work here because the borrow checker is silly :(
             let header_start = if P::SHOULD_USE_TCP { size_of_types!(u32) } else { 0usize };
 
+            // udp packets use the smaller counter prefix if the client supports it
+            let session = !P::SHOULD_USE_TCP && self.session_box.is_some();
+
             let nonce_start = header_start + PacketHeader::SIZE;
             let mac_start = nonce_start + NONCE_SIZE;
-            let raw_data_start = mac_start + MAC_SIZE;
+            let raw_data_start = if session { nonce_start + SessionBox::PREFIX_SIZE } else { mac_start + MAC_SIZE };
             let total_size = raw_data_start + packet_size;
 
             gs_alloca_check_size!(total_size);
@@ -218,20 +259,25 @@ impl ClientSocket {
                 // if the written size isn't equal to `packet_size`, we use buffer length instead
                 let raw_data_end = raw_data_start + buf.len();
 
-                // this unwrap is safe, as an encrypted packet can only be sent downstream after the handshake is established.
-                let cbox = self.crypto_box.get().unwrap();
+                if session {
+                    let (prefix, message) = data[nonce_start..raw_data_end].split_at_mut(SessionBox::PREFIX_SIZE);
+                    self.session_box.as_mut().unwrap().encrypt_in_place(prefix, message)?;
+                } else {
+                    // this unwrap is safe, as an encrypted packet can only be sent downstream after the handshake is established.
+                    let cbox = self.crypto_box.get().unwrap();
 
-                // encrypt in place
-                let nonce = ChaChaBox::generate_nonce(&mut OsRng);
-                let tag = cbox
-                    .encrypt_in_place_detached(&nonce, b"", &mut data[raw_data_start..raw_data_end])
-                    .map_err(|_| PacketHandlingError::EncryptionError)?;
+                    // encrypt in place
+                    let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+                    let tag = cbox
+                        .encrypt_in_place_detached(&nonce, b"", &mut data[raw_data_start..raw_data_end])
+                        .map_err(|_| PacketHandlingError::EncryptionError)?;
 
-                // prepend the nonces
-                data[nonce_start..mac_start].copy_from_slice(nonce.as_slice());
+                    // prepend the nonces
+                    data[nonce_start..mac_start].copy_from_slice(nonce.as_slice());
 
-                // prepend the mac tag
-                data[mac_start..raw_data_start].copy_from_slice(&tag);
+                    // prepend the mac tag
+                    data[mac_start..raw_data_start].copy_from_slice(&tag);
+                }
 
                 if P::SHOULD_USE_TCP {
                     // write total packet length
@@ -285,6 +331,74 @@ impl ClientSocket {
         Ok(())
     }
 
+    /// version of `send_packet_alloca_with` for big tcp packets. the packet is encoded on the heap and compressed with lz4,
+    /// and the compressed data is prefixed with the uncompressed size (u32) and then encrypted like in any other packet.
+    /// if compression doesn't make the packet any smaller, it is sent uncompressed instead.
+    async fn send_packet_compressed<P: Packet, F>(&mut self, packet_size: usize, encode_fn: F) -> Result<()>
+    where
+        F: FnOnce(&mut FastByteBuffer),
+    {
+        let mut raw = vec![0u8; packet_size];
+        let mut buf = FastByteBuffer::new(&mut raw);
+        encode_fn(&mut buf);
+
+        let raw_len = buf.len();
+        raw.truncate(raw_len);
+
+        let header_start = size_of_types!(u32);
+        let payload_start = header_start + PacketHeader::SIZE + if P::ENCRYPTED { NONCE_SIZE + MAC_SIZE } else { 0 };
+        let compressed_start = payload_start + size_of_types!(u32);
+
+        let mut data = vec![0u8; compressed_start + lz4_flex::block::get_maximum_output_size(raw_len)];
+
+        let compressed_len = lz4_flex::block::compress_into(&raw, &mut data[compressed_start..])
+            .map_err(|_| PacketHandlingError::CompressionError)?;
+
+        let compressed = size_of_types!(u32) + compressed_len < raw_len;
+
+        let payload_end = if compressed {
+            data[payload_start..compressed_start].copy_from_slice(&(raw_len as u32).to_be_bytes());
+            compressed_start + compressed_len
+        } else {
+            data[payload_start..payload_start + raw_len].copy_from_slice(&raw);
+            payload_start + raw_len
+        };
+
+        data.truncate(payload_end);
+
+        let mut buf = FastByteBuffer::new(&mut data[header_start..payload_start]);
+        let mut header = PacketHeader::from_packet::<P>();
+        if compressed {
+            header.flags |= PacketHeader::FLAG_COMPRESSED;
+        }
+
+        buf.write_value(&header);
+
+        if P::ENCRYPTED {
+            let nonce_start = header_start + PacketHeader::SIZE;
+            let mac_start = nonce_start + NONCE_SIZE;
+
+            // this unwrap is safe, as an encrypted packet can only be sent downstream after the handshake is established.
+            let cbox = self.crypto_box.get().unwrap();
+
+            let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+            let tag = cbox
+                .encrypt_in_place_detached(&nonce, b"", &mut data[payload_start..])
+                .map_err(|_| PacketHandlingError::EncryptionError)?;
+
+            data[nonce_start..mac_start].copy_from_slice(nonce.as_slice());
+            data[mac_start..payload_start].copy_from_slice(&tag);
+        }
+
+        let packet_len = (data.len() - header_start) as u32;
+        data[..header_start].copy_from_slice(&packet_len.to_be_bytes());
+
+        self.send_buffer_tcp(&data).await?;
+        self.socket.flush().await?;
+
+        Ok(())
+    }
+
     /// sends a buffer to our peer via the tcp socket
     async fn send_buffer_tcp(&mut self, buffer: &[u8]) -> Result<()> {
         let result = tokio::time::timeout(Duration::from_secs(5), self.socket.write_all(buffer)).await;
@@ -4,7 +4,7 @@ use std::{
     net::SocketAddrV4,
     sync::{
         atomic::{AtomicBool, AtomicI32, AtomicU16, AtomicU32, Ordering},
-        Arc,
+        Arc, Weak,
     },
     time::Duration,
 };
@@ -14,13 +14,13 @@ use crate::tokio::{
     sync::{Mutex, Notify},
 };
 use esp::ByteReader;
-use globed_shared::{logger::*, SyncMutex, UserEntry};
-use handlers::game::MAX_VOICE_PACKET_SIZE;
+use globed_shared::{logger::*, IntMap, SyncMutex, UserEntry};
+use handlers::game::{MAX_LINKED_TPS, MAX_VOICE_PACKET_SIZE, VOICE_BUNDLE_DATAGRAM_SIZE};
 use tokio::time::Instant;
 
 use crate::{
     data::*,
-    managers::ComputedRole,
+    managers::{ComputedRole, LevelManager},
     server::GameServer,
     util::{LockfreeMutCell, SimpleRateLimiter},
 };
@@ -31,6 +31,8 @@ pub mod handlers;
 
 pub const INLINE_BUFFER_SIZE: usize = 164;
 pub const THREAD_MICRO_TIMEOUT: Duration = Duration::from_secs(30);
+/// how often subscribed player counts are checked for changes
+pub const PLAYER_COUNT_PUSH_INTERVAL: Duration = Duration::from_secs(2);
 
 #[derive(Clone)]
 pub enum ServerThreadMessage {
@@ -41,6 +43,9 @@ pub enum ServerThreadMessage {
     BroadcastNotice(ServerNoticePacket),
     BroadcastInvite(RoomInvitePacket),
     BroadcastRoomInfo(RoomInfoPacket),
+    BroadcastRoomPlayersDiff(Arc<RoomPlayersDiffPacket>),
+    BroadcastPlayerMetadata(Arc<LevelPlayerMetadataPacket>),
+    BroadcastLinkedPlayerData(LinkedPlayerDataBroadcastPacket),
     BroadcastBan(ServerBannedPacket),
     BroadcastMute(ServerMutedPacket),
     BroadcastRoleChange(RolesUpdatedPacket),
@@ -66,15 +71,116 @@ pub struct ClientThread {
 
     pub is_authorized_admin: AtomicBool,
 
+    /// whether to send `QuantizedLevelDataPacket` instead of `LevelDataPacket`
+    quantized_player_data: bool,
+
+    /// area of the level the client can see, players outside of it are sent less often
+    interest_area: LockfreeMutCell<Option<InterestArea>>,
+    /// amount of level data responses sent, used to pace updates of far away players
+    level_data_counter: AtomicU32,
+    /// sequence number of the next level data datagram, shared by `LevelDataPacket` and `QuantizedLevelDataPacket`
+    level_data_sequence: AtomicU32,
+    /// timestamps in level data packets are relative to this
+    stream_epoch: Instant,
+
+    /// whether the client got the metadata of everyone on its current level, after that only changes are sent
+    level_metadata_synced: AtomicBool,
+    /// tps from the server config, and the tps that was last sent in `LevelTpsPacket` (0 if none since joining the level)
+    server_tps: u32,
+    level_tps: AtomicU32,
+    /// proximity voice range from `VoiceProximityPacket` as f32 bits, 0 if the client hears everyone on the level
+    voice_range: AtomicU32,
+
+    /// last `PlayerDataDeltaPacket` keyframe (id and the decoded data)
+    player_data_keyframe: LockfreeMutCell<Option<(u8, PlayerData)>>,
+    /// player from `LinkPlayerPacket`, `LinkedPlayerDataPacket` is forwarded only to them
+    linked_player: SyncMutex<Option<Weak<ClientThread>>>,
+
+    /// levels from `SubscribePlayerCountsPacket`, with the counts that were last sent for them
+    player_count_subscription: LockfreeMutCell<PlayerCountSubscription>,
+    level_list_snapshot: LockfreeMutCell<LevelListSnapshot>,
+
     message_queue: Mutex<VecDeque<ServerThreadMessage>>,
     message_notify: Notify,
     rate_limiter: LockfreeMutCell<SimpleRateLimiter>,
     voice_rate_limiter: LockfreeMutCell<SimpleRateLimiter>,
+    /// the linked stream is faster than everything else, so it's limited separately
+    link_rate_limiter: LockfreeMutCell<SimpleRateLimiter>,
     chat_rate_limiter: Option<LockfreeMutCell<SimpleRateLimiter>>,
 
     pub destruction_notify: Arc<Notify>,
 }
 
+#[derive(Default)]
+pub struct PlayerCountSubscription {
+    pub levels: Vec<(LevelId, u16)>,
+    /// room and count generation of the last push, nothing is looked up again until either changes
+    pub room_id: u32,
+    pub generation: u64,
+}
+
+/// The level list as it was last sent to the client, so that a refresh only has to send what changed
+#[derive(Default)]
+pub struct LevelListSnapshot {
+    pub levels: IntMap<LevelId, u16>,
+    pub room_id: u32,
+    pub generation: u64,
+    /// 0 until a list is sent, then bumped every time the client's copy changes
+    pub version: u32,
+}
+
+impl LevelListSnapshot {
+    pub fn bump_version(&mut self) {
+        self.version = self.version.wrapping_add(1).max(1);
+    }
+
+    /// update the snapshot to the current player counts and return the levels that changed
+    pub fn diff(&mut self, manager: &LevelManager) -> Vec<GlobedLevel> {
+        let mut changes = Vec::new();
+
+        let generation = manager.get_count_generation();
+        if generation == self.generation {
+            return changes;
+        }
+
+        self.generation = generation;
+
+        manager.for_each_level(
+            |(level_id, players), _count, (levels, changes)| {
+                if is_editorcollab_level(level_id) || players.is_empty() {
+                    return false;
+                }
+
+                let count = players.len() as u16;
+                if levels.insert(level_id, count) != Some(count) {
+                    changes.push(GlobedLevel {
+                        level_id: VarInt(level_id),
+                        player_count: VarUint(u64::from(count)),
+                    });
+                }
+
+                true
+            },
+            &mut (&mut self.levels, &mut changes),
+        );
+
+        // levels that nobody is playing anymore
+        self.levels.retain(|&level_id, _| {
+            let present = manager.get_player_count_on_level(level_id).is_some_and(|count| count > 0);
+            if !present {
+                changes.push(GlobedLevel {
+                    level_id: VarInt(level_id),
+                    player_count: VarUint(0),
+                });
+            }
+
+            present
+        });
+
+        changes
+    }
+}
+
 pub enum ClientThreadOutcome {
     Terminate,  // complete termination
     Disconnect, // downgrade to unauthorized thread, allow the user to reconnect
@@ -84,7 +190,7 @@ impl ClientThread {
     pub fn from_unauthorized(thread: UnauthorizedThread) -> Self {
         let game_server = thread.game_server;
 
-        let (rate_limiter, voice_rate_limiter, chat_rate_limiter) = {
+        let (rate_limiter, voice_rate_limiter, chat_rate_limiter, quantized_player_data, server_tps) = {
             let conf = game_server.bridge.central_conf.lock();
 
             (
@@ -98,6 +204,8 @@ impl ClientThread {
                 } else {
                     None
                 },
+                conf.quantized_player_data,
+                conf.tps,
             )
         };
 
@@ -124,10 +232,26 @@ impl ClientThread {
 
             is_authorized_admin: AtomicBool::new(false),
 
+            quantized_player_data,
+            interest_area: LockfreeMutCell::new(None),
+            level_data_counter: AtomicU32::new(0),
+            level_metadata_synced: AtomicBool::new(false),
+            server_tps,
+            level_tps: AtomicU32::new(0),
+            voice_range: AtomicU32::new(0),
+            level_data_sequence: AtomicU32::new(0),
+            stream_epoch: Instant::now(),
+            player_data_keyframe: LockfreeMutCell::new(None),
+            linked_player: SyncMutex::new(None),
+
+            player_count_subscription: LockfreeMutCell::new(PlayerCountSubscription::default()),
+            level_list_snapshot: LockfreeMutCell::new(LevelListSnapshot::default()),
+
             message_queue: Mutex::new(VecDeque::new()),
             message_notify: Notify::new(),
             rate_limiter: LockfreeMutCell::new(rate_limiter),
             voice_rate_limiter: LockfreeMutCell::new(voice_rate_limiter),
+            link_rate_limiter: LockfreeMutCell::new(SimpleRateLimiter::new(MAX_LINKED_TPS + 6, Duration::from_millis(900))),
             chat_rate_limiter: chat_rate_limiter.map(LockfreeMutCell::new),
 
             destruction_notify: thread.destruction_notify,
@@ -161,6 +285,9 @@ impl ClientThread {
     pub async fn run(&self) -> ClientThreadOutcome {
         let mut last_received_packet = Instant::now();
 
+        let mut player_count_interval = tokio::time::interval(PLAYER_COUNT_PUSH_INTERVAL);
+        player_count_interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+
         loop {
             let state = self.connection_state.load();
 
@@ -217,6 +344,13 @@ impl ClientThread {
                     }
                 },
 
+                _ = player_count_interval.tick(), if self.has_player_count_subscription() => {
+                    match self.push_player_counts().await {
+                        Ok(()) => {}
+                        Err(e) => self.print_error(&e),
+                    }
+                }
+
                 () = tokio::time::sleep(THREAD_MICRO_TIMEOUT) => {
                     continue;
                 }
@@ -228,6 +362,12 @@ impl ClientThread {
         self.account_id.load(Ordering::Relaxed) != 0
     }
 
+    /// proximity voice range of this client, 0 if it hears everyone on the level
+    #[inline]
+    pub fn voice_range(&self) -> f32 {
+        f32::from_bits(self.voice_range.load(Ordering::Relaxed))
+    }
+
     /// schedule the thread to terminate as soon as possible.
     #[inline]
     pub fn terminate(&self) -> ClientThreadOutcome {
@@ -351,16 +491,16 @@ impl ClientThread {
     async fn recv_and_handle(&self, message_size: usize) -> Result<()> {
         // safety: only we can receive data from our client.
         let socket = unsafe { self.socket.get_mut() };
-        socket.recv_and_handle(message_size, async |buf| self.handle_packet(buf).await).await
+        socket.recv_and_handle(message_size, async |buf| self.handle_packet(buf, false).await).await
     }
 
     /// handle a message sent from the `GameServer`
     async fn handle_message(&self, message: ServerThreadMessage) -> Result<()> {
         match message {
-            ServerThreadMessage::Packet(mut packet) => self.handle_packet(&mut packet).await?,
-            ServerThreadMessage::SmallPacket((mut packet, len)) => self.handle_packet(&mut packet[..len]).await?,
+            ServerThreadMessage::Packet(mut packet) => self.handle_packet(&mut packet, true).await?,
+            ServerThreadMessage::SmallPacket((mut packet, len)) => self.handle_packet(&mut packet[..len], true).await?,
             ServerThreadMessage::BroadcastText(text_packet) => self.send_packet_static(&text_packet).await?,
-            ServerThreadMessage::BroadcastVoice(voice_packet) => self.send_packet_dynamic(&*voice_packet).await?,
+            ServerThreadMessage::BroadcastVoice(voice_packet) => self.send_voice(voice_packet).await?,
             ServerThreadMessage::BroadcastNotice(packet) => {
                 self.send_packet_dynamic(&packet).await?;
                 info!("{} is receiving a notice: {}", self.account_data.lock().name, packet.message);
@@ -369,6 +509,9 @@ impl ClientThread {
             ServerThreadMessage::BroadcastRoomInfo(packet) => {
                 self.send_packet_static(&packet).await?;
             }
+            ServerThreadMessage::BroadcastRoomPlayersDiff(packet) => self.send_packet_dynamic(&*packet).await?,
+            ServerThreadMessage::BroadcastPlayerMetadata(packet) => self.send_packet_dynamic(&*packet).await?,
+            ServerThreadMessage::BroadcastLinkedPlayerData(packet) => self.send_packet_static(&packet).await?,
             ServerThreadMessage::BroadcastBan(packet) => self.ban(packet.message, packet.timestamp).await?,
             ServerThreadMessage::BroadcastMute(packet) => self.send_packet_dynamic(&packet).await?,
             ServerThreadMessage::BroadcastRoleChange(packet) => self.send_packet_static(&packet).await?,
@@ -378,23 +521,81 @@ impl ClientThread {
         Ok(())
     }
 
-    /// handle an incoming packet
-    async fn handle_packet(&self, message: &mut [u8]) -> Result<()> {
+    /// send a voice frame. if more voice frames are waiting right behind it in the message queue, e.g. because several people
+    /// are talking at once, they are sent together in one `VoiceBundlePacket` to save on per-datagram overhead.
+    async fn send_voice(&self, first: Arc<VoiceBroadcastPacket>) -> Result<()> {
+        let entry_size = |packet: &VoiceBroadcastPacket| size_of_types!(i32, u16) + packet.data.data.len();
+
+        // the limit is for the whole datagram, so leave room for the header and the encryption prefix
+        let overhead = unsafe { self.socket.get() }.encrypted_udp_overhead();
+        let limit = (self.fragmentation_limit.load(Ordering::Relaxed) as usize)
+            .min(VOICE_BUNDLE_DATAGRAM_SIZE)
+            .saturating_sub(overhead);
+        let mut size = size_of_types!(VarLength) + entry_size(&first);
+        let mut rest = Vec::new();
+
+        {
+            let mut mq = self.message_queue.lock().await;
+            while let Some(ServerThreadMessage::BroadcastVoice(next)) = mq.front() {
+                let next_size = entry_size(next);
+                if size + next_size > limit {
+                    break;
+                }
+
+                size += next_size;
+                rest.push(next.clone());
+                mq.pop_front();
+            }
+        }
+
+        if rest.is_empty() {
+            return self.send_packet_dynamic(&*first).await;
+        }
+
+        self.send_packet_alloca_with::<VoiceBundlePacket, _>(size, |buf| {
+            buf.write_length(rest.len() + 1);
+
+            for packet in std::iter::once(&first).chain(rest.iter()) {
+                buf.write_i32(packet.player_id);
+                #[allow(clippy::cast_possible_truncation)]
+                buf.write_u16(packet.data.data.len() as u16);
+                buf.write_bytes(&packet.data.data);
+            }
+        })
+        .await
+    }
+
+    /// handle an incoming packet, `udp` is whether it came from the udp socket
+    async fn handle_packet(&self, message: &mut [u8], udp: bool) -> Result<()> {
         #[cfg(debug_assertions)]
         if message.len() < PacketHeader::SIZE {
             return Err(PacketHandlingError::MalformedMessage);
         }
 
+        let mut data = ByteReader::from_bytes(message);
+        let header = data.read_packet_header()?;
+
         // if we are ratelimited, just discard the packet.
-        // safety: only we can use this ratelimiter.
-        if !unsafe { self.rate_limiter.get_mut() }.try_tick() {
+        // safety: only we can use these ratelimiters.
+        let rate_limiter = if header.packet_id == LinkedPlayerDataPacket::PACKET_ID {
+            &self.link_rate_limiter
+        } else {
+            &self.rate_limiter
+        };
+
+        if !unsafe { rate_limiter.get_mut() }.try_tick() {
             return Err(PacketHandlingError::Ratelimited);
         }
 
-        let mut data = ByteReader::from_bytes(message);
-        let header = data.read_packet_header()?;
+        if header.compressed() {
+            return Err(PacketHandlingError::UnexpectedCompression);
+        }
 
         // by far the most common packet, so we try it early
+        if header.packet_id == PlayerDataDeltaPacket::PACKET_ID {
+            return self.handle_player_data_delta(&mut data).await;
+        }
+
         if header.packet_id == PlayerDataPacket::PACKET_ID {
             return self.handle_player_data(&mut data).await;
         }
@@ -409,8 +610,19 @@ impl ClientThread {
         }
 
         // decrypt the packet in-place if encrypted
-        if header.encrypted {
-            data = unsafe { self.socket.get_mut() }.decrypt(message)?;
+        if header.encrypted() {
+            let socket = unsafe { self.socket.get_mut() };
+
+            data = if udp {
+                // duplicated or replayed packets are silently dropped
+                let Some(data) = socket.decrypt_udp(message)? else {
+                    return Ok(());
+                };
+
+                data
+            } else {
+                socket.decrypt(message)?
+            };
         }
 
         match header.packet_id {
@@ -426,13 +638,21 @@ impl ClientThread {
             RequestGlobalPlayerListPacket::PACKET_ID => self.handle_request_global_list(&mut data).await,
             RequestLevelListPacket::PACKET_ID => self.handle_request_level_list(&mut data).await,
             RequestPlayerCountPacket::PACKET_ID => self.handle_request_player_count(&mut data).await,
+            SubscribePlayerCountsPacket::PACKET_ID => self.handle_subscribe_player_counts(&mut data).await,
+            RequestPlayerListPagePacket::PACKET_ID => self.handle_request_player_list_page(&mut data).await,
 
             /* game related */
             RequestPlayerProfilesPacket::PACKET_ID => self.handle_request_profiles(&mut data).await,
             LevelJoinPacket::PACKET_ID => self.handle_level_join(&mut data).await,
             LevelLeavePacket::PACKET_ID => self.handle_level_leave(&mut data).await,
             PlayerDataPacket::PACKET_ID => self.handle_player_data(&mut data).await,
+            PlayerDataDeltaPacket::PACKET_ID => self.handle_player_data_delta(&mut data).await,
             PlayerMetadataPacket::PACKET_ID => self.handle_player_metadata(&mut data).await,
+            PlayerViewportPacket::PACKET_ID => self.handle_player_viewport(&mut data).await,
+            RequestPlayerProfilesBatchPacket::PACKET_ID => self.handle_request_profiles_batch(&mut data).await,
+            VoiceProximityPacket::PACKET_ID => self.handle_voice_proximity(&mut data).await,
+            LinkPlayerPacket::PACKET_ID => self.handle_link_player(&mut data).await,
+            LinkedPlayerDataPacket::PACKET_ID => self.handle_linked_player_data(&mut data).await,
 
             VoicePacket::PACKET_ID => self.handle_voice(&mut data).await,
             ChatMessagePacket::PACKET_ID => self.handle_chat_message(&mut data).await,
@@ -445,6 +665,7 @@ impl ClientThread {
             UpdateRoomSettingsPacket::PACKET_ID => self.handle_update_room_settings(&mut data).await,
             RoomSendInvitePacket::PACKET_ID => self.handle_room_invitation(&mut data).await,
             RequestRoomListPacket::PACKET_ID => self.handle_request_room_list(&mut data).await,
+            RequestRoomListPagePacket::PACKET_ID => self.handle_request_room_list_page(&mut data).await,
 
             /* admin related */
             AdminAuthPacket::PACKET_ID => self.handle_admin_auth(&mut data).await,
@@ -452,6 +673,8 @@ impl ClientThread {
             AdminDisconnectPacket::PACKET_ID => self.handle_admin_disconnect(&mut data).await,
             AdminGetUserStatePacket::PACKET_ID => self.handle_admin_get_user_state(&mut data).await,
             AdminUpdateUserPacket::PACKET_ID => self.handle_admin_update_user(&mut data).await,
+            AdminGetUsersPacket::PACKET_ID => self.handle_admin_get_users(&mut data).await,
+            AdminSearchUsersPacket::PACKET_ID => self.handle_admin_search_users(&mut data).await,
             x => Err(PacketHandlingError::NoHandler(x)),
         }
     }
@@ -14,3 +14,13 @@ use crate::{
 
 #[allow(unused)]
 use globed_shared::{debug, error, info, trace, warn};
+
+/// compares two names the way paginated lists sort them, ignoring ascii case
+fn cmp_ignore_ascii_case(a: &[u8], b: &[u8]) -> std::cmp::Ordering {
+    a.iter().map(u8::to_ascii_lowercase).cmp(b.iter().map(u8::to_ascii_lowercase))
+}
+
+/// whether `needle` appears anywhere in `haystack`, ignoring ascii case
+fn contains_ignore_ascii_case(haystack: &[u8], needle: &[u8]) -> bool {
+    needle.is_empty() || haystack.windows(needle.len()).any(|w| w.eq_ignore_ascii_case(needle))
+}
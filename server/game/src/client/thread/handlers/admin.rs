@@ -14,6 +14,9 @@ macro_rules! admin_error {
     };
 }
 
+/// max amount of players in an `AdminUserSearchResultsPacket`
+const ADMIN_SEARCH_LIMIT: usize = 25;
+
 #[derive(Clone, Copy)]
 enum AdminPerm {
     Any,
@@ -415,6 +418,66 @@ impl ClientThread {
         self.send_packet_dynamic(&packet).await
     });
 
+    gs_handler!(self, handle_admin_get_users, AdminGetUsersPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        if !self._has_perm(AdminPerm::Any) {
+            return Ok(());
+        }
+
+        let mut users = Vec::with_capacity(packet.players.len());
+        let mut missing = Vec::new();
+
+        for player in packet.players.iter() {
+            if let Some(user) = self.game_server.find_user(player) {
+                let entry = user.user_entry.lock().clone();
+                let account_data = user.account_data.lock().make_room_preview(0);
+                users.push((entry, Some(account_data)));
+                continue;
+            }
+
+            // offline players can only be looked up through the bridge, one at a time, but without a round trip to the client each
+            if self.game_server.standalone {
+                missing.push(player.clone());
+                continue;
+            }
+
+            match self.game_server.bridge.get_user_data(player).await {
+                Ok(entry) => users.push((entry, None)),
+                Err(err) => {
+                    warn!("error fetching data from the bridge: {err}");
+                    missing.push(player.clone());
+                }
+            }
+        }
+
+        // only admins can see/change passwords of others
+        if !self._has_perm(AdminPerm::Admin) {
+            for (entry, _) in &mut users {
+                entry.admin_password = None;
+            }
+        }
+
+        self.send_packet_dynamic(&AdminUsersDataPacket { users, missing }).await
+    });
+
+    gs_handler!(self, handle_admin_search_users, AdminSearchUsersPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        if !self._has_perm(AdminPerm::Any) || packet.prefix.is_empty() {
+            return Ok(());
+        }
+
+        let players = self
+            .game_server
+            .find_users_by_prefix(&packet.prefix, ADMIN_SEARCH_LIMIT)
+            .iter()
+            .map(|thread| thread.account_data.lock().make_room_preview(0))
+            .collect();
+
+        self.send_packet_dynamic(&AdminUserSearchResultsPacket { players }).await
+    });
+
     gs_handler!(self, handle_admin_update_user, AdminUpdateUserPacket, packet, {
         let self_account_id = gs_needauth!(self);
 
@@ -11,11 +11,13 @@ impl ClientThread {
         .await
     });
 
-    gs_handler!(self, handle_keepalive, KeepalivePacket, _packet, {
+    gs_handler!(self, handle_keepalive, KeepalivePacket, packet, {
         let _ = gs_needauth!(self);
 
         self.send_packet_static(&KeepaliveResponsePacket {
             player_count: self.game_server.state.get_player_count(),
+            client_time: packet.client_time,
+            server_time: self.game_server.clock_micros(),
         })
         .await
     });
@@ -1,15 +1,40 @@
-use std::sync::{atomic::Ordering, Arc};
+use std::sync::{atomic::Ordering, Arc, Weak};
 
 use super::*;
 
 /// max voice packet size in bytes
 pub const MAX_VOICE_PACKET_SIZE: usize = 4096;
 
+/// level data is split into datagrams no bigger than this, even if the client's fragmentation limit is higher.
+/// this keeps them under a typical path MTU (1500 minus IP, UDP and tunnel headers), so they aren't fragmented
+/// at the IP layer, and losing one datagram only loses the players that were in it.
+const LEVEL_DATA_DATAGRAM_SIZE: usize = 1400;
+
+/// voice frames queued for the same client are bundled into datagrams up to this size, for the same reason
+pub const VOICE_BUNDLE_DATAGRAM_SIZE: usize = LEVEL_DATA_DATAGRAM_SIZE;
+
+/// highest rate of `LinkedPlayerDataPacket` a client may send, it has a rate limiter of its own
+pub const MAX_LINKED_TPS: usize = 60;
+
+/// levels with more players than this get a lower tps, the level data sent per second grows with the square of the player count.
+/// past this the tps drops in proportion to the player count, so the level data only grows linearly instead
+const DENSE_LEVEL_PLAYERS: usize = 40;
+/// the tps of a crowded level never goes below this, and it changes in steps of `LEVEL_TPS_STEP` so a player joining or
+/// leaving doesn't send everyone a new tps
+const MIN_LEVEL_TPS: u32 = 10;
+const LEVEL_TPS_STEP: u32 = 5;
+
+/// players outside of the client's interest area are only sent in every Nth level data response
+const FAR_PLAYER_INTERVAL: u32 = 4;
+
 impl ClientThread {
     gs_handler!(self, handle_level_join, LevelJoinPacket, packet, {
         let account_id = gs_needauth!(self);
 
         let old_level = self.level_id.swap(packet.level_id, Ordering::Relaxed);
+        self.level_metadata_synced.store(false, Ordering::Relaxed);
+        self.level_tps.store(0, Ordering::Relaxed);
+        *self.linked_player.lock() = None;
         let room_id = self.room_id.load(Ordering::Relaxed);
 
         self.game_server.state.room_manager.with_any(room_id, |pm| {
@@ -22,6 +47,11 @@ impl ClientThread {
             }
         });
 
+        // the room player list shows which level everyone is on
+        self.game_server
+            .broadcast_room_players_diff(room_id, 0, vec![self._make_room_preview()], Vec::new())
+            .await;
+
         Ok(())
     });
 
@@ -29,18 +59,110 @@ impl ClientThread {
         let account_id = gs_needauth!(self);
 
         let level_id = self.level_id.swap(0, Ordering::Relaxed);
+        self.level_metadata_synced.store(false, Ordering::Relaxed);
+        *self.linked_player.lock() = None;
         if level_id != 0 {
             let room_id = self.room_id.load(Ordering::Relaxed);
 
             self.game_server.state.room_manager.with_any(room_id, |pm| {
                 pm.manager.remove_from_level(level_id, account_id);
             });
+
+            self.game_server
+                .broadcast_room_players_diff(room_id, 0, vec![self._make_room_preview()], Vec::new())
+                .await;
         }
 
         Ok(())
     });
 
     gs_handler!(self, handle_player_data, PlayerDataPacket, packet, {
+        self._process_player_data(&packet.data).await
+    });
+
+    gs_handler!(self, handle_player_data_delta, PlayerDataDeltaPacket, packet, {
+        let delta = &packet.delta;
+
+        // safety: only we can use this cell.
+        let keyframe = unsafe { self.player_data_keyframe.get_mut() };
+
+        let data = if delta.keyframe {
+            let data = delta.apply_to(&PlayerData::default());
+            *keyframe = Some((delta.keyframe_id, data.clone()));
+            data
+        } else {
+            match keyframe {
+                Some((id, base)) if *id == delta.keyframe_id => delta.apply_to(base),
+                // the keyframe this delta refers to was lost, drop it and wait for the next one
+                _ => return Ok(()),
+            }
+        };
+
+        self._process_player_data(&data).await
+    });
+
+    gs_handler!(self, handle_player_viewport, PlayerViewportPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        // safety: only we can use this cell.
+        let area = unsafe { self.interest_area.get_mut() };
+        *area = Some(InterestArea::from_viewport(packet.origin, packet.size));
+
+        Ok(())
+    });
+
+    gs_handler!(self, handle_link_player, LinkPlayerPacket, packet, {
+        let account_id = gs_needauth!(self);
+
+        let room_id = self.room_id.load(Ordering::Relaxed);
+        let linkable = packet.player_id != 0
+            && packet.player_id != account_id
+            && room_id != 0
+            && self.game_server.state.room_manager.with_any(room_id, |room| room.is_two_player_mode());
+
+        let linked = if linkable {
+            self.game_server
+                .get_user_by_id(packet.player_id)
+                .filter(|thread| thread.room_id.load(Ordering::Relaxed) == room_id)
+                .map(|thread| Arc::downgrade(&thread))
+        } else {
+            None
+        };
+
+        *self.linked_player.lock() = linked;
+
+        Ok(())
+    });
+
+    /// forward the player data to the linked player only, it isn't stored and nobody else on the level gets it
+    gs_handler!(self, handle_linked_player_data, LinkedPlayerDataPacket, packet, {
+        let account_id = gs_needauth!(self);
+
+        let Some(linked) = self.linked_player.lock().as_ref().and_then(Weak::upgrade) else {
+            return Ok(());
+        };
+
+        // the link only holds while both are on the same level in the same room
+        let level_id = self.level_id.load(Ordering::Relaxed);
+        if level_id == 0
+            || linked.level_id.load(Ordering::Relaxed) != level_id
+            || linked.room_id.load(Ordering::Relaxed) != self.room_id.load(Ordering::Relaxed)
+        {
+            return Ok(());
+        }
+
+        linked
+            .push_new_message(ServerThreadMessage::BroadcastLinkedPlayerData(LinkedPlayerDataBroadcastPacket {
+                player_id: account_id,
+                data: packet.data,
+            }))
+            .await;
+
+        Ok(())
+    });
+
+    /// store the player data and send `LevelDataPacket` (or `QuantizedLevelDataPacket`) back to the client
+    async fn _process_player_data(&self, data: &PlayerData) -> crate::client::Result<()> {
         let account_id = gs_needauth!(self);
 
         let level_id = self.level_id.load(Ordering::Relaxed);
@@ -51,29 +173,67 @@ impl ClientThread {
         let room_id = self.room_id.load(Ordering::Relaxed);
 
         let written_players = self.game_server.state.room_manager.with_any(room_id, |pm| {
-            pm.manager.set_player_data(account_id, &packet.data);
+            pm.manager.set_player_data(account_id, data);
             // this unwrap should be safe and > 0 given that self.level_id != 0, but we leave a default just in case
             pm.manager.get_player_count_on_level(level_id).unwrap_or(1) - 1
         });
 
+        // the first player data on a level always gets the tps, after that only changes are sent
+        let tps = level_tps(self.server_tps, written_players + 1);
+        if self.level_tps.swap(tps, Ordering::Relaxed) != tps {
+            self.send_packet_static(&LevelTpsPacket { tps }).await?;
+        }
+
         // no one else on the level, no need to send a response packet
         if written_players == 0 {
             return Ok(());
         }
 
-        let calc_size = size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * written_players;
-        let fragmentation_limit = self.fragmentation_limit.load(Ordering::Relaxed) as usize;
+        // players that the client can't see are skipped, except for every `FAR_PLAYER_INTERVAL`th response.
+        // builders in the editor only carry their status, so they're treated the same way, unless the client is building too,
+        // as then it only sends (and gets responses) once in a while.
+        // safety: only we can use this cell.
+        let area = unsafe { self.interest_area.get_mut() }.as_ref();
+        let send_far = self.level_data_counter.fetch_add(1, Ordering::Relaxed) % FAR_PLAYER_INTERVAL == 0;
+        let building = data.is_editor_building();
+        let should_send = |player: &PlayerData| {
+            send_far || (if player.is_editor_building() { building } else { area.is_none_or(|area| area.contains(player)) })
+        };
+
+        // in quantized mode, positions are sent relative to the player receiving the packet
+        let anchor = self.quantized_player_data.then_some(data.player1.position);
+        let anchor_size = if anchor.is_some() { size_of_types!(Point) } else { 0 };
+
+        // every datagram starts with its sequence number and a timestamp
+        let header_size = size_of_types!(u32, u32);
+        let timestamp = self.stream_epoch.elapsed().as_millis() as u32;
+
+        // `QuantizedPlayerData` has the same worst-case size, so the fragmentation math is the same for both modes
+        let calc_size = header_size + anchor_size + size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * written_players;
+        let fragmentation_limit = (self.fragmentation_limit.load(Ordering::Relaxed) as usize).min(LEVEL_DATA_DATAGRAM_SIZE);
 
         // if we can fit in one packet, then just send it as-is
         if calc_size <= fragmentation_limit {
-            self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| {
+            let sequence = self.level_data_sequence.fetch_add(1, Ordering::Relaxed);
+
+            let encode = |buf: &mut FastByteBuffer| {
+                buf.write_u32(sequence);
+                buf.write_u32(timestamp);
+
+                if let Some(anchor) = &anchor {
+                    buf.write_value(anchor);
+                }
+
                 self.game_server.state.room_manager.with_any(room_id, |pm| {
                     buf.write_list_with(written_players, |buf| {
                         pm.manager.for_each_player_on_level(
                             level_id,
                             |player, count, buf| {
-                                if count < written_players && player.account_id != account_id {
-                                    buf.write_value(&player.to_borrowed_associated_data());
+                                if count < written_players && player.account_id != account_id && should_send(&player.data) {
+                                    match anchor {
+                                        Some(anchor) => buf.write_value(&player.to_quantized_data(anchor)),
+                                        None => buf.write_bytes(&player.encoded_data),
+                                    }
                                     true
                                 } else {
                                     false
@@ -83,22 +243,84 @@ impl ClientThread {
                         )
                     });
                 });
-            })
-            .await?;
+            };
+
+            if anchor.is_some() {
+                self.send_packet_alloca_with::<QuantizedLevelDataPacket, _>(calc_size, encode).await?;
+            } else {
+                self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, encode).await?;
+            }
 
             return Ok(());
         }
 
-        // get all players into a vec
         let total_fragments = (calc_size + fragmentation_limit - 1) / fragmentation_limit;
 
+        // without an anchor, every player is already encoded. they're copied into one buffer back to back,
+        // so each datagram is the list length followed by a single slice of it.
+        let Some(anchor) = anchor else {
+            let mut encoded = (
+                Vec::with_capacity(size_of_types!(AssociatedPlayerData) * written_players),
+                Vec::with_capacity(written_players),
+            );
+
+            self.game_server.state.room_manager.with_any(room_id, |pm| {
+                pm.manager.for_each_player_on_level(
+                    level_id,
+                    |player, _, (bytes, ends)| {
+                        if player.account_id == account_id || !should_send(&player.data) {
+                            false
+                        } else {
+                            bytes.extend_from_slice(&player.encoded_data);
+                            ends.push(bytes.len());
+                            true
+                        }
+                    },
+                    &mut encoded,
+                )
+            });
+
+            let (bytes, ends) = encoded;
+
+            // everyone could have been filtered out by the interest area
+            if ends.is_empty() {
+                return Ok(());
+            }
+
+            let players_per_fragment = (ends.len() + total_fragments - 1) / total_fragments;
+            let calc_size = header_size + size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * players_per_fragment;
+
+            trace!(
+                "sending a fragmented packet (lim: {fragmentation_limit}, per: {players_per_fragment}, frags: {total_fragments}, fragsize: {calc_size})"
+            );
+
+            let mut start = 0;
+            for chunk in ends.chunks(players_per_fragment) {
+                let end = chunk[chunk.len() - 1];
+                let sequence = self.level_data_sequence.fetch_add(1, Ordering::Relaxed);
+
+                self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| {
+                    buf.write_u32(sequence);
+                    buf.write_u32(timestamp);
+                    buf.write_length(chunk.len());
+                    buf.write_bytes(&bytes[start..end]);
+                })
+                .await?;
+
+                start = end;
+            }
+
+            return Ok(());
+        };
+
+        // in quantized mode positions depend on the recipient, so the players are encoded for each datagram
         let mut players = Vec::with_capacity(written_players + 4);
 
         self.game_server.state.room_manager.with_any(room_id, |pm| {
             pm.manager.for_each_player_on_level(
                 level_id,
                 |player, _, players| {
-                    if player.account_id == account_id {
+                    if player.account_id == account_id || !should_send(&player.data) {
                         false
                     } else {
                         players.push(player.to_associated_data());
@@ -109,20 +331,39 @@ impl ClientThread {
             )
         });
 
+        // everyone could have been filtered out by the interest area
+        if players.is_empty() {
+            return Ok(());
+        }
+
         let players_per_fragment = (players.len() + total_fragments - 1) / total_fragments;
-        let calc_size = size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * players_per_fragment;
+        let calc_size = header_size + anchor_size + size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * players_per_fragment;
 
-        debug!(
+        trace!(
             "sending a fragmented packet (lim: {fragmentation_limit}, per: {players_per_fragment}, frags: {total_fragments}, fragsize: {calc_size})"
         );
 
         for chunk in players.chunks(players_per_fragment) {
-            self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| buf.write_value(chunk))
-                .await?;
+            let sequence = self.level_data_sequence.fetch_add(1, Ordering::Relaxed);
+
+            self.send_packet_alloca_with::<QuantizedLevelDataPacket, _>(calc_size, |buf| {
+                buf.write_u32(sequence);
+                buf.write_u32(timestamp);
+                buf.write_value(&anchor);
+                buf.write_length(chunk.len());
+                for player in chunk {
+                    buf.write_value(&QuantizedPlayerData {
+                        anchor,
+                        account_id: player.account_id,
+                        data: &player.data,
+                    });
+                }
+            })
+            .await?;
         }
 
         Ok(())
-    });
+    }
 
     gs_handler!(self, handle_player_metadata, PlayerMetadataPacket, packet, {
         let account_id = gs_needauth!(self);
@@ -133,13 +374,26 @@ impl ClientThread {
         }
 
         let room_id = self.room_id.load(Ordering::Relaxed);
+
+        // clients only send metadata when it changes. the first one on a level is answered with everyone else's,
+        // and every one of them goes out to the others on the level as a single entry
+        let first = !self.level_metadata_synced.swap(true, Ordering::Relaxed);
+
         let players = self.game_server.state.room_manager.with_any(room_id, |pm| {
             pm.manager.set_player_meta(account_id, &packet.data);
 
+            if !first {
+                return Vec::new();
+            }
+
             let mut vec = Vec::with_capacity(pm.manager.get_player_count_on_level(level_id).unwrap_or(0));
             pm.manager.for_each_player_on_level(
                 level_id,
                 |player, _count, vec| {
+                    if player.account_id == account_id {
+                        return false;
+                    }
+
                     vec.push(AssociatedPlayerMetadata {
                         account_id: player.account_id,
                         data: player.meta.clone(),
@@ -152,6 +406,17 @@ impl ClientThread {
             vec
         });
 
+        let change = Arc::new(LevelPlayerMetadataPacket {
+            players: vec![AssociatedPlayerMetadata {
+                account_id,
+                data: packet.data,
+            }],
+        });
+
+        self.game_server
+            .broadcast_player_metadata(change, account_id, level_id, room_id)
+            .await;
+
         if players.is_empty() {
             // if no players, don't send a response packet
             Ok(())
@@ -216,8 +481,40 @@ impl ClientThread {
         self.send_packet_dynamic(&PlayerProfilesPacket { players }).await
     });
 
+    gs_handler!(self, handle_request_profiles_batch, RequestPlayerProfilesBatchPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        let level_id = self.level_id.load(Ordering::Relaxed);
+        if level_id == 0 {
+            return Err(PacketHandlingError::UnexpectedPlayerData);
+        }
+
+        let players = packet
+            .requested
+            .iter()
+            .filter_map(|&id| self.game_server.get_player_account_data(id))
+            .collect::<Vec<_>>();
+
+        // if none of them are online anymore, don't send a response packet
+        if players.is_empty() {
+            Ok(())
+        } else {
+            self.send_packet_dynamic(&PlayerProfilesPacket { players }).await
+        }
+    });
+
     /* Note: blocking logic for voice & chat packets is not in here but in the packet receiving function */
 
+    gs_handler!(self, handle_voice_proximity, VoiceProximityPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        // a negative range would mute everyone, treat it as no proximity
+        let range = packet.range.get().max(0.0);
+        self.voice_range.store(range.to_bits(), Ordering::Relaxed);
+
+        Ok(())
+    });
+
     gs_handler!(self, handle_voice, VoicePacket, packet, {
         let account_id = gs_needauth!(self);
 
@@ -252,3 +549,14 @@ impl ClientThread {
         Ok(())
     });
 }
+
+/// tps that players on a level with `players` players should send at
+fn level_tps(server_tps: u32, players: usize) -> u32 {
+    if players <= DENSE_LEVEL_PLAYERS {
+        return server_tps;
+    }
+
+    #[allow(clippy::cast_possible_truncation)]
+    let tps = (server_tps as usize * DENSE_LEVEL_PLAYERS / players) as u32;
+    (tps / LEVEL_TPS_STEP * LEVEL_TPS_STEP).clamp(MIN_LEVEL_TPS.min(server_tps), server_tps)
+}
@@ -1,5 +1,16 @@
 use super::*;
 
+/// max amount of levels in a single `LevelListPacket`, bigger lists are sent as multiple packets
+const LEVEL_LIST_CHUNK_SIZE: usize = 1024;
+
+/// max amount of players in a single `PlayerListPagePacket`
+const PLAYER_LIST_PAGE_SIZE: usize = 100;
+
+/// order of the paginated player list, by name (case insensitive) and then by account id
+fn player_list_order(a_name: &[u8], a_id: i32, b_name: &[u8], b_id: i32) -> std::cmp::Ordering {
+    cmp_ignore_ascii_case(a_name, b_name).then(a_id.cmp(&b_id))
+}
+
 impl ClientThread {
     gs_handler!(self, handle_sync_icons, SyncIconsPacket, packet, {
         let _ = gs_needauth!(self);
@@ -17,20 +28,95 @@ impl ClientThread {
         .await
     });
 
-    gs_handler!(self, handle_request_level_list, RequestLevelListPacket, _packet, {
+    gs_handler!(self, handle_request_player_list_page, RequestPlayerListPagePacket, packet, {
+        let _ = gs_needauth!(self);
+
+        let limit = usize::from(packet.limit).clamp(1, PLAYER_LIST_PAGE_SIZE);
+        let prefix = packet.name_prefix.as_bytes();
+        let after_name = packet.after_name.as_bytes();
+
+        let mut only_ids = packet.only_ids.to_vec();
+        only_ids.sort_unstable();
+
+        // only the matching players after the cursor are cloned, the rest of the list never leaves the lock
+        let mut players = Vec::new();
+        self.game_server.for_every_player_preview_in_room(
+            0,
+            |p, _, players| {
+                let name = p.name.as_bytes();
+                let matches = (only_ids.is_empty() || only_ids.binary_search(&p.account_id).is_ok())
+                    && name.len() >= prefix.len()
+                    && name[..prefix.len()].eq_ignore_ascii_case(prefix)
+                    && player_list_order(name, p.account_id, after_name, packet.after_id).is_gt();
+
+                if matches {
+                    players.push(p.clone());
+                }
+
+                matches
+            },
+            &mut players,
+        );
+
+        let order = |a: &PlayerPreviewAccountData, b: &PlayerPreviewAccountData| {
+            player_list_order(a.name.as_bytes(), a.account_id, b.name.as_bytes(), b.account_id)
+        };
+
+        // no need to sort the whole list when only the first page of it is sent
+        let has_more = players.len() > limit;
+        if has_more {
+            players.select_nth_unstable_by(limit, order);
+            players.truncate(limit);
+        }
+
+        players.sort_unstable_by(order);
+
+        self.send_packet_dynamic(&PlayerListPagePacket { players, has_more }).await
+    });
+
+    gs_handler!(self, handle_request_level_list, RequestLevelListPacket, packet, {
         let _ = gs_needauth!(self);
 
         let room_id = self.room_id.load(Ordering::Relaxed);
 
-        let levels = self.game_server.state.room_manager.with_any(room_id, |pm| {
+        // safety: only we can use this cell.
+        let snapshot = unsafe { self.level_list_snapshot.get_mut() };
+
+        // the client still has the list we sent last, so only send the levels that changed since then
+        if packet.known_version != 0 && packet.known_version == snapshot.version && room_id == snapshot.room_id {
+            let changes = self
+                .game_server
+                .state
+                .room_manager
+                .with_any(room_id, |pm| snapshot.diff(&pm.manager));
+
+            // past this point the full list is about as cheap, and it arrives sorted
+            if changes.len() <= LEVEL_LIST_CHUNK_SIZE {
+                let base_version = snapshot.version;
+                if !changes.is_empty() {
+                    snapshot.bump_version();
+                }
+
+                return self
+                    .send_packet_dynamic(&LevelListDeltaPacket {
+                        base_version,
+                        version: snapshot.version,
+                        changes,
+                        request_id: packet.request_id,
+                    })
+                    .await;
+            }
+        }
+
+        let (mut levels, generation) = self.game_server.state.room_manager.with_any(room_id, |pm| {
             let mut vec = Vec::with_capacity(pm.manager.get_level_count());
 
             pm.manager.for_each_level(
                 |(level_id, players), _count, vec| {
-                    if !is_editorcollab_level(level_id) {
+                    if !is_editorcollab_level(level_id) && !players.is_empty() {
                         vec.push(GlobedLevel {
-                            level_id,
-                            player_count: players.len() as u16,
+                            level_id: VarInt(level_id),
+                            player_count: VarUint(players.len() as u64),
                         });
                     }
 
@@ -39,10 +125,41 @@ impl ClientThread {
                 &mut vec,
             );
 
-            vec
+            (vec, pm.manager.get_count_generation())
         });
 
-        self.send_packet_dynamic(&LevelListPacket { levels }).await
+        snapshot.levels.clear();
+        snapshot.levels.extend(levels.iter().map(|level| (level.level_id.0, level.player_count.0 as u16)));
+        snapshot.room_id = room_id;
+        snapshot.generation = generation;
+        snapshot.bump_version();
+
+        // sorted and split into chunks, so the client can show the most popular levels before the whole list arrives
+        levels.sort_unstable_by(|a, b| b.player_count.cmp(&a.player_count));
+
+        if levels.is_empty() {
+            return self
+                .send_packet_dynamic(&LevelListPacket {
+                    levels,
+                    is_final: true,
+                    version: snapshot.version,
+                    request_id: packet.request_id,
+                })
+                .await;
+        }
+
+        let chunk_count = levels.len().div_ceil(LEVEL_LIST_CHUNK_SIZE);
+        for (idx, chunk) in levels.chunks(LEVEL_LIST_CHUNK_SIZE).enumerate() {
+            self.send_packet_dynamic(&LevelListPacket {
+                levels: chunk.to_vec(),
+                is_final: idx + 1 == chunk_count,
+                version: snapshot.version,
+                request_id: packet.request_id,
+            })
+            .await?;
+        }
+
+        Ok(())
     });
 
     gs_handler!(self, handle_request_player_count, RequestPlayerCountPacket, packet, {
@@ -62,4 +179,68 @@ impl ClientThread {
 
         self.send_packet_dynamic(&LevelPlayerCountPacket { levels }).await
     });
+
+    gs_handler!(self, handle_subscribe_player_counts, SubscribePlayerCountsPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        {
+            // safety: only we can use this cell.
+            let sub = unsafe { self.player_count_subscription.get_mut() };
+            sub.levels.clear();
+            sub.levels.extend(packet.level_ids.iter().map(|&id| (id, u16::MAX)));
+
+            // force the first push to send everything
+            sub.generation = u64::MAX;
+        }
+
+        self.push_player_counts().await
+    });
+
+    pub(crate) fn has_player_count_subscription(&self) -> bool {
+        // safety: only we can use this cell.
+        !unsafe { self.player_count_subscription.get() }.levels.is_empty()
+    }
+
+    /// send `LevelPlayerCountPacket` with the subscribed levels whose counts changed since the last push, if any
+    pub(crate) async fn push_player_counts(&self) -> crate::client::Result<()> {
+        // safety: only we can use this cell.
+        let sub = unsafe { self.player_count_subscription.get_mut() };
+        let room_id = self.room_id.load(Ordering::Relaxed);
+
+        let levels = self.game_server.state.room_manager.try_with_any(
+            room_id,
+            |pm| {
+                let generation = pm.manager.get_count_generation();
+                if room_id == sub.room_id && generation == sub.generation {
+                    return Vec::new();
+                }
+
+                // counts from another room mean nothing here
+                if room_id != sub.room_id {
+                    sub.levels.iter_mut().for_each(|(_, last)| *last = u16::MAX);
+                }
+
+                sub.room_id = room_id;
+                sub.generation = generation;
+
+                let mut changed = Vec::new();
+                for (level_id, last) in &mut sub.levels {
+                    let count = pm.manager.get_player_count_on_level(*level_id).unwrap_or(0) as u16;
+                    if count != *last {
+                        *last = count;
+                        changed.push((*level_id, count));
+                    }
+                }
+
+                changed
+            },
+            Vec::new,
+        );
+
+        if levels.is_empty() {
+            Ok(())
+        } else {
+            self.send_packet_dynamic(&LevelPlayerCountPacket { levels }).await
+        }
+    }
 }
@@ -1,5 +1,8 @@
 use super::*;
 
+/// max amount of rooms in a single `RoomListPagePacket`
+const ROOM_LIST_PAGE_SIZE: usize = 50;
+
 impl ClientThread {
     gs_handler!(self, handle_create_room, CreateRoomPacket, packet, {
         let account_id = gs_needauth!(self);
@@ -102,6 +105,14 @@ impl ClientThread {
             pm.manager.create_player(account_id);
         });
 
+        self.game_server
+            .broadcast_room_players_diff(old_room_id, 0, Vec::new(), vec![account_id])
+            .await;
+
+        self.game_server
+            .broadcast_room_players_diff(packet.room_id, account_id, vec![self._make_room_preview()], Vec::new())
+            .await;
+
         self.send_packet_static(&RoomJoinedPacket).await
     });
 
@@ -122,6 +133,10 @@ impl ClientThread {
             self.game_server.broadcast_room_info(room_id).await;
         }
 
+        self.game_server
+            .broadcast_room_players_diff(room_id, 0, Vec::new(), vec![account_id])
+            .await;
+
         // add them to the global room
         self.game_server.state.room_manager.get_global().manager.create_player(account_id);
 
@@ -229,18 +244,89 @@ impl ClientThread {
         self.send_packet_dynamic(&pkt).await
     });
 
+    gs_handler!(self, handle_request_room_list_page, RequestRoomListPagePacket, packet, {
+        let _ = gs_needauth!(self);
+
+        let limit = usize::from(packet.limit).clamp(1, ROOM_LIST_PAGE_SIZE);
+        let offset = packet.offset as usize;
+        let query = packet.name_filter.as_bytes();
+
+        let (rooms, has_more) = {
+            let rooms = self.game_server.state.room_manager.get_rooms();
+
+            // only the sort keys of every room are collected, listing infos are made just for the requested page
+            let mut keys = rooms
+                .iter()
+                .filter(|(_, room)| !room.is_hidden() && contains_ignore_ascii_case(room.name.as_bytes(), query))
+                .map(|(id, room)| (room.manager.get_total_player_count(), room.name.as_bytes(), *id))
+                .collect::<Vec<_>>();
+
+            let order = |a: &(usize, &[u8], u32), b: &(usize, &[u8], u32)| {
+                if packet.sort_by_name {
+                    cmp_ignore_ascii_case(a.1, b.1).then(a.2.cmp(&b.2))
+                } else {
+                    b.0.cmp(&a.0).then(a.2.cmp(&b.2))
+                }
+            };
+
+            let end = keys.len().min(offset.saturating_add(limit));
+            let has_more = keys.len() > end;
+
+            let mut page = Vec::new();
+            if offset < end {
+                // partition out everything past the page, then everything before it, and sort just the page
+                if has_more {
+                    keys.select_nth_unstable_by(end, order);
+                    keys.truncate(end);
+                }
+
+                if offset > 0 {
+                    keys.select_nth_unstable_by(offset, order);
+                }
+
+                let page_keys = &mut keys[offset..];
+                page_keys.sort_unstable_by(order);
+
+                page.reserve(page_keys.len());
+                page.extend(
+                    page_keys
+                        .iter()
+                        .filter_map(|&(_, _, id)| rooms.get(&id).map(|room| room.get_room_listing_info(id, self.game_server))),
+                );
+            }
+
+            (page, has_more)
+        };
+
+        self.send_packet_dynamic(&RoomListPagePacket { rooms, has_more }).await
+    });
+
     #[inline]
     async fn _respond_with_room_list(&self, room_id: u32) -> crate::client::Result<()> {
-        let room_info = self
+        // the version is read before collecting the players, so a diff that races with this can only repeat a change
+        let (room_info, version) = self
             .game_server
             .state
             .room_manager
-            .with_any(room_id, |room| room.get_room_info(room_id, self.game_server));
+            .with_any(room_id, |room| (room.get_room_info(room_id, self.game_server), room.version));
 
         self.send_packet_dynamic(&RoomPlayerListPacket {
             room_info,
             players: self.game_server.get_room_player_previews(room_id),
+            version,
         })
         .await
     }
+
+    /// our own entry in the room player list, same as what `GameServer::for_every_room_player_preview` makes
+    pub(crate) fn _make_room_preview(&self) -> PlayerRoomPreviewAccountData {
+        let mut level_id = self.level_id.load(Ordering::Relaxed);
+
+        // if they are in editorcollab, show no level
+        if is_editorcollab_level(level_id) {
+            level_id = 0;
+        }
+
+        self.account_data.lock().make_room_preview(level_id)
+    }
 }
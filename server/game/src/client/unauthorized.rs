@@ -250,14 +250,27 @@ impl UnauthorizedThread {
         let mut data = ByteReader::from_bytes(message);
         let header = data.read_packet_header()?;
 
+        if header.compressed() {
+            return Err(PacketHandlingError::UnexpectedCompression);
+        }
+
         // reject cleartext credentials
-        if header.packet_id == LoginPacket::PACKET_ID && !header.encrypted {
+        if header.packet_id == LoginPacket::PACKET_ID && !header.encrypted() {
             return Err(PacketHandlingError::MalformedLoginAttempt);
         }
 
         // decrypt the packet in-place if encrypted
-        if header.encrypted {
-            data = self.get_socket().decrypt(message)?;
+        if header.encrypted() {
+            data = match self.get_socket().decrypt(message) {
+                Ok(data) => data,
+                // a pipelined login encrypted for the key this server had before a restart,
+                // the client sends it again once it gets the handshake response with the new key
+                Err(PacketHandlingError::DecryptionError) if header.packet_id == LoginPacket::PACKET_ID => {
+                    debug!("[{}] dropping a login encrypted with an outdated server key", self.get_tcp_peer());
+                    return Ok(());
+                }
+                Err(err) => return Err(err),
+            };
         }
 
         match header.packet_id {
@@ -286,6 +299,16 @@ impl UnauthorizedThread {
         }
 
         socket.init_crypto_box(&packet.key)?;
+
+        // clients that override the protocol check don't necessarily support it
+        if packet.protocol == PROTOCOL_VERSION {
+            let cipher = SessionCipher::negotiate(packet.ciphers);
+            socket.init_session_box(cipher)?;
+
+            // must arrive before the handshake response, that is when the client sets up its own box
+            socket.send_packet_static(&SessionCipherPacket { cipher: cipher as u8 }).await?;
+        }
+
         socket
             .send_packet_static(&CryptoHandshakeResponsePacket {
                 key: self.game_server.public_key.clone().into(),
@@ -322,7 +345,12 @@ impl UnauthorizedThread {
                 "Invalid account/user ID was sent ({} and {}). Please note that you must be signed into a Geometry Dash account before connecting.",
                 packet.account_id, packet.user_id
             );
-            socket.send_packet_dynamic(&LoginFailedPacket { message: &message }).await?;
+            socket
+                .send_packet_dynamic(&LoginFailedPacket {
+                    message: &message,
+                    token_rejected: false,
+                })
+                .await?;
             return Ok(());
         }
 
@@ -346,7 +374,12 @@ impl UnauthorizedThread {
                     let mut message = FastString::new("authentication failed: ");
                     message.extend(err.error_message());
 
-                    socket.send_packet_dynamic(&LoginFailedPacket { message: &message }).await?;
+                    socket
+                        .send_packet_dynamic(&LoginFailedPacket {
+                            message: &message,
+                            token_rejected: true,
+                        })
+                        .await?;
                     return Ok(());
                 }
             }
@@ -372,6 +405,7 @@ impl UnauthorizedThread {
                     socket
                         .send_packet_dynamic(&LoginFailedPacket {
                             message: "This server has whitelist enabled and your account has not been allowed.",
+                            token_rejected: false,
                         })
                         .await?;
 
@@ -382,7 +416,12 @@ impl UnauthorizedThread {
                     let mut message = InlineString::<256>::new("failed to fetch user data: ");
                     message.extend_safe(&err.to_string());
 
-                    socket.send_packet_dynamic(&LoginFailedPacket { message: &message }).await?;
+                    socket
+                        .send_packet_dynamic(&LoginFailedPacket {
+                            message: &message,
+                            token_rejected: false,
+                        })
+                        .await?;
                     return Ok(());
                 }
             };
@@ -4,6 +4,8 @@ pub const MAX_NOTICE_SIZE: usize = 224;
 pub const MAX_MESSAGE_SIZE: usize = 156;
 /// amount of chars in a room id string (6)
 pub const ROOM_ID_LENGTH: usize = 6;
+/// maximum amount of profiles in a `RequestPlayerProfilesBatchPacket` (64)
+pub const MAX_PROFILE_BATCH: usize = 64;
 
 // this should be the PlayerData size plus some headroom
 pub const SMALL_PACKET_LIMIT: usize = 96;
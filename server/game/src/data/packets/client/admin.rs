@@ -43,3 +43,16 @@ pub struct AdminGetUserStatePacket {
 pub struct AdminUpdateUserPacket {
     pub user_entry: UserEntry,
 }
+
+/// same as `AdminGetUserStatePacket` but for many players at once, answered with a single `AdminUsersDataPacket`
+#[derive(Packet, Decodable)]
+#[packet(id = 19005)]
+pub struct AdminGetUsersPacket {
+    pub players: FastVec<FastString, 32>,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 19006)]
+pub struct AdminSearchUsersPacket {
+    pub prefix: FastString,
+}
@@ -6,16 +6,36 @@ pub struct PingPacket {
     pub id: u32,
 }
 
-#[derive(Packet, Decodable)]
+#[derive(Packet)]
 #[packet(id = 10001)]
 pub struct CryptoHandshakeStartPacket {
     pub protocol: u16,
     pub key: CryptoPublicKey,
+    /// bitmask of `SessionCipher`s the client supports
+    pub ciphers: u8,
+}
+
+impl Decodable for CryptoHandshakeStartPacket {
+    fn decode_from_reader(buf: &mut ByteReader) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        let protocol = buf.read_u16()?;
+        let key = buf.read_value()?;
+
+        // older clients don't send it, and they should still get a `ProtocolMismatchPacket` back instead of a decode error
+        let ciphers = if buf.get_rpos() < buf.len() { buf.read_u8()? } else { 1 };
+
+        Ok(Self { protocol, key, ciphers })
+    }
 }
 
 #[derive(Packet, Decodable)]
 #[packet(id = 10002)]
-pub struct KeepalivePacket;
+pub struct KeepalivePacket {
+    /// client clock in microseconds, echoed back in the response
+    pub client_time: u64,
+}
 
 pub const MAX_TOKEN_SIZE: usize = 164;
 
@@ -28,6 +28,43 @@ pub struct PlayerMetadataPacket {
     pub data: PlayerMetadata,
 }
 
+#[derive(Packet, Decodable)]
+#[packet(id = 12005)]
+pub struct PlayerDataDeltaPacket {
+    pub delta: PlayerDataDelta,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12006)]
+pub struct PlayerViewportPacket {
+    pub origin: Point,
+    pub size: Point,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12007)]
+pub struct RequestPlayerProfilesBatchPacket {
+    pub requested: FastVec<i32, MAX_PROFILE_BATCH>,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12008)]
+pub struct VoiceProximityPacket {
+    pub range: FiniteF32, // 0 if the client hears everyone on the level
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12012)]
+pub struct LinkPlayerPacket {
+    pub player_id: i32, // 0 to unlink
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12013)]
+pub struct LinkedPlayerDataPacket {
+    pub data: PlayerData,
+}
+
 #[derive(Packet, Decodable)]
 #[packet(id = 12010, encrypted = true)]
 pub struct VoicePacket {
@@ -12,10 +12,34 @@ pub struct RequestGlobalPlayerListPacket;
 
 #[derive(Packet, Decodable)]
 #[packet(id = 11002)]
-pub struct RequestLevelListPacket;
+pub struct RequestLevelListPacket {
+    /// version of the list the client already has, 0 if it has none. if it's still current, only the changes are sent
+    pub known_version: u32,
+    /// echoed in every response, so the client can tell responses to an older request apart
+    pub request_id: u32,
+}
 
 #[derive(Packet, Decodable)]
 #[packet(id = 11003)]
 pub struct RequestPlayerCountPacket {
     pub level_ids: FastVec<LevelId, 128>,
 }
+
+#[derive(Packet, Decodable)]
+#[packet(id = 11004)]
+pub struct SubscribePlayerCountsPacket {
+    pub level_ids: FastVec<LevelId, 128>,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 11005)]
+pub struct RequestPlayerListPagePacket {
+    /// only players whose name starts with this (case insensitive), empty for everyone
+    pub name_prefix: InlineString<MAX_NAME_SIZE>,
+    /// only players with one of these account ids, empty for everyone
+    pub only_ids: FastVec<i32, 512>,
+    /// the page starts after this player in the list order (name, then account id), empty name and 0 for the first page
+    pub after_name: InlineString<MAX_NAME_SIZE>,
+    pub after_id: i32,
+    pub limit: u16,
+}
@@ -38,3 +38,15 @@ pub struct RoomSendInvitePacket {
 #[derive(Packet, Decodable)]
 #[packet(id = 13006)]
 pub struct RequestRoomListPacket;
+
+#[derive(Packet, Decodable)]
+#[packet(id = 13007)]
+pub struct RequestRoomListPagePacket {
+    /// only rooms with this in their name (case insensitive), empty for every room
+    pub name_filter: InlineString<32>,
+    /// sort by name instead of by player count (descending), ties are sorted by room id
+    pub sort_by_name: bool,
+    /// how many rooms to skip, the amount the client already has
+    pub offset: u32,
+    pub limit: u16,
+}
@@ -19,17 +19,32 @@ pub trait PacketMetadata {
 #[derive(Encodable, Decodable, StaticSize)]
 pub struct PacketHeader {
     pub packet_id: u16,
-    pub encrypted: bool,
+    /// `FLAG_*` bits. this used to be the `encrypted` bool, so older clients still read bit 0 correctly
+    pub flags: u8,
 }
 
 impl PacketHeader {
+    pub const FLAG_ENCRYPTED: u8 = 1 << 0;
+    /// only set by the server, see `ClientSocket::send_packet_compressed`
+    pub const FLAG_COMPRESSED: u8 = 1 << 1;
+
     #[inline]
     pub const fn from_packet<P: PacketMetadata>() -> Self {
         Self {
             packet_id: P::PACKET_ID,
-            encrypted: P::ENCRYPTED,
+            flags: if P::ENCRYPTED { Self::FLAG_ENCRYPTED } else { 0 },
         }
     }
 
+    #[inline]
+    pub const fn encrypted(&self) -> bool {
+        self.flags & Self::FLAG_ENCRYPTED != 0
+    }
+
+    #[inline]
+    pub const fn compressed(&self) -> bool {
+        self.flags & Self::FLAG_COMPRESSED != 0
+    }
+
     pub const SIZE: usize = Self::ENCODED_SIZE;
 }
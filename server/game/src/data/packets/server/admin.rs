@@ -30,3 +30,18 @@ pub struct AdminSuccessMessagePacket<'a> {
 #[derive(Packet, Encodable, StaticSize)]
 #[packet(id = 29004, tcp = true)]
 pub struct AdminAuthFailedPacket;
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 29005, tcp = true, encrypted = true)]
+pub struct AdminUsersDataPacket {
+    pub users: Vec<(UserEntry, Option<PlayerRoomPreviewAccountData>)>,
+    /// names or account ids from the request that weren't found
+    pub missing: Vec<FastString>,
+}
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 29006, tcp = true)]
+pub struct AdminUserSearchResultsPacket {
+    /// online players only, sorted by name
+    pub players: Vec<PlayerRoomPreviewAccountData>,
+}
@@ -17,6 +17,9 @@ pub struct CryptoHandshakeResponsePacket {
 #[packet(id = 20002, tcp = false)]
 pub struct KeepaliveResponsePacket {
     pub player_count: u32,
+    pub client_time: u64,
+    /// see `GameServer::clock_micros`
+    pub server_time: u64,
 }
 
 #[derive(Packet, Encodable, DynamicSize)]
@@ -38,6 +41,8 @@ pub struct LoggedInPacket {
 #[packet(id = 20005, tcp = true)]
 pub struct LoginFailedPacket<'a> {
     pub message: &'a str,
+    /// the token didn't validate, a new one from the central server may work
+    pub token_rejected: bool,
 }
 
 #[derive(Packet, Encodable, DynamicSize)]
@@ -59,6 +64,13 @@ pub struct ClaimThreadFailedPacket;
 #[packet(id = 20009, tcp = true)]
 pub struct LoginRecoveryFailedPacket;
 
+/// the cipher picked for the session box, see `SessionCipher`
+#[derive(Packet, Encodable, StaticSize)]
+#[packet(id = 20010, tcp = true)]
+pub struct SessionCipherPacket {
+    pub cipher: u8,
+}
+
 // used to communicate a simple message to the user
 #[derive(Packet, Encodable, DynamicSize, Clone)]
 #[packet(id = 20100, tcp = false)]
@@ -9,15 +9,35 @@ pub struct PlayerProfilesPacket {
 #[derive(Packet, Encodable)]
 #[packet(id = 22001, tcp = false)]
 pub struct LevelDataPacket {
+    /// incremented for every level data datagram, lets the client see lost and reordered packets
+    pub sequence: u32,
+    /// milliseconds since the client connected, lets the client calculate jitter
+    pub timestamp: u32,
     pub players: Vec<AssociatedPlayerData>,
 }
 
+#[derive(Packet, Encodable)]
+#[packet(id = 22003, tcp = false)]
+pub struct QuantizedLevelDataPacket<'a> {
+    pub sequence: u32,
+    pub timestamp: u32,
+    pub anchor: Point,
+    pub players: Vec<QuantizedPlayerData<'a>>,
+}
+
 #[derive(Packet, Encodable, DynamicSize)]
 #[packet(id = 22002, tcp = true)]
 pub struct LevelPlayerMetadataPacket {
     pub players: Vec<AssociatedPlayerMetadata>,
 }
 
+/// tps the client should send player data at on its current level, lower than the server tps on crowded levels
+#[derive(Packet, Encodable, StaticSize)]
+#[packet(id = 22004, tcp = true)]
+pub struct LevelTpsPacket {
+    pub tps: u32,
+}
+
 #[derive(Packet, Encodable, DynamicSize)]
 #[packet(id = 22010, encrypted = true, tcp = false)]
 pub struct VoiceBroadcastPacket {
@@ -25,9 +45,23 @@ pub struct VoiceBroadcastPacket {
     pub data: FastEncodedAudioFrame,
 }
 
+/// frames of several speakers in one datagram. every entry is the sender (i32), the frame length (u16) and the frame itself.
+/// only encoded by hand in `ClientThread::send_voice`
+#[derive(Packet)]
+#[packet(id = 22012, encrypted = true, tcp = false)]
+pub struct VoiceBundlePacket;
+
 #[derive(Clone, Packet, Encodable, StaticSize)]
 #[packet(id = 22011, encrypted = true, tcp = false)]
 pub struct ChatMessageBroadcastPacket {
     pub player_id: i32,
     pub message: InlineString<MAX_MESSAGE_SIZE>,
 }
+
+/// player data forwarded straight to the player that the sender is linked to in two player mode, see `LinkPlayerPacket`
+#[derive(Packet, Encodable, StaticSize)]
+#[packet(id = 22013, tcp = false)]
+pub struct LinkedPlayerDataBroadcastPacket {
+    pub player_id: i32,
+    pub data: PlayerData,
+}
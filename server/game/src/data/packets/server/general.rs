@@ -14,6 +14,9 @@ pub struct GlobalPlayerListPacket {
 #[packet(id = 21001, tcp = true)]
 pub struct LevelListPacket {
     pub levels: Vec<GlobedLevel>,
+    pub is_final: bool,
+    pub version: u32,
+    pub request_id: u32,
 }
 
 #[derive(Packet, Encodable, DynamicSize)]
@@ -22,6 +25,24 @@ pub struct LevelPlayerCountPacket {
     pub levels: Vec<(LevelId, u16)>,
 }
 
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 21004, tcp = true)]
+pub struct LevelListDeltaPacket {
+    pub base_version: u32,
+    pub version: u32,
+    /// levels whose player count changed, a count of 0 means the level is no longer on the list
+    pub changes: Vec<GlobedLevel>,
+    pub request_id: u32,
+}
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 21005, tcp = true)]
+pub struct PlayerListPagePacket {
+    /// sorted by name (case insensitive) and then account id
+    pub players: Vec<PlayerPreviewAccountData>,
+    pub has_more: bool,
+}
+
 #[derive(Packet, Encodable, StaticSize, Clone)]
 #[packet(id = 21003)]
 pub struct RolesUpdatedPacket {
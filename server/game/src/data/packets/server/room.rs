@@ -23,6 +23,8 @@ pub struct RoomJoinFailedPacket {
 pub struct RoomPlayerListPacket {
     pub room_info: RoomInfo,
     pub players: Vec<PlayerRoomPreviewAccountData>,
+    /// version of the room the list was taken at, `RoomPlayersDiffPacket`s continue from it
+    pub version: u32,
 }
 
 #[derive(Packet, Encodable, StaticSize, DynamicSize, Clone)]
@@ -50,3 +52,21 @@ pub struct RoomListPacket {
 pub struct RoomCreateFailedPacket<'a> {
     pub reason: &'a str,
 }
+
+/// Sent to everyone in a room (except the global room) when someone joins, leaves, or their preview changes.
+/// `updated` players should be added or replaced, `removed` ones removed. If `version` is not exactly one more
+/// than the last known one, a diff was missed and the client should request the full list again.
+#[derive(Packet, Encodable, DynamicSize, Clone)]
+#[packet(id = 23008, tcp = true)]
+pub struct RoomPlayersDiffPacket {
+    pub version: u32,
+    pub updated: Vec<PlayerRoomPreviewAccountData>,
+    pub removed: Vec<i32>,
+}
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 23009, tcp = true)]
+pub struct RoomListPagePacket {
+    pub rooms: Vec<RoomListingInfo>,
+    pub has_more: bool,
+}
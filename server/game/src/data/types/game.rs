@@ -28,15 +28,113 @@ pub struct SpiderTeleportData {
 }
 
 /* SpecificIconData (specific player data) */
-// 16 bytes best-case, 32 bytes worst-case (when on the same frame as spider TP).
+// always 15 bytes.
 
 #[derive(Clone, Debug, Default, Encodable, Decodable, StaticSize, DynamicSize)]
+#[dynamic_size(as_static = true)]
 pub struct SpecificIconData {
     pub position: Point,
     pub rotation: FiniteF32,
     pub icon_type: PlayerIconType,
     pub flags: Bits<2>, // bit-field with various flags, see the client-side structure for more info
-    pub spider_teleport_data: Option<SpiderTeleportData>,
+}
+
+/* PlayerEventList (jumps, deaths and spider teleports) */
+// events are repeated by the client in a few consecutive frames, the server relays them as they are
+// and the receiving client skips the ones it has already seen, see the client-side `PlayerEvent` structure.
+// 1 byte best-case, 77 bytes worst-case (4 spider teleports).
+
+pub const MAX_PLAYER_EVENTS: usize = 4;
+
+const EVENT_SPIDER_TELEPORT: u8 = 2;
+const EVENT_TYPE_MASK: u8 = 0x7f; // the top bit is the icon the event is for
+
+#[derive(Clone, Debug, Default)]
+pub struct PlayerEvent {
+    pub sequence: u16,
+    pub kind: u8,
+    pub teleport: Option<SpiderTeleportData>,
+}
+
+#[derive(Clone, Debug, Default)]
+pub struct PlayerEventList {
+    events: [PlayerEvent; MAX_PLAYER_EVENTS],
+    len: u8,
+}
+
+impl PlayerEventList {
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    #[inline]
+    pub fn iter(&self) -> impl Iterator<Item = &PlayerEvent> {
+        self.events[..self.len as usize].iter()
+    }
+}
+
+macro_rules! encode_events {
+    ($self:expr, $buf:expr) => {
+        $buf.write_u8($self.len);
+        for event in $self.iter() {
+            $buf.write_u16(event.sequence);
+            $buf.write_u8(event.kind);
+            if let Some(teleport) = &event.teleport {
+                $buf.write_value(teleport);
+            }
+        }
+    };
+}
+
+impl Encodable for PlayerEventList {
+    fn encode(&self, buf: &mut ByteBuffer) {
+        encode_events!(self, buf);
+    }
+
+    fn encode_fast(&self, buf: &mut FastByteBuffer) {
+        encode_events!(self, buf);
+    }
+}
+
+impl Decodable for PlayerEventList {
+    fn decode_from_reader(buf: &mut ByteReader) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        let len = buf.read_u8()?;
+        if len as usize > MAX_PLAYER_EVENTS {
+            return Err(DecodeError::NotEnoughCapacity);
+        }
+
+        let mut list = Self { len, ..Default::default() };
+
+        for event in &mut list.events[..len as usize] {
+            event.sequence = buf.read_u16()?;
+            event.kind = buf.read_u8()?;
+            event.teleport = match event.kind & EVENT_TYPE_MASK {
+                EVENT_SPIDER_TELEPORT => Some(buf.read_value()?),
+                kind if kind < EVENT_SPIDER_TELEPORT => None,
+                _ => return Err(DecodeError::InvalidEnumValue),
+            };
+        }
+
+        Ok(list)
+    }
+}
+
+impl StaticSize for PlayerEventList {
+    const ENCODED_SIZE: usize = size_of_types!(u8) + size_of_types!(u16, u8, SpiderTeleportData) * MAX_PLAYER_EVENTS;
+}
+
+impl DynamicSize for PlayerEventList {
+    fn encoded_size(&self) -> usize {
+        size_of_types!(u8)
+            + self
+                .iter()
+                .map(|event| size_of_types!(u16, u8) + if event.teleport.is_some() { size_of_types!(SpiderTeleportData) } else { 0 })
+                .sum::<usize>()
+    }
 }
 
 /* PlayerMetadata (player things that are sent less often) */
@@ -49,18 +147,271 @@ pub struct PlayerMetadata {
 }
 
 /* PlayerData (data in a level) */
-// 45 bytes best-case, 77 bytes worst-case (with 2 spider teleports).
+// 44 bytes best-case, 120 bytes worst-case (with 4 spider teleports).
+// Timestamps are seconds on the server clock (see `GameServer::clock_micros`), doubles so they stay precise on long running servers.
 
 #[derive(Clone, Debug, Default, Encodable, Decodable, StaticSize, DynamicSize)]
 pub struct PlayerData {
-    pub timestamp: FiniteF32,
+    pub timestamp: FiniteF64,
 
     pub player1: SpecificIconData,
     pub player2: SpecificIconData,
 
-    pub last_death_timestamp: FiniteF32,
-
     pub current_percentage: FiniteF32,
 
     pub flags: Bits<1>, // also a bit-field
+
+    pub events: PlayerEventList,
+}
+
+// position of the flag in `PlayerData::flags`, the client writes them from the most significant bit
+const FLAG_IN_EDITOR: usize = 4;
+const FLAG_EDITOR_BUILDING: usize = 5;
+
+/// voice is forwarded a bit further than the listener's range, positions are only as fresh as the last player data
+const VOICE_RANGE_LEEWAY: f32 = 1.25;
+
+impl PlayerData {
+    /// in the editor, either building or playtesting
+    #[inline]
+    pub fn is_in_editor(&self) -> bool {
+        self.flags.get_bit(FLAG_IN_EDITOR)
+    }
+
+    /// in the editor and not playtesting, the icons are blank then and only the status matters
+    #[inline]
+    pub fn is_editor_building(&self) -> bool {
+        self.flags.get_bit(FLAG_EDITOR_BUILDING)
+    }
+
+    /// whether this player can hear `speaker` with proximity voice that fades out at `range` units.
+    /// players in the editor are heard from anywhere, same as on the client.
+    pub fn can_hear(&self, speaker: &PlayerData, range: f32) -> bool {
+        if speaker.is_in_editor() {
+            return true;
+        }
+
+        let dx = self.player1.position.x.get() - speaker.player1.position.x.get();
+        let dy = self.player1.position.y.get() - speaker.player1.position.y.get();
+        let range = range * VOICE_RANGE_LEEWAY;
+
+        dx * dx + dy * dy <= range * range
+    }
+}
+
+/* PlayerDataDelta (player data encoded relative to an earlier keyframe) */
+// see the client-side `PlayerDataDelta` structure for the wire format.
+
+const DELTA_POSITION: u16 = 1 << 0;
+const DELTA_ROTATION: u16 = 1 << 1;
+const DELTA_STATE: u16 = 1 << 2;
+const DELTA_ICON_BITS: u16 = 3;
+const DELTA_EVENTS: u16 = 1 << 8;
+const DELTA_PERCENTAGE: u16 = 1 << 9;
+const DELTA_FLAGS: u16 = 1 << 10;
+
+#[derive(Clone, Debug, Default)]
+pub struct SpecificIconDataDelta {
+    pub position: Option<Point>,
+    pub rotation: Option<FiniteF32>,
+    pub state: Option<(PlayerIconType, Bits<2>)>,
+}
+
+impl SpecificIconDataDelta {
+    fn decode_with_mask(buf: &mut ByteReader, mask: u16) -> DecodeResult<Self> {
+        Ok(Self {
+            position: if mask & DELTA_POSITION != 0 { Some(buf.read_value()?) } else { None },
+            rotation: if mask & DELTA_ROTATION != 0 { Some(buf.read_value()?) } else { None },
+            state: if mask & DELTA_STATE != 0 {
+                Some((buf.read_value()?, buf.read_value()?))
+            } else {
+                None
+            },
+        })
+    }
+
+    fn apply_to(&self, base: &SpecificIconData) -> SpecificIconData {
+        let (icon_type, flags) = self.state.unwrap_or((base.icon_type, base.flags));
+
+        SpecificIconData {
+            position: self.position.unwrap_or(base.position),
+            rotation: self.rotation.unwrap_or(base.rotation),
+            icon_type,
+            flags,
+        }
+    }
+}
+
+#[derive(Clone, Debug, Default)]
+pub struct PlayerDataDelta {
+    pub keyframe_id: u8,
+    pub keyframe: bool,
+
+    pub timestamp: FiniteF64,
+
+    pub player1: SpecificIconDataDelta,
+    pub player2: SpecificIconDataDelta,
+
+    pub current_percentage: Option<FiniteF32>,
+    pub flags: Option<Bits<1>>,
+    pub events: PlayerEventList,
+}
+
+impl PlayerDataDelta {
+    /// build the full player data by applying the changes on top of `base`
+    pub fn apply_to(&self, base: &PlayerData) -> PlayerData {
+        PlayerData {
+            timestamp: self.timestamp,
+            player1: self.player1.apply_to(&base.player1),
+            player2: self.player2.apply_to(&base.player2),
+            current_percentage: self.current_percentage.unwrap_or(base.current_percentage),
+            flags: self.flags.unwrap_or(base.flags),
+            // events belong to the frame they're sent with and never carry over from the keyframe
+            events: self.events.clone(),
+        }
+    }
+}
+
+impl Decodable for PlayerDataDelta {
+    fn decode_from_reader(buf: &mut ByteReader) -> DecodeResult<Self>
+    where
+        Self: Sized,
+    {
+        let keyframe_id = buf.read_u8()?;
+        let keyframe = buf.read_bool()?;
+        let mask = buf.read_u16()?;
+
+        Ok(Self {
+            keyframe_id,
+            keyframe,
+            timestamp: buf.read_value()?,
+            player1: SpecificIconDataDelta::decode_with_mask(buf, mask)?,
+            player2: SpecificIconDataDelta::decode_with_mask(buf, mask >> DELTA_ICON_BITS)?,
+            current_percentage: if mask & DELTA_PERCENTAGE != 0 { Some(buf.read_value()?) } else { None },
+            flags: if mask & DELTA_FLAGS != 0 { Some(buf.read_value()?) } else { None },
+            events: if mask & DELTA_EVENTS != 0 { buf.read_value()? } else { PlayerEventList::default() },
+        })
+    }
+}
+
+/* QuantizedPlayerData (compact encoding of PlayerData, used in QuantizedLevelDataPacket) */
+// positions are encoded as 16-bit fixed-point offsets from an anchor, and rotations as 16-bit fractions of a full turn.
+// positions too far from the anchor are written in full, prefixed with `QUANTIZED_POSITION_ESCAPE`.
+
+pub const QUANTIZED_POSITION_SCALE: f32 = 4.0;
+pub const QUANTIZED_POSITION_ESCAPE: i16 = i16::MIN;
+
+pub struct QuantizedPlayerData<'a> {
+    pub anchor: Point,
+    pub account_id: i32,
+    pub data: &'a PlayerData,
+}
+
+#[inline]
+#[allow(clippy::cast_possible_truncation)]
+fn quantize_offset(value: FiniteF32, anchor: FiniteF32) -> Option<i16> {
+    let offset = ((value.get() - anchor.get()) * QUANTIZED_POSITION_SCALE).round();
+
+    if offset > f32::from(QUANTIZED_POSITION_ESCAPE) && offset <= f32::from(i16::MAX) {
+        Some(offset as i16)
+    } else {
+        None
+    }
+}
+
+#[inline]
+fn quantize_rotation(rotation: FiniteF32) -> u16 {
+    #[allow(clippy::cast_possible_truncation, clippy::cast_sign_loss)]
+    let q = (rotation.get().rem_euclid(360.0) / 360.0 * 65536.0) as u32;
+    (q & 0xffff) as u16
+}
+
+macro_rules! encode_quantized_icon {
+    ($buf:expr, $anchor:expr, $icon:expr) => {
+        match (quantize_offset($icon.position.x, $anchor.x), quantize_offset($icon.position.y, $anchor.y)) {
+            (Some(x), Some(y)) => {
+                $buf.write_i16(x);
+                $buf.write_i16(y);
+            }
+            _ => {
+                $buf.write_i16(QUANTIZED_POSITION_ESCAPE);
+                $buf.write_value(&$icon.position);
+            }
+        }
+
+        $buf.write_u16(quantize_rotation($icon.rotation));
+        $buf.write_value(&$icon.icon_type);
+        $buf.write_value(&$icon.flags);
+    };
+}
+
+macro_rules! encode_quantized {
+    ($self:expr, $buf:expr) => {
+        $buf.write_i32($self.account_id);
+        $buf.write_value(&$self.data.timestamp);
+        encode_quantized_icon!($buf, $self.anchor, $self.data.player1);
+        encode_quantized_icon!($buf, $self.anchor, $self.data.player2);
+        $buf.write_value(&$self.data.current_percentage);
+        $buf.write_value(&$self.data.flags);
+        $buf.write_value(&$self.data.events);
+    };
+}
+
+impl Encodable for QuantizedPlayerData<'_> {
+    fn encode(&self, buf: &mut ByteBuffer) {
+        encode_quantized!(self, buf);
+    }
+
+    fn encode_fast(&self, buf: &mut FastByteBuffer) {
+        encode_quantized!(self, buf);
+    }
+}
+
+impl StaticSize for QuantizedPlayerData<'_> {
+    // worst case: both positions escaped, which takes 2 bytes more than a full point, while rotation takes 2 bytes less.
+    const ENCODED_SIZE: usize = size_of_types!(i32, PlayerData);
+}
+
+impl DynamicSize for QuantizedPlayerData<'_> {
+    fn encoded_size(&self) -> usize {
+        Self::ENCODED_SIZE
+    }
+}
+
+/* InterestArea (part of the level a client is looking at) */
+
+#[derive(Clone, Copy, Debug)]
+pub struct InterestArea {
+    pub min_x: f32,
+    pub min_y: f32,
+    pub max_x: f32,
+    pub max_y: f32,
+}
+
+impl InterestArea {
+    /// build an area from the client's camera, extended to 3 screens in each direction,
+    /// same as `ComplexVisualPlayer::isPlayerNearby` on the client.
+    pub fn from_viewport(origin: Point, size: Point) -> Self {
+        let (x, y) = (origin.x.get(), origin.y.get());
+        let (w, h) = (size.x.get().abs(), size.y.get().abs());
+
+        Self {
+            min_x: x - w,
+            min_y: y - h,
+            max_x: x + w * 2.0,
+            max_y: y + h * 2.0,
+        }
+    }
+
+    #[inline]
+    fn contains_point(&self, point: Point) -> bool {
+        let (x, y) = (point.x.get(), point.y.get());
+        x >= self.min_x && x <= self.max_x && y >= self.min_y && y <= self.max_y
+    }
+
+    /// whether either of the player's icons is inside of the area
+    #[inline]
+    pub fn contains(&self, data: &PlayerData) -> bool {
+        self.contains_point(data.player1.position) || self.contains_point(data.player2.position)
+    }
 }
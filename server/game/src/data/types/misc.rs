@@ -1,10 +1,10 @@
 use crate::data::*;
 
-#[derive(Encodable, StaticSize, DynamicSize)]
-#[dynamic_size(as_static = true)]
+/// level ids and player counts are mostly small numbers, so they are sent as varints
+#[derive(Encodable, DynamicSize, Clone)]
 pub struct GlobedLevel {
-    pub level_id: LevelId,
-    pub player_count: u16,
+    pub level_id: VarInt,
+    pub player_count: VarUint,
 }
 
 #[derive(Encodable, Decodable, StaticSize, DynamicSize)]
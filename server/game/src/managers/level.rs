@@ -1,8 +1,12 @@
+use std::time::{Duration, Instant};
+
 use globed_shared::IntMap;
 
+use esp::{size_of_types, ByteBufferExtWrite, FastByteBuffer, StaticSize};
+
 use crate::data::{
     types::PlayerData, AssociatedPlayerData, AssociatedPlayerMetadata, BorrowedAssociatedPlayerData, BorrowedAssociatedPlayerMetadata, LevelId,
-    PlayerMetadata,
+    PlayerMetadata, Point, QuantizedPlayerData,
 };
 
 #[derive(Default)]
@@ -10,9 +14,36 @@ pub struct LevelManagerPlayer {
     pub account_id: i32,
     pub data: PlayerData,
     pub meta: PlayerMetadata,
+    /// `data` already encoded as an `AssociatedPlayerData`. it's refreshed once whenever the data changes,
+    /// so level data responses copy it instead of encoding every player again for every recipient.
+    pub encoded_data: Vec<u8>,
 }
 
 impl LevelManagerPlayer {
+    pub fn new(account_id: i32) -> Self {
+        let mut player = Self {
+            account_id,
+            ..Default::default()
+        };
+
+        player.encode_data();
+        player
+    }
+
+    fn encode_data(&mut self) {
+        let mut encoded = std::mem::take(&mut self.encoded_data);
+        encoded.resize(size_of_types!(AssociatedPlayerData), 0);
+
+        let len = {
+            let mut buf = FastByteBuffer::new(&mut encoded);
+            buf.write_value(&self.to_borrowed_associated_data());
+            buf.len()
+        };
+
+        encoded.truncate(len);
+        self.encoded_data = encoded;
+    }
+
     pub fn to_associated_data(&self) -> AssociatedPlayerData {
         AssociatedPlayerData {
             account_id: self.account_id,
@@ -27,6 +58,14 @@ impl LevelManagerPlayer {
         }
     }
 
+    pub fn to_quantized_data(&self, anchor: Point) -> QuantizedPlayerData {
+        QuantizedPlayerData {
+            anchor,
+            account_id: self.account_id,
+            data: &self.data,
+        }
+    }
+
     pub fn to_associated_meta(&self) -> AssociatedPlayerMetadata {
         AssociatedPlayerMetadata {
             account_id: self.account_id,
@@ -42,11 +81,20 @@ impl LevelManagerPlayer {
     }
 }
 
+/// how many players on one level can talk at once, in rooms with the `limit_speakers` setting
+pub const MAX_LEVEL_SPEAKERS: usize = 6;
+/// a speaker keeps their slot for this long after their last voice frame, so pauses between sentences don't lose it
+const SPEAKER_SLOT_TIMEOUT: Duration = Duration::from_millis(1500);
+
 // Manages an entire room (all levels and players inside of it).
 #[derive(Default)]
 pub struct LevelManager {
     pub players: IntMap<i32, LevelManagerPlayer>, // player id : associated data
     pub levels: IntMap<LevelId, Vec<i32>>,        // level id : [player id]
+    /// level id : [(player id, time of their last voice frame)], only used when speakers are limited
+    speakers: IntMap<LevelId, Vec<(i32, Instant)>>,
+    /// bumped whenever the player count of any level changes
+    count_generation: u64,
 }
 
 impl LevelManager {
@@ -59,25 +107,18 @@ impl LevelManager {
     }
 
     pub fn create_player(&mut self, account_id: i32) {
-        self.players.insert(
-            account_id,
-            LevelManagerPlayer {
-                account_id,
-                ..Default::default()
-            },
-        );
+        self.players.insert(account_id, LevelManagerPlayer::new(account_id));
     }
 
     fn get_or_create_player(&mut self, account_id: i32) -> &mut LevelManagerPlayer {
-        self.players.entry(account_id).or_insert_with(|| LevelManagerPlayer {
-            account_id,
-            ..Default::default()
-        })
+        self.players.entry(account_id).or_insert_with(|| LevelManagerPlayer::new(account_id))
     }
 
     /// set player's data, inserting a new entry if doesn't already exist
     pub fn set_player_data(&mut self, account_id: i32, data: &PlayerData) {
-        self.get_or_create_player(account_id).data.clone_from(data);
+        let player = self.get_or_create_player(account_id);
+        player.data.clone_from(data);
+        player.encode_data();
     }
 
     /// set player's metadata, inserting a new entry if it doesn't already exist
@@ -105,6 +146,12 @@ impl LevelManager {
         self.levels.get(&level_id).map(Vec::len)
     }
 
+    /// get a counter that changes whenever the player count of any level in the room changes,
+    /// so that player count subscribers can tell when nothing needs to be sent
+    pub fn get_count_generation(&self) -> u64 {
+        self.count_generation
+    }
+
     /// get the total amount of players
     pub fn get_total_player_count(&self) -> usize {
         self.players.len()
@@ -149,21 +196,49 @@ impl LevelManager {
         let players = self.levels.entry(level_id).or_insert_with(|| Vec::with_capacity(8));
         if !players.contains(&account_id) {
             players.push(account_id);
+            self.count_generation += 1;
         }
     }
 
     /// remove a player from a level given a level ID and an account ID
     pub fn remove_from_level(&mut self, level_id: LevelId, account_id: i32) {
+        let mut removed = false;
         let should_remove_level = self.levels.get_mut(&level_id).is_some_and(|level| {
             if let Some(index) = level.iter().position(|&x| x == account_id) {
                 level.remove(index);
+                removed = true;
             }
 
             level.is_empty()
         });
 
+        if removed {
+            self.count_generation += 1;
+        }
+
         if should_remove_level {
             self.levels.remove(&level_id);
+            self.speakers.remove(&level_id);
         }
     }
+
+    /// whether the player can talk on the level, when at most `MAX_LEVEL_SPEAKERS` players can talk at once.
+    /// the first voice frame claims a slot, and it's freed `SPEAKER_SLOT_TIMEOUT` after the last one.
+    pub fn claim_speaker_slot(&mut self, level_id: LevelId, account_id: i32) -> bool {
+        let now = Instant::now();
+        let slots = self.speakers.entry(level_id).or_default();
+        slots.retain(|(_, last_frame)| now.duration_since(*last_frame) < SPEAKER_SLOT_TIMEOUT);
+
+        if let Some(slot) = slots.iter_mut().find(|(id, _)| *id == account_id) {
+            slot.1 = now;
+            return true;
+        }
+
+        if slots.len() >= MAX_LEVEL_SPEAKERS {
+            return false;
+        }
+
+        slots.push((account_id, now));
+        true
+    }
 }
@@ -20,6 +20,8 @@ pub struct Room {
     pub password: InlineString<16>,
     pub manager: LevelManager,
     pub settings: RoomSettings,
+    /// bumped every time a `RoomPlayersDiffPacket` is sent for this room, so clients can notice a missed one
+    pub version: u32,
 }
 
 #[derive(Default)]
@@ -41,9 +43,16 @@ impl Room {
             password,
             manager,
             settings,
+            version: 0,
         }
     }
 
+    #[inline]
+    pub fn bump_version(&mut self) -> u32 {
+        self.version = self.version.wrapping_add(1);
+        self.version
+    }
+
     // Removes a player, if the player was the owner, rotates the owner and returns `true`.
     pub fn remove_player(&mut self, player: i32) -> bool {
         let was_owner = self.owner == player;
@@ -108,6 +117,10 @@ impl Room {
         self.settings.flags.two_player
     }
 
+    pub fn is_limit_speakers(&self) -> bool {
+        self.settings.flags.limit_speakers
+    }
+
     pub fn is_protected(&self) -> bool {
         !self.password.is_empty()
     }
@@ -1,8 +1,8 @@
 use std::{
-    collections::VecDeque,
-    net::{SocketAddr, SocketAddrV4},
+    collections::{BTreeSet, VecDeque},
+    net::{Ipv4Addr, SocketAddr, SocketAddrV4},
     sync::{atomic::Ordering, Arc},
-    time::Duration,
+    time::{Duration, Instant},
 };
 
 use globed_shared::{
@@ -56,6 +56,8 @@ pub struct GameServer {
     pub udp_socket: UdpSocket,
     /// map udp peer : thread
     pub clients: SyncMutex<FxHashMap<SocketAddrV4, Arc<ClientThread>>>,
+    /// lowercase name and udp peer of everyone in `clients`, so players can be found by name without going through every thread
+    pub name_index: SyncMutex<BTreeSet<(String, SocketAddrV4)>>,
     pub unauthorized_clients: SyncMutex<VecDeque<Arc<UnauthorizedThread>>>,
     pub unclaimed_threads: SyncMutex<VecDeque<Arc<ClientThread>>>,
     pub secret_key: SecretKey,
@@ -63,6 +65,8 @@ pub struct GameServer {
     pub bridge: CentralBridge,
     pub standalone: bool,
     pub large_packet_buffer: SyncMutex<Box<[u8]>>,
+    /// shared timeline for all clients, they sync their clocks to it through keepalives
+    pub clock_epoch: Instant,
 }
 
 impl GameServer {
@@ -75,6 +79,7 @@ impl GameServer {
             tcp_socket,
             udp_socket,
             clients: SyncMutex::new(FxHashMap::default()),
+            name_index: SyncMutex::new(BTreeSet::new()),
             unauthorized_clients: SyncMutex::new(VecDeque::new()),
             unclaimed_threads: SyncMutex::new(VecDeque::new()),
             secret_key,
@@ -82,9 +87,15 @@ impl GameServer {
             bridge,
             standalone,
             large_packet_buffer: SyncMutex::new(vec![0; LARGE_BUFFER_SIZE].into_boxed_slice()),
+            clock_epoch: Instant::now(),
         }
     }
 
+    /// Microseconds since the server was started, this is the clock that player data timestamps are synced to
+    pub fn clock_micros(&self) -> u64 {
+        self.clock_epoch.elapsed().as_micros() as u64
+    }
+
     pub async fn run(&'static self) -> ! {
         info!(
             "Server launched on {} (version: {})",
@@ -319,6 +330,9 @@ impl GameServer {
 
                     self.clients.lock().insert(udp_peer, thread.clone());
 
+                    let name = thread.account_data.lock().name.to_ascii_lowercase();
+                    self.name_index.lock().insert((name, udp_peer));
+
                     either_thread = EitherClientThread::Authorized(thread);
                 }
                 EitherClientThread::Authorized(thread) => {
@@ -332,6 +346,10 @@ impl GameServer {
                         // TODO
                         let udp_peer = unsafe { thread.socket.get() }.udp_peer.expect("no udp peer in established thread");
                         clients.remove(&udp_peer);
+                        drop(clients);
+
+                        let name = thread.account_data.lock().name.to_ascii_lowercase();
+                        self.name_index.lock().remove(&(name, udp_peer));
                     }
 
                     // wait until there are no more references to the thread
@@ -430,9 +448,57 @@ impl GameServer {
         }
     }
 
+    /// like `broadcast_user_message`, but listeners with proximity voice only get it if the speaker is in their range
     pub async fn broadcast_voice_packet(&self, vpkt: &Arc<VoiceBroadcastPacket>, level_id: LevelId, room_id: u32) {
-        self.broadcast_user_message(&ServerThreadMessage::BroadcastVoice(vpkt.clone()), vpkt.player_id, level_id, room_id)
-            .await;
+        let origin_id = vpkt.player_id;
+
+        let threads: Vec<_> = self.state.room_manager.with_any(room_id, |pm| {
+            // in large rooms, everyone else is silenced while the speaker slots are taken
+            if pm.is_limit_speakers() && !pm.manager.claim_speaker_slot(level_id, origin_id) {
+                return Vec::new();
+            }
+
+            let Some(players) = pm.manager.get_level(level_id) else {
+                return Vec::new();
+            };
+
+            // players that haven't sent any data yet have no position, so they are heard by everyone
+            let position_of = |account_id: i32| {
+                pm.manager
+                    .get_player_data(account_id)
+                    .map(|player| &player.data)
+                    .filter(|data| data.timestamp.get() != 0.0)
+            };
+
+            let speaker = position_of(origin_id);
+
+            self.clients
+                .lock()
+                .values()
+                .filter(|thread| {
+                    let account_id = thread.account_id.load(Ordering::Relaxed);
+                    if account_id == origin_id || !players.contains(&account_id) {
+                        return false;
+                    }
+
+                    let range = thread.voice_range();
+                    if range == 0.0 {
+                        return true;
+                    }
+
+                    match (speaker, position_of(account_id)) {
+                        (Some(speaker), Some(listener)) => listener.can_hear(speaker, range),
+                        _ => true,
+                    }
+                })
+                .cloned()
+                .collect()
+        });
+
+        let msg = ServerThreadMessage::BroadcastVoice(vpkt.clone());
+        for thread in threads {
+            thread.push_new_message(msg.clone()).await;
+        }
     }
 
     pub async fn broadcast_chat_packet(&self, tpkt: &ChatMessageBroadcastPacket, level_id: LevelId, room_id: u32) {
@@ -640,19 +706,43 @@ impl GameServer {
 
     /// If the passed string is numeric, tries to find a user by account ID, else by their account name.
     pub fn find_user(&self, name: &str) -> Option<Arc<ClientThread>> {
-        self.clients
+        // if it's a valid int, assume it's an account ID
+        if let Ok(account_id) = name.parse::<i32>() {
+            return self
+                .clients
+                .lock()
+                .values()
+                .find(|thr| thr.account_id.load(Ordering::Relaxed) == account_id)
+                .cloned();
+        }
+
+        // else assume it's a player name
+        let name = name.to_ascii_lowercase();
+        let peer = self
+            .name_index
             .lock()
-            .values()
-            .find(|thr| {
-                // if it's a valid int, assume it's an account ID
-                if let Ok(account_id) = name.parse::<i32>() {
-                    thr.account_id.load(Ordering::Relaxed) == account_id
-                } else {
-                    // else assume it's a player name
-                    thr.account_data.lock().name.eq_ignore_ascii_case(name)
-                }
-            })
-            .cloned()
+            .range((name.clone(), SocketAddrV4::new(Ipv4Addr::UNSPECIFIED, 0))..)
+            .next()
+            .filter(|(n, _)| *n == name)
+            .map(|(_, peer)| *peer)?;
+
+        self.clients.lock().get(&peer).cloned()
+    }
+
+    /// Up to `limit` online players whose name starts with `prefix` (case insensitive), sorted by name
+    pub fn find_users_by_prefix(&self, prefix: &str, limit: usize) -> Vec<Arc<ClientThread>> {
+        let prefix = prefix.to_ascii_lowercase();
+        let peers = self
+            .name_index
+            .lock()
+            .range((prefix.clone(), SocketAddrV4::new(Ipv4Addr::UNSPECIFIED, 0))..)
+            .take_while(|(name, _)| name.starts_with(&prefix))
+            .take(limit)
+            .map(|(_, peer)| *peer)
+            .collect::<Vec<_>>();
+
+        let clients = self.clients.lock();
+        peers.iter().filter_map(|peer| clients.get(peer).cloned()).collect()
     }
 
     /// Try to find a user by name or account ID, invoke the passed closure, and if it returns `true`,
@@ -679,6 +769,12 @@ impl GameServer {
         Ok(())
     }
 
+    /// send a `LevelPlayerMetadataPacket` with the changed metadata of a player to everyone else on the level
+    pub async fn broadcast_player_metadata(&self, pkt: Arc<LevelPlayerMetadataPacket>, origin_id: i32, level_id: LevelId, room_id: u32) {
+        self.broadcast_user_message(&ServerThreadMessage::BroadcastPlayerMetadata(pkt), origin_id, level_id, room_id)
+            .await;
+    }
+
     /* private handling stuff */
 
     /// broadcast a message to all people on the level
@@ -743,6 +839,31 @@ impl GameServer {
         }
     }
 
+    /// send `RoomPlayersDiffPacket` to all players in a room except `skip_id` (0 to skip nobody). does nothing for the global room,
+    /// with that many people it's cheaper for clients to request the list when they need it.
+    /// the player that caused the change must get it too, or their copy of the list ends up a version behind. the only one
+    /// to skip is a player that just joined the room, they are about to get the whole list anyway
+    pub async fn broadcast_room_players_diff(
+        &self,
+        room_id: u32,
+        skip_id: i32,
+        updated: Vec<PlayerRoomPreviewAccountData>,
+        removed: Vec<i32>,
+    ) {
+        if room_id == 0 {
+            return;
+        }
+
+        let version = self.state.room_manager.try_with_any(room_id, |room| Some(room.bump_version()), || None);
+
+        if let Some(version) = version {
+            let pkt = RoomPlayersDiffPacket { version, updated, removed };
+
+            self.broadcast_room_message(&ServerThreadMessage::BroadcastRoomPlayersDiff(Arc::new(pkt)), skip_id, room_id)
+                .await;
+        }
+    }
+
     /// Try to handle a packet that is not addressed to a specific thread, but to the game server.
     async fn try_udp_handle(&self, data: &[u8], peer: SocketAddrV4) -> anyhow::Result<bool> {
         let mut byte_reader = ByteReader::from_bytes(data);
@@ -827,6 +948,8 @@ impl GameServer {
         if was_owner && room_id != 0 {
             self.broadcast_room_info(room_id).await;
         }
+
+        self.broadcast_room_players_diff(room_id, 0, Vec::new(), vec![account_id]).await;
     }
 
     fn print_server_status(&self) {
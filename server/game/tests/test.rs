@@ -133,3 +133,64 @@ fn test_player_manager() {
         }
     }
 }
+
+#[test]
+fn test_player_data_delta() {
+    // keyframe id, not a keyframe, mask with only player 1 position and percentage
+    let mut buffer = ByteBuffer::new();
+    buffer.write_u8(3);
+    buffer.write_bool(false);
+    buffer.write_u16((1 << 0) | (1 << 9));
+    buffer.write_f32(1.5); // timestamp
+    buffer.write_f32(100.0); // player1 position
+    buffer.write_f32(200.0);
+    buffer.write_f32(42.0); // percentage
+
+    let mut reader = ByteReader::from_bytes(buffer.as_bytes());
+    let delta = reader.read_value::<PlayerDataDelta>().unwrap();
+    assert_eq!(delta.keyframe_id, 3);
+    assert!(!delta.keyframe);
+    assert!(delta.player2.position.is_none());
+
+    let mut base = PlayerData::default();
+    base.player1.rotation = reader_f32(90.0);
+    base.player2.position.x = reader_f32(7.0);
+
+    let data = delta.apply_to(&base);
+    assert_eq!(data.player1.position.x.to_string(), "100");
+    assert_eq!(data.player1.position.y.to_string(), "200");
+    assert_eq!(data.player1.rotation.to_string(), "90");
+    assert_eq!(data.player2.position.x.to_string(), "7");
+    assert_eq!(data.current_percentage.to_string(), "42");
+}
+
+#[test]
+fn test_interest_area() {
+    let origin = Point {
+        x: reader_f32(1000.0),
+        y: reader_f32(0.0),
+    };
+    let size = Point {
+        x: reader_f32(570.0),
+        y: reader_f32(320.0),
+    };
+
+    let area = InterestArea::from_viewport(origin, size);
+
+    let mut data = PlayerData::default();
+    data.player1.position.x = reader_f32(1200.0);
+    assert!(area.contains(&data));
+
+    data.player1.position.x = reader_f32(5000.0);
+    assert!(!area.contains(&data));
+
+    // the second icon being visible is enough
+    data.player2.position.x = reader_f32(500.0);
+    assert!(area.contains(&data));
+}
+
+fn reader_f32(val: f32) -> FiniteF32 {
+    let mut buffer = ByteBuffer::new();
+    buffer.write_f32(val);
+    ByteReader::from_bytes(buffer.as_bytes()).read_value().unwrap()
+}
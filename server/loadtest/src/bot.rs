@@ -0,0 +1,658 @@
+//! A single simulated player. It logs in the same way as the game client, joins a level and then keeps sending player data
+//! (and optionally voice) at a fixed rate, measuring how long the server takes to answer.
+
+use std::{
+    collections::VecDeque,
+    fmt::Display,
+    net::SocketAddr,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+    time::{Duration, Instant},
+};
+
+use globed_game_server::{
+    client::{PacketHandlingError, SessionBox, SessionCipher},
+    data::*,
+    managers::GameServerRole,
+};
+use globed_shared::{
+    crypto_box::{
+        aead::{AeadCore, AeadInPlace, OsRng},
+        ChaChaBox, SecretKey,
+    },
+    PROTOCOL_VERSION,
+};
+use tokio::{
+    io::{AsyncRead, AsyncReadExt, AsyncWriteExt},
+    net::{tcp::OwnedWriteHalf, TcpStream, UdpSocket},
+    sync::oneshot,
+    time::{interval, sleep, timeout, MissedTickBehavior},
+};
+
+use crate::{stats::BotReport, trace::TracePacket};
+
+// must match `MARKER_CONN_INITIAL` in the server
+const MARKER_CONN_INITIAL: u8 = 0xe0;
+
+// do not touch those, encryption related
+const NONCE_SIZE: usize = 24;
+const MAC_SIZE: usize = 16;
+
+const MAX_UDP_PACKET_SIZE: usize = 65536;
+/// room and profile lists can get a lot bigger than anything sent over udp
+const MAX_TCP_PACKET_SIZE: usize = 1 << 20;
+
+/// same as the client default, the server caps it to its own datagram size anyway
+const FRAGMENTATION_LIMIT: u16 = 65000;
+
+const LOGIN_TIMEOUT: Duration = Duration::from_secs(15);
+const CLAIM_ATTEMPTS: usize = 10;
+const CLAIM_RETRY_INTERVAL: Duration = Duration::from_millis(500);
+
+const PING_INTERVAL: Duration = Duration::from_secs(1);
+/// pings that haven't been answered after this many newer ones were sent are considered lost
+const MAX_PENDING_PINGS: usize = 16;
+const KEEPALIVE_INTERVAL: Duration = Duration::from_secs(5);
+
+/// length of one opus frame in the client (`VOICE_CHUNK_RECORD_TIME`)
+const VOICE_FRAME_DURATION: Duration = Duration::from_millis(60);
+/// must match `VOICE_MAX_FRAMES_IN_AUDIO_FRAME`
+pub const VOICE_MAX_FRAMES: usize = 10;
+
+#[derive(Clone, Copy)]
+pub struct VoiceConfig {
+    /// opus frames in every voice packet, the client sends one packet once it has recorded this many
+    pub frames_per_packet: usize,
+    /// size of one encoded opus frame in bytes
+    pub frame_size: usize,
+}
+
+pub struct BotConfig {
+    pub server: SocketAddr,
+    pub account_id: i32,
+    pub level_id: LevelId,
+    pub tps: u32,
+    /// how long to keep sending after logging in
+    pub duration: Duration,
+    /// player data to replay, synthetic data is sent if this is empty
+    pub trace: Arc<Vec<TracePacket>>,
+    /// where in the trace to start, so that bots don't all move in lockstep
+    pub trace_start: usize,
+    pub voice: Option<VoiceConfig>,
+    /// incremented while the bot is logged in
+    pub active: Arc<AtomicUsize>,
+}
+
+pub enum BotError {
+    Io(std::io::Error),
+    Decode(DecodeError),
+    Session(PacketHandlingError),
+    MalformedPacket,
+    EncryptionError,
+    DecryptionError,
+    TimedOut(&'static str),
+    UnexpectedPacket(u16),
+    UnknownCipher(u8),
+    /// the server refused the login or disconnected us, with its message
+    Rejected(String),
+}
+
+impl Display for BotError {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            Self::Io(e) => write!(f, "IO error: {e}"),
+            Self::Decode(e) => write!(f, "decode error: {e}"),
+            Self::Session(e) => write!(f, "session box error: {e}"),
+            Self::MalformedPacket => f.write_str("malformed packet"),
+            Self::EncryptionError => f.write_str("encryption failed"),
+            Self::DecryptionError => f.write_str("decryption failed"),
+            Self::TimedOut(what) => write!(f, "timed out while {what}"),
+            Self::UnexpectedPacket(id) => write!(f, "unexpected packet {id}"),
+            Self::UnknownCipher(cipher) => write!(f, "server picked an unknown session cipher ({cipher})"),
+            Self::Rejected(message) => write!(f, "rejected by the server: {message}"),
+        }
+    }
+}
+
+impl From<std::io::Error> for BotError {
+    fn from(value: std::io::Error) -> Self {
+        Self::Io(value)
+    }
+}
+
+impl From<DecodeError> for BotError {
+    fn from(value: DecodeError) -> Self {
+        Self::Decode(value)
+    }
+}
+
+impl From<PacketHandlingError> for BotError {
+    fn from(value: PacketHandlingError) -> Self {
+        Self::Session(value)
+    }
+}
+
+pub type Result<T> = core::result::Result<T, BotError>;
+
+/// Connects, plays for `config.duration` and disconnects. Errors are stored in the report instead of being returned,
+/// so that everything measured until then is kept.
+pub async fn run(config: BotConfig) -> BotReport {
+    let mut report = BotReport {
+        account_id: config.account_id,
+        ..Default::default()
+    };
+
+    let started = Instant::now();
+
+    let mut bot = match timeout(LOGIN_TIMEOUT, Bot::connect(&config)).await {
+        Ok(Ok(bot)) => bot,
+        Ok(Err(e)) => {
+            report.error = Some(e.to_string());
+            return report;
+        }
+        Err(_) => {
+            report.error = Some(BotError::TimedOut("logging in").to_string());
+            return report;
+        }
+    };
+
+    report.connect_time = Some(started.elapsed());
+
+    config.active.fetch_add(1, Ordering::Relaxed);
+
+    if let Err(e) = bot.play(&config, &mut report).await {
+        report.error = Some(e.to_string());
+    }
+
+    config.active.fetch_sub(1, Ordering::Relaxed);
+
+    bot.disconnect().await;
+
+    report
+}
+
+struct Bot {
+    tcp: OwnedWriteHalf,
+    /// resolves with the reason once the server closes the tcp connection
+    tcp_closed: oneshot::Receiver<String>,
+    udp: UdpSocket,
+    crypto_box: ChaChaBox,
+    session_box: Option<SessionBox>,
+    send_buf: Vec<u8>,
+}
+
+impl Bot {
+    /// handshake -> `LoginPacket` -> `ClaimThreadPacket` -> `LevelJoinPacket`
+    async fn connect(config: &BotConfig) -> Result<Self> {
+        let mut tcp = TcpStream::connect(config.server).await?;
+        tcp.set_nodelay(true)?;
+        tcp.write_u8(MARKER_CONN_INITIAL).await?;
+
+        let secret_key = SecretKey::generate(&mut OsRng);
+
+        let mut ciphers = 1u8 << SessionCipher::XChaCha20Poly1305 as u8;
+        if SessionCipher::has_hardware_aes() {
+            ciphers |= 1 << SessionCipher::Aes256Gcm as u8;
+        }
+
+        let mut body = ByteBuffer::new();
+        body.write_u16(PROTOCOL_VERSION);
+        body.write_value(&CryptoPublicKey(secret_key.public_key()));
+        body.write_u8(ciphers);
+
+        let mut out = Vec::new();
+        encode_packet(&mut out, CryptoHandshakeStartPacket::PACKET_ID, body.as_bytes(), true);
+        tcp.write_all(&out).await?;
+
+        // the cipher is only sent if the server supports session boxes, and always before the handshake response
+        let mut cipher = None;
+        let server_key = loop {
+            let (header, data) = read_tcp_packet(&mut tcp).await?;
+            let mut reader = ByteReader::from_bytes(&data[PacketHeader::SIZE..]);
+
+            match header.packet_id {
+                SessionCipherPacket::PACKET_ID => cipher = Some(reader.read_value::<u8>()?),
+                CryptoHandshakeResponsePacket::PACKET_ID => break reader.read_value::<CryptoPublicKey>()?,
+                ProtocolMismatchPacket::PACKET_ID => {
+                    let protocol = reader.read_value::<u16>()?;
+                    return Err(BotError::Rejected(format!(
+                        "protocol mismatch, the server is on v{protocol} and we are on v{PROTOCOL_VERSION}"
+                    )));
+                }
+                id => return Err(BotError::UnexpectedPacket(id)),
+            }
+        };
+
+        let crypto_box = ChaChaBox::new(&server_key.0, &secret_key);
+
+        let session_box = match cipher {
+            None => None,
+            Some(0) => Some(SessionBox::from_crypto_box_client(&crypto_box, SessionCipher::XChaCha20Poly1305)?),
+            Some(1) => Some(SessionBox::from_crypto_box_client(&crypto_box, SessionCipher::Aes256Gcm)?),
+            Some(x) => return Err(BotError::UnknownCipher(x)),
+        };
+
+        // standalone servers don't check the token, and others can't be load tested with fake accounts anyway
+        let mut body = ByteBuffer::new();
+        body.write_i32(config.account_id);
+        body.write_i32(config.account_id);
+        body.write_value(&InlineString::<MAX_NAME_SIZE>::new(&format!("bot{}", config.account_id)));
+        body.write_value(&FastString::new(""));
+        body.write_value(&PlayerIconData::default());
+        body.write_u16(FRAGMENTATION_LIMIT);
+        body.write_value(&InlineString::<72>::new("globed-loadtest"));
+
+        let mut out = Vec::new();
+        encode_encrypted_tcp(&crypto_box, &mut out, LoginPacket::PACKET_ID, body.as_bytes())?;
+        tcp.write_all(&out).await?;
+
+        let secret = loop {
+            let (header, mut data) = read_tcp_packet(&mut tcp).await?;
+
+            let body = if header.encrypted {
+                decrypt(&crypto_box, &mut data)?
+            } else {
+                &data[PacketHeader::SIZE..]
+            };
+
+            let mut reader = ByteReader::from_bytes(body);
+
+            match header.packet_id {
+                LoggedInPacket::PACKET_ID => {
+                    let _tps = reader.read_value::<u32>()?;
+                    let _special_user_data = reader.read_value::<SpecialUserData>()?;
+                    let _all_roles = reader.read_value::<Vec<GameServerRole>>()?;
+                    break reader.read_value::<u32>()?;
+                }
+                LoginFailedPacket::PACKET_ID | ServerDisconnectPacket::PACKET_ID => {
+                    return Err(BotError::Rejected(reader.read_value::<String>()?));
+                }
+                ServerBannedPacket::PACKET_ID => return Err(BotError::Rejected("banned".to_owned())),
+                // notices and such can arrive at any time
+                _ => {}
+            }
+        };
+
+        let udp = UdpSocket::bind("0.0.0.0:0").await?;
+        udp.connect(config.server).await?;
+
+        let mut bot = Self::claim(tcp, udp, crypto_box, session_box, secret).await?;
+
+        let mut body = ByteBuffer::new();
+        body.write_i64(config.level_id);
+        bot.send_tcp(LevelJoinPacket::PACKET_ID, body.as_bytes()).await?;
+
+        Ok(bot)
+    }
+
+    /// The server only knows the udp address of a client once it sends `ClaimThreadPacket`, and doesn't confirm it,
+    /// so we keep claiming until a keepalive gets answered. Claims that arrive after the first one are rejected, which is harmless.
+    async fn claim(
+        tcp: TcpStream,
+        udp: UdpSocket,
+        crypto_box: ChaChaBox,
+        session_box: Option<SessionBox>,
+        secret: u32,
+    ) -> Result<Self> {
+        let mut claim = Vec::new();
+        encode_packet(&mut claim, ClaimThreadPacket::PACKET_ID, &secret.to_be_bytes(), false);
+
+        let mut keepalive = Vec::new();
+        encode_packet(&mut keepalive, KeepalivePacket::PACKET_ID, &0u64.to_be_bytes(), false);
+
+        let mut buf = vec![0u8; MAX_UDP_PACKET_SIZE];
+        let mut claimed = false;
+
+        for _ in 0..CLAIM_ATTEMPTS {
+            udp.send(&claim).await?;
+            udp.send(&keepalive).await?;
+
+            let wait = async {
+                loop {
+                    let len = udp.recv(&mut buf).await?;
+                    if len >= PacketHeader::SIZE && u16::from_be_bytes([buf[0], buf[1]]) == KeepaliveResponsePacket::PACKET_ID {
+                        return Ok::<(), std::io::Error>(());
+                    }
+                }
+            };
+
+            if let Ok(result) = timeout(CLAIM_RETRY_INTERVAL, wait).await {
+                result?;
+                claimed = true;
+                break;
+            }
+        }
+
+        if !claimed {
+            return Err(BotError::TimedOut("claiming the udp connection"));
+        }
+
+        // the server sends room and profile updates over tcp, those have to be read or its sends would start timing out
+        let (read_half, write_half) = tcp.into_split();
+        let (closed_tx, tcp_closed) = oneshot::channel();
+
+        tokio::spawn(async move {
+            let _ = closed_tx.send(drain_tcp(read_half).await);
+        });
+
+        Ok(Self {
+            tcp: write_half,
+            tcp_closed,
+            udp,
+            crypto_box,
+            session_box,
+            send_buf: Vec::with_capacity(1024),
+        })
+    }
+
+    async fn play(&mut self, config: &BotConfig, report: &mut BotReport) -> Result<()> {
+        let mut player_tick = interval(Duration::from_secs_f64(1.0 / f64::from(config.tps.max(1))));
+        // an overloaded bot process should send less, not burst to catch up
+        player_tick.set_missed_tick_behavior(MissedTickBehavior::Skip);
+
+        let mut ping_tick = interval(PING_INTERVAL);
+        let mut keepalive_tick = interval(KEEPALIVE_INTERVAL);
+
+        let voice_interval = config.voice.map_or(Duration::from_secs(1), |v| VOICE_FRAME_DURATION * v.frames_per_packet as u32);
+        let mut voice_tick = interval(voice_interval);
+        voice_tick.set_missed_tick_behavior(MissedTickBehavior::Skip);
+
+        let deadline = sleep(config.duration);
+        tokio::pin!(deadline);
+
+        let started = Instant::now();
+        let mut player = PlayerDataSource::new(config);
+        let voice_body = config.voice.map(make_voice_body);
+
+        let mut recv_buf = vec![0u8; MAX_UDP_PACKET_SIZE];
+
+        // only the oldest unanswered player data is timed, the server answers every one with a level data packet
+        let mut pending_response: Option<Instant> = None;
+        let mut pending_pings = VecDeque::<(u32, Instant)>::new();
+        let mut next_ping_id = 0u32;
+        let mut last_sequence: Option<u32> = None;
+
+        loop {
+            tokio::select! {
+                () = &mut deadline => return Ok(()),
+
+                reason = &mut self.tcp_closed => {
+                    return Err(BotError::Rejected(reason.unwrap_or_else(|_| "connection closed".to_owned())));
+                }
+
+                _ = player_tick.tick() => {
+                    let (packet_id, body) = player.next(started.elapsed());
+                    self.send_udp(packet_id, &body).await?;
+
+                    pending_response.get_or_insert_with(Instant::now);
+                    report.sent_player_data += 1;
+                }
+
+                _ = ping_tick.tick() => {
+                    let id = next_ping_id;
+                    next_ping_id = next_ping_id.wrapping_add(1);
+
+                    self.send_udp(PingPacket::PACKET_ID, &id.to_be_bytes()).await?;
+
+                    pending_pings.push_back((id, Instant::now()));
+                    if pending_pings.len() > MAX_PENDING_PINGS {
+                        pending_pings.pop_front();
+                    }
+                }
+
+                _ = keepalive_tick.tick() => {
+                    // bots don't sync their clock, the client time is only echoed back anyway
+                    self.send_udp(KeepalivePacket::PACKET_ID, &0u64.to_be_bytes()).await?;
+                }
+
+                _ = voice_tick.tick(), if voice_body.is_some() => {
+                    self.send_encrypted_udp(VoicePacket::PACKET_ID, voice_body.as_deref().unwrap()).await?;
+                    report.sent_voice += 1;
+                }
+
+                result = self.udp.recv(&mut recv_buf) => {
+                    let len = result?;
+                    let data = &recv_buf[..len];
+
+                    if len < PacketHeader::SIZE {
+                        continue;
+                    }
+
+                    let mut reader = ByteReader::from_bytes(&data[PacketHeader::SIZE..]);
+
+                    match u16::from_be_bytes([data[0], data[1]]) {
+                        LevelDataPacket::PACKET_ID | QuantizedLevelDataPacket::PACKET_ID => {
+                            let sequence = reader.read_value::<u32>()?;
+                            report.received_level_data += 1;
+
+                            match last_sequence {
+                                Some(last) if sequence > last => {
+                                    report.lost_level_data += u64::from(sequence - last - 1);
+                                    last_sequence = Some(sequence);
+                                }
+                                // arrived late, it was already counted as lost
+                                Some(_) => report.lost_level_data = report.lost_level_data.saturating_sub(1),
+                                None => last_sequence = Some(sequence),
+                            }
+
+                            if let Some(sent_at) = pending_response.take() {
+                                report.response.push(sent_at.elapsed());
+                            }
+                        }
+
+                        PingResponsePacket::PACKET_ID => {
+                            let id = reader.read_value::<u32>()?;
+
+                            if let Some(pos) = pending_pings.iter().position(|(pid, _)| *pid == id) {
+                                report.ping.push(pending_pings[pos].1.elapsed());
+                                // anything older than this was lost or reordered, either way it won't be timed
+                                pending_pings.drain(..=pos);
+                            }
+                        }
+
+                        VoiceBroadcastPacket::PACKET_ID => report.received_voice += 1,
+
+                        _ => {}
+                    }
+                }
+            }
+        }
+    }
+
+    async fn disconnect(mut self) {
+        let _ = self.send_tcp(DisconnectPacket::PACKET_ID, &[]).await;
+        let _ = self.tcp.shutdown().await;
+    }
+
+    async fn send_tcp(&mut self, packet_id: u16, body: &[u8]) -> Result<()> {
+        self.send_buf.clear();
+        encode_packet(&mut self.send_buf, packet_id, body, true);
+        self.tcp.write_all(&self.send_buf).await?;
+
+        Ok(())
+    }
+
+    async fn send_udp(&mut self, packet_id: u16, body: &[u8]) -> Result<()> {
+        self.send_buf.clear();
+        encode_packet(&mut self.send_buf, packet_id, body, false);
+        self.udp.send(&self.send_buf).await?;
+
+        Ok(())
+    }
+
+    /// uses the session box if the server picked a cipher, otherwise the handshake box like older clients
+    async fn send_encrypted_udp(&mut self, packet_id: u16, body: &[u8]) -> Result<()> {
+        self.send_buf.clear();
+        write_header(&mut self.send_buf, packet_id, true);
+
+        if let Some(sbox) = self.session_box.as_mut() {
+            let prefix_start = self.send_buf.len();
+            self.send_buf.resize(prefix_start + SessionBox::PREFIX_SIZE, 0);
+            self.send_buf.extend_from_slice(body);
+
+            let (prefix, message) = self.send_buf[prefix_start..].split_at_mut(SessionBox::PREFIX_SIZE);
+            sbox.encrypt_in_place(prefix, message)?;
+        } else {
+            append_encrypted(&self.crypto_box, &mut self.send_buf, body)?;
+        }
+
+        self.udp.send(&self.send_buf).await?;
+
+        Ok(())
+    }
+}
+
+/// Hands out the body of the next player data packet, either from the trace or made up
+struct PlayerDataSource {
+    trace: Arc<Vec<TracePacket>>,
+    pos: usize,
+    /// an encoded `PlayerData::default()`, only the timestamp and the x position get changed
+    synthetic: Vec<u8>,
+}
+
+impl PlayerDataSource {
+    /// units per second the synthetic player moves to the right, roughly the normal speed of a cube
+    const SYNTHETIC_SPEED: f32 = 311.0;
+
+    fn new(config: &BotConfig) -> Self {
+        let mut synthetic = ByteBuffer::new();
+        synthetic.write_value(&PlayerData::default());
+
+        Self {
+            trace: config.trace.clone(),
+            pos: config.trace_start,
+            synthetic: synthetic.into_vec(),
+        }
+    }
+
+    fn next(&mut self, elapsed: Duration) -> (u16, Vec<u8>) {
+        if !self.trace.is_empty() {
+            let packet = &self.trace[self.pos % self.trace.len()];
+            self.pos += 1;
+            return (packet.packet_id, packet.body.clone());
+        }
+
+        // `PlayerData` starts with the timestamp, followed by the position of the first player
+        let time = elapsed.as_secs_f64();
+        let mut body = self.synthetic.clone();
+        body[0..8].copy_from_slice(&time.to_be_bytes());
+        body[8..12].copy_from_slice(&(time as f32 * Self::SYNTHETIC_SPEED).to_be_bytes());
+
+        (PlayerDataPacket::PACKET_ID, body)
+    }
+}
+
+/// an `EncodedAudioFrame` with `frames_per_packet` opus frames of garbage, the server only forwards them
+fn make_voice_body(voice: VoiceConfig) -> Vec<u8> {
+    let frame = EncodedAudioFrame {
+        opus_frames: std::array::from_fn(|i| (i < voice.frames_per_packet).then(|| vec![0x5a; voice.frame_size])),
+    };
+
+    let mut body = ByteBuffer::new();
+    body.write_value(&frame);
+    body.into_vec()
+}
+
+fn write_header(out: &mut Vec<u8>, packet_id: u16, encrypted: bool) {
+    out.extend_from_slice(&packet_id.to_be_bytes());
+    out.push(u8::from(encrypted));
+    out.push(0); // compressed, only ever set by the server
+}
+
+/// unencrypted packet as the client sends it, `tcp` adds the length prefix
+fn encode_packet(out: &mut Vec<u8>, packet_id: u16, body: &[u8], tcp: bool) {
+    if tcp {
+        out.extend_from_slice(&((PacketHeader::SIZE + body.len()) as u32).to_be_bytes());
+    }
+
+    write_header(out, packet_id, false);
+    out.extend_from_slice(body);
+}
+
+fn encode_encrypted_tcp(cbox: &ChaChaBox, out: &mut Vec<u8>, packet_id: u16, body: &[u8]) -> Result<()> {
+    out.extend_from_slice(&[0u8; 4]);
+    write_header(out, packet_id, true);
+    append_encrypted(cbox, out, body)?;
+
+    let packet_len = (out.len() - 4) as u32;
+    out[..4].copy_from_slice(&packet_len.to_be_bytes());
+
+    Ok(())
+}
+
+/// appends `[nonce][mac][ciphertext]`
+fn append_encrypted(cbox: &ChaChaBox, out: &mut Vec<u8>, body: &[u8]) -> Result<()> {
+    let nonce_start = out.len();
+    let mac_start = nonce_start + NONCE_SIZE;
+    let data_start = mac_start + MAC_SIZE;
+
+    let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+    out.extend_from_slice(nonce.as_slice());
+    out.resize(data_start, 0);
+    out.extend_from_slice(body);
+
+    let tag = cbox
+        .encrypt_in_place_detached(&nonce, b"", &mut out[data_start..])
+        .map_err(|_| BotError::EncryptionError)?;
+
+    out[mac_start..data_start].copy_from_slice(&tag);
+
+    Ok(())
+}
+
+/// decrypts a whole packet (header included) in place and returns the body
+fn decrypt<'a>(cbox: &ChaChaBox, message: &'a mut [u8]) -> Result<&'a [u8]> {
+    if message.len() < PacketHeader::SIZE + NONCE_SIZE + MAC_SIZE {
+        return Err(BotError::MalformedPacket);
+    }
+
+    let nonce_start = PacketHeader::SIZE;
+    let mac_start = nonce_start + NONCE_SIZE;
+    let ciphertext_start = mac_start + MAC_SIZE;
+
+    let mut nonce = [0u8; NONCE_SIZE];
+    nonce.clone_from_slice(&message[nonce_start..mac_start]);
+    let nonce = nonce.into();
+
+    let mut mac = [0u8; MAC_SIZE];
+    mac.clone_from_slice(&message[mac_start..ciphertext_start]);
+    let mac = mac.into();
+
+    cbox.decrypt_in_place_detached(&nonce, b"", &mut message[ciphertext_start..], &mac)
+        .map_err(|_| BotError::DecryptionError)?;
+
+    Ok(&message[ciphertext_start..])
+}
+
+/// reads one length-prefixed packet, returns the header and the whole packet including it
+async fn read_tcp_packet<R: AsyncRead + Unpin>(reader: &mut R) -> Result<(PacketHeader, Vec<u8>)> {
+    let length = reader.read_u32().await? as usize;
+
+    if !(PacketHeader::SIZE..=MAX_TCP_PACKET_SIZE).contains(&length) {
+        return Err(BotError::MalformedPacket);
+    }
+
+    let mut data = vec![0u8; length];
+    reader.read_exact(&mut data).await?;
+
+    let header = ByteReader::from_bytes(&data).read_packet_header()?;
+
+    Ok((header, data))
+}
+
+/// reads and throws away everything the server sends over tcp after the login, returns why the connection ended
+async fn drain_tcp<R: AsyncRead + Unpin>(mut reader: R) -> String {
+    loop {
+        match read_tcp_packet(&mut reader).await {
+            Ok((header, data)) if header.packet_id == ServerDisconnectPacket::PACKET_ID => {
+                return ByteReader::from_bytes(&data[PacketHeader::SIZE..])
+                    .read_value::<String>()
+                    .unwrap_or_else(|_| "disconnected by the server".to_owned());
+            }
+            Ok(_) => {}
+            Err(e) => return e.to_string(),
+        }
+    }
+}
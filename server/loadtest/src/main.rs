@@ -0,0 +1,334 @@
+#![allow(
+    clippy::must_use_candidate,
+    clippy::module_name_repetitions,
+    clippy::cast_possible_truncation,
+    clippy::cast_precision_loss,
+    clippy::missing_errors_doc,
+    clippy::missing_panics_doc,
+    clippy::wildcard_imports
+)]
+
+//! Spawns many simulated players against a standalone game server and reports how long the server took to answer them.
+//! See `print_usage` for the options.
+
+use std::{
+    collections::HashMap,
+    fmt::Write as _,
+    net::SocketAddr,
+    path::PathBuf,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+    time::{Duration, Instant},
+};
+
+use bot::{BotConfig, VoiceConfig, VOICE_MAX_FRAMES};
+use stats::{format_duration, BotReport, LatencySamples};
+use tokio::time::{interval, sleep};
+
+mod bot;
+mod stats;
+mod trace;
+
+const PROGRESS_INTERVAL: Duration = Duration::from_secs(5);
+
+struct Options {
+    server: SocketAddr,
+    bots: usize,
+    tps: u32,
+    duration: Duration,
+    /// bots are started evenly spread over this time
+    ramp: Duration,
+    /// bots are split between this many levels, starting at `level_base`
+    levels: usize,
+    level_base: i64,
+    account_base: i32,
+    trace: Option<PathBuf>,
+    /// the first `voice_bots` bots also send voice
+    voice_bots: usize,
+    voice_frames: usize,
+    voice_frame_size: usize,
+    csv: Option<PathBuf>,
+}
+
+fn print_usage(exe: &str) {
+    eprintln!("usage: {exe} <server address> [options]");
+    eprintln!();
+    eprintln!("the server has to be a standalone one, login tokens are not checked there.");
+    eprintln!();
+    eprintln!("options:");
+    eprintln!("  --bots <n>             amount of bots (default 100)");
+    eprintln!("  --tps <n>              player data packets per second of every bot (default 30)");
+    eprintln!("  --duration <secs>      how long every bot stays connected (default 60)");
+    eprintln!("  --ramp <secs>          time over which the bots connect (default 10)");
+    eprintln!("  --levels <n>           split the bots between this many levels (default 1)");
+    eprintln!("  --level-id <id>        id of the first level (default 1)");
+    eprintln!("  --account-base <id>    account id of the first bot (default 100000000)");
+    eprintln!("  --trace <file.gcap>    replay player data from a client packet capture instead of made up data");
+    eprintln!("  --voice-bots <n>       how many of the bots also send voice (default 0)");
+    eprintln!("  --voice-frames <n>     opus frames in a voice packet (default 4, max {VOICE_MAX_FRAMES})");
+    eprintln!("  --voice-frame-size <n> bytes in one opus frame (default 160)");
+    eprintln!("  --csv <file>           also write the results of every bot into a csv file");
+    eprintln!();
+    eprintln!("every bot uses a tcp and a udp socket, raise the open file limit (ulimit -n) for more than a few hundred bots.");
+}
+
+fn parse_value<T: std::str::FromStr>(flag: &str, value: Option<String>) -> Result<T, String> {
+    let value = value.ok_or_else(|| format!("missing value for {flag}"))?;
+    value.parse().map_err(|_| format!("invalid value for {flag}: {value}"))
+}
+
+fn parse_options(mut args: impl Iterator<Item = String>) -> Result<Options, String> {
+    let server = args.next().ok_or_else(|| "missing server address".to_owned())?;
+    let server = server.parse().map_err(|_| format!("invalid server address: {server}"))?;
+
+    let mut options = Options {
+        server,
+        bots: 100,
+        tps: 30,
+        duration: Duration::from_secs(60),
+        ramp: Duration::from_secs(10),
+        levels: 1,
+        level_base: 1,
+        account_base: 100_000_000,
+        trace: None,
+        voice_bots: 0,
+        voice_frames: 4,
+        voice_frame_size: 160,
+        csv: None,
+    };
+
+    while let Some(flag) = args.next() {
+        let value = args.next();
+
+        match flag.as_str() {
+            "--bots" => options.bots = parse_value(&flag, value)?,
+            "--tps" => options.tps = parse_value(&flag, value)?,
+            "--duration" => options.duration = Duration::from_secs(parse_value(&flag, value)?),
+            "--ramp" => options.ramp = Duration::from_secs(parse_value(&flag, value)?),
+            "--levels" => options.levels = parse_value(&flag, value)?,
+            "--level-id" => options.level_base = parse_value(&flag, value)?,
+            "--account-base" => options.account_base = parse_value(&flag, value)?,
+            "--trace" => options.trace = Some(parse_value(&flag, value)?),
+            "--voice-bots" => options.voice_bots = parse_value(&flag, value)?,
+            "--voice-frames" => options.voice_frames = parse_value(&flag, value)?,
+            "--voice-frame-size" => options.voice_frame_size = parse_value(&flag, value)?,
+            "--csv" => options.csv = Some(parse_value(&flag, value)?),
+            _ => return Err(format!("unknown option: {flag}")),
+        }
+    }
+
+    if options.bots == 0 || options.tps == 0 || options.levels == 0 {
+        return Err("--bots, --tps and --levels must be at least 1".to_owned());
+    }
+
+    if options.voice_frames == 0 || options.voice_frames > VOICE_MAX_FRAMES {
+        return Err(format!("--voice-frames must be between 1 and {VOICE_MAX_FRAMES}"));
+    }
+
+    if i32::try_from(options.bots).map_or(true, |bots| options.account_base.checked_add(bots).is_none()) || options.account_base <= 0 {
+        return Err("--account-base must be positive and leave room for every bot".to_owned());
+    }
+
+    Ok(options)
+}
+
+#[tokio::main]
+async fn main() {
+    let mut args = std::env::args();
+    let exe = args.next().unwrap_or_else(|| "globed-loadtest".to_owned());
+
+    let options = match parse_options(args) {
+        Ok(x) => x,
+        Err(e) => {
+            eprintln!("{e}\n");
+            print_usage(&exe);
+            std::process::exit(1);
+        }
+    };
+
+    let trace = match &options.trace {
+        Some(path) => match trace::load(path) {
+            Ok(trace) => {
+                println!("loaded {} player data packets from {}", trace.len(), path.display());
+                trace
+            }
+            Err(e) => {
+                eprintln!("{e}");
+                std::process::exit(1);
+            }
+        },
+        None => Vec::new(),
+    };
+
+    let trace = Arc::new(trace);
+    let active = Arc::new(AtomicUsize::new(0));
+
+    println!(
+        "starting {} bots against {} ({} tps, {}s each, {} voice)",
+        options.bots,
+        options.server,
+        options.tps,
+        options.duration.as_secs(),
+        options.voice_bots.min(options.bots)
+    );
+
+    let started = Instant::now();
+    let mut handles = Vec::with_capacity(options.bots);
+
+    for i in 0..options.bots {
+        let config = BotConfig {
+            server: options.server,
+            account_id: options.account_base + i as i32,
+            level_id: options.level_base + (i % options.levels) as i64,
+            tps: options.tps,
+            duration: options.duration,
+            trace: trace.clone(),
+            trace_start: if trace.is_empty() { 0 } else { i * 7919 % trace.len() },
+            voice: (i < options.voice_bots).then_some(VoiceConfig {
+                frames_per_packet: options.voice_frames,
+                frame_size: options.voice_frame_size,
+            }),
+            active: active.clone(),
+        };
+
+        let delay = options.ramp.mul_f64(i as f64 / options.bots as f64);
+
+        handles.push(tokio::spawn(async move {
+            sleep(delay).await;
+            bot::run(config).await
+        }));
+    }
+
+    let progress_active = active.clone();
+    let progress = tokio::spawn(async move {
+        let mut tick = interval(PROGRESS_INTERVAL);
+        tick.tick().await;
+
+        loop {
+            tick.tick().await;
+            println!("[{:>4}s] {} bots connected", started.elapsed().as_secs(), progress_active.load(Ordering::Relaxed));
+        }
+    });
+
+    let mut reports = Vec::with_capacity(handles.len());
+    for handle in handles {
+        match handle.await {
+            Ok(report) => reports.push(report),
+            Err(e) => eprintln!("bot task failed: {e}"),
+        }
+    }
+
+    progress.abort();
+
+    print_summary(&mut reports, started.elapsed());
+
+    if let Some(path) = &options.csv {
+        match std::fs::write(path, make_csv(&mut reports)) {
+            Ok(()) => println!("wrote per-bot results to {}", path.display()),
+            Err(e) => eprintln!("failed to write {}: {e}", path.display()),
+        }
+    }
+}
+
+fn print_summary(reports: &mut [BotReport], elapsed: Duration) {
+    let connected = reports.iter().filter(|r| r.connect_time.is_some()).count();
+
+    println!();
+    println!("finished in {:.1}s, {connected} of {} bots connected", elapsed.as_secs_f64(), reports.len());
+
+    // the same error usually happens to many bots at once, so they are grouped
+    let mut errors = HashMap::<&str, usize>::new();
+    for report in reports.iter() {
+        if let Some(error) = &report.error {
+            *errors.entry(error.as_str()).or_default() += 1;
+        }
+    }
+
+    let mut errors: Vec<_> = errors.into_iter().collect();
+    errors.sort_unstable_by(|a, b| b.1.cmp(&a.1));
+
+    for (error, count) in errors.iter().take(10) {
+        println!("  {count} x {error}");
+    }
+
+    let mut connect = LatencySamples::default();
+    let mut ping = LatencySamples::default();
+    let mut response = LatencySamples::default();
+    let mut bot_p99s = LatencySamples::default();
+
+    for report in reports.iter_mut() {
+        if let Some(time) = report.connect_time {
+            connect.push(time);
+        }
+
+        ping.merge(&report.ping);
+        response.merge(&report.response);
+
+        if let Some(p99) = report.response.percentile(0.99) {
+            bot_p99s.push(p99);
+        }
+    }
+
+    println!();
+    print_percentiles("login", &mut connect);
+    print_percentiles("ping", &mut ping);
+    print_percentiles("response", &mut response);
+    print_percentiles("response p99 of each bot", &mut bot_p99s);
+
+    let sent: u64 = reports.iter().map(|r| r.sent_player_data).sum();
+    let received: u64 = reports.iter().map(|r| r.received_level_data).sum();
+    let lost: u64 = reports.iter().map(|r| r.lost_level_data).sum();
+    let voice_sent: u64 = reports.iter().map(|r| r.sent_voice).sum();
+    let voice_received: u64 = reports.iter().map(|r| r.received_voice).sum();
+
+    let loss = if received + lost > 0 { lost as f64 * 100.0 / (received + lost) as f64 } else { 0.0 };
+
+    println!();
+    println!("player data sent: {sent}, level data received: {received}, lost: {lost} ({loss:.2}%)");
+
+    if voice_sent > 0 {
+        println!("voice packets sent: {voice_sent}, received: {voice_received}");
+    }
+}
+
+fn print_percentiles(name: &str, samples: &mut LatencySamples) {
+    println!(
+        "{name:<26} n={:<9} p50 {:<10} p90 {:<10} p99 {:<10} max {}",
+        samples.len(),
+        format_duration(samples.percentile(0.5)),
+        format_duration(samples.percentile(0.9)),
+        format_duration(samples.percentile(0.99)),
+        format_duration(samples.percentile(1.0)),
+    );
+}
+
+fn make_csv(reports: &mut [BotReport]) -> String {
+    let millis = |d: Option<Duration>| d.map_or(String::new(), |d| format!("{:.3}", d.as_secs_f64() * 1000.0));
+
+    let mut out = String::from(
+        "account_id,connect_ms,ping_p50_ms,ping_p99_ms,response_p50_ms,response_p99_ms,player_data_sent,level_data_received,level_data_lost,voice_sent,voice_received,error\n",
+    );
+
+    for r in reports {
+        let _ = writeln!(
+            out,
+            "{},{},{},{},{},{},{},{},{},{},{},\"{}\"",
+            r.account_id,
+            millis(r.connect_time),
+            millis(r.ping.percentile(0.5)),
+            millis(r.ping.percentile(0.99)),
+            millis(r.response.percentile(0.5)),
+            millis(r.response.percentile(0.99)),
+            r.sent_player_data,
+            r.received_level_data,
+            r.lost_level_data,
+            r.sent_voice,
+            r.received_voice,
+            r.error.as_deref().unwrap_or("").replace('"', "\"\""),
+        );
+    }
+
+    out
+}
@@ -0,0 +1,67 @@
+use std::time::Duration;
+
+/// Latency samples of one bot, kept in microseconds. Every sample is kept, a bot at 30 tps makes about 100k an hour.
+#[derive(Default)]
+pub struct LatencySamples {
+    samples: Vec<u32>,
+    sorted: bool,
+}
+
+impl LatencySamples {
+    pub fn push(&mut self, latency: Duration) {
+        self.samples.push(latency.as_micros().min(u128::from(u32::MAX)) as u32);
+        self.sorted = false;
+    }
+
+    pub fn len(&self) -> usize {
+        self.samples.len()
+    }
+
+    /// `p` is in the range 0.0 - 1.0, returns `None` if there are no samples
+    pub fn percentile(&mut self, p: f64) -> Option<Duration> {
+        if self.samples.is_empty() {
+            return None;
+        }
+
+        if !self.sorted {
+            self.samples.sort_unstable();
+            self.sorted = true;
+        }
+
+        let idx = ((self.samples.len() - 1) as f64 * p).round() as usize;
+        Some(Duration::from_micros(u64::from(self.samples[idx])))
+    }
+
+    pub fn merge(&mut self, other: &LatencySamples) {
+        self.samples.extend_from_slice(&other.samples);
+        self.sorted = false;
+    }
+}
+
+/// Everything a bot measured, returned when it finishes
+#[derive(Default)]
+pub struct BotReport {
+    pub account_id: i32,
+    /// the error that ended the bot early, if any
+    pub error: Option<String>,
+    /// how long the connection and login took
+    pub connect_time: Option<Duration>,
+    /// round trip of `PingPacket`, which the server answers without going through the client thread
+    pub ping: LatencySamples,
+    /// time from sending player data until the next level data arrives, this includes the time the client thread takes
+    pub response: LatencySamples,
+    pub sent_player_data: u64,
+    pub sent_voice: u64,
+    pub received_level_data: u64,
+    /// level data datagrams that never arrived, from gaps in their sequence numbers
+    pub lost_level_data: u64,
+    pub received_voice: u64,
+}
+
+pub fn format_duration(duration: Option<Duration>) -> String {
+    match duration {
+        Some(d) if d < Duration::from_millis(1) => format!("{}µs", d.as_micros()),
+        Some(d) => format!("{:.2}ms", d.as_secs_f64() * 1000.0),
+        None => "-".to_owned(),
+    }
+}
@@ -0,0 +1,78 @@
+//! Reads player data out of packet captures made by the client (`.gcap` files written by `PacketCapture`).
+//!
+//! File format (little endian): u32 magic, u16 version, then records of
+//! u64 timestamp (microseconds since the unix epoch), u16 packet id, u8 flags (1 = outgoing, 2 = encrypted), u32 length, data.
+//! The data of a udp packet is the packet header followed by the body, same as on the wire.
+
+use std::path::Path;
+
+use globed_game_server::data::{PacketHeader, PacketMetadata, PlayerDataDeltaPacket, PlayerDataPacket};
+
+const FILE_MAGIC: u32 = 0x5041_4347; // "GCAP"
+const FILE_VERSION: u16 = 1;
+const FILE_HEADER_SIZE: usize = 6;
+const RECORD_HEADER_SIZE: usize = 15;
+
+const FLAG_OUTGOING: u8 = 1;
+const FLAG_ENCRYPTED: u8 = 2;
+
+pub struct TracePacket {
+    pub packet_id: u16,
+    /// the packet body, without the header
+    pub body: Vec<u8>,
+}
+
+/// Loads every player data packet the client sent, in the order they were captured. They are replayed at a fixed rate,
+/// so the timestamps of the records are not needed. Deltas are kept as well, when a bot starts in the middle of the trace
+/// the server drops them until the next keyframe, same as after losing one.
+pub fn load(path: &Path) -> Result<Vec<TracePacket>, String> {
+    let data = std::fs::read(path).map_err(|e| format!("failed to read {}: {e}", path.display()))?;
+
+    if data.len() < FILE_HEADER_SIZE || u32::from_le_bytes(data[..4].try_into().unwrap()) != FILE_MAGIC {
+        return Err(format!("{} is not a packet capture", path.display()));
+    }
+
+    let version = u16::from_le_bytes(data[4..6].try_into().unwrap());
+    if version != FILE_VERSION {
+        return Err(format!("unsupported capture version {version}, expected {FILE_VERSION}"));
+    }
+
+    let mut packets = Vec::new();
+    let mut pos = FILE_HEADER_SIZE;
+
+    // a capture that was cut off while writing just ends early
+    while pos + RECORD_HEADER_SIZE <= data.len() {
+        let record = &data[pos..pos + RECORD_HEADER_SIZE];
+        let packet_id = u16::from_le_bytes(record[8..10].try_into().unwrap());
+        let flags = record[10];
+        let length = u32::from_le_bytes(record[11..15].try_into().unwrap()) as usize;
+
+        let start = pos + RECORD_HEADER_SIZE;
+        if start + length > data.len() {
+            break;
+        }
+
+        pos = start + length;
+
+        let is_player_data = packet_id == PlayerDataPacket::PACKET_ID || packet_id == PlayerDataDeltaPacket::PACKET_ID;
+        if !is_player_data || flags & FLAG_OUTGOING == 0 || flags & FLAG_ENCRYPTED != 0 {
+            continue;
+        }
+
+        let packet = &data[start..pos];
+        if packet.len() < PacketHeader::SIZE || u16::from_be_bytes([packet[0], packet[1]]) != packet_id {
+            continue;
+        }
+
+        packets.push(TracePacket {
+            packet_id,
+            body: packet[PacketHeader::SIZE..].to_vec(),
+        });
+    }
+
+    if packets.is_empty() {
+        return Err(format!("{} has no outgoing player data packets", path.display()));
+    }
+
+    Ok(packets)
+}
@@ -15,6 +15,7 @@ pub struct GameServerBootData {
     pub admin_webhook_url: String,
     pub chat_burst_limit: u32,
     pub chat_burst_interval: u32,
+    pub quantized_player_data: bool,
     pub roles: Vec<ServerRole>,
 }
 
@@ -37,6 +38,7 @@ impl Default for GameServerBootData {
             admin_webhook_url: String::new(),
             chat_burst_limit: 0,
             chat_burst_interval: 0,
+            quantized_player_data: false,
             roles: Vec::new(),
         }
     }
@@ -14,6 +14,7 @@ use rand::{distributions::Alphanumeric, Rng};
 pub use nohash_hasher::{IntMap, IntSet};
 pub use parking_lot::{Mutex as SyncMutex, MutexGuard as SyncMutexGuard};
 // module reexports
+pub use aes_gcm;
 pub use anyhow;
 pub use base64;
 pub use colored;
@@ -34,9 +35,9 @@ pub mod data;
 pub mod logger;
 pub mod token_issuer;
 
-pub const PROTOCOL_VERSION: u16 = 6;
+pub const PROTOCOL_VERSION: u16 = 7;
 // used for communicating to the user the minimum required mod version for this protocol
-pub const MIN_CLIENT_VERSION: &str = "v1.4.0";
+pub const MIN_CLIENT_VERSION: &str = "v1.5.0";
 pub const SERVER_MAGIC: &[u8] = b"\xdd\xeeglobed\xda\xee";
 pub const SERVER_MAGIC_LEN: usize = SERVER_MAGIC.len();
 /// amount of chars in an admin key (32)
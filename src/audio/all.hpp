@@ -4,7 +4,10 @@
 #include "encoder.hpp"
 #include "frame.hpp"
 #include "manager.hpp"
+#include "mixer.hpp"
 #include "sample_queue.hpp"
+#include "spatializer.hpp"
 #include "stream.hpp"
+#include "voice_activity.hpp"
 #include "voice_playback_manager.hpp"
 #include "voice_record_manager.hpp"
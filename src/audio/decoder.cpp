@@ -6,17 +6,6 @@
 
 using namespace util::data;
 
-void DecodedOpusData::freeData() {
-    GLOBED_REQUIRE(ptr != nullptr, "attempting to double free an instance of DecodedOpusData")
-
-    delete[] ptr;
-#ifdef GLOBED_DEBUG
-    // to try and prevent misuse
-    ptr = nullptr;
-    length = -1; // wraps around to int max
-#endif // GLOBED_DEBUG
-}
-
 AudioDecoder::AudioDecoder(int sampleRate, int frameSize, int channels) {
     this->frameSize = frameSize;
     this->sampleRate = sampleRate;
@@ -57,24 +46,32 @@ AudioDecoder& AudioDecoder::operator=(AudioDecoder&& other) noexcept {
     return *this;
 }
 
-Result<DecodedOpusData> AudioDecoder::decode(const byte* data, size_t length) {
-    DecodedOpusData out;
-
-    out.length = frameSize * channels;
-    out.ptr = new float[out.length];
+Result<size_t> AudioDecoder::decode(const EncodedOpusData& data, float* out, size_t outCapacity) {
+    GLOBED_REQUIRE_SAFE(outCapacity >= this->getDecodedSize(), "output buffer is too small for a decoded opus frame")
 
-    _res = opus_decode_float(decoder, data, length, out.ptr, frameSize, 0);
+    _res = opus_decode_float(decoder, data.ptr, data.length, out, frameSize, 0);
 
     if (_res < 0) {
-        delete[] out.ptr;
         GLOBED_UNWRAP(this->errcheck("opus_decode_float"));
     }
 
-    return Ok(out);
+    return Ok(static_cast<size_t>(_res) * channels);
 }
 
-Result<DecodedOpusData> AudioDecoder::decode(const EncodedOpusData& data) {
-    return this->decode(data.ptr, data.length);
+Result<size_t> AudioDecoder::decodeLost(const EncodedOpusData* next, float* out, size_t outCapacity) {
+    GLOBED_REQUIRE_SAFE(outCapacity >= this->getDecodedSize(), "output buffer is too small for a decoded opus frame")
+
+    if (next) {
+        _res = opus_decode_float(decoder, next->ptr, next->length, out, frameSize, 1);
+    } else {
+        _res = opus_decode_float(decoder, nullptr, 0, out, frameSize, 0);
+    }
+
+    if (_res < 0) {
+        GLOBED_UNWRAP(this->errcheck("opus_decode_float"));
+    }
+
+    return Ok(static_cast<size_t>(_res) * channels);
 }
 
 Result<> AudioDecoder::setSampleRate(int sampleRate) {
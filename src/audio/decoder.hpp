@@ -10,13 +10,6 @@
 
 struct OpusDecoder;
 
-struct DecodedOpusData {
-    float* ptr;
-    size_t length;
-
-    void freeData();
-};
-
 class AudioDecoder {
 public:
     AudioDecoder(int sampleRate = 0, int frameSize = 0, int channels = 1);
@@ -29,16 +22,16 @@ public:
     AudioDecoder(AudioDecoder&& other) noexcept;
     AudioDecoder& operator=(AudioDecoder&& other) noexcept;
 
-    // Decodes the given Opus data into PCM float samples. `length` must be the size of the input data in bytes.
-    // After you no longer need the decoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioDecoder::freeData(data)`
-    [[nodiscard]] Result<DecodedOpusData> decode(const util::data::byte* data, size_t length);
+    // Decodes the given Opus data straight into `out`, which must have space for at least `frameSize * channels` samples.
+    // Returns the amount of samples written, does not allocate.
+    [[nodiscard]] Result<size_t> decode(const EncodedOpusData& data, float* out, size_t outCapacity);
 
-    // Decodes the given Opus data into PCM float samples. `length` must be the size of the input data in bytes.
-    // After you no longer need the decoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioDecoder::freeData(data)`
-    [[nodiscard]] Result<DecodedOpusData> decode(const EncodedOpusData& data);
+    // Produces a replacement for a lost frame. If `next` is the frame right after the lost one, it is recovered
+    // from the FEC data in it, otherwise it's extrapolated from the previous frames (packet loss concealment).
+    [[nodiscard]] Result<size_t> decodeLost(const EncodedOpusData* next, float* out, size_t outCapacity);
 
-    static void freeData(DecodedOpusData& data) {
-        data.freeData();
+    size_t getDecodedSize() const {
+        return frameSize * channels;
     }
 
     // sets the sample rate that will be used and recreates the decoder
@@ -6,45 +6,11 @@
 
 using namespace util::data;
 
-void EncodedOpusData::freeData() {
-    GLOBED_REQUIRE(ptr != nullptr, "attempting to double free an instance of EncodedOpusData")
-
-    delete[] ptr;
-
-#ifdef GLOBED_DEBUG
-    // to try and prevent misuse
-    ptr = nullptr;
-    length = -1;
-#endif // GLOBED_DEBUG
-}
-
 template<> void ByteBuffer::customEncode(const EncodedOpusData& data) {
     this->writeU32(data.length);
     this->rawWriteBytes(data.ptr, data.length);
 }
 
-template<> ByteBuffer::DecodeResult<EncodedOpusData> ByteBuffer::customDecode() {
-    EncodedOpusData out;
-
-    GLOBED_UNWRAP_INTO(this->readU32(), out.length);
-
-    if (out.length > VOICE_MAX_BYTES_IN_FRAME) {
-        log::warn("Rejecting audio frame, size too large ({})", out.length);
-        return Err(DecodeError::DataTooLong);
-    }
-
-    out.ptr = new util::data::byte[out.length];
-
-    auto result = this->readBytesInto(out.ptr, out.length);
-    if (result.isErr()) {
-        delete[] out.ptr;
-        out.ptr = nullptr;
-        return Err(std::move(result.unwrapErr()));
-    }
-
-    return Ok(out);
-}
-
 AudioEncoder::AudioEncoder(int sampleRate, int frameSize, int channels) {
     this->frameSize = frameSize;
     this->sampleRate = sampleRate;
@@ -84,19 +50,14 @@ AudioEncoder& AudioEncoder::operator=(AudioEncoder&& other) noexcept {
     return *this;
 }
 
-Result<EncodedOpusData> AudioEncoder::encode(const float* data) {
-    EncodedOpusData out;
-    size_t bytes = sizeof(float) * frameSize / 4; // the /4 is arbitrary, could experiment with it
-    out.ptr = new byte[bytes];
-
-    out.length = opus_encode_float(encoder, data, frameSize, out.ptr, bytes);
-    if (out.length < 0) {
-        delete[] out.ptr;
-        _res = out.length;
+Result<size_t> AudioEncoder::encode(const float* data, byte* out, size_t outCapacity) {
+    opus_int32 length = opus_encode_float(encoder, data, frameSize, out, outCapacity);
+    if (length < 0) {
+        _res = length;
         GLOBED_UNWRAP(this->errcheck("opus_encode_float"));
     }
 
-    return Ok(out);
+    return Ok(static_cast<size_t>(length));
 }
 
 Result<> AudioEncoder::setSampleRate(int sampleRate) {
@@ -113,6 +74,19 @@ Result<> AudioEncoder::setChannels(int channels) {
     return this->remakeEncoder();
 }
 
+Result<> AudioEncoder::setForwardErrorCorrection(bool enabled, int expectedLoss) {
+    _res = opus_encoder_ctl(encoder, OPUS_SET_INBAND_FEC(enabled ? 1 : 0));
+    GLOBED_UNWRAP(this->errcheck("AudioEncoder::setForwardErrorCorrection"));
+
+    _res = opus_encoder_ctl(encoder, OPUS_SET_PACKET_LOSS_PERC(enabled ? expectedLoss : 0));
+    return this->errcheck("AudioEncoder::setForwardErrorCorrection");
+}
+
+Result<> AudioEncoder::setDiscontinuousTransmission(bool enabled) {
+    _res = opus_encoder_ctl(encoder, OPUS_SET_DTX(enabled ? 1 : 0));
+    return this->errcheck("AudioEncoder::setDiscontinuousTransmission");
+}
+
 Result<> AudioEncoder::resetState() {
     _res = opus_encoder_ctl(encoder, OPUS_RESET_STATE);
     return this->errcheck("AudioEncoder::resetState");
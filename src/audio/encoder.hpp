@@ -10,12 +10,11 @@ constexpr size_t VOICE_MAX_BYTES_IN_FRAME = 1000;
 
 struct OpusEncoder;
 
+// View into a single encoded opus frame, the bytes are owned by someone else (usually an `EncodedAudioFrame`)
 class EncodedOpusData {
 public:
-    util::data::byte* ptr;
-    int64_t length;
-
-    void freeData();
+    const util::data::byte* ptr;
+    size_t length;
 };
 
 class AudioEncoder {
@@ -30,14 +29,9 @@ public:
     AudioEncoder(AudioEncoder&& other) noexcept;
     AudioEncoder& operator=(AudioEncoder&& other) noexcept;
 
-    // Encode the given PCM samples with Opus. The amount of samples passed must be equal to `frameSize` passed in the constructor.
-    // After you no longer need the encoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioEncoder::freeData(data)`
-    [[nodiscard]] Result<EncodedOpusData> encode(const float* data);
-
-    // Free the underlying buffer of the encoded frame
-    static void freeData(EncodedOpusData& data) {
-        data.freeData();
-    }
+    // Encode the given PCM samples with Opus into `out`. The amount of samples passed must be equal to `frameSize` passed in the constructor.
+    // The encoder picks a lower quality if the frame wouldn't fit in `outCapacity` bytes. Returns the amount of bytes written.
+    [[nodiscard]] Result<size_t> encode(const float* data, util::data::byte* out, size_t outCapacity);
 
     // sets the sample rate that will be used and recreates the encoder
     Result<> setSampleRate(int sampleRate);
@@ -46,20 +40,20 @@ public:
     // sets the amount of channels that will be used and recreates the encoder
     Result<> setChannels(int channels);
 
-private:
-    // EXPERIMENTAL ZONE
-    //
-    // those functions are here for completeness sake, right now they are NOT used anywhere.
-    // in future they may be configurable by the end user, in which case verify that the user cannot screw things up
-    // and remove the `private:` specifier and this comment.
+    // enables in-band forward error correction, every encoded frame then also carries a low quality copy of the previous one,
+    // which the decoder can use to recover it if it gets lost. `expectedLoss` is the packet loss percentage (0-100) to tune for.
+    Result<> setForwardErrorCorrection(bool enabled, int expectedLoss);
+
+    // enables discontinuous transmission, silence then gets encoded into tiny frames that are only sent every 400ms
+    Result<> setDiscontinuousTransmission(bool enabled);
 
     // resets the internal state of the encoder
     Result<> resetState();
 
-    // sets the bitrate for the encoder
+    // sets the bitrate for the encoder, in bits per second
     Result<> setBitrate(int bitrate);
 
-    // sets the encoder complexity (1-10)
+    // sets the encoder complexity (0-10), lower values are faster but sound worse
     Result<> setComplexity(int complexity);
 
     // sets whether to use VBR or CBR (if false)
@@ -1,68 +1,101 @@
 #include "frame.hpp"
 
+#include <cstring>
+
 #ifdef GLOBED_VOICE_SUPPORT
 
 using namespace util::data;
 
 EncodedAudioFrame::EncodedAudioFrame() : _capacity(VOICE_MAX_FRAMES_IN_AUDIO_FRAME) {}
-EncodedAudioFrame::EncodedAudioFrame(size_t capacity) : _capacity(capacity) {}
+EncodedAudioFrame::EncodedAudioFrame(size_t capacity) : _capacity(std::min(capacity, VOICE_MAX_FRAMES_IN_AUDIO_FRAME)) {}
+
+Result<> EncodedAudioFrame::pushOpusFrame(const EncodedOpusData& frame) {
+    if (count >= _capacity) {
+        return Err("tried to push an extra frame into EncodedAudioFrame, {} is the max", _capacity);
+    }
 
-EncodedAudioFrame::~EncodedAudioFrame() {
-    this->clear();
+    if (frame.length > VOICE_MAX_BYTES_IN_FRAME) {
+        return Err("tried to push an opus frame of {} bytes into EncodedAudioFrame, {} is the max", frame.length, VOICE_MAX_BYTES_IN_FRAME);
+    }
+
+    std::memcpy(arena.data() + offsets[count], frame.ptr, frame.length);
+    offsets[count + 1] = offsets[count] + frame.length;
+    count++;
+
+    return Ok();
 }
 
-Result<> EncodedAudioFrame::pushOpusFrame(const EncodedOpusData& frame) {
-    if (frames.size() >= _capacity) {
+Result<> EncodedAudioFrame::pushEncoded(AudioEncoder& encoder, const float* pcm) {
+    if (count >= _capacity) {
         return Err("tried to push an extra frame into EncodedAudioFrame, {} is the max", _capacity);
     }
 
-    frames.push_back(frame);
+    GLOBED_UNWRAP_INTO(encoder.encode(pcm, arena.data() + offsets[count], VOICE_MAX_BYTES_IN_FRAME), size_t length);
+
+    offsets[count + 1] = offsets[count] + length;
+    count++;
+
     return Ok();
 }
 
 void EncodedAudioFrame::setCapacity(size_t frames_) {
-    _capacity = frames_;
-    while (frames.size() > _capacity) {
-        AudioEncoder::freeData(frames.back());
-        frames.pop_back();
-    }
+    _capacity = std::min(frames_, VOICE_MAX_FRAMES_IN_AUDIO_FRAME);
+    count = std::min(count, _capacity);
 }
 
 void EncodedAudioFrame::clear() {
-    for (auto& frame : frames) {
-        AudioEncoder::freeData(frame);
-    }
-
-    frames.clear();
+    count = 0;
 }
 
 size_t EncodedAudioFrame::size() const {
-    return frames.size();
+    return count;
 }
 
 size_t EncodedAudioFrame::capacity() const {
     return _capacity;
 }
 
-const std::vector<EncodedOpusData>& EncodedAudioFrame::getFrames() const {
-    return frames;
+size_t EncodedAudioFrame::encodedSize() const {
+    // a presence flag for every slot, a length prefix for every present frame and the optional sequence
+    return VOICE_MAX_FRAMES_IN_AUDIO_FRAME + count * sizeof(uint32_t) + offsets[count] + (sequence ? sizeof(uint32_t) : 0);
+}
+
+EncodedOpusData EncodedAudioFrame::getFrame(size_t index) const {
+    return EncodedOpusData {
+        .ptr = arena.data() + offsets[index],
+        .length = static_cast<size_t>(offsets[index + 1] - offsets[index]),
+    };
+}
+
+std::optional<uint32_t> EncodedAudioFrame::getSequence() const {
+    return sequence;
+}
+
+void EncodedAudioFrame::setSequence(uint32_t sequence) {
+    this->sequence = sequence;
 }
 
 template<> void ByteBuffer::customEncode(const EncodedAudioFrame& frame) {
     GLOBED_REQUIRE(
-        frame.frames.size() <= frame._capacity,
-        fmt::format("tried to encode an EncodedAudioFrame with {} frames when at most {} is permitted", frame.frames.size(), frame._capacity)
+        frame.count <= frame._capacity,
+        fmt::format("tried to encode an EncodedAudioFrame with {} frames when at most {} is permitted", frame.count, frame._capacity)
     )
 
-    // first encode all opus frames
-    for (auto& frame : frame.frames) {
-        this->writeValue<std::optional<EncodedOpusData>>(frame);
+    // first encode all opus frames, same layout as an `std::optional<EncodedOpusData>` for each
+    for (size_t i = 0; i < frame.count; i++) {
+        this->writeBool(true);
+        this->writeValue(frame.getFrame(i));
     }
 
     // if we have written less than the absolute max, write nullopts
 
-    for (size_t i = frame.frames.size(); i < EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME; i++) {
-        this->writeValue<std::optional<EncodedOpusData>>(std::nullopt);
+    for (size_t i = frame.count; i < EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME; i++) {
+        this->writeBool(false);
+    }
+
+    // the sequence goes at the very end, older clients stop reading before it
+    if (frame.sequence) {
+        this->writeU32(frame.sequence.value());
     }
 }
 
@@ -70,17 +103,60 @@ template<> ByteBuffer::DecodeResult<EncodedAudioFrame> ByteBuffer::customDecode(
     EncodedAudioFrame eframe;
 
     for (size_t i = 0; i < EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME; i++) {
-        auto result = this->readValue<std::optional<EncodedOpusData>>();
-        if (result.isErr()) {
-            eframe.clear();
-            return Err(result.unwrapErr());
+        GLOBED_UNWRAP_INTO(this->readBool(), bool present);
+        if (!present) continue;
+
+        GLOBED_UNWRAP_INTO(this->readU32(), uint32_t length);
+
+        if (length > VOICE_MAX_BYTES_IN_FRAME) {
+            log::warn("Rejecting audio frame, size too large ({})", length);
+            return Err(DecodeError::DataTooLong);
         }
 
-        GLOBED_UNWRAP_INTO(result, auto frame);
-        if (frame) eframe.frames.push_back(frame.value());
+        // read straight into the arena
+        auto& count = eframe.count;
+        GLOBED_UNWRAP(this->readBytesInto(eframe.arena.data() + eframe.offsets[count], length));
+
+        eframe.offsets[count + 1] = eframe.offsets[count] + length;
+        count++;
+    }
+
+    // frames are always at the end of the packet, so anything left is the sequence
+    if (this->size() - this->getPosition() >= sizeof(uint32_t)) {
+        GLOBED_UNWRAP_INTO(this->readU32(), uint32_t sequence);
+        eframe.sequence = sequence;
     }
 
     return Ok(std::move(eframe));
 }
 
-#endif // GLOBED_VOICE_SUPPORT
\ No newline at end of file
+template<> void ByteBuffer::customEncode(const VoiceBundleEntry& entry) {
+    this->writeI32(entry.sender);
+
+    ByteBuffer frameBuf;
+    frameBuf.writeValue(entry.frame);
+
+    this->writeU16(static_cast<uint16_t>(frameBuf.size()));
+    this->rawWriteBytes(frameBuf.rawData(), frameBuf.size());
+}
+
+template<> ByteBuffer::DecodeResult<VoiceBundleEntry> ByteBuffer::customDecode() {
+    VoiceBundleEntry entry;
+
+    GLOBED_UNWRAP_INTO(this->readI32(), entry.sender);
+    GLOBED_UNWRAP_INTO(this->readU16(), uint16_t length);
+
+    if (this->size() - this->getPosition() < length) {
+        return Err(DecodeError::LengthPrefixTooLong);
+    }
+
+    // decode from a view that ends where the frame does, so the sequence is found without copying
+    auto frameBuf = ByteBuffer::view(this->rawData() + this->getPosition(), length);
+    GLOBED_UNWRAP_INTO(frameBuf.readValue<EncodedAudioFrame>(), entry.frame);
+
+    this->setPosition(this->getPosition() + length);
+
+    return Ok(std::move(entry));
+}
+
+#endif // GLOBED_VOICE_SUPPORT
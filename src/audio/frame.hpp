@@ -5,7 +5,8 @@
 
 #include "encoder.hpp"
 
-// Represents an audio frame that contains multiple encoded opus frames
+// Represents an audio frame that contains multiple encoded opus frames.
+// The opus frames are stored back to back in an inline buffer, so creating, copying or decoding one never allocates.
 class EncodedAudioFrame {
 public:
     friend class ByteBuffer;
@@ -21,18 +22,11 @@ public:
 
     EncodedAudioFrame();
     EncodedAudioFrame(size_t capacity);
-    ~EncodedAudioFrame();
 
-    // prevent copying since we manually free the opus frames in the dtor
-    EncodedAudioFrame(const EncodedAudioFrame&) = delete;
-    EncodedAudioFrame operator=(const EncodedAudioFrame& other) = delete;
-
-    // allow moving
-    EncodedAudioFrame(EncodedAudioFrame&& other) noexcept = default;
-    EncodedAudioFrame& operator=(EncodedAudioFrame&&) noexcept = default;
-
-    // adds this audio frame to the list
+    // adds a copy of this opus frame to the list
     Result<> pushOpusFrame(const EncodedOpusData& frame);
+    // encodes the pcm samples with `encoder` directly into the next opus frame
+    Result<> pushEncoded(AudioEncoder& encoder, const float* pcm);
 
     // set the capacity of the audio frame, in individual opus frames
     void setCapacity(size_t frames);
@@ -41,12 +35,31 @@ public:
     size_t size() const;
     size_t capacity() const;
 
-    // extract all frames
-    const std::vector<EncodedOpusData>& getFrames() const;
+    // amount of bytes this frame takes up when encoded into a `ByteBuffer`
+    size_t encodedSize() const;
+
+    // the returned data points into this frame, so it is only valid as long as the frame is alive and unchanged
+    EncodedOpusData getFrame(size_t index) const;
+
+    // Sequence number of the first opus frame in this frame, counted in opus frames. Used to detect lost packets.
+    // Frames from older clients don't have one.
+    std::optional<uint32_t> getSequence() const;
+    void setSequence(uint32_t sequence);
 
 protected:
-    mutable std::vector<EncodedOpusData> frames;
+    std::array<util::data::byte, VOICE_MAX_FRAMES_IN_AUDIO_FRAME * VOICE_MAX_BYTES_IN_FRAME> arena;
+    // frame `i` spans from `offsets[i]` to `offsets[i + 1]` in the arena
+    std::array<uint16_t, VOICE_MAX_FRAMES_IN_AUDIO_FRAME + 1> offsets = {};
+    size_t count = 0;
     size_t _capacity;
+    std::optional<uint32_t> sequence;
+};
+
+// A frame from one speaker in a `VoiceBundlePacket`. Encoded with a u16 length prefix,
+// because `EncodedAudioFrame` reads until the end of its buffer.
+struct VoiceBundleEntry {
+    int sender;
+    EncodedAudioFrame frame;
 };
 
 
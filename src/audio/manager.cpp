@@ -8,6 +8,9 @@
 # include <objbase.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+
 #include <opus.h>
 #include <Geode/utils/permission.hpp>
 
@@ -15,6 +18,9 @@
 #include <managers/settings.hpp>
 #include <util/debug.hpp>
 #include <util/format.hpp>
+#include <util/profiler.hpp>
+#include <util/thread.hpp>
+#include <util/time.hpp>
 
 using namespace geode::prelude;
 namespace permission = geode::utils::permission;
@@ -41,6 +47,8 @@ GlobedAudioManager::GlobedAudioManager()
     // initializing COM is not necessary as FMOD will do it on its own, but FMOD docs recommend doing it anyway.
     audioThreadHandle.setStartFunction([] {
         geode::utils::thread::setName("Audio Thread");
+        GLOBED_PROFILE_THREAD("Audio Thread");
+        util::thread::configureCurrent(util::thread::Priority::TimeCritical, util::thread::CoreHint::Performance);
 #ifdef GEODE_IS_WINDOWS
         auto result = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
         if (result != S_OK) {
@@ -55,6 +63,22 @@ GlobedAudioManager::GlobedAudioManager()
     });
 #endif
 
+    // voice packets are sent over udp, so let the receivers recover lost ones
+    auto fecResult = encoder.setForwardErrorCorrection(true, VOICE_EXPECTED_PACKET_LOSS);
+    if (!fecResult) {
+        log::warn("failed to enable opus fec: {}", fecResult.unwrapErr());
+    }
+
+    auto encoderResult = [&]() -> Result<> {
+        GLOBED_UNWRAP(encoder.setDiscontinuousTransmission(true));
+        GLOBED_UNWRAP(encoder.setBitrate(encoderBitrate));
+        return encoder.setComplexity(encoderComplexity);
+    }();
+
+    if (!encoderResult) {
+        log::warn("failed to configure opus encoder: {}", encoderResult.unwrapErr());
+    }
+
     audioThreadHandle.start(this);
 
     recordDevice = {.id = -1};
@@ -68,6 +92,17 @@ GlobedAudioManager::~GlobedAudioManager() {
 }
 
 void GlobedAudioManager::preInitialize() {
+    auto cbResult = this->getSystem()->setCallback(
+        &GlobedAudioManager::onDeviceListChanged,
+        FMOD_SYSTEM_CALLBACK_DEVICELISTCHANGED | FMOD_SYSTEM_CALLBACK_RECORDLISTCHANGED
+    );
+
+    if (cbResult == FMOD_OK) {
+        deviceCallbackSet = true;
+    } else {
+        log::warn("{}, audio devices will be enumerated every time", formatFmodError(cbResult, "System::setCallback"));
+    }
+
 #ifdef GEODE_IS_ANDROID
     // the first call to FMOD::System::getRecordDriverInfo for some reason can take half a second on android,
     // causing a freeze when the user first opens the playlayer.
@@ -101,7 +136,48 @@ void GlobedAudioManager::preInitialize() {
 }
 
 std::vector<AudioRecordingDevice> GlobedAudioManager::getRecordingDevices() {
-    std::vector<AudioRecordingDevice> out;
+    auto cache = deviceCache.lock();
+    this->ensureDeviceCache(*cache);
+    return cache->record;
+}
+
+std::vector<AudioPlaybackDevice> GlobedAudioManager::getPlaybackDevices() {
+    auto cache = deviceCache.lock();
+    this->ensureDeviceCache(*cache);
+    return cache->playback;
+}
+
+std::optional<AudioRecordingDevice> GlobedAudioManager::getRecordingDevice(int deviceId) {
+    auto cache = deviceCache.lock();
+    this->ensureDeviceCache(*cache);
+
+    auto it = std::find_if(cache->record.begin(), cache->record.end(), [&](auto& dev) { return dev.id == deviceId; });
+    return it == cache->record.end() ? std::nullopt : std::optional(*it);
+}
+
+std::optional<AudioPlaybackDevice> GlobedAudioManager::getPlaybackDevice(int deviceId) {
+    auto cache = deviceCache.lock();
+    this->ensureDeviceCache(*cache);
+
+    auto it = std::find_if(cache->playback.begin(), cache->playback.end(), [&](auto& dev) { return dev.id == deviceId; });
+    return it == cache->playback.end() ? std::nullopt : std::optional(*it);
+}
+
+uint32_t GlobedAudioManager::currentDeviceGeneration() {
+    // without the callback there is no way to know if anything changed, so the cache is never trusted
+    if (!deviceCallbackSet) {
+        return deviceGeneration.fetch_add(1) + 1;
+    }
+
+    return deviceGeneration.load();
+}
+
+void GlobedAudioManager::ensureDeviceCache(DeviceCache& cache) {
+    uint32_t generation = this->currentDeviceGeneration();
+    if (cache.generation == generation) return;
+
+    cache.record.clear();
+    cache.playback.clear();
 
     int numDrivers, numConnected;
     FMOD_ERR_CHECK(
@@ -110,35 +186,34 @@ std::vector<AudioRecordingDevice> GlobedAudioManager::getRecordingDevices() {
     )
 
     for (int i = 0; i < numDrivers; i++) {
-        auto dev = this->getRecordingDevice(i);
+        auto dev = this->queryRecordingDevice(i);
         if (dev.has_value()) {
-            out.push_back(dev.value());
+            cache.record.push_back(std::move(dev.value()));
         }
     }
 
-    return out;
-}
-
-std::vector<AudioPlaybackDevice> GlobedAudioManager::getPlaybackDevices() {
-    std::vector<AudioPlaybackDevice> out;
-
-    int numDrivers;
     FMOD_ERR_CHECK(
         this->getSystem()->getNumDrivers(&numDrivers),
         "System::getNumDrivers"
     )
 
     for (int i = 0; i < numDrivers; i++) {
-        auto dev = this->getPlaybackDevice(i);
+        auto dev = this->queryPlaybackDevice(i);
         if (dev.has_value()) {
-            out.push_back(dev.value());
+            cache.playback.push_back(std::move(dev.value()));
         }
     }
 
-    return out;
+    cache.generation = generation;
 }
 
-std::optional<AudioRecordingDevice> GlobedAudioManager::getRecordingDevice(int deviceId) {
+FMOD_RESULT F_CALLBACK GlobedAudioManager::onDeviceListChanged(FMOD_SYSTEM*, FMOD_SYSTEM_CALLBACK_TYPE, void*, void*, void*) {
+    // called from `System::update` on the main thread, only mark the lists stale so that nothing is enumerated here
+    GlobedAudioManager::get().deviceGeneration.fetch_add(1);
+    return FMOD_OK;
+}
+
+std::optional<AudioRecordingDevice> GlobedAudioManager::queryRecordingDevice(int deviceId) {
     AudioRecordingDevice device;
     char name[256];
 
@@ -167,7 +242,7 @@ std::optional<AudioRecordingDevice> GlobedAudioManager::getRecordingDevice(int d
     return device;
 }
 
-std::optional<AudioPlaybackDevice> GlobedAudioManager::getPlaybackDevice(int deviceId) {
+std::optional<AudioPlaybackDevice> GlobedAudioManager::queryPlaybackDevice(int deviceId) {
     AudioPlaybackDevice device;
     char name[256];
     if (this->getSystem()->getDriverInfo(
@@ -191,6 +266,11 @@ bool GlobedAudioManager::isRecordingDeviceSet() {
 }
 
 void GlobedAudioManager::validateDevices() {
+    // nothing was plugged in or out since the last check, so the selected devices are still there
+    uint32_t generation = this->currentDeviceGeneration();
+    if (generation == validatedGeneration) return;
+    validatedGeneration = generation;
+
     try {
         if (recordDevice.id != -1) {
             this->setActiveRecordingDevice(recordDevice.id);
@@ -220,6 +300,80 @@ void GlobedAudioManager::setRecordBufferCapacity(size_t frames) {
     recordFrame.setCapacity(frames);
 }
 
+void GlobedAudioManager::setVoiceActivityDetection(bool enabled) {
+    recordVadEnabled = enabled;
+}
+
+void GlobedAudioManager::setNetworkConditions(float lossRate, int ping) {
+    netLossRate = lossRate;
+    netPing = ping;
+    encoderDirty = true;
+}
+
+int GlobedAudioManager::getEncoderBitrate() {
+    return encoderBitrate;
+}
+
+int GlobedAudioManager::getEncoderComplexity() {
+    return encoderComplexity;
+}
+
+void GlobedAudioManager::applyNetworkConditions() {
+    float loss = netLossRate;
+    int ping = netPing;
+
+    // on a lossy or slow connection, spend less on the audio itself and more on redundancy
+    int bitrate = VOICE_MAX_BITRATE;
+    if (loss > 0.1f) {
+        bitrate = VOICE_MIN_BITRATE;
+    } else if (loss > 0.03f || ping > 300) {
+        bitrate = (VOICE_MIN_BITRATE + VOICE_MAX_BITRATE) / 2;
+    }
+
+    int expectedLoss = std::clamp(static_cast<int>(std::ceil(loss * 100.f)), VOICE_EXPECTED_PACKET_LOSS, 40);
+
+    auto result = encoder.setForwardErrorCorrection(true, expectedLoss);
+    if (result && bitrate != encoderBitrate) {
+        result = encoder.setBitrate(bitrate);
+        if (result) encoderBitrate = bitrate;
+    }
+
+    if (!result) {
+        log::warn("failed to update opus encoder: {}", result.unwrapErr());
+    }
+}
+
+Result<> GlobedAudioManager::encodeFrame(const float* pcm) {
+    if (encoderDirty.exchange(false)) {
+        this->applyNetworkConditions();
+    }
+
+    auto start = util::time::now();
+    GLOBED_UNWRAP(recordFrame.pushEncoded(encoder, pcm));
+    float took = std::chrono::duration<float>(util::time::now() - start).count();
+
+    encodeLoad += (took / VOICE_CHUNK_RECORD_TIME - encodeLoad) * 0.1f;
+
+    // adjust the complexity if encoding takes a big part of the frame duration (weak cpu) or barely any of it.
+    // wait a few seconds between changes so the smoothed load can settle.
+    if (++framesSinceComplexityChange < 50) return Ok();
+
+    int complexity = encoderComplexity;
+    if (encodeLoad > 0.15f && complexity > VOICE_MIN_COMPLEXITY) {
+        complexity--;
+    } else if (encodeLoad < 0.03f && complexity < VOICE_MAX_COMPLEXITY) {
+        complexity++;
+    } else {
+        return Ok();
+    }
+
+    GLOBED_UNWRAP(encoder.setComplexity(complexity));
+    encoderComplexity = complexity;
+    framesSinceComplexityChange = 0;
+
+    return Ok();
+}
+
 Result<> GlobedAudioManager::startRecordingInternal(bool passive) {
     if (!permission::getPermissionStatus(Permission::RecordAudio)) {
         return Err("Recording failed, please grant microphone permission in Globed settings");
@@ -238,11 +392,22 @@ Result<> GlobedAudioManager::startRecordingInternal(bool passive) {
     exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
     exinfo.numchannels = 1;
     exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
-    exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
+    // record at the device's own rate, so FMOD doesn't have to resample internally
+    int deviceRate = recordDevice.sampleRate > 0 ? recordDevice.sampleRate : static_cast<int>(VOICE_TARGET_SAMPLERATE);
+
+    exinfo.defaultfrequency = deviceRate;
     exinfo.length = sizeof(float) * exinfo.defaultfrequency * exinfo.numchannels;
 
     recordChunkSize = exinfo.length;
 
+    if (recordResampler.getInputRate() != static_cast<size_t>(deviceRate)) {
+        recordResampler = AudioResampler(deviceRate, VOICE_TARGET_SAMPLERATE);
+        log::debug("recording at {}hz, resampler adds {:.2f}ms of latency", deviceRate, recordResampler.getLatency() * 1000.0);
+    }
+
+    recordResampler.reset();
+    recordResampleLatency = static_cast<float>(recordResampler.getLatency());
+
     FMOD_ERR_CHECK_SAFE(
         this->getSystem()->createSound(nullptr, FMOD_2D | FMOD_OPENUSER | FMOD_LOOP_NORMAL, &exinfo, &recordSound),
         "System::createSound"
@@ -260,8 +425,10 @@ Result<> GlobedAudioManager::startRecordingInternal(bool passive) {
     recordQueuedStop = false;
     recordQueuedHalt = false;
     recordLastPosition = 0;
+    recordVad.reset();
     recordActive = true;
     recordingPassive = passive;
+    audioThreadWakeup.push(true);
 
     return Ok();
 }
@@ -311,6 +478,8 @@ void GlobedAudioManager::internalStopRecording() {
     recordingPassiveActive = false;
     recordQueue.clear();
 
+    this->stopLoopback();
+
     if (recordSound) {
         recordSound->release();
         recordSound = nullptr;
@@ -322,11 +491,13 @@ void GlobedAudioManager::internalStopRecording() {
 
 void GlobedAudioManager::stopRecording() {
     recordQueuedStop = true;
+    audioThreadWakeup.push(true);
 }
 
 void GlobedAudioManager::haltRecording() {
     recordQueuedStop = true;
     recordQueuedHalt = true;
+    audioThreadWakeup.push(true);
 }
 
 bool GlobedAudioManager::isRecording() {
@@ -348,6 +519,10 @@ bool GlobedAudioManager::isRecording() {
     return recording;
 }
 
+double GlobedAudioManager::getRecordResampleLatency() {
+    return recordResampleLatency;
+}
+
 Result<> GlobedAudioManager::startPassiveRecording(std::function<void(const EncodedAudioFrame&)> callback) {
     auto result = this->startRecordingInternal(true);
     if (result.isErr()) return result;
@@ -360,10 +535,138 @@ Result<> GlobedAudioManager::startPassiveRecording(std::function<void(const Enco
 
 void GlobedAudioManager::resumePassiveRecording() {
     recordingPassiveActive = true;
+    audioThreadWakeup.push(true);
 }
 
 void GlobedAudioManager::pausePassiveRecording() {
     recordingPassiveActive = false;
+    audioThreadWakeup.push(true);
+}
+
+void GlobedAudioManager::setLoopbackEnabled(bool enabled) {
+    loopbackEnabled = enabled;
+    audioThreadWakeup.push(true);
+}
+
+bool GlobedAudioManager::isLoopbackEnabled() {
+    return loopbackEnabled;
+}
+
+double GlobedAudioManager::getLoopbackLatency() {
+    return loopbackLatency.load();
+}
+
+void GlobedAudioManager::updateLoopback() {
+    if (loopbackEnabled && !loopbackSound) {
+        auto result = this->startLoopback();
+        if (!result) {
+            ErrorQueues::get().warn(fmt::format("Failed to start voice loopback: {}", result.unwrapErr()));
+            loopbackEnabled = false;
+            this->stopLoopback();
+        }
+    } else if (!loopbackEnabled && loopbackSound) {
+        this->stopLoopback();
+    }
+}
+
+Result<> GlobedAudioManager::startLoopback() {
+    // play at the rate we record at, the samples are taken before they get resampled for the encoder
+    loopbackRate = recordDevice.sampleRate > 0 ? recordDevice.sampleRate : VOICE_TARGET_SAMPLERATE;
+    loopbackQueue.clear();
+    loopbackLatency = 0.f;
+
+    FMOD_CREATESOUNDEXINFO exinfo = {};
+
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.numchannels = 1;
+    exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+    exinfo.defaultfrequency = loopbackRate;
+    exinfo.length = sizeof(float) * loopbackRate;
+    // streams decode 400ms ahead by default, which would be most of the delay
+    exinfo.decodebuffersize = std::max<unsigned int>(loopbackRate * VOICE_LOOPBACK_BLOCK_TIME, 64);
+    exinfo.userdata = this;
+
+    exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data, unsigned int len) -> FMOD_RESULT {
+        FMOD::Sound* sound = reinterpret_cast<FMOD::Sound*>(sound_);
+        GlobedAudioManager* manager = nullptr;
+        sound->getUserData((void**)&manager);
+
+        if (!manager || !data) return FMOD_OK;
+
+        GLOBED_PROFILE_THREAD("FMOD Mixer");
+        GLOBED_PROFILE_ZONE("audio: loopback callback");
+
+        float* out = reinterpret_cast<float*>(data);
+        size_t neededSamples = len / sizeof(float);
+        size_t copied = manager->loopbackRead(out, neededSamples);
+
+        std::fill(out + copied, out + neededSamples, 0.0f);
+
+        return FMOD_OK;
+    };
+
+    FMOD_ERR_CHECK_SAFE(
+        this->getSystem()->createStream(nullptr, FMOD_OPENUSER | FMOD_2D | FMOD_LOOP_NORMAL, &exinfo, &loopbackSound),
+        "System::createStream"
+    )
+
+    FMOD_ERR_CHECK_SAFE(
+        this->getSystem()->playSound(loopbackSound, nullptr, false, &loopbackChannel),
+        "System::playSound"
+    )
+
+    // everything between a sample being recorded and reaching the speakers, apart from what's waiting in the queue
+    unsigned int dspLength = 0;
+    int dspBuffers = 0, outputRate = 0;
+    this->getSystem()->getDSPBufferSize(&dspLength, &dspBuffers);
+    this->getSystem()->getSoftwareFormat(&outputRate, nullptr, nullptr);
+
+    float capturePoll = static_cast<float>(VOICE_TARGET_FRAMESIZE / 4) / VOICE_TARGET_SAMPLERATE / 2.f;
+    float decodeBlock = static_cast<float>(exinfo.decodebuffersize) / loopbackRate;
+    float mixer = outputRate > 0 ? static_cast<float>(dspLength * dspBuffers) / outputRate : 0.f;
+    loopbackFixedLatency = capturePoll + decodeBlock + mixer;
+
+    log::debug("voice loopback started at {}hz, fixed latency {:.2f}ms", loopbackRate, loopbackFixedLatency * 1000.f);
+
+    return Ok();
+}
+
+void GlobedAudioManager::stopLoopback() {
+    if (loopbackSound) {
+        loopbackSound->setUserData(nullptr);
+    }
+
+    if (loopbackChannel) {
+        loopbackChannel->stop();
+        loopbackChannel = nullptr;
+    }
+
+    if (loopbackSound) {
+        loopbackSound->release();
+        loopbackSound = nullptr;
+    }
+
+    loopbackQueue.clear();
+    loopbackLatency = 0.f;
+}
+
+size_t GlobedAudioManager::loopbackRead(float* out, size_t samples) {
+    // if recording got ahead of playback (e.g. the mixer stalled), skip ahead instead of staying behind forever
+    size_t maxQueued = samples + static_cast<size_t>(loopbackRate * VOICE_LOOPBACK_MAX_BUFFERED);
+    size_t queued = loopbackQueue.size();
+
+    while (queued > maxQueued) {
+        queued -= loopbackQueue.copyTo(out, std::min(queued - maxQueued, samples));
+    }
+
+    // only measured while there is something to play, otherwise the queue is empty because nobody is talking
+    if (queued > 0) {
+        float latency = loopbackFixedLatency + static_cast<float>(queued) / loopbackRate;
+        float prev = loopbackLatency.load();
+        loopbackLatency = prev == 0.f ? latency : prev + (latency - prev) / 8.f;
+    }
+
+    return loopbackQueue.copyTo(out, samples);
 }
 
 FMOD::Channel* GlobedAudioManager::playSound(FMOD::Sound* sound) {
@@ -448,11 +751,17 @@ void GlobedAudioManager::setActivePlaybackDevice(const AudioPlaybackDevice& devi
 
 void GlobedAudioManager::toggleLoopbacksAllowed(bool allowed) {
     loopbacksAllowed = allowed;
+
+    // loopback devices are filtered out when enumerating, so the cached list has to be rebuilt
+    deviceGeneration.fetch_add(1);
 }
 
 void GlobedAudioManager::recordInvokeCallback() {
     if (recordFrame.size() == 0) return;
 
+    recordFrame.setSequence(recordSequence);
+    recordSequence += recordFrame.size();
+
     try {
         recordCallback(recordFrame);
     } catch (const std::exception& e) {
@@ -473,10 +782,11 @@ void GlobedAudioManager::recordInvokeRawCallback(float* pcm, size_t samples) {
 }
 
 void GlobedAudioManager::audioThreadFunc() {
-    // if we are not recording right now, sleep
+    // if we are not recording right now, sleep until recording starts.
+    // the timeout is only there so the thread can notice when it's being stopped
     if (!recordActive) {
         audioThreadSleeping = true;
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        (void) audioThreadWakeup.popTimeout(util::time::millis(250));
         return;
     }
 
@@ -490,6 +800,7 @@ void GlobedAudioManager::audioThreadFunc() {
 
     audioThreadSleeping = false;
 
+    GLOBED_PROFILE_ZONE("audio: record work");
     auto result = this->audioThreadWork();
 
     if (result.isErr()) {
@@ -500,8 +811,7 @@ void GlobedAudioManager::audioThreadFunc() {
 }
 
 Result<> GlobedAudioManager::audioThreadWork() {
-    float* pcmData;
-    unsigned int pcmLen;
+    this->updateLoopback();
 
     unsigned int pos;
     FMOD_ERR_CHECK_SAFE(
@@ -509,13 +819,30 @@ Result<> GlobedAudioManager::audioThreadWork() {
         "System::getRecordPosition"
     )
 
-    // if we are at the same position, do nothing
-    if (pos == recordLastPosition) {
-        this->getSystem()->update();
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        return Ok();
+    // if we are at the same position, there's nothing new to read
+    if (pos != recordLastPosition) {
+        GLOBED_UNWRAP(this->recordReadData(pos));
     }
 
+    this->getSystem()->update();
+
+    // sleep until the next frame should be fully recorded, rather than repeatedly polling the record position.
+    // raw recording and the loopback are used for live previews so they wake up more often.
+    // anything that changes the recording state (stopping, pausing) wakes the thread up early.
+    size_t target = (recordingRaw || loopbackSound) ? VOICE_TARGET_FRAMESIZE / 4 : VOICE_TARGET_FRAMESIZE;
+    size_t queued = recordQueue.size();
+    size_t missing = queued < target ? target - queued : 0;
+
+    // an extra millisecond since the driver hands out audio in blocks and may be slightly behind
+    (void) audioThreadWakeup.popTimeout(util::time::millis(missing * 1000 / VOICE_TARGET_SAMPLERATE + 1));
+
+    return Ok();
+}
+
+Result<> GlobedAudioManager::recordReadData(unsigned int pos) {
+    float* pcmData;
+    unsigned int pcmLen;
+
     FMOD_ERR_CHECK_SAFE(
         recordSound->lock(0, recordChunkSize, (void**)&pcmData, nullptr, &pcmLen, nullptr),
         "Sound::lock"
@@ -524,12 +851,12 @@ Result<> GlobedAudioManager::audioThreadWork() {
     // don't write any data if we are in passive recording and not currently recording
     if (!recordingPassive || recordingPassiveActive) {
         if (pos > recordLastPosition) {
-            recordQueue.writeData(pcmData + recordLastPosition, pos - recordLastPosition);
+            this->recordWriteSamples(pcmData + recordLastPosition, pos - recordLastPosition);
         } else if (pos < recordLastPosition) { // we have reached the end of the buffer
             // write the data left at the end
-            recordQueue.writeData(pcmData + recordLastPosition, pcmLen / sizeof(float) - recordLastPosition);
+            this->recordWriteSamples(pcmData + recordLastPosition, pcmLen / sizeof(float) - recordLastPosition);
             // write the data from beginning to current pos
-            recordQueue.writeData(pcmData, pos);
+            this->recordWriteSamples(pcmData, pos);
         }
     }
 
@@ -541,33 +868,59 @@ Result<> GlobedAudioManager::audioThreadWork() {
     )
 
     if (recordingRaw) {
-        // raw recording, call the raw callback with the pcm data directly.
-        float* pcm = recordQueue.data();
-        size_t samples = recordQueue.size();
-        this->recordInvokeRawCallback(pcm, samples);
-        recordQueue.clear();
+        // raw recording, call the raw callback with everything that was recorded, one frame at a time.
+        float pcmbuf[VOICE_TARGET_FRAMESIZE];
+        while (size_t samples = recordQueue.copyTo(pcmbuf, VOICE_TARGET_FRAMESIZE)) {
+            this->recordInvokeRawCallback(pcmbuf, samples);
+        }
     } else {
-        // encoded recording, encode the data and push to the frame.
-        if (recordQueue.size() >= VOICE_TARGET_FRAMESIZE) {
-            float pcmbuf[VOICE_TARGET_FRAMESIZE];
+        // encoded recording, encode every full frame and push it to the audio frame.
+        float pcmbuf[VOICE_TARGET_FRAMESIZE];
+        while (recordQueue.size() >= VOICE_TARGET_FRAMESIZE) {
             recordQueue.copyTo(pcmbuf, VOICE_TARGET_FRAMESIZE);
 
-            GLOBED_UNWRAP_INTO(encoder.encode(pcmbuf), auto opusFrame);
-            GLOBED_UNWRAP(recordFrame.pushOpusFrame(opusFrame));
+            // silent frames are skipped entirely. they don't take up a sequence number either,
+            // so the receiver does not mistake a pause for packet loss and simply plays silence once its buffer runs dry.
+            bool talkspurtEnded = false;
+            if (!recordVadEnabled || recordVad.process(pcmbuf, VOICE_TARGET_FRAMESIZE)) {
+                GLOBED_UNWRAP(this->encodeFrame(pcmbuf));
+            } else {
+                talkspurtEnded = recordVad.justEnded();
+            }
+
+            // if we are at capacity or the speaker went silent, call the callback
+            if (recordFrame.size() >= recordFrame.capacity() || (talkspurtEnded && recordFrame.size() > 0)) {
+                this->recordInvokeCallback();
+            }
         }
 
-        // if we are at capacity, or we just stopped passive recording, call the callback
-        if (recordFrame.size() >= recordFrame.capacity() || (recordFrame.size() > 0 && recordingPassive && !recordingPassiveActive)) {
+        // if we just stopped passive recording, send whatever is left
+        if (recordFrame.size() > 0 && recordingPassive && !recordingPassiveActive) {
             this->recordInvokeCallback();
         }
     }
 
-    this->getSystem()->update();
+    return Ok();
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
-    // std::this_thread::yield();
+void GlobedAudioManager::recordWriteSamples(const float* pcm, size_t samples) {
+    if (loopbackSound) {
+        loopbackQueue.writeData(pcm, samples);
+    }
 
-    return Ok();
+    if (!recordResampler.isActive()) {
+        recordQueue.writeData(pcm, samples);
+        return;
+    }
+
+    // only grows for the first few reads, after that no allocations happen here
+    size_t needed = recordResampler.maxOutput(samples);
+    if (recordResampleBuffer.size() < needed) {
+        recordResampleBuffer.resize(needed);
+    }
+
+    size_t written = recordResampler.process(pcm, samples, recordResampleBuffer.data());
+    recordQueue.writeData(recordResampleBuffer.data(), written);
 }
 
 FMOD::System* GlobedAudioManager::getSystem() {
@@ -11,7 +11,9 @@
 #include <asp/thread.hpp>
 
 #include "frame.hpp"
+#include "resampler.hpp"
 #include "sample_queue.hpp"
+#include "voice_activity.hpp"
 
 struct AudioRecordingDevice {
     int id = -1;
@@ -37,6 +39,24 @@ constexpr float VOICE_CHUNK_RECORD_TIME = 0.06f; // the audio buffer that is rec
 constexpr size_t VOICE_TARGET_FRAMESIZE = VOICE_TARGET_SAMPLERATE * VOICE_CHUNK_RECORD_TIME; // opus framesize
 constexpr size_t VOICE_CHANNELS = 1;
 constexpr int MAX_AUDIO_CHANNELS = 512;
+constexpr int VOICE_EXPECTED_PACKET_LOSS = 10; // percentage the encoder tunes its FEC for
+constexpr uint32_t VOICE_MAX_CONCEALED_FRAMES = 5; // losing more opus frames than this in a row is treated as a new stream
+// bounds for how long a stream waits after the first packet before it starts (or resumes) playing, see `AudioStream`
+constexpr float VOICE_MIN_PLAYOUT_DELAY = 0.02f;
+constexpr float VOICE_MAX_PLAYOUT_DELAY = 0.4f;
+// bitrate range the encoder is adjusted in, based on the network conditions (bits per second)
+constexpr int VOICE_MIN_BITRATE = 12000;
+constexpr int VOICE_MAX_BITRATE = 32000;
+// the loopback monitor is fed in blocks of this length, and drops the oldest audio once more than the max is waiting (seconds)
+constexpr float VOICE_LOOPBACK_BLOCK_TIME = 0.01f;
+constexpr float VOICE_LOOPBACK_MAX_BUFFERED = 0.05f;
+// encoder complexity range, the complexity is lowered if encoding takes too long
+constexpr int VOICE_MIN_COMPLEXITY = 2;
+#ifdef GLOBED_IS_ARM
+constexpr int VOICE_MAX_COMPLEXITY = 6;
+#else
+constexpr int VOICE_MAX_COMPLEXITY = 10;
+#endif
 
 // This class might thread safe ?
 class GlobedAudioManager : public SingletonBase<GlobedAudioManager> {
@@ -49,6 +69,7 @@ public:
     // preinitialization, for more info open the implementation
     void preInitialize();
 
+    // the device lists are cached, and only enumerated again after FMOD reports that a device was added or removed
     std::vector<AudioRecordingDevice> getRecordingDevices();
     std::vector<AudioPlaybackDevice> getPlaybackDevices();
 
@@ -67,6 +88,7 @@ public:
 
     // if the current selected recording/playback is invalid (i.e. disconnected),
     // it will be reset. if no device is selected or a valid device is selected, nothing happens.
+    // only does any work if the device list changed since the last call.
     void validateDevices();
 
     /* Recording API */
@@ -74,6 +96,17 @@ public:
     // set the amount of record frames in a buffer (used by the lowerAudioLatency setting)
     void setRecordBufferCapacity(size_t frames);
 
+    // toggle voice activity detection for encoded recording, when enabled silent frames are not encoded or sent
+    void setVoiceActivityDetection(bool enabled);
+
+    // update the measured network conditions, the encoder bitrate and FEC strength are adjusted accordingly.
+    // `lossRate` is the fraction of lost packets (0-1), `ping` is the round trip time in milliseconds.
+    void setNetworkConditions(float lossRate, int ping);
+
+    // get the current encoder bitrate (in bits per second) and complexity
+    int getEncoderBitrate();
+    int getEncoderComplexity();
+
     // start recording the voice and call the callback once a full frame is ready.
     // if `stopRecording()` is called at any point, the callback will be called with the remaining data.
     // in that case it may have less than the full 10 frames.
@@ -89,6 +122,10 @@ public:
     void haltRecording();
     bool isRecording();
 
+    // delay added by converting the recording device's sample rate to `VOICE_TARGET_SAMPLERATE`, in seconds.
+    // zero if the device records at the target rate already, only meaningful while recording
+    double getRecordResampleLatency();
+
     /* Background recording API */
 
     // start recording, similar to `startRecording` but the callback is not automatically called,
@@ -98,6 +135,16 @@ public:
     void resumePassiveRecording();
     void pausePassiveRecording();
 
+    /* Loopback API */
+
+    // when enabled, everything that is recorded is also played back right away, at the recording device's rate
+    // and without going through the encoder or a voice stream. can be toggled while recording.
+    void setLoopbackEnabled(bool enabled);
+    bool isLoopbackEnabled();
+    // estimated time between audio being recorded and heard through the loopback, in seconds. zero if nothing is playing.
+    // does not include the buffering done by the audio drivers themselves
+    double getLoopbackLatency();
+
     /* Misc */
 
     // play a sound and return the channel associated with it
@@ -127,6 +174,27 @@ private:
 
     asp::AtomicBool loopbacksAllowed = false;
 
+    struct DeviceCache {
+        uint32_t generation = 0;
+        std::vector<AudioRecordingDevice> record;
+        std::vector<AudioPlaybackDevice> playback;
+    };
+
+    // bumped whenever the cached device lists go stale, by the FMOD callback or by changing what gets listed.
+    // without the callback every generation check fails, and the lists are enumerated on every call like before
+    asp::AtomicU32 deviceGeneration = 1;
+    asp::AtomicBool deviceCallbackSet = false;
+    asp::Mutex<DeviceCache> deviceCache;
+    uint32_t validatedGeneration = 0;
+
+    uint32_t currentDeviceGeneration();
+    // refills the (locked) cache from FMOD if it's out of date
+    void ensureDeviceCache(DeviceCache& cache);
+    std::optional<AudioRecordingDevice> queryRecordingDevice(int deviceId);
+    std::optional<AudioPlaybackDevice> queryPlaybackDevice(int deviceId);
+
+    static FMOD_RESULT F_CALLBACK onDeviceListChanged(FMOD_SYSTEM* system, FMOD_SYSTEM_CALLBACK_TYPE type, void* data1, void* data2, void* userdata);
+
     /* recording */
     asp::AtomicBool recordActive = false;
     asp::AtomicBool recordQueuedStop = false;
@@ -138,25 +206,64 @@ private:
     size_t recordChunkSize = 0;
     std::function<void(const EncodedAudioFrame&)> recordCallback;
     std::function<void(const float*, size_t)> recordRawCallback;
-    AudioSampleQueue recordQueue;
+    // the recording sound holds 1 second of audio, so this can always fit a full lap of it
+    AudioSampleQueue recordQueue{VOICE_TARGET_SAMPLERATE + VOICE_TARGET_FRAMESIZE};
     unsigned int recordLastPosition = 0;
+    // the sound records at the device's native rate, and is converted to the opus rate before it goes into `recordQueue`
+    AudioResampler recordResampler;
+    std::vector<float> recordResampleBuffer;
+    asp::AtomicF32 recordResampleLatency = 0.f;
     EncodedAudioFrame recordFrame;
+    uint32_t recordSequence = 0;
+    asp::AtomicBool recordVadEnabled = true;
+    VoiceActivityDetector recordVad;
+
+    // encoder tuning, network conditions are set from the main thread and applied on the audio thread
+    asp::AtomicF32 netLossRate = 0.f;
+    asp::AtomicInt netPing = 0;
+    asp::AtomicBool encoderDirty = false;
+    asp::AtomicInt encoderBitrate = VOICE_MAX_BITRATE;
+    asp::AtomicInt encoderComplexity = VOICE_MAX_COMPLEXITY;
+    float encodeLoad = 0.f; // smoothed fraction of the frame duration spent encoding
+    size_t framesSinceComplexityChange = 0;
 
     Result<> startRecordingInternal(bool passive = false);
     void recordContinueStream();
     void recordInvokeCallback();
     void recordInvokeRawCallback(float* pcm, size_t samples);
     void internalStopRecording();
+    void applyNetworkConditions();
+    Result<> encodeFrame(const float* pcm);
 
     AudioEncoder encoder;
 
+    /* loopback */
+    asp::AtomicBool loopbackEnabled = false;
+    // the sound and channel are only touched by the audio thread, see `updateLoopback`
+    FMOD::Sound* loopbackSound = nullptr;
+    FMOD::Channel* loopbackChannel = nullptr;
+    size_t loopbackRate = 0;
+    float loopbackFixedLatency = 0.f; // capture polling, decode block and mixer buffers
+    // written by the audio thread at the device rate, read by the FMOD mixer
+    AudioSampleQueue loopbackQueue;
+    asp::AtomicF32 loopbackLatency = 0.f;
+
+    void updateLoopback();
+    Result<> startLoopback();
+    void stopLoopback();
+    size_t loopbackRead(float* out, size_t samples);
+
     /* misc */
     FMOD::System* cachedSystem = nullptr;
 
     void audioThreadFunc();
     Result<> audioThreadWork();
+    Result<> recordReadData(unsigned int pos);
+    void recordWriteSamples(const float* pcm, size_t samples);
 
     asp::AtomicBool audioThreadSleeping = true;
+    // pushed to whenever the recording state changes, so the audio thread doesn't have to poll for it
+    asp::Channel<bool> audioThreadWakeup;
     asp::Thread<GlobedAudioManager*> audioThreadHandle;
 };
 
@@ -0,0 +1,138 @@
+#include "mixer.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include "manager.hpp"
+#include <util/profiler.hpp>
+#include <util/simd.hpp>
+
+AudioMixer::AudioMixer() {
+    FMOD_CREATESOUNDEXINFO exinfo = {};
+
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.numchannels = OUTPUT_CHANNELS;
+    exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+    exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
+    exinfo.userdata = this;
+    exinfo.length = sizeof(float) * exinfo.numchannels * exinfo.defaultfrequency * VOICE_CHUNK_RECORD_TIME;
+
+    exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data, unsigned int len) -> FMOD_RESULT {
+        FMOD::Sound* sound = reinterpret_cast<FMOD::Sound*>(sound_);
+        AudioMixer* mixer = nullptr;
+        sound->getUserData((void**)&mixer);
+
+        if (!mixer || !data) {
+            return FMOD_OK;
+        }
+
+        // runs on the FMOD mixer thread
+        GLOBED_PROFILE_THREAD("FMOD Mixer");
+        GLOBED_PROFILE_ZONE("audio: mix callback");
+        mixer->mix(reinterpret_cast<float*>(data), len / sizeof(float));
+
+        return FMOD_OK;
+    };
+
+    auto system = GlobedAudioManager::get().getSystem();
+    FMOD_RESULT res = system->createStream(nullptr, FMOD_OPENUSER | FMOD_2D | FMOD_LOOP_NORMAL, &exinfo, &sound);
+
+    GLOBED_REQUIRE(res == FMOD_OK, GlobedAudioManager::formatFmodError(res, "System::createStream"))
+}
+
+AudioMixer::~AudioMixer() {
+    if (sound) {
+        sound->setUserData(nullptr);
+    }
+
+    if (channel) {
+        channel->stop();
+    }
+
+    if (sound) {
+        sound->release();
+    }
+}
+
+void AudioMixer::start() {
+    if (this->channel) {
+        return;
+    }
+
+    this->channel = GlobedAudioManager::get().playSound(sound);
+}
+
+bool AudioMixer::addSource(AudioStream* stream) {
+    for (size_t i = 0; i < MAX_SOURCES; i++) {
+        AudioStream* expected = nullptr;
+        if (sources[i].compare_exchange_strong(expected, stream)) {
+            if (sourceEnd.load() <= i) {
+                sourceEnd.store(i + 1);
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AudioMixer::removeSource(AudioStream* stream) {
+    size_t end = sourceEnd.load();
+
+    for (size_t i = 0; i < end; i++) {
+        AudioStream* expected = stream;
+        if (sources[i].compare_exchange_strong(expected, nullptr)) {
+            return;
+        }
+    }
+}
+
+size_t AudioMixer::retireToken() {
+    return sequence.load();
+}
+
+bool AudioMixer::canFree(size_t token) {
+    // if the callback wasn't running when the sources were removed, it can't have seen them,
+    // otherwise wait until that run is over
+    return token % 2 == 0 || sequence.load() != token;
+}
+
+void AudioMixer::mix(float* out, size_t samples) {
+    sequence.fetch_add(1);
+
+    size_t frames = samples / OUTPUT_CHANNELS;
+    size_t end = sourceEnd.load();
+
+    for (size_t offset = 0; offset < frames; offset += SCRATCH_SIZE) {
+        size_t chunk = std::min(SCRATCH_SIZE, frames - offset);
+
+        std::fill(left, left + chunk, 0.f);
+        std::fill(right, right + chunk, 0.f);
+
+        for (size_t i = 0; i < end; i++) {
+            AudioStream* stream = sources[i].load();
+            if (!stream) continue;
+
+            // always read, so that muted streams don't pile up audio
+            size_t read = stream->readSamples(scratch, chunk);
+
+            float gain = stream->getVolume();
+            if (read == 0 || gain <= 0.f) continue;
+
+            // balance law rather than equal power, so a centered speaker is as loud as on its own sound
+            float pan = stream->getPan();
+            util::simd::mixAdd(left, scratch, gain * std::min(1.f, 1.f - pan), read);
+            util::simd::mixAdd(right, scratch, gain * std::min(1.f, 1.f + pan), read);
+        }
+
+        float* dest = out + offset * OUTPUT_CHANNELS;
+        for (size_t i = 0; i < chunk; i++) {
+            dest[i * 2] = left[i];
+            dest[i * 2 + 1] = right[i];
+        }
+    }
+
+    sequence.fetch_add(1);
+}
+
+#endif // GLOBED_VOICE_SUPPORT
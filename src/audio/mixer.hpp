@@ -0,0 +1,55 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <fmod.hpp>
+
+#include "stream.hpp"
+
+// Plays many `AudioStream`s (created with `mixed = true`) through a single stereo FMOD stream,
+// summing their samples with each stream's volume and pan applied. Streams with no queued audio are skipped.
+// Sources are added and removed from the main thread, the mixing happens in FMOD's callback without any locks.
+class AudioMixer {
+public:
+    static constexpr size_t MAX_SOURCES = 128;
+
+    AudioMixer();
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    void start();
+
+    // Returns false if there are already `MAX_SOURCES` sources
+    bool addSource(AudioStream* stream);
+    // The callback might still be reading from the stream after this returns, see `canFree`
+    void removeSource(AudioStream* stream);
+
+    // Returns a token to pass to `canFree` later, call right after removing sources
+    size_t retireToken();
+    // Whether sources removed before `retireToken()` returned `token` are no longer used by the callback
+    bool canFree(size_t token);
+
+private:
+    static constexpr size_t SCRATCH_SIZE = VOICE_TARGET_FRAMESIZE;
+    static constexpr size_t OUTPUT_CHANNELS = 2;
+
+    FMOD::Sound* sound = nullptr;
+    FMOD::Channel* channel = nullptr;
+
+    std::array<std::atomic<AudioStream*>, MAX_SOURCES> sources = {};
+    // one past the highest slot that was ever used, so the callback doesn't walk through all of them
+    std::atomic<size_t> sourceEnd = 0;
+    // incremented when the callback starts and when it ends, so it is odd while mixing
+    std::atomic<size_t> sequence = 0;
+    // only touched by the callback
+    float scratch[SCRATCH_SIZE];
+    float left[SCRATCH_SIZE];
+    float right[SCRATCH_SIZE];
+
+    void mix(float* out, size_t samples);
+};
+
+#endif // GLOBED_VOICE_SUPPORT
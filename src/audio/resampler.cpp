@@ -0,0 +1,112 @@
+#include "resampler.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <util/simd.hpp>
+
+AudioResampler::AudioResampler(size_t inputRate, size_t outputRate) : inputRate(inputRate), outputRate(outputRate) {
+    if (inputRate == 0 || outputRate == 0 || inputRate == outputRate) {
+        return;
+    }
+
+    size_t divisor = std::gcd(inputRate, outputRate);
+    up = outputRate / divisor;
+    down = inputRate / divisor;
+
+    // prototype filter runs at `inputRate * up`, and has to cut off below the nyquist frequency of the lower of the two rates.
+    // a bit below it in fact, so the transition band doesn't alias back in
+    size_t length = up * TAPS;
+    double cutoff = 0.45 / static_cast<double>(std::max(up, down));
+    double center = static_cast<double>(length - 1) / 2.0;
+
+    constexpr double PI = 3.14159265358979323846;
+
+    std::vector<double> prototype(length);
+    for (size_t k = 0; k < length; k++) {
+        double x = static_cast<double>(k) - center;
+        double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * PI * cutoff * x) / (2.0 * PI * cutoff * x);
+
+        // blackman window
+        double w = static_cast<double>(k) / static_cast<double>(length - 1);
+        double window = 0.42 - 0.5 * std::cos(2.0 * PI * w) + 0.08 * std::cos(4.0 * PI * w);
+
+        // the gain of `up` makes up for the zeros that upsampling would insert
+        prototype[k] = 2.0 * cutoff * sinc * window * static_cast<double>(up);
+    }
+
+    bank.resize(length);
+    for (size_t p = 0; p < up; p++) {
+        for (size_t j = 0; j < TAPS; j++) {
+            bank[p * TAPS + (TAPS - 1 - j)] = static_cast<float>(prototype[j * up + p]);
+        }
+    }
+
+    this->reset();
+}
+
+size_t AudioResampler::process(const float* input, size_t length, float* output) {
+    if (!this->isActive()) {
+        std::copy(input, input + length, output);
+        return length;
+    }
+
+    history.insert(history.end(), input, input + length);
+
+    size_t written = 0;
+    while (index < history.size()) {
+        output[written++] = util::simd::dot(bank.data() + phase * TAPS, history.data() + index - (TAPS - 1), TAPS);
+
+        phase += down;
+        index += phase / up;
+        phase %= up;
+    }
+
+    // keep just enough of the old input for the next call
+    size_t consumed = std::min(index, history.size()) - (TAPS - 1);
+    history.erase(history.begin(), history.begin() + consumed);
+    index -= consumed;
+
+    return written;
+}
+
+size_t AudioResampler::maxOutput(size_t length) const {
+    if (!this->isActive()) {
+        return length;
+    }
+
+    // samples left over from the previous call can add one more
+    return (length * up) / down + 2;
+}
+
+void AudioResampler::reset() {
+    history.assign(TAPS - 1, 0.f);
+    index = TAPS - 1;
+    phase = 0;
+}
+
+bool AudioResampler::isActive() const {
+    return !bank.empty();
+}
+
+double AudioResampler::getLatency() const {
+    if (!this->isActive()) {
+        return 0.0;
+    }
+
+    // linear phase filter, the delay is half of its length
+    return static_cast<double>(TAPS * up - 1) / 2.0 / static_cast<double>(inputRate * up);
+}
+
+size_t AudioResampler::getInputRate() const {
+    return inputRate;
+}
+
+size_t AudioResampler::getOutputRate() const {
+    return outputRate;
+}
+
+#endif // GLOBED_VOICE_SUPPORT
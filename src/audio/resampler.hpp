@@ -0,0 +1,52 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <cstddef>
+#include <vector>
+
+// Streaming polyphase resampler for mono audio, converting between any two integer sample rates (i.e. 48khz or 44.1khz to 24khz).
+// The rates are reduced to an upsampling factor L and a downsampling factor M, and every output sample is a dot product
+// of the recent input with one of L phases of a windowed sinc lowpass, so the cost per output sample is a fixed amount of taps.
+// When both rates are equal, samples are copied unchanged. Not thread safe, only used from the audio thread.
+class AudioResampler {
+public:
+    // taps per phase, more taps make for a sharper cutoff at the cost of latency and cpu time
+    static constexpr size_t TAPS = 32;
+
+    AudioResampler(size_t inputRate = 0, size_t outputRate = 0);
+
+    // Resamples `length` samples from `input` into `output`, returns the amount of samples written.
+    // `output` must have room for at least `maxOutput(length)` samples.
+    size_t process(const float* input, size_t length, float* output);
+
+    // upper bound for the amount of samples `process` produces from `length` input samples
+    size_t maxOutput(size_t length) const;
+
+    // drops the filter history, to be called when the input stream restarts
+    void reset();
+
+    // whether any conversion happens at all
+    bool isActive() const;
+
+    // delay added by the filter, in seconds
+    double getLatency() const;
+
+    size_t getInputRate() const;
+    size_t getOutputRate() const;
+
+private:
+    size_t inputRate, outputRate;
+    size_t up = 1, down = 1;
+
+    // `up` phases of `TAPS` coefficients each, stored reversed so they line up with the input in memory
+    std::vector<float> bank;
+
+    // the last `TAPS - 1` input samples followed by the ones that haven't been fully used yet
+    std::vector<float> history;
+    size_t index = 0;
+    size_t phase = 0;
+};
+
+#endif // GLOBED_VOICE_SUPPORT
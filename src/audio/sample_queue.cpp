@@ -2,39 +2,84 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-void AudioSampleQueue::writeData(const DecodedOpusData& data) {
-    this->writeData(data.ptr, data.length);
+#include <bit>
+
+AudioSampleQueue::AudioSampleQueue(size_t capacity) {
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+
+    buf.resize(capacity);
+    mask = capacity - 1;
 }
 
-void AudioSampleQueue::writeData(const float* pcm, size_t length) {
-    buf.insert(buf.end(), pcm, pcm + length);
+AudioSampleQueue::AudioSampleQueue(AudioSampleQueue&& other) noexcept {
+    *this = std::move(other);
 }
 
-size_t AudioSampleQueue::copyTo(float* dest, size_t samples) {
-    if (buf.size() < samples) {
-        size_t total = buf.size();
+AudioSampleQueue& AudioSampleQueue::operator=(AudioSampleQueue&& other) noexcept {
+    if (this != &other) {
+        buf = std::move(other.buf);
+        other.buf.clear();
+        mask = other.mask;
+        head.store(other.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        tail.store(other.tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
 
-        std::copy(buf.data(), buf.data() + total, dest);
-        buf.clear();
-        return total;
+        other.mask = 0;
+        other.head.store(0, std::memory_order_relaxed);
+        other.tail.store(0, std::memory_order_relaxed);
     }
 
-    std::copy(buf.data(), buf.data() + samples, dest);
-    buf.erase(buf.begin(), buf.begin() + samples);
+    return *this;
+}
+
+size_t AudioSampleQueue::writeData(const float* pcm, size_t length) {
+    if (buf.empty()) return 0;
 
-    return samples;
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+
+    size_t count = std::min(length, this->capacity() - (t - h));
+    size_t start = t & mask;
+
+    // the free space can wrap around the end of the buffer
+    size_t first = std::min(count, this->capacity() - start);
+    std::copy(pcm, pcm + first, buf.data() + start);
+    std::copy(pcm + first, pcm + count, buf.data());
+
+    tail.store(t + count, std::memory_order_release);
+
+    return count;
 }
 
-size_t AudioSampleQueue::size() const {
-    return buf.size();
+size_t AudioSampleQueue::copyTo(float* dest, size_t samples) {
+    if (buf.empty()) return 0;
+
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_acquire);
+
+    size_t count = std::min(samples, t - h);
+    size_t start = h & mask;
+
+    size_t first = std::min(count, this->capacity() - start);
+    std::copy(buf.data() + start, buf.data() + start + first, dest);
+    std::copy(buf.data(), buf.data() + (count - first), dest + first);
+
+    head.store(h + count, std::memory_order_release);
+
+    return count;
 }
 
 void AudioSampleQueue::clear() {
-    buf.clear();
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+size_t AudioSampleQueue::size() const {
+    // head first, it can never get past the tail
+    size_t h = head.load(std::memory_order_acquire);
+    return tail.load(std::memory_order_acquire) - h;
 }
 
-float* AudioSampleQueue::data() {
-    return buf.data();
+size_t AudioSampleQueue::capacity() const {
+    return buf.empty() ? 0 : mask + 1;
 }
 
-#endif // GLOBED_VOICE_SUPPORT
\ No newline at end of file
+#endif // GLOBED_VOICE_SUPPORT
@@ -3,28 +3,49 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-#include "decoder.hpp"
+#include <atomic>
 
+#include <util/memory.hpp>
+
+
+// Fixed capacity ring buffer of samples, for exactly one producer thread (`writeData`) and one consumer thread (`copyTo`).
+// Neither side ever locks or allocates, so it is safe to use from FMOD callbacks.
+// The buffer is allocated once in the constructor, and the capacity is rounded up to a power of two. It counts towards `MemoryTag::AudioQueues`.
 class AudioSampleQueue {
 public:
-    AudioSampleQueue() {};
-    // enable copying
-    AudioSampleQueue(const AudioSampleQueue&) = default;
-    AudioSampleQueue& operator=(const AudioSampleQueue&) = default;
-    // enable moving
-    AudioSampleQueue(AudioSampleQueue&&) = default;
-    AudioSampleQueue& operator=(AudioSampleQueue&&) = default;
-
-    void writeData(const DecodedOpusData& data);
-    void writeData(const float* pcm, size_t length);
-    // contrary to the name, this will erase the samples from this queue after copying them to `dest`
+    // 2.7 seconds of audio at 24khz
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    AudioSampleQueue(size_t capacity = DEFAULT_CAPACITY);
+
+    AudioSampleQueue(const AudioSampleQueue&) = delete;
+    AudioSampleQueue& operator=(const AudioSampleQueue&) = delete;
+    // moving is not thread safe, neither of the queues must be in use at the time
+    AudioSampleQueue(AudioSampleQueue&&) noexcept;
+    AudioSampleQueue& operator=(AudioSampleQueue&&) noexcept;
+
+    // Producer side. If there isn't enough space, the samples that don't fit are dropped. Returns the amount of samples written.
+    size_t writeData(const float* pcm, size_t length);
+
+    // Consumer side. Copies up to `samples` samples to `dest` and removes them from the queue, returns the amount copied.
     size_t copyTo(float* dest, size_t samples);
-    size_t size() const;
+    // Consumer side, drops all the samples currently in the queue
     void clear();
-    float* data();
+
+    // Approximate when called while the other thread is active
+    size_t size() const;
+    size_t capacity() const;
 
 private:
-    std::vector<float> buf;
+    static constexpr size_t CACHE_LINE = 64;
+
+    util::memory::TrackedVector<float, util::memory::MemoryTag::AudioQueues> buf;
+    size_t mask = 0;
+
+    // consumer side
+    alignas(CACHE_LINE) std::atomic<size_t> head = 0;
+    // producer side
+    alignas(CACHE_LINE) std::atomic<size_t> tail = 0;
 };
 
 #endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,45 @@
+#include "spatializer.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <algorithm>
+
+#include <util/simd.hpp>
+
+void VoiceSpatializer::clear() {
+    streams.clear();
+    dx.clear();
+    dy.clear();
+    fullVolume.clear();
+}
+
+void VoiceSpatializer::push(AudioStream* stream, float dx, float dy, bool fullVolume) {
+    streams.push_back(stream);
+    this->dx.push_back(dx);
+    this->dy.push_back(dy);
+    this->fullVolume.push_back(fullVolume);
+}
+
+void VoiceSpatializer::apply(float range, float volume, bool panning) {
+    size_t count = streams.size();
+    distance.resize(count);
+
+    util::simd::distance(dx.data(), dy.data(), distance.data(), count);
+
+    for (size_t i = 0; i < count; i++) {
+        float gain = 1.f - std::clamp(distance[i], 0.01f, range) / range;
+        float pan = panning ? std::clamp(dx[i] / range, -1.f, 1.f) * MAX_PAN : 0.f;
+
+        if (fullVolume[i]) {
+            gain = 1.f;
+            pan = 0.f;
+        }
+
+        streams[i]->setVolume(gain * volume);
+        streams[i]->setPan(pan);
+    }
+
+    this->clear();
+}
+
+#endif // GLOBED_VOICE_SUPPORT
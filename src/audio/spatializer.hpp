@@ -0,0 +1,33 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <vector>
+
+#include "stream.hpp"
+
+// Computes the proximity volume and stereo pan of all speakers at once. Speakers are queued with `push`
+// every frame, then `apply` works through them in flat arrays, so the distances are calculated with SIMD.
+// Streams are only touched (and only call into FMOD) when their volume or pan actually changes.
+class VoiceSpatializer {
+public:
+    // how far to the side a speaker can be panned, full panning is uncomfortable with headphones
+    static constexpr float MAX_PAN = 0.6f;
+
+    void clear();
+
+    // queue a speaker at offset (`dx`, `dy`) from the listener. `fullVolume` ignores the distance (i.e. players in the editor)
+    void push(AudioStream* stream, float dx, float dy, bool fullVolume);
+
+    // sets the volume of every queued speaker to `volume` scaled down by its distance, reaching zero at `range`.
+    // if `panning` is enabled, speakers are also panned towards their side of the screen. Clears the queue afterwards.
+    void apply(float range, float volume, bool panning);
+
+private:
+    std::vector<AudioStream*> streams;
+    std::vector<float> dx, dy, distance;
+    std::vector<bool> fullVolume;
+};
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -2,12 +2,19 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
+#include <algorithm>
+#include <cmath>
+
 #include "manager.hpp"
 #include <util/misc.hpp>
+#include <util/profiler.hpp>
 
-AudioStream::AudioStream(AudioDecoder&& decoder)
+AudioStream::AudioStream(AudioDecoder&& decoder, bool mixed)
     : decoder(std::move(decoder)),
-      estimator(std::move(VolumeEstimator(VOICE_TARGET_SAMPLERATE))) {
+      estimator(VOICE_TARGET_SAMPLERATE),
+      mixed(mixed) {
+    if (mixed) return;
+
     FMOD_CREATESOUNDEXINFO exinfo = {};
 
     exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
@@ -27,21 +34,17 @@ AudioStream::AudioStream(AudioDecoder&& decoder)
             return FMOD_OK;
         }
 
+        GLOBED_PROFILE_THREAD("FMOD Mixer");
+        GLOBED_PROFILE_ZONE("audio: stream callback");
+
         // write data..
 
         size_t neededSamples = len / sizeof(float);
-        size_t copied = stream->queue.lock()->copyTo(reinterpret_cast<float*>(data), neededSamples);
-        stream->estimator.lock()->feedData(reinterpret_cast<const float*>(data), copied);
-
-        if (copied != neededSamples) {
-            stream->starving = true;
-            // fill the rest with the void to not repeat stuff
-            for (size_t i = copied; i < neededSamples; i++) {
-                ((float*)data)[i] = 0.0f;
-            }
-        } else {
-            stream->starving = false;
-            stream->lastPlaybackTime = util::time::now();
+        size_t copied = stream->readSamples(reinterpret_cast<float*>(data), neededSamples);
+
+        // fill the rest with the void to not repeat stuff
+        for (size_t i = copied; i < neededSamples; i++) {
+            ((float*)data)[i] = 0.0f;
         }
 
         return FMOD_OK;
@@ -77,9 +80,10 @@ AudioStream::AudioStream(AudioStream&& other) noexcept {
     other.sound = nullptr;
     other.channel = nullptr;
 
-    *queue.lock() = std::move(*other.queue.lock());
+    queue = std::move(other.queue);
     decoder = std::move(other.decoder);
-    *estimator.lock() = std::move(*other.estimator.lock());
+    estimator = std::move(other.estimator);
+    mixed = other.mixed;
 }
 
 AudioStream& AudioStream::operator=(AudioStream&& other) noexcept {
@@ -98,41 +102,104 @@ AudioStream& AudioStream::operator=(AudioStream&& other) noexcept {
         other.sound = nullptr;
         other.channel = nullptr;
 
-        *queue.lock() = std::move(*other.queue.lock());
+        queue = std::move(other.queue);
         decoder = std::move(other.decoder);
-        *estimator.lock() = std::move(*other.estimator.lock());
+        estimator = std::move(other.estimator);
+        mixed = other.mixed;
     }
 
     return *this;
 }
 
 void AudioStream::start() {
-    if (this->channel) {
+    if (this->channel || mixed) {
         return;
     }
 
     this->channel = GlobedAudioManager::get().playSound(sound);
+
+    // the setters skip FMOD if nothing changed, so apply whatever was set before the channel existed
+    if (this->channel) {
+        this->channel->setVolume(volume);
+        this->channel->setPan(pan);
+    }
 }
 
-Result<> AudioStream::writeData(const EncodedAudioFrame& frame) {
-    const auto& frames = frame.getFrames();
-    for (const auto& opusFrame : frames) {
-        auto decodedFrame_ = decoder.decode(opusFrame);
-        GLOBED_UNWRAP_INTO(decodedFrame_, auto decodedFrame);
+Result<> AudioStream::writeData(const EncodedAudioFrame& frame, util::time::time_point arrival) {
+    if (frame.size() == 0) return Ok();
+
+    this->trackArrival(arrival, frame.size() * decoder.getDecodedSize());
+
+    if (auto sequence = frame.getSequence()) {
+        // signed so that late packets come up negative
+        int32_t lost = nextSequence ? static_cast<int32_t>(*sequence - *nextSequence) : 0;
+
+        // arrived after we already concealed it, playing it now would only make things worse
+        if (lost < 0 && -lost < static_cast<int32_t>(VOICE_MAX_CONCEALED_FRAMES * EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME)) {
+            return Ok();
+        }
+
+        if (lost > 0 && lost <= static_cast<int32_t>(VOICE_MAX_CONCEALED_FRAMES)) {
+            // extrapolate all but the last lost frame, that one can be recovered from the fec data in the first frame we did get
+            auto first = frame.getFrame(0);
 
-        queue.lock()->writeData(decodedFrame);
+            for (int32_t i = 0; i < lost; i++) {
+                bool canRecover = i == lost - 1;
 
-        AudioDecoder::freeData(decodedFrame);
+                GLOBED_UNWRAP_INTO(decoder.decodeLost(canRecover ? &first : nullptr, decodeBuffer.data(), decodeBuffer.size()), size_t samples);
+                queue.writeData(decodeBuffer.data(), samples);
+            }
+        }
+
+        nextSequence = *sequence + frame.size();
     }
 
+    for (size_t i = 0; i < frame.size(); i++) {
+        GLOBED_UNWRAP_INTO(decoder.decode(frame.getFrame(i), decodeBuffer.data(), decodeBuffer.size()), size_t samples);
+
+        queue.writeData(decodeBuffer.data(), samples);
+    }
+
+    this->schedulePlayout(arrival, playoutDelay);
+
     return Ok();
 }
 
 void AudioStream::writeData(const float* pcm, size_t samples) {
-    queue.lock()->writeData(pcm, samples);
+    queue.writeData(pcm, samples);
+
+    // raw data is local, no need to buffer it
+    this->schedulePlayout(util::time::now(), 0.f);
+}
+
+void AudioStream::trackArrival(util::time::time_point arrival, size_t samples) {
+    if (lastArrival) {
+        float interval = std::chrono::duration<float>(arrival - *lastArrival).count();
+
+        // gaps this long are pauses in speech, not jitter
+        if (interval < lastPacketLength + VOICE_MAX_PLAYOUT_DELAY) {
+            float deviation = std::abs(interval - lastPacketLength);
+            jitter += (deviation - jitter) / 16.f;
+
+            playoutDelay = std::clamp(jitter * 3.f, VOICE_MIN_PLAYOUT_DELAY, VOICE_MAX_PLAYOUT_DELAY);
+        }
+    }
+
+    lastArrival = arrival;
+    lastPacketLength = static_cast<float>(samples) / VOICE_TARGET_SAMPLERATE;
+}
+
+void AudioStream::schedulePlayout(util::time::time_point arrival, float delay) {
+    if (!awaitingPlayout.load()) return;
+
+    // the start time must be visible before the flag is cleared
+    playoutStart = arrival + std::chrono::duration_cast<util::time::clock::duration>(std::chrono::duration<float>(delay));
+    awaitingPlayout = false;
 }
 
 void AudioStream::setVolume(float volume) {
+    if (volume == this->volume) return;
+
     if (channel) {
         channel->setVolume(volume);
     }
@@ -144,16 +211,67 @@ float AudioStream::getVolume() {
     return volume;
 }
 
+void AudioStream::setPan(float pan) {
+    if (pan == this->pan) return;
+
+    if (channel) {
+        channel->setPan(pan);
+    }
+
+    this->pan = pan;
+}
+
+float AudioStream::getPan() {
+    return pan;
+}
+
+float AudioStream::getPlayoutDelay() {
+    return playoutDelay;
+}
+
 void AudioStream::updateEstimator(float dt) {
-    estimator.lock()->update(dt);
+    estimator.update(dt);
 }
 
 float AudioStream::getLoudness() {
-    return estimator.lock()->getVolume() * this->volume;
+    return estimator.getVolume() * this->volume;
 }
 
 util::time::time_point AudioStream::getLastPlaybackTime() {
-    return lastPlaybackTime;
+    return lastPlaybackTime.load();
+}
+
+size_t AudioStream::readSamples(float* dest, size_t samples) {
+    // still filling up the jitter buffer
+    if (awaitingPlayout.load() || util::time::now() < playoutStart.load()) {
+        starving = true;
+        return 0;
+    }
+
+    size_t copied = queue.copyTo(dest, samples);
+    estimator.feedData(dest, copied);
+
+    if (copied != samples) {
+        if (!starving.load()) {
+            underruns.fetch_add(1);
+        }
+
+        starving = true;
+
+        // ran dry, wait for the buffer to fill up again
+        if (queue.size() == 0) {
+            awaitingPlayout = true;
+        }
+    } else {
+        starving = false;
+        lastPlaybackTime = util::time::now();
+    }
+
+    return copied;
+}
+
+bool AudioStream::isMixed() {
+    return mixed;
 }
 
 #endif // GLOBED_VOICE_SUPPORT
@@ -7,13 +7,15 @@
 #include "sample_queue.hpp"
 #include "decoder.hpp"
 #include "volume_estimator.hpp"
+#include "manager.hpp"
 
 #include <asp/sync.hpp>
 #include <util/time.hpp>
 
 class AudioStream {
 public:
-    AudioStream(AudioDecoder&& decoder);
+    // if `mixed` is true, no FMOD sound is created and the samples are instead pulled by `AudioMixer`
+    AudioStream(AudioDecoder&& decoder, bool mixed = false);
     ~AudioStream();
 
     // prevent copying since we manually free the sound
@@ -26,32 +28,69 @@ public:
 
     // start playing this stream
     void start();
-    // write an audio frame to this stream. returns error if opus decoding failed
-    Result<> writeData(const EncodedAudioFrame& frame);
+    // write an audio frame to this stream. returns error if opus decoding failed.
+    // must only be called from one thread at a time, normally the decode thread of `VoicePlaybackManager`.
+    // `arrival` is when the packet was received, used by the jitter buffer.
+    Result<> writeData(const EncodedAudioFrame& frame, util::time::time_point arrival);
     // write raw audio data to this stream
     void writeData(const float* pcm, size_t samples);
 
-    // set the volume of the stream (0.0f - 1.0f, beyond 1.0f amplifies)
+    // set the volume of the stream (0.0f - 1.0f, beyond 1.0f amplifies). FMOD is only called if the volume changed.
     void setVolume(float volume);
 
     float getVolume();
 
+    // set the stereo pan of the stream, from -1.0f (left) to 1.0f (right). FMOD is only called if the pan changed.
+    void setPan(float pan);
+
+    float getPan();
+
+    // how long the stream currently waits before it starts playing after an underrun, adapts to the jitter of incoming packets
+    float getPlayoutDelay();
+
     void updateEstimator(float dt);
     // get how loud the sound is being played
     float getLoudness();
 
     util::time::time_point getLastPlaybackTime();
 
+    // Reads up to `samples` samples to play into `dest`, returns the amount read. Called from the FMOD mixer thread, never blocks.
+    size_t readSamples(float* dest, size_t samples);
+
+    bool isMixed();
+
     asp::AtomicBool starving = false; // true if there aren't enough samples in the queue
+    asp::AtomicU32 underruns = 0; // how many times the queue ran dry while the voice was playing
 
 private:
     FMOD::Sound* sound = nullptr;
     FMOD::Channel* channel = nullptr;
-    asp::Mutex<AudioSampleQueue> queue;
+    // written on the main thread, read by FMOD in `pcmreadcallback`, which must never block
+    AudioSampleQueue queue;
     AudioDecoder decoder;
-    asp::Mutex<VolumeEstimator> estimator;
-    float volume = 0.f;
-    util::time::time_point lastPlaybackTime;
+    // decoded opus frames go here before being written to the queue
+    std::array<float, VOICE_TARGET_FRAMESIZE * VOICE_CHANNELS> decodeBuffer;
+    // sequence of the opus frame we expect next, for detecting lost packets
+    std::optional<uint32_t> nextSequence;
+
+    // Jitter buffer. After running dry, the stream waits `playoutDelay` past the arrival of the next packet
+    // before playing again. The delay follows the mean deviation of packet arrival times (like RFC 3550 jitter),
+    // so it stays minimal on a stable connection and grows when packets arrive unevenly.
+    std::atomic<bool> awaitingPlayout = true;
+    std::atomic<util::time::time_point> playoutStart;
+    std::atomic<float> playoutDelay = VOICE_MIN_PLAYOUT_DELAY;
+    // only touched by the producer
+    std::optional<util::time::time_point> lastArrival;
+    float lastPacketLength = 0.f;
+    float jitter = 0.f;
+
+    void trackArrival(util::time::time_point arrival, size_t samples);
+    void schedulePlayout(util::time::time_point arrival, float delay);
+    VolumeEstimator estimator;
+    std::atomic<float> volume = 0.f;
+    std::atomic<float> pan = 0.f;
+    std::atomic<util::time::time_point> lastPlaybackTime;
+    bool mixed = false;
 };
 
 #else
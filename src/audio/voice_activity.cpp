@@ -0,0 +1,48 @@
+#include "voice_activity.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <algorithm>
+
+#include <util/misc.hpp>
+
+bool VoiceActivityDetector::process(const float* pcm, size_t samples) {
+    float volume = util::misc::calculatePcmVolume(pcm, samples);
+
+    // the noise floor drops instantly and rises slowly, so it follows the quietest parts of the signal
+    if (volume < noiseFloor) {
+        noiseFloor = std::max(volume, MIN_VOLUME / NOISE_RATIO);
+    } else {
+        noiseFloor += (volume - noiseFloor) * 0.01f;
+    }
+
+    bool speech = volume >= MIN_VOLUME && volume >= noiseFloor * NOISE_RATIO;
+
+    bool wasActive = active;
+
+    if (speech) {
+        hangover = HANGOVER_FRAMES;
+        active = true;
+    } else if (hangover > 0) {
+        hangover--;
+    } else {
+        active = false;
+    }
+
+    ended = wasActive && !active;
+
+    return active;
+}
+
+bool VoiceActivityDetector::justEnded() const {
+    return ended;
+}
+
+void VoiceActivityDetector::reset() {
+    noiseFloor = MIN_VOLUME;
+    hangover = 0;
+    active = false;
+    ended = false;
+}
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,36 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <cstddef>
+
+// Decides whether a recorded opus frame contains speech and is worth encoding and sending.
+// A frame counts as speech if it is louder than both a fixed minimum and the tracked background noise level.
+// After speech stops, frames keep being sent for a short hangover period so quiet word endings aren't clipped.
+// Not thread safe, only used from the audio thread.
+class VoiceActivityDetector {
+public:
+    // minimum (mean absolute) volume of a frame to be considered speech
+    static constexpr float MIN_VOLUME = 0.004f;
+    // how much louder than the background noise speech has to be
+    static constexpr float NOISE_RATIO = 2.5f;
+    // how many frames are still sent after the last frame with speech (5 * 60ms)
+    static constexpr size_t HANGOVER_FRAMES = 5;
+
+    // returns whether the frame should be sent
+    bool process(const float* pcm, size_t samples);
+
+    // whether the last processed frame is the first silent frame after speech, in which case any pending frames should be flushed
+    bool justEnded() const;
+
+    void reset();
+
+private:
+    float noiseFloor = MIN_VOLUME;
+    size_t hangover = 0;
+    bool active = false;
+    bool ended = false;
+};
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -1,17 +1,53 @@
 #include "voice_playback_manager.hpp"
 
 #include "manager.hpp"
+#include <managers/error_queues.hpp>
+#include <managers/settings.hpp>
+#include <util/profiler.hpp>
+#include <util/thread.hpp>
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-Result<> VoicePlaybackManager::playFrameStreamed(int playerId, const EncodedAudioFrame& frame) {
+VoicePlaybackManager::VoicePlaybackManager() {
+    decodeThread.setLoopFunction(&VoicePlaybackManager::decodeThreadFunc);
+    decodeThread.setStartFunction([] {
+        geode::utils::thread::setName("Voice Decoder");
+        GLOBED_PROFILE_THREAD("Voice Decoder");
+        util::thread::configureCurrent(util::thread::Priority::High);
+    });
+    decodeThread.start(this);
+}
+
+VoicePlaybackManager::~VoicePlaybackManager() {
+    decodeThread.stopAndWait();
+}
+
+void VoicePlaybackManager::playFrameStreamed(int playerId, EncodedAudioFrame&& frame) {
     // if the stream doesn't exist yet, create it
     if (!streams.contains(playerId)) {
         this->prepareStream(playerId);
     }
 
-    auto& stream = streams.at(playerId);
-    return stream->writeData(frame);
+    if (maxSpeakers != 0 && !this->isSpeaking(playerId) && this->speakingCount() >= maxSpeakers) {
+        return;
+    }
+
+    decodeQueue.push(DecodeTask {
+        .stream = streams.at(playerId),
+        .frame = std::move(frame),
+        .arrival = util::time::now(),
+    });
+}
+
+void VoicePlaybackManager::decodeThreadFunc() {
+    auto task = decodeQueue.popTimeout(util::time::millis(50));
+    if (!task) return;
+
+    GLOBED_PROFILE_ZONE("audio: decode frame");
+    auto result = task->stream->writeData(task->frame, task->arrival);
+    if (!result) {
+        ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + result.unwrapErr());
+    }
 }
 
 void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, size_t samples) {
@@ -24,21 +60,65 @@ void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, s
 }
 
 void VoicePlaybackManager::stopAllStreams() {
+    for (auto& [_, stream] : streams) {
+        this->retireStream(std::move(stream));
+    }
+
     streams.clear();
+    publishedSpeakers.clear();
+    events.clear();
 }
 
 void VoicePlaybackManager::prepareStream(int playerId) {
     if (streams.contains(playerId)) return;
 
+    this->freeRetiredStreams();
+
     AudioDecoder decoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS);
 
-    auto stream = std::make_unique<AudioStream>(std::move(decoder));
+    bool mixed = GlobedSettings::get().communication.voiceMixer;
+    if (mixed && !mixer) {
+        mixer = std::make_unique<AudioMixer>();
+        mixer->start();
+    }
+
+    auto stream = std::make_shared<AudioStream>(std::move(decoder), mixed);
+
+    // fall back to a separate sound if the mixer is full
+    if (mixed && !mixer->addSource(stream.get())) {
+        AudioDecoder decoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS);
+        stream = std::make_shared<AudioStream>(std::move(decoder));
+    }
+
     stream->start();
     streams.emplace(playerId, std::move(stream));
 }
 
 void VoicePlaybackManager::removeStream(int playerId) {
-    streams.erase(playerId);
+    auto it = streams.find(playerId);
+    if (it == streams.end()) return;
+
+    this->retireStream(std::move(it->second));
+    streams.erase(it);
+}
+
+void VoicePlaybackManager::retireStream(std::shared_ptr<AudioStream> stream) {
+    if (!stream || !stream->isMixed()) return;
+
+    mixer->removeSource(stream.get());
+    size_t token = mixer->retireToken();
+
+    if (!mixer->canFree(token)) {
+        retiredStreams.emplace_back(std::move(stream), token);
+    }
+}
+
+void VoicePlaybackManager::freeRetiredStreams() {
+    if (retiredStreams.empty()) return;
+
+    std::erase_if(retiredStreams, [this](const auto& pair) {
+        return mixer->canFree(pair.second);
+    });
 }
 
 bool VoicePlaybackManager::isSpeaking(int playerId) {
@@ -77,6 +157,19 @@ void VoicePlaybackManager::setVolumeAll(float volume) {
     }
 }
 
+void VoicePlaybackManager::setMaxSpeakers(size_t count) {
+    maxSpeakers = count;
+}
+
+size_t VoicePlaybackManager::speakingCount() {
+    size_t count = 0;
+    for (const auto& [_, stream] : streams) {
+        if (!stream->starving) count++;
+    }
+
+    return count;
+}
+
 void VoicePlaybackManager::updateEstimator(int playerId, float dt) {
     if (streams.contains(playerId)) {
         streams.at(playerId)->updateEstimator(dt);
@@ -84,9 +177,54 @@ void VoicePlaybackManager::updateEstimator(int playerId, float dt) {
 }
 
 void VoicePlaybackManager::updateAllEstimators(float dt) {
+    this->freeRetiredStreams();
+
     for (const auto& [_, stream] : streams) {
         stream->updateEstimator(dt);
     }
+
+    this->collectSpeakerEvents();
+}
+
+void VoicePlaybackManager::collectSpeakerEvents() {
+    events.clear();
+
+    for (const auto& [playerId, stream] : streams) {
+        bool audible = !stream->starving && stream->getVolume() > AUDIBLE_VOLUME;
+        auto it = publishedSpeakers.find(playerId);
+
+        if (!audible) {
+            if (it != publishedSpeakers.end()) {
+                publishedSpeakers.erase(it);
+                events.push_back(SpeakerEvent { SpeakerEvent::Kind::Stopped, playerId, 0.f });
+            }
+
+            continue;
+        }
+
+        float loudness = stream->getLoudness();
+        int bucket = static_cast<int>(std::clamp(loudness, 0.f, 1.f) * LOUDNESS_BUCKETS);
+
+        if (it == publishedSpeakers.end()) {
+            publishedSpeakers.emplace(playerId, bucket);
+            events.push_back(SpeakerEvent { SpeakerEvent::Kind::Started, playerId, loudness });
+        } else if (it->second != bucket) {
+            it->second = bucket;
+            events.push_back(SpeakerEvent { SpeakerEvent::Kind::Loudness, playerId, loudness });
+        }
+    }
+
+    // removed streams stop speaking too
+    std::erase_if(publishedSpeakers, [this](const auto& pair) {
+        if (streams.contains(pair.first)) return false;
+
+        events.push_back(SpeakerEvent { SpeakerEvent::Kind::Stopped, pair.first, 0.f });
+        return true;
+    });
+}
+
+const std::vector<VoicePlaybackManager::SpeakerEvent>& VoicePlaybackManager::speakerEvents() {
+    return events;
 }
 
 float VoicePlaybackManager::getLoudness(int playerId) {
@@ -107,6 +245,11 @@ void VoicePlaybackManager::forEachStream(std::function<void(int, AudioStream&)>
     }
 }
 
+AudioStream* VoicePlaybackManager::findStream(int playerId) {
+    auto it = streams.find(playerId);
+    return it == streams.end() ? nullptr : it->second.get();
+}
+
 #else
 
 void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, size_t samples) {}
@@ -122,8 +265,13 @@ float VoicePlaybackManager::getVolume(int playerId) {
 }
 void VoicePlaybackManager::muteEveryone() {}
 void VoicePlaybackManager::setVolumeAll(float volume) {}
+void VoicePlaybackManager::setMaxSpeakers(size_t count) {}
 void VoicePlaybackManager::updateEstimator(int playerId, float dt) {}
 void VoicePlaybackManager::updateAllEstimators(float dt) {}
+const std::vector<VoicePlaybackManager::SpeakerEvent>& VoicePlaybackManager::speakerEvents() {
+    static const std::vector<SpeakerEvent> empty;
+    return empty;
+}
 float VoicePlaybackManager::getLoudness(int playerId) {
     return 0.f;
 }
@@ -131,5 +279,8 @@ util::time::time_point VoicePlaybackManager::getLastPlaybackTime(int playerId) {
     return {};
 }
 void VoicePlaybackManager::forEachStream(std::function<void(int, AudioStream&)> func) {}
+AudioStream* VoicePlaybackManager::findStream(int playerId) {
+    return nullptr;
+}
 
 #endif // GLOBED_VOICE_SUPPORT
@@ -3,18 +3,47 @@
 #include <defs/minimal_geode.hpp>
 
 #include "stream.hpp"
+#include "mixer.hpp"
+
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
 #include <util/time.hpp>
 #include <util/singleton.hpp>
 
 /*
 * VoicePlaybackManager is responsible for playing voices of multiple people
 * at the same time efficiently and without memory leaks (?).
-* Not thread safe.
+* Not thread safe, except for the decoding which happens on a separate thread.
 */
 class VoicePlaybackManager : public SingletonBase<VoicePlaybackManager> {
+public:
+    // A change in who can be heard, collected by `updateAllEstimators`.
+    struct SpeakerEvent {
+        enum class Kind : uint8_t {
+            Started, Stopped, Loudness
+        };
+
+        Kind kind;
+        int playerId;
+        float loudness;
+    };
+
+    // Loudness changes smaller than one bucket don't produce an event
+    static constexpr float LOUDNESS_BUCKETS = 16.f;
+    // Streams quieter than this (e.g. muted or out of proximity range) count as not speaking
+    static constexpr float AUDIBLE_VOLUME = 0.005f;
+
+#ifdef GLOBED_VOICE_SUPPORT
+protected:
+    friend class SingletonBase;
+    VoicePlaybackManager();
+    ~VoicePlaybackManager();
+#endif
+
 public:
 #ifdef GLOBED_VOICE_SUPPORT
-    Result<> playFrameStreamed(int playerId, const EncodedAudioFrame& frame);
+    // queue the frame to be decoded on the decode thread, which then writes it to the stream of the player
+    void playFrameStreamed(int playerId, EncodedAudioFrame&& frame);
 #endif
     void playRawDataStreamed(int playerId, const float* pcm, size_t samples);
     void stopAllStreams();
@@ -27,16 +56,52 @@ public:
     void muteEveryone();
     void setVolumeAll(float volume);
 
+    // Only decode the voices of this many people at once, frames from anyone else are dropped until one of them goes quiet.
+    // 0 means no limit. Used by the battery saver.
+    void setMaxSpeakers(size_t count);
+
     void updateEstimator(int playerId, float dt);
     void updateAllEstimators(float dt);
 
+    // Events produced by the last `updateAllEstimators` call, valid until the next one.
+    const std::vector<SpeakerEvent>& speakerEvents();
+
     float getLoudness(int playerId);
     util::time::time_point getLastPlaybackTime(int playerId);
 
     void forEachStream(std::function<void(int, AudioStream&)> func);
 
+    // Returns the stream of the given player, or nullptr if they have none. Lets callers touching the stream
+    // multiple times in a row do a single lookup.
+    AudioStream* findStream(int playerId);
+
 private:
 #ifdef GLOBED_VOICE_SUPPORT
-    std::unordered_map<int, std::unique_ptr<AudioStream>> streams;
+    struct DecodeTask {
+        // keeps the stream alive until the frame is decoded, even if it gets removed in the meantime
+        std::shared_ptr<AudioStream> stream;
+        EncodedAudioFrame frame;
+        util::time::time_point arrival;
+    };
+
+    std::unordered_map<int, std::shared_ptr<AudioStream>> streams;
+    // players last reported as speaking, and their loudness bucket
+    std::unordered_map<int, int> publishedSpeakers;
+    std::vector<SpeakerEvent> events;
+    size_t maxSpeakers = 0;
+
+    // created once the first mixed stream is made, with the `voiceMixer` setting
+    std::unique_ptr<AudioMixer> mixer;
+    // mixed streams that were removed but could still be in use by the mixer callback
+    std::vector<std::pair<std::shared_ptr<AudioStream>, size_t>> retiredStreams;
+
+    asp::Channel<DecodeTask> decodeQueue;
+    asp::Thread<VoicePlaybackManager*> decodeThread;
+
+    void decodeThreadFunc();
+    size_t speakingCount();
+    void retireStream(std::shared_ptr<AudioStream> stream);
+    void freeRetiredStreams();
+    void collectSpeakerEvents();
 #endif
 };
@@ -6,77 +6,75 @@
 #include <data/packets/client/game.hpp>
 #include <managers/error_queues.hpp>
 #include <audio/manager.hpp>
+#include <util/profiler.hpp>
+#include <util/thread.hpp>
 #include <net/manager.hpp>
 #include <util/time.hpp>
 
 VoiceRecordingManager::VoiceRecordingManager() {
-    thread.setStartFunction([] { geode::utils::thread::setName("Record Thread"); });
+    thread.setStartFunction([] {
+        geode::utils::thread::setName("Record Thread");
+        GLOBED_PROFILE_THREAD("Record Thread");
+        util::thread::configureCurrent(util::thread::Priority::High, util::thread::CoreHint::Performance);
+    });
     thread.setLoopFunction(&VoiceRecordingManager::threadFunc);
     thread.start(this);
 }
 
 void VoiceRecordingManager::startRecording() {
-    queuedStart = true;
+    commands.push(Command::Start);
 }
 
 void VoiceRecordingManager::stopRecording() {
-    queuedStop = true;
+    commands.push(Command::Stop);
 }
 
 void VoiceRecordingManager::threadFunc() {
     auto& vm = GlobedAudioManager::get();
 
-    if (queuedStop) {
+    // the timeout is only there so the thread can notice when it's being stopped
+    auto command = commands.popTimeout(util::time::millis(250));
+
+    if (command == Command::Stop) {
         if (vm.isRecording()) {
             vm.stopRecording();
         }
-
-        this->resetBools(false);
-        return;
-    }
-
-    if (queuedStart) {
+    } else if (command == Command::Start) {
         if (!vm.isRecording()) {
-            vm.validateDevices();
-
-            // make sure the recording device is valid
-            if (!vm.isRecordingDeviceSet()) {
-                ErrorQueues::get().debugWarn("Unable to record audio, no recording device is set");
-                this->resetBools(false);
-                return;
-            }
-
-            auto result = vm.startPassiveRecording([](const auto& frame) {
-                auto& nm = NetworkManager::get();
-                if (!nm.established()) return;
-
-                // `frame` does not live long enough and will be destructed at the end of this callback.
-                // so we can't pass it directly in a `VoicePacket` and we use a `RawPacket` instead.
-
-                ByteBuffer buf;
-                buf.writeValue(frame);
-
-                nm.send(RawPacket::create<VoicePacket>(std::move(buf)));
-            });
-
-            if (result.isErr()) {
-                ErrorQueues::get().warn(result.unwrapErr());
-                log::warn("unable to record audio: {}", result.unwrapErr());
-                this->resetBools(false);
-                return;
-            }
+            this->handleStart();
         }
     }
 
-    this->resetBools(vm.isRecording());
-
-    std::this_thread::sleep_for(util::time::millis(10));
+    // recording can also stop on its own, for example if the device gets disconnected
+    recording = vm.isRecording();
 }
 
-void VoiceRecordingManager::resetBools(bool recording) {
-    this->recording = recording;
-    queuedStart = false;
-    queuedStop = false;
+void VoiceRecordingManager::handleStart() {
+    auto& vm = GlobedAudioManager::get();
+
+    vm.validateDevices();
+
+    // make sure the recording device is valid
+    if (!vm.isRecordingDeviceSet()) {
+        ErrorQueues::get().debugWarn("Unable to record audio, no recording device is set");
+        return;
+    }
+
+    auto result = vm.startPassiveRecording([](const EncodedAudioFrame& frame) {
+        auto& nm = NetworkManager::get();
+        if (!nm.established()) return;
+
+        // the frame is serialized straight into a pooled packet buffer, sized upfront so it's written in one go
+        nm.sendEncoded<VoicePacket>([&](ByteBuffer& buf) {
+            buf.reserve(frame.encodedSize());
+            buf.writeValue(frame);
+        });
+    });
+
+    if (result.isErr()) {
+        ErrorQueues::get().warn(result.unwrapErr());
+        log::warn("unable to record audio: {}", result.unwrapErr());
+    }
 }
 
 bool VoiceRecordingManager::isRecording() {
@@ -88,7 +86,6 @@ bool VoiceRecordingManager::isRecording() {
 VoiceRecordingManager::VoiceRecordingManager() {}
 void VoiceRecordingManager::startRecording() {}
 void VoiceRecordingManager::stopRecording() {}
-void VoiceRecordingManager::resetBools(bool recording) {}
 bool VoiceRecordingManager::isRecording() {
     return false;
 }
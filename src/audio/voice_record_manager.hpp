@@ -3,6 +3,7 @@
 
 #include <asp/thread/Thread.hpp>
 #include <asp/sync/Atomic.hpp>
+#include <asp/sync/Channel.hpp>
 
 #include <util/singleton.hpp>
 
@@ -13,8 +14,14 @@ protected:
 
 public:
 #ifdef GLOBED_VOICE_SUPPORT
+    enum class Command {
+        Start, Stop
+    };
+
     asp::thread::Thread<VoiceRecordingManager*> thread;
-    asp::sync::AtomicBool queuedStop = false, queuedStart = false, recording = false;
+    // the thread sleeps until a command arrives, so requests are handled right away instead of on the next poll
+    asp::sync::Channel<Command> commands;
+    asp::sync::AtomicBool recording = false;
 
     void threadFunc();
 #endif // GLOBED_VOICE_SUPPORT
@@ -23,6 +30,8 @@ public:
     void stopRecording();
     bool isRecording();
 
+#ifdef GLOBED_VOICE_SUPPORT
 private:
-    void resetBools(bool recording);
+    void handleStart();
+#endif // GLOBED_VOICE_SUPPORT
 };
@@ -1,23 +1,67 @@
 #include "volume_estimator.hpp"
 
-#include "manager.hpp"
-#include <util/misc.hpp>
+#include <util/simd.hpp>
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-VolumeEstimator::VolumeEstimator(size_t sampleRate) {
-    this->sampleRate = sampleRate;
+#include <algorithm>
+#include <cmath>
+
+VolumeEstimator::VolumeEstimator(size_t sampleRate)
+    : sampleRate(sampleRate),
+      bucketSize(std::max<size_t>(1, static_cast<size_t>(static_cast<float>(sampleRate) * WINDOW) / BUCKETS)) {}
+
+VolumeEstimator::VolumeEstimator() : VolumeEstimator(0) {}
+
+VolumeEstimator::VolumeEstimator(VolumeEstimator&& other) noexcept {
+    *this = std::move(other);
 }
 
-VolumeEstimator::VolumeEstimator() {
-    this->sampleRate = 0;
+VolumeEstimator& VolumeEstimator::operator=(VolumeEstimator&& other) noexcept {
+    sampleRate = other.sampleRate;
+    bucketSize = other.bucketSize;
+    buckets = other.buckets;
+    nextBucket = other.nextBucket;
+    partialSum = other.partialSum;
+    partialCount = other.partialCount;
+    windowVolume = other.windowVolume.load();
+    fedSinceUpdate = other.fedSinceUpdate.load();
+    volume = other.volume.load();
+
+    return *this;
 }
 
 void VolumeEstimator::feedData(const float* pcm, size_t samples) {
-    sampleQueue.writeData(pcm, samples);
+    fedSinceUpdate.fetch_add(samples, std::memory_order_relaxed);
+
+    bool changed = false;
+
+    while (samples > 0) {
+        size_t take = std::min(samples, bucketSize - partialCount);
+
+        // the kernel gives the average, turn it back into a sum
+        partialSum += util::simd::calcPcmVolume(pcm, take) * static_cast<float>(take);
+        partialCount += take;
+        pcm += take;
+        samples -= take;
+
+        if (partialCount == bucketSize) {
+            buckets[nextBucket] = partialSum;
+            nextBucket = (nextBucket + 1) % BUCKETS;
+            partialSum = 0.f;
+            partialCount = 0;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        // summing the buckets again is cheaper than it sounds, and unlike a running total it can't drift
+        float sum = 0.f;
+        for (float bucket : buckets) {
+            sum += bucket;
+        }
 
-    if (sampleQueue.size() > static_cast<float>(sampleRate) * BUFFER_SIZE) {
-        sampleQueue.clear();
+        windowVolume.store(sum / static_cast<float>(bucketSize * BUCKETS), std::memory_order_relaxed);
     }
 }
 
@@ -28,29 +72,17 @@ void VolumeEstimator::update(float dt) {
 
     dt = std::clamp(dt, 0.0f, 0.25f);
 
-    const size_t needed = static_cast<size_t>(static_cast<float>(sampleRate) * BUFFER_SIZE * dt);
+    float expected = static_cast<float>(sampleRate) * dt;
+    size_t fed = fedSinceUpdate.exchange(0, std::memory_order_relaxed);
 
-#ifdef __clang__
-    float buf[needed];
-#else
-    // yuck msvc
-    float* buf = reinterpret_cast<float*>(alloca(sizeof(float) * needed));
-#endif
-    size_t copied = sampleQueue.copyTo(buf, needed);
+    // missing samples count as silence
+    float coverage = expected > 0.f ? std::min(1.f, static_cast<float>(fed) / expected) : 1.f;
 
-    if (copied < needed) {
-        // fill the rest with void
-        for (size_t i = copied; i < needed; i++) {
-            buf[i] = 0.f;
-        }
-    }
-
-    volume = util::misc::calculatePcmVolume(buf, needed);
+    volume = windowVolume.load(std::memory_order_relaxed) * coverage;
 }
 
 float VolumeEstimator::getVolume() {
     return volume;
 }
 
-
-#endif // GLOBED_VOICE_SUPPORT
\ No newline at end of file
+#endif // GLOBED_VOICE_SUPPORT
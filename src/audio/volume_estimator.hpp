@@ -3,32 +3,51 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-#include "sample_queue.hpp"
-#include <util/collections.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
 
+// Running average of the absolute amplitude over the last `WINDOW` seconds of audio.
+// Samples are summed up as they arrive, in buckets of `WINDOW / BUCKETS` seconds, so the cost is O(new samples) and nothing gets buffered.
+// `feedData` may be called from one thread (i.e. the audio thread) while `update` and `getVolume` are called from another, without locking.
 class VolumeEstimator {
 public:
     VolumeEstimator(size_t sampleRate);
     VolumeEstimator();
 
-    VolumeEstimator(const VolumeEstimator&) = default;
-    VolumeEstimator& operator=(const VolumeEstimator&) = default;
+    VolumeEstimator(const VolumeEstimator&) = delete;
+    VolumeEstimator& operator=(const VolumeEstimator&) = delete;
 
-    VolumeEstimator(VolumeEstimator&&) = default;
-    VolumeEstimator& operator=(VolumeEstimator&&) = default;
+    // moving is not thread safe, the audio thread must not be feeding either of the estimators
+    VolumeEstimator(VolumeEstimator&&) noexcept;
+    VolumeEstimator& operator=(VolumeEstimator&&) noexcept;
 
     void feedData(const float* pcm, size_t samples);
 
+    // Fades the volume out if fewer samples than expected arrived in the last `dt` seconds, like when the stream stops playing
     void update(float dt);
 
     float getVolume();
 
 private:
-    static constexpr float BUFFER_SIZE = 1.0f;
+    static constexpr float WINDOW = 0.1f;
+    static constexpr size_t BUCKETS = 8;
 
-    float volume;
     size_t sampleRate;
-    AudioSampleQueue sampleQueue;
+    size_t bucketSize;
+
+    // audio thread only
+    std::array<float, BUCKETS> buckets{};
+    size_t nextBucket = 0;
+    float partialSum = 0.f;
+    size_t partialCount = 0;
+
+    // written by the audio thread
+    std::atomic<float> windowVolume = 0.f;
+    std::atomic<size_t> fedSinceUpdate = 0;
+
+    // written by `update`
+    std::atomic<float> volume = 0.f;
 };
 
-#endif // GLOBED_VOICE_SUPPORT
\ No newline at end of file
+#endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,39 @@
+#include "bench.hpp"
+
+#include <util/format.hpp>
+
+namespace bench {
+
+std::chrono::nanoseconds Measurement::perIteration() const {
+    return std::chrono::nanoseconds(iterations == 0 ? 0 : time.count() * 1000 / static_cast<int64_t>(iterations));
+}
+
+double Measurement::throughput() const {
+    // bytes per microsecond is the same as megabytes per second
+    return bytes == 0 || time.count() == 0 ? 0.0 : (double)(bytes * iterations) / (double)time.count();
+}
+
+void Report::log() const {
+    geode::log::info("{}", title);
+
+    for (const auto& c : cases) {
+        std::string line = c.name + ":";
+
+        for (size_t i = 0; i < c.measurements.size(); i++) {
+            const auto& m = c.measurements[i];
+            line += fmt::format("{}{} {}", i == 0 ? " " : ", ", m.label, util::format::duration(m.perIteration()));
+
+            if (m.bytes != 0) {
+                line += fmt::format(" ({:.1f} MB/s)", m.throughput());
+            }
+        }
+
+        if (!c.note.empty()) {
+            line += fmt::format("{}{}", c.measurements.empty() ? " " : ", ", c.note);
+        }
+
+        geode::log::info("{}", line);
+    }
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <game/lerp_replay.hpp>
+#include <util/time.hpp>
+
+// Microbenchmarks behind the test buttons in `DebugToolsPopup`. Each one runs synchronously on the calling thread
+// and returns its timings, where possible comparing an optimized path against the one it replaced.
+namespace bench {
+    struct Measurement {
+        std::string label;
+        util::time::micros time; // of all iterations together
+        size_t iterations;
+        size_t bytes = 0;        // processed per iteration, 0 if a throughput makes no sense
+
+        std::chrono::nanoseconds perIteration() const;
+        // in MB/s, 0 if `bytes` is 0
+        double throughput() const;
+    };
+
+    struct Case {
+        std::string name;
+        std::vector<Measurement> measurements;
+        std::string note; // anything else worth logging, e.g. a checksum that keeps the work from being optimized out
+    };
+
+    struct Report {
+        std::string title;
+        std::vector<Case> cases;
+
+        // Logs the title and then one line per case
+        void log() const;
+    };
+
+    // `ByteBuffer`: the fixed size fast path against encoding every member on its own, and decoding level data in bulk
+    Report encoding();
+
+    // Every crypto box, in place and out of place, over a few packet sizes
+    Report crypto();
+
+    // `util::simd::adler32` against the constexpr one in `util::crypto`
+    Report adler32();
+
+    // Every other kernel in `util::simd`, the scalar table against the one picked for this cpu, and the bulk codecs
+    Report simdKernels();
+
+    // `LevelDataPacket` coding and `PlayerInterpolator` ticks at the player counts of the server benchmarks,
+    // and the voice sample queue when voice is supported
+    Report game();
+
+    // `SmallVector` and `CappedQueue` against the standard containers they replaced
+    Report collections();
+
+    struct LerpReplayReport {
+        std::filesystem::path capture;
+        size_t packets;
+        size_t players;
+        float frameInterval;
+        std::vector<LerpReplay::Score> scores; // one per variant in `LerpReplay::defaultVariants`
+
+        void log() const;
+    };
+
+    // Plays the level data of the newest packet capture through the interpolator with different settings
+    Result<LerpReplayReport> lerpReplay();
+}
@@ -0,0 +1,86 @@
+#include "bench.hpp"
+
+#include <deque>
+
+#include <util/collections.hpp>
+#include <util/debug.hpp>
+
+namespace bench {
+
+Report collections() {
+    constexpr size_t ITERS = 10'000;
+
+    util::debug::Benchmarker bb;
+    Report report { .title = "Collections benchmark" };
+
+    // per-tick id lists like in selPeriodicalUpdate, once within the inline capacity and once spilling to the heap
+    auto benchIdList = [&]<size_t N>(std::integral_constant<size_t, N>) {
+        for (size_t count : {N / 2, N * 4}) {
+            int64_t checksum = 0;
+
+            auto small = bb.run([&] {
+                for (size_t i = 0; i < ITERS; i++) {
+                    util::collections::SmallVector<int, N> ids;
+                    for (size_t j = 0; j < count; j++) ids.push_back(static_cast<int>(j));
+                    for (int id : ids) checksum += id;
+                }
+            });
+
+            auto vec = bb.run([&] {
+                for (size_t i = 0; i < ITERS; i++) {
+                    std::vector<int> ids;
+                    for (size_t j = 0; j < count; j++) ids.push_back(static_cast<int>(j));
+                    for (int id : ids) checksum += id;
+                }
+            });
+
+            report.cases.push_back(Case {
+                .name = fmt::format("SmallVector<int, {}> {} elements", N, count),
+                .measurements = {
+                    { "SmallVector", small, ITERS },
+                    { "std::vector", vec, ITERS },
+                },
+                .note = fmt::format("checksum {}", checksum),
+            });
+        }
+    };
+
+    benchIdList(std::integral_constant<size_t, 32>{});
+    benchIdList(std::integral_constant<size_t, 256>{});
+
+    // a rolling window of samples, pushed one at a time and read back every 16 pushes
+    constexpr size_t WINDOW = 64;
+    constexpr size_t PUSHES = 1024 * 1024;
+
+    util::collections::CappedQueue<float, WINDOW> ring;
+    std::deque<float> deque;
+    float sum = 0.f;
+
+    auto ringTime = bb.run([&] {
+        for (size_t i = 0; i < PUSHES; i++) {
+            ring.push(static_cast<float>(i));
+            if (i % 16 == 0) ring.forEach([&](float v) { sum += v; });
+        }
+    });
+
+    auto dequeTime = bb.run([&] {
+        for (size_t i = 0; i < PUSHES; i++) {
+            if (deque.size() == WINDOW) deque.pop_front();
+            deque.push_back(static_cast<float>(i));
+            if (i % 16 == 0) for (float v : deque) sum += v;
+        }
+    });
+
+    report.cases.push_back(Case {
+        .name = fmt::format("CappedQueue<float, {}> x{}", WINDOW, PUSHES),
+        .measurements = {
+            { "CappedQueue", ringTime, PUSHES },
+            { "std::deque", dequeTime, PUSHES },
+        },
+        .note = fmt::format("checksum {}", sum),
+    });
+
+    return report;
+}
+
+}
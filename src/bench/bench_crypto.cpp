@@ -0,0 +1,122 @@
+#include "bench.hpp"
+
+#include <crypto/box.hpp>
+#include <crypto/secret_box.hpp>
+#include <crypto/chacha_secret_box.hpp>
+#include <crypto/aes_gcm_secret_box.hpp>
+#include <crypto/session_box.hpp>
+#include <util/crypto.hpp>
+#include <util/debug.hpp>
+
+namespace bench {
+
+Report crypto() {
+    // every test processes roughly this much data, so small packets get a lot more iterations than big ones
+    constexpr size_t TOTAL_BYTES = 4 * 1024 * 1024;
+    constexpr size_t SIZES[] = {64, 512, 1024, 65536};
+
+    util::debug::Benchmarker bb;
+    Report report { .title = fmt::format("Crypto benchmark, libsodium {}, {} bytes per test", CryptoBox::sodiumVersion(), TOTAL_BYTES) };
+
+    auto add = [&](const char* name, size_t size, const char* mode, size_t iters, util::time::micros encrypt, util::time::micros decrypt) {
+        report.cases.push_back(Case {
+            .name = fmt::format("{} {}B {}", name, size, mode),
+            .measurements = {
+                { "encrypt", encrypt, iters, size },
+                { "decrypt", decrypt, iters, size },
+            },
+        });
+    };
+
+    auto bench = [&]<typename Box>(const char* name, Box& box) {
+        for (size_t size : SIZES) {
+            size_t iters = TOTAL_BYTES / size;
+            size_t slot = size + Box::prefixLength();
+
+            auto plaintext = util::crypto::secureRandom(size);
+            util::data::bytevector ciphertext(slot);
+            util::data::bytevector output(slot);
+
+            // out of place, the same buffers every time
+            auto encryptOut = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) box.encryptInto(plaintext.data(), ciphertext.data(), size);
+            });
+
+            auto decryptOut = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) box.decryptInto(ciphertext.data(), output.data(), slot);
+            });
+
+            add(name, size, "out-of-place", iters, encryptOut, decryptOut);
+
+            // in place, every packet gets its own slot since decrypting destroys the ciphertext
+            util::data::bytevector packets(slot * iters);
+            for (size_t i = 0; i < iters; i++) {
+                std::memcpy(packets.data() + i * slot, plaintext.data(), size);
+            }
+
+            auto encryptIn = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) box.encryptInPlace(packets.data() + i * slot, size);
+            });
+
+            auto decryptIn = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) box.decryptInPlace(packets.data() + i * slot, slot);
+            });
+
+            add(name, size, "in-place", iters, encryptIn, decryptIn);
+        }
+    };
+
+    CryptoBox cryptoBox, peerBox;
+    cryptoBox.setPeerKey(peerBox.getPublicKey());
+    bench("CryptoBox", cryptoBox);
+
+    SecretBox secretBox(util::crypto::secureRandom(SecretBox::KEY_LEN));
+    bench("SecretBox", secretBox);
+
+    ChaChaSecretBox chachaBox(util::crypto::secureRandom(ChaChaSecretBox::KEY_LEN));
+    bench("ChaChaSecretBox", chachaBox);
+
+    if (AesGcmSecretBox::isAvailable()) {
+        AesGcmSecretBox aesBox(util::crypto::secureRandom(AesGcmSecretBox::KEY_LEN));
+        bench("AesGcmSecretBox", aesBox);
+    } else {
+        report.cases.push_back(Case { .name = "AesGcmSecretBox", .note = "no hardware AES on this device, skipped" });
+    }
+
+    // session boxes only work in place, and reject replays, so the receiving side needs a box of its own
+    auto benchSession = [&](const char* name, SessionCipher cipher) {
+        auto key = cryptoBox.deriveSessionKey();
+        SessionBox sender(key, true, cipher);
+        SessionBox receiver(key, false, cipher);
+
+        for (size_t size : SIZES) {
+            size_t iters = TOTAL_BYTES / size;
+            size_t slot = size + SessionBox::PREFIX_LEN;
+
+            auto plaintext = util::crypto::secureRandom(size);
+            util::data::bytevector packets(slot * iters);
+            for (size_t i = 0; i < iters; i++) {
+                std::memcpy(packets.data() + i * slot, plaintext.data(), size);
+            }
+
+            auto encryptIn = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) sender.encryptInPlace(packets.data() + i * slot, size);
+            });
+
+            auto decryptIn = bb.run([&] {
+                for (size_t i = 0; i < iters; i++) (void) receiver.decryptInPlace(packets.data() + i * slot, slot);
+            });
+
+            add(name, size, "in-place", iters, encryptIn, decryptIn);
+        }
+    };
+
+    benchSession("SessionBox (XChaCha20-Poly1305)", SessionCipher::XChaCha20Poly1305);
+    if (AesGcmSecretBox::isAvailable()) {
+        benchSession("SessionBox (AES-256-GCM)", SessionCipher::Aes256Gcm);
+    }
+
+    return report;
+}
+
+}
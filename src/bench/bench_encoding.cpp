@@ -0,0 +1,96 @@
+#include "bench.hpp"
+
+#include <data/bytebuffer.hpp>
+#include <data/packets/packet.hpp>
+#include <data/types/game.hpp>
+#include <data/types/gd.hpp>
+#include <util/debug.hpp>
+
+namespace bench {
+
+Report encoding() {
+    constexpr size_t ITERS = 100'000;
+
+    util::debug::Benchmarker bb;
+    Report report { .title = fmt::format("Encoding benchmark, {} iterations", ITERS) };
+
+    // compares the fixed size fast path against decoding each field on its own
+    auto bench = [&]<typename T>(const char* name, const T& value) {
+        ByteBuffer buf;
+        buf.reserve(ByteBuffer::encodedSizeHint(value) * ITERS);
+
+        auto encodeFields = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) buf.writeValueFieldwise(value);
+        });
+
+        buf.setPosition(0);
+        auto encodeFixed = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) buf.writeValue(value);
+        });
+
+        buf.setPosition(0);
+        auto decodeFields = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) (void) buf.readValueFieldwise<T>();
+        });
+
+        buf.setPosition(0);
+        auto decodeFixed = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) (void) buf.readValue<T>();
+        });
+
+        report.cases.push_back(Case {
+            .name = name,
+            .measurements = {
+                { "encode per field", encodeFields, ITERS },
+                { "encode fixed", encodeFixed, ITERS },
+                { "decode per field", decodeFields, ITERS },
+                { "decode fixed", decodeFixed, ITERS },
+            },
+        });
+    };
+
+    bench("PacketHeader", PacketHeader { .id = 12003, .flags = 0 });
+    bench("PlayerIconData", PlayerIconData::DEFAULT_ICONS);
+    bench("PlayerIconDataSimple", PlayerIconDataSimple());
+    bench("PlayerMetadata", PlayerMetadata { .localBest = 50, .attempts = 100 });
+
+    // level data, compares decoding every element on its own against decoding the whole vector
+    constexpr size_t PLAYER_COUNT = 100;
+    std::vector<AssociatedPlayerData> players(PLAYER_COUNT, AssociatedPlayerData(0, PlayerData {}));
+    players[0].data.events.push(PlayerEvent { .type = PlayerEventType::SpiderTeleport });
+
+    ByteBuffer buf;
+    buf.writeValue(players);
+
+    std::vector<AssociatedPlayerData> out(PLAYER_COUNT);
+
+    auto decodeChecked = bb.run([&] {
+        for (size_t i = 0; i < ITERS / PLAYER_COUNT; i++) {
+            buf.setPosition(0);
+            (void) buf.readLength();
+
+            for (auto& player : out) {
+                (void) buf.readValueInto(player);
+            }
+        }
+    });
+
+    auto decodeBounded = bb.run([&] {
+        for (size_t i = 0; i < ITERS / PLAYER_COUNT; i++) {
+            buf.setPosition(0);
+            (void) buf.readValueInto(out);
+        }
+    });
+
+    report.cases.push_back(Case {
+        .name = fmt::format("{} AssociatedPlayerData", PLAYER_COUNT),
+        .measurements = {
+            { "decode each", decodeChecked, ITERS / PLAYER_COUNT },
+            { "decode bounded", decodeBounded, ITERS / PLAYER_COUNT },
+        },
+    });
+
+    return report;
+}
+
+}
@@ -0,0 +1,136 @@
+#include "bench.hpp"
+
+#include <audio/manager.hpp>
+#include <audio/sample_queue.hpp>
+#include <data/bytebuffer.hpp>
+#include <data/packets/server/game.hpp>
+#include <game/interpolator.hpp>
+#include <game/lerp_logger.hpp>
+#include <game/player_slots.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+
+using namespace geode::prelude;
+
+namespace bench {
+
+Report game() {
+    // the same player counts as the server benchmarks, so the numbers are comparable
+    constexpr size_t PLAYER_COUNTS[] = {10, 100, 500};
+    constexpr size_t ITERS = 1000;
+
+    util::debug::Benchmarker bb;
+    Report report { .title = fmt::format("Game benchmark, {} iterations", ITERS) };
+
+    for (size_t count : PLAYER_COUNTS) {
+        LevelDataPacket packet;
+        packet.players.resize(count, AssociatedPlayerData(0, PlayerData {}));
+        for (size_t i = 0; i < count; i++) {
+            packet.players[i].accountId = static_cast<int>(i + 1);
+            packet.players[i].data.player1.position = CCPoint { i * 30.f, 105.f };
+        }
+
+        ByteBuffer buf;
+        buf.reserve(packet.getEncodedSizeHint() * 2);
+
+        auto encode = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) {
+                buf.clear();
+                packet.encode(buf);
+            }
+        });
+
+        LevelDataPacket decoded;
+        auto decode = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) {
+                buf.setPosition(0);
+                (void) decoded.decode(buf);
+            }
+        });
+
+        report.cases.push_back(Case {
+            .name = fmt::format("LevelDataPacket {} players ({})", count, util::format::formatBytes(buf.size())),
+            .measurements = {
+                { "encode", encode, ITERS },
+                { "decode", decode, ITERS },
+            },
+        });
+    }
+
+    // the interpolator asks the play layer for the time when logging, which isn't there in the menu
+    if (!LerpLogger::isEnabled()) {
+        constexpr float FRAME_DELTA = 1.f / 240.f;
+        constexpr float SEND_DELTA = 1.f / 30.f;
+
+        for (size_t count : PLAYER_COUNTS) {
+            PlayerSlots slots;
+            PlayerInterpolator interpolator(InterpolatorSettings {
+                .realtime = false,
+                .isPlatformer = false,
+                .expectedDelta = SEND_DELTA,
+                .extrapolation = true,
+            }, slots);
+
+            PlayerData data {};
+            for (size_t i = 0; i < count; i++) {
+                int id = static_cast<int>(i + 1);
+                slots.add(id);
+                interpolator.addPlayer(id);
+            }
+
+            // new frames arrive at 30 tps like in a real level, so the jitter buffer stays filled
+            float time = 0.f, nextFrame = 0.f;
+            auto tick = bb.run([&] {
+                for (size_t i = 0; i < ITERS; i++) {
+                    if (time >= nextFrame) {
+                        data.timestamp = nextFrame;
+                        data.player1.position.x = nextFrame * 300.f;
+                        for (size_t p = 0; p < count; p++) {
+                            interpolator.updatePlayer(static_cast<int>(p + 1), data, nextFrame);
+                        }
+
+                        nextFrame += SEND_DELTA;
+                    }
+
+                    interpolator.tick(FRAME_DELTA);
+                    time += FRAME_DELTA;
+                }
+            });
+
+            report.cases.push_back(Case {
+                .name = fmt::format("PlayerInterpolator {} players", count),
+                .measurements = {{ "tick", tick, ITERS }},
+                .note = "including updates",
+            });
+        }
+    } else {
+        report.cases.push_back(Case { .name = "PlayerInterpolator", .note = "interpolation logging is enabled, skipped" });
+    }
+
+#ifdef GLOBED_VOICE_SUPPORT
+    // one voice frame at a time, like the decoder thread writes and FMOD reads
+    constexpr size_t CHUNK = VOICE_TARGET_FRAMESIZE;
+    constexpr size_t TOTAL_SAMPLES = 16 * 1024 * 1024;
+
+    AudioSampleQueue queue;
+    std::vector<float> in(CHUNK, 0.5f), out(CHUNK);
+
+    size_t moved = 0;
+    auto samples = bb.run([&] {
+        for (size_t i = 0; i < TOTAL_SAMPLES / CHUNK; i++) {
+            queue.writeData(in.data(), CHUNK);
+            moved += queue.copyTo(out.data(), CHUNK);
+        }
+    });
+
+    report.cases.push_back(Case {
+        .name = fmt::format("AudioSampleQueue {} samples", CHUNK),
+        .measurements = {{ "write and copy", samples, TOTAL_SAMPLES / CHUNK, CHUNK * sizeof(float) }},
+        .note = fmt::format("{} samples moved", moved),
+    });
+#endif // GLOBED_VOICE_SUPPORT
+
+    return report;
+}
+
+}
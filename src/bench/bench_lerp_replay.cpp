@@ -0,0 +1,52 @@
+#include "bench.hpp"
+
+#include <defs/assert.hpp>
+#include <game/lerp_logger.hpp>
+
+using namespace geode::prelude;
+
+namespace bench {
+
+void LerpReplayReport::log() const {
+    log::info("Replaying {}", capture);
+    log::info(
+        "{} level data packets, {} players, frame interval {}ms",
+        packets, players, static_cast<int>(frameInterval * 1000.f)
+    );
+
+    for (const auto& score : scores) {
+        log::info(
+            "{:<28} n={:<7} latency {:.1f}ms (p95 {:.1f}ms), error {:.2f} (p95 {:.2f}), roughness {:.1f}, held {:.1f}%",
+            score.name, score.samples,
+            score.meanLatency * 1000.f, score.p95Latency * 1000.f,
+            score.meanError, score.p95Error,
+            score.roughness, score.heldRatio * 100.f
+        );
+    }
+}
+
+Result<LerpReplayReport> lerpReplay() {
+    constexpr float FRAME_DELTA = 1.f / 60.f;
+
+    if (LerpLogger::isEnabled()) {
+        return Err("Turn off interpolation logging first");
+    }
+
+    GLOBED_UNWRAP_INTO(LerpReplay::latestCapture(), auto path);
+    GLOBED_UNWRAP_INTO(LerpReplay::fromCapture(path), auto replay);
+
+    LerpReplayReport report {
+        .capture = path,
+        .packets = replay.packetCount(),
+        .players = replay.playerCount(),
+        .frameInterval = replay.frameInterval(),
+    };
+
+    for (const auto& variant : replay.defaultVariants()) {
+        report.scores.push_back(replay.run(variant, FRAME_DELTA));
+    }
+
+    return Ok(std::move(report));
+}
+
+}
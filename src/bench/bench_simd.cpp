@@ -0,0 +1,120 @@
+#include "bench.hpp"
+
+#include <util/crypto.hpp>
+#include <util/debug.hpp>
+#include <util/simd.hpp>
+
+namespace bench {
+
+Report adler32() {
+    constexpr size_t TOTAL_BYTES = 16 * 1024 * 1024;
+    constexpr size_t SIZES[] = {16, 256, 4096, 65536, 1024 * 1024};
+
+    util::debug::Benchmarker bb;
+    Report report { .title = fmt::format("adler32 benchmark, {} bytes per test", TOTAL_BYTES) };
+
+    for (size_t size : SIZES) {
+        size_t iters = TOTAL_BYTES / size;
+        auto data = util::crypto::secureRandom(size);
+
+        // keep the results around so the loops don't get optimized out
+        uint32_t scalarHash = 0, simdHash = 0;
+
+        auto scalar = bb.run([&] {
+            for (size_t i = 0; i < iters; i++) scalarHash ^= util::crypto::adler32(data.data(), size);
+        });
+
+        auto simd = bb.run([&] {
+            for (size_t i = 0; i < iters; i++) simdHash ^= util::simd::adler32(data.data(), size);
+        });
+
+        report.cases.push_back(Case {
+            .name = fmt::format("adler32 {}B x{}", size, iters),
+            .measurements = {
+                { "constexpr", scalar, iters, size },
+                { "simd", simd, iters, size },
+            },
+            .note = scalarHash == simdHash ? "" : "MISMATCH",
+        });
+    }
+
+    return report;
+}
+
+Report simdKernels() {
+    constexpr size_t COUNT = 4096;
+    constexpr size_t ITERS = 2000;
+
+    const auto& scalarTable = util::simd::scalarKernels();
+    const auto& simdTable = util::simd::kernels();
+
+    util::debug::Benchmarker bb;
+    Report report { .title = fmt::format("SIMD kernels: {}, {} elements x{}", simdTable.name, COUNT, ITERS) };
+
+    std::vector<float> a(COUNT), b(COUNT), c(COUNT), d(COUNT), ratio(COUNT), out(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        a[i] = (float)(i % 360);
+        b[i] = (float)((i * 7) % 720) - 360.f;
+        c[i] = (float)(i % 13);
+        d[i] = (float)(i % 17);
+        ratio[i] = (float)(i % 150) / 100.f;
+    }
+
+    std::vector<uint32_t> words(COUNT);
+
+    // the scalar table against the one picked for this cpu
+    auto compare = [&](const char* name, size_t bytes, auto&& kernel) {
+        auto scalar = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) kernel(scalarTable);
+        });
+
+        auto simd = bb.run([&] {
+            for (size_t i = 0; i < ITERS; i++) kernel(simdTable);
+        });
+
+        report.cases.push_back(Case {
+            .name = name,
+            .measurements = {
+                { "scalar", scalar, ITERS, bytes },
+                { simdTable.name, simd, ITERS, bytes },
+            },
+        });
+    };
+
+    float volume = 0.f;
+    compare("pcmVolume", COUNT * sizeof(float), [&](const auto& k) { volume += k.pcmVolume(a.data(), COUNT); });
+    compare("byteswap32", COUNT * sizeof(uint32_t), [&](const auto& k) { k.byteswap32(words.data(), COUNT); });
+    compare("lerp", COUNT * sizeof(float), [&](const auto& k) { k.lerp(a.data(), b.data(), ratio.data(), out.data(), COUNT); });
+    compare("lerpAngle", COUNT * sizeof(float), [&](const auto& k) { k.lerpAngle(a.data(), b.data(), ratio.data(), out.data(), COUNT); });
+    compare("mixAdd", COUNT * sizeof(float), [&](const auto& k) { k.mixAdd(out.data(), a.data(), 0.5f, COUNT); });
+    compare("distance", COUNT * sizeof(float), [&](const auto& k) { k.distance(a.data(), b.data(), out.data(), COUNT); });
+    compare("hermite", COUNT * sizeof(float), [&](const auto& k) {
+        k.hermite(a.data(), b.data(), c.data(), d.data(), ratio.data(), out.data(), COUNT);
+    });
+
+    // the bulk codecs only do part of the work, so measure the whole conversion instead
+    auto bytes = util::crypto::secureRandom(COUNT);
+    std::string text(util::crypto::base64EncodedLength(COUNT), '\0');
+
+    auto base64 = bb.run([&] {
+        for (size_t i = 0; i < ITERS; i++) (void) util::crypto::base64EncodeInto(bytes.data(), COUNT, text.data());
+    });
+
+    text.resize(COUNT * 2);
+    auto hex = bb.run([&] {
+        for (size_t i = 0; i < ITERS; i++) (void) util::crypto::hexEncodeInto(bytes.data(), COUNT, text.data());
+    });
+
+    report.cases.push_back(Case {
+        .name = "codecs",
+        .measurements = {
+            { "base64 encode", base64, ITERS, COUNT },
+            { "hex encode", hex, ITERS, COUNT },
+        },
+        .note = fmt::format("volume {}", volume),
+    });
+
+    return report;
+}
+
+}
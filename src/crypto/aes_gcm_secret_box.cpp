@@ -0,0 +1,101 @@
+#include "aes_gcm_secret_box.hpp"
+
+#include <sodium.h>
+
+#include <util/crypto.hpp>
+#include <defs/assert.hpp>
+#include <defs/minimal_geode.hpp>
+
+using namespace util::data;
+
+static_assert(AesGcmSecretBox::KEY_LEN == crypto_aead_aes256gcm_KEYBYTES);
+static_assert(AesGcmSecretBox::NONCE_LEN == crypto_aead_aes256gcm_NPUBBYTES);
+static_assert(AesGcmSecretBox::MAC_LEN == crypto_aead_aes256gcm_ABYTES);
+
+#define GLOBED_AES_STATE reinterpret_cast<crypto_aead_aes256gcm_state*>(this->state)
+
+AesGcmSecretBox::AesGcmSecretBox(bytevector key) {
+    CRYPTO_REQUIRE(isAvailable(), "AES-GCM is not supported by this CPU")
+    CRYPTO_REQUIRE(key.size() == KEY_LEN, "provided key is too long or too short for AesGcmSecretBox")
+
+    // the state must be 16-byte aligned, its size is a multiple of that so sodium_malloc gives us an aligned pointer
+    this->state = reinterpret_cast<byte*>(sodium_malloc(
+        sizeof(crypto_aead_aes256gcm_state)
+    ));
+
+    CRYPTO_REQUIRE(this->state != nullptr, "sodium_malloc returned nullptr")
+
+    this->setKey(key.data());
+}
+
+AesGcmSecretBox::~AesGcmSecretBox() {
+    if (this->state) {
+        sodium_free(this->state);
+    }
+}
+
+bool AesGcmSecretBox::isAvailable() {
+    // on x86 this checks for AES-NI and PCLMUL, on arm for the ARMv8 crypto extensions
+    static bool available = sodium_init() != -1 && crypto_aead_aes256gcm_is_available() != 0;
+    return available;
+}
+
+size_t AesGcmSecretBox::encryptInto(const byte* src, byte* dest, size_t size) {
+    byte nonce[NONCE_LEN];
+    util::crypto::secureRandom(nonce, NONCE_LEN);
+
+    return this->encryptIntoWithNonce(src, dest, size, nonce);
+}
+
+size_t AesGcmSecretBox::encryptIntoWithNonce(const byte* src, byte* dest, size_t size, const byte* nonce) {
+    byte* mac = dest + NONCE_LEN;
+    byte* ciphertext = mac + MAC_LEN;
+
+    // libsodium only allows exact in-place operation for AES-GCM, shifted overlaps (like in `encryptInPlace`) are not safe.
+    // so move the plaintext into place first, then encrypt it there
+    std::memmove(ciphertext, src, size);
+    this->encryptDetached(ciphertext, ciphertext, mac, size, nonce);
+
+    // prepend the nonce
+    std::memcpy(dest, nonce, NONCE_LEN);
+
+    return size + prefixLength();
+}
+
+size_t AesGcmSecretBox::decryptInto(const byte* src, byte* dest, size_t size) {
+    CRYPTO_REQUIRE(size >= prefixLength(), "message is too short")
+
+    size_t plaintextLength = size - prefixLength();
+
+    // see `encryptIntoWithNonce`, `dest` may overlap with the whole message (`decryptInPlace` does that),
+    // so keep the nonce and the tag aside before moving the ciphertext into place
+    byte nonce[NONCE_LEN];
+    byte mac[MAC_LEN];
+    std::memcpy(nonce, src, NONCE_LEN);
+    std::memcpy(mac, src + NONCE_LEN, MAC_LEN);
+
+    std::memmove(dest, src + PREFIX_LEN, plaintextLength);
+    CRYPTO_REQUIRE(this->decryptDetached(dest, dest, mac, plaintextLength, nonce), "crypto_aead_aes256gcm_decrypt_detached_afternm failed")
+
+    return plaintextLength;
+}
+
+void AesGcmSecretBox::encryptDetached(const byte* src, byte* dest, byte* mac, size_t size, const byte* nonce) {
+    CRYPTO_ERR_CHECK(
+        crypto_aead_aes256gcm_encrypt_detached_afternm(dest, mac, nullptr, src, size, nullptr, 0, nullptr, nonce, GLOBED_AES_STATE),
+        "crypto_aead_aes256gcm_encrypt_detached_afternm failed"
+    )
+}
+
+bool AesGcmSecretBox::decryptDetached(const byte* src, byte* dest, const byte* mac, size_t size, const byte* nonce) {
+    return crypto_aead_aes256gcm_decrypt_detached_afternm(dest, nullptr, src, size, mac, nullptr, 0, nonce, GLOBED_AES_STATE) == 0;
+}
+
+void AesGcmSecretBox::setKey(const util::data::bytevector& src) {
+    GLOBED_REQUIRE(src.size() == KEY_LEN, "key size is too small or too big for AesGcmSecretBox")
+    setKey(src.data());
+}
+
+void AesGcmSecretBox::setKey(const util::data::byte* src) {
+    CRYPTO_ERR_CHECK(crypto_aead_aes256gcm_beforenm(GLOBED_AES_STATE, src), "crypto_aead_aes256gcm_beforenm failed")
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "base_box.hpp"
+
+/*
+* AesGcmSecretBox - SecretBox with prefix AES-GCM algo
+*
+* Algorithm - AES256-GCM
+* Tag implementation - prefix
+*
+* Only usable on CPUs with hardware AES support (AES-NI + PCLMUL, or the ARMv8 crypto extensions), check `isAvailable` first.
+* The nonce is only 96 bits, so with random nonces a single key should not encrypt more than a few billion messages.
+*/
+
+class AesGcmSecretBox final : public BaseCryptoBox<AesGcmSecretBox> {
+public:
+    constexpr static size_t NONCE_LEN = 12;
+    constexpr static size_t PREFIX_LEN = NONCE_LEN + MAC_LEN;
+
+    constexpr static size_t prefixLength() {
+        return PREFIX_LEN;
+    }
+
+    constexpr static size_t nonceLength() {
+        return NONCE_LEN;
+    }
+
+    AesGcmSecretBox(util::data::bytevector key);
+    AesGcmSecretBox(const AesGcmSecretBox&) = delete;
+    AesGcmSecretBox& operator=(const AesGcmSecretBox&) = delete;
+    ~AesGcmSecretBox();
+
+    // whether the CPU can run AES-GCM in hardware, the box must not be created otherwise
+    static bool isAvailable();
+
+    size_t encryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
+    // Like `encryptInto` but with a caller provided nonce (`nonceLength()` bytes), which must never be reused with the same key.
+    size_t encryptIntoWithNonce(const util::data::byte* src, util::data::byte* dest, size_t size, const util::data::byte* nonce);
+    size_t decryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
+
+    // Encrypt `size` bytes from `src` into `dest` with a caller provided nonce (`NONCE_LEN` bytes), writing the tag into `mac` (`MAC_LEN` bytes).
+    // The nonce must never be reused with the same key. `src` and `dest` must be either the same pointer or not overlap at all.
+    void encryptDetached(const util::data::byte* src, util::data::byte* dest, util::data::byte* mac, size_t size, const util::data::byte* nonce);
+    // Decrypt and verify `size` bytes from `src` into `dest`, returns false if the tag doesn't match. Same rules for `src` and `dest` as `encryptDetached`.
+    bool decryptDetached(const util::data::byte* src, util::data::byte* dest, const util::data::byte* mac, size_t size, const util::data::byte* nonce);
+
+    void setKey(const util::data::bytevector& src);
+    void setKey(const util::data::byte* src);
+
+private:
+    // expanded key schedule (`crypto_aead_aes256gcm_state`), computed once in `setKey`
+    util::data::byte* state = nullptr;
+};
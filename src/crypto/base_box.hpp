@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <cstring> // std::memmove
 
 #include <util/data.hpp>
+#include <util/crypto.hpp>
 
 /*
 * This class contains no crypto implementation and is here just for boilerplate code.
@@ -16,8 +18,18 @@
 * constexpr size_t nonceLength();
 *
 * constexpr size_t macLength();
+*
+* For the batch functions, also:
+*
+* size_t encryptIntoWithNonce(byte* src, byte* dest, size_t size, byte* nonce)
 */
 
+// One message in a batch, `size` is updated with the new length after encryption or decryption.
+struct CryptoBatchItem {
+    util::data::byte* data;
+    size_t size;
+};
+
 // this does not work bc c++ is shit
 template <typename T>
 concept CBox = requires(T box, const util::data::byte* src, util::data::byte* dest, size_t size) {
@@ -34,6 +46,7 @@ protected:
 
 public:
     // Preferrably we should define those separately for each subclass, but it does not compile on MSVC.
+    // Boxes with a different layout can shadow them along with the functions below, the helpers here always go through `Derived`.
     constexpr static size_t KEY_LEN = 32;
     constexpr static size_t NONCE_LEN = 24;
     constexpr static size_t MAC_LEN = 16;
@@ -83,7 +96,7 @@ public:
 
     // Encrypt `size` bytes from byte buffer `src` and return a bytevector with the encrypted data.
     bytevector encrypt(const byte* src, size_t size) {
-        bytevector output(size + prefixLength());
+        bytevector output(size + Derived::prefixLength());
         static_cast<Derived*>(this)->encryptInto(src, output.data(), size);
         return output;
     }
@@ -93,19 +106,49 @@ public:
         return encrypt(reinterpret_cast<const byte*>(src.data()), src.size());
     }
 
+    // Encrypt `count` messages in place, each buffer must be at least `size + prefixLength()` bytes big.
+    // All nonces are generated with a single call to the RNG, which is cheaper than one call per message.
+    void encryptInPlaceBatch(CryptoBatchItem* items, size_t count) {
+        constexpr size_t NONCES = Derived::nonceLength();
+        constexpr size_t STACK_NONCES = 32;
+
+        byte stackNonces[STACK_NONCES * NONCES];
+        std::vector<byte> heapNonces;
+
+        byte* nonces = stackNonces;
+        if (count > STACK_NONCES) {
+            heapNonces.resize(count * NONCES);
+            nonces = heapNonces.data();
+        }
+
+        util::crypto::secureRandom(nonces, count * NONCES);
+
+        for (size_t i = 0; i < count; i++) {
+            auto& item = items[i];
+            item.size = static_cast<Derived*>(this)->encryptIntoWithNonce(item.data, item.data, item.size, nonces + i * NONCES);
+        }
+    }
+
     /* Decryption */
 
     // Decrypt `size` bytes from `data` into itself. Returns the length of the plaintext data.
     size_t decryptInPlace(byte* data, size_t size) {
         // overwriting nonce causes decryption to break
         // so we offset the destination by NONCE_LEN and then move it back
-        size_t plaintext_size = static_cast<Derived*>(this)->decryptInto(data, data + nonceLength(), size);
+        size_t plaintext_size = static_cast<Derived*>(this)->decryptInto(data, data + Derived::nonceLength(), size);
 
-        std::memmove(data, data + nonceLength(), plaintext_size);
+        std::memmove(data, data + Derived::nonceLength(), plaintext_size);
 
         return plaintext_size;
     }
 
+    // Decrypt `count` messages in place, counterpart of `encryptInPlaceBatch`.
+    void decryptInPlaceBatch(CryptoBatchItem* items, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            items[i].size = this->decryptInPlace(items[i].data, items[i].size);
+        }
+    }
+
     // Decrypt bytes from bytevector `src` and return a bytevector with the plaintext data.
     bytevector decrypt(const bytevector& src) {
         return decrypt(src.data(), src.size());
@@ -113,7 +156,7 @@ public:
 
     // Decrypt `size` bytes from byte buffer `src` and return a bytevector with the plaintext data.
     bytevector decrypt(const byte* src, size_t size) {
-        size_t plaintextLength = size - prefixLength();
+        size_t plaintextLength = size - Derived::prefixLength();
 
         bytevector plaintext(plaintextLength);
         static_cast<Derived*>(this)->decryptInto(src, plaintext.data(), size);
@@ -89,10 +89,30 @@ void CryptoBox::setPeerKey(const byte* key) {
     CRYPTO_ERR_CHECK(func_box_beforenm(sharedKey, peerPublicKey, secretKey), "func_box_beforenm failed")
 }
 
+bytevector CryptoBox::deriveSessionKey() {
+    // the key is the keystream for a fixed nonce, i.e. the encryption of zeroes. regular packets use random nonces,
+    // so this nonce is never used for anything else. must match `SESSION_KEY_NONCE` on the server
+    static constexpr byte SESSION_KEY_NONCE[NONCE_LEN] = {'g', 'l', 'o', 'b', 'e', 'd', ' ', 's', 'e', 's', 's', 'i', 'o', 'n', ' ', 'k', 'e', 'y'};
+
+    byte zeroes[KEY_LEN] = {};
+    byte out[KEY_LEN + MAC_LEN];
+    CRYPTO_ERR_CHECK(func_box_easy(out, zeroes, KEY_LEN, SESSION_KEY_NONCE, sharedKey), "func_box_easy failed")
+
+    // skip the mac
+    bytevector key(out + MAC_LEN, out + MAC_LEN + KEY_LEN);
+    sodium_memzero(out, sizeof(out));
+
+    return key;
+}
+
 size_t CryptoBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
     util::crypto::secureRandom(nonce, NONCE_LEN);
 
+    return this->encryptIntoWithNonce(src, dest, size, nonce);
+}
+
+size_t CryptoBox::encryptIntoWithNonce(const byte* src, byte* dest, size_t size, const byte* nonce) {
     byte* ciphertext = dest + NONCE_LEN;
     CRYPTO_ERR_CHECK(func_box_easy(ciphertext, src, size, nonce, sharedKey), "func_box_easy failed")
 
@@ -28,7 +28,13 @@ public:
     // This precomputes the shared key and stores it for use in all future operations.
     void setPeerKey(const util::data::byte* src);
 
+    // Derives a symmetric key (`KEY_LEN` bytes) for a `SessionBox` from the shared key, must be called after `setPeerKey`.
+    // The server derives the same key on its side, so it never has to be sent.
+    util::data::bytevector deriveSessionKey();
+
     size_t encryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
+    // Like `encryptInto` but with a caller provided nonce (`nonceLength()` bytes), which must never be reused with the same key.
+    size_t encryptIntoWithNonce(const util::data::byte* src, util::data::byte* dest, size_t size, const util::data::byte* nonce);
     size_t decryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
 
 private: // nuh uh
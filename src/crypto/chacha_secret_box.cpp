@@ -36,6 +36,10 @@ size_t ChaChaSecretBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
     util::crypto::secureRandom(nonce, NONCE_LEN);
 
+    return this->encryptIntoWithNonce(src, dest, size, nonce);
+}
+
+size_t ChaChaSecretBox::encryptIntoWithNonce(const byte* src, byte* dest, size_t size, const byte* nonce) {
     byte* mac = dest + NONCE_LEN;
     byte* ciphertext = mac + MAC_LEN;
 
@@ -61,6 +65,14 @@ size_t ChaChaSecretBox::decryptInto(const byte* src, byte* dest, size_t size) {
     return plaintextLength;
 }
 
+void ChaChaSecretBox::encryptDetached(const byte* src, byte* dest, byte* mac, size_t size, const byte* nonce) {
+    CRYPTO_ERR_CHECK(crypto_secretbox_xchacha20poly1305_detached(dest, mac, src, size, nonce, key), "crypto_secretbox_xchacha20poly1305_detached failed")
+}
+
+bool ChaChaSecretBox::decryptDetached(const byte* src, byte* dest, const byte* mac, size_t size, const byte* nonce) {
+    return crypto_secretbox_xchacha20poly1305_open_detached(dest, src, mac, size, nonce, key) == 0;
+}
+
 void ChaChaSecretBox::setKey(const util::data::bytevector& src) {
     GLOBED_REQUIRE(src.size() == crypto_secretbox_KEYBYTES, "key size is too small or too big for ChaChaSecretBox")
     setKey(src.data());
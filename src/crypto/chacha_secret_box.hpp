@@ -18,8 +18,16 @@ public:
     static ChaChaSecretBox withPassword(const std::string_view pw);
 
     size_t encryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
+    // Like `encryptInto` but with a caller provided nonce (`nonceLength()` bytes), which must never be reused with the same key.
+    size_t encryptIntoWithNonce(const util::data::byte* src, util::data::byte* dest, size_t size, const util::data::byte* nonce);
     size_t decryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
 
+    // Encrypt `size` bytes from `src` into `dest` with a caller provided nonce (`NONCE_LEN` bytes), writing the tag into `mac` (`MAC_LEN` bytes).
+    // The nonce must never be reused with the same key. `src` and `dest` must be either the same pointer or not overlap at all.
+    void encryptDetached(const util::data::byte* src, util::data::byte* dest, util::data::byte* mac, size_t size, const util::data::byte* nonce);
+    // Decrypt and verify `size` bytes from `src` into `dest`, returns false if the tag doesn't match. Same rules for `src` and `dest` as `encryptDetached`.
+    bool decryptDetached(const util::data::byte* src, util::data::byte* dest, const util::data::byte* mac, size_t size, const util::data::byte* nonce);
+
     void setKey(const util::data::bytevector& src);
     void setKey(const util::data::byte* src);
     // hashes the password and initializes the secret key with the hash
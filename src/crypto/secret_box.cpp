@@ -36,6 +36,10 @@ size_t SecretBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
     util::crypto::secureRandom(nonce, NONCE_LEN);
 
+    return this->encryptIntoWithNonce(src, dest, size, nonce);
+}
+
+size_t SecretBox::encryptIntoWithNonce(const byte* src, byte* dest, size_t size, const byte* nonce) {
     byte* ciphertext = dest + NONCE_LEN;
     CRYPTO_ERR_CHECK(crypto_secretbox_easy(ciphertext, src, size, nonce, key), "crypto_secretbox_easy failed")
 
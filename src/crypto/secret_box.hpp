@@ -16,6 +16,8 @@ public:
     static SecretBox withPassword(const std::string_view pw);
 
     size_t encryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
+    // Like `encryptInto` but with a caller provided nonce (`nonceLength()` bytes), which must never be reused with the same key.
+    size_t encryptIntoWithNonce(const util::data::byte* src, util::data::byte* dest, size_t size, const util::data::byte* nonce);
     size_t decryptInto(const util::data::byte* src, util::data::byte* dest, size_t size);
 
     void setKey(const util::data::bytevector& src);
@@ -0,0 +1,156 @@
+#include "session_box.hpp"
+
+#include <cstring> // std::memcpy, std::memmove
+
+#include <util/crypto.hpp>
+#include <defs/assert.hpp>
+#include <defs/minimal_geode.hpp>
+
+using namespace util::data;
+
+// must match the server
+constexpr byte DIRECTION_CLIENT = 1;
+constexpr byte DIRECTION_SERVER = 2;
+
+static_assert(ChaChaSecretBox::MAC_LEN == AesGcmSecretBox::MAC_LEN);
+
+static std::variant<ChaChaSecretBox, AesGcmSecretBox> makeBox(const bytevector& key, SessionCipher cipher) {
+    // neither box can be moved, so construct it in place
+    if (cipher == SessionCipher::Aes256Gcm) {
+        return std::variant<ChaChaSecretBox, AesGcmSecretBox>(std::in_place_type<AesGcmSecretBox>, key);
+    } else {
+        return std::variant<ChaChaSecretBox, AesGcmSecretBox>(std::in_place_type<ChaChaSecretBox>, key);
+    }
+}
+
+SessionBox::SessionBox(const bytevector& key, bool isClient, SessionCipher cipher)
+    : box(makeBox(key, cipher)),
+      sendDirection(isClient ? DIRECTION_CLIENT : DIRECTION_SERVER),
+      recvDirection(isClient ? DIRECTION_SERVER : DIRECTION_CLIENT) {}
+
+uint8_t SessionBox::supportedCiphers() {
+    uint8_t mask = 1 << (uint8_t) SessionCipher::XChaCha20Poly1305;
+
+    if (AesGcmSecretBox::isAvailable()) {
+        mask |= 1 << (uint8_t) SessionCipher::Aes256Gcm;
+    }
+
+    return mask;
+}
+
+SessionCipher SessionBox::getCipher() {
+    return std::holds_alternative<AesGcmSecretBox>(box) ? SessionCipher::Aes256Gcm : SessionCipher::XChaCha20Poly1305;
+}
+
+template <typename Box>
+void SessionBox::makeNonce(byte* nonce, byte direction, uint32_t counter) {
+    // [direction, 0 ..., counter (big endian)]
+    std::memset(nonce, 0, Box::NONCE_LEN);
+    nonce[0] = direction;
+
+    uint32_t be = maybeByteswap(counter);
+    std::memcpy(nonce + Box::NONCE_LEN - COUNTER_LEN, &be, COUNTER_LEN);
+}
+
+size_t SessionBox::encryptInPlace(byte* data, size_t size) {
+    uint32_t counter = sendCounter.fetch_add(1);
+
+    // wrapping around would reuse nonces, five billion packets is well beyond any real session though
+    CRYPTO_REQUIRE(counter != UINT32_MAX, "session counter exhausted")
+
+    return this->encryptWithCounter(data, size, counter);
+}
+
+void SessionBox::encryptInPlaceBatch(CryptoBatchItem* items, size_t count) {
+    if (count == 0) return;
+
+    uint32_t first = sendCounter.fetch_add(count);
+    CRYPTO_REQUIRE(first <= UINT32_MAX - count, "session counter exhausted")
+
+    for (size_t i = 0; i < count; i++) {
+        items[i].size = this->encryptWithCounter(items[i].data, items[i].size, first + i);
+    }
+}
+
+size_t SessionBox::encryptWithCounter(byte* data, size_t size, uint32_t counter) {
+    byte* mac = data + COUNTER_LEN;
+    byte* ciphertext = mac + MAC_LEN;
+
+    // move the plaintext out of the way first, only exact in-place encryption is safe for every cipher
+    std::memmove(ciphertext, data, size);
+
+    std::visit([&]<typename Box>(Box& impl) {
+        byte nonce[Box::NONCE_LEN];
+        makeNonce<Box>(nonce, sendDirection, counter);
+
+        impl.encryptDetached(ciphertext, ciphertext, mac, size, nonce);
+    }, box);
+
+    uint32_t be = maybeByteswap(counter);
+    std::memcpy(data, &be, COUNTER_LEN);
+
+    return size + PREFIX_LEN;
+}
+
+std::optional<size_t> SessionBox::decryptInPlace(byte* data, size_t size) {
+    CRYPTO_REQUIRE(size >= PREFIX_LEN, "message is too short")
+
+    uint32_t counter;
+    std::memcpy(&counter, data, COUNTER_LEN);
+    counter = maybeByteswap(counter);
+
+    if (this->isReplay(counter)) {
+        return std::nullopt;
+    }
+
+    size_t plaintextLength = size - PREFIX_LEN;
+    const byte* mac = data + COUNTER_LEN;
+    byte* ciphertext = data + PREFIX_LEN;
+
+    bool verified = std::visit([&]<typename Box>(Box& impl) {
+        byte nonce[Box::NONCE_LEN];
+        makeNonce<Box>(nonce, recvDirection, counter);
+
+        return impl.decryptDetached(ciphertext, ciphertext, mac, plaintextLength, nonce);
+    }, box);
+
+    CRYPTO_REQUIRE(verified, "session packet failed verification")
+
+    // only remember the counter once we know the packet is genuine
+    this->markReceived(counter);
+
+    std::memmove(data, ciphertext, plaintextLength);
+
+    return plaintextLength;
+}
+
+uint32_t SessionBox::lastReceivedCounter() {
+    return highestReceived;
+}
+
+bool SessionBox::isReplay(uint32_t counter) {
+    if (receivedMask == 0 || counter > highestReceived) {
+        return false;
+    }
+
+    uint32_t age = highestReceived - counter;
+    if (age >= REPLAY_WINDOW) {
+        return true;
+    }
+
+    return (receivedMask >> age) & 1;
+}
+
+void SessionBox::markReceived(uint32_t counter) {
+    if (receivedMask == 0) {
+        highestReceived = counter;
+        receivedMask = 1;
+    } else if (counter > highestReceived) {
+        uint32_t shift = counter - highestReceived;
+        receivedMask = shift >= REPLAY_WINDOW ? 0 : receivedMask << shift;
+        receivedMask |= 1;
+        highestReceived = counter;
+    } else {
+        receivedMask |= uint64_t(1) << (highestReceived - counter);
+    }
+}
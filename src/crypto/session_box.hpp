@@ -0,0 +1,80 @@
+#pragma once
+#include "chacha_secret_box.hpp"
+#include "aes_gcm_secret_box.hpp"
+
+#include <atomic>
+#include <optional>
+#include <variant>
+
+/*
+* SessionBox - symmetric box for UDP packets, keyed once per connection with `CryptoBox::deriveSessionKey`
+*
+* Algorithm - XChaCha20Poly1305 (through `ChaChaSecretBox`), or AES256-GCM (through `AesGcmSecretBox`) if both sides have hardware support
+* Nonce - implicit, made of the sending direction and a 32-bit counter. Only the counter is sent.
+* Tag implementation - detached, after the counter
+*
+* Compared to `CryptoBox`, this saves 20 bytes per packet and does not need random numbers for every packet.
+* The counter also protects against replayed packets.
+*/
+
+// must match the server, values are also bit indices in the mask returned by `SessionBox::supportedCiphers`
+enum class SessionCipher : uint8_t {
+    XChaCha20Poly1305 = 0,
+    Aes256Gcm = 1,
+};
+
+class SessionBox {
+public:
+    using byte = util::data::byte;
+
+    static constexpr size_t KEY_LEN = ChaChaSecretBox::KEY_LEN;
+    // same for both ciphers
+    static constexpr size_t COUNTER_LEN = sizeof(uint32_t);
+    static constexpr size_t MAC_LEN = ChaChaSecretBox::MAC_LEN;
+    static constexpr size_t PREFIX_LEN = COUNTER_LEN + MAC_LEN;
+
+    // packets with a counter this far behind the newest one are rejected, in case they got reordered that much
+    static constexpr uint32_t REPLAY_WINDOW = 64;
+
+    // `isClient` decides which direction is used for sending and which for receiving, the server uses the opposite
+    SessionBox(const util::data::bytevector& key, bool isClient, SessionCipher cipher = SessionCipher::XChaCha20Poly1305);
+    SessionBox(const SessionBox&) = delete;
+    SessionBox& operator=(const SessionBox&) = delete;
+
+    // Encrypt `size` bytes from `data` into itself. The buffer must be at least `size + PREFIX_LEN` bytes big.
+    // Returns the length of the encrypted data. May be called from multiple threads.
+    size_t encryptInPlace(byte* data, size_t size);
+
+    // Encrypt `count` messages in place, takes all the counters at once. Same requirements as `encryptInPlace`.
+    void encryptInPlaceBatch(CryptoBatchItem* items, size_t count);
+
+    // Decrypt `size` bytes from `data` into itself. Returns the length of the plaintext data,
+    // or `std::nullopt` if the packet was already received or is too old. Throws if the packet was tampered with.
+    // Must only be called from one thread.
+    std::optional<size_t> decryptInPlace(byte* data, size_t size);
+
+    // bitmask of ciphers this device can use, sent to the server during the handshake
+    static uint8_t supportedCiphers();
+
+    SessionCipher getCipher();
+
+    // counter of the newest packet received so far, also useful as a sequence number
+    uint32_t lastReceivedCounter();
+
+private:
+    std::variant<ChaChaSecretBox, AesGcmSecretBox> box;
+    byte sendDirection, recvDirection;
+
+    std::atomic<uint32_t> sendCounter = 0;
+
+    // bit `i` is set if the packet `highestReceived - i` was received
+    uint64_t receivedMask = 0;
+    uint32_t highestReceived = 0;
+
+    size_t encryptWithCounter(byte* data, size_t size, uint32_t counter);
+
+    template <typename Box>
+    static void makeNonce(byte* nonce, byte direction, uint32_t counter);
+    bool isReplay(uint32_t counter);
+    void markReceived(uint32_t counter);
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <boost/describe.hpp>
+#include <type_traits>
 
 // Various macros for data serialization
 
@@ -13,3 +14,11 @@
 #define GLOBED_SERIALIZABLE_CLASS(name, ...) BOOST_DESCRIBE_CLASS(name, __VA_ARGS__)
 #define GLOBED_SERIALIZABLE_BITFIELD(name, ...) BOOST_DESCRIBE_STRUCT(name, (BitfieldBase), __VA_ARGS__)
 
+// Structs serialized with `GLOBED_SERIALIZABLE_PACKED_STRUCT` get all of their bool members packed into a single bit-field,
+// which is written in place of the first bool member. All other members are encoded as usual, in the same order.
+template <typename T>
+struct SerializePackedBools : std::false_type {};
+
+#define GLOBED_SERIALIZABLE_PACKED_STRUCT(name, ...) \
+    GLOBED_SERIALIZABLE_STRUCT(name, __VA_ARGS__) \
+    template <> struct SerializePackedBools<name> : std::true_type {};
@@ -1,5 +1,7 @@
 #include "bytebuffer.hpp"
 
+#include <bit>
+
 #include <boost/describe.hpp>
 
 template <typename T = std::monostate>
@@ -18,6 +20,7 @@ const char* ByteBuffer::strerror(DecodeError err) {
         case Error::InvalidEnumValue: return "Invalid enum value was read";
         case Error::DataTooLong: return "Received data is too long so packet decoding was halted";
         case Error::LengthPrefixTooLong: return "Datatype has an invalid length prefix, failed to decode packet";
+        case Error::InvalidVarint: return "Varint is too long or does not fit into its type";
     }
 
     return "Unknown error";
@@ -32,7 +35,24 @@ ByteBuffer::ByteBuffer(const byte* data, size_t length)
 ByteBuffer::ByteBuffer(bytevector&& data)
     : _data(std::move(data)) {}
 
+ByteBuffer ByteBuffer::view(byte* data, size_t length) {
+    ByteBuffer buf;
+    buf._view = data;
+    buf._viewSize = length;
+    return buf;
+}
+
+void ByteBuffer::materialize() {
+    if (!_view) return;
+
+    _data.assign(_view, _view + _viewSize);
+    _view = nullptr;
+    _viewSize = 0;
+}
+
 void ByteBuffer::rawWriteBytes(const byte* bytes, size_t length) {
+    this->materialize();
+
     // if we can't fit (i.e. writing at the end, just use insert)
     if (_position + length > _data.size()) {
         _data.insert(_data.begin() + _position, bytes, bytes + length);
@@ -49,7 +69,7 @@ void ByteBuffer::rawWriteBytes(const byte* bytes, size_t length) {
 }
 
 DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
-    if (_position + count > _data.size()) {
+    if (_position + count > this->size()) {
         return Err(DecodeError::NotEnoughData);
     }
 
@@ -59,20 +79,37 @@ DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
 /* Util methods */
 
 const bytevector& ByteBuffer::data() const {
+    // contents stay the same, only the storage changes
+    const_cast<ByteBuffer*>(this)->materialize();
     return _data;
 }
 
 bytevector& ByteBuffer::data() {
+    this->materialize();
     return _data;
 }
 
+byte* ByteBuffer::rawData() {
+    return _view ? _view : _data.data();
+}
+
+const byte* ByteBuffer::rawData() const {
+    return _view ? _view : _data.data();
+}
+
+bool ByteBuffer::isView() const {
+    return _view != nullptr;
+}
+
 void ByteBuffer::clear() {
     _data.clear();
+    _view = nullptr;
+    _viewSize = 0;
     _position = 0;
 }
 
 size_t ByteBuffer::size() const {
-    return _data.size();
+    return _view ? _viewSize : _data.size();
 }
 
 size_t ByteBuffer::getPosition() const {
@@ -84,9 +121,21 @@ void ByteBuffer::setPosition(size_t pos) {
 }
 
 void ByteBuffer::resize(size_t newSize) {
+    // shrinking a view does not need a copy
+    if (_view && newSize <= _viewSize) {
+        _viewSize = newSize;
+        return;
+    }
+
+    this->materialize();
     _data.resize(newSize);
 }
 
+void ByteBuffer::reserve(size_t capacity) {
+    this->materialize();
+    _data.reserve(capacity);
+}
+
 void ByteBuffer::grow(size_t bytes) {
     this->resize(this->size() + bytes);
 }
@@ -104,7 +153,7 @@ DecodeResult<> ByteBuffer::skip(size_t bytes) {
 
 DecodeResult<> ByteBuffer::readBytesInto(byte* buf, size_t bytes) {
     GLOBED_UNWRAP(this->boundsCheck(bytes));
-    std::memcpy(buf, _data.data() + _position, bytes);
+    std::memcpy(buf, this->rawData() + _position, bytes);
     _position += bytes;
 
     return Ok();
@@ -128,12 +177,23 @@ template<> DecodeResult<std::string> ByteBuffer::customDecode() {
 
     GLOBED_UNWRAP(this->boundsCheck(length));
 
-    std::string str(reinterpret_cast<const char*>(_data.data() + _position), length);
+    std::string str(reinterpret_cast<const char*>(this->rawData() + _position), length);
     _position += length;
 
     return Ok(std::move(str));
 }
 
+DecodeResult<> ByteBuffer::readStringInto(std::string& out) {
+    GLOBED_UNWRAP_INTO(this->readLength(), size_t length);
+
+    GLOBED_UNWRAP(this->boundsCheck(length));
+
+    out.assign(reinterpret_cast<const char*>(this->rawData() + _position), length);
+    _position += length;
+
+    return Ok();
+}
+
 // CCPoint
 
 template<> void ByteBuffer::customEncode(const CCPoint& point) {
@@ -253,3 +313,43 @@ DecodeResult<size_t> ByteBuffer::readLengthCheck(size_t elemsize) {
 void ByteBuffer::writeLength(size_t value) {
     this->writePrimitive<length_t>(static_cast<length_t>(value));
 }
+
+void ByteBuffer::writeVarUint(uint64_t value) {
+    byte bytes[MAX_VARINT_SIZE];
+    size_t count = 0;
+
+    while (value >= 0x80) {
+        bytes[count++] = static_cast<byte>(value) | 0x80;
+        value >>= 7;
+    }
+
+    bytes[count++] = static_cast<byte>(value);
+
+    this->rawWriteBytes(bytes, count);
+}
+
+DecodeResult<uint64_t> ByteBuffer::readVarUint() {
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < MAX_VARINT_SIZE; i++) {
+        GLOBED_UNWRAP_INTO(this->readU8(), uint8_t part);
+
+        // the 10th byte only has room for the top bit of a u64, anything more would overflow
+        if (i == MAX_VARINT_SIZE - 1 && part > 1) {
+            return Err(DecodeError::InvalidVarint);
+        }
+
+        value |= static_cast<uint64_t>(part & 0x7f) << (i * 7);
+
+        if ((part & 0x80) == 0) {
+            return Ok(value);
+        }
+    }
+
+    return Err(DecodeError::InvalidVarint);
+}
+
+size_t ByteBuffer::varUintSize(uint64_t value) {
+    // each byte holds 7 bits, zero still takes up one byte
+    return (std::bit_width(value | 1) + 6) / 7;
+}
@@ -3,12 +3,14 @@
 #include <defs/minimal_geode.hpp>
 
 #include <type_traits>
+#include <limits>
 #include <fmt/format.h>
 
 #include "basic.hpp"
 #include "types/basic/either.hpp"
 #include "bitbuffer.hpp"
 #include "bitfield.hpp"
+#include <util/adler32.hpp>
 #include <util/data.hpp>
 #include <util/misc.hpp>
 
@@ -22,7 +24,8 @@ public:
         NotEnoughData,
         InvalidEnumValue,
         DataTooLong,
-        LengthPrefixTooLong
+        LengthPrefixTooLong,
+        InvalidVarint,
     };
 
     BOOST_DESCRIBE_NESTED_ENUM(DecodeError, Ok, NotEnoughData, InvalidEnumValue);
@@ -42,6 +45,11 @@ public:
     // Take ownership of the given `bytevector` and construct a `ByteBuffer` from the data
     ByteBuffer(util::data::bytevector&& data);
 
+    // Construct a non-owning `ByteBuffer` that reads directly from `data`. No copy is made,
+    // so the caller must keep the memory alive for as long as this buffer is used.
+    // Any write, or a call to `data()`, will copy the contents into an owned buffer first.
+    static ByteBuffer view(util::data::byte* data, size_t length);
+
     ByteBuffer(const ByteBuffer& other) = default;
     ByteBuffer& operator=(const ByteBuffer& other) = default;
 
@@ -68,6 +76,24 @@ public:
         }
     }
 
+    // Read a value into an existing object. Unlike `readValue`, this reuses the storage of `out` where possible
+    // (vectors keep their capacity and their elements are decoded in place). On error `out` may be partially overwritten.
+    template <typename T>
+    DecodeResult<> readValueInto(T& out) {
+        if constexpr (boost::describe::has_describe_members<T>::value && !isBitfieldStruct<T>()) {
+            return this->reflectionDecodeInto<T>(out);
+        } else if constexpr (util::misc::IsStdVector<T>::value) {
+            return this->pcDecodeVectorInto<typename T::value_type>(out);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return this->readStringInto(out);
+        } else if constexpr (requires { T::CUSTOM_DECODE_INTO; }) {
+            return this->customDecodeInto<T>(out);
+        } else {
+            GLOBED_UNWRAP_INTO(this->readValue<T>(), out);
+            return Ok();
+        }
+    }
+
     // Write a value to this bytebuffer
     template <typename T>
     void writeValue(const T& value) {
@@ -85,10 +111,96 @@ public:
         }
     }
 
+    // Returns how many bytes `value` takes up when encoded. For fixed-size types, this folds into a compile-time constant.
+    // Types with a custom encoder can declare `static constexpr size_t ENCODED_SIZE_HINT`, otherwise they count as 0 bytes,
+    // so the result should be used as a hint (i.e. for reserving space) and not as an exact size.
+    template <typename T>
+    static constexpr size_t encodedSizeHint(const T& value) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            return sizeof(T);
+        } else if constexpr (std::is_enum_v<T>) {
+            return sizeof(std::underlying_type_t<T>);
+        } else if constexpr (std::is_empty_v<T>) {
+            return 0;
+        } else if constexpr (requires { T::ENCODED_SIZE_HINT; }) {
+            return T::ENCODED_SIZE_HINT;
+        } else if constexpr (boost::describe::has_describe_members<T>::value) {
+            if constexpr (isBitfieldStruct<T>()) {
+                return util::data::bitsToBytes(sizeof(T));
+            } else {
+                size_t total = 0;
+                boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                    using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+                    if constexpr (!SerializePackedBools<T>::value || !std::is_same_v<FT, bool>) {
+                        total += encodedSizeHint(value.*descriptor.pointer);
+                    }
+                });
+
+                if constexpr (SerializePackedBools<T>::value) {
+                    total += util::data::bitsToBytes(packedBoolCount<T>());
+                }
+
+                return total;
+            }
+        } else if constexpr (util::misc::IsStdVector<T>::value) {
+            size_t total = sizeof(length_t);
+            for (const auto& elem : value) {
+                total += encodedSizeHint(elem);
+            }
+
+            return total;
+        } else if constexpr (util::misc::IsStdArray<T>::value) {
+            size_t total = 0;
+            for (const auto& elem : value) {
+                total += encodedSizeHint(elem);
+            }
+
+            return total;
+        } else if constexpr (util::misc::IsStdPair<T>::value) {
+            return encodedSizeHint(value.first) + encodedSizeHint(value.second);
+        } else if constexpr (util::misc::IsStdOptional<T>::value) {
+            return sizeof(bool) + (value.has_value() ? encodedSizeHint(value.value()) : 0);
+        } else if constexpr (util::misc::IsEither<T>::value) {
+            return sizeof(bool) + (value.isFirst() ? encodedSizeHint(value.firstRef()->get()) : encodedSizeHint(value.secondRef()->get()));
+        } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> || util::misc::IsInlineString<T>::value) {
+            return sizeof(length_t) + value.size();
+        } else if constexpr (util::misc::IsVarint<T>::value) {
+            return varUintSize(T::zigzag(value.get()));
+        } else if constexpr (std::is_same_v<T, cocos2d::CCPoint> || std::is_same_v<T, cocos2d::CCSize>) {
+            return sizeof(float) * 2;
+        } else if constexpr (std::is_same_v<T, cocos2d::ccColor3B>) {
+            return 3;
+        } else if constexpr (std::is_same_v<T, cocos2d::ccColor4B>) {
+            return 4;
+        } else if constexpr (std::is_same_v<T, ByteBuffer>) {
+            return value.size();
+        } else {
+            return 0;
+        }
+    }
+
+    // Like `writeValue` and `readValue` for described structs, but always encode one member at a time,
+    // skipping the fixed size fast path. Only meant for benchmarking the two paths against each other.
+    template <typename T>
+    void writeValueFieldwise(const T& value) {
+        this->reflectionEncodeFields<T>(value);
+    }
+
+    template <typename T>
+    DecodeResult<T> readValueFieldwise() {
+        return this->reflectionDecodeFields<T>();
+    }
+
     // Read a commonly encodable type. Can be specialized for any type to enable decoding ability.
     template <typename T>
     DecodeResult<T> customDecode();
 
+    // Read a commonly encodable type into an existing object, used by `readValueInto`. Types that specialize this
+    // must declare `static constexpr bool CUSTOM_DECODE_INTO = true`.
+    template <typename T>
+    DecodeResult<> customDecodeInto(T& out);
+
     // Write a commonly encodable type. Can be specialized for any type to enable encoding ability.
     template <typename T>
     void customEncode(const T& value);
@@ -101,6 +213,13 @@ public:
     // Get the underlying data buffer of this `ByteBuffer`
     util::data::bytevector& data();
 
+    // Get a pointer to the contents of this `ByteBuffer`. Unlike `data()`, never copies in view mode.
+    util::data::byte* rawData();
+    const util::data::byte* rawData() const;
+
+    // Returns whether this `ByteBuffer` is a non-owning view over external memory
+    bool isView() const;
+
     // Clear all the data in this buffer
     void clear();
 
@@ -116,6 +235,9 @@ public:
     // Resize the internal buffer to `newSize` bytes
     void resize(size_t newSize);
 
+    // Reserve space for at least `capacity` bytes in total
+    void reserve(size_t capacity);
+
     // Equivalent to `resize(size() + bytes)`
     void grow(size_t bytes);
 
@@ -159,6 +281,15 @@ public:
     void writeF64(double value);
     void writeLength(size_t value);
 
+    /* Varints (LEB128, see `Varint`) */
+    static constexpr size_t MAX_VARINT_SIZE = 10;
+
+    void writeVarUint(uint64_t value);
+    DecodeResult<uint64_t> readVarUint();
+
+    // Amount of bytes `value` takes up when written with `writeVarUint`
+    static size_t varUintSize(uint64_t value);
+
     /* Bits */
     template <size_t N>
     void writeBits(const BitBuffer<N>& bits) {
@@ -174,6 +305,9 @@ public:
     /* Raw reads */
     DecodeResult<> readBytesInto(util::data::byte* buf, size_t bytes);
 
+    // Read a string into `out`, reusing its buffer if it's big enough
+    DecodeResult<> readStringInto(std::string& out);
+
 protected:
     // Read `sizeof(T)` bytes and reinterpret them as `T`. No endianness conversions are done.
     template <typename T>
@@ -181,7 +315,7 @@ protected:
         GLOBED_UNWRAP(this->boundsCheck(sizeof(T)));
 
         T value;
-        std::memcpy(&value, _data.data() + _position, sizeof(T));
+        std::memcpy(&value, this->rawData() + _position, sizeof(T));
         _position += sizeof(T);
 
         return Ok(value);
@@ -231,19 +365,7 @@ protected:
         GLOBED_UNWRAP_INTO(this->readPrimitive<P>(), P underlying);
 
         // validate the enum - if there's no descriptor matching the decoded value, raise an error
-
-        bool foundMatch = false;
-
-        boost::mp11::mp_for_each<boost::describe::describe_enumerators<E>>([&](auto descriptor) {
-            E val = descriptor.value;
-            P valUnderlying = static_cast<P>(val);
-
-            if (valUnderlying == underlying) {
-                foundMatch = true;
-            }
-        });
-
-        if (!foundMatch) {
+        if (!isValidEnumValue<E>(underlying)) {
             return Err(DecodeError::InvalidEnumValue);
         }
 
@@ -281,6 +403,25 @@ protected:
             checkMissingFields<T>();
         }
 
+        if constexpr (SerializePackedBools<T>::value) {
+            T value;
+            GLOBED_UNWRAP(this->reflectionDecodePackedInto<T>(value));
+            return Ok(std::move(value));
+        } else if constexpr (isFixedSize<T>()) {
+            T value;
+            GLOBED_UNWRAP(this->readFixedInto<T>(value));
+            return Ok(std::move(value));
+        } else {
+            return this->reflectionDecodeFields<T>();
+        }
+    }
+
+    // Read a value using boost reflection, decoding each member separately. Prefer `reflectionDecode`.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    DecodeResult<T> reflectionDecodeFields() {
         // create a default initialized instance
         T value;
 
@@ -310,6 +451,54 @@ protected:
         return Ok(std::move(value));
     }
 
+    template <typename T, class Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>>
+    static constexpr bool isBitfieldStruct() {
+        if constexpr (!boost::mp11::mp_empty<Bd>::value) {
+            return std::is_same_v<typename boost::mp11::mp_first<Bd>::type, BitfieldBase>;
+        } else {
+            return false;
+        }
+    }
+
+    // Like `reflectionDecode` but decodes every member in place
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>,
+        class Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>
+    >
+    DecodeResult<> reflectionDecodeInto(T& value) {
+        static_assert(std::is_class_v<T>, "attempted to call reflectionDecodeInto on a non-class type");
+
+        if constexpr (boost::mp11::mp_empty<Bd>::value) {
+            checkMissingFields<T>();
+        }
+
+        if constexpr (SerializePackedBools<T>::value) {
+            return this->reflectionDecodePackedInto<T>(value);
+        } else if constexpr (isFixedSize<T>()) {
+            return this->readFixedInto<T>(value);
+        }
+
+        bool failed = false;
+        DecodeError failError;
+
+        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) -> void {
+            if (failed) return;
+
+            auto result = this->readValueInto(value.*descriptor.pointer);
+            if (result.isErr()) {
+                failed = true;
+                failError = result.unwrapErr();
+            }
+        });
+
+        if (failed) {
+            return Err(std::move(failError));
+        }
+
+        return Ok();
+    }
+
     // Write a value using boost reflection
     template <
         typename T,
@@ -329,11 +518,499 @@ protected:
             checkMissingFields<T>();
         }
 
+        if constexpr (SerializePackedBools<T>::value) {
+            this->reflectionEncodePacked<T>(value);
+        } else if constexpr (isFixedSize<T>()) {
+            this->writeFixed<T>(value);
+        } else {
+            this->reflectionEncodeFields<T>(value);
+        }
+    }
+
+    // Write a value using boost reflection, encoding each member separately. Prefer `reflectionEncode`.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    void reflectionEncodeFields(const T& value) {
         boost::mp11::mp_for_each<Md>([&, this](auto descriptor) {
             this->writeValue(value.*descriptor.pointer);
         });
     }
 
+    // Whether `T` is a primitive, or a described struct made only of such types (recursively).
+    // The encoded size of these types is known at compile time, see `fixedEncodedSize`.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>,
+        class Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>
+    >
+    static constexpr bool isFixedSize() {
+        if constexpr (util::data::IsPrimitive<T>) {
+            return true;
+        } else if constexpr (boost::describe::has_describe_members<T>::value && !std::is_empty_v<T>) {
+            // bitfields and packed bools have their own encoding, and members of bases are not described
+            if constexpr (!boost::mp11::mp_empty<Bd>::value || SerializePackedBools<T>::value) {
+                return false;
+            } else {
+                bool fixed = true;
+                boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                    using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+                    if constexpr (!isFixedSize<FT>()) {
+                        fixed = false;
+                    }
+                });
+
+                return fixed;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    // Whether a vector of `T` can be encoded and decoded in bulk. `std::vector<bool>` can't hand out references to its elements.
+    template <typename T>
+    static constexpr bool isFixedSizeElement() {
+        return isFixedSize<T>() && std::is_default_constructible_v<T> && !std::is_same_v<T, bool>;
+    }
+
+    // Encoded size of a type for which `isFixedSize` is true
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static constexpr size_t fixedEncodedSize() {
+        static_assert(isFixedSize<T>(), "fixedEncodedSize called on a type that is not fixed size");
+
+        if constexpr (util::data::IsPrimitive<T>) {
+            return sizeof(T);
+        } else {
+            size_t total = 0;
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+                total += fixedEncodedSize<FT>();
+            });
+
+            return total;
+        }
+    }
+
+public:
+    // Compile-time fingerprint of how `T` is encoded. Any change that affects the wire format of `T` (reordering, adding
+    // or removing members, changing a member type) changes the hash, while renaming members does not.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static constexpr uint32_t schemaHash() {
+        if constexpr (util::data::IsPrimitive<T>) {
+            return schemaCombine('P', (sizeof(T) << 2) | (std::is_floating_point_v<T> << 1) | std::is_signed_v<T>);
+        } else if constexpr (std::is_enum_v<T>) {
+            return schemaCombine('E', schemaHash<std::underlying_type_t<T>>());
+        } else if constexpr (std::is_empty_v<T> && std::is_default_constructible_v<T>) {
+            return schemaCombine('Z', 0);
+        } else if constexpr (boost::describe::has_describe_members<T>::value) {
+            uint32_t hash = schemaCombine(isBitfieldStruct<T>() ? 'B' : (SerializePackedBools<T>::value ? 'K' : 'S'), 0);
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+                hash = schemaCombine(hash, schemaHash<FT>());
+            });
+
+            return hash;
+        } else if constexpr (util::misc::IsStdVector<T>::value) {
+            return schemaCombine('V', schemaHash<typename T::value_type>());
+        } else if constexpr (util::misc::IsStdArray<T>::value) {
+            return schemaCombine(schemaCombine('A', std::tuple_size_v<T>), schemaHash<typename T::value_type>());
+        } else if constexpr (util::misc::IsStdPair<T>::value) {
+            return schemaCombine(schemaCombine('R', schemaHash<typename T::first_type>()), schemaHash<typename T::second_type>());
+        } else if constexpr (util::misc::IsStdOptional<T>::value) {
+            return schemaCombine('O', schemaHash<typename T::value_type>());
+        } else if constexpr (util::misc::IsEither<T>::value) {
+            return schemaCombine(schemaCombine('X', schemaHash<typename T::first_type>()), schemaHash<typename T::second_type>());
+        } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> || util::misc::IsInlineString<T>::value) {
+            return schemaCombine('T', 0);
+        } else if constexpr (util::misc::IsVarint<T>::value) {
+            return schemaCombine('W', std::is_signed_v<typename T::value_type>);
+        } else if constexpr (std::is_same_v<T, ByteBuffer>) {
+            return schemaCombine('Y', 0);
+        } else {
+            // types with a `customEncode` specialization, the size is the best we can tell them apart by
+            return schemaCombine('C', sizeof(T));
+        }
+    }
+
+protected:
+    static constexpr uint32_t schemaCombine(uint32_t hash, uint32_t value) {
+        const uint8_t bytes[8] = {
+            static_cast<uint8_t>(hash), static_cast<uint8_t>(hash >> 8), static_cast<uint8_t>(hash >> 16), static_cast<uint8_t>(hash >> 24),
+            static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24),
+        };
+
+        return util::crypto::adler32(bytes, sizeof(bytes));
+    }
+
+    // Write a fixed size value, growing the buffer once and then copying every member without further checks
+    template <typename T>
+    void writeFixed(const T& value) {
+        constexpr size_t size = fixedEncodedSize<T>();
+
+        this->materialize();
+        if (_position + size > _data.size()) {
+            _data.resize(_position + size);
+        }
+
+        util::data::byte* out = _data.data() + _position;
+        writeFixedUnchecked<T>(out, value);
+        _position += size;
+    }
+
+    // Read a fixed size value, doing one bounds check and then copying every member without further checks
+    template <typename T>
+    DecodeResult<> readFixedInto(T& value) {
+        constexpr size_t size = fixedEncodedSize<T>();
+        GLOBED_UNWRAP(this->boundsCheck(size));
+
+        const util::data::byte* in = this->rawData() + _position;
+        readFixedUnchecked<T>(in, value);
+        _position += size;
+
+        return Ok();
+    }
+
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static void writeFixedUnchecked(util::data::byte*& out, const T& value) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            T swapped = util::data::maybeByteswap(value);
+            std::memcpy(out, &swapped, sizeof(T));
+            out += sizeof(T);
+        } else {
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+                writeFixedUnchecked<FT>(out, value.*descriptor.pointer);
+            });
+        }
+    }
+
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static void readFixedUnchecked(const util::data::byte*& in, T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            value = *in != 0;
+            in += sizeof(bool);
+        } else if constexpr (util::data::IsPrimitive<T>) {
+            std::memcpy(&value, in, sizeof(T));
+            value = util::data::maybeByteswap(value);
+            in += sizeof(T);
+        } else {
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+                readFixedUnchecked<FT>(in, value.*descriptor.pointer);
+            });
+        }
+    }
+
+    // Whether the encoded size of `T` has a compile-time upper bound, see `maxEncodedSize`. Unlike `isFixedSize`,
+    // this also allows optionals, Eithers, enums, bitfields and packed structs.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>,
+        class Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>
+    >
+    static constexpr bool isBoundedSize() {
+        if constexpr (util::data::IsPrimitive<T> || std::is_enum_v<T>) {
+            return true;
+        } else if constexpr (std::is_same_v<T, cocos2d::CCPoint> || std::is_same_v<T, cocos2d::CCSize>
+                          || std::is_same_v<T, cocos2d::ccColor3B> || std::is_same_v<T, cocos2d::ccColor4B>) {
+            return true;
+        } else if constexpr (util::misc::IsStdOptional<T>::value || util::misc::IsStdArray<T>::value) {
+            return isBoundedSize<typename T::value_type>();
+        } else if constexpr (util::misc::IsEither<T>::value) {
+            using A = typename T::first_type;
+            using B = typename T::second_type;
+            return isBoundedSize<A>() && isBoundedSize<B>() && std::is_default_constructible_v<A> && std::is_default_constructible_v<B>;
+        } else if constexpr (boost::describe::has_describe_members<T>::value && std::is_default_constructible_v<T>) {
+            if constexpr (isBitfieldStruct<T>()) {
+                return true;
+            } else if constexpr (!boost::mp11::mp_empty<Bd>::value) {
+                return false;
+            } else {
+                bool bounded = true;
+                boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                    using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+                    if constexpr (!isBoundedSize<FT>()) {
+                        bounded = false;
+                    }
+                });
+
+                return bounded;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    // Largest possible encoded size of a type for which `isBoundedSize` is true
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static constexpr size_t maxEncodedSize() {
+        static_assert(isBoundedSize<T>(), "maxEncodedSize called on a type that is not bounded in size");
+
+        if constexpr (util::data::IsPrimitive<T>) {
+            return sizeof(T);
+        } else if constexpr (std::is_enum_v<T>) {
+            return sizeof(std::underlying_type_t<T>);
+        } else if constexpr (std::is_same_v<T, cocos2d::CCPoint> || std::is_same_v<T, cocos2d::CCSize>) {
+            return sizeof(float) * 2;
+        } else if constexpr (std::is_same_v<T, cocos2d::ccColor3B>) {
+            return 3;
+        } else if constexpr (std::is_same_v<T, cocos2d::ccColor4B>) {
+            return 4;
+        } else if constexpr (util::misc::IsStdOptional<T>::value) {
+            return sizeof(bool) + maxEncodedSize<typename T::value_type>();
+        } else if constexpr (util::misc::IsStdArray<T>::value) {
+            return std::tuple_size_v<T> * maxEncodedSize<typename T::value_type>();
+        } else if constexpr (util::misc::IsEither<T>::value) {
+            return sizeof(bool) + std::max(maxEncodedSize<typename T::first_type>(), maxEncodedSize<typename T::second_type>());
+        } else if constexpr (isBitfieldStruct<T>()) {
+            return util::data::bitsToBytes(sizeof(T));
+        } else {
+            size_t total = 0;
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+                if constexpr (!SerializePackedBools<T>::value || !std::is_same_v<FT, bool>) {
+                    total += maxEncodedSize<FT>();
+                }
+            });
+
+            if constexpr (SerializePackedBools<T>::value) {
+                total += util::data::bitsToBytes(packedBoolCount<T>());
+            }
+
+            return total;
+        }
+    }
+
+    // Read a value for which `isBoundedSize` is true without any bounds checks. The caller must make sure that
+    // at least `maxEncodedSize<T>()` bytes are readable. Invalid enum values set `valid` to false instead of
+    // stopping, so that the decoding loop has no branches on errors.
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static void readBoundedUnchecked(const util::data::byte*& in, T& value, bool& valid) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            readFixedUnchecked<T>(in, value);
+        } else if constexpr (std::is_enum_v<T>) {
+            using P = std::underlying_type_t<T>;
+
+            P underlying;
+            readFixedUnchecked<P>(in, underlying);
+            valid &= isValidEnumValue<T>(underlying);
+            value = static_cast<T>(underlying);
+        } else if constexpr (std::is_same_v<T, cocos2d::CCPoint>) {
+            readFixedUnchecked<float>(in, value.x);
+            readFixedUnchecked<float>(in, value.y);
+        } else if constexpr (std::is_same_v<T, cocos2d::CCSize>) {
+            readFixedUnchecked<float>(in, value.width);
+            readFixedUnchecked<float>(in, value.height);
+        } else if constexpr (std::is_same_v<T, cocos2d::ccColor3B> || std::is_same_v<T, cocos2d::ccColor4B>) {
+            readFixedUnchecked<uint8_t>(in, value.r);
+            readFixedUnchecked<uint8_t>(in, value.g);
+            readFixedUnchecked<uint8_t>(in, value.b);
+
+            if constexpr (std::is_same_v<T, cocos2d::ccColor4B>) {
+                readFixedUnchecked<uint8_t>(in, value.a);
+            }
+        } else if constexpr (util::misc::IsStdOptional<T>::value) {
+            bool present;
+            readFixedUnchecked<bool>(in, present);
+
+            if (present) {
+                if (!value.has_value()) value.emplace();
+                readBoundedUnchecked(in, value.value(), valid);
+            } else {
+                value.reset();
+            }
+        } else if constexpr (util::misc::IsStdArray<T>::value) {
+            for (auto& elem : value) {
+                readBoundedUnchecked(in, elem, valid);
+            }
+        } else if constexpr (util::misc::IsEither<T>::value) {
+            bool isFirst;
+            readFixedUnchecked<bool>(in, isFirst);
+
+            if (isFirst) {
+                typename T::first_type inner;
+                readBoundedUnchecked(in, inner, valid);
+                value = T(std::move(inner));
+            } else {
+                typename T::second_type inner;
+                readBoundedUnchecked(in, inner, valid);
+                value = T(std::move(inner));
+            }
+        } else if constexpr (isBitfieldStruct<T>()) {
+            constexpr size_t bitcount = util::data::bitsToBytes(sizeof(T)) * 8;
+
+            BitBufferUnderlyingType<bitcount> underlying;
+            readFixedUnchecked(in, underlying);
+            BitBuffer<bitcount> bits(underlying);
+
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                value.*descriptor.pointer = bits.readBit();
+            });
+        } else if constexpr (SerializePackedBools<T>::value) {
+            constexpr size_t bitcount = util::data::bitsToBytes(packedBoolCount<T>()) * 8;
+
+            BitBuffer<bitcount> bits;
+            bool bitsRead = false;
+
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+                if constexpr (std::is_same_v<FT, bool>) {
+                    if (!bitsRead) {
+                        BitBufferUnderlyingType<bitcount> underlying;
+                        readFixedUnchecked(in, underlying);
+                        bits = BitBuffer<bitcount>(underlying);
+                        bitsRead = true;
+                    }
+
+                    value.*descriptor.pointer = bits.readBit();
+                } else {
+                    readBoundedUnchecked(in, value.*descriptor.pointer, valid);
+                }
+            });
+        } else {
+            boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+                readBoundedUnchecked(in, value.*descriptor.pointer, valid);
+            });
+        }
+    }
+
+    // Whether `underlying` is the value of one of the described enumerators of `E`
+    template <typename E>
+    static constexpr bool isValidEnumValue(std::underlying_type_t<E> underlying) {
+        bool found = false;
+
+        boost::mp11::mp_for_each<boost::describe::describe_enumerators<E>>([&](auto descriptor) {
+            if (static_cast<std::underlying_type_t<E>>(descriptor.value) == underlying) {
+                found = true;
+            }
+        });
+
+        return found;
+    }
+
+    // Amount of bool members in a struct, used for packed structs
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    static constexpr size_t packedBoolCount() {
+        size_t count = 0;
+
+        boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+            using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+            if constexpr (std::is_same_v<FT, bool>) {
+                count++;
+            }
+        });
+
+        return count;
+    }
+
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    void reflectionEncodePacked(const T& value) {
+        constexpr size_t bitcount = util::data::bitsToBytes(packedBoolCount<T>()) * 8;
+        static_assert(bitcount > 0 && bitcount <= 64, "packed struct must have between 1 and 64 bool fields");
+
+        BitBuffer<bitcount> bits;
+        boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+            using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+            if constexpr (std::is_same_v<FT, bool>) {
+                bits.writeBit(value.*descriptor.pointer);
+            }
+        });
+
+        bool bitsWritten = false;
+        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) {
+            using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+            if constexpr (std::is_same_v<FT, bool>) {
+                if (!bitsWritten) {
+                    this->writeBits(bits);
+                    bitsWritten = true;
+                }
+            } else {
+                this->writeValue(value.*descriptor.pointer);
+            }
+        });
+    }
+
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    DecodeResult<> reflectionDecodePackedInto(T& value) {
+        constexpr size_t bitcount = util::data::bitsToBytes(packedBoolCount<T>()) * 8;
+        static_assert(bitcount > 0 && bitcount <= 64, "packed struct must have between 1 and 64 bool fields");
+
+        BitBuffer<bitcount> bits;
+        bool bitsRead = false;
+
+        bool failed = false;
+        DecodeError failError;
+
+        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) -> void {
+            if (failed) return;
+
+            using FT = typename util::misc::MemberPtrToUnderlying<decltype(descriptor.pointer)>::type;
+
+            if constexpr (std::is_same_v<FT, bool>) {
+                if (!bitsRead) {
+                    auto result = this->readBits<bitcount>();
+                    if (result.isErr()) {
+                        failed = true;
+                        failError = result.unwrapErr();
+                        return;
+                    }
+
+                    bits = result.unwrap();
+                    bitsRead = true;
+                }
+
+                value.*descriptor.pointer = bits.readBit();
+            } else {
+                auto result = this->readValueInto(value.*descriptor.pointer);
+                if (result.isErr()) {
+                    failed = true;
+                    failError = result.unwrapErr();
+                }
+            }
+        });
+
+        if (failed) {
+            return Err(std::move(failError));
+        }
+
+        return Ok();
+    }
+
     template <
         typename T,
         class Md = boost::describe::describe_members<T, boost::describe::mod_public>
@@ -392,6 +1069,10 @@ protected:
             return this->pcDecodeOptional<typename T::value_type>();
         } else if constexpr (util::misc::IsEither<T>::value) {
             return this->pcDecodeEither<typename T::first_type, typename T::second_type>();
+        } else if constexpr (util::misc::IsInlineString<T>::value) {
+            return this->pcDecodeInlineString<T::CAPACITY>();
+        } else if constexpr (util::misc::IsVarint<T>::value) {
+            return this->pcDecodeVarint<typename T::value_type>();
         } else {
             return this->customDecode<T>();
         }
@@ -407,6 +1088,10 @@ protected:
             this->pcEncodeOptional<typename T::value_type>(value);
         } else if constexpr (util::misc::IsEither<T>::value) {
             this->pcEncodeEither(value);
+        } else if constexpr (util::misc::IsInlineString<T>::value) {
+            this->customEncode(value.view());
+        } else if constexpr (util::misc::IsVarint<T>::value) {
+            this->writeVarUint(T::zigzag(value.get()));
         } else if constexpr (std::is_same_v<T, ByteBuffer>) {
             this->rawWriteBytes(value.data().data(), value.size());
         } else {
@@ -418,6 +1103,12 @@ protected:
 
     template<typename T>
     DecodeResult<std::vector<T>> pcDecodeVector() {
+        if constexpr (isFixedSizeElement<T>()) {
+            std::vector<T> out;
+            GLOBED_UNWRAP(this->readFixedVectorInto<T>(out));
+            return Ok(std::move(out));
+        }
+
         GLOBED_UNWRAP_INTO(this->readLength(), auto length);
 
         std::vector<T> out;
@@ -431,13 +1122,114 @@ protected:
             out.emplace_back(std::move(val));
         }
 
-        return Ok(out);
+        return Ok(std::move(out));
+    }
+
+    // Read a vector of fixed size elements, checking the bounds for all of them at once and allocating only once
+    template<typename T>
+    DecodeResult<> readFixedVectorInto(std::vector<T>& out) {
+        constexpr size_t elemSize = fixedEncodedSize<T>();
+        GLOBED_UNWRAP_INTO(this->readLengthCheck(elemSize), auto length);
+
+        out.resize(length);
+
+        const util::data::byte* in = this->rawData() + _position;
+
+        if constexpr (util::data::IsPrimitive<T>) {
+            if (length > 0) std::memcpy(out.data(), in, elemSize * length);
+            util::data::maybeByteswapArray(out.data(), length);
+        } else {
+            for (auto& elem : out) {
+                readFixedUnchecked<T>(in, elem);
+            }
+        }
+
+        _position += elemSize * length;
+
+        return Ok();
+    }
+
+    template<typename T>
+    DecodeResult<> pcDecodeVectorInto(std::vector<T>& out) {
+        if constexpr (isFixedSizeElement<T>()) {
+            return this->readFixedVectorInto<T>(out);
+        }
+
+        GLOBED_UNWRAP_INTO(this->readLength(), auto length);
+
+        // same limit as in pcDecodeVector, don't let a bogus length make us allocate a lot upfront
+        if constexpr (std::is_default_constructible_v<T>) {
+            if (sizeof(T) * length < (2 << 15)) {
+                out.resize(length);
+
+                size_t i = 0;
+
+                // as long as even the largest possible element fits in the remaining data, elements can be read with no checks.
+                // only the last few elements, if any, have to go through the checked path below.
+                if constexpr (isBoundedSize<T>()) {
+                    constexpr size_t maxSize = maxEncodedSize<T>();
+
+                    const util::data::byte* in = this->rawData() + _position;
+                    const util::data::byte* end = this->rawData() + this->size();
+                    bool valid = true;
+
+                    while (i < length && static_cast<size_t>(end - in) >= maxSize) {
+                        readBoundedUnchecked<T>(in, out[i], valid);
+                        i++;
+                    }
+
+                    _position = in - this->rawData();
+
+                    if (!valid) {
+                        return Err(DecodeError::InvalidEnumValue);
+                    }
+                }
+
+                for (; i < length; i++) {
+                    GLOBED_UNWRAP(this->readValueInto<T>(out[i]));
+                }
+
+                return Ok();
+            }
+        }
+
+        out.clear();
+
+        for (size_t i = 0; i < length; i++) {
+            GLOBED_UNWRAP_INTO(this->readValue<T>(), T val);
+            out.emplace_back(std::move(val));
+        }
+
+        return Ok();
     }
 
     template<typename T>
     void pcEncodeVector(const std::vector<T>& vec) {
         this->writeLength(vec.size());
 
+        if constexpr (isFixedSizeElement<T>()) {
+            constexpr size_t elemSize = fixedEncodedSize<T>();
+
+            this->materialize();
+            if (_position + elemSize * vec.size() > _data.size()) {
+                _data.resize(_position + elemSize * vec.size());
+            }
+
+            util::data::byte* out = _data.data() + _position;
+
+            if constexpr (util::data::IsPrimitive<T>) {
+                if (!vec.empty()) std::memcpy(out, vec.data(), elemSize * vec.size());
+                util::data::maybeByteswapArray(reinterpret_cast<T*>(out), vec.size());
+            } else {
+                for (const auto& elem : vec) {
+                    writeFixedUnchecked<T>(out, elem);
+                }
+            }
+
+            _position += elemSize * vec.size();
+            return;
+        }
+
         for (const auto& elem : vec) {
             this->writeValue<T>(elem);
         }
@@ -509,6 +1301,46 @@ protected:
         }
     }
 
+    // Varint
+
+    template <typename T>
+    DecodeResult<Varint<T>> pcDecodeVarint() {
+        GLOBED_UNWRAP_INTO(this->readVarUint(), uint64_t raw);
+
+        if constexpr (std::is_signed_v<T>) {
+            int64_t value = Varint<T>::unzigzag(raw);
+            if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                return Err(DecodeError::InvalidVarint);
+            }
+
+            return Ok(Varint<T>(static_cast<T>(value)));
+        } else {
+            if (raw > std::numeric_limits<T>::max()) {
+                return Err(DecodeError::InvalidVarint);
+            }
+
+            return Ok(Varint<T>(static_cast<T>(raw)));
+        }
+    }
+
+    // InlineString
+
+    template <size_t N>
+    DecodeResult<InlineString<N>> pcDecodeInlineString() {
+        GLOBED_UNWRAP_INTO(this->readLength(), size_t length);
+
+        if (length > N) {
+            return Err(DecodeError::DataTooLong);
+        }
+
+        GLOBED_UNWRAP(this->boundsCheck(length));
+
+        InlineString<N> out(std::string_view(reinterpret_cast<const char*>(this->rawData() + _position), length));
+        _position += length;
+
+        return Ok(out);
+    }
+
     template <
         typename T,
         class Md = boost::describe::describe_members<T, boost::describe::mod_public>
@@ -557,6 +1389,13 @@ private:
     // Data members
     util::data::bytevector _data;
     size_t _position = 0;
+
+    // set when in view mode, points to memory we do not own
+    util::data::byte* _view = nullptr;
+    size_t _viewSize = 0;
+
+    // copy the viewed memory into `_data` and leave view mode
+    void materialize();
 };
 
 // Custom error formatter
@@ -1,62 +1,56 @@
 #include "all.hpp"
+#include "pool.hpp"
+
+// Server packets that arrive often or carry many strings reuse their instances once all listeners are done with them
+template <typename T>
+struct IsPooledPacket : std::false_type {};
+
+#define GLOBED_POOLED_PACKET(pt) template <> struct IsPooledPacket<pt> : std::true_type {}
+
+GLOBED_POOLED_PACKET(GlobalPlayerListPacket);
+GLOBED_POOLED_PACKET(PlayerListPagePacket);
+GLOBED_POOLED_PACKET(LevelListPacket);
+GLOBED_POOLED_PACKET(PlayerProfilesPacket);
+GLOBED_POOLED_PACKET(LevelDataPacket);
+GLOBED_POOLED_PACKET(LevelPlayerMetadataPacket);
+GLOBED_POOLED_PACKET(QuantizedLevelDataPacket);
+GLOBED_POOLED_PACKET(VoiceBroadcastPacket);
+GLOBED_POOLED_PACKET(VoiceBundlePacket);
+GLOBED_POOLED_PACKET(ChatMessageBroadcastPacket);
+GLOBED_POOLED_PACKET(RoomPlayerListPacket);
+GLOBED_POOLED_PACKET(RoomListPacket);
+GLOBED_POOLED_PACKET(RoomListPagePacket);
+
+#undef GLOBED_POOLED_PACKET
+
+using PacketFactory = std::shared_ptr<Packet>(*)();
+
+template <typename T>
+static std::shared_ptr<Packet> createPacket() {
+    if constexpr (IsPooledPacket<T>::value) {
+        return PacketPool<T>::get().acquire();
+    } else {
+        return std::make_shared<T>();
+    }
+}
+
+// indexed by `ServerPacketTypes::indexOf`
+template <typename... Packets>
+static constexpr auto makeFactories(PacketTypeList<Packets...>) {
+    using List = PacketTypeList<Packets...>;
 
-#define PACKET(pt) case pt::PACKET_ID: return std::make_shared<pt>()
+    std::array<PacketFactory, List::size> out{};
+    ((out[List::indexOf(Packets::PACKET_ID)] = &createPacket<Packets>), ...);
+    return out;
+}
+
+static constexpr auto SERVER_PACKET_FACTORIES = makeFactories(ServerPacketTypes{});
 
 std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
-    switch (packetId) {
-        // connection related
-
-        PACKET(PingResponsePacket);
-        PACKET(CryptoHandshakeResponsePacket);
-        PACKET(KeepaliveResponsePacket);
-        PACKET(ServerDisconnectPacket);
-        PACKET(LoggedInPacket);
-        PACKET(LoginFailedPacket);
-        PACKET(ProtocolMismatchPacket);
-        PACKET(KeepaliveTCPResponsePacket);
-        PACKET(ClaimThreadFailedPacket);
-        PACKET(LoginRecoveryFailecPacket);
-
-        PACKET(ServerNoticePacket);
-        PACKET(ServerBannedPacket);
-        PACKET(ServerMutedPacket);
-        PACKET(ConnectionTestResponsePacket);
-
-        // general
-
-        PACKET(GlobalPlayerListPacket);
-        PACKET(LevelListPacket);
-        PACKET(LevelPlayerCountPacket);
-        PACKET(RolesUpdatedPacket);
-
-        // game related
-
-        PACKET(PlayerProfilesPacket);
-        PACKET(LevelDataPacket);
-        PACKET(LevelPlayerMetadataPacket);
-        PACKET(VoiceBroadcastPacket);
-        PACKET(ChatMessageBroadcastPacket);
-
-        // room related
-
-        PACKET(RoomCreatedPacket);
-        PACKET(RoomJoinedPacket);
-        PACKET(RoomJoinFailedPacket);
-        PACKET(RoomPlayerListPacket);
-        PACKET(RoomInfoPacket);
-        PACKET(RoomInvitePacket);
-        PACKET(RoomListPacket);
-        PACKET(RoomCreateFailedPacket);
-
-        // admin related
-
-        PACKET(AdminAuthSuccessPacket);
-        PACKET(AdminErrorPacket);
-        PACKET(AdminUserDataPacket);
-        PACKET(AdminSuccessMessagePacket);
-        PACKET(AdminAuthFailedPacket);
-
-        default:
-            return std::shared_ptr<Packet>(nullptr);
+    size_t idx = ServerPacketTypes::indexOf(packetId);
+    if (idx >= SERVER_PACKET_FACTORIES.size()) {
+        return nullptr;
     }
-}
\ No newline at end of file
+
+    return SERVER_PACKET_FACTORIES[idx]();
+}
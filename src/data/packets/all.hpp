@@ -11,7 +11,8 @@
 * 2. in your class, inherit Packet and add GLOBED_PACKET(id, encrypt), encrypt should be true for packets that are sensitive.
 * 3. add the GLOBED_ENCODE or GLOBED_DECODE method
 * 4. For client packets, you may also choose to add a ::create(...) function and/or a constructor
-* 5. For server packets, in `all.cpp` add the packet to the switch as PACKET(cls).
+* 5. Add the packet to `ServerPacketTypes` or `ClientPacketTypes` below. Server packets that arrive often or carry many strings
+*    can also be pooled, see `GLOBED_POOLED_PACKET` in `all.cpp`.
 */
 
 #pragma once
@@ -30,5 +31,188 @@
 #include "server/general.hpp"
 #include "server/room.hpp"
 
-// Matches a packet by packet ID, returns nullptr if not found. Otherwise returns an Packet pointer with uninitialized data
+#include <algorithm>
+#include <array>
+
+// Properties of a packet type, readable by ID without creating the packet or making a virtual call
+struct PacketProperties {
+    const char* name;
+    bool encrypted;
+    bool tcp;
+};
+
+template <typename... Packets>
+struct PacketTypeList {
+    static constexpr size_t size = sizeof...(Packets);
+
+    // all packet IDs in this list, sorted in ascending order
+    static constexpr std::array<packetid_t, size> sortedIds = [] {
+        std::array<packetid_t, size> ids = { Packets::PACKET_ID... };
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }();
+
+    static_assert(std::adjacent_find(sortedIds.begin(), sortedIds.end()) == sortedIds.end(), "duplicate packet ID in packet list");
+
+    static constexpr packetid_t MIN_ID = sortedIds.front();
+    static constexpr size_t ID_SPAN = sortedIds.back() - MIN_ID + 1;
+
+    static_assert(size < 255, "packet list too big for the index table");
+    static_assert(ID_SPAN <= 16384, "packet IDs in one list are too far apart for the index table");
+
+    // maps `id - MIN_ID` to a dense index, `size` for IDs that are not in the list
+    static constexpr std::array<uint8_t, ID_SPAN> indexTable = [] {
+        std::array<uint8_t, ID_SPAN> table{};
+        table.fill(static_cast<uint8_t>(size));
+
+        for (size_t i = 0; i < size; i++) {
+            table[sortedIds[i] - MIN_ID] = static_cast<uint8_t>(i);
+        }
+
+        return table;
+    }();
+
+    // Returns a dense index in range [0, size) for the given packet ID, or `size` if the ID is not in this list
+    static constexpr size_t indexOf(packetid_t id) {
+        if (id < MIN_ID || static_cast<size_t>(id - MIN_ID) >= ID_SPAN) {
+            return size;
+        }
+
+        return indexTable[id - MIN_ID];
+    }
+
+    // indexed by `indexOf`
+    static constexpr std::array<PacketProperties, size> properties = [] {
+        std::array<PacketProperties, size> out{};
+        ((out[std::lower_bound(sortedIds.begin(), sortedIds.end(), Packets::PACKET_ID) - sortedIds.begin()] = PacketProperties {
+            .name = Packets::PACKET_NAME,
+            .encrypted = Packets::ENCRYPTED,
+            .tcp = Packets::SHOULD_USE_TCP,
+        }), ...);
+        return out;
+    }();
+
+    // Returns nullptr if the ID is not in this list
+    static constexpr const PacketProperties* propertiesOf(packetid_t id) {
+        size_t idx = indexOf(id);
+        return idx < size ? &properties[idx] : nullptr;
+    }
+};
+
+// Every packet the server can send us
+using ServerPacketTypes = PacketTypeList<
+    // connection related
+    PingResponsePacket,
+    CryptoHandshakeResponsePacket,
+    KeepaliveResponsePacket,
+    ServerDisconnectPacket,
+    LoggedInPacket,
+    LoginFailedPacket,
+    ProtocolMismatchPacket,
+    KeepaliveTCPResponsePacket,
+    ClaimThreadFailedPacket,
+    LoginRecoveryFailecPacket,
+    ServerNoticePacket,
+    ServerBannedPacket,
+    ServerMutedPacket,
+    ConnectionTestResponsePacket,
+    SessionCipherPacket,
+
+    // general
+    GlobalPlayerListPacket,
+    LevelListPacket,
+    LevelPlayerCountPacket,
+    RolesUpdatedPacket,
+    LevelListDeltaPacket,
+    PlayerListPagePacket,
+
+    // game related
+    PlayerProfilesPacket,
+    LevelDataPacket,
+    LevelPlayerMetadataPacket,
+    QuantizedLevelDataPacket,
+    LevelTpsPacket,
+    VoiceBroadcastPacket,
+    VoiceBundlePacket,
+    ChatMessageBroadcastPacket,
+    LinkedPlayerDataBroadcastPacket,
+
+    // room related
+    RoomCreatedPacket,
+    RoomJoinedPacket,
+    RoomJoinFailedPacket,
+    RoomPlayerListPacket,
+    RoomInfoPacket,
+    RoomInvitePacket,
+    RoomListPacket,
+    RoomCreateFailedPacket,
+    RoomPlayersDiffPacket,
+    RoomListPagePacket,
+
+    // admin related
+    AdminAuthSuccessPacket,
+    AdminErrorPacket,
+    AdminUserDataPacket,
+    AdminSuccessMessagePacket,
+    AdminAuthFailedPacket,
+    AdminUsersDataPacket,
+    AdminUserSearchResultsPacket
+>;
+
+// Every packet we can send, except `RawPacket`
+using ClientPacketTypes = PacketTypeList<
+    // connection related
+    PingPacket,
+    CryptoHandshakeStartPacket,
+    KeepalivePacket,
+    LoginPacket,
+    ClaimThreadPacket,
+    DisconnectPacket,
+    KeepaliveTCPPacket,
+    ConnectionTestPacket,
+
+    // general
+    SyncIconsPacket,
+    RequestGlobalPlayerListPacket,
+    RequestLevelListPacket,
+    RequestPlayerCountPacket,
+    SubscribePlayerCountsPacket,
+    RequestPlayerListPagePacket,
+
+    // game related
+    RequestPlayerProfilesPacket,
+    LevelJoinPacket,
+    LevelLeavePacket,
+    PlayerDataPacket,
+    PlayerMetadataPacket,
+    PlayerDataDeltaPacket,
+    PlayerViewportPacket,
+    RequestPlayerProfilesBatchPacket,
+    VoiceProximityPacket,
+    LinkPlayerPacket,
+    LinkedPlayerDataPacket,
+    VoicePacket,
+    ChatMessagePacket,
+
+    // room related
+    CreateRoomPacket,
+    JoinRoomPacket,
+    LeaveRoomPacket,
+    RequestRoomPlayerListPacket,
+    UpdateRoomSettingsPacket,
+    RoomSendInvitePacket,
+    RequestRoomListPacket,
+    RequestRoomListPagePacket,
+
+    // admin related
+    AdminAuthPacket,
+    AdminSendNoticePacket,
+    AdminDisconnectPacket,
+    AdminGetUserStatePacket,
+    AdminUpdateUserPacket,
+    AdminGetUsersPacket,
+    AdminSearchUsersPacket
+>;
+
+// Matches a server packet by packet ID, returns nullptr if not found. Otherwise returns an Packet pointer with uninitialized data
 std::shared_ptr<Packet> matchPacket(packetid_t packetId);
\ No newline at end of file
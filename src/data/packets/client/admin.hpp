@@ -84,3 +84,34 @@ class AdminUpdateUserPacket : public Packet {
 GLOBED_SERIALIZABLE_STRUCT(AdminUpdateUserPacket, (
     userEntry
 ));
+
+// 19005 - AdminGetUsersPacket
+class AdminGetUsersPacket : public Packet {
+    GLOBED_PACKET(19005, AdminGetUsersPacket, false, true)
+
+    // matches the limit of the packet on the server
+    static constexpr size_t MAX_PLAYERS = 32;
+
+    AdminGetUsersPacket() {}
+    AdminGetUsersPacket(std::vector<std::string>&& players) : players(std::move(players)) {}
+
+    std::vector<std::string> players; // names or account IDs, like in `AdminGetUserStatePacket`
+};
+
+GLOBED_SERIALIZABLE_STRUCT(AdminGetUsersPacket, (
+    players
+));
+
+// 19006 - AdminSearchUsersPacket
+class AdminSearchUsersPacket : public Packet {
+    GLOBED_PACKET(19006, AdminSearchUsersPacket, false, true)
+
+    AdminSearchUsersPacket() {}
+    AdminSearchUsersPacket(const std::string_view prefix) : prefix(prefix) {}
+
+    std::string prefix;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(AdminSearchUsersPacket, (
+    prefix
+));
@@ -20,22 +20,27 @@ class CryptoHandshakeStartPacket : public Packet {
     GLOBED_PACKET(10001, CryptoHandshakeStartPacket, false, true)
 
     CryptoHandshakeStartPacket() {}
-    CryptoHandshakeStartPacket(uint16_t _protocol, CryptoPublicKey _key) : protocol(_protocol), key(_key) {}
+    CryptoHandshakeStartPacket(uint16_t _protocol, CryptoPublicKey _key, uint8_t _ciphers) : protocol(_protocol), key(_key), ciphers(_ciphers) {}
 
     uint16_t protocol;
     CryptoPublicKey key;
+    // bitmask of supported `SessionCipher`s
+    uint8_t ciphers;
 };
 
-GLOBED_SERIALIZABLE_STRUCT(CryptoHandshakeStartPacket, (protocol, key));
+GLOBED_SERIALIZABLE_STRUCT(CryptoHandshakeStartPacket, (protocol, key, ciphers));
 
 // 10002 - KeepalivePacket
 class KeepalivePacket : public Packet {
     GLOBED_PACKET(10002, KeepalivePacket, false, false)
 
     KeepalivePacket() {}
+    KeepalivePacket(uint64_t clientTime) : clientTime(clientTime) {}
+
+    uint64_t clientTime; // microseconds on the local monotonic clock, echoed back by the server
 };
 
-GLOBED_SERIALIZABLE_STRUCT(KeepalivePacket, ());
+GLOBED_SERIALIZABLE_STRUCT(KeepalivePacket, (clientTime));
 
 // 10003 - LoginPacket
 class LoginPacket : public Packet {
@@ -59,6 +59,84 @@ class PlayerMetadataPacket : public Packet {
 
 GLOBED_SERIALIZABLE_STRUCT(PlayerMetadataPacket, (data));
 
+// 12005 - PlayerDataDeltaPacket
+class PlayerDataDeltaPacket : public Packet {
+    GLOBED_PACKET(12005, PlayerDataDeltaPacket, false, false)
+
+    PlayerDataDeltaPacket() {}
+    PlayerDataDeltaPacket(const PlayerDataDelta& delta) : delta(delta) {}
+
+    PlayerDataDelta delta;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(PlayerDataDeltaPacket, (delta));
+
+// 12006 - PlayerViewportPacket
+class PlayerViewportPacket : public Packet {
+    GLOBED_PACKET(12006, PlayerViewportPacket, false, false)
+
+    PlayerViewportPacket() {}
+    PlayerViewportPacket(const cocos2d::CCPoint& origin, const cocos2d::CCSize& size) : origin(origin), size(size) {}
+
+    cocos2d::CCPoint origin;
+    cocos2d::CCSize size;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(PlayerViewportPacket, (origin, size));
+
+// 12007 - RequestPlayerProfilesBatchPacket
+class RequestPlayerProfilesBatchPacket : public Packet {
+    GLOBED_PACKET(12007, RequestPlayerProfilesBatchPacket, false, false)
+
+    // matches `MAX_PROFILE_BATCH` on the server
+    static constexpr size_t MAX_PLAYERS = 64;
+
+    RequestPlayerProfilesBatchPacket() {}
+    RequestPlayerProfilesBatchPacket(std::vector<int>&& requested) : requested(std::move(requested)) {}
+
+    std::vector<int> requested;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RequestPlayerProfilesBatchPacket, (requested));
+
+// 12008 - VoiceProximityPacket
+class VoiceProximityPacket : public Packet {
+    GLOBED_PACKET(12008, VoiceProximityPacket, false, true)
+
+    VoiceProximityPacket() {}
+    VoiceProximityPacket(float range) : range(range) {}
+
+    // distance at which other players can't be heard anymore, 0 if everyone on the level is heard
+    float range;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(VoiceProximityPacket, (range));
+
+// 12012 - LinkPlayerPacket
+class LinkPlayerPacket : public Packet {
+    GLOBED_PACKET(12012, LinkPlayerPacket, false, true)
+
+    LinkPlayerPacket() {}
+    LinkPlayerPacket(int player) : player(player) {}
+
+    // player we are linked to in two player mode, `LinkedPlayerDataPacket` is forwarded only to them. 0 to unlink
+    int player;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LinkPlayerPacket, (player));
+
+// 12013 - LinkedPlayerDataPacket
+class LinkedPlayerDataPacket : public Packet {
+    GLOBED_PACKET(12013, LinkedPlayerDataPacket, false, false)
+
+    LinkedPlayerDataPacket() {}
+    LinkedPlayerDataPacket(const PlayerData& data) : data(data) {}
+
+    PlayerData data;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LinkedPlayerDataPacket, (data));
+
 #ifdef GLOBED_VOICE_SUPPORT
 
 #include <audio/frame.hpp>
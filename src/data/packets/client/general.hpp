@@ -29,9 +29,14 @@ class RequestLevelListPacket : public Packet {
     GLOBED_PACKET(11002, RequestLevelListPacket, false, false)
 
     RequestLevelListPacket() {}
+    RequestLevelListPacket(uint32_t knownVersion, uint32_t requestId) : knownVersion(knownVersion), requestId(requestId) {}
+
+    // version of the list we already have, or 0. if it's still current, the server sends `LevelListDeltaPacket` instead
+    uint32_t knownVersion;
+    uint32_t requestId; // echoed in every response, so responses to an older request can be told apart
 };
 
-GLOBED_SERIALIZABLE_STRUCT(RequestLevelListPacket, ());
+GLOBED_SERIALIZABLE_STRUCT(RequestLevelListPacket, (knownVersion, requestId));
 
 // 11003 - RequestPlayerCountPacket
 class RequestPlayerCountPacket : public Packet {
@@ -44,3 +49,39 @@ class RequestPlayerCountPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(RequestPlayerCountPacket, (levelIds));
+
+// 11004 - SubscribePlayerCountsPacket
+class SubscribePlayerCountsPacket : public Packet {
+    GLOBED_PACKET(11004, SubscribePlayerCountsPacket, false, false)
+
+    // matches the limit of the packet on the server
+    static constexpr size_t MAX_LEVELS = 128;
+
+    SubscribePlayerCountsPacket() {}
+    SubscribePlayerCountsPacket(std::vector<LevelId>&& levelIds) : levelIds(std::move(levelIds)) {}
+
+    std::vector<LevelId> levelIds;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(SubscribePlayerCountsPacket, (levelIds));
+
+// 11005 - RequestPlayerListPagePacket
+class RequestPlayerListPagePacket : public Packet {
+    GLOBED_PACKET(11005, RequestPlayerListPagePacket, false, false)
+
+    // matches the limits of the packet on the server
+    static constexpr size_t MAX_IDS = 512;
+    static constexpr uint16_t MAX_LIMIT = 100;
+
+    RequestPlayerListPagePacket() {}
+
+    PlayerName namePrefix; // case insensitive, empty for everyone
+    std::vector<int> onlyIds; // only these accounts, empty for everyone
+    // the page starts after this player in the list, which is sorted by name (case insensitive) and then account id.
+    // empty name and 0 for the first page
+    PlayerName afterName;
+    int afterId = 0;
+    uint16_t limit = MAX_LIMIT;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RequestPlayerListPagePacket, (namePrefix, onlyIds, afterName, afterId, limit));
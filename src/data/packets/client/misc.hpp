@@ -11,6 +11,14 @@ public:
     RawPacket() {}
     RawPacket(packetid_t id, bool encrypted, bool tcp, ByteBuffer&& buffer) : id(id), encrypted(encrypted), tcp(tcp), buffer(std::move(buffer)) {}
 
+    // Reuse a pooled instance for another packet, the buffer keeps its capacity
+    void reset(packetid_t id, bool encrypted, bool tcp) {
+        this->id = id;
+        this->encrypted = encrypted;
+        this->tcp = tcp;
+        buffer.clear();
+    }
+
     packetid_t getPacketId() const override {
         return id;
     }
@@ -27,6 +35,14 @@ public:
         return "RawPacket";
     }
 
+    size_t getEncodedSizeHint() const override {
+        return buffer.size();
+    }
+
+    uint32_t getSchemaHash() const override {
+        return 0;
+    }
+
     void encode(ByteBuffer& buf) const override {
         buf.writeValue<ByteBuffer>(buffer);
     }
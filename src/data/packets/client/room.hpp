@@ -80,3 +80,20 @@ class RequestRoomListPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(RequestRoomListPacket, ());
+
+// 13007 - RequestRoomListPagePacket
+class RequestRoomListPagePacket : public Packet {
+    GLOBED_PACKET(13007, RequestRoomListPagePacket, false, false)
+
+    // matches the limit of the packet on the server
+    static constexpr uint16_t MAX_LIMIT = 50;
+
+    RequestRoomListPagePacket() {}
+
+    std::string nameFilter; // case insensitive, empty for every room
+    bool sortByName = false; // otherwise by player count, most players first
+    uint32_t offset = 0; // how many rooms we already have
+    uint16_t limit = MAX_LIMIT;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RequestRoomListPagePacket, (nameFilter, sortByName, offset, limit));
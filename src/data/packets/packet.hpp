@@ -4,6 +4,8 @@
 #include <defs/assert.hpp>
 #include <data/bytebuffer.hpp>
 
+#include <memory>
+
 using packetid_t = uint16_t;
 
 #define GLOBED_PACKET(id, name, enc, tcp) \
@@ -16,14 +18,19 @@ using packetid_t = uint16_t;
     bool getUseTcp() const override { return this->SHOULD_USE_TCP; } \
     bool getEncrypted() const override { return this->ENCRYPTED; } \
     const char* getPacketName() const override { return this->PACKET_NAME; } \
+    size_t getEncodedSizeHint() const override { \
+        return ByteBuffer::encodedSizeHint<std::remove_cv_t<std::remove_reference_t<decltype(*this)>>>(*this); \
+    } \
+    uint32_t getSchemaHash() const override { \
+        return ByteBuffer::schemaHash<std::remove_cv_t<std::remove_reference_t<decltype(*this)>>>(); \
+    } \
     void encode(ByteBuffer& buf) const override { \
         using InstTy = typename std::remove_reference_t<decltype(*this)>; \
         using NonCvTy = typename std::remove_cv_t<InstTy>; \
         buf.writeValue<NonCvTy>(*this); \
     } \
     ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) override { \
-        GLOBED_UNWRAP_INTO(buf.readValue<std::remove_reference_t<decltype(*this)>>(), *this); \
-        return Ok(); \
+        return buf.readValueInto<std::remove_reference_t<decltype(*this)>>(*this); \
     } \
     template <typename... Args> \
     static std::shared_ptr<Packet> create(Args&&... args) { \
@@ -35,6 +42,9 @@ public:
     // Encodes the packet into a bytebuffer
     virtual void encode(ByteBuffer& buf) const = 0;
 
+    // Returns the approximate size of the encoded packet body, not including the header
+    virtual size_t getEncodedSizeHint() const = 0;
+
     // Decodes the packet from a bytebuffer
     virtual ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) = 0;
 
@@ -43,6 +53,9 @@ public:
     virtual bool getEncrypted() const = 0;
     virtual const char* getPacketName() const = 0;
 
+    // Returns a fingerprint of the wire format of this packet, see `ByteBuffer::schemaHash`
+    virtual uint32_t getSchemaHash() const = 0;
+
     template <typename T>
     requires std::is_base_of_v<Packet, T>
     bool isInstanceOf() {
@@ -62,10 +75,22 @@ public:
 };
 
 struct PacketHeader {
-    static constexpr size_t SIZE = sizeof(packetid_t) + sizeof(bool);
+    static constexpr size_t SIZE = sizeof(packetid_t) + sizeof(uint8_t);
+
+    static constexpr uint8_t FLAG_ENCRYPTED = 1 << 0;
+    // only ever set by the server, for big TCP packets
+    static constexpr uint8_t FLAG_COMPRESSED = 1 << 1;
 
     packetid_t id;
-    bool encrypted;
+    uint8_t flags; // `FLAG_*` bits, this used to be a bool for encryption so older versions still read bit 0 correctly
+
+    bool encrypted() const {
+        return flags & FLAG_ENCRYPTED;
+    }
+
+    bool compressed() const {
+        return flags & FLAG_COMPRESSED;
+    }
 };
 
-GLOBED_SERIALIZABLE_STRUCT(PacketHeader, (id, encrypted));
+GLOBED_SERIALIZABLE_STRUCT(PacketHeader, (id, flags));
@@ -0,0 +1,135 @@
+#pragma once
+#include "packet.hpp"
+
+#include <asp/sync.hpp>
+
+/*
+* PacketPool recycles instances of a single packet type. The `shared_ptr` returned by `acquire` puts the packet
+* back into the pool once the last reference is dropped, instead of freeing it. Since packets decode in place
+* (see `ByteBuffer::readValueInto`), vectors inside a recycled packet keep their capacity too.
+*
+* The control blocks of the returned pointers are recycled as well, so at steady state acquiring a packet does not allocate.
+* Safe to acquire and release from any thread.
+*/
+
+template <typename T, size_t MaxPooled = 16>
+requires std::is_base_of_v<Packet, T>
+class PacketPool {
+public:
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    static PacketPool& get() {
+        static PacketPool instance;
+        return instance;
+    }
+
+    std::shared_ptr<T> acquire() {
+        T* obj = nullptr;
+
+        {
+            auto free = freeList.lock();
+            if (!free->empty()) {
+                obj = free->back();
+                free->pop_back();
+            }
+        }
+
+        if (!obj) {
+            obj = new T();
+        }
+
+        return std::shared_ptr<T>(obj, Releaser{}, BlockAllocator<T>{});
+    }
+
+    // Returns the amount of packets that are currently sitting in the pool
+    size_t pooled() {
+        return freeList.lock()->size();
+    }
+
+private:
+    asp::Mutex<std::vector<T*>> freeList;
+    static inline bool alive = false;
+
+    PacketPool() {
+        alive = true;
+    }
+
+    ~PacketPool() {
+        alive = false;
+
+        auto free = freeList.lock();
+        for (T* obj : *free) {
+            delete obj;
+        }
+
+        free->clear();
+    }
+
+    void release(T* obj) {
+        auto free = freeList.lock();
+        if (free->size() >= MaxPooled) {
+            delete obj;
+        } else {
+            free->push_back(obj);
+        }
+    }
+
+    struct Releaser {
+        void operator()(T* obj) const {
+            if (alive) {
+                PacketPool::get().release(obj);
+            } else {
+                delete obj;
+            }
+        }
+    };
+
+    // Recycles single-object allocations, used for the shared_ptr control blocks
+    template <typename U>
+    struct BlockAllocator {
+        using value_type = U;
+
+        BlockAllocator() = default;
+
+        template <typename V>
+        BlockAllocator(const BlockAllocator<V>&) {}
+
+        U* allocate(size_t n) {
+            if (n == 1) {
+                auto blocks = freeBlocks().lock();
+                if (!blocks->empty()) {
+                    U* block = blocks->back();
+                    blocks->pop_back();
+                    return block;
+                }
+            }
+
+            return static_cast<U*>(::operator new(n * sizeof(U)));
+        }
+
+        void deallocate(U* ptr, size_t n) {
+            if (n == 1) {
+                auto blocks = freeBlocks().lock();
+                if (blocks->size() < MaxPooled * 2) {
+                    blocks->push_back(ptr);
+                    return;
+                }
+            }
+
+            ::operator delete(ptr);
+        }
+
+        // intentionally leaked, blocks may be released during static destruction
+        static asp::Mutex<std::vector<U*>>& freeBlocks() {
+            static auto* blocks = new asp::Mutex<std::vector<U*>>();
+            return *blocks;
+        }
+
+        template <typename V>
+        bool operator==(const BlockAllocator<V>&) const { return true; }
+
+        template <typename V>
+        bool operator!=(const BlockAllocator<V>&) const { return false; }
+    };
+};
@@ -57,3 +57,26 @@ class AdminAuthFailedPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(AdminAuthFailedPacket, ());
+
+// 29005 - AdminUsersDataPacket
+class AdminUsersDataPacket : public Packet {
+    GLOBED_PACKET(29005, AdminUsersDataPacket, true, false)
+
+    AdminUsersDataPacket() {}
+
+    std::vector<std::pair<UserEntry, std::optional<PlayerRoomPreviewAccountData>>> users;
+    std::vector<std::string> missing; // requested names or account IDs that were not found
+};
+
+GLOBED_SERIALIZABLE_STRUCT(AdminUsersDataPacket, (users, missing));
+
+// 29006 - AdminUserSearchResultsPacket
+class AdminUserSearchResultsPacket : public Packet {
+    GLOBED_PACKET(29006, AdminUserSearchResultsPacket, false, false)
+
+    AdminUserSearchResultsPacket() {}
+
+    std::vector<PlayerRoomPreviewAccountData> players; // online players only, sorted by name
+};
+
+GLOBED_SERIALIZABLE_STRUCT(AdminUserSearchResultsPacket, (players));
@@ -31,8 +31,10 @@ class KeepaliveResponsePacket : public Packet {
     KeepaliveResponsePacket() {}
 
     uint32_t playerCount;
+    uint64_t clientTime; // from our `KeepalivePacket`
+    uint64_t serverTime; // microseconds since the server started
 };
-GLOBED_SERIALIZABLE_STRUCT(KeepaliveResponsePacket, (playerCount));
+GLOBED_SERIALIZABLE_STRUCT(KeepaliveResponsePacket, (playerCount, clientTime, serverTime));
 
 // 20003 - ServerDisconnectPacket
 class ServerDisconnectPacket : public Packet {
@@ -64,8 +66,9 @@ class LoginFailedPacket : public Packet {
     LoginFailedPacket() {}
 
     std::string message;
+    bool tokenRejected; // the token didn't validate, a new one from the central server may work
 };
-GLOBED_SERIALIZABLE_STRUCT(LoginFailedPacket, (message));
+GLOBED_SERIALIZABLE_STRUCT(LoginFailedPacket, (message, tokenRejected));
 
 // 20006 - ProtocolMismatchPacket
 class ProtocolMismatchPacket : public Packet {
@@ -102,6 +105,17 @@ class LoginRecoveryFailecPacket : public Packet {
 };
 GLOBED_SERIALIZABLE_STRUCT(LoginRecoveryFailecPacket, ());
 
+// 20010 - SessionCipherPacket
+class SessionCipherPacket : public Packet {
+    GLOBED_PACKET(20010, SessionCipherPacket, false, false)
+
+    SessionCipherPacket() {}
+
+    // a `SessionCipher`, sent right before `CryptoHandshakeResponsePacket`
+    uint8_t cipher;
+};
+GLOBED_SERIALIZABLE_STRUCT(SessionCipherPacket, (cipher));
+
 // 20100 - ServerNoticePacket
 class ServerNoticePacket : public Packet {
     GLOBED_PACKET(20100, ServerNoticePacket, false, false)
@@ -19,10 +19,12 @@ class LevelDataPacket : public Packet {
 
     LevelDataPacket() {}
 
+    uint32_t sequence;
+    uint32_t timestamp;
     std::vector<AssociatedPlayerData> players;
 };
 
-GLOBED_SERIALIZABLE_STRUCT(LevelDataPacket, (players));
+GLOBED_SERIALIZABLE_STRUCT(LevelDataPacket, (sequence, timestamp, players));
 
 // 22002 - LevelPlayerMetadataPacket
 class LevelPlayerMetadataPacket : public Packet {
@@ -35,10 +37,35 @@ class LevelPlayerMetadataPacket : public Packet {
 
 GLOBED_SERIALIZABLE_STRUCT(LevelPlayerMetadataPacket, (players));
 
+// 22003 - QuantizedLevelDataPacket
+class QuantizedLevelDataPacket : public Packet {
+    GLOBED_PACKET(22003, QuantizedLevelDataPacket, false, false)
+
+    QuantizedLevelDataPacket() {}
+
+    uint32_t sequence;
+    uint32_t timestamp;
+    QuantizedLevelData data;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(QuantizedLevelDataPacket, (sequence, timestamp, data));
+
 #ifdef GLOBED_VOICE_SUPPORT
 # include <audio/frame.hpp>
 #endif
 
+// 22004 - LevelTpsPacket
+class LevelTpsPacket : public Packet {
+    GLOBED_PACKET(22004, LevelTpsPacket, false, true)
+
+    LevelTpsPacket() {}
+
+    // rate to send player data at on the current level, lower than the server tps on crowded levels
+    uint32_t tps;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LevelTpsPacket, (tps));
+
 // 22010 - VoiceBroadcastPacket
 class VoiceBroadcastPacket : public Packet {
     GLOBED_PACKET(22010, VoiceBroadcastPacket, true, false)
@@ -57,6 +84,24 @@ class VoiceBroadcastPacket : public Packet {
     GLOBED_SERIALIZABLE_STRUCT(VoiceBroadcastPacket, ());
 #endif // GLOBED_VOICE_SUPPORT
 
+// 22012 - VoiceBundlePacket
+class VoiceBundlePacket : public Packet {
+    GLOBED_PACKET(22012, VoiceBundlePacket, true, false)
+
+    VoiceBundlePacket() {}
+
+#ifdef GLOBED_VOICE_SUPPORT
+    // frames from several speakers that were queued on the server at the same time
+    std::vector<VoiceBundleEntry> frames;
+#endif
+};
+
+#ifdef GLOBED_VOICE_SUPPORT
+    GLOBED_SERIALIZABLE_STRUCT(VoiceBundlePacket, (frames));
+#else
+    GLOBED_SERIALIZABLE_STRUCT(VoiceBundlePacket, ());
+#endif // GLOBED_VOICE_SUPPORT
+
 // 22011 - ChatMessageBroadcastPacket
 class ChatMessageBroadcastPacket : public Packet {
     GLOBED_PACKET(22011, ChatMessageBroadcastPacket, true, false)
@@ -68,3 +113,16 @@ class ChatMessageBroadcastPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(ChatMessageBroadcastPacket, (sender, message));
+
+// 22013 - LinkedPlayerDataBroadcastPacket
+class LinkedPlayerDataBroadcastPacket : public Packet {
+    GLOBED_PACKET(22013, LinkedPlayerDataBroadcastPacket, false, false)
+
+    LinkedPlayerDataBroadcastPacket() {}
+
+    // the player that linked to us in two player mode
+    int sender;
+    PlayerData data;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LinkedPlayerDataBroadcastPacket, (sender, data));
@@ -21,9 +21,12 @@ class LevelListPacket : public Packet {
     LevelListPacket() {}
 
     std::vector<GlobedLevel> levels;
+    bool isFinal; // the list is split into multiple packets, sorted by player count (descending), this is set on the last one
+    uint32_t version; // pass to `RequestLevelListPacket` to only get the changes next time
+    uint32_t requestId; // from the `RequestLevelListPacket` this answers
 };
 
-GLOBED_SERIALIZABLE_STRUCT(LevelListPacket, (levels));
+GLOBED_SERIALIZABLE_STRUCT(LevelListPacket, (levels, isFinal, version, requestId));
 
 // 21002 - LevelPlayerCountPacket
 class LevelPlayerCountPacket : public Packet {
@@ -46,3 +49,29 @@ class RolesUpdatedPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(RolesUpdatedPacket, (specialUserData));
+
+// 21004 - LevelListDeltaPacket
+class LevelListDeltaPacket : public Packet {
+    GLOBED_PACKET(21004, LevelListDeltaPacket, false, false)
+
+    LevelListDeltaPacket() {}
+
+    uint32_t baseVersion;
+    uint32_t version;
+    std::vector<GlobedLevel> changes; // a player count of 0 means the level is no longer on the list
+    uint32_t requestId; // from the `RequestLevelListPacket` this answers
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LevelListDeltaPacket, (baseVersion, version, changes, requestId));
+
+// 21005 - PlayerListPagePacket
+class PlayerListPagePacket : public Packet {
+    GLOBED_PACKET(21005, PlayerListPagePacket, false, false)
+
+    PlayerListPagePacket() {}
+
+    std::vector<PlayerPreviewAccountData> players; // sorted by name (case insensitive) and then account id
+    bool hasMore;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(PlayerListPagePacket, (players, hasMore));
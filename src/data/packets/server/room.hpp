@@ -42,9 +42,11 @@ class RoomPlayerListPacket : public Packet {
 
     RoomInfo info;
     std::vector<PlayerRoomPreviewAccountData> players;
+    // `RoomPlayersDiffPacket`s continue from this version
+    uint32_t version;
 };
 
-GLOBED_SERIALIZABLE_STRUCT(RoomPlayerListPacket, (info, players));
+GLOBED_SERIALIZABLE_STRUCT(RoomPlayerListPacket, (info, players, version));
 
 // 23004 - RoomInfoPacket
 class RoomInfoPacket : public Packet {
@@ -90,3 +92,30 @@ class RoomCreateFailedPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(RoomCreateFailedPacket, (reason));
+
+// 23008 - RoomPlayersDiffPacket
+// Someone joined or left the room, or their preview changed. Never sent for the global room.
+class RoomPlayersDiffPacket : public Packet {
+    GLOBED_PACKET(23008, RoomPlayersDiffPacket, false, false)
+
+    RoomPlayersDiffPacket() {}
+
+    uint32_t version;
+    // players to add, or to replace if already in the list
+    std::vector<PlayerRoomPreviewAccountData> updated;
+    std::vector<int32_t> removed;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RoomPlayersDiffPacket, (version, updated, removed));
+
+// 23009 - RoomListPagePacket
+class RoomListPagePacket : public Packet {
+    GLOBED_PACKET(23009, RoomListPagePacket, false, false)
+
+    RoomListPagePacket() {}
+
+    std::vector<RoomListingInfo> rooms;
+    bool hasMore;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RoomListPagePacket, (rooms, hasMore));
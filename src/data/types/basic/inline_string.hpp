@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+// String with a fixed capacity that is stored inline, without any heap allocations. Matches `esp::InlineString` on the server,
+// and is encoded the same way as a `std::string`. Strings longer than `N` are truncated when constructed,
+// and fail to decode with `DataTooLong`.
+template <size_t N>
+class InlineString {
+public:
+    static_assert(N > 0 && N <= 255, "InlineString capacity must fit in a single byte");
+
+    static constexpr size_t CAPACITY = N;
+
+    InlineString() {
+        buffer[0] = '\0';
+    }
+
+    InlineString(const std::string_view str) {
+        this->assign(str);
+    }
+
+    InlineString(const InlineString&) = default;
+    InlineString& operator=(const InlineString&) = default;
+
+    InlineString& operator=(const std::string_view str) {
+        this->assign(str);
+        return *this;
+    }
+
+    void assign(const std::string_view str) {
+        len = static_cast<uint8_t>(std::min(str.size(), N));
+        std::memcpy(buffer, str.data(), len);
+        buffer[len] = '\0';
+    }
+
+    bool operator==(const InlineString& other) const {
+        return this->view() == other.view();
+    }
+
+    bool operator==(const std::string_view other) const {
+        return this->view() == other;
+    }
+
+    std::string_view view() const {
+        return std::string_view(buffer, len);
+    }
+
+    operator std::string_view() const {
+        return this->view();
+    }
+
+    std::string str() const {
+        return std::string(buffer, len);
+    }
+
+    // Always null terminated
+    const char* c_str() const {
+        return buffer;
+    }
+
+    const char* data() const {
+        return buffer;
+    }
+
+    size_t size() const {
+        return len;
+    }
+
+    bool empty() const {
+        return len == 0;
+    }
+
+    const char* begin() const {
+        return buffer;
+    }
+
+    const char* end() const {
+        return buffer + len;
+    }
+
+private:
+    char buffer[N + 1];
+    uint8_t len = 0;
+};
+
+template <size_t N>
+struct fmt::formatter<InlineString<N>> : fmt::formatter<std::string_view> {
+    auto format(const InlineString<N>& str, fmt::format_context& ctx) const {
+        return fmt::formatter<std::string_view>::format(str.view(), ctx);
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+
+// Integer that is encoded as a LEB128 varint, matching `esp::VarUint` and `esp::VarInt` on the server.
+// Small values take up less space (anything below 128 is a single byte), signed values are zigzag encoded first.
+// Converts implicitly to and from `T`, so it can replace an integer member of a serialized struct.
+template <typename T>
+requires (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+class Varint {
+public:
+    using value_type = T;
+
+    Varint() : value(0) {}
+    Varint(T value) : value(value) {}
+
+    Varint(const Varint&) = default;
+    Varint& operator=(const Varint&) = default;
+
+    operator T() const {
+        return value;
+    }
+
+    T get() const {
+        return value;
+    }
+
+    bool operator==(const Varint&) const = default;
+
+    static constexpr uint64_t zigzag(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            int64_t wide = value;
+            return (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63);
+        } else {
+            return value;
+        }
+    }
+
+    static constexpr int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+private:
+    T value;
+};
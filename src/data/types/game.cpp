@@ -1,5 +1,6 @@
 #include "game.hpp"
 
+#include "gd.hpp"
 #include <data/bitbuffer.hpp>
 
 using namespace cocos2d;
@@ -14,16 +15,13 @@ void SpecificIconData::copyFlagsFrom(const SpecificIconData& other) {
     isGrounded = other.isGrounded;
     isStationary = other.isStationary;
     isFalling = other.isFalling;
-    didJustJump = other.didJustJump;
     isRotating = other.isRotating;
     isSideways = other.isSideways;
 }
 
-template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
-    this->writeValue(data.position);
-    this->writeValue(data.rotation);
-    this->writeValue(data.iconType);
+// these match the bit order of the packed `SpecificIconData` and `PlayerData` serialization
 
+static BitBuffer<16> iconFlagBits(const SpecificIconData& data) {
     BitBuffer<16> bits;
     bits.writeBits(
         data.isVisible,
@@ -34,23 +32,14 @@ template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
         data.isGrounded,
         data.isStationary,
         data.isFalling,
-        data.didJustJump,
         data.isRotating,
         data.isSideways
     );
-    this->writeBits(bits);
 
-    this->writeValue(data.spiderTeleportData);
+    return bits;
 }
 
-template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode() {
-    SpecificIconData data;
-
-    GLOBED_UNWRAP_INTO(this->readValue<CCPoint>(), data.position);
-    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.rotation);
-    GLOBED_UNWRAP_INTO(this->readValue<PlayerIconType>(), data.iconType);
-
-    GLOBED_UNWRAP_INTO(this->readBits<16>(), auto bits);
+static void readIconFlagBits(BitBuffer<16>& bits, SpecificIconData& data) {
     bits.readBitsInto(
         data.isVisible,
         data.isLookingLeft,
@@ -60,39 +49,292 @@ template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode()
         data.isGrounded,
         data.isStationary,
         data.isFalling,
-        data.didJustJump,
         data.isRotating,
         data.isSideways
     );
+}
+
+static BitBuffer<8> playerFlagBits(const PlayerData& data) {
+    return BitBuffer<8>(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding);
+}
 
-    GLOBED_UNWRAP_INTO(this->readValue<std::optional<SpiderTeleportData>>(), data.spiderTeleportData);
+/* PlayerEventList */
 
-    return Ok(data);
+void PlayerEventList::push(const PlayerEvent& event) {
+    if (count == CAPACITY) {
+        std::move(events.begin() + 1, events.end(), events.begin());
+        count--;
+    }
+
+    events[count++] = event;
 }
 
-template<> void ByteBuffer::customEncode(const PlayerData& data) {
+// the top bit of the type byte tells which icon the event is for
+static constexpr uint8_t EVENT_PLAYER2_BIT = 0x80;
+
+template<> void ByteBuffer::customEncode(const PlayerEventList& list) {
+    this->writeU8(list.count);
+
+    for (const auto& event : list) {
+        this->writeU16(event.sequence);
+        this->writeU8(static_cast<uint8_t>(event.type) | (event.player2 ? EVENT_PLAYER2_BIT : 0));
+
+        if (event.type == PlayerEventType::SpiderTeleport) {
+            this->writeValue(event.teleport);
+        }
+    }
+}
+
+template<> ByteBuffer::DecodeResult<PlayerEventList> ByteBuffer::customDecode() {
+    PlayerEventList list;
+
+    GLOBED_UNWRAP_INTO(this->readU8(), uint8_t count);
+    if (count > PlayerEventList::CAPACITY) {
+        return Err(DecodeError::LengthPrefixTooLong);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        PlayerEvent event {};
+
+        GLOBED_UNWRAP_INTO(this->readU16(), event.sequence);
+        GLOBED_UNWRAP_INTO(this->readU8(), uint8_t type);
+
+        event.player2 = (type & EVENT_PLAYER2_BIT) != 0;
+        type &= ~EVENT_PLAYER2_BIT;
+
+        if (type > static_cast<uint8_t>(PlayerEventType::SpiderTeleport)) {
+            return Err(DecodeError::InvalidEnumValue);
+        }
+
+        event.type = static_cast<PlayerEventType>(type);
+
+        if (event.type == PlayerEventType::SpiderTeleport) {
+            GLOBED_UNWRAP_INTO(this->readValue<SpiderTeleportData>(), event.teleport);
+        }
+
+        list.push(event);
+    }
+
+    return Ok(list);
+}
+
+/* PlayerDataDelta */
+
+// bit layout of the change mask, player 2 uses the same bits as player 1 shifted by `DELTA_ICON_BITS`
+enum DeltaMask : uint16_t {
+    DELTA_POSITION = 1 << 0,
+    DELTA_ROTATION = 1 << 1,
+    DELTA_STATE = 1 << 2, // icon type and flags
+    DELTA_ICON_BITS = 3,
+
+    DELTA_EVENTS = 1 << 8,
+    DELTA_PERCENTAGE = 1 << 9,
+    DELTA_FLAGS = 1 << 10,
+
+    DELTA_ALL = 0x073f,
+};
+
+static uint16_t iconDeltaMask(const SpecificIconData& base, const SpecificIconData& data) {
+    uint16_t mask = 0;
+
+    if (base.position.x != data.position.x || base.position.y != data.position.y) mask |= DELTA_POSITION;
+    if (base.rotation != data.rotation) mask |= DELTA_ROTATION;
+    if (base.iconType != data.iconType || iconFlagBits(base).contents() != iconFlagBits(data).contents()) mask |= DELTA_STATE;
+
+    return mask;
+}
+
+static void writeIconDelta(ByteBuffer& buf, uint16_t mask, const SpecificIconData& data) {
+    if (mask & DELTA_POSITION) buf.writeValue(data.position);
+    if (mask & DELTA_ROTATION) buf.writeValue(data.rotation);
+    if (mask & DELTA_STATE) {
+        buf.writeValue(data.iconType);
+        buf.writeBits(iconFlagBits(data));
+    }
+}
+
+static ByteBuffer::DecodeResult<> readIconDelta(ByteBuffer& buf, uint16_t mask, SpecificIconData& data) {
+    if (mask & DELTA_POSITION) {
+        GLOBED_UNWRAP_INTO(buf.readValue<CCPoint>(), data.position);
+    }
+    if (mask & DELTA_ROTATION) {
+        GLOBED_UNWRAP_INTO(buf.readValue<float>(), data.rotation);
+    }
+    if (mask & DELTA_STATE) {
+        GLOBED_UNWRAP_INTO(buf.readValue<PlayerIconType>(), data.iconType);
+        GLOBED_UNWRAP_INTO(buf.readBits<16>(), auto bits);
+        readIconFlagBits(bits, data);
+    }
+
+    return Ok();
+}
+
+template<> void ByteBuffer::customEncode(const PlayerDataDelta& delta) {
+    const auto& base = delta.base;
+    const auto& data = delta.data;
+
+    uint16_t mask = DELTA_ALL;
+
+    if (!delta.keyframe) {
+        mask = iconDeltaMask(base.player1, data.player1)
+            | (iconDeltaMask(base.player2, data.player2) << DELTA_ICON_BITS);
+
+        if (base.currentPercentage != data.currentPercentage) mask |= DELTA_PERCENTAGE;
+        if (playerFlagBits(base).contents() != playerFlagBits(data).contents()) mask |= DELTA_FLAGS;
+    }
+
+    // events belong to the frame they're sent with and never carry over from the keyframe
+    if (data.events.empty()) {
+        mask &= ~DELTA_EVENTS;
+    } else {
+        mask |= DELTA_EVENTS;
+    }
+
+    this->writeU8(delta.keyframeId);
+    this->writeBool(delta.keyframe);
+    this->writeU16(mask);
+
     this->writeValue(data.timestamp);
-    this->writeValue(data.player1);
-    this->writeValue(data.player2);
-    this->writeValue(data.lastDeathTimestamp);
-    this->writeValue(data.currentPercentage);
+    writeIconDelta(*this, mask, data.player1);
+    writeIconDelta(*this, mask >> DELTA_ICON_BITS, data.player2);
 
-    BitBuffer<8> bits;
-    bits.writeBits(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding);
-    this->writeBits(bits);
+    if (mask & DELTA_PERCENTAGE) this->writeValue(data.currentPercentage);
+    if (mask & DELTA_FLAGS) this->writeBits(playerFlagBits(data));
+    if (mask & DELTA_EVENTS) this->writeValue(data.events);
 }
 
-template<> ByteBuffer::DecodeResult<PlayerData> ByteBuffer::customDecode() {
-    PlayerData data;
+// the client never receives deltas, the changes are applied on top of a default base.
+template<> ByteBuffer::DecodeResult<PlayerDataDelta> ByteBuffer::customDecode() {
+    PlayerDataDelta delta {};
+
+    GLOBED_UNWRAP_INTO(this->readU8(), delta.keyframeId);
+    GLOBED_UNWRAP_INTO(this->readBool(), delta.keyframe);
+    GLOBED_UNWRAP_INTO(this->readU16(), uint16_t mask);
+
+    auto& data = delta.data;
+    data = delta.base;
+
+    GLOBED_UNWRAP_INTO(this->readValue<double>(), data.timestamp);
+    GLOBED_UNWRAP(readIconDelta(*this, mask, data.player1));
+    GLOBED_UNWRAP(readIconDelta(*this, mask >> DELTA_ICON_BITS, data.player2));
+
+    if (mask & DELTA_PERCENTAGE) {
+        GLOBED_UNWRAP_INTO(this->readValue<float>(), data.currentPercentage);
+    }
+    if (mask & DELTA_FLAGS) {
+        GLOBED_UNWRAP_INTO(this->readBits<8>(), auto bits);
+        bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding);
+    }
+
+    data.events = {};
+    if (mask & DELTA_EVENTS) {
+        GLOBED_UNWRAP_INTO(this->readValue<PlayerEventList>(), data.events);
+    }
+
+    return Ok(delta);
+}
+
+/* QuantizedLevelData */
+
+static void writeQuantizedIcon(ByteBuffer& buf, const CCPoint& anchor, const SpecificIconData& data) {
+    using QLD = QuantizedLevelData;
+
+    float dx = std::round((data.position.x - anchor.x) * QLD::POSITION_SCALE);
+    float dy = std::round((data.position.y - anchor.y) * QLD::POSITION_SCALE);
+
+    constexpr float lower = QLD::POSITION_ESCAPE;
+    constexpr float upper = std::numeric_limits<int16_t>::max();
+
+    if (dx > lower && dx <= upper && dy > lower && dy <= upper) {
+        buf.writeI16(static_cast<int16_t>(dx));
+        buf.writeI16(static_cast<int16_t>(dy));
+    } else {
+        buf.writeI16(QLD::POSITION_ESCAPE);
+        buf.writeValue(data.position);
+    }
+
+    float turns = std::fmod(data.rotation, 360.f);
+    if (turns < 0.f) turns += 360.f;
+    buf.writeU16(static_cast<uint16_t>(static_cast<uint32_t>(turns / 360.f * 65536.f) & 0xffff));
+
+    buf.writeValue(data.iconType);
+    buf.writeBits(iconFlagBits(data));
+}
 
-    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.timestamp);
-    GLOBED_UNWRAP_INTO(this->readValue<SpecificIconData>(), data.player1);
-    GLOBED_UNWRAP_INTO(this->readValue<SpecificIconData>(), data.player2);
-    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.lastDeathTimestamp);
-    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.currentPercentage);
+static ByteBuffer::DecodeResult<> readQuantizedIcon(ByteBuffer& buf, const CCPoint& anchor, SpecificIconData& data) {
+    using QLD = QuantizedLevelData;
+
+    GLOBED_UNWRAP_INTO(buf.readI16(), int16_t dx);
+    if (dx == QLD::POSITION_ESCAPE) {
+        GLOBED_UNWRAP_INTO(buf.readValue<CCPoint>(), data.position);
+    } else {
+        GLOBED_UNWRAP_INTO(buf.readI16(), int16_t dy);
+        data.position = CCPoint {
+            anchor.x + static_cast<float>(dx) / QLD::POSITION_SCALE,
+            anchor.y + static_cast<float>(dy) / QLD::POSITION_SCALE
+        };
+    }
+
+    GLOBED_UNWRAP_INTO(buf.readU16(), uint16_t rotation);
+    data.rotation = static_cast<float>(rotation) / 65536.f * 360.f;
+
+    GLOBED_UNWRAP_INTO(buf.readValue<PlayerIconType>(), data.iconType);
+    GLOBED_UNWRAP_INTO(buf.readBits<16>(), auto bits);
+    readIconFlagBits(bits, data);
+
+    return Ok();
+}
+
+template<> void ByteBuffer::customEncode(const QuantizedLevelData& level) {
+    this->writeValue(level.anchor);
+    this->writeLength(level.players.size());
+
+    for (const auto& player : level.players) {
+        const auto& data = player.data;
+
+        this->writeI32(player.accountId);
+        this->writeValue(data.timestamp);
+        writeQuantizedIcon(*this, level.anchor, data.player1);
+        writeQuantizedIcon(*this, level.anchor, data.player2);
+        this->writeValue(data.currentPercentage);
+        this->writeBits(playerFlagBits(data));
+        this->writeValue(data.events);
+    }
+}
+
+template<> ByteBuffer::DecodeResult<> ByteBuffer::customDecodeInto(QuantizedLevelData& level) {
+    GLOBED_UNWRAP_INTO(this->readValue<CCPoint>(), level.anchor);
+    GLOBED_UNWRAP_INTO(this->readLength(), size_t length);
+
+    level.players.clear();
+
+    // don't let a bogus length make us allocate a lot upfront
+    if (sizeof(AssociatedPlayerData) * length < (2 << 15)) {
+        level.players.reserve(length);
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        auto& player = level.players.emplace_back();
+        auto& data = player.data;
+
+        GLOBED_UNWRAP_INTO(this->readI32(), player.accountId);
+        GLOBED_UNWRAP_INTO(this->readValue<double>(), data.timestamp);
+        GLOBED_UNWRAP(readQuantizedIcon(*this, level.anchor, data.player1));
+        GLOBED_UNWRAP(readQuantizedIcon(*this, level.anchor, data.player2));
+        GLOBED_UNWRAP_INTO(this->readValue<float>(), data.currentPercentage);
+
+        GLOBED_UNWRAP_INTO(this->readBits<8>(), auto bits);
+        bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding);
+
+        GLOBED_UNWRAP_INTO(this->readValue<PlayerEventList>(), data.events);
+    }
+
+    return Ok();
+}
 
-    GLOBED_UNWRAP_INTO(this->readBits<8>(), auto bits);
-    bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding);
+template<> ByteBuffer::DecodeResult<QuantizedLevelData> ByteBuffer::customDecode() {
+    QuantizedLevelData level;
+    GLOBED_UNWRAP(this->customDecodeInto(level));
 
-    return Ok(data);
+    return Ok(std::move(level));
 }
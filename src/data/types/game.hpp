@@ -16,13 +16,72 @@ enum class PlayerIconType : uint8_t {
 
 GLOBED_SERIALIZABLE_ENUM(PlayerIconType, Unknown, Cube, Ship, Ball, Ufo, Wave, Robot, Spider, Swing, Jetpack);
 
+// Set of icon types, one bit per `PlayerIconType`
+using PlayerIconTypeMask = uint16_t;
+
+constexpr PlayerIconTypeMask iconTypeBit(PlayerIconType type) {
+    return static_cast<PlayerIconTypeMask>(1 << static_cast<int>(type));
+}
+
+// Cube through Jetpack
+constexpr PlayerIconTypeMask ALL_ICON_TYPES = 0b11'1111'1110;
+
 struct SpiderTeleportData {
     cocos2d::CCPoint from, to;
 };
 
 GLOBED_SERIALIZABLE_STRUCT(SpiderTeleportData, (from, to));
 
+enum class PlayerEventType : uint8_t {
+    Jump = 0,
+    Death = 1,
+    SpiderTeleport = 2,
+};
+
+/*
+* PlayerEvent - something that happened once, like a jump or a death. Unlike the rest of `PlayerData`, events can't be
+* made up from the frames around them, so a lost frame must not lose them. Every event is repeated in the frames
+* sent shortly after it (see `GlobedGJBGL::queuePlayerEvent`), and the receiver uses the sequence number to skip the repeats.
+*/
+struct PlayerEvent {
+    uint16_t sequence;
+    PlayerEventType type;
+    bool player2;                // happened to the second icon, unused for deaths
+    SpiderTeleportData teleport; // only for `SpiderTeleport`
+};
+
+struct PlayerEventList {
+    static constexpr size_t CAPACITY = 4;
+    // count, the rest only when there are events
+    static constexpr size_t ENCODED_SIZE_HINT = 1;
+
+    std::array<PlayerEvent, CAPACITY> events{};
+    uint8_t count = 0;
+
+    // Adds an event to the end, dropping the oldest one if the list is full
+    void push(const PlayerEvent& event);
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const PlayerEvent* begin() const {
+        return events.data();
+    }
+
+    const PlayerEvent* end() const {
+        return events.data() + count;
+    }
+};
+
 struct SpecificIconData {
+    // position, rotation, icon type, flags
+    static constexpr size_t ENCODED_SIZE_HINT = 8 + 4 + 1 + 2;
+
     void copyFlagsFrom(const SpecificIconData& other);
 
     cocos2d::CCPoint position;
@@ -38,20 +97,36 @@ struct SpecificIconData {
     bool isStationary;      // true if player is not moving currently (in platformer)
     bool isFalling;         // when !isGrounded, true if falling, false if jumping upwards
 
-    bool didJustJump;       // true on the next frame after the player performed a jump
     bool isRotating;        // true if player is, well, rotating
     bool isSideways;        // true if player is stuck to a wall
-    std::optional<SpiderTeleportData> spiderTeleportData;
 };
 
+GLOBED_SERIALIZABLE_PACKED_STRUCT(SpecificIconData, (
+    position,
+    rotation,
+    iconType,
+    isVisible,
+    isLookingLeft,
+    isUpsideDown,
+    isDashing,
+    isMini,
+    isGrounded,
+    isStationary,
+    isFalling,
+    isRotating,
+    isSideways
+));
+
 struct PlayerData {
-    float timestamp;
+    // timestamp, both players, percentage, flags, events
+    static constexpr size_t ENCODED_SIZE_HINT = 8 + SpecificIconData::ENCODED_SIZE_HINT * 2 + 4 + 1 + PlayerEventList::ENCODED_SIZE_HINT;
+
+    // seconds on the server clock, see `NetworkManager::serverTime`
+    double timestamp;
 
     SpecificIconData player1;
     SpecificIconData player2;
 
-    float lastDeathTimestamp;
-
     float currentPercentage;
 
     bool isDead;
@@ -60,11 +135,44 @@ struct PlayerData {
     bool isDualMode;
     bool isInEditor;
     bool isEditorBuilding; // in the editor && not playtesting (incl. not paused)
+
+    PlayerEventList events;
+};
+
+GLOBED_SERIALIZABLE_PACKED_STRUCT(PlayerData, (
+    timestamp,
+    player1,
+    player2,
+    currentPercentage,
+    isDead,
+    isPaused,
+    isPracticing,
+    isDualMode,
+    isInEditor,
+    isEditorBuilding,
+    events
+));
+
+/*
+* PlayerDataDelta - `data` encoded relative to `base`, an earlier keyframe that was sent to the server.
+* Only the fields that differ from the base get written, prefixed with a change mask.
+* Deltas are always made against the keyframe and not the previous packet, so a lost delta never breaks the chain.
+*/
+struct PlayerDataDelta {
+    // keyframe id, keyframe flag, change mask, all fields
+    static constexpr size_t ENCODED_SIZE_HINT = 1 + 1 + 2 + PlayerData::ENCODED_SIZE_HINT;
+
+    uint8_t keyframeId;
+    bool keyframe; // if true, all fields are written and the server stores the result as the new base
+    PlayerData base;
+    PlayerData data;
 };
 
 struct PlayerMetadata {
     uint32_t localBest;
     int32_t attempts;
+
+    bool operator==(const PlayerMetadata& other) const = default;
 };
 
 GLOBED_SERIALIZABLE_STRUCT(PlayerMetadata, (
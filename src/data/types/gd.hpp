@@ -13,6 +13,10 @@
 static constexpr uint8_t NO_GLOW = -1;
 static constexpr uint8_t NO_TRAIL = 1;
 
+// same as `MAX_NAME_SIZE` on the server
+static constexpr size_t MAX_NAME_SIZE = 24;
+using PlayerName = InlineString<MAX_NAME_SIZE>;
+
 class PlayerIconData {
 public:
     static const PlayerIconData DEFAULT_ICONS;
@@ -56,6 +60,8 @@ public:
 
     PlayerIconDataSimple(const PlayerIconData& data) : PlayerIconDataSimple(data.cube, data.color1, data.color2, data.glowColor) {}
 
+    bool operator==(const PlayerIconDataSimple&) const = default;
+
     int16_t cube;
     uint8_t color1, color2, glowColor;
 };
@@ -78,12 +84,14 @@ GLOBED_SERIALIZABLE_STRUCT(SpecialUserData, (
 
 class PlayerRoomPreviewAccountData {
 public:
-    PlayerRoomPreviewAccountData(int32_t id, int32_t userId, std::string name, PlayerIconDataSimple icons, LevelId levelId, const SpecialUserData& specialUserData)
+    PlayerRoomPreviewAccountData(int32_t id, int32_t userId, const std::string_view name, PlayerIconDataSimple icons, LevelId levelId, const SpecialUserData& specialUserData)
         : accountId(id), userId(userId), name(name), icons(icons), levelId(levelId), specialUserData(specialUserData) {}
     PlayerRoomPreviewAccountData() {}
 
+    bool operator==(const PlayerRoomPreviewAccountData&) const = default;
+
     int32_t accountId, userId;
-    std::string name;
+    PlayerName name;
     PlayerIconDataSimple icons;
     LevelId levelId;
     SpecialUserData specialUserData;
@@ -95,12 +103,14 @@ GLOBED_SERIALIZABLE_STRUCT(PlayerRoomPreviewAccountData, (
 
 class PlayerPreviewAccountData {
 public:
-    PlayerPreviewAccountData(int32_t id, int32_t userId, std::string name, PlayerIconDataSimple icons, int32_t levelId)
+    PlayerPreviewAccountData(int32_t id, int32_t userId, const std::string_view name, PlayerIconDataSimple icons, int32_t levelId)
         : accountId(id), userId(userId), name(name), icons(icons) {}
     PlayerPreviewAccountData() {}
 
+    bool operator==(const PlayerPreviewAccountData&) const = default;
+
     int32_t accountId, userId;
-    std::string name;
+    PlayerName name;
     PlayerIconDataSimple icons;
     SpecialUserData specialUserData;
 
@@ -141,7 +151,7 @@ public:
     }
 
     int32_t accountId, userId;
-    std::string name;
+    PlayerName name;
     PlayerIconData icons;
     SpecialUserData specialUserData;
 };
@@ -170,6 +180,18 @@ GLOBED_SERIALIZABLE_STRUCT(AssociatedPlayerData, (
     accountId, data
 ));
 
+// Same as a list of `AssociatedPlayerData`, except positions are 16-bit fixed-point offsets from `anchor`
+// and rotations are 16-bit fractions of a full turn. Positions too far from the anchor are sent in full.
+struct QuantizedLevelData {
+    static constexpr float POSITION_SCALE = 4.f;
+    static constexpr int16_t POSITION_ESCAPE = std::numeric_limits<int16_t>::min();
+    // pooled packets decode into the existing `players` and keep its capacity
+    static constexpr bool CUSTOM_DECODE_INTO = true;
+
+    cocos2d::CCPoint anchor;
+    std::vector<AssociatedPlayerData> players;
+};
+
 class AssociatedPlayerMetadata {
 public:
     AssociatedPlayerMetadata(int accountId, const PlayerMetadata& data) : accountId(accountId), data(data) {}
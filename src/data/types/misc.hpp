@@ -13,10 +13,11 @@ GLOBED_SERIALIZABLE_STRUCT(GameServerEntry, (
     id, name, address, region
 ));
 
+// ids and player counts are mostly small, so they are sent as varints
 class GlobedLevel {
 public:
-    LevelId levelId;
-    unsigned short playerCount;
+    Varint<LevelId> levelId;
+    Varint<unsigned short> playerCount;
 };
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedLevel, (
@@ -8,15 +8,16 @@ struct RoomSettingsFlags : BitfieldBase {
     bool publicInvites;
     bool collision;
     bool twoPlayerMode;
+    bool limitSpeakers; // only a few players on a level can talk at once, see `MAX_LEVEL_SPEAKERS` on the server
 
     // we need the struct to be 2 bytes
-    bool _pad1, _pad2, _pad3, _pad4, _pad5;
+    bool _pad1, _pad2, _pad3, _pad4;
 };
 
 static_assert((sizeof(RoomSettingsFlags) + 7) / 8 == 2);
 
 GLOBED_SERIALIZABLE_BITFIELD(RoomSettingsFlags, (
-    isHidden, publicInvites, collision, twoPlayerMode
+    isHidden, publicInvites, collision, twoPlayerMode, limitSpeakers
 ))
 
 struct RoomSettings {
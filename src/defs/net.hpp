@@ -4,6 +4,7 @@
 /*
 * GLOBED_SOCKET_POLL - poll function
 * GLOBED_SOCKET_POLLFD - pollfd structure
+* GLOBED_HAS_RECVMMSG - 0 or 1, whether `recvmmsg` and `sendmmsg` can be used to receive or send multiple datagrams in one syscall
 */
 
 #ifdef GEODE_IS_WINDOWS
@@ -17,3 +18,9 @@
 # define GLOBED_SOCKET_POLLFD struct pollfd
 
 #endif
+
+#ifdef GEODE_IS_ANDROID
+# define GLOBED_HAS_RECVMMSG 1
+#else
+# define GLOBED_HAS_RECVMMSG 0
+#endif
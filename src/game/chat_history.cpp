@@ -0,0 +1,78 @@
+#include "chat_history.hpp"
+
+#include <managers/profile_cache.hpp>
+
+void ChatHistory::push(int accountId, std::string_view text) {
+    // the oldest message is about to be overwritten
+    if (messages.size() == messages.capacity()) {
+        this->release(messages.front().sender);
+    }
+
+    messages.push(Message {
+        .seq = pushed++,
+        .sender = this->intern(accountId),
+        .text = ChatText(text),
+    });
+}
+
+void ChatHistory::clear() {
+    messages.clear();
+    senders.clear();
+}
+
+const ChatHistory::Message& ChatHistory::at(size_t index) const {
+    return messages[index];
+}
+
+const ChatHistory::Sender& ChatHistory::senderOf(const Message& message) const {
+    return senders[message.sender];
+}
+
+size_t ChatHistory::size() const {
+    return messages.size();
+}
+
+uint64_t ChatHistory::totalPushed() const {
+    return pushed;
+}
+
+uint16_t ChatHistory::intern(int accountId) {
+    size_t freeSlot = senders.size();
+
+    for (size_t i = 0; i < senders.size(); i++) {
+        auto& sender = senders[i];
+
+        if (sender.refs != 0 && sender.accountId == accountId) {
+            sender.refs++;
+            return static_cast<uint16_t>(i);
+        }
+
+        if (sender.refs == 0 && freeSlot == senders.size()) {
+            freeSlot = i;
+        }
+    }
+
+    // there can't be more senders than messages, so this never grows past `CAPACITY`
+    if (freeSlot == senders.size()) {
+        senders.emplace_back();
+    }
+
+    auto& pcm = ProfileCacheManager::get();
+    auto& sender = senders[freeSlot];
+    sender.accountId = accountId;
+    sender.refs = 1;
+
+    if (accountId == pcm.getOwnAccountData().accountId) {
+        sender.name = pcm.getOwnAccountData().name;
+    } else if (auto* data = pcm.findData(accountId)) {
+        sender.name = data->name;
+    } else {
+        sender.name = PlayerName{};
+    }
+
+    return static_cast<uint16_t>(freeSlot);
+}
+
+void ChatHistory::release(uint16_t sender) {
+    senders[sender].refs--;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string_view>
+#include <vector>
+
+#include <data/types/basic/inline_string.hpp>
+#include <data/types/gd.hpp>
+#include <util/collections.hpp>
+
+// same as `MAX_MESSAGE_SIZE` on the server
+static constexpr size_t MAX_CHAT_MESSAGE_SIZE = 156;
+using ChatText = InlineString<MAX_CHAT_MESSAGE_SIZE>;
+
+// Chat messages of the current level, in a fixed capacity ring, once it's full the oldest messages are dropped.
+// Senders are interned, every message only keeps a small index into the sender table, and a sender is forgotten once none of its messages are left.
+class ChatHistory {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    struct Sender {
+        int accountId;
+        PlayerName name; // as of the first message, empty if the profile wasn't known yet
+        uint32_t refs; // free slot if zero
+    };
+
+    struct Message {
+        uint64_t seq; // unique for the lifetime of the history, lists use it to tell if a row shows the same message
+        uint16_t sender;
+        ChatText text;
+    };
+
+    void push(int accountId, std::string_view text);
+    void clear();
+
+    // 0 is the oldest message
+    const Message& at(size_t index) const;
+    const Sender& senderOf(const Message& message) const;
+
+    size_t size() const;
+    // total amount of messages ever pushed, changes whenever a message arrives, even if the size stays the same
+    uint64_t totalPushed() const;
+
+private:
+    util::collections::CappedQueue<Message, CAPACITY> messages;
+    std::vector<Sender> senders;
+    uint64_t pushed = 0;
+
+    uint16_t intern(int accountId);
+    void release(uint16_t sender);
+};
@@ -0,0 +1,28 @@
+#include "collision_grid.hpp"
+
+#include <cmath>
+
+void CollisionGrid::clear() {
+    entries.clear();
+}
+
+void CollisionGrid::insert(const cocos2d::CCPoint& position, ComplexVisualPlayer* player) {
+    entries.push_back(Entry {
+        .key = makeKey(cellOf(position.x), cellOf(position.y)),
+        .player = player,
+    });
+}
+
+void CollisionGrid::finish() {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.key < b.key;
+    });
+}
+
+int CollisionGrid::cellOf(float coord) {
+    return static_cast<int>(std::floor(coord / CELL_SIZE));
+}
+
+uint64_t CollisionGrid::makeKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
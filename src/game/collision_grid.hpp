@@ -0,0 +1,54 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <algorithm>
+#include <vector>
+
+class ComplexVisualPlayer;
+
+// Uniform grid broadphase for player collision. Remote players are bucketed by the cell their position falls into,
+// and `query` only returns the ones in cells around the given rect. Rebuilt from scratch every frame,
+// which is cheap since the entries are just sorted by cell and no memory is allocated once the vector has grown.
+class CollisionGrid {
+public:
+    // big enough that a player rect never spans more than 2 cells
+    static constexpr float CELL_SIZE = 128.f;
+    // how far a player's rect can extend from their position
+    static constexpr float MAX_EXTENT = 64.f;
+
+    void clear();
+    void insert(const cocos2d::CCPoint& position, ComplexVisualPlayer* player);
+    // Sorts the entries, must be called after inserting and before querying
+    void finish();
+
+    // Calls `func` with every player whose position is close enough to `rect` that they could be intersecting it
+    template <typename F>
+    void query(const cocos2d::CCRect& rect, F&& func) const {
+        int minX = cellOf(rect.getMinX() - MAX_EXTENT), maxX = cellOf(rect.getMaxX() + MAX_EXTENT);
+        int minY = cellOf(rect.getMinY() - MAX_EXTENT), maxY = cellOf(rect.getMaxY() + MAX_EXTENT);
+
+        for (int x = minX; x <= maxX; x++) {
+            for (int y = minY; y <= maxY; y++) {
+                uint64_t key = makeKey(x, y);
+                auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, uint64_t key) {
+                    return e.key < key;
+                });
+
+                for (; it != entries.end() && it->key == key; it++) {
+                    func(it->player);
+                }
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        ComplexVisualPlayer* player;
+    };
+
+    std::vector<Entry> entries;
+
+    static int cellOf(float coord);
+    static uint64_t makeKey(int x, int y);
+};
@@ -5,122 +5,359 @@
 #include <util/math.hpp>
 #include <util/debug.hpp>
 #include <util/format.hpp>
+#include <util/profiler.hpp>
+#include <util/simd.hpp>
 
 using namespace geode::prelude;
 
-PlayerInterpolator::PlayerInterpolator(const InterpolatorSettings& settings) : settings(settings) {}
+PlayerInterpolator::PlayerInterpolator(const InterpolatorSettings& settings, const PlayerSlots& slots) : slots(slots), settings(settings) {}
 
 void PlayerInterpolator::addPlayer(int playerId) {
-    players.emplace(playerId, PlayerState {});
-#ifdef GLOBED_DEBUG_INTERPOLATION
-    LerpLogger::get().reset(playerId);
-#endif
+    // the registry hands out slots in order, so a new player always ends up right after the last one
+    if (slots.find(playerId) == states.size()) {
+        states.emplace_back();
+        lanes.resize(states.size() * 2);
+    }
+
+    GLOBED_LERP_LOG(reset, playerId);
 }
 
-void PlayerInterpolator::removePlayer(int playerId) {
-    players.erase(playerId);
+void PlayerInterpolator::removePlayer(const PlayerSlots::Removal& removal) {
+    if (removal.slot == PlayerSlots::INVALID) return;
+
+    // mirror the registry, which moved the last player into the freed slot
+    if (removal.slot != removal.last) {
+        states[removal.slot] = std::move(states[removal.last]);
+
+        lanes.moveLane(removal.last * 2, removal.slot * 2);
+        lanes.moveLane(removal.last * 2 + 1, removal.slot * 2 + 1);
+    }
+
+    states.pop_back();
+    lanes.resize(states.size() * 2);
 }
 
 bool PlayerInterpolator::hasPlayer(int playerId) {
-    return players.contains(playerId);
+    return slots.find(playerId) < states.size();
+}
+
+void PlayerInterpolator::setDormantAt(size_t slot, bool dormant) {
+    auto& player = states.at(slot);
+    if (player.dormant == dormant) return;
+
+    player.dormant = dormant;
+
+    // the lanes still hold whatever frames were loaded before it went dormant
+    if (!dormant) {
+        player.olderTimestamp = -1.0;
+        player.newerTimestamp = -1.0;
+    }
+}
+
+bool PlayerInterpolator::isDormantAt(size_t slot) {
+    return states.at(slot).dormant;
 }
 
-void PlayerInterpolator::updatePlayer(int playerId, const PlayerData& data, float updateCounter) {
-    auto& player = players.at(playerId);
+void PlayerInterpolator::setExpectedDelta(float delta) {
+    settings.expectedDelta = delta;
+}
+
+void PlayerInterpolator::setLowLatency(int playerId, float expectedDelta) {
+    states.at(slots.find(playerId)).lowLatencyDelta = expectedDelta;
+}
+
+void PlayerInterpolator::updatePlayer(int playerId, const PlayerData& data, double updateCounter) {
+    GLOBED_PROFILE_INSTANT("interpolator: player update", playerId, 0);
+
+    size_t slot = slots.find(playerId);
+    auto& player = states.at(slot);
+
+    // far away players are updated less often by the server, so keep track of how often this one arrives
+    if (player.updateCounter != 0.0) {
+        float interval = static_cast<float>(updateCounter - player.updateCounter);
+        player.updateInterval = player.updateInterval == 0.f ? interval : std::lerp(player.updateInterval, interval, 0.25f);
+    }
+
     player.updateCounter = updateCounter;
     player.pendingRealFrame = true;
     player.totalFrames++;
 
-    if (!util::math::equal(player.lastDeathTimestamp, data.lastDeathTimestamp)) {
-        player.lastDeathTimestamp = data.lastDeathTimestamp;
-        if (player.totalFrames > 1) {
-            player.frameFlags.pendingDeath = true;
-        }
-    }
+    this->applyEvents(player, data.events);
 
-    player.frameFlags.pendingP1Teleport = data.player1.spiderTeleportData;
-    player.frameFlags.pendingP2Teleport = data.player2.spiderTeleportData;
-    player.frameFlags.pendingP1Jump = data.player1.didJustJump;
-    player.frameFlags.pendingP2Jump = data.player1.didJustJump;
+    GLOBED_LERP_LOG(logRealFrame, playerId, this->getLocalTs(), data.timestamp, data.player1);
 
-    LerpLogger::get().logRealFrame(playerId, this->getLocalTs(), data.timestamp, data.player1);
+    // nothing is interpolated for dormant players, the status of the newest frame is all that's needed
+    if (player.dormant) {
+        player.interpolatedState = data;
+    }
 
-    if (settings.realtime) {
+    // builders in the editor don't move, their status is shown as is and the buffer starts over once they playtest
+    if (settings.realtime || data.isEditorBuilding) {
         player.interpolatedState = data;
+        player.snapshotCount = 0;
         return;
     }
 
-    player.olderFrame = player.newerFrame;
-    player.newerFrame = data;
+    if (player.snapshotCount > 0) {
+        double newest = player.snapshot(player.snapshotCount - 1).timestamp;
 
-    player.timeCounter = player.olderFrame.timestamp;
-}
+        if (data.timestamp < newest - TIMELINE_RESET) {
+            player.snapshotCount = 0;
+            player.jitter = 0.f;
+            player.rate = 1.f;
+        } else if (data.timestamp <= newest) {
+            // frames that arrive out of order are older than the ones we have, they only matter for the flags above
+            return;
+        }
+    }
 
-static inline void lerpSpecific(
-        const SpecificIconData& older,
-        const SpecificIconData& newer,
-        SpecificIconData& out,
-        float lerpRatio
-    ) {
+    // jitter is how much the transit time changes between frames, any leftover clock offset between us and the sender cancels out
+    float transit = static_cast<float>(updateCounter - data.timestamp);
+    if (player.snapshotCount > 0) {
+        player.jitter += (std::abs(transit - player.lastTransit) - player.jitter) / 16.f;
+    }
 
-    out.copyFlagsFrom(older);
+    player.lastTransit = transit;
 
-    // i hate spider
-    if (out.iconType == PlayerIconType::Spider && std::abs(older.position.y - newer.position.y) >= 33.f) {
-        out.position.x = std::lerp(older.position.x, newer.position.x, lerpRatio);
-        out.position.y = older.position.y;
+    if (player.lowLatencyDelta != 0.f) {
+        // one frame of the fast stream plus the jitter, the extra delay and headroom are skipped and late frames are extrapolated instead
+        player.playoutDelay = std::clamp(player.lowLatencyDelta + player.jitter, player.lowLatencyDelta, MAX_PLAYOUT_DELAY);
     } else {
-        out.position = older.position.lerp(newer.position, lerpRatio);
+        // show the player about one update behind, plus enough headroom that a late frame usually arrives before it is needed
+        float interval = player.updateInterval == 0.f ? settings.expectedDelta : player.updateInterval;
+        player.playoutDelay = std::clamp(interval + player.jitter * 2.f + settings.extraPlayoutDelay, settings.expectedDelta, MAX_PLAYOUT_DELAY);
     }
-    out.rotation = std::lerp(older.rotation, newer.rotation, lerpRatio);
+
+    player.pushSnapshot(data, updateCounter);
+    this->estimateRate(player);
 }
 
-static inline void lerpPlayer(
-        const VisualPlayerState& older,
-        const VisualPlayerState& newer,
-        VisualPlayerState& out,
-        float lerpRatio
+void PlayerInterpolator::estimateRate(PlayerState& player) {
+    if (player.snapshotCount < 4) return;
+
+    const auto& first = player.snapshot(0);
+    double span = player.snapshot(player.snapshotCount - 1).arrival - first.arrival;
+    if (span < MIN_RATE_SPAN) return;
+
+    // least squares slope of send time over arrival time, relative to the first frame to keep the sums small
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    double n = static_cast<double>(player.snapshotCount);
+
+    for (size_t i = 0; i < player.snapshotCount; i++) {
+        const auto& snap = player.snapshot(i);
+        double x = snap.arrival - first.arrival;
+        double y = snap.timestamp - first.timestamp;
+
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+
+    double denom = n * sumXX - sumX * sumX;
+    if (denom <= 0.0) return;
+
+    // a single window is noisy with jitter, the estimate only follows it slowly
+    float slope = static_cast<float>((n * sumXY - sumX * sumY) / denom);
+    slope = std::clamp(slope, 1.f - MAX_RATE_DEVIATION, 1.f + MAX_RATE_DEVIATION);
+    player.rate += (slope - player.rate) / 16.f;
+}
+
+void PlayerInterpolator::loadFrames(size_t slot, PlayerState& player, size_t newerIdx) {
+    this->loadLane(slot * 2, player, newerIdx, &VisualPlayerState::player1);
+    this->loadLane(slot * 2 + 1, player, newerIdx, &VisualPlayerState::player2);
+
+    const auto& older = player.snapshot(newerIdx - 1);
+    const auto& newer = player.snapshot(newerIdx);
+
+    // flags aren't interpolated, so they are only copied when the frames change and not on every tick
+    auto& out = player.interpolatedState;
+
+    out.player1.copyFlagsFrom(older.visual.player1);
+    out.player2.copyFlagsFrom(older.visual.player2);
+    out.currentPercentage = older.visual.currentPercentage;
+    out.isDead = older.visual.isDead;
+    out.isPaused = older.visual.isPaused;
+    out.isPracticing = older.visual.isPracticing;
+    out.isDualMode = older.visual.isDualMode;
+    out.isInEditor = older.visual.isInEditor;
+    out.isEditorBuilding = older.visual.isEditorBuilding;
+
+    player.olderTimestamp = older.timestamp;
+    player.newerTimestamp = newer.timestamp;
+}
+
+// slope between two frames, scaled to the length of the segment that is being interpolated
+static inline cocos2d::CCPoint segmentTangent(
+        const PlayerInterpolator::Snapshot& before,
+        const PlayerInterpolator::Snapshot& after,
+        SpecificIconData VisualPlayerState::* icon,
+        float segment
     ) {
 
-    lerpSpecific(older.player1, newer.player1, out.player1, lerpRatio);
-    lerpSpecific(older.player2, newer.player2, out.player2, lerpRatio);
+    return ((after.visual.*icon).position - (before.visual.*icon).position) * (segment / static_cast<float>(after.timestamp - before.timestamp));
+}
+
+void PlayerInterpolator::loadLane(size_t lane, const PlayerState& player, size_t newerIdx, SpecificIconData VisualPlayerState::* icon) {
+    const auto& olderFrame = player.snapshot(newerIdx - 1);
+    const auto& newerFrame = player.snapshot(newerIdx);
+    const auto& older = olderFrame.visual.*icon;
+    const auto& newer = newerFrame.visual.*icon;
+
+    lanes.olderX[lane] = older.position.x;
+    lanes.olderY[lane] = older.position.y;
+    lanes.olderRot[lane] = older.rotation;
 
-    out.currentPercentage = older.currentPercentage;
-    out.isDead = older.isDead;
-    out.isPaused = older.isPaused;
-    out.isPracticing = older.isPracticing;
-    out.isDualMode = older.isDualMode;
-    out.isInEditor = older.isInEditor;
-    out.isEditorBuilding = older.isEditorBuilding;
+    lanes.newerX[lane] = newer.position.x;
+    lanes.newerY[lane] = newer.position.y;
+    lanes.newerRot[lane] = newer.rotation;
+
+    // i hate spider
+    bool spiderTeleport = older.iconType == PlayerIconType::Spider && std::abs(older.position.y - newer.position.y) >= 33.f;
+    lanes.targetY[lane] = spiderTeleport ? older.position.y : newer.position.y;
+
+    if (settings.mode != InterpolationMode::Cubic) return;
+
+    // at the ends of the buffer the segment itself is used, which makes that end of the curve linear
+    const auto& before = player.snapshot(newerIdx >= 2 ? newerIdx - 2 : newerIdx - 1);
+    const auto& after = player.snapshot(newerIdx + 1 < player.snapshotCount ? newerIdx + 1 : newerIdx);
+
+    float segment = static_cast<float>(newerFrame.timestamp - olderFrame.timestamp);
+    auto olderTangent = segmentTangent(before, newerFrame, icon, segment);
+    auto newerTangent = segmentTangent(olderFrame, after, icon, segment);
+
+    lanes.olderTanX[lane] = olderTangent.x;
+    lanes.newerTanX[lane] = newerTangent.x;
+
+    // a teleporting spider stays at the same height until the next frame
+    lanes.olderTanY[lane] = spiderTeleport ? 0.f : olderTangent.y;
+    lanes.newerTanY[lane] = spiderTeleport ? 0.f : newerTangent.y;
+}
+
+void PlayerInterpolator::writeLane(size_t lane, SpecificIconData& out) {
+    out.position.x = lanes.outX[lane];
+    out.position.y = lanes.outY[lane];
+    out.rotation = lanes.outRot[lane];
 }
 
 void PlayerInterpolator::tick(float dt) {
-    if (settings.realtime) return;
+    if (settings.realtime || states.empty()) return;
+
+    GLOBED_PROFILE_ZONE("interpolator: tick");
 
-    for (auto& [playerId, player] : players) {
-        if (player.totalFrames < 2) continue;
+    for (size_t slot = 0; slot < states.size(); slot++) {
+        auto& player = states[slot];
+        player.lerping = false;
 
-        float frameDelta = player.newerFrame.timestamp - player.olderFrame.timestamp;
-        if (frameDelta == 0.f) {
-            LerpLogger::get().logLerpSkip(playerId, this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
-            continue;
+        if (player.dormant || player.snapshotCount < 2) continue;
+
+        // drift towards the playout point instead of jumping, unless it's way off (first frames, or after a lag spike)
+        double target = player.snapshot(player.snapshotCount - 1).timestamp - player.playoutDelay;
+        double drift = target - player.timeCounter;
+
+        if (std::abs(drift) > std::max(MAX_DRIFT, player.playoutDelay)) {
+            player.timeCounter = target;
+        } else {
+            player.timeCounter += drift * std::min(dt * DRIFT_CORRECTION, 1.f);
         }
 
-        float lerpRatio = (player.timeCounter - player.olderFrame.timestamp) / frameDelta;
-        lerpPlayer(player.olderFrame.visual, player.newerFrame.visual, player.interpolatedState, lerpRatio);
+        // find the two frames around the shown time, or the last two if we ran past the newest one
+        size_t newerIdx = 1;
+        while (newerIdx < player.snapshotCount - 1 && player.snapshot(newerIdx).timestamp <= player.timeCounter) {
+            newerIdx++;
+        }
 
-        LerpLogger::get().logLerpOperation(playerId, this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+        const auto& older = player.snapshot(newerIdx - 1);
+        const auto& newer = player.snapshot(newerIdx);
 
-        player.timeCounter += dt;
+        if (older.timestamp != player.olderTimestamp || newer.timestamp != player.newerTimestamp) {
+            this->loadFrames(slot, player, newerIdx);
+        }
+
+        // timestamps in the buffer are strictly increasing, so this is never zero
+        float frameDelta = static_cast<float>(newer.timestamp - older.timestamp);
+        float lerpRatio = std::max(static_cast<float>(player.timeCounter - older.timestamp) / frameDelta, 0.f);
+
+        if (lerpRatio > 1.f) {
+            if (settings.extrapolation || (settings.lowLatencyExtrapolation && player.lowLatencyDelta != 0.f)) {
+                lerpRatio = std::min(lerpRatio, 1.f + MAX_EXTRAPOLATION / frameDelta);
+            } else {
+                // the next frame is late, hold the player at the newest one
+                lerpRatio = 1.f;
+                GLOBED_LERP_LOG(logLerpSkip, slots.idAt(slot), this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+            }
+        }
+
+        lanes.ratio[slot * 2] = lerpRatio;
+        lanes.ratio[slot * 2 + 1] = lerpRatio;
+        player.lerping = true;
+    }
+
+    // lanes of players that were skipped get interpolated too, but the result is never written back
+    size_t count = states.size() * 2;
+    if (settings.mode == InterpolationMode::Cubic) {
+        util::simd::hermite(lanes.olderX.data(), lanes.newerX.data(), lanes.olderTanX.data(), lanes.newerTanX.data(), lanes.ratio.data(), lanes.outX.data(), count);
+        util::simd::hermite(lanes.olderY.data(), lanes.targetY.data(), lanes.olderTanY.data(), lanes.newerTanY.data(), lanes.ratio.data(), lanes.outY.data(), count);
+    } else {
+        util::simd::lerp(lanes.olderX.data(), lanes.newerX.data(), lanes.ratio.data(), lanes.outX.data(), count);
+        util::simd::lerp(lanes.olderY.data(), lanes.targetY.data(), lanes.ratio.data(), lanes.outY.data(), count);
+    }
+
+    util::simd::lerpAngle(lanes.olderRot.data(), lanes.newerRot.data(), lanes.ratio.data(), lanes.outRot.data(), count);
+
+    for (size_t slot = 0; slot < states.size(); slot++) {
+        auto& player = states[slot];
+        if (!player.lerping) continue;
+
+        this->writeLane(slot * 2, player.interpolatedState.player1);
+        this->writeLane(slot * 2 + 1, player.interpolatedState.player2);
+
+        GLOBED_LERP_LOG(logLerpOperation, slots.idAt(slot), this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+
+        player.shownTimestamp = player.timeCounter;
+        player.timeCounter += dt * player.rate;
     }
 }
 
 VisualPlayerState& PlayerInterpolator::getPlayerState(int playerId) {
-    return players.at(playerId).interpolatedState;
+    return this->getPlayerStateAt(slots.find(playerId));
+}
+
+void PlayerInterpolator::applyEvents(PlayerState& player, const PlayerEventList& events) {
+    for (const auto& event : events) {
+        // sequence numbers wrap around, anything up to half the range behind the last one is a repeat.
+        // there is nothing to compare against until the first frame that carries events
+        if (player.lastEventSequence && static_cast<int16_t>(event.sequence - *player.lastEventSequence) <= 0) continue;
+
+        player.lastEventSequence = event.sequence;
+
+        // the first frame of a player only tells where their sequence is, the events in it already happened a while ago
+        if (player.totalFrames == 1) continue;
+
+        switch (event.type) {
+            case PlayerEventType::Jump: {
+                (event.player2 ? player.frameFlags.pendingP2Jump : player.frameFlags.pendingP1Jump) = true;
+            } break;
+            case PlayerEventType::Death: {
+                player.frameFlags.pendingDeath = true;
+            } break;
+            case PlayerEventType::SpiderTeleport: {
+                (event.player2 ? player.frameFlags.pendingP2Teleport : player.frameFlags.pendingP1Teleport) = event.teleport;
+            } break;
+        }
+    }
+}
+
+VisualPlayerState& PlayerInterpolator::getPlayerStateAt(size_t slot) {
+    return states.at(slot).interpolatedState;
 }
 
 FrameFlags PlayerInterpolator::swapFrameFlags(int playerId) {
-    auto& state = players.at(playerId);
+    return this->swapFrameFlagsAt(slots.find(playerId));
+}
+
+FrameFlags PlayerInterpolator::swapFrameFlagsAt(size_t slot) {
+    auto& state = states.at(slot);
     FrameFlags out;
     out.pendingDeath = util::misc::swapFlag(state.frameFlags.pendingDeath);
     out.pendingP1Jump = util::misc::swapFlag(state.frameFlags.pendingP1Jump);
@@ -132,22 +369,69 @@ FrameFlags PlayerInterpolator::swapFrameFlags(int playerId) {
     return out;
 }
 
-bool PlayerInterpolator::isPlayerStale(int playerId, float lastServerPacket) {
-    auto uc = players.at(playerId).updateCounter;
+const PlayerInterpolator::Snapshot& PlayerInterpolator::PlayerState::snapshot(size_t idx) const {
+    return snapshots[(snapshotHead + SNAPSHOT_COUNT - snapshotCount + idx) % SNAPSHOT_COUNT];
+}
+
+void PlayerInterpolator::PlayerState::pushSnapshot(const PlayerData& data, double arrival) {
+    snapshots[snapshotHead] = Snapshot {
+        .timestamp = data.timestamp,
+        .arrival = arrival,
+        .visual = data,
+    };
+
+    snapshotHead = (snapshotHead + 1) % SNAPSHOT_COUNT;
+    snapshotCount = std::min(snapshotCount + 1, SNAPSHOT_COUNT);
+}
+
+bool PlayerInterpolator::isPlayerStale(int playerId, double lastServerPacket) {
+    auto& player = states.at(slots.find(playerId));
+    auto uc = player.updateCounter;
+
+    // allow a few missed updates at the player's own cadence, but never less than half a second
+    float threshold = std::max(0.5f, player.updateInterval * 3.f);
+
+    return uc != 0.0 && std::abs(uc - lastServerPacket) > threshold;
+}
+
+PlayerInterpolator::BufferStats PlayerInterpolator::getBufferStatsAt(size_t slot) {
+    auto& player = states.at(slot);
 
-    return uc != 0.f && std::abs(uc - lastServerPacket) > 0.5f;
+    size_t depth = 0;
+    for (size_t i = 0; i < player.snapshotCount; i++) {
+        if (player.snapshot(i).timestamp > player.timeCounter) depth++;
+    }
+
+    return BufferStats {
+        .depth = depth,
+        .playoutDelay = player.playoutDelay,
+        .jitter = player.jitter,
+        .rate = player.rate,
+        .lerping = player.lerping,
+        .shownTimestamp = player.shownTimestamp,
+    };
 }
 
-float PlayerInterpolator::getLocalTs() {
+double PlayerInterpolator::getLocalTs() {
     return GlobedGJBGL::get()->m_fields->timeCounter;
 }
 
-PlayerInterpolator::LerpFrame::LerpFrame() {
-    timestamp = 0.f;
-    visual = {};
+std::array<std::vector<float>*, 15> PlayerInterpolator::LerpLanes::arrays() {
+    return {
+        &olderX, &olderY, &olderRot, &newerX, &newerY, &newerRot, &targetY,
+        &olderTanX, &olderTanY, &newerTanX, &newerTanY,
+        &ratio, &outX, &outY, &outRot
+    };
+}
+
+void PlayerInterpolator::LerpLanes::resize(size_t count) {
+    for (auto* arr : this->arrays()) {
+        arr->resize(count, 0.f);
+    }
 }
 
-PlayerInterpolator::LerpFrame::LerpFrame(const PlayerData& data) {
-    timestamp = data.timestamp;
-    visual = data;
+void PlayerInterpolator::LerpLanes::moveLane(size_t from, size_t to) {
+    for (auto* arr : this->arrays()) {
+        (*arr)[to] = (*arr)[from];
+    }
 }
@@ -1,69 +1,178 @@
 #pragma once
 
 #include "visual_state.hpp"
+#include "player_slots.hpp"
 #include <data/types/game.hpp>
 
+#include <array>
+#include <optional>
+
+enum class InterpolationMode {
+    Linear,
+    Cubic, // hermite curve through the frames, with tangents from the neighbouring frames
+};
+
 struct InterpolatorSettings {
     bool realtime;      // no interpolation at all
     bool isPlatformer;  // platformer duh
     float expectedDelta;
+    bool extrapolation; // keep moving players for a short while when their frames are late
+    InterpolationMode mode = InterpolationMode::Linear;
+    float extraPlayoutDelay = 0.f; // seconds added on top of the adaptive playout delay, trades latency for fewer late frames
+    bool lowLatencyExtrapolation = false; // extrapolate low latency players even if `extrapolation` is off
 };
 
 class PlayerInterpolator {
 public:
     struct PlayerState;
+    struct Snapshot;
 
-    PlayerInterpolator(const InterpolatorSettings& settings);
+    // `slots` is the registry shared with the rest of the level, players must be added to it before `addPlayer`
+    PlayerInterpolator(const InterpolatorSettings& settings, const PlayerSlots& slots);
 
     PlayerInterpolator(PlayerInterpolator&) = delete;
     PlayerInterpolator& operator=(PlayerInterpolator&) = delete;
 
     void addPlayer(int playerId);
-    void removePlayer(int playerId);
+    // Call with the result of `PlayerSlots::remove`
+    void removePlayer(const PlayerSlots::Removal& removal);
     bool hasPlayer(int playerId);
 
     // Update the last known state of the player. Should be called only when new data is received.
-    void updatePlayer(int playerId, const PlayerData& data, float updateCounter);
+    void updatePlayer(int playerId, const PlayerData& data, double updateCounter);
+
+    // Dormant players are skipped by `tick`, their state is just the last received frame. Used for players that aren't shown,
+    // so they cost nothing per frame. Once woken up they continue from the frames received in the meantime.
+    void setDormantAt(size_t slot, bool dormant);
+    bool isDormantAt(size_t slot);
+
+    // Change the expected time between updates, when the send rate changes mid level
+    void setExpectedDelta(float delta);
+
+    // Show the player as close to the newest frame as their jitter allows, for a player that sends every `expectedDelta` seconds
+    // on a faster stream than everyone else (like the linked player in two player mode). 0 goes back to the normal playout delay.
+    void setLowLatency(int playerId, float expectedDelta);
 
     // Interpolate the player state. Should preferrably be called every frame.
     void tick(float dt);
 
     // Get the current interpolated visual state of the player. This is what you pass into `RemotePlayer::updateData`
     VisualPlayerState& getPlayerState(int playerId);
+    VisualPlayerState& getPlayerStateAt(size_t slot);
 
     // returns `true` if death animation needs to be played and sets the flag back to false (so next call won't return `true` again)
     FrameFlags swapFrameFlags(int playerId);
+    FrameFlags swapFrameFlagsAt(size_t slot);
+
+    // returns `true` if the player hasn't been updated for a while, relative to the time of the last packet.
+    // takes the player's update cadence into account, as the server may be sending them less often.
+    bool isPlayerStale(int playerId, double lastServerPacket);
+
+    struct BufferStats {
+        size_t depth;         // received frames that are newer than what is currently shown
+        float playoutDelay;   // seconds
+        float jitter;         // seconds
+        float rate;           // estimated speed of the sender's clock relative to ours
+        bool lerping;         // whether the last tick interpolated the player, `shownTimestamp` is stale otherwise
+        double shownTimestamp; // point in the sender's timeline shown by the last tick
+    };
 
-    // returns `true` if the given time of the last packet doesn't match the last update time of the player
-    bool isPlayerStale(int playerId, float lastServerPacket);
+    // State of the jitter buffer of the player, for diagnostics
+    BufferStats getBufferStatsAt(size_t slot);
 
-    float getLocalTs();
+    double getLocalTs();
 
 private:
-    std::unordered_map<int, PlayerState> players;
+    // players are stored densely, indexed by their slot in `slots`
+    const PlayerSlots& slots;
+    std::vector<PlayerState> states;
+
+    // positions and rotations of both icons as a structure of arrays, so `tick` can interpolate everyone at once.
+    // player1 of a slot is lane `slot * 2`, player2 is lane `slot * 2 + 1`.
+    struct LerpLanes {
+        std::vector<float> olderX, olderY, olderRot;
+        std::vector<float> newerX, newerY, newerRot;
+        // what y is interpolated towards, same as `newerY` except when a spider teleports
+        std::vector<float> targetY;
+        // tangents at the older and newer frame, only used in cubic mode
+        std::vector<float> olderTanX, olderTanY, newerTanX, newerTanY;
+        std::vector<float> ratio;
+        std::vector<float> outX, outY, outRot;
+
+        std::array<std::vector<float>*, 15> arrays();
+        void resize(size_t count);
+        void moveLane(size_t from, size_t to);
+    };
+
+    LerpLanes lanes;
     InterpolatorSettings settings;
 
-    constexpr static bool EXTRAPOLATION = false;
+    // how many received frames are kept per player
+    constexpr static size_t SNAPSHOT_COUNT = 8;
+    // upper bound for the playout delay, no matter how bad the jitter is
+    constexpr static float MAX_PLAYOUT_DELAY = 0.5f;
+    // how far past the newest frame a player can be extrapolated
+    constexpr static float MAX_EXTRAPOLATION = 0.1f;
+    // if the shown time is further than this from where it should be, it jumps instead of slowly catching up
+    constexpr static float MAX_DRIFT = 0.25f;
+    // fraction of the drift that is corrected every second
+    constexpr static float DRIFT_CORRECTION = 2.f;
+    // a frame this much older than the newest one means the sender's clock was synced to the server again, so its timeline starts over
+    constexpr static double TIMELINE_RESET = 1.0;
+    // how far the estimated speed of a sender's clock may be from ours, and how much of the buffer it needs to span before it is trusted
+    constexpr static float MAX_RATE_DEVIATION = 0.1f;
+    constexpr static double MIN_RATE_SPAN = 0.2;
+
+    // turns the events that weren't seen before into frame flags
+    void applyEvents(PlayerState& player, const PlayerEventList& events);
+    // fits a line through the arrival and send times of the buffered frames, to follow senders whose clock runs slower or faster
+    void estimateRate(PlayerState& player);
+    void loadFrames(size_t slot, PlayerState& player, size_t newerIdx);
+    void loadLane(size_t lane, const PlayerState& player, size_t newerIdx, SpecificIconData VisualPlayerState::* icon);
+    void writeLane(size_t lane, SpecificIconData& out);
 
 public:
-
-    struct LerpFrame {
-        LerpFrame();
-        LerpFrame(const PlayerData& pd);
-
-        float timestamp;
+    struct Snapshot {
+        double timestamp = 0.0;
+        double arrival = 0.0; // our `updateCounter` when it was received
         VisualPlayerState visual;
     };
 
     struct PlayerState {
-        float updateCounter = 0.0f;
-        float timeCounter = 0.0f;
-        float lastDeathTimestamp = 0.0f;
+        double updateCounter = 0.0;
+        float updateInterval = 0.0f; // smoothed time between updates
+        std::optional<uint16_t> lastEventSequence; // newest event that was seen, repeats of it and of older ones are skipped
         size_t totalFrames = 0;
 
-        LerpFrame olderFrame, newerFrame;
+        // jitter buffer with the last few frames in the order they were sent, see `snapshot` to access them
+        std::array<Snapshot, SNAPSHOT_COUNT> snapshots;
+        size_t snapshotHead = 0;
+        size_t snapshotCount = 0;
+
+        // arrival jitter, smoothed like in RFC 3550, and how far behind the newest frame the player is shown
+        float lastTransit = 0.0f;
+        float jitter = 0.0f;
+        float playoutDelay = 0.0f;
+        // time between frames of the low latency stream, 0 if the player isn't on one
+        float lowLatencyDelta = 0.0f;
+        // how fast the sender's timeline moves compared to ours, the shown time advances at this speed
+        float rate = 1.0f;
+
+        // the point in the sender's timeline that is currently shown
+        double timeCounter = 0.0;
+        // `timeCounter` as of the last interpolated frame, before it was advanced for the next one
+        double shownTimestamp = 0.0;
+
+        // timestamps of the two frames that are loaded into `lanes`
+        double olderTimestamp = -1.0, newerTimestamp = -1.0;
         VisualPlayerState interpolatedState;
         bool pendingRealFrame = false;
+        bool lerping = false; // whether `tick` interpolated this player in the current frame
+        bool dormant = false;
         FrameFlags frameFlags;
+
+        // 0 is the oldest frame, `snapshotCount - 1` is the newest
+        const Snapshot& snapshot(size_t idx) const;
+        void pushSnapshot(const PlayerData& data, double arrival);
     };
 };
\ No newline at end of file
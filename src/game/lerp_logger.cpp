@@ -1,61 +1,51 @@
 #include "lerp_logger.hpp"
 
-#include <defs/crash.hpp>
+void LerpLogger::setEnabled(bool state) {
+#ifndef GLOBED_DEBUG_INTERPOLATION
+    enabled = state;
+#endif
+}
 
 void LerpLogger::reset(uint32_t id) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
     auto& player = this->ensureExists(id);
     player.realFrames.clear();
     player.realExtrapolatedFrames.clear();
     player.lerpedFrames.clear();
     player.lerpSkippedFrames.clear();
-#endif
 }
 
-void LerpLogger::logRealFrame(uint32_t id, float localts, float timeCounter, const SpecificIconData& data) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
+void LerpLogger::logRealFrame(uint32_t id, double localts, double timeCounter, const SpecificIconData& data) {
     auto& player = this->ensureExists(id);
-    player.realFrames.push_back(this->makeLogData(data, localts, timeCounter));
-#endif
+    player.realFrames.push(this->makeLogData(data, localts, timeCounter));
 }
 
-void LerpLogger::logExtrapolatedRealFrame(uint32_t id, float localts, float realTime, float timeCounter, const SpecificIconData& realData, const SpecificIconData& extrapolatedData) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
+void LerpLogger::logExtrapolatedRealFrame(uint32_t id, double localts, double realTime, double timeCounter, const SpecificIconData& realData, const SpecificIconData& extrapolatedData) {
     auto& player = this->ensureExists(id);
-    player.realExtrapolatedFrames.push_back(std::make_pair(
+    player.realExtrapolatedFrames.push(std::make_pair(
         this->makeLogData(realData, localts, realTime),
         this->makeLogData(extrapolatedData, localts, timeCounter)
     ));
-#endif
 }
 
-void LerpLogger::logLerpOperation(uint32_t id, float localts, float timeCounter, const SpecificIconData& data) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
+void LerpLogger::logLerpOperation(uint32_t id, double localts, double timeCounter, const SpecificIconData& data) {
     auto& player = this->ensureExists(id);
-    player.lerpedFrames.push_back(this->makeLogData(data, localts, timeCounter));
-#endif
+    player.lerpedFrames.push(this->makeLogData(data, localts, timeCounter));
 }
 
-void LerpLogger::logLerpSkip(uint32_t id, float localts, float timeCounter, const SpecificIconData& data) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
+void LerpLogger::logLerpSkip(uint32_t id, double localts, double timeCounter, const SpecificIconData& data) {
     auto& player = this->ensureExists(id);
-    player.lerpSkippedFrames.push_back(this->makeLogData(data, localts, timeCounter));
-#endif
+    player.lerpSkippedFrames.push(this->makeLogData(data, localts, timeCounter));
 }
 
-PlayerLog& LerpLogger::ensureExists(uint32_t id) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
-    if (!players.contains(id)) {
-        players.emplace(id, PlayerLog {});
-    }
-
-    return players.at(id);
-#endif
+void LerpLogger::clear() {
+    players.clear();
+}
 
-    globed::unreachable(); // ensureExists is a private function, should never be callable if lerp debug is disabled
+LerpLogger::PlayerRings& LerpLogger::ensureExists(uint32_t id) {
+    return players[id];
 }
 
-PlayerLogData LerpLogger::makeLogData(const SpecificIconData& data, float localts, float timeCounter) {
+PlayerLogData LerpLogger::makeLogData(const SpecificIconData& data, double localts, double timeCounter) {
     return PlayerLogData {
         .localTimestamp = localts,
         .timestamp = timeCounter,
@@ -65,17 +55,20 @@ PlayerLogData LerpLogger::makeLogData(const SpecificIconData& data, float localt
 }
 
 void LerpLogger::makeDump(const std::filesystem::path path) {
-#ifdef GLOBED_DEBUG_INTERPOLATION
     ByteBuffer bb;
 
     bb.writeU32(players.size());
-    for (const auto& [playerId, plog] : players) {
+    for (const auto& [playerId, rings] : players) {
         bb.writeU32(playerId);
-        bb.writeValue(plog);
+        bb.writeValue(PlayerLog {
+            .realFrames = rings.realFrames.ordered(),
+            .realExtrapolatedFrames = rings.realExtrapolatedFrames.ordered(),
+            .lerpedFrames = rings.lerpedFrames.ordered(),
+            .lerpSkippedFrames = rings.lerpSkippedFrames.ordered(),
+        });
     }
 
     std::ofstream file(path, std::ios::binary);
     file.write(reinterpret_cast<const char*>(bb.data().data()), bb.size());
     log::debug("dumped interpolation data to {} ({} bytes)", path, bb.size());
-#endif
-}
\ No newline at end of file
+}
@@ -4,15 +4,26 @@
 #include <filesystem>
 
 #include <data/types/game.hpp>
+#include <util/memory.hpp>
 #include <util/singleton.hpp>
 
+// Log an interpolation event. The arguments are only evaluated while logging is enabled,
+// so in normal play this costs a single branch.
+#define GLOBED_LERP_LOG(method, ...) \
+    do { \
+        if (::LerpLogger::isEnabled()) [[unlikely]] { \
+            ::LerpLogger::get().method(__VA_ARGS__); \
+        } \
+    } while (0)
+
 struct PlayerLogData {
-    float localTimestamp;
-    float timestamp;
+    double localTimestamp;
+    double timestamp;
     cocos2d::CCPoint position;
     float rotation;
 };
 
+// Layout of a dump, every list is ordered from the oldest to the newest entry
 struct PlayerLog {
     std::vector<PlayerLogData> realFrames;
     std::vector<std::pair<PlayerLogData, PlayerLogData>> realExtrapolatedFrames;
@@ -23,24 +34,83 @@ struct PlayerLog {
 GLOBED_SERIALIZABLE_STRUCT(PlayerLogData, (localTimestamp, timestamp, position, rotation));
 GLOBED_SERIALIZABLE_STRUCT(PlayerLog, (realFrames, realExtrapolatedFrames, lerpedFrames, lerpSkippedFrames));
 
+// Keeps the last `CAPACITY` entries, older ones are overwritten
+template <typename T, size_t CAPACITY>
+class LogRing {
+public:
+    void push(const T& value) {
+        if (entries.size() < CAPACITY) {
+            entries.push_back(value);
+        } else {
+            entries[head] = value;
+            head = (head + 1) % CAPACITY;
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        head = 0;
+    }
+
+    std::vector<T> ordered() const {
+        std::vector<T> out;
+        out.reserve(entries.size());
+        out.insert(out.end(), entries.begin() + head, entries.end());
+        out.insert(out.end(), entries.begin(), entries.begin() + head);
+        return out;
+    }
+
+private:
+    util::memory::TrackedVector<T, util::memory::MemoryTag::LerpLogger> entries;
+    size_t head = 0;
+};
+
 class LerpLogger : public SingletonBase<LerpLogger> {
 public:
+    // about a minute of frames at 60 fps, per player and per kind of event
+    static constexpr size_t CAPACITY = 4096;
+
+    // Logging is always on with `GLOBED_DEBUG_INTERPOLATION`, otherwise it can be toggled at runtime
+    static bool isEnabled() {
+        return enabled;
+    }
+
+    static void setEnabled(bool state);
+
     void reset(uint32_t player);
 
     // real frames logging
-    void logRealFrame(uint32_t player, float localts, float timeCounter, const SpecificIconData& data);
-    void logExtrapolatedRealFrame(uint32_t player, float localts, float realTime, float timeCounter, const SpecificIconData& realData, const SpecificIconData& extrapolatedData);
+    void logRealFrame(uint32_t player, double localts, double timeCounter, const SpecificIconData& data);
+    void logExtrapolatedRealFrame(uint32_t player, double localts, double realTime, double timeCounter, const SpecificIconData& realData, const SpecificIconData& extrapolatedData);
 
     // interpolated frames logging
-    void logLerpOperation(uint32_t player, float localts, float timeCounter, const SpecificIconData& data);
-    void logLerpSkip(uint32_t player, float localts, float timeCounter, const SpecificIconData& data);
+    void logLerpOperation(uint32_t player, double localts, double timeCounter, const SpecificIconData& data);
+    void logLerpSkip(uint32_t player, double localts, double timeCounter, const SpecificIconData& data);
 
     void makeDump(const std::filesystem::path path);
 
+    // Forget everything that has been logged so far
+    void clear();
+
 private:
-    PlayerLog& ensureExists(uint32_t player);
-    PlayerLogData makeLogData(const SpecificIconData& data, float localts, float timeCounter);
+    struct PlayerRings {
+        LogRing<PlayerLogData, CAPACITY> realFrames;
+        LogRing<std::pair<PlayerLogData, PlayerLogData>, CAPACITY> realExtrapolatedFrames;
+        LogRing<PlayerLogData, CAPACITY> lerpedFrames;
+        LogRing<PlayerLogData, CAPACITY> lerpSkippedFrames;
+    };
 
-    std::unordered_map<uint32_t, PlayerLog> players;
-};
+#ifdef GLOBED_DEBUG_INTERPOLATION
+    static inline bool enabled = true;
+#else
+    static inline bool enabled = false;
+#endif
+
+    PlayerRings& ensureExists(uint32_t player);
+    PlayerLogData makeLogData(const SpecificIconData& data, double localts, double timeCounter);
 
+    std::unordered_map<
+        uint32_t, PlayerRings, std::hash<uint32_t>, std::equal_to<uint32_t>,
+        util::memory::TrackingAllocator<std::pair<const uint32_t, PlayerRings>, util::memory::MemoryTag::LerpLogger>
+    > players;
+};
@@ -0,0 +1,296 @@
+#include "lerp_replay.hpp"
+
+#include <data/packets/packet.hpp>
+#include <data/packets/server/game.hpp>
+#include <net/packet_capture.hpp>
+
+using namespace geode::prelude;
+
+// default playout delays to try on top of the adaptive one, in seconds
+constexpr static float EXTRA_DELAYS[] = {0.02f, 0.05f};
+// how long the replay keeps going after the last packet, so the last frames get shown too
+constexpr static float REPLAY_TAIL = 0.5f;
+// smaller movement than this between two frames counts as standing still
+constexpr static float HELD_EPSILON = 0.01f;
+
+static float percentile(std::vector<float>& values, float p) {
+    if (values.empty()) return 0.f;
+
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(std::round((values.size() - 1) * p))];
+}
+
+static float mean(const std::vector<float>& values) {
+    if (values.empty()) return 0.f;
+
+    double sum = 0.0;
+    for (float v : values) sum += v;
+
+    return static_cast<float>(sum / values.size());
+}
+
+static Result<std::vector<AssociatedPlayerData>> decodeLevelData(PacketCapture::CapturedPacket& packet) {
+    auto buf = ByteBuffer::view(packet.data.data(), packet.data.size());
+    buf.setPosition(PacketHeader::SIZE);
+
+    if (packet.id == LevelDataPacket::PACKET_ID) {
+        LevelDataPacket decoded;
+        auto res = decoded.decode(buf);
+        if (!res) return Err(std::string(ByteBuffer::strerror(res.unwrapErr())));
+
+        return Ok(std::move(decoded.players));
+    } else {
+        QuantizedLevelDataPacket decoded;
+        auto res = decoded.decode(buf);
+        if (!res) return Err(std::string(ByteBuffer::strerror(res.unwrapErr())));
+
+        return Ok(std::move(decoded.data.players));
+    }
+}
+
+Result<LerpReplay> LerpReplay::fromCapture(const std::filesystem::path& path) {
+    GLOBED_UNWRAP_INTO(PacketCapture::readFile(path), auto packets);
+
+    LerpReplay replay;
+    std::optional<uint64_t> firstTimestamp;
+    size_t failed = 0;
+
+    for (auto& packet : packets) {
+        if (packet.outgoing || packet.encrypted) continue;
+        if (packet.id != LevelDataPacket::PACKET_ID && packet.id != QuantizedLevelDataPacket::PACKET_ID) continue;
+
+        auto players = decodeLevelData(packet);
+        if (!players) {
+            failed++;
+            continue;
+        }
+
+        if (!firstTimestamp) firstTimestamp = packet.timestamp;
+
+        replay.arrivals.push_back(Arrival {
+            .time = static_cast<float>(static_cast<double>(packet.timestamp - *firstTimestamp) / 1'000'000.0),
+            .players = std::move(players.unwrap()),
+        });
+    }
+
+    GLOBED_REQUIRE_SAFE(!replay.arrivals.empty(), "the capture has no level data packets")
+
+    if (failed > 0) {
+        log::warn("LerpReplay: skipped {} level data packets that failed to decode", failed);
+    }
+
+    for (const auto& arrival : replay.arrivals) {
+        for (const auto& player : arrival.players) {
+            replay.paths[player.accountId].push_back(PathPoint {
+                .timestamp = player.data.timestamp,
+                .position = player.data.player1.position,
+            });
+        }
+    }
+
+    // the server sends the latest frame of everyone in every packet, so most frames are in there more than once
+    for (auto& [id, path] : replay.paths) {
+        std::stable_sort(path.begin(), path.end(), [](auto& a, auto& b) { return a.timestamp < b.timestamp; });
+        path.erase(std::unique(path.begin(), path.end(), [](auto& a, auto& b) { return a.timestamp == b.timestamp; }), path.end());
+    }
+
+    return Ok(std::move(replay));
+}
+
+Result<std::filesystem::path> LerpReplay::latestCapture() {
+    auto folder = Mod::get()->getSaveDir() / "packets";
+
+    std::error_code ec;
+    std::filesystem::path latest;
+    std::filesystem::file_time_type latestTime;
+
+    for (const auto& entry : std::filesystem::directory_iterator(folder, ec)) {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".gcap") continue;
+
+        auto time = entry.last_write_time(ec);
+        if (ec) continue;
+
+        if (latest.empty() || time > latestTime) {
+            latest = entry.path();
+            latestTime = time;
+        }
+    }
+
+    GLOBED_REQUIRE_SAFE(!latest.empty(), "no packet captures found, record one in a level first")
+
+    return Ok(std::move(latest));
+}
+
+LerpReplay::Score LerpReplay::run(const Variant& variant, float frameDelta) const {
+    // the fastest any frame of a player got here, latency is measured against a frame that took this long
+    std::unordered_map<int, double> minTransit;
+    for (const auto& arrival : arrivals) {
+        for (const auto& player : arrival.players) {
+            double transit = arrival.time - player.data.timestamp;
+            auto [it, inserted] = minTransit.try_emplace(player.accountId, transit);
+            if (!inserted) it->second = std::min(it->second, transit);
+        }
+    }
+
+    // the last two frames of a player, shown and recorded, to get the acceleration
+    struct History {
+        size_t count = 0;
+        CCPoint shown[2];
+        CCPoint recorded[2];
+    };
+
+    PlayerSlots slots;
+    PlayerInterpolator interpolator(variant.settings, slots);
+    std::vector<History> history;
+
+    std::vector<float> latencies, errors;
+    double roughnessSum = 0.0;
+    size_t roughnessCount = 0, held = 0;
+
+    float end = arrivals.back().time + REPLAY_TAIL;
+    size_t next = 0;
+
+    for (float now = 0.f; now <= end; now += frameDelta) {
+        for (; next < arrivals.size() && arrivals[next].time <= now; next++) {
+            for (const auto& player : arrivals[next].players) {
+                if (!slots.contains(player.accountId)) {
+                    slots.add(player.accountId);
+                    interpolator.addPlayer(player.accountId);
+                    history.emplace_back();
+                }
+
+                interpolator.updatePlayer(player.accountId, player.data, now);
+            }
+        }
+
+        interpolator.tick(frameDelta);
+
+        for (size_t slot = 0; slot < slots.size(); slot++) {
+            auto& hist = history[slot];
+            auto stats = interpolator.getBufferStatsAt(slot);
+            const auto& path = paths.at(slots.idAt(slot));
+
+            // nothing to compare against once the player is extrapolated past the end of the capture
+            if (!stats.lerping || stats.shownTimestamp > path.back().timestamp) {
+                hist.count = 0;
+                continue;
+            }
+
+            CCPoint shown = interpolator.getPlayerStateAt(slot).player1.position;
+            CCPoint recorded = this->pathAt(path, stats.shownTimestamp);
+
+            latencies.push_back(static_cast<float>(now - minTransit.at(slots.idAt(slot)) - stats.shownTimestamp));
+            errors.push_back(shown.getDistance(recorded));
+
+            if (hist.count >= 1) {
+                bool stood = shown.getDistance(hist.shown[1]) < HELD_EPSILON;
+                bool moved = recorded.getDistance(hist.recorded[1]) >= HELD_EPSILON;
+                if (stood && moved) held++;
+            }
+
+            if (hist.count >= 2) {
+                CCPoint shownAccel = (shown - hist.shown[1] * 2.f + hist.shown[0]) / (frameDelta * frameDelta);
+                CCPoint recordedAccel = (recorded - hist.recorded[1] * 2.f + hist.recorded[0]) / (frameDelta * frameDelta);
+                CCPoint diff = shownAccel - recordedAccel;
+
+                roughnessSum += diff.x * diff.x + diff.y * diff.y;
+                roughnessCount++;
+            }
+
+            hist.shown[0] = hist.shown[1];
+            hist.shown[1] = shown;
+            hist.recorded[0] = hist.recorded[1];
+            hist.recorded[1] = recorded;
+            hist.count = std::min<size_t>(hist.count + 1, 2);
+        }
+    }
+
+    size_t samples = errors.size();
+
+    return Score {
+        .name = variant.name,
+        .samples = samples,
+        .meanLatency = mean(latencies),
+        .p95Latency = percentile(latencies, 0.95f),
+        .meanError = mean(errors),
+        .p95Error = percentile(errors, 0.95f),
+        .roughness = roughnessCount == 0 ? 0.f : static_cast<float>(std::sqrt(roughnessSum / roughnessCount)),
+        .heldRatio = samples == 0 ? 0.f : static_cast<float>(held) / samples,
+    };
+}
+
+std::vector<LerpReplay::Variant> LerpReplay::defaultVariants() const {
+    InterpolatorSettings base {
+        .realtime = false,
+        .isPlatformer = false,
+        .expectedDelta = this->frameInterval(),
+        .extrapolation = false,
+    };
+
+    std::vector<Variant> variants;
+
+    for (auto mode : {InterpolationMode::Linear, InterpolationMode::Cubic}) {
+        const char* modeName = mode == InterpolationMode::Linear ? "linear" : "cubic";
+
+        for (bool extrapolation : {false, true}) {
+            auto settings = base;
+            settings.mode = mode;
+            settings.extrapolation = extrapolation;
+
+            variants.push_back(Variant {
+                .name = fmt::format("{}{}", modeName, extrapolation ? " + extrapolation" : ""),
+                .settings = settings,
+            });
+        }
+
+        for (float delay : EXTRA_DELAYS) {
+            auto settings = base;
+            settings.mode = mode;
+            settings.extraPlayoutDelay = delay;
+
+            variants.push_back(Variant {
+                .name = fmt::format("{} + {}ms delay", modeName, static_cast<int>(delay * 1000.f)),
+                .settings = settings,
+            });
+        }
+    }
+
+    return variants;
+}
+
+float LerpReplay::frameInterval() const {
+    std::vector<float> intervals;
+
+    for (const auto& [id, path] : paths) {
+        for (size_t i = 1; i < path.size(); i++) {
+            intervals.push_back(static_cast<float>(path[i].timestamp - path[i - 1].timestamp));
+        }
+    }
+
+    if (intervals.empty()) return 1.f / 30.f;
+
+    return percentile(intervals, 0.5f);
+}
+
+size_t LerpReplay::packetCount() const {
+    return arrivals.size();
+}
+
+size_t LerpReplay::playerCount() const {
+    return paths.size();
+}
+
+CCPoint LerpReplay::pathAt(const std::vector<PathPoint>& path, double timestamp) const {
+    auto it = std::lower_bound(path.begin(), path.end(), timestamp, [](const PathPoint& point, double ts) {
+        return point.timestamp < ts;
+    });
+
+    if (it == path.begin()) return path.front().position;
+    if (it == path.end()) return path.back().position;
+
+    auto& newer = *it;
+    auto& older = *(it - 1);
+    float ratio = static_cast<float>((timestamp - older.timestamp) / (newer.timestamp - older.timestamp));
+
+    return older.position + (newer.position - older.position) * ratio;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <filesystem>
+
+#include "interpolator.hpp"
+#include <data/types/gd.hpp>
+
+// Replays the level data received in a packet capture (see `PacketCapture`) through a fresh `PlayerInterpolator`,
+// with the packets arriving at the same times as when they were recorded. Running the same capture with different
+// settings shows which ones give the smoothest result and how much latency they cost, without having to play.
+//
+// Like the interpolation benchmark, this can't run while `LerpLogger` is enabled, since logging asks the play layer for the time.
+class LerpReplay {
+public:
+    struct Variant {
+        std::string name;
+        InterpolatorSettings settings;
+    };
+
+    struct Score {
+        std::string name;
+        size_t samples;        // player frames that were scored
+        float meanLatency;     // seconds between a frame arriving the earliest it could and it being shown
+        float p95Latency;
+        float meanError;       // units between the shown position and the recorded path at the shown time
+        float p95Error;
+        float roughness;       // rms of the shown acceleration minus the recorded one, units per second squared
+        float heldRatio;       // fraction of frames where the player stood still while the recorded path moved
+    };
+
+    // Loads the level data packets received in a capture file
+    static Result<LerpReplay> fromCapture(const std::filesystem::path& path);
+
+    // Newest capture in the `packets` folder
+    static Result<std::filesystem::path> latestCapture();
+
+    // Plays back the capture once, ticking the interpolator every `frameDelta` seconds
+    Score run(const Variant& variant, float frameDelta) const;
+
+    // Linear and cubic, with and without extrapolation and with a few extra playout delays
+    std::vector<Variant> defaultVariants() const;
+
+    // median time between two frames of the same player, what `InterpolatorSettings::expectedDelta` should be
+    float frameInterval() const;
+
+    size_t packetCount() const;
+    size_t playerCount() const;
+
+private:
+    struct Arrival {
+        float time; // seconds since the first level data packet
+        std::vector<AssociatedPlayerData> players;
+    };
+
+    struct PathPoint {
+        double timestamp;
+        cocos2d::CCPoint position;
+    };
+
+    std::vector<Arrival> arrivals;
+    // every frame each player sent, sorted by timestamp, this is the path the interpolation is compared against
+    std::unordered_map<int, std::vector<PathPoint>> paths;
+
+    cocos2d::CCPoint pathAt(const std::vector<PathPoint>& path, double timestamp) const;
+};
@@ -0,0 +1,51 @@
+#include "player_slots.hpp"
+
+size_t PlayerSlots::add(int playerId) {
+    auto [it, inserted] = slots.emplace(playerId, ids.size());
+    if (inserted) {
+        ids.push_back(playerId);
+    }
+
+    return it->second;
+}
+
+PlayerSlots::Removal PlayerSlots::remove(int playerId) {
+    auto it = slots.find(playerId);
+    if (it == slots.end()) {
+        return Removal { INVALID, INVALID };
+    }
+
+    size_t slot = it->second;
+    size_t last = ids.size() - 1;
+    slots.erase(it);
+
+    if (slot != last) {
+        ids[slot] = ids[last];
+        slots[ids[slot]] = slot;
+    }
+
+    ids.pop_back();
+
+    return Removal { slot, last };
+}
+
+size_t PlayerSlots::find(int playerId) const {
+    auto it = slots.find(playerId);
+    return it == slots.end() ? INVALID : it->second;
+}
+
+bool PlayerSlots::contains(int playerId) const {
+    return slots.contains(playerId);
+}
+
+int PlayerSlots::idAt(size_t slot) const {
+    return ids[slot];
+}
+
+size_t PlayerSlots::size() const {
+    return ids.size();
+}
+
+bool PlayerSlots::empty() const {
+    return ids.empty();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+// Dense registry of the players in a level. Every player gets a slot when they join, and per-player data
+// (interpolator state, remote player nodes) lives in arrays indexed by that slot, so per-frame updates are one linear pass.
+// When a player leaves, the last slot is moved into the freed one, and `remove` tells the caller which one to move.
+class PlayerSlots {
+public:
+    static constexpr size_t INVALID = static_cast<size_t>(-1);
+
+    struct Removal {
+        size_t slot; // the freed slot
+        size_t last; // the slot that has to be moved into `slot`, equal to `slot` if nothing moves
+    };
+
+    // Returns the slot of the player, assigning the next one if they don't have it yet
+    size_t add(int playerId);
+
+    // Returns `INVALID` in `slot` if the player had no slot
+    Removal remove(int playerId);
+
+    // Returns `INVALID` if the player has no slot
+    size_t find(int playerId) const;
+    bool contains(int playerId) const;
+
+    int idAt(size_t slot) const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    std::unordered_map<int, size_t> slots;
+    std::vector<int> ids;
+};
@@ -1,10 +1,17 @@
 #include "player_store.hpp"
 
-void PlayerStore::insertOrUpdate(int playerId, int32_t attempts, uint32_t localBest) {
-    auto& entry = _data[playerId] = Entry {
+bool PlayerStore::insertOrUpdate(int playerId, int32_t attempts, uint32_t localBest) {
+    Entry entry {
         .attempts = attempts,
         .localBest = localBest
     };
+
+    auto [it, inserted] = _data.try_emplace(playerId, entry);
+    if (inserted) return true;
+    if (it->second == entry) return false;
+
+    it->second = entry;
+    return true;
 }
 
 void PlayerStore::removePlayer(int playerId) {
@@ -12,7 +19,8 @@ void PlayerStore::removePlayer(int playerId) {
 }
 
 std::optional<PlayerStore::Entry> PlayerStore::get(int playerId) {
-    return _data.contains(playerId) ? std::nullopt : std::optional(_data.at(playerId));
+    auto it = _data.find(playerId);
+    return it == _data.end() ? std::nullopt : std::optional(it->second);
 }
 
 std::unordered_map<int, PlayerStore::Entry>& PlayerStore::getAll() {
@@ -11,7 +11,8 @@ public:
         bool operator==(const Entry& other) const = default;
     };
 
-    void insertOrUpdate(int playerId, int32_t attempts, uint32_t localBest);
+    // Returns whether anything changed, an entry that already has these values is left alone
+    bool insertOrUpdate(int playerId, int32_t attempts, uint32_t localBest);
     void removePlayer(int playerId);
     std::optional<Entry> get(int playerId);
     std::unordered_map<int, Entry>& getAll();
@@ -0,0 +1,240 @@
+#include "scenario_bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <data/packets/server/game.hpp>
+#include <net/manager.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/memory.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+# include <audio/manager.hpp>
+#endif
+
+using namespace geode::prelude;
+
+// the synthetic players stand on rings around the base position, close enough for proximity voice to reach the speakers
+static constexpr float RING_START = 30.f;
+static constexpr float RING_SPACING = 15.f;
+static constexpr size_t PLAYERS_PER_RING = 10;
+static constexpr float GOLDEN_ANGLE = 2.39996323f;
+
+static constexpr float TONE_FREQUENCY = 220.f;
+
+static float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) return 0.f;
+
+    size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[idx];
+}
+
+ScenarioBenchmark::ScenarioBenchmark(LevelId levelId) : levelId(levelId) {
+    for (uint16_t players : PLAYER_COUNTS) {
+        for (uint16_t speakers : SPEAKER_COUNTS) {
+            stages.push_back(Stage { players, std::min(speakers, players) });
+        }
+    }
+}
+
+Result<std::unique_ptr<ScenarioBenchmark>> ScenarioBenchmark::create(LevelId levelId) {
+    std::unique_ptr<ScenarioBenchmark> bench(new ScenarioBenchmark(levelId));
+
+#ifdef GLOBED_VOICE_SUPPORT
+    AudioEncoder encoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS);
+    std::vector<float> pcm(VOICE_TARGET_FRAMESIZE * VOICE_CHANNELS);
+    size_t sample = 0;
+
+    for (size_t i = 0; i < EncodedAudioFrame::LIMIT_REGULAR; i++) {
+        for (float& s : pcm) {
+            s = 0.3f * std::sin(2.f * std::numbers::pi_v<float> * TONE_FREQUENCY * sample++ / VOICE_TARGET_SAMPLERATE);
+        }
+
+        GLOBED_UNWRAP(bench->voiceFrame.pushEncoded(encoder, pcm.data()));
+    }
+#endif
+
+    return Ok(std::move(bench));
+}
+
+bool ScenarioBenchmark::takeQueued() {
+    return std::exchange(queued, false) || Loader::get()->getLaunchFlag("globed-scenario-bench");
+}
+
+bool ScenarioBenchmark::update(double now, const PlayerData& base) {
+    if (stageIdx >= stages.size()) return false;
+
+    auto wall = util::time::now();
+
+    if (stageStart < 0.0) {
+        stageStart = now;
+        nextData = now;
+        nextVoice = now;
+        log::info("Scenario benchmark: {} players, {} speakers", stages[stageIdx].players, stages[stageIdx].speakers);
+    }
+
+    if (measuring) {
+        frameTimes.push_back(util::time::asMicros(wall - lastFrame) / 1000.f);
+    } else if (now - stageStart >= WARMUP) {
+        this->startMeasuring();
+    }
+
+    lastFrame = wall;
+
+    // a slow frame sends one batch instead of catching up, like a server would
+    if (now >= nextData) {
+        nextData = std::max(nextData + 1.0 / DATA_RATE, now);
+        this->sendLevelData(now, base);
+    }
+
+#ifdef GLOBED_VOICE_SUPPORT
+    if (now >= nextVoice) {
+        nextVoice = std::max(nextVoice + EncodedAudioFrame::LIMIT_REGULAR * VOICE_CHUNK_RECORD_TIME, now);
+        this->sendVoice();
+    }
+#endif
+
+    if (measuring && now - stageStart >= WARMUP + MEASURE) {
+        this->finishStage();
+    }
+
+    return stageIdx < stages.size();
+}
+
+void ScenarioBenchmark::sendLevelData(double now, const PlayerData& base) {
+    auto& stage = stages[stageIdx];
+
+    auto packet = std::make_shared<LevelDataPacket>();
+    packet->players.reserve(stage.players);
+
+    for (size_t i = 0; i < stage.players; i++) {
+        PlayerData data = base;
+        data.timestamp = now;
+
+        float radius = RING_START + (i / PLAYERS_PER_RING) * RING_SPACING;
+        float angle = i * GOLDEN_ANGLE;
+        // some movement, so the interpolator has work to do
+        float bob = std::sin(static_cast<float>(now) * 2.f + i) * 10.f;
+
+        auto offset = CCPoint { std::cos(angle) * radius, std::sin(angle) * radius + bob };
+        data.player1.position += offset;
+        data.player2.position += offset;
+
+        packet->players.emplace_back(FIRST_PLAYER_ID + static_cast<int>(i), data);
+    }
+
+    NetworkManager::get().dispatchLocal(std::move(packet));
+}
+
+void ScenarioBenchmark::sendVoice() {
+#ifdef GLOBED_VOICE_SUPPORT
+    auto& nm = NetworkManager::get();
+
+    // the speakers are the innermost players, the same frame from all of them
+    voiceFrame.setSequence(voiceSequence);
+    voiceSequence += voiceFrame.size();
+
+    for (size_t i = 0; i < stages[stageIdx].speakers; i++) {
+        auto packet = std::make_shared<VoiceBroadcastPacket>();
+        packet->sender = FIRST_PLAYER_ID + static_cast<int>(i);
+        packet->frame = voiceFrame;
+        nm.dispatchLocal(std::move(packet));
+    }
+#endif
+}
+
+void ScenarioBenchmark::startMeasuring() {
+    measuring = true;
+    frameTimes.clear();
+
+    measureStart = util::time::now();
+    cpuStart = NetworkManager::get().getThreadCpuTime();
+
+    auto totals = util::debug::MainThreadTimer::get().totals();
+    globedStart = totals.spent;
+    globedFramesStart = totals.frames;
+
+    util::memory::MemoryTracker::get().resetPeaks();
+}
+
+void ScenarioBenchmark::finishStage() {
+    auto wall = util::time::now() - measureStart;
+    auto cpu = NetworkManager::get().getThreadCpuTime() - cpuStart;
+    auto totals = util::debug::MainThreadTimer::get().totals();
+    size_t globedFrames = totals.frames - globedFramesStart;
+    auto memory = util::memory::MemoryTracker::get().snapshot();
+
+    int64_t memoryPeak = 0;
+    for (auto peak : memory.peak) {
+        memoryPeak += std::max<int64_t>(peak, 0);
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    StageResult result {
+        .stage = stages[stageIdx],
+        .frames = frameTimes.size(),
+        .frameP50 = percentile(frameTimes, 0.5f),
+        .frameP95 = percentile(frameTimes, 0.95f),
+        .frameP99 = percentile(frameTimes, 0.99f),
+        .frameMax = frameTimes.empty() ? 0.f : frameTimes.back(),
+        .globedMsPerFrame = globedFrames == 0 ? 0.f : util::time::asMicros(totals.spent - globedStart) / 1000.f / globedFrames,
+        .memory = memory.total,
+        .memoryPeak = memoryPeak,
+        .networkCpu = wall.count() == 0 ? 0.f : static_cast<float>(cpu.count()) / util::time::asMicros(wall),
+    };
+
+    log::info(
+        "{} players, {} speakers: frame p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, globed {:.2f}ms/frame, memory {}, network cpu {:.1f}%",
+        result.stage.players, result.stage.speakers,
+        result.frameP50, result.frameP95, result.frameP99, result.frameMax,
+        result.globedMsPerFrame, util::format::formatBytes(std::max<int64_t>(result.memory, 0)), result.networkCpu * 100.f
+    );
+
+    results.push_back(result);
+
+    stageIdx++;
+    stageStart = -1.0;
+    measuring = false;
+}
+
+Result<std::filesystem::path> ScenarioBenchmark::writeReport() const {
+    matjson::Array stageArray;
+
+    for (auto& result : results) {
+        stageArray.push_back(matjson::Object({
+            {"players", result.stage.players},
+            {"speakers", result.stage.speakers},
+            {"frames", result.frames},
+            {"frame_ms", matjson::Object({
+                {"p50", result.frameP50},
+                {"p95", result.frameP95},
+                {"p99", result.frameP99},
+                {"max", result.frameMax},
+            })},
+            {"globed_ms_per_frame", result.globedMsPerFrame},
+            {"memory_bytes", result.memory},
+            {"memory_peak_bytes", result.memoryPeak},
+            {"network_cpu", result.networkCpu},
+        }));
+    }
+
+    auto report = matjson::Value(matjson::Object({
+        {"version", Mod::get()->getVersion().toVString()},
+        {"platform", GLOBED_PLATFORM_STRING},
+        {"level", levelId},
+        {"warmup", WARMUP},
+        {"measure", MEASURE},
+        {"stages", stageArray},
+    }));
+
+    auto folder = Mod::get()->getSaveDir() / "benchmarks";
+    (void) geode::utils::file::createDirectoryAll(folder);
+
+    auto path = folder / fmt::format("scenario-{}.json", util::format::formatDateTime(util::time::systemNow()));
+    GLOBED_UNWRAP(geode::utils::file::writeString(path, report.dump()));
+
+    return Ok(path);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <array>
+#include <filesystem>
+#include <memory>
+
+#include <data/types/game.hpp>
+#include <data/types/gd.hpp>
+#include <util/time.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+# include <audio/frame.hpp>
+#endif
+
+// Whole-level performance run. Synthetic players, and voice from some of them, are handed to the packet listeners
+// the same way real ones arrive, in stages of increasing size. Each stage is measured for frame times, globed's share of
+// the main thread, tracked memory and the CPU time of the network threads, and the results are written as json
+// into the `benchmarks` folder so runs on different builds and devices can be compared.
+//
+// Runs in the next level after `queue`, or in every level with the `globed-scenario-bench` launch flag.
+// Joining a level still needs a server connection, real players in the level are measured along with the synthetic ones.
+class ScenarioBenchmark {
+public:
+    struct Stage {
+        uint16_t players;
+        uint16_t speakers;
+    };
+
+    // every combination of these is run, the player count is the outer loop so players only ever join
+    static constexpr std::array<uint16_t, 3> PLAYER_COUNTS = {10, 50, 200};
+    static constexpr std::array<uint16_t, 3> SPEAKER_COUNTS = {0, 5, 20};
+
+    // a stage first runs without being measured, so new players have joined and their buffers are filled
+    static constexpr double WARMUP = 3.0;
+    static constexpr double MEASURE = 10.0;
+    // level data rate of the synthetic players, same as a server with the default tps
+    static constexpr double DATA_RATE = 30.0;
+    // account IDs of the synthetic players start here, far above any real one
+    static constexpr int FIRST_PLAYER_ID = 2'000'000'000;
+
+    struct StageResult {
+        Stage stage;
+        size_t frames;
+        // milliseconds between frames
+        float frameP50, frameP95, frameP99, frameMax;
+        float globedMsPerFrame;  // see `MainThreadTimer`
+        int64_t memory;          // bytes tracked by `MemoryTracker` at the end of the stage
+        int64_t memoryPeak;      // sum of the peaks of every subsystem during the stage
+        float networkCpu;        // share of one core used by the network threads
+    };
+
+    static Result<std::unique_ptr<ScenarioBenchmark>> create(LevelId levelId);
+
+    static void queue() {
+        queued = true;
+    }
+
+    // Whether the level being entered should run the benchmark, clears the queued run
+    static bool takeQueued();
+
+    // Called every frame with `GlobedGJBGL::Fields::timeCounter`. The synthetic players look like `base` and are spread around
+    // its position. Returns false once every stage is done.
+    bool update(double now, const PlayerData& base);
+
+    // Writes the results into a new file in the `benchmarks` folder and returns its path
+    Result<std::filesystem::path> writeReport() const;
+
+private:
+    static inline bool queued = false;
+
+    LevelId levelId;
+    std::vector<Stage> stages;
+    std::vector<StageResult> results;
+
+    size_t stageIdx = 0;
+    double stageStart = -1.0; // negative until the first update of the stage
+    bool measuring = false;
+    double nextData = 0.0;
+    double nextVoice = 0.0;
+
+    // taken when the measured part of the stage starts
+    util::time::time_point measureStart;
+    util::time::micros cpuStart{0};
+    util::time::clock::duration globedStart{};
+    size_t globedFramesStart = 0;
+
+    util::time::time_point lastFrame;
+    std::vector<float> frameTimes;
+
+#ifdef GLOBED_VOICE_SUPPORT
+    // a tone, encoded once and sent by every speaker
+    EncodedAudioFrame voiceFrame;
+    uint32_t voiceSequence = 0;
+#endif
+
+    ScenarioBenchmark(LevelId levelId);
+
+    void sendLevelData(double now, const PlayerData& base);
+    void sendVoice();
+    void startMeasuring();
+    void finishStage();
+};
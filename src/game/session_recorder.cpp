@@ -0,0 +1,449 @@
+#include "session_recorder.hpp"
+
+#include <bit>
+#include <lz4.h>
+
+#include <util/format.hpp>
+#include <util/thread.hpp>
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+// how often the writer thread compresses and writes out finished chunks
+static constexpr auto WRITE_INTERVAL = util::time::millis(250);
+
+template <typename T>
+static void writeLE(uint8_t* out, T value) {
+    if constexpr (std::is_same_v<T, double>) {
+        writeLE(out, std::bit_cast<uint64_t>(value));
+    } else {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+}
+
+template <typename T>
+static T readLE(const uint8_t* in) {
+    if constexpr (std::is_same_v<T, double>) {
+        return std::bit_cast<double>(readLE<uint64_t>(in));
+    } else {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<T>(in[i]) << (i * 8);
+        }
+        return value;
+    }
+}
+
+static std::filesystem::path recordingsFolder() {
+    return Mod::get()->getSaveDir() / "recordings";
+}
+
+SessionRecorder::SessionRecorder() {
+    writerThread.setLoopFunction(&SessionRecorder::writerFunc);
+    writerThread.setStartFunction([] {
+        geode::utils::thread::setName("Session Recorder Writer");
+        util::thread::configureCurrent(util::thread::Priority::Background);
+    });
+    writerThread.start(this);
+}
+
+SessionRecorder::~SessionRecorder() {
+    writerThread.stopAndWait();
+    this->stop();
+}
+
+Result<> SessionRecorder::start(LevelId levelId) {
+    auto out = output.lock();
+    if (recording) return Ok();
+
+    auto folder = recordingsFolder();
+    (void) geode::utils::file::createDirectoryAll(folder);
+
+    auto startTime = util::time::systemNow();
+    auto filepath = folder / fmt::format("session-{}-{}.grec", levelId, util::format::formatDateTime(startTime));
+
+    out->file.open(filepath, std::ios::binary);
+    if (!out->file.is_open()) {
+        return Err(fmt::format("failed to open {}", filepath));
+    }
+
+    uint8_t header[FILE_HEADER_SIZE];
+    writeLE(header, FILE_MAGIC);
+    writeLE(header + 4, FILE_VERSION);
+    writeLE(header + 6, static_cast<uint64_t>(levelId));
+    writeLE<uint64_t>(header + 14, util::time::as<util::time::micros>(startTime.time_since_epoch()).count());
+    out->file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    out->offset = FILE_HEADER_SIZE;
+    out->index.clear();
+
+    pending = ByteBuffer();
+    pendingFrames = 0;
+    dropped = 0;
+
+    recording = true;
+
+    log::debug("Recording session into {}", filepath);
+
+    return Ok();
+}
+
+void SessionRecorder::stop() {
+    if (!recording) return;
+
+    this->submitPending();
+    recording = false;
+
+    auto out = output.lock();
+    this->drain(*out);
+
+    if (!out->file.is_open()) return;
+
+    // index and trailer, so playback can seek without reading every chunk header first
+    uint64_t indexOffset = out->offset;
+
+    std::vector<uint8_t> buf(out->index.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+    uint8_t* ptr = buf.data();
+
+    for (const auto& entry : out->index) {
+        writeLE(ptr, entry.offset);
+        writeLE(ptr + 8, entry.firstTime);
+        ptr += INDEX_ENTRY_SIZE;
+    }
+
+    writeLE(ptr, static_cast<uint32_t>(out->index.size()));
+    writeLE(ptr + 4, indexOffset);
+    writeLE(ptr + 12, INDEX_MAGIC);
+
+    out->file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+    out->file.close();
+
+    if (dropped > 0) {
+        log::warn("Session recorder dropped {} chunks", dropped.load());
+    }
+}
+
+bool SessionRecorder::isRecording() {
+    return recording;
+}
+
+void SessionRecorder::record(double time, const std::vector<AssociatedPlayerData>& players) {
+    if (!recording) return;
+
+    if (pendingFrames == 0) {
+        pendingFirstTime = time;
+    }
+
+    pending.writeF64(time);
+    pending.writeValue(players);
+
+    pendingFrames++;
+    pendingLastTime = time;
+
+    if (pending.size() >= CHUNK_SIZE || pendingLastTime - pendingFirstTime >= CHUNK_DURATION) {
+        this->submitPending();
+    }
+}
+
+size_t SessionRecorder::getDroppedCount() {
+    return dropped;
+}
+
+void SessionRecorder::submitPending() {
+    if (pendingFrames == 0) return;
+
+    if (queuedChunks >= MAX_QUEUED_CHUNKS) {
+        dropped.fetch_add(1);
+    } else {
+        queuedChunks.fetch_add(1);
+        chunks.push(Chunk {
+            .data = std::move(pending.data()),
+            .frames = pendingFrames,
+            .firstTime = pendingFirstTime,
+            .lastTime = pendingLastTime,
+        });
+    }
+
+    pending = ByteBuffer();
+    pendingFrames = 0;
+}
+
+void SessionRecorder::writerFunc() {
+    std::this_thread::sleep_for(WRITE_INTERVAL);
+
+    auto out = output.lock();
+    this->drain(*out);
+}
+
+void SessionRecorder::drain(Output& out) {
+    // chunks are only taken out under the output lock, so `stop` can't close the file while one is between the queue and the file
+    while (auto chunk = chunks.tryPop()) {
+        queuedChunks.fetch_sub(1);
+
+        if (!out.file.is_open()) continue;
+
+        int rawSize = static_cast<int>(chunk->data.size());
+        out.compressBuffer.resize(LZ4_compressBound(rawSize));
+
+        int compressedSize = LZ4_compress_default(
+            reinterpret_cast<const char*>(chunk->data.data()), out.compressBuffer.data(),
+            rawSize, static_cast<int>(out.compressBuffer.size())
+        );
+
+        if (compressedSize <= 0) {
+            dropped.fetch_add(1);
+            continue;
+        }
+
+        uint8_t header[CHUNK_HEADER_SIZE];
+        writeLE(header, CHUNK_MAGIC);
+        writeLE(header + 4, chunk->frames);
+        writeLE(header + 8, static_cast<uint32_t>(rawSize));
+        writeLE(header + 12, static_cast<uint32_t>(compressedSize));
+        writeLE(header + 16, chunk->firstTime);
+        writeLE(header + 24, chunk->lastTime);
+
+        out.file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.file.write(out.compressBuffer.data(), compressedSize);
+
+        out.index.push_back(IndexEntry {
+            .offset = out.offset,
+            .firstTime = chunk->firstTime,
+        });
+
+        out.offset += CHUNK_HEADER_SIZE + compressedSize;
+    }
+
+    if (out.file.is_open()) {
+        out.file.flush();
+    }
+}
+
+Result<std::filesystem::path> SessionRecorder::latestRecording() {
+    std::error_code ec;
+    std::filesystem::path latest;
+    std::filesystem::file_time_type latestTime;
+
+    for (const auto& entry : std::filesystem::directory_iterator(recordingsFolder(), ec)) {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".grec") continue;
+
+        auto time = entry.last_write_time(ec);
+        if (ec) continue;
+
+        if (latest.empty() || time > latestTime) {
+            latest = entry.path();
+            latestTime = time;
+        }
+    }
+
+    GLOBED_REQUIRE_SAFE(!latest.empty(), "no recordings found, record one in a level first")
+
+    return Ok(std::move(latest));
+}
+
+/* SessionPlayback */
+
+Result<std::unique_ptr<SessionPlayback>> SessionPlayback::open(const std::filesystem::path& path) {
+    auto pb = std::make_unique<SessionPlayback>();
+
+    pb->file.open(path, std::ios::binary | std::ios::ate);
+    if (!pb->file.is_open()) {
+        return Err(fmt::format("failed to open {}", path));
+    }
+
+    uint64_t fileSize = pb->file.tellg();
+    GLOBED_REQUIRE_SAFE(fileSize >= SessionRecorder::FILE_HEADER_SIZE, "recording is too short")
+
+    uint8_t header[SessionRecorder::FILE_HEADER_SIZE];
+    pb->file.seekg(0);
+    pb->file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    GLOBED_REQUIRE_SAFE(readLE<uint32_t>(header) == SessionRecorder::FILE_MAGIC, "not a session recording")
+
+    auto version = readLE<uint16_t>(header + 4);
+    GLOBED_REQUIRE_SAFE(version == SessionRecorder::FILE_VERSION, fmt::format("unsupported recording version: {}", version))
+
+    pb->levelId = static_cast<LevelId>(readLE<uint64_t>(header + 6));
+
+    GLOBED_UNWRAP(pb->buildIndex(fileSize));
+    GLOBED_REQUIRE_SAFE(!pb->index.empty(), "the recording has no frames")
+
+    pb->startTime = pb->index.front().firstTime;
+
+    // the last time is only in the header of the last chunk
+    uint8_t chunkHeader[SessionRecorder::CHUNK_HEADER_SIZE];
+    pb->file.clear();
+    pb->file.seekg(pb->index.back().offset);
+    pb->file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader));
+    pb->endTime = readLE<double>(chunkHeader + 24);
+
+    GLOBED_UNWRAP(pb->seek(0.0));
+
+    return Ok(std::move(pb));
+}
+
+Result<> SessionPlayback::buildIndex(uint64_t fileSize) {
+    // a finished recording ends with the index
+    if (fileSize >= SessionRecorder::FILE_HEADER_SIZE + SessionRecorder::TRAILER_SIZE) {
+        uint8_t trailer[SessionRecorder::TRAILER_SIZE];
+        file.seekg(fileSize - SessionRecorder::TRAILER_SIZE);
+        file.read(reinterpret_cast<char*>(trailer), sizeof(trailer));
+
+        uint32_t count = readLE<uint32_t>(trailer);
+        uint64_t indexOffset = readLE<uint64_t>(trailer + 4);
+
+        if (
+            readLE<uint32_t>(trailer + 12) == SessionRecorder::INDEX_MAGIC
+            && indexOffset + count * SessionRecorder::INDEX_ENTRY_SIZE + SessionRecorder::TRAILER_SIZE == fileSize
+        ) {
+            std::vector<uint8_t> buf(count * SessionRecorder::INDEX_ENTRY_SIZE);
+            file.seekg(indexOffset);
+            file.read(reinterpret_cast<char*>(buf.data()), buf.size());
+
+            index.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t* entry = buf.data() + i * SessionRecorder::INDEX_ENTRY_SIZE;
+                index.push_back(IndexEntry {
+                    .offset = readLE<uint64_t>(entry),
+                    .firstTime = readLE<double>(entry + 8),
+                });
+            }
+
+            return Ok();
+        }
+    }
+
+    // otherwise the recording was cut off, every chunk that was written out completely is still usable
+    uint64_t offset = SessionRecorder::FILE_HEADER_SIZE;
+    uint8_t header[SessionRecorder::CHUNK_HEADER_SIZE];
+
+    while (offset + SessionRecorder::CHUNK_HEADER_SIZE <= fileSize) {
+        file.clear();
+        file.seekg(offset);
+        if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) break;
+        if (readLE<uint32_t>(header) != SessionRecorder::CHUNK_MAGIC) break;
+
+        uint64_t end = offset + SessionRecorder::CHUNK_HEADER_SIZE + readLE<uint32_t>(header + 12);
+        if (end > fileSize) break;
+
+        index.push_back(IndexEntry {
+            .offset = offset,
+            .firstTime = readLE<double>(header + 16),
+        });
+
+        offset = end;
+    }
+
+    if (!index.empty()) {
+        log::warn("Recording has no index, recovered {} chunks", index.size());
+    }
+
+    return Ok();
+}
+
+LevelId SessionPlayback::getLevelId() const {
+    return levelId;
+}
+
+double SessionPlayback::getStartTime() const {
+    return startTime;
+}
+
+double SessionPlayback::getDuration() const {
+    return endTime - startTime;
+}
+
+Result<> SessionPlayback::seek(double time) {
+    double target = startTime + time;
+
+    // last chunk that starts at or before the target, the frames before it in that chunk are skipped below
+    auto it = std::upper_bound(index.begin(), index.end(), target, [](double t, const IndexEntry& e) { return t < e.firstTime; });
+    size_t chunk = it == index.begin() ? 0 : static_cast<size_t>(it - index.begin()) - 1;
+
+    GLOBED_UNWRAP(this->loadChunk(chunk));
+    peeked.reset();
+
+    Frame frame;
+    while (true) {
+        GLOBED_UNWRAP_INTO(this->readFrame(frame), bool more);
+        if (!more) break;
+
+        if (frame.time >= time) {
+            peeked = std::move(frame);
+            break;
+        }
+    }
+
+    return Ok();
+}
+
+Result<bool> SessionPlayback::advance(double time, const std::function<void(Frame&)>& func) {
+    while (true) {
+        if (!peeked) {
+            Frame frame;
+            GLOBED_UNWRAP_INTO(this->readFrame(frame), bool more);
+            if (!more) return Ok(false);
+
+            peeked = std::move(frame);
+        }
+
+        if (peeked->time > time) return Ok(true);
+
+        func(*peeked);
+        peeked.reset();
+    }
+}
+
+Result<> SessionPlayback::loadChunk(size_t idx) {
+    GLOBED_REQUIRE_SAFE(idx < index.size(), "chunk index out of range")
+
+    uint8_t header[SessionRecorder::CHUNK_HEADER_SIZE];
+    file.clear();
+    file.seekg(index[idx].offset);
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    GLOBED_REQUIRE_SAFE(file && readLE<uint32_t>(header) == SessionRecorder::CHUNK_MAGIC, "corrupted recording chunk")
+
+    uint32_t rawSize = readLE<uint32_t>(header + 8);
+    uint32_t compressedSize = readLE<uint32_t>(header + 12);
+
+    compressedData.resize(compressedSize);
+    chunkData.resize(rawSize);
+
+    file.read(compressedData.data(), compressedSize);
+    GLOBED_REQUIRE_SAFE(file, "recording chunk was cut off")
+
+    int written = LZ4_decompress_safe(
+        compressedData.data(), reinterpret_cast<char*>(chunkData.data()),
+        static_cast<int>(compressedSize), static_cast<int>(rawSize)
+    );
+
+    GLOBED_REQUIRE_SAFE(written == static_cast<int>(rawSize), "failed to decompress a recording chunk")
+
+    chunkPos = 0;
+    nextChunk = idx + 1;
+
+    return Ok();
+}
+
+Result<bool> SessionPlayback::readFrame(Frame& out) {
+    while (chunkPos >= chunkData.size()) {
+        if (nextChunk >= index.size()) return Ok(false);
+        GLOBED_UNWRAP(this->loadChunk(nextChunk));
+    }
+
+    auto buf = ByteBuffer::view(chunkData.data() + chunkPos, chunkData.size() - chunkPos);
+
+    auto time = buf.readF64();
+    if (!time) return Err(std::string(ByteBuffer::strerror(time.unwrapErr())));
+
+    auto res = buf.readValueInto(out.players);
+    if (!res) return Err(std::string(ByteBuffer::strerror(res.unwrapErr())));
+
+    out.time = time.unwrap() - startTime;
+    chunkPos += buf.getPosition();
+
+    return Ok(true);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
+
+#include <data/bytebuffer.hpp>
+#include <data/types/gd.hpp>
+#include <util/singleton.hpp>
+
+// Records the level data received in a level into a file, so the other players can be watched again later as ghosts.
+// The main thread only appends each batch to an in-memory chunk, full chunks are compressed and written by a background thread.
+//
+// File format (little endian): u32 magic, u16 version, i64 level id, u64 start time (microseconds since the unix epoch), then chunks of
+// u32 magic, u32 frame count, u32 raw size, u32 compressed size, f64 first time, f64 last time, lz4 compressed frames.
+// A frame is an f64 time (`GlobedGJBGL::Fields::timeCounter` when it arrived) followed by the `AssociatedPlayerData` list as a `ByteBuffer` value.
+// Once the recording is stopped, an index of u64 chunk offset + f64 first time follows the last chunk, and then a trailer of
+// u32 chunk count, u64 index offset, u32 magic. A file without the trailer (for example after a crash) is still readable, the chunks are scanned instead.
+class SessionRecorder : public SingletonBase<SessionRecorder> {
+protected:
+    friend class SingletonBase;
+    SessionRecorder();
+    ~SessionRecorder();
+
+public:
+    static constexpr uint32_t FILE_MAGIC = 0x43455247;  // "GREC"
+    static constexpr uint32_t CHUNK_MAGIC = 0x4b435247; // "GRCK"
+    static constexpr uint32_t INDEX_MAGIC = 0x58495247; // "GRIX"
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr size_t FILE_HEADER_SIZE = 22;
+    static constexpr size_t CHUNK_HEADER_SIZE = 32;
+    static constexpr size_t INDEX_ENTRY_SIZE = 16;
+    static constexpr size_t TRAILER_SIZE = 16;
+
+    // a chunk is handed to the writer once it's this big or spans this many seconds, whichever comes first
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr double CHUNK_DURATION = 1.0;
+    // chunks waiting for the writer, anything past this is dropped instead of growing without a limit
+    static constexpr size_t MAX_QUEUED_CHUNKS = 64;
+
+    // Whether levels should be recorded, checked when entering a level
+    static bool isEnabled() {
+        return enabled;
+    }
+
+    static void setEnabled(bool state) {
+        enabled = state;
+    }
+
+    // Start recording into a new file in the `recordings` folder, does nothing if already recording
+    Result<> start(LevelId levelId);
+
+    // Write out the last chunk and the index, and close the file
+    void stop();
+
+    bool isRecording();
+
+    // Record a batch of level data, does nothing unless recording. Main thread only.
+    void record(double time, const std::vector<AssociatedPlayerData>& players);
+
+    // Returns how many chunks were dropped because the writer thread could not keep up
+    size_t getDroppedCount();
+
+    // Newest recording in the `recordings` folder
+    static Result<std::filesystem::path> latestRecording();
+
+private:
+    struct Chunk {
+        std::vector<uint8_t> data;
+        uint32_t frames;
+        double firstTime;
+        double lastTime;
+    };
+
+    struct IndexEntry {
+        uint64_t offset;
+        double firstTime;
+    };
+
+    struct Output {
+        std::ofstream file;
+        uint64_t offset = 0;
+        std::vector<IndexEntry> index;
+        std::vector<char> compressBuffer;
+    };
+
+    static inline bool enabled = false;
+
+    asp::Mutex<Output> output;
+    asp::Channel<Chunk> chunks;
+    asp::AtomicSizeT queuedChunks;
+    asp::AtomicBool recording;
+    asp::AtomicSizeT dropped;
+
+    asp::Thread<SessionRecorder*> writerThread;
+
+    // the chunk being filled, only touched by the main thread
+    ByteBuffer pending;
+    uint32_t pendingFrames = 0;
+    double pendingFirstTime = 0.0;
+    double pendingLastTime = 0.0;
+
+    void writerFunc();
+
+    // hand the chunk being filled to the writer thread
+    void submitPending();
+
+    // compress and write every queued chunk, must be called with the output locked
+    void drain(Output& out);
+};
+
+// Reads a recording made by `SessionRecorder` back. Only one chunk is decompressed at a time,
+// so memory use doesn't depend on how long the recording is.
+class SessionPlayback {
+public:
+    struct Frame {
+        double time; // seconds since the start of the recording
+        std::vector<AssociatedPlayerData> players;
+    };
+
+    static Result<std::unique_ptr<SessionPlayback>> open(const std::filesystem::path& path);
+
+    // Recording to play back in the next level that is entered, see `GlobedGJBGL::setupUpdate`
+    static void queue(std::filesystem::path path) {
+        queued = std::move(path);
+    }
+
+    static std::optional<std::filesystem::path> takeQueued() {
+        return std::exchange(queued, std::nullopt);
+    }
+
+    LevelId getLevelId() const;
+    // time of the first frame, on the clock it was recorded with
+    double getStartTime() const;
+    double getDuration() const;
+
+    // The next `advance` continues from the first frame at or after `time` (in seconds since the start)
+    Result<> seek(double time);
+
+    // Calls `func` with every frame up to and including `time` (in seconds since the start), in order.
+    // Returns false once the end of the recording is reached.
+    Result<bool> advance(double time, const std::function<void(Frame&)>& func);
+
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        double firstTime;
+    };
+
+    static inline std::optional<std::filesystem::path> queued;
+
+    std::ifstream file;
+    LevelId levelId = 0;
+    double startTime = 0.0; // time of the first frame, as it was recorded
+    double endTime = 0.0;
+    std::vector<IndexEntry> index;
+
+    size_t nextChunk = 0;
+    std::vector<uint8_t> chunkData;
+    std::vector<char> compressedData;
+    size_t chunkPos = 0;
+    std::optional<Frame> peeked;
+
+    Result<> buildIndex(uint64_t fileSize);
+    Result<> loadChunk(size_t idx);
+    // decodes the next frame, from the next chunk if the current one is done. Returns false at the end of the recording.
+    Result<bool> readFrame(Frame& out);
+};
@@ -1,9 +1,23 @@
 #include "appdelegate.hpp"
 
+#include <managers/profile_cache.hpp>
+#include <managers/settings.hpp>
 #include <net/manager.hpp>
 
 using namespace geode::prelude;
 
+void GlobedAppDelegate::trySaveGame(bool p0) {
+    // a debounced flush may still be pending if a setting was changed right before closing
+    GlobedSettings::get().flush();
+
+    auto result = ProfileCacheManager::get().save();
+    if (result.isErr()) {
+        log::warn("Failed to save cached profiles: {}", result.unwrapErr());
+    }
+
+    AppDelegate::trySaveGame(p0);
+}
+
 #ifdef GEODE_IS_ANDROID
 void GlobedAppDelegate::applicationDidEnterBackground() {
     NetworkManager::get().suspend();
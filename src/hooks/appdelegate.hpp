@@ -6,6 +6,14 @@
 #include <util/time.hpp>
 
 class $modify(GlobedAppDelegate, AppDelegate) {
+    static void onModify(auto& self) {
+        // flush settings before geode writes the mod save data
+        (void) self.setHookPriority("AppDelegate::trySaveGame", -1000);
+    }
+
+    $override
+    void trySaveGame(bool p0);
+
 #ifdef GEODE_IS_ANDROID
     $override
     void applicationDidEnterBackground();
@@ -6,11 +6,17 @@
 
 #include <managers/settings.hpp>
 #include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/misc.hpp>
+#include <util/time.hpp>
 #include <util/ui.hpp>
 #include <util/cocos.hpp>
 
 using namespace geode::prelude;
 
+// main thread time spent per frame on death effects that load in the background
+constexpr auto DEATH_EFFECT_LOAD_BUDGET = util::time::micros(1000);
+
 void HookedGameManager::returnToLastScene(GJGameLevel* level) {
     if (GlobedLevelEditorLayer::fromEditor) {
         auto* pl = GlobedGJBGL::get();
@@ -67,26 +73,32 @@ void HookedGameManager::loadIconsBatched(int iconType, int startId, int endId) {
 }
 
 void HookedGameManager::loadIconsBatched(const std::vector<BatchedIconRange>& ranges) {
-    std::vector<std::string> toLoad;
-    std::unordered_map<int, std::unordered_map<int, size_t>> toLoadMap;
+    util::cocos::loadAssetsParallel(this->getIconSheets(ranges));
+    this->cacheLoadedIcons(ranges);
+}
+
+std::vector<std::string> HookedGameManager::getIconSheets(const std::vector<BatchedIconRange>& ranges) {
+    std::vector<std::string> sheets;
 
     for (const auto& range : ranges) {
         for (int id = range.startId; id <= range.endId; id++) {
             auto sheetName = this->sheetNameForIcon(id, range.iconType);
             if (sheetName.empty()) continue;
 
-            toLoad.push_back(sheetName);
-            toLoadMap[range.iconType][id] = toLoad.size() - 1;
+            sheets.push_back(sheetName);
         }
     }
 
-    util::cocos::loadAssetsParallel(toLoad);
+    return sheets;
+}
 
+void HookedGameManager::cacheLoadedIcons(const std::vector<BatchedIconRange>& ranges) {
     auto* tc = CCTextureCache::sharedTextureCache();
 
-    for (const auto& [iconType, map] : toLoadMap) {
-        for (const auto& [iconId, idx] : map) {
-            const auto& sheetName = toLoad[idx];
+    for (const auto& range : ranges) {
+        for (int iconId = range.startId; iconId <= range.endId; iconId++) {
+            auto sheetName = this->sheetNameForIcon(iconId, range.iconType);
+            if (sheetName.empty()) continue;
 
             auto fullpath = util::cocos::fullPathForFilename(fmt::format("{}.png", sheetName));
             if (fullpath.empty()) {
@@ -97,20 +109,104 @@ void HookedGameManager::loadIconsBatched(const std::vector<BatchedIconRange>& ra
             auto* tex = static_cast<CCTexture2D*>(tc->m_pTextures->objectForKey(fullpath));
 
             if (!tex) {
-                log::warn("icon failed to preload: type {}, id {}", iconType, iconId);
+                log::warn("icon failed to preload: type {}, id {}", range.iconType, iconId);
                 continue;
             }
 
-            auto* existing = this->getCachedIcon(iconId, iconType);
+            auto* existing = this->getCachedIcon(iconId, range.iconType);
             if (existing && existing != tex) {
-                log::warn("icon already exists, overwriting (id: {}, type: {})", iconId, iconType);
+                log::warn("icon already exists, overwriting (id: {}, type: {})", iconId, range.iconType);
             }
 
-            m_fields->iconCache[iconType][iconId] = tex;
+            m_fields->iconCache[range.iconType][iconId] = tex;
         }
     }
 }
 
+void HookedGameManager::loadIconsFor(const std::vector<PlayerIconData>& icons, PlayerIconTypeMask types) {
+    std::vector<BatchedIconRange> ranges;
+
+    for (const auto& data : icons) {
+        for (auto type = PlayerIconType::Cube; type <= PlayerIconType::Jetpack; type = (PlayerIconType)((int)type + 1)) {
+            if (!(types & iconTypeBit(type))) continue;
+
+            int iconId = util::misc::getIconWithType(data, type);
+            int iconType = (int)util::misc::convertEnum<IconType>(type);
+
+            if (this->getCachedIcon(iconId, iconType)) continue;
+
+            // multiple players often share icons
+            bool queued = std::any_of(ranges.begin(), ranges.end(), [&](const auto& range) {
+                return range.iconType == iconType && range.startId == iconId;
+            });
+
+            if (queued) continue;
+
+            ranges.push_back(BatchedIconRange {
+                .iconType = iconType,
+                .startId = iconId,
+                .endId = iconId
+            });
+        }
+    }
+
+    if (ranges.empty()) return;
+
+    auto start = util::time::now();
+    this->loadIconsBatched(ranges);
+
+    log::debug("Loaded {} icons on demand in {}", ranges.size(), util::format::formatDuration(util::time::now() - start));
+}
+
+void HookedGameManager::prewarmDeathEffect(int id) {
+    if (m_fields->deathEffectsPreloaded || util::ui::isDeathEffectLoaded(id)) return;
+
+    auto isPending = [id](const std::vector<int>& ids) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+
+    if (isPending(m_fields->loadingDeathEffects) || isPending(m_fields->queuedDeathEffects)) return;
+
+    m_fields->queuedDeathEffects.push_back(id);
+}
+
+void HookedGameManager::pollDeathEffects() {
+    if (!m_fields->deathEffectLoader) {
+        if (m_fields->queuedDeathEffects.empty()) return;
+
+        // everything that got queued in the meantime is loaded as one batch
+        std::vector<std::string> sheets;
+        for (int id : m_fields->queuedDeathEffects) {
+            sheets.push_back(util::ui::deathEffectSheet(id));
+        }
+
+        m_fields->loadingDeathEffects = std::move(m_fields->queuedDeathEffects);
+        m_fields->queuedDeathEffects.clear();
+        m_fields->deathEffectLoader = std::make_unique<util::cocos::ParallelAssetLoader>(sheets);
+    }
+
+    if (!m_fields->deathEffectLoader->poll(DEATH_EFFECT_LOAD_BUDGET)) return;
+
+    log::debug("Loaded {} death effects in the background", m_fields->loadingDeathEffects.size());
+
+    m_fields->deathEffectLoader.reset();
+    m_fields->loadingDeathEffects.clear();
+}
+
+bool HookedGameManager::hasLoadedIcons(const PlayerIconData& icons, PlayerIconTypeMask types) {
+    for (auto type = PlayerIconType::Cube; type <= PlayerIconType::Jetpack; type = (PlayerIconType)((int)type + 1)) {
+        if (!(types & iconTypeBit(type))) continue;
+
+        int iconId = util::misc::getIconWithType(icons, type);
+
+        if (!this->getCachedIcon(iconId, (int)util::misc::convertEnum<IconType>(type))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 CCTexture2D* HookedGameManager::getCachedIcon(int iconId, int iconType) {
     if (m_fields->iconCache.contains(iconType)) {
         if (m_fields->iconCache.at(iconType).contains(iconId)) {
@@ -141,6 +237,9 @@ void HookedGameManager::setDeathEffectsPreloaded(bool state) {
 void HookedGameManager::resetAssetPreloadState() {
     m_fields->iconCache.clear();
     m_fields->loadedFrames.clear();
+    m_fields->deathEffectLoader.reset();
+    m_fields->loadingDeathEffects.clear();
+    m_fields->queuedDeathEffects.clear();
 
     this->setAssetsPreloaded(false);
     this->setDeathEffectsPreloaded(false);
@@ -1,6 +1,9 @@
 #pragma once
 #include <defs/geode.hpp>
 
+#include <data/types/gd.hpp>
+#include <util/cocos.hpp>
+
 #include <Geode/modify/GameManager.hpp>
 
 class $modify(HookedGameManager, GameManager) {
@@ -10,6 +13,11 @@ class $modify(HookedGameManager, GameManager) {
         int lastSceneEnum;
         bool assetsPreloaded = false;
         bool deathEffectsPreloaded = false;
+
+        // death effects that are loaded in the background, see `prewarmDeathEffect`
+        std::unique_ptr<util::cocos::ParallelAssetLoader> deathEffectLoader;
+        std::vector<int> loadingDeathEffects;
+        std::vector<int> queuedDeathEffects;
     };
 
     static void onModify(auto& self) {
@@ -42,9 +50,27 @@ class $modify(HookedGameManager, GameManager) {
 
     void loadIconsBatched(const std::vector<BatchedIconRange>& ranges);
 
+    // The two halves of `loadIconsBatched`, for loading icons with a `util::cocos::ParallelAssetLoader`.
+    // Returns the sheets that have to be loaded for the icons in the ranges, and then puts the loaded ones into the icon cache.
+    std::vector<std::string> getIconSheets(const std::vector<BatchedIconRange>& ranges);
+    void cacheLoadedIcons(const std::vector<BatchedIconRange>& ranges);
+
+    // Load the icons of the given types used by the given players in a single parallel batch, skipping ones that are already loaded.
+    void loadIconsFor(const std::vector<PlayerIconData>& icons, PlayerIconTypeMask types = ALL_ICON_TYPES);
+
+    // Whether every icon of the given types in the set has been loaded, either by preloading or by `loadIconsFor`
+    bool hasLoadedIcons(const PlayerIconData& icons, PlayerIconTypeMask types = ALL_ICON_TYPES);
+
     bool getAssetsPreloaded();
     void setAssetsPreloaded(bool state);
 
+    // Start loading a death effect in the background, so that playing it later doesn't cause a hitch.
+    // The loading is done by `pollDeathEffects`.
+    void prewarmDeathEffect(int id);
+
+    // Does a bit of main thread work on the death effects that are being loaded, should be called every frame while in a level
+    void pollDeathEffects();
+
     bool getDeathEffectsPreloaded();
     void setDeathEffectsPreloaded(bool state);
 
@@ -14,6 +14,8 @@
 #include <managers/friend_list.hpp>
 #include <managers/profile_cache.hpp>
 #include <managers/game_server.hpp>
+#include <managers/level_prefetch.hpp>
+#include <managers/power.hpp>
 #include <managers/settings.hpp>
 #include <managers/room.hpp>
 #include <data/packets/all.hpp>
@@ -24,15 +26,62 @@
 #include <util/cocos.hpp>
 #include <util/format.hpp>
 #include <util/lowlevel.hpp>
+#include <util/memory.hpp>
+#include <util/profiler.hpp>
 
 using namespace geode::prelude;
 
 // how many units before the voice disappears
 constexpr float PROXIMITY_VOICE_LIMIT = 1200.f;
+// below this gain (before the volume setting), a proximity voice frame is dropped instead of decoded
+constexpr float PROXIMITY_VOICE_MIN_GAIN = 0.02f;
 
 constexpr float VOICE_OVERLAY_PAD_X = 5.f;
 constexpr float VOICE_OVERLAY_PAD_Y = 20.f;
 
+// how many player data packets are sent as deltas before the next keyframe
+constexpr uint32_t PLAYER_DATA_KEYFRAME_INTERVAL = 30;
+
+// jumps, deaths and spider teleports are repeated in every sent frame for this long (in seconds), and at least this many times,
+// so they make it through lost frames and through the receiver only getting level data every few of our frames
+constexpr double PLAYER_EVENT_RESEND_TIME = 0.5;
+constexpr uint32_t PLAYER_EVENT_MIN_SENDS = 3;
+
+// adaptive send rate, the data is sent every Nth tick depending on what the player is doing and how the connection is
+constexpr uint32_t IDLE_SEND_INTERVAL = 3;
+constexpr uint32_t CONGESTED_SEND_INTERVAL = 2;
+constexpr int CONGESTED_PING = 200;
+constexpr float CONGESTED_LOSS = 0.1f;
+
+// while building in the editor only the status matters, it's sent this often (in seconds) unless someone is playtesting.
+// the server answers player data with level data, so while anyone plays the full rate is kept to see them smoothly
+constexpr float EDITOR_STATUS_INTERVAL = 2.f;
+
+// in two player mode our data is also sent straight to the linked player this many times per second, separately from the level data.
+// the server only accepts up to this rate on the linked stream
+constexpr uint32_t LINKED_TPS = 60;
+
+// with the battery saver on, the send rate is capped and only a few voices are decoded at once, unless the level is crowded
+constexpr uint32_t LOW_POWER_TPS = 15;
+constexpr size_t LOW_POWER_MAX_SPEAKERS = 3;
+
+// attempts and the best only change on a death or a completion, metadata is checked this often (in seconds) and sent if it changed
+constexpr float METADATA_CHECK_INTERVAL = 1.f;
+
+constexpr float PERIODICAL_UPDATE_INTERVAL = 0.25f;
+constexpr float ESTIMATOR_UPDATE_INTERVAL = 1.f / 30.f;
+
+// discord takes at most 5 presence updates per 20 seconds, so changes are checked often but sent at most this often
+constexpr float DRPC_CHECK_INTERVAL = 1.f;
+constexpr auto DRPC_MIN_UPDATE_INTERVAL = util::time::seconds(4);
+
+// in crowd mode, players further than this from the center of the camera (relative to the larger side of the camera) are drawn simplified
+constexpr float CROWD_DETAIL_RADIUS = 0.3f;
+
+// constructing a remote player is expensive, so a few are made upfront and the ones that leave are kept around for reuse
+constexpr size_t PLAYER_POOL_PREWARM = 8;
+constexpr size_t PLAYER_POOL_MAX = 64;
+
 
 bool GlobedGJBGL::init() {
     if (!GJBaseGameLayer::init()) return false;
@@ -73,6 +122,11 @@ void GlobedGJBGL::setupPreInit(GJGameLevel* level) {
 
     auto levelId = HookedGJGameLevel::getLevelIDFrom(level);
     m_fields->globedReady = nm.established() && levelId > 0;
+    globed::setLevelHooksEnabled(this, m_fields->globedReady);
+
+    // always consume, so a join for a different level doesn't linger
+    bool prefetched = LevelPrefetchManager::get().consume(levelId);
+    m_fields->prefetched = prefetched && m_fields->globedReady;
 
     if (m_fields->globedReady) {
         // room settings
@@ -104,6 +158,9 @@ void GlobedGJBGL::setupPreInit(GJGameLevel* level) {
 void GlobedGJBGL::setupAll() {
     this->setupBare();
 
+    // peaks logged on level exit are for this level only
+    util::memory::MemoryTracker::get().resetPeaks();
+
     if (!m_fields->globedReady) return;
 
     this->setupDeferredAssetPreloading();
@@ -174,7 +231,17 @@ void GlobedGJBGL::setupDeferredAssetPreloading() {
         gm->setDeathEffectsPreloaded(true);
     }
 
-    util::cocos::cleanupThreadPool();
+    this->prewarmPlayerPool();
+}
+
+void GlobedGJBGL::prewarmPlayerPool() {
+    auto& pool = m_fields->playerPool;
+
+    while (pool.size() < PLAYER_POOL_PREWARM) {
+        pool.push_back(Build<RemotePlayer>::create(&m_fields->camState, nullptr, nullptr)
+            .zOrder(10)
+            .collect());
+    }
 }
 
 void GlobedGJBGL::setupAudio() {
@@ -202,6 +269,8 @@ void GlobedGJBGL::setupAudio() {
 
         // set the record buffer size
         vm.setRecordBufferCapacity(settings.communication.lowerAudioLatency ? EncodedAudioFrame::LIMIT_LOW_LATENCY : EncodedAudioFrame::LIMIT_REGULAR);
+        vm.setVoiceActivityDetection(settings.communication.voiceActivityDetection);
+        vm.setLoopbackEnabled(settings.communication.voiceLoopback);
 
         // start passive voice recording
         auto& vrm = VoiceRecordingManager::get();
@@ -230,59 +299,63 @@ void GlobedGJBGL::setupAudio() {
 void GlobedGJBGL::setupPacketListeners() {
     auto& nm = NetworkManager::get();
 
-    nm.addListener<PlayerProfilesPacket>(this, [](std::shared_ptr<PlayerProfilesPacket> packet) {
-        auto& pcm = ProfileCacheManager::get();
-        for (auto& player : packet->players) {
-            pcm.insert(player);
-        }
+    // after reconnecting, the server might not know which level we are on anymore. joining a room also takes us out of the level.
+    auto rejoinLevel = [this] {
+        auto& nm = NetworkManager::get();
+        nm.send(LevelJoinPacket::create(HookedGJGameLevel::getLevelIDFrom(m_level)));
+        this->sendVoiceProximity();
+
+        // the server thread is new, so it doesn't have our last keyframe either
+        m_fields->lastKeyframe.reset();
+    };
+
+    nm.addListener<LoggedInPacket>(this, [rejoinLevel](LoggedInPacket&) {
+        rejoinLevel();
     });
 
-    nm.addListener<LevelDataPacket>(this, [this](std::shared_ptr<LevelDataPacket> packet){
-        this->m_fields->lastServerUpdate = this->m_fields->timeCounter;
+    nm.addListener<RoomJoinedPacket>(this, [rejoinLevel](RoomJoinedPacket&) {
+        rejoinLevel();
+    });
 
-        for (const auto& player : packet->players) {
-            if (!this->m_fields->players.contains(player.accountId)) {
-                // new player joined
-                this->handlePlayerJoin(player.accountId);
-            }
+    nm.addListener<LevelDataPacket>(this, [this](LevelDataPacket& packet){
+        this->handleLevelData(packet.players);
+    });
 
-            this->m_fields->interpolator->updatePlayer(player.accountId, player.data, this->m_fields->lastServerUpdate);
-        }
+    nm.addListener<QuantizedLevelDataPacket>(this, [this](QuantizedLevelDataPacket& packet){
+        this->handleLevelData(packet.data.players);
     });
 
-    nm.addListener<LevelPlayerMetadataPacket>(this, [this](std::shared_ptr<LevelPlayerMetadataPacket> packet) {
-        for (const auto& player : packet->players) {
+    nm.addListener<LevelTpsPacket>(this, [this](LevelTpsPacket& packet) {
+        m_fields->levelTps = packet.tps;
+        this->updateSendRate();
+    });
+
+    nm.addListener<LinkedPlayerDataBroadcastPacket>(this, [this](LinkedPlayerDataBroadcastPacket& packet){
+        this->handleLinkedData(packet.sender, packet.data);
+    });
+
+    nm.addListener<LevelPlayerMetadataPacket>(this, [this](LevelPlayerMetadataPacket& packet) {
+        for (const auto& player : packet.players) {
             this->m_fields->playerStore->insertOrUpdate(player.accountId, player.data.attempts, player.data.localBest);
         }
     });
 
-    nm.addListener<ChatMessageBroadcastPacket>(this, [this](std::shared_ptr<ChatMessageBroadcastPacket> packet) {
-        this->m_fields->chatMessages.push_back({packet->sender, packet->message});
+    nm.addListener<ChatMessageBroadcastPacket>(this, [this](ChatMessageBroadcastPacket& packet) {
+        this->m_fields->chatHistory.push(packet.sender, packet.message);
 
-        //m_fields->chatOverlay->addMessage(packet->sender, packet->message);
+        //m_fields->chatOverlay->addMessage(packet.sender, packet.message);
     });
 
-    nm.addListener<VoiceBroadcastPacket>(this, [this](std::shared_ptr<VoiceBroadcastPacket> packet) {
+    nm.addListener<VoiceBroadcastPacket>(this, [this](VoiceBroadcastPacket& packet) {
 #ifdef GLOBED_VOICE_SUPPORT
-        // if deafened or voice is disabled, do nothing
-        auto& settings = GlobedSettings::get();
-
-        if (this->m_fields->deafened || !settings.communication.voiceEnabled) return;
-        if (!this->shouldLetMessageThrough(packet->sender)) return;
-
-        auto& vpm = VoicePlaybackManager::get();
-        try {
-            vpm.prepareStream(packet->sender);
-
-            vpm.setVolume(packet->sender, settings.communication.voiceVolume);
-            this->updateProximityVolume(packet->sender);
-            auto result = vpm.playFrameStreamed(packet->sender, packet->frame);
+        this->handleVoiceFrame(packet.sender, std::move(packet.frame));
+#endif // GLOBED_VOICE_SUPPORT
+    });
 
-            if (result.isErr()) {
-                ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + result.unwrapErr());
-            }
-        } catch(const std::exception& e) {
-            ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + e.what());
+    nm.addListener<VoiceBundlePacket>(this, [this](VoiceBundlePacket& packet) {
+#ifdef GLOBED_VOICE_SUPPORT
+        for (auto& entry : packet.frames) {
+            this->handleVoiceFrame(entry.sender, std::move(entry.frame));
         }
 #endif // GLOBED_VOICE_SUPPORT
     });
@@ -346,12 +419,43 @@ void GlobedGJBGL::setupUpdate() {
         // here we run the stuff that must run on a valid playlayer
         self->setupPacketListeners();
 
-        // send LevelJoinPacket and RequestPlayerProfilesPacket
-
         auto levelId = HookedGJGameLevel::getLevelIDFrom(self->m_level);
-        nm.send(LevelJoinPacket::create(levelId));
 
-        self->rescheduleSelectors();
+        // send LevelJoinPacket, unless it was already sent when pressing play
+        if (!self->m_fields->prefetched) {
+            nm.send(LevelJoinPacket::create(levelId));
+        }
+
+        if (SessionRecorder::isEnabled()) {
+            GLOBED_RESULT_ERRC(SessionRecorder::get().start(levelId));
+        }
+
+        // a recording queued from the advanced settings is played back as ghosts, if it was made in this level
+        if (auto path = SessionPlayback::takeQueued()) {
+            auto res = SessionPlayback::open(*path);
+
+            if (!res) {
+                ErrorQueues::get().warn(fmt::format("Failed to open the recording: {}", res.unwrapErr()));
+            } else if (auto playback = std::move(res).unwrap(); playback->getLevelId() != levelId) {
+                ErrorQueues::get().warn("The recording was made in a different level");
+            } else {
+                self->m_fields->sessionPlayback = std::move(playback);
+            }
+        }
+
+        if (ScenarioBenchmark::takeQueued()) {
+            auto res = ScenarioBenchmark::create(levelId);
+
+            if (!res) {
+                ErrorQueues::get().warn(fmt::format("Failed to start the scenario benchmark: {}", res.unwrapErr()));
+            } else {
+                self->m_fields->scenarioBench = std::move(res).unwrap();
+            }
+        }
+
+        self->sendVoiceProximity();
+
+        self->setupPeriodicTasks();
         self->getParent()->schedule(schedule_selector(GlobedGJBGL::selUpdate), 0.f);
 
         self->scheduleOnce(schedule_selector(GlobedGJBGL::postInitActions), 0.25f);
@@ -364,20 +468,17 @@ void GlobedGJBGL::setupMisc() {
 
     m_fields->isVoiceProximity = m_level->isPlatformer() ? settings.communication.voiceProximity : settings.communication.classicProximity;
 
-    // set the configured tps
-    auto tpsCap = settings.globed.tpsCap;
-    if (tpsCap != 0) {
-        m_fields->configuredTps = std::min(nm.getServerTps(), (uint32_t)tpsCap);
-    } else {
-        m_fields->configuredTps = nm.getServerTps();
-    }
+    this->updateSendRate();
 
     // interpolator
     m_fields->interpolator = std::make_unique<PlayerInterpolator>(InterpolatorSettings {
         .realtime = false,
         .isPlatformer = m_level->isPlatformer(),
-        .expectedDelta = (1.0f / m_fields->configuredTps)
-    });
+        .expectedDelta = (1.0f / m_fields->configuredTps),
+        .extrapolation = settings.players.extrapolation,
+        .mode = settings.players.cubicInterpolation ? InterpolationMode::Cubic : InterpolationMode::Linear,
+        .lowLatencyExtrapolation = settings.players.linkedExtrapolation,
+    }, m_fields->playerSlots);
 
     // player store
     m_fields->playerStore = std::make_unique<PlayerStore>();
@@ -438,58 +539,100 @@ void GlobedGJBGL::setupUi() {
     m_fields->selfProgressIcon->updateIcons(pcm.getOwnData());
     m_fields->selfProgressIcon->setForceOnTop(true);
 
+    bool ownName = settings.players.showNames && settings.players.ownName;
+
+    if (settings.players.statusIcons || ownName) {
+        Build<CCNode>::create()
+            .parent(m_objectLayer)
+            .id("self-label-anchor"_spr)
+            .store(m_fields->ownLabelAnchor);
+    }
+
     // status icons
     if (settings.players.statusIcons) {
         Build<PlayerStatusIcons>::create(255)
             .scale(0.8f)
             .anchorPoint(0.5f, 0.f)
             .pos(0.f, 25.f)
-            .parent(m_objectLayer)
+            .parent(m_fields->ownLabelAnchor)
             .id("self-status-icon"_spr)
             .store(m_fields->selfStatusIcons);
     }
 
     // own name
-    if (settings.players.showNames && settings.players.ownName) {
+    if (ownName) {
         auto ownData = pcm.getOwnAccountData();
         auto ownSpecial = pcm.getOwnSpecialData();
 
-        Build<GlobedNameLabel>::create(ownData.name, ownSpecial)
-            .parent(m_objectLayer)
+        Build<GlobedNameLabel>::create(ownData.name.str(), ownSpecial)
+            .pos(0.f, 25.f)
+            .parent(m_fields->ownLabelAnchor)
             .id("self-name"_spr)
             .store(m_fields->ownNameLabel);
 
         m_fields->ownNameLabel->updateOpacity(settings.players.nameOpacity);
 
         if (settings.players.dualName) {
-            Build<GlobedNameLabel>::create(ownData.name, ownSpecial)
-                .visible(false)
+            Build<CCNode>::create()
                 .parent(m_objectLayer)
+                .id("self-label-anchor-p2"_spr)
+                .store(m_fields->ownLabelAnchor2);
+
+            Build<GlobedNameLabel>::create(ownData.name.str(), ownSpecial)
+                .visible(false)
+                .pos(0.f, 25.f)
+                .parent(m_fields->ownLabelAnchor2)
                 .id("self-name-p2"_spr)
                 .store(m_fields->ownNameLabel2);
 
             m_fields->ownNameLabel2->updateOpacity(settings.players.nameOpacity);
         }
     }
+
+    // crowd mode, drawn right under the remote players
+    if (settings.players.crowdModeThreshold != 0) {
+        Build<CrowdRenderer>::create()
+            .zOrder(9)
+            .parent(m_objectLayer)
+            .id("crowd-renderer"_spr)
+            .store(m_fields->crowdRenderer);
+    }
+
+    // names go above all the remote players
+    if (settings.players.batchedNames && settings.players.showNames) {
+        Build<NameLabelBatch>::create()
+            .zOrder(11)
+            .parent(m_objectLayer)
+            .id("name-batch"_spr)
+            .store(m_fields->nameBatch);
+    }
 }
 
 void GlobedGJBGL::postInitActions(float) {
     auto& nm = NetworkManager::get();
-    nm.send(RequestPlayerProfilesPacket::create(0));
 
+    // prefetched profiles were requested right after joining and may already be cached
+    if (!m_fields->prefetched) {
+        nm.send(RequestPlayerProfilesPacket::create(0));
+    }
+
+    // the server answers the first metadata on a level with everyone else's, later ones only go out to the others
     auto data = this->gatherPlayerMetadata();
-    nm.send(PlayerMetadataPacket::create(data));
+    m_fields->lastSentMetadata = data;
+    m_fields->playerStore->insertOrUpdate(GJAccountManager::get()->m_accountID, data.attempts, data.localBest);
+    nm.sendLatest(PlayerMetadataPacket::create(data));
 }
 
 /* Selectors */
 
-// selSendPlayerData - runs tps (default 30) times per second
+// selSendPlayerData - runs tps (default 30) times per second, see `PeriodicTask::SendPlayerData`
 void GlobedGJBGL::selSendPlayerData(float) {
     auto self = GlobedGJBGL::get();
 
     if (!self || !self->established()) return;
     // if (!self->isCurrentPlayLayer()) return;
-    if (!self->accountForSpeedhack(0, 1.0f / self->m_fields->configuredTps, 0.8f)) return;
+
+    util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::SendPlayerData);
 
     self->m_fields->totalSentPackets++;
     // additionally, if there are no players on the level, we drop down to 1 time per second as an optimization
@@ -497,19 +640,73 @@ void GlobedGJBGL::selSendPlayerData(float) {
     if ((self->m_fields->players.empty() && self->m_fields->totalSentPackets % 30 != 15) || self->m_fields->quitting) return;
 
     auto data = self->gatherPlayerData();
-    NetworkManager::get().send(PlayerDataPacket::create(data));
+    // the once per second packet when alone is already as slow as it gets
+    if (!self->m_fields->players.empty() && !self->shouldSendPlayerData(data)) {
+        self->m_fields->skippedSends++;
+        return;
+    }
+
+    self->m_fields->skippedSends = 0;
+    self->m_fields->lastSentData = data;
+    self->attachPlayerEvents(data);
+
+    auto& nm = NetworkManager::get();
+
+    if (!nm.serverMatchesProtocol()) {
+        nm.sendLatest(PlayerDataPacket(data));
+        return;
+    }
+
+    // deltas are made against the last keyframe, so a lost delta costs nothing and a lost keyframe costs at most one interval
+    bool keyframe = !self->m_fields->lastKeyframe || ++self->m_fields->sentSinceKeyframe >= PLAYER_DATA_KEYFRAME_INTERVAL;
+    if (keyframe) {
+        self->m_fields->keyframeId++;
+        self->m_fields->sentSinceKeyframe = 0;
+        self->m_fields->lastKeyframe = data;
+    }
+
+    PlayerDataDeltaPacket packet(PlayerDataDelta {
+        .keyframeId = self->m_fields->keyframeId,
+        .keyframe = keyframe,
+        .base = self->m_fields->lastKeyframe.value(),
+        .data = data,
+    });
+
+    // an unsent delta is useless once a newer one exists, but the keyframe it's based on has to arrive
+    if (keyframe) {
+        nm.send(packet);
+    } else {
+        nm.sendLatest(packet);
+    }
+}
+
+// selSendLinkedData - runs `LINKED_TPS` times per second, see `PeriodicTask::SendLinkedData`
+void GlobedGJBGL::selSendLinkedData(float) {
+    auto self = GlobedGJBGL::get();
+
+    if (!self || !self->established() || self->m_fields->quitting) return;
+    if (!self->m_fields->twopstate.active || self->m_fields->twopstate.linkedId == 0) return;
+
+    // events go out with the regular player data, the linked player gets that too
+    NetworkManager::get().sendLatest(LinkedPlayerDataPacket(self->gatherPlayerData()));
 }
 
-// selSendPlayerMetadata - runs every 10 seconds
+// selSendPlayerMetadata - runs every `METADATA_CHECK_INTERVAL` seconds
 void GlobedGJBGL::selSendPlayerMetadata(float) {
     auto self = GlobedGJBGL::get();
 
-    if (!self || !self->established()) return;
-    // if there are no players or we are quitting from the level, don't send the packet
-    if (self->m_fields->players.empty() || self->m_fields->quitting) return;
+    if (!self || !self->established() || self->m_fields->quitting) return;
+
+    // the initial metadata goes out in postInitActions
+    if (!self->m_fields->lastSentMetadata) return;
 
     auto data = self->gatherPlayerMetadata();
-    NetworkManager::get().send(PlayerMetadataPacket::create(data));
+    if (data == *self->m_fields->lastSentMetadata) return;
+
+    // sent even when alone, the server keeps it for whoever joins later
+    self->m_fields->lastSentMetadata = data;
+    self->m_fields->playerStore->insertOrUpdate(GJAccountManager::get()->m_accountID, data.attempts, data.localBest);
+    NetworkManager::get().sendLatest(PlayerMetadataPacket::create(data));
 }
 
 // selPeriodicalUpdate - runs 4 times a second, does various stuff
@@ -519,8 +716,39 @@ void GlobedGJBGL::selPeriodicalUpdate(float) {
     if (!self || !self->established()) return;
     // if (!self->isCurrentPlayLayer()) return;
 
+    auto& timer = util::debug::MainThreadTimer::get();
+    util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::PeriodicalUpdate);
+
     // update the overlay
-    self->m_fields->overlay->updatePing(GameServerManager::get().getActivePing());
+    auto& nm = NetworkManager::get();
+    int ping = GameServerManager::get().getActivePing();
+    auto stats = nm.getConnectionStats();
+    self->m_fields->overlay->updatePing(ping);
+    self->m_fields->overlay->updateNetworkStats(stats);
+    self->m_fields->overlay->updateProfiler();
+
+    if (self->m_fields->overlay->wantsDetailedStats() && self->m_fields->interpolator) {
+        self->measureMemoryUsage();
+        self->m_fields->overlay->updateDetailedStats(stats, *self->m_fields->interpolator, self->m_fields->playerSlots);
+    }
+
+    // cached for selSendPlayerData, so the hot send path doesn't have to lock the traffic stats or copy the active server
+    // responses are split into several datagrams, so the loss is based on their sequence numbers
+    self->m_fields->congested = ping > CONGESTED_PING || stats.lossRate > CONGESTED_LOSS;
+
+    // the power source and the player count can both change mid level
+    self->updateSendRate();
+
+#ifdef GLOBED_VOICE_CAN_TALK
+    // level data goes over the same connection as voice, so its loss is a good estimate for voice packets too
+    GlobedAudioManager::get().setNetworkConditions(stats.lossRate, ping);
+#endif // GLOBED_VOICE_CAN_TALK
+
+    // let the server know what part of the level we see, so it can send far away players less often
+    if (!self->m_fields->players.empty() && nm.serverMatchesProtocol()) {
+        auto& camState = self->m_fields->camState;
+        nm.send(PlayerViewportPacket(camState.cameraOrigin, camState.cameraCoverage()));
+    }
 
     auto& pcm = ProfileCacheManager::get();
 
@@ -536,7 +764,30 @@ void GlobedGJBGL::selPeriodicalUpdate(float) {
             self->handlePlayerLeave(id);
         }
     } else {
-        util::collections::SmallVector<int, 256> ids;
+        // profile changes stay queued in the cache and ticks don't advance while deferred, so nothing is lost by skipping a run
+        bool refreshProfiles = timer.tryRun(self->m_fields->profileDeferrals);
+
+        // apply profiles that arrived or changed since the last run
+        if (refreshProfiles) {
+            for (int32_t id : pcm.takeChanges()) {
+                auto it = self->m_fields->players.find(id);
+                if (it == self->m_fields->players.end()) continue;
+
+                // the same player can be in the list more than once
+                auto* remotePlayer = it->second;
+                uint32_t version = pcm.getVersion(id);
+                if (remotePlayer->profileVersion == version) continue;
+
+                // might have been evicted already if a lot of profiles arrived at once
+                auto* data = pcm.findData(id);
+                if (!data) continue;
+
+                remotePlayer->updateAccountData(*data, true);
+                remotePlayer->profileVersion = version;
+            }
+        }
+
+        std::vector<int> ids;
 
         // kick players that have left the level
         for (const auto& [playerId, remotePlayer] : self->m_fields->players) {
@@ -546,78 +797,104 @@ void GlobedGJBGL::selPeriodicalUpdate(float) {
                 continue;
             }
 
-            auto data = pcm.getData(playerId);
+            if (!refreshProfiles) continue;
 
-            if (!remotePlayer->isValidPlayer()) {
-                if (data.has_value()) {
-                    // if the profile data already exists in cache, use it
-                    remotePlayer->updateAccountData(data.value(), true);
-                    continue;
-                }
-
-                // request again if it has either been 5 seconds, or if the player just joined
-                if (remotePlayer->getDefaultTicks() == 20) {
-                    remotePlayer->setDefaultTicks(0);
-                }
+            // profiles loaded from a previous session are shown right away, but still refreshed once
+            if (remotePlayer->isValidPlayer() && !pcm.isStale(playerId)) continue;
 
-                if (remotePlayer->getDefaultTicks() == 0) {
-                    ids.push_back(playerId);
-                }
-
-                remotePlayer->incDefaultTicks();
-            } else if (data.has_value()) {
-                // still try to see if the cache has changed
-                remotePlayer->updateAccountData(data.value());
+            // request again if it has either been 5 seconds, or if the player just joined
+            if (remotePlayer->getDefaultTicks() == 20) {
+                remotePlayer->setDefaultTicks(0);
             }
-        }
 
-        if (ids.size() > 3) {
-            NetworkManager::get().send(RequestPlayerProfilesPacket::create(0));
-        } else {
-            for (int id : ids) {
-                NetworkManager::get().send(RequestPlayerProfilesPacket::create(id));
+            if (remotePlayer->getDefaultTicks() == 0) {
+                ids.push_back(playerId);
             }
+
+            remotePlayer->incDefaultTicks();
         }
 
+        self->requestProfiles(std::move(ids));
+
         for (int id : toRemove) {
             self->handlePlayerLeave(id);
         }
     }
 
     // update the ping to the server if overlay is enabled
-    if (GlobedSettings::get().overlay.enabled) {
+    if (GlobedSettings::get().snapshot().overlayEnabled) {
         NetworkManager::get().updateServerPing();
     }
+
+    // retry a discord rpc update that selUpdateDRPC had to defer
+    if (self->m_fields->drpcPending && timer.tryRun(self->m_fields->drpcDeferrals)) {
+        self->m_fields->drpcPending = false;
+        self->updateDRPC();
+    }
 }
 
 // selUpdate - runs every frame, increments the non-decreasing time counter, interpolates and updates players
-void GlobedGJBGL::selUpdate(float timescaledDt) {
-    // timescale silently changing dt isn't very good when doing network interpolation >_>
-    // since timeCounter needs to agree with everyone else on how long a second is!
-    float dt = timescaledDt / CCScheduler::get()->getTimeScale();
-
+void GlobedGJBGL::selUpdate(float) {
     auto self = GlobedGJBGL::get();
 
     if (!self) return;
 
+    GLOBED_PROFILE_ZONE("GlobedGJBGL::selUpdate");
+    util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::Update);
+    util::debug::MainThreadTimer::get().frame(util::time::micros(GlobedSettings::get().snapshot().frameBudget));
+
+    // timeCounter needs to agree with everyone else on the time, so it comes from the clock synced to the server
+    // and not from frame delta, which is affected by the timescale and by frame hitches.
+    // dt is clamped since the first frame has nothing to compare to and clock sync can nudge the time either way.
+    double now = NetworkManager::get().serverTime();
+    float dt = static_cast<float>(std::clamp(now - self->m_fields->timeCounter, 0.0, 1.0));
+    self->m_fields->timeCounter = now;
+
+    if (self->m_fields->sessionPlayback) {
+        self->updateSessionPlayback();
+    }
+
+    if (self->m_fields->scenarioBench) {
+        self->updateScenarioBench();
+    }
+
     self->m_fields->camState.visibleOrigin = CCPoint{0.f, 0.f};
     self->m_fields->camState.visibleCoverage = CCDirector::get()->getWinSize();
 
     self->m_fields->camState.cameraOrigin = self->m_gameState.m_cameraPosition;
     self->m_fields->camState.zoom = self->m_objectLayer->getScale();
 
-    // update ourselves
-    auto accountId = GJAccountManager::get()->m_accountID;
-    self->m_fields->playerStore->insertOrUpdate(
-        accountId,
-        self->m_level->m_attempts,
-        static_cast<uint32_t>(self->m_level->isPlatformer() ? self->m_level->m_bestTime : self->m_level->m_normalPercent)
-    );
+    // periodic tasks are spaced evenly on the network clock, a late frame runs each of them at most once
+    auto& timers = self->m_fields->timers;
 
-    self->m_fields->timeCounter += dt;
+    if (timers.poll(PeriodicTask::SendPlayerData, now)) {
+        self->selSendPlayerData(0.f);
+    }
+
+    if (timers.poll(PeriodicTask::SendLinkedData, now)) {
+        self->selSendLinkedData(0.f);
+    }
+
+    if (timers.poll(PeriodicTask::SendPlayerMetadata, now)) {
+        self->selSendPlayerMetadata(0.f);
+    }
+
+    if (timers.poll(PeriodicTask::PeriodicalUpdate, now)) {
+        self->selPeriodicalUpdate(0.f);
+    }
+
+    if (timers.poll(PeriodicTask::UpdateEstimators, now)) {
+        self->selUpdateEstimators(timers.getInterval(PeriodicTask::UpdateEstimators));
+    }
+
+    if (timers.poll(PeriodicTask::UpdateDRPC, now)) {
+        self->selUpdateDRPC(0.f);
+    }
 
     self->m_fields->interpolator->tick(dt);
 
+    static_cast<HookedGameManager*>(GameManager::get())->pollDeathEffects();
+
     if (auto pl = PlayLayer::get()) {
         if (self->m_fields->progressBarWrapper->getParent() != nullptr) {
             self->m_fields->selfProgressIcon->updatePosition(pl->getCurrentPercent() / 100.f, self->m_isPracticeMode);
@@ -632,60 +909,113 @@ void GlobedGJBGL::selUpdate(float timescaledDt) {
 
     auto& bl = BlockListManager::get();
     auto& vpm = VoicePlaybackManager::get();
-    auto& settings = GlobedSettings::get();
+    auto& settings = GlobedSettings::get().snapshot();
 
-    for (const auto [playerId, remotePlayer] : self->m_fields->players) {
-        const auto& vstate = self->m_fields->interpolator->getPlayerState(playerId);
+    auto& slots = self->m_fields->playerSlots;
+    auto& interpolator = *self->m_fields->interpolator;
 
-        auto frameFlags = self->m_fields->interpolator->swapFrameFlags(playerId);
+    // in crowd mode only the players around the center of the camera get the full treatment
+    int crowdThreshold = settings.crowdModeThreshold;
+    bool crowdMode = crowdThreshold != 0 && slots.size() > static_cast<size_t>(crowdThreshold) && self->m_fields->crowdRenderer;
+    size_t playtesters = 0;
+    auto& camState = self->m_fields->camState;
+    CCPoint cameraCenter = camState.cameraOrigin + camState.cameraCoverage() / 2.f;
+    float detailRadius = std::max(camState.cameraCoverage().width, camState.cameraCoverage().height) * CROWD_DETAIL_RADIUS;
 
-        bool isSpeaking = vpm.isSpeaking(playerId);
-        remotePlayer->updateData(
-            vstate,
-            frameFlags,
-            isSpeaking,
-            isSpeaking ? vpm.getLoudness(playerId) : 0.f
-        );
+    if (self->m_fields->crowdRenderer) {
+        self->m_fields->crowdRenderer->begin();
+    }
 
-        // update progress icons
-        if (auto self = PlayLayer::get()) {
-            // dont update if we are in a normal level and without a progressbar
-            if (self->m_level->isPlatformer() || self->m_progressBar->isVisible()) {
-                remotePlayer->updateProgressIcon();
-            }
+    // dont update progress icons if we are in a normal level and without a progressbar
+    auto* playLayer = PlayLayer::get();
+    bool showProgress = playLayer && (playLayer->m_level->isPlatformer() || playLayer->m_progressBar->isVisible());
+
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        int playerId = slots.idAt(slot);
+        auto* remotePlayer = self->m_fields->slotPlayers[slot];
+
+        const auto& vstate = interpolator.getPlayerStateAt(slot);
+        auto frameFlags = interpolator.swapFrameFlagsAt(slot);
+        auto* stream = vpm.findStream(playerId);
+
+        // hidden players are only tracked for their status, they aren't interpolated or drawn and their events are dropped
+        bool hidden = remotePlayer->getForciblyHidden() || (settings.hidePracticePlayers && vstate.isPracticing);
+        interpolator.setDormantAt(slot, hidden);
+
+        if (hidden) {
+            remotePlayer->updateHidden(vstate);
+            remotePlayer->updateProgressIcon();
+            self->updateProximityVolume(playerId, vstate, stream);
+            continue;
+        }
+
+        // builders in the editor have nothing to show but their status, so their icons stay hidden until they playtest
+        if (vstate.isEditorBuilding) {
+            remotePlayer->updateBuilding(vstate);
+            remotePlayer->updateProgressIcon();
+            self->updateProximityVolume(playerId, vstate, stream);
+            continue;
+        }
+
+        playtesters++;
+
+        if (crowdMode && cameraCenter.getDistance(vstate.player1.position) > detailRadius) {
+            remotePlayer->updateCrowd(vstate, self->m_fields->crowdRenderer);
+            remotePlayer->updateProgressIcon();
+            self->updateProximityVolume(playerId, vstate, stream);
+            continue;
+        }
+
+        bool isSpeaking = false;
+        float loudness = 0.f;
+
+#ifdef GLOBED_VOICE_SUPPORT
+        if (stream && !stream->starving) {
+            isSpeaking = true;
+            loudness = stream->getLoudness();
+        }
+#endif
+
+        remotePlayer->updateData(vstate, frameFlags, isSpeaking, loudness);
+
+        if (showProgress) {
+            remotePlayer->updateProgressIcon();
         }
 
         // update voice proximity
-        self->updateProximityVolume(playerId);
+        self->updateProximityVolume(playerId, vstate, stream);
+    }
+
+    if (self->m_fields->crowdRenderer) {
+        self->m_fields->crowdRenderer->end();
+    }
+
+    self->m_fields->remotePlaytesters = playtesters;
+
+    self->applyProximityVolumes();
+
+    self->rebuildCollisionGrid();
+
+    // our status icons and names are on anchors that follow the icons, the anchors are the only thing moved every frame
+    if (self->m_fields->ownLabelAnchor) {
+        self->m_fields->ownLabelAnchor->setPosition(self->m_player1->getPosition());
     }
 
     if (self->m_fields->selfStatusIcons) {
-        self->m_fields->selfStatusIcons->setPosition(self->m_player1->getPosition() + CCPoint{0.f, 25.f});
         bool recording = VoiceRecordingManager::get().isRecording();
-
         self->m_fields->selfStatusIcons->updateStatus(false, false, recording, false, 0.f);
     }
 
-    if (self->m_fields->voiceOverlay) {
-        self->m_fields->voiceOverlay->updateOverlaySoft();
+    if (self->m_fields->ownNameLabel) {
+        self->m_fields->ownNameLabel->setVisible(!self->m_player1->m_isHidden);
     }
 
-    // update self names
-    if (self->m_fields->ownNameLabel) {
-        if (self->m_player1->m_isHidden) {
-            self->m_fields->ownNameLabel->setVisible(false);
-        } else {
-            self->m_fields->ownNameLabel->setVisible(true);
-            self->m_fields->ownNameLabel->setPosition(self->m_player1->getPosition() + CCPoint{0.f, 25.f});
-        }
+    if (self->m_fields->ownNameLabel2) {
+        bool visible = !self->m_player2->m_isHidden && self->m_gameState.m_isDualMode;
+        self->m_fields->ownNameLabel2->setVisible(visible);
 
-        if (self->m_fields->ownNameLabel2) {
-            if (self->m_player2->m_isHidden || !self->m_gameState.m_isDualMode) {
-                self->m_fields->ownNameLabel2->setVisible(false);
-            } else {
-                self->m_fields->ownNameLabel2->setVisible(true);
-                self->m_fields->ownNameLabel2->setPosition(self->m_player2->getPosition() + CCPoint{0.f, 25.f});
-            }
+        if (visible) {
+            self->m_fields->ownLabelAnchor2->setPosition(self->m_player2->getPosition());
         }
     }
 }
@@ -694,6 +1024,14 @@ void GlobedGJBGL::selUpdate(float timescaledDt) {
 void GlobedGJBGL::selUpdateEstimators(float dt) {
     auto* self = GlobedGJBGL::get();
 
+    util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::Estimators);
+
+    // the estimators only need the total time, so a deferred run just gets a bigger step next time
+    self->m_fields->deferredEstimatorDt += dt;
+    if (!util::debug::MainThreadTimer::get().tryRun(self->m_fields->estimatorDeferrals)) return;
+
+    dt = std::exchange(self->m_fields->deferredEstimatorDt, 0.f);
+
     // update volume estimators
     VoicePlaybackManager::get().updateAllEstimators(dt);
 
@@ -707,6 +1045,17 @@ void GlobedGJBGL::updateDRPC() {
 
     if (!GlobedSettings::get().globed.useDiscordRPC) return;
 
+    Fields::DiscordPresence presence {
+        .levelId = m_level->m_levelID.value(),
+        .playerCount = m_fields->players.size() + 1,
+    };
+
+    if (m_fields->sentPresence == presence) return;
+
+    // a change that comes too soon stays pending, the next check picks it up
+    auto now = util::time::now();
+    if (m_fields->sentPresence && now - m_fields->lastPresenceUpdate < DRPC_MIN_UPDATE_INTERVAL) return;
+
     // taken from drpc
     bool isRobTopLevel = (
         (m_level->m_levelID.value() < 128 && m_level->m_levelID.value() != 0) ||
@@ -716,8 +1065,10 @@ void GlobedGJBGL::updateDRPC() {
 
     auto state = fmt::format("{} by {}", std::string(m_level->m_levelName), (isRobTopLevel) ? "RobTopGames" : std::string(m_level->m_creatorName));
 
-    using SetRPCEvent = geode::DispatchEvent<bool>;
-    SetRPCEvent("techstudent10.discord_rich_presence/set_default_rpc_enabled", false).post();
+    if (!m_fields->sentPresence) {
+        using SetRPCEvent = geode::DispatchEvent<bool>;
+        SetRPCEvent("techstudent10.discord_rich_presence/set_default_rpc_enabled", false).post();
+    }
 
     using UpdateRPCEvent = geode::DispatchEvent<std::string>;
     auto json = matjson::Value(matjson::Object({
@@ -730,18 +1081,28 @@ void GlobedGJBGL::updateDRPC() {
         {"shouldResetTime", false},
         {"largeImageKey", "https://github.com/HJfod/globed-site/blob/main/public/logo.png?raw=true"},
         {"largeImageText", ""},
-        {"joinSecret", std::to_string(m_level->m_levelID.value())},
-        {"partyMax", m_fields->players.size() + 1}
+        {"joinSecret", std::to_string(presence.levelId)},
+        {"partyMax", presence.playerCount}
     })).dump();
     UpdateRPCEvent("techstudent10.discord_rich_presence/update_rpc", json).post();
+
+    m_fields->sentPresence = presence;
+    m_fields->lastPresenceUpdate = now;
 }
 
-// selUpdateDRPC - runs every 10 seconds, updates Discord RPC
+// selUpdateDRPC - runs every second, updates Discord RPC if the presence changed
 void GlobedGJBGL::selUpdateDRPC(float dt) {
     auto self = GlobedGJBGL::get();
 
     if (!self || !self->established()) return;
 
+    util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::DiscordRPC);
+
+    // when over budget, selPeriodicalUpdate retries it a bit later
+    self->m_fields->drpcPending = true;
+    if (!util::debug::MainThreadTimer::get().tryRun(self->m_fields->drpcDeferrals)) return;
+
+    self->m_fields->drpcPending = false;
     self->updateDRPC();
 }
 
@@ -761,11 +1122,6 @@ SpecificIconData GlobedGJBGL::gatherSpecificIconData(PlayerObject* player) {
 
     float rot = player->getRotation();
 
-    bool isPlayer1 = player == m_player1;
-
-    auto spiderTeleportData = isPlayer1 ? util::misc::swapOptional(m_fields->spiderTp1) : util::misc::swapOptional(m_fields->spiderTp2);
-    bool didJustJump = isPlayer1 ? util::misc::swapFlag(m_fields->didJustJumpp1) : util::misc::swapFlag(m_fields->didJustJumpp2);
-
     bool isStationary = false;
     if (m_level->isPlatformer()) {
         isStationary = std::abs(player->m_platformerXVelocity) < 0.1;
@@ -784,11 +1140,8 @@ SpecificIconData GlobedGJBGL::gatherSpecificIconData(PlayerObject* player) {
         .isGrounded = player->m_isOnGround,
         .isStationary = isStationary,
         .isFalling = player->m_yVelocity < 0.0,
-        .didJustJump = didJustJump,
         .isRotating = player->m_isRotating,
         .isSideways = player->m_isSideways,
-
-        .spiderTeleportData = spiderTeleportData
     };
 }
 
@@ -796,7 +1149,7 @@ PlayerData GlobedGJBGL::gatherPlayerData() {
     bool isDead = m_player1->m_isDead || m_player2->m_isDead;
     if (isDead && !m_fields->isCurrentlyDead) {
         m_fields->isCurrentlyDead = true;
-        m_fields->lastDeathTimestamp = m_fields->timeCounter;
+        this->queuePlayerEvent(PlayerEventType::Death, false);
     } else if (!isDead) {
         m_fields->isCurrentlyDead = false;
     }
@@ -832,13 +1185,20 @@ PlayerData GlobedGJBGL::gatherPlayerData() {
         isEditorBuilding = this->m_playbackMode == PlaybackMode::Not;
     }
 
+    auto player1 = this->gatherSpecificIconData(m_player1);
+    auto player2 = this->gatherSpecificIconData(m_player2);
+
+    // the icons don't mean anything while building, blank ones keep every delta down to the header
+    if (isEditorBuilding) {
+        player1 = {};
+        player2 = {};
+    }
+
     return PlayerData {
         .timestamp = m_fields->timeCounter,
 
-        .player1 = this->gatherSpecificIconData(m_player1),
-        .player2 = this->gatherSpecificIconData(m_player2),
-
-        .lastDeathTimestamp = m_fields->lastDeathTimestamp,
+        .player1 = player1,
+        .player2 = player2,
 
         .currentPercentage = currentPercentage,
 
@@ -851,6 +1211,41 @@ PlayerData GlobedGJBGL::gatherPlayerData() {
     };
 }
 
+void GlobedGJBGL::queuePlayerEvent(PlayerEventType type, bool player2, SpiderTeleportData teleport) {
+    auto& events = m_fields->outgoingEvents;
+
+    // a frame can't carry more, and the oldest one has been repeated the most (or is stale, if nothing was sent in a while)
+    if (events.size() == PlayerEventList::CAPACITY) {
+        events.erase(events.begin());
+    }
+
+    events.push_back({
+        .event = PlayerEvent {
+            .sequence = m_fields->eventSequence++,
+            .type = type,
+            .player2 = player2,
+            .teleport = teleport,
+        },
+    });
+}
+
+void GlobedGJBGL::attachPlayerEvents(PlayerData& data) {
+    auto& events = m_fields->outgoingEvents;
+    double now = m_fields->timeCounter;
+
+    std::erase_if(events, [now](const auto& out) {
+        return out.sends >= PLAYER_EVENT_MIN_SENDS && now - out.firstSent >= PLAYER_EVENT_RESEND_TIME;
+    });
+
+    for (auto& out : events) {
+        if (out.sends++ == 0) {
+            out.firstSent = now;
+        }
+
+        data.events.push(out.event);
+    }
+}
+
 PlayerMetadata GlobedGJBGL::gatherPlayerMetadata() {
     uint32_t localBest;
     if (m_level->isPlatformer()) {
@@ -866,14 +1261,14 @@ PlayerMetadata GlobedGJBGL::gatherPlayerMetadata() {
 }
 
 bool GlobedGJBGL::shouldLetMessageThrough(int playerId) {
-    auto& settings = GlobedSettings::get();
+    auto& settings = GlobedSettings::get().snapshot();
     auto& flm = FriendListManager::get();
     auto& bl = BlockListManager::get();
 
     if (bl.isExplicitlyBlocked(playerId)) return false;
     if (bl.isExplicitlyAllowed(playerId)) return true;
 
-    if (settings.communication.onlyFriends && !flm.isFriend(playerId)) return false;
+    if (settings.onlyFriends && !flm.isFriend(playerId)) return false;
 
     return true;
 }
@@ -889,36 +1284,194 @@ void GlobedGJBGL::updateProximityVolume(int playerId) {
         return;
     }
 
+    this->updateProximityVolume(playerId, m_fields->interpolator->getPlayerState(playerId), vpm.findStream(playerId));
+    this->applyProximityVolumes();
+}
+
+void GlobedGJBGL::updateProximityVolume(int playerId, const VisualPlayerState& vstate, AudioStream* stream) {
+#ifdef GLOBED_VOICE_SUPPORT
+    if (m_fields->deafened || !m_fields->isVoiceProximity || !stream) return;
+    if (!this->shouldLetMessageThrough(playerId)) return;
+
+    // queued and applied for everyone at once in `applyProximityVolumes`
+    auto offset = vstate.player1.position - m_player1->getPosition();
+    m_fields->spatializer.push(stream, offset.x, offset.y, vstate.isInEditor);
+#endif // GLOBED_VOICE_SUPPORT
+}
+
+#ifdef GLOBED_VOICE_SUPPORT
+void GlobedGJBGL::handleVoiceFrame(int sender, EncodedAudioFrame&& frame) {
+    // if deafened or voice is disabled, do nothing
+    auto& settings = GlobedSettings::get();
+
+    if (m_fields->deafened || !settings.communication.voiceEnabled) return;
+    if (!this->shouldLetMessageThrough(sender)) return;
+
+    // the server only filters by the last known positions, skip decoding frames that would be silent anyway
+    if (m_fields->isVoiceProximity && !this->isVoiceAudible(sender)) return;
+
+    auto& vpm = VoicePlaybackManager::get();
+    try {
+        vpm.prepareStream(sender);
+
+        if (m_fields->isVoiceProximity) {
+            this->updateProximityVolume(sender);
+        } else {
+            vpm.setVolume(sender, settings.communication.voiceVolume);
+        }
+
+        // decoded on a separate thread
+        vpm.playFrameStreamed(sender, std::move(frame));
+    } catch(const std::exception& e) {
+        ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + e.what());
+    }
+}
+#endif // GLOBED_VOICE_SUPPORT
+
+bool GlobedGJBGL::isVoiceAudible(int playerId) {
+    if (!m_fields->interpolator->hasPlayer(playerId)) return false;
+
     auto& vstate = m_fields->interpolator->getPlayerState(playerId);
+    if (vstate.isInEditor) return true;
+
+    // same falloff as `VoiceSpatializer::apply`
+    float distance = vstate.player1.position.getDistance(m_player1->getPosition());
+    return 1.f - distance / PROXIMITY_VOICE_LIMIT >= PROXIMITY_VOICE_MIN_GAIN;
+}
+
+void GlobedGJBGL::sendVoiceProximity() {
+#ifdef GLOBED_VOICE_SUPPORT
+    auto& nm = NetworkManager::get();
+    if (!nm.serverMatchesProtocol()) return;
+
+    nm.send(VoiceProximityPacket::create(m_fields->isVoiceProximity ? PROXIMITY_VOICE_LIMIT : 0.f));
+#endif // GLOBED_VOICE_SUPPORT
+}
+
+void GlobedGJBGL::applyProximityVolumes() {
+#ifdef GLOBED_VOICE_SUPPORT
+    auto& settings = GlobedSettings::get().snapshot();
+    m_fields->spatializer.apply(PROXIMITY_VOICE_LIMIT, settings.voiceVolume, settings.voicePanning);
+#endif // GLOBED_VOICE_SUPPORT
+}
+
+void GlobedGJBGL::requestProfiles(std::vector<int>&& ids) {
+    auto& nm = NetworkManager::get();
+
+    if (ids.size() > 1 && nm.serverMatchesProtocol()) {
+        constexpr size_t BATCH = RequestPlayerProfilesBatchPacket::MAX_PLAYERS;
 
-    float distance = cocos2d::ccpDistance(m_player1->getPosition(), vstate.player1.position);
-    float volume = 1.f - std::clamp(distance, 0.01f, PROXIMITY_VOICE_LIMIT) / PROXIMITY_VOICE_LIMIT;
-    if (vstate.isInEditor) {
-        volume = 1.f;
+        for (size_t i = 0; i < ids.size(); i += BATCH) {
+            auto end = ids.begin() + std::min(i + BATCH, ids.size());
+            nm.send(RequestPlayerProfilesBatchPacket::create(std::vector<int>(ids.begin() + i, end)));
+        }
+
+        return;
     }
 
-    auto& settings = GlobedSettings::get();
+    // older servers only know about single players, or everyone at once
+    if (ids.size() > 3) {
+        nm.send(RequestPlayerProfilesPacket::create(0));
+    } else {
+        for (int id : ids) {
+            nm.send(RequestPlayerProfilesPacket::create(id));
+        }
+    }
+}
+
+void GlobedGJBGL::handleLevelData(const std::vector<AssociatedPlayerData>& players) {
+    m_fields->lastServerUpdate = m_fields->timeCounter;
+
+    // a playback being recorded again would only make a copy of the same recording
+    if (SessionRecorder::isEnabled() && !m_fields->sessionPlayback) {
+        SessionRecorder::get().record(m_fields->timeCounter, players);
+    }
+
+    for (const auto& player : players) {
+        if (!m_fields->players.contains(player.accountId)) {
+            // new player joined
+            this->handlePlayerJoin(player.accountId);
+        }
 
-    if (this->shouldLetMessageThrough(playerId)) {
-        vpm.setVolume(playerId, volume * settings.communication.voiceVolume);
+        m_fields->interpolator->updatePlayer(player.accountId, player.data, m_fields->lastServerUpdate);
     }
 }
 
+void GlobedGJBGL::handleLinkedData(int playerId, const PlayerData& data) {
+    // the level data introduces new players, this stream only speeds up one we already know
+    if (!m_fields->players.contains(playerId)) return;
+
+    // the frames come a lot more often than level data, so the player can be shown much closer to the newest one
+    m_fields->interpolator->setLowLatency(playerId, 1.f / LINKED_TPS);
+    m_fields->interpolator->updatePlayer(playerId, data, m_fields->timeCounter);
+}
+
+void GlobedGJBGL::updateSessionPlayback() {
+    auto& playback = m_fields->sessionPlayback;
+    double now = m_fields->timeCounter;
+
+    if (m_fields->playbackStart < 0.0) {
+        m_fields->playbackStart = now;
+    }
+
+    // the recorded frames are stamped with the clock of the recording, shift them so the interpolator sees them as current
+    double shift = m_fields->playbackStart - playback->getStartTime();
+
+    auto res = playback->advance(now - m_fields->playbackStart, [&](SessionPlayback::Frame& frame) {
+        for (auto& player : frame.players) {
+            player.data.timestamp += shift;
+        }
+
+        this->handleLevelData(frame.players);
+    });
+
+    if (!res) {
+        ErrorQueues::get().warn(fmt::format("Session playback failed: {}", res.unwrapErr()));
+        playback.reset();
+    } else if (!res.unwrap()) {
+        // the ghosts go stale and get removed like players that stopped sending data
+        playback.reset();
+    }
+}
+
+void GlobedGJBGL::updateScenarioBench() {
+    auto& bench = m_fields->scenarioBench;
+
+    PlayerData base {
+        .timestamp = m_fields->timeCounter,
+        .player1 = this->gatherSpecificIconData(m_player1),
+        .player2 = this->gatherSpecificIconData(m_player2),
+        .isDualMode = m_gameState.m_isDualMode,
+    };
+
+    if (bench->update(m_fields->timeCounter, base)) return;
+
+    auto res = bench->writeReport();
+    if (!res) {
+        ErrorQueues::get().warn(fmt::format("Failed to write the benchmark report: {}", res.unwrapErr()));
+    } else {
+        ErrorQueues::get().success(fmt::format("Scenario benchmark finished, see {}", res.unwrap().filename().string()));
+    }
+
+    // the synthetic players go stale and get removed like players that stopped sending data
+    bench.reset();
+}
+
 void GlobedGJBGL::handlePlayerJoin(int playerId) {
-    auto& settings = GlobedSettings::get();
+    auto& settings = GlobedSettings::get().snapshot();
 
     PlayerProgressIcon* progressIcon = nullptr;
     PlayerProgressArrow* progressArrow = nullptr;
 
     bool platformer = m_level->isPlatformer();
 
-    if (!platformer && settings.levelUi.progressIndicators) {
+    if (!platformer && settings.progressIndicators) {
         Build<PlayerProgressIcon>::create()
             .zOrder(2)
             .id(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)))
             .parent(m_fields->progressBarWrapper)
             .store(progressIcon);
-    } else if (platformer && settings.levelUi.progressIndicators) {
+    } else if (platformer && settings.progressIndicators) {
         Build<PlayerProgressArrow>::create()
             .zOrder(2)
             .id(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)))
@@ -937,15 +1490,28 @@ void GlobedGJBGL::handlePlayerJoin(int playerId) {
         }
     }
 
-    auto* rp = Build<RemotePlayer>::create(&m_fields->camState, progressIcon, progressArrow)
-        .zOrder(10)
-        .id(util::cocos::spr(fmt::format("remote-player-{}", playerId)))
-        .collect();
+    Ref<RemotePlayer> rp;
+    bool reused = !m_fields->playerPool.empty();
+
+    if (reused) {
+        rp = m_fields->playerPool.back();
+        m_fields->playerPool.pop_back();
+        rp->reuse(progressIcon, progressArrow);
+    } else {
+        rp = Build<RemotePlayer>::create(&m_fields->camState, progressIcon, progressArrow)
+            .zOrder(10)
+            .collect();
+    }
+
+    rp->setID(util::cocos::spr(fmt::format("remote-player-{}", playerId)));
 
     auto& pcm = ProfileCacheManager::get();
-    auto pcmData = pcm.getData(playerId);
-    if (pcmData.has_value()) {
-        rp->updateAccountData(pcmData.value(), true);
+    if (auto* pcmData = pcm.findData(playerId)) {
+        rp->updateAccountData(*pcmData, true);
+        rp->profileVersion = pcm.getVersion(playerId);
+    } else if (reused) {
+        // don't show the icons of whoever used this player before
+        rp->updateAccountData(PlayerAccountData::DEFAULT_DATA, true);
     }
 
     auto& bl = BlockListManager::get();
@@ -955,6 +1521,12 @@ void GlobedGJBGL::handlePlayerJoin(int playerId) {
 
     m_objectLayer->addChild(rp);
     m_fields->players.emplace(playerId, rp);
+
+    size_t slot = m_fields->playerSlots.add(playerId);
+    if (slot == m_fields->slotPlayers.size()) {
+        m_fields->slotPlayers.push_back(rp);
+    }
+
     m_fields->interpolator->addPlayer(playerId);
 
     // log::debug("Player joined: {}", playerId);
@@ -966,16 +1538,127 @@ void GlobedGJBGL::handlePlayerLeave(int playerId) {
     if (!m_fields->players.contains(playerId)) return;
 
     auto rp = m_fields->players.at(playerId);
+
+    // the sticky lists point at the visual players, which are about to go away
+    for (auto* sticky : {&m_fields->stickyP1, &m_fields->stickyP2}) {
+        std::erase(*sticky, rp->player1);
+        std::erase(*sticky, rp->player2);
+    }
+
     rp->removeProgressIndicators();
+    rp->removeBatchedNames();
+
+    // keep it alive for the next player that joins
+    if (m_fields->playerPool.size() < PLAYER_POOL_MAX) {
+        m_fields->playerPool.push_back(rp);
+    }
+
     rp->removeFromParent();
 
     m_fields->players.erase(playerId);
-    m_fields->interpolator->removePlayer(playerId);
+
+    auto removal = m_fields->playerSlots.remove(playerId);
+    if (removal.slot != PlayerSlots::INVALID) {
+        auto& slotPlayers = m_fields->slotPlayers;
+        slotPlayers[removal.slot] = slotPlayers[removal.last];
+        slotPlayers.pop_back();
+    }
+
+    m_fields->interpolator->removePlayer(removal);
+
+    if (m_fields->twopstate.linkedId == playerId) {
+        m_fields->twopstate.linkedId = 0;
+    }
+
+    // the grid points at the visual players of everyone, so it has to forget about this one
+    this->rebuildCollisionGrid();
     m_fields->playerStore->removePlayer(playerId);
 
     // log::debug("Player removed: {}", playerId);
 }
 
+static bool isIdleIcon(const SpecificIconData& last, const SpecificIconData& current) {
+    return current.isStationary
+        || (util::math::equal(last.position.x, current.position.x) && util::math::equal(last.position.y, current.position.y));
+}
+
+static bool hasIconEvent(const SpecificIconData& last, const SpecificIconData& current) {
+    return last.iconType != current.iconType
+        || last.isVisible != current.isVisible
+        || last.isUpsideDown != current.isUpsideDown
+        || last.isMini != current.isMini;
+}
+
+bool GlobedGJBGL::shouldSendPlayerData(const PlayerData& data) {
+    if (!m_fields->lastSentData) return true;
+
+    auto& last = m_fields->lastSentData.value();
+
+    // things the interpolator can't guess must be sent right away
+    if (last.isDead != data.isDead
+        || last.isPaused != data.isPaused
+        || last.isDualMode != data.isDualMode
+        || last.isEditorBuilding != data.isEditorBuilding
+        || (!m_fields->outgoingEvents.empty() && m_fields->outgoingEvents.back().sends == 0)
+        || hasIconEvent(last.player1, data.player1)
+        || hasIconEvent(last.player2, data.player2)
+    ) {
+        return true;
+    }
+
+    if (data.isEditorBuilding && m_fields->remotePlaytesters == 0) {
+        uint32_t interval = std::max(1u, static_cast<uint32_t>(m_fields->configuredTps * EDITOR_STATUS_INTERVAL));
+        return m_fields->skippedSends + 1 >= interval;
+    }
+
+    uint32_t interval = 1;
+
+    bool idle = data.isPaused || (isIdleIcon(last.player1, data.player1) && (!data.isDualMode || isIdleIcon(last.player2, data.player2)));
+    if (idle) {
+        interval = IDLE_SEND_INTERVAL;
+    }
+
+    if (m_fields->congested) {
+        interval *= CONGESTED_SEND_INTERVAL;
+    }
+
+    return m_fields->skippedSends + 1 >= interval;
+}
+
+void GlobedGJBGL::updateSendRate() {
+    auto& settings = GlobedSettings::get();
+
+    uint32_t tps = NetworkManager::get().getServerTps();
+    if (settings.globed.tpsCap.get() != 0) {
+        tps = std::min(tps, static_cast<uint32_t>(settings.globed.tpsCap.get()));
+    }
+
+    // the server lowers the rate of crowded levels to keep up with the level data
+    if (m_fields->levelTps != 0) {
+        tps = std::min(tps, m_fields->levelTps);
+    }
+
+    // crowded levels need every update to look right, so they run at the full rate even on battery
+    int crowdThreshold = settings.snapshot().crowdModeThreshold;
+    bool crowded = crowdThreshold != 0 && m_fields->players.size() > static_cast<size_t>(crowdThreshold);
+    bool savingPower = PowerManager::get().savingPower() && !crowded;
+
+    if (savingPower) {
+        tps = std::min(tps, LOW_POWER_TPS);
+    }
+
+    VoicePlaybackManager::get().setMaxSpeakers(savingPower ? LOW_POWER_MAX_SPEAKERS : 0);
+
+    if (tps == m_fields->configuredTps) return;
+
+    m_fields->configuredTps = tps;
+    m_fields->timers.setInterval(PeriodicTask::SendPlayerData, 1.0 / tps);
+
+    if (m_fields->interpolator) {
+        m_fields->interpolator->setExpectedDelta(1.f / tps);
+    }
+}
+
 bool GlobedGJBGL::established() {
     // the 2nd check is in case we disconnect while being in a level somehow
     return m_fields->globedReady && NetworkManager::get().established();
@@ -1008,6 +1691,30 @@ bool GlobedGJBGL::isEditor() {
     return (void*)LevelEditorLayer::get() == (void*)this;
 }
 
+PlayerIconTypeMask GlobedGJBGL::getLevelIconTypes() {
+    if (m_fields->levelIconTypes) return *m_fields->levelIconTypes;
+
+    bool platformer = m_level->isPlatformer() || m_fields->forcedPlatformer;
+    PlayerIconTypeMask types = iconTypeBit(PlayerIconType::Cube);
+
+    for (auto* obj : CCArrayExt<GameObject*>(m_objects)) {
+        switch (obj->m_objectID) {
+            // the ship turns into a jetpack in platformer
+            case 13: types |= iconTypeBit(platformer ? PlayerIconType::Jetpack : PlayerIconType::Ship); break;
+            case 47: types |= iconTypeBit(PlayerIconType::Ball); break;
+            case 111: types |= iconTypeBit(PlayerIconType::Ufo); break;
+            case 660: types |= iconTypeBit(PlayerIconType::Wave); break;
+            case 745: types |= iconTypeBit(PlayerIconType::Robot); break;
+            case 1331: types |= iconTypeBit(PlayerIconType::Spider); break;
+            case 1933: types |= iconTypeBit(PlayerIconType::Swing); break;
+            default: break;
+        }
+    }
+
+    m_fields->levelIconTypes = types;
+    return types;
+}
+
 bool GlobedGJBGL::isSafeMode() {
     return m_fields->shouldStopProgress;
 }
@@ -1024,6 +1731,14 @@ void GlobedGJBGL::onQuitActions() {
     auto& nm = NetworkManager::get();
 
     m_fields->quitting = true;
+    globed::releaseLevelHooks(this);
+
+    if (SessionRecorder::isEnabled()) {
+        SessionRecorder::get().stop();
+    }
+
+    this->measureMemoryUsage();
+    util::memory::MemoryTracker::get().logSummary("level exit");
 
     if (m_fields->globedReady) {
         if (nm.established()) {
@@ -1035,6 +1750,7 @@ void GlobedGJBGL::onQuitActions() {
         // stop voice recording and playback
         GlobedAudioManager::get().haltRecording();
         VoicePlaybackManager::get().stopAllStreams();
+        VoicePlaybackManager::get().setMaxSpeakers(0);
 #endif // GLOBED_VOICE_SUPPORT
     }
 
@@ -1043,6 +1759,20 @@ void GlobedGJBGL::onQuitActions() {
     SetRPCEvent("techstudent10.discord_rich_presence/set_default_rpc_enabled", true).post();
 }
 
+void GlobedGJBGL::measureMemoryUsage() {
+    size_t total = 0;
+
+    for (const auto& [_, rp] : m_fields->players) {
+        total += util::memory::nodeTreeSize(rp);
+    }
+
+    for (const auto& rp : m_fields->playerPool) {
+        total += util::memory::nodeTreeSize(rp);
+    }
+
+    util::memory::MemoryTracker::get().set(util::memory::MemoryTag::RemotePlayers, total);
+}
+
 void GlobedGJBGL::pausedUpdate(float dt) {
     // unpause dash effects and death effects
     for (auto* child : CCArrayExt<CCNode*>(m_objectLayer->getChildren())) {
@@ -1058,64 +1788,35 @@ void GlobedGJBGL::pausedUpdate(float dt) {
     }
 }
 
-bool GlobedGJBGL::accountForSpeedhack(int uniqueKey, float cap, float allowance) {
-    auto* sched = CCScheduler::get();
-    auto ts = sched->getTimeScale();
-    if (!util::math::equal(ts, m_fields->lastKnownTimeScale)) {
-        this->unscheduleSelectors();
-        this->rescheduleSelectors();
-    }
+void GlobedGJBGL::setupPeriodicTasks() {
+    // the player data rate is set by `updateSendRate`
+    auto& timers = m_fields->timers;
+    timers.setInterval(PeriodicTask::SendLinkedData, 1.0 / LINKED_TPS);
+    timers.setInterval(PeriodicTask::SendPlayerMetadata, METADATA_CHECK_INTERVAL);
+    timers.setInterval(PeriodicTask::PeriodicalUpdate, PERIODICAL_UPDATE_INTERVAL);
+    timers.setInterval(PeriodicTask::UpdateEstimators, ESTIMATOR_UPDATE_INTERVAL);
+    timers.setInterval(PeriodicTask::UpdateDRPC, DRPC_CHECK_INTERVAL);
+}
 
-    auto now = util::time::now();
+/* Collision stuff */
 
-    if (!m_fields->lastSentPacket.contains(uniqueKey)) {
-        m_fields->lastSentPacket.emplace(uniqueKey, now);
-        return true;
-    }
+void GlobedGJBGL::rebuildCollisionGrid() {
+    auto& grid = m_fields->collisionGrid;
+    grid.clear();
 
-    auto lastSent = m_fields->lastSentPacket.at(uniqueKey);
+    if (!m_fields->roomSettings.flags.collision) return;
 
-    auto passed = util::time::asMillis(now - lastSent);
+    for (auto* rp : m_fields->slotPlayers) {
+        // builders and hidden players aren't shown, and have no up to date position to collide at
+        if (rp->lastVisualState.isEditorBuilding || rp->isHidden()) continue;
 
-    if (passed < cap * 1000 * allowance) {
-        // log::warn("dropping a packet (speedhack?), passed time is {}ms", passed);
-        return false;
+        grid.insert(rp->player1->getPlayerPosition(), rp->player1);
+        grid.insert(rp->player2->getPlayerPosition(), rp->player2);
     }
 
-    m_fields->lastSentPacket[uniqueKey] = now;
-
-    return true;
-}
-
-void GlobedGJBGL::unscheduleSelectors() {
-    auto* sched = CCScheduler::get();
-    sched->unscheduleSelector(schedule_selector(GlobedGJBGL::selSendPlayerData), this->getParent());
-    sched->unscheduleSelector(schedule_selector(GlobedGJBGL::selSendPlayerMetadata), this->getParent());
-    sched->unscheduleSelector(schedule_selector(GlobedGJBGL::selPeriodicalUpdate), this->getParent());
-    sched->unscheduleSelector(schedule_selector(GlobedGJBGL::selUpdateEstimators), this->getParent());
-    sched->unscheduleSelector(schedule_selector(GlobedGJBGL::selUpdateDRPC), this->getParent());
-}
-
-void GlobedGJBGL::rescheduleSelectors() {
-    auto* sched = CCScheduler::get();
-    float timescale = sched->getTimeScale();
-    m_fields->lastKnownTimeScale = timescale;
-
-    float pdInterval = (1.0f / m_fields->configuredTps) * timescale;
-    float pmdInterval = 10.f * timescale;
-    float updpInterval = 0.25f * timescale;
-    float updeInterval = (1.0f / 30.f) * timescale;
-    float drpcInterval = 10.f * timescale;
-
-    this->getParent()->schedule(schedule_selector(GlobedGJBGL::selSendPlayerData), pdInterval);
-    this->getParent()->schedule(schedule_selector(GlobedGJBGL::selSendPlayerMetadata), pmdInterval);
-    this->getParent()->schedule(schedule_selector(GlobedGJBGL::selPeriodicalUpdate), updpInterval);
-    this->getParent()->schedule(schedule_selector(GlobedGJBGL::selUpdateEstimators), updeInterval);
-    this->getParent()->schedule(schedule_selector(GlobedGJBGL::selUpdateDRPC), drpcInterval);
+    grid.finish();
 }
 
-/* Collision stuff */
-
 static bool shouldCorrectCollision(const CCRect& p1, const CCRect& p2, CCPoint& displacement) {
     if (std::abs(displacement.x) > 10.f) {
         displacement.x = -displacement.x;
@@ -1140,73 +1841,36 @@ int GlobedGJBGL::checkCollisions(PlayerObject* player, float dt, bool p2) {
 
     bool isSecond = player == gpl->m_player2;
 
-    for (const auto& [_, rp] : gpl->m_fields->players) {
-        auto* p1 = static_cast<PlayerObject*>(rp->player1->getPlayerObject());
-        auto* p2 = static_cast<PlayerObject*>(rp->player2->getPlayerObject());
+    // only the players that were stuck to us on the last check need their sticky state reset
+    auto& sticky = isSecond ? gpl->m_fields->stickyP2 : gpl->m_fields->stickyP1;
+    for (auto* vp : sticky) {
+        isSecond ? vp->setP2StickyState(false) : vp->setP1StickyState(false);
+    }
 
-        auto& p1Rect = p1->getObjectRect();
-        auto& p2Rect = p2->getObjectRect();
+    sticky.clear();
 
+    gpl->m_fields->collisionGrid.query(player->getObjectRect(), [&](ComplexVisualPlayer* vp) {
+        auto* obj = static_cast<PlayerObject*>(vp->getPlayerObject());
+        auto& objRect = obj->getObjectRect();
         auto& playerRect = player->getObjectRect();
 
-        CCRect p1CollRect = p1Rect;
-        CCRect p2CollRect = p2Rect;
+        if (!playerRect.intersectsRect(objRect)) return;
 
-        constexpr float padding = 2.f;
+        auto prev = player->getPosition();
+        player->collidedWithObject(dt, obj, objRect, false);
+        auto displacement = player->getPosition() - prev;
 
-        // p1CollRect.origin += CCPoint{padding, padding};
-        // p1CollRect.size -= CCSize{padding * 2, padding * 2};
+        bool shouldRevert = shouldCorrectCollision(playerRect, objRect, displacement);
 
-        // p2CollRect.origin += CCPoint{padding, padding};
-        // p2CollRect.size -= CCSize{padding * 2, padding * 2};
-
-        bool intersectsP1 = playerRect.intersectsRect(p1CollRect);
-        bool intersectsP2 = playerRect.intersectsRect(p2CollRect);
-
-        if (isSecond) {
-            rp->player1->setP2StickyState(false);
-            rp->player2->setP2StickyState(false);
-        } else {
-            rp->player1->setP1StickyState(false);
-            rp->player2->setP1StickyState(false);
-        }
-
-        if (intersectsP1) {
-            auto prev = player->getPosition();
-            player->collidedWithObject(dt, p1, p1CollRect, false);
-            auto displacement = player->getPosition() - prev;
-
-            // log::debug("p1 intersect, displacement: {}", displacement);
-
-            bool shouldRevert = shouldCorrectCollision(playerRect, p1Rect, displacement);
-
-            if (shouldRevert) {
-                player->setPosition(player->getPosition() + displacement);
-            }
-
-            if (std::abs(displacement.y) > 0.001f) {
-                isSecond ? rp->player1->setP2StickyState(true) : rp->player1->setP1StickyState(true);
-            }
+        if (shouldRevert) {
+            player->setPosition(player->getPosition() + displacement);
         }
 
-        if (intersectsP2) {
-            auto prev = player->getPosition();
-            player->collidedWithObject(dt, p2, p2CollRect, false);
-            auto displacement = player->getPosition() - prev;
-
-            // log::debug("p2 intersect, displacement: {}", displacement);
-
-            bool shouldRevert = shouldCorrectCollision(playerRect, p2Rect, displacement);
-
-            if (shouldRevert) {
-                player->setPosition(player->getPosition() + displacement);
-            }
-
-            if (std::abs(displacement.y) > 0.001f) {
-                isSecond ? rp->player2->setP2StickyState(true) : rp->player2->setP1StickyState(true);
-            }
+        if (std::abs(displacement.y) > 0.001f) {
+            isSecond ? vp->setP2StickyState(true) : vp->setP1StickyState(true);
+            sticky.push_back(vp);
         }
-    }
+    });
 
     return retval;
 }
@@ -1236,6 +1900,10 @@ void GlobedGJBGL::loadLevelSettings() {
 /* 2-player mode stuff */
 
 class $modify(TwoPModePlayerObject, PlayerObject) {
+    static void onModify(auto& self) {
+        globed::deferLevelHooks(self, {"PlayerObject::update"});
+    }
+
     struct Fields {
         Ref<ComplexVisualPlayer> lockedTo;
     };
@@ -1321,4 +1989,11 @@ void GlobedGJBGL::linkPlayerTo(int accountId) {
     pobj->setLockedTo(m_fields->twopstate.isPrimary ? rp->player2 : rp->player1);
 
     m_fields->twopstate.active = true;
+
+    // this only sets up our half of the link, the server forwards our stream to them. theirs reaches us once they link to us too
+    auto& nm = NetworkManager::get();
+    if (nm.serverMatchesProtocol()) {
+        m_fields->twopstate.linkedId = accountId;
+        nm.send(LinkPlayerPacket(accountId));
+    }
 }
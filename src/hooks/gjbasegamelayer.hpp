@@ -4,10 +4,17 @@
 #include <Geode/modify/GJBaseGameLayer.hpp>
 #include "Geode/loader/Dispatch.hpp"
 
+#include <audio/spatializer.hpp>
 #include <data/types/room.hpp>
+#include <game/chat_history.hpp>
+#include <game/collision_grid.hpp>
 #include <game/interpolator.hpp>
 #include <game/player_store.hpp>
+#include <game/scenario_bench.hpp>
+#include <game/session_recorder.hpp>
+#include <hooks/level_hooks.hpp>
 #include <net/manager.hpp>
+#include <ui/game/player/name_batch.hpp>
 #include <ui/game/player/remote_player.hpp>
 #include <ui/game/overlay/overlay.hpp>
 #include <ui/game/progress/progress_icon.hpp>
@@ -15,43 +22,117 @@
 #include <ui/game/voice_overlay/overlay.hpp>
 #include <util/time.hpp>
 
+class AudioStream;
+
 float adjustLerpTimeDelta(float dt);
 
+// Periodic work in a level, all of it runs from `selUpdate` off `GlobedGJBGL::Fields::timeCounter`
+enum class PeriodicTask : uint8_t {
+    SendPlayerData,
+    SendLinkedData,
+    SendPlayerMetadata,
+    PeriodicalUpdate,
+    UpdateEstimators,
+    UpdateDRPC,
+    Count,
+};
+
 class $modify(GlobedGJBGL, GJBaseGameLayer) {
+    static void onModify(auto& self) {
+        globed::deferLevelHooks(self, {"GJBaseGameLayer::checkCollisions", "GJBaseGameLayer::updateCamera"});
+    }
+
     struct Fields {
         // setup stuff
         bool globedReady = false;
         bool setupWasCompleted = false;
+        bool prefetched = false; // the level was joined from the level page already, see `LevelPrefetchManager`
         uint32_t configuredTps = 0;
+        uint32_t levelTps = 0; // from `LevelTpsPacket`, lowers the send rate on crowded levels. 0 until the server sends it
 
         // in game stuff
         bool deafened = false;
         bool isVoiceProximity = false;
+#ifdef GLOBED_VOICE_SUPPORT
+        VoiceSpatializer spatializer; // proximity volumes queued during selUpdate, applied at the end of it
+#endif
         uint32_t totalSentPackets = 0;
-        float timeCounter = 0.f;
-        float lastServerUpdate = 0.f;
+        double timeCounter = 0.0; // `NetworkManager::serverTime` as of the current frame
+        util::time::FixedTimestepTable<PeriodicTask> timers;
+        double lastServerUpdate = 0.0;
+        // dense slot of every remote player, shared by the interpolator and `slotPlayers` so per-frame updates are a linear pass
+        PlayerSlots playerSlots;
+        std::vector<RemotePlayer*> slotPlayers;
         std::unique_ptr<PlayerInterpolator> interpolator;
+        // ghosts played back from a session recording, see `SessionRecorder`
+        std::unique_ptr<SessionPlayback> sessionPlayback;
+        double playbackStart = -1.0; // `timeCounter` when the playback started, negative until the first frame
+        // synthetic players for measuring performance, see `ScenarioBenchmark`
+        std::unique_ptr<ScenarioBenchmark> scenarioBench;
+
+        // player collision, the grid is rebuilt every frame from the interpolated positions
+        CollisionGrid collisionGrid;
+        std::vector<ComplexVisualPlayer*> stickyP1, stickyP2;
         std::unique_ptr<PlayerStore> playerStore;
         RoomSettings roomSettings;
         struct TwoPlayerModeState {
             bool active = false; // true when two player mode is enabled and linked to a player
             bool isPrimary = false;
+            int linkedId = 0; // account id of the player we are linked to
             Ref<PlayerObject> linked;
         } twopstate;
         bool progressForciblyDisabled = false; // affected by room settings, forces safe mode
         bool forcedPlatformer = false;
+        std::optional<PlayerIconTypeMask> levelIconTypes; // see `getLevelIconTypes`
         bool shouldStopProgress = false;
         bool quitting = false;
         GameCameraState camState;
 
-        std::optional<SpiderTeleportData> spiderTp1, spiderTp2;
-        bool didJustJumpp1 = false, didJustJumpp2 = false;
+        // jumps, deaths and spider teleports that are still being repeated in sent player data, oldest first
+        struct OutgoingEvent {
+            PlayerEvent event;
+            double firstSent = -1.0; // `timeCounter` of the first frame it was sent with, negative if not sent yet
+            uint32_t sends = 0;
+        };
+        std::vector<OutgoingEvent> outgoingEvents;
+        uint16_t eventSequence = 0;
         bool isCurrentlyDead = false;
-        float lastDeathTimestamp = 0.f;
+
+        // delta encoding of sent player data
+        std::optional<PlayerData> lastKeyframe;
+        uint8_t keyframeId = 0;
+        uint32_t sentSinceKeyframe = 0;
+
+        // metadata is only sent when it changes
+        std::optional<PlayerMetadata> lastSentMetadata;
+
+        // adaptive send rate
+        std::optional<PlayerData> lastSentData;
+        uint32_t skippedSends = 0;
+        bool congested = false; // updated in selPeriodicalUpdate
+        size_t remotePlaytesters = 0; // remote players that aren't building in the editor, counted every frame in selUpdate
+
+        // non-critical work pushed to later frames by the frame budget, see `util::debug::MainThreadTimer::tryRun`
+        uint8_t profileDeferrals = 0;
+        uint8_t estimatorDeferrals = 0;
+        uint8_t drpcDeferrals = 0;
+        float deferredEstimatorDt = 0.f;
+        bool drpcPending = false;
+
+        // what the discord presence shows, only sent again when it changes, see `updateDRPC`
+        struct DiscordPresence {
+            int levelId = 0;
+            size_t playerCount = 0;
+
+            bool operator==(const DiscordPresence&) const = default;
+        };
+        std::optional<DiscordPresence> sentPresence;
+        util::time::time_point lastPresenceUpdate;
 
         // ui elements
         GlobedOverlay* overlay = nullptr;
         std::unordered_map<int, RemotePlayer*> players;
+        std::vector<Ref<RemotePlayer>> playerPool; // players that left, reused by `handlePlayerJoin`
         Ref<PlayerProgressIcon> selfProgressIcon = nullptr;
         Ref<CCNode> progressBarWrapper = nullptr;
         Ref<PlayerStatusIcons> selfStatusIcons = nullptr;
@@ -59,13 +140,14 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
         //Ref<GlobedChatOverlay> chatOverlay = nullptr;
         Ref<GlobedNameLabel> ownNameLabel = nullptr;
         Ref<GlobedNameLabel> ownNameLabel2 = nullptr;
-
-        // speedhack detection
-        float lastKnownTimeScale = 1.0f;
-        std::unordered_map<int, util::time::time_point> lastSentPacket;
-
-        // chat messages (duh)
-        std::vector<std::pair<int, std::string>> chatMessages;
+        // follow our icons without rotating with them, `selfStatusIcons` and `ownNameLabel` sit on the first one
+        Ref<CCNode> ownLabelAnchor = nullptr;
+        Ref<CCNode> ownLabelAnchor2 = nullptr;
+        CrowdRenderer* crowdRenderer = nullptr;
+        NameLabelBatch* nameBatch = nullptr;
+
+        // chat messages (duh), bounded
+        ChatHistory chatHistory;
     };
 
     $override
@@ -95,6 +177,7 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
 
     void setupBare();
     void setupDeferredAssetPreloading();
+    void prewarmPlayerPool();
     void setupAudio();
     void setupCustomKeybinds();
     void setupMisc();
@@ -107,19 +190,23 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
 
     /* selectors */
 
-    // selSendPlayerData - runs tps (default 30) times per second
+    // selSendPlayerData - runs tps (default 30) times per second, see `PeriodicTask::SendPlayerData`
     void selSendPlayerData(float);
 
-    // selSendPlayerMetadata - runs every 5 seconds
+    // selSendLinkedData - runs `LINKED_TPS` times per second while linked in two player mode, sends our data only to the linked player
+    void selSendLinkedData(float);
+
+    // selSendPlayerMetadata - runs every second, sends the metadata if it changed
     void selSendPlayerMetadata(float);
 
     // selPeriodicalUpdate - runs 4 times a second, does various stuff
     void selPeriodicalUpdate(float);
 
-    // selUpdate - runs every frame, increments the non-decreasing time counter, interpolates and updates players
+    // selUpdate - runs every frame, increments the non-decreasing time counter, runs the periodic tasks that are due,
+    // interpolates and updates players
     void selUpdate(float dt);
 
-    // setlUpdateEstimators - runs 30 times a second, updates volume estimators
+    // selUpdateEstimators - runs 30 times a second, updates volume estimators
     void selUpdateEstimators(float);
 
     /* player related functions */
@@ -128,11 +215,46 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
     PlayerData gatherPlayerData();
     PlayerMetadata gatherPlayerMetadata();
 
+    // Queues an event to go out with the next player data, and be repeated in the frames after it
+    void queuePlayerEvent(PlayerEventType type, bool player2, SpiderTeleportData teleport = {});
+    // Puts the queued events into a frame that is about to be sent, and forgets the ones that were repeated enough
+    void attachPlayerEvents(PlayerData& data);
+
     bool shouldLetMessageThrough(int playerId);
     void updateProximityVolume(int playerId);
+    void updateProximityVolume(int playerId, const VisualPlayerState& vstate, AudioStream* stream);
+    // applies the volumes queued by `updateProximityVolume`, in one batch
+    void applyProximityVolumes();
+#ifdef GLOBED_VOICE_SUPPORT
+    // plays a voice frame from `VoiceBroadcastPacket` or `VoiceBundlePacket`, unless the sender shouldn't be heard
+    void handleVoiceFrame(int sender, EncodedAudioFrame&& frame);
+#endif
+    // whether the player is close enough to be heard with proximity voice, frames from everyone else aren't decoded
+    bool isVoiceAudible(int playerId);
+    // tells the server our proximity range, so it doesn't forward voice we wouldn't hear
+    void sendVoiceProximity();
+
+    // Requests the profiles of exactly these players, in as few packets as possible
+    void requestProfiles(std::vector<int>&& ids);
 
     void handlePlayerJoin(int playerId);
+    void handleLevelData(const std::vector<AssociatedPlayerData>& players);
+    // A frame from the stream of the player linked to us, fed into the same interpolator as level data
+    void handleLinkedData(int playerId, const PlayerData& data);
     void handlePlayerLeave(int playerId);
+    // Feeds the frames of the session playback that are due into `handleLevelData`, as if they were just received
+    void updateSessionPlayback();
+    // Runs the next step of the scenario benchmark and writes its report once all stages are done
+    void updateScenarioBench();
+
+    // Decides if the player data should be sent this tick. Idle players and congested connections send less often,
+    // builders in the editor only send their status once in a while unless someone is playtesting,
+    // while any change that can't be interpolated (death, jump, gamemode change, etc.) is sent immediately.
+    bool shouldSendPlayerData(const PlayerData& data);
+
+    // Picks the send rate from the server tps, the `tpsCap` setting and the battery saver, and applies it if it changed.
+    // Also limits voice decoding while saving power.
+    void updateSendRate();
 
     /* misc */
 
@@ -141,27 +263,28 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
     bool isPaused(bool checkCurrent = true);
     bool isEditor();
 
+    // Gamemodes that the level has portals for, plus the cube. Remote players load these icons up front,
+    // anything else only once someone actually switches to it. Scans the level objects on the first call.
+    PlayerIconTypeMask getLevelIconTypes();
+
     bool isSafeMode();
     void toggleSafeMode(bool enabled);
 
     void onQuitActions();
 
+    // Remote player node trees change whenever icons do, so instead of being counted they are measured here for `MemoryTracker`
+    void measureMemoryUsage();
+
     void linkPlayerTo(int accountId);
 
     // runs every frame while paused
     void pausedUpdate(float dt);
 
-    // With speedhack enabled, all scheduled selectors will run more often than they are supposed to.
-    // This means, if you turn up speedhack to let's say 100x, you will send 3000 packets per second. That is a big no-no.
-    // For naive speedhack implementations, we simply check CCScheduler::getTimeScale and properly reschedule our data sender.
-    //
-    // For non-naive speedhacks however, ones that don't use CCScheduler::setTimeScale, it is more complicated.
-    // We record the time of sending each packet and compare the intervals. If the interval is suspiciously small, we reject the packet.
-    // This does result in less smooth experience with non-naive speedhacks however.
-    bool accountForSpeedhack(int uniqueKey, float cap, float allowance = 0.9f);
-
-    void unscheduleSelectors();
-    void rescheduleSelectors();
+    void rebuildCollisionGrid();
+
+    // Sets the intervals of the periodic tasks. They run off the server clock, so unlike cocos selectors
+    // they don't run more often with speedhack or a changed timescale.
+    void setupPeriodicTasks();
 
     /* Discord RPC */
     void updateDRPC();
@@ -48,20 +48,24 @@ bool HookedLevelAreaInnerLayer::init(bool p0) {
         m_fields->doorNodes[id] = wrapper;
     }
 
-    nm.addListener<LevelPlayerCountPacket>(this, [this](auto packet) {
+    nm.addListener<LevelPlayerCountPacket>(this, [this](auto& packet) {
         auto currentLayer = getChildOfType<LevelAreaInnerLayer>(CCScene::get(), 0);
         if (currentLayer && this != currentLayer) return;
 
-        m_fields->levels.clear();
-        for (const auto& level : packet->levels) {
+        // pushed updates only contain the levels that changed
+        for (const auto& level : packet.levels) {
             m_fields->levels[level.first] = level.second;
         }
 
         this->updatePlayerCounts();
     });
 
-    this->schedule(schedule_selector(HookedLevelAreaInnerLayer::sendRequest), 5.f);
-    this->sendRequest(0.f);
+    if (nm.serverMatchesProtocol()) {
+        m_fields->countSubscription.set(std::vector<LevelId>(TOWER_LEVELS.begin(), TOWER_LEVELS.end()));
+    } else {
+        this->schedule(schedule_selector(HookedLevelAreaInnerLayer::sendRequest), 5.f);
+        this->sendRequest(0.f);
+    }
 
     return true;
 }
@@ -4,12 +4,14 @@
 #include <Geode/modify/LevelAreaInnerLayer.hpp>
 
 #include <data/types/gd.hpp>
+#include <managers/player_count.hpp>
 
 class $modify(HookedLevelAreaInnerLayer, LevelAreaInnerLayer) {
     static inline const auto TOWER_LEVELS = std::to_array<LevelId>({5001, 5002, 5003, 5004});
 
     struct Fields {
         std::unordered_map<int, uint16_t> levels;
+        PlayerCountManager::Subscription countSubscription;
         std::unordered_map<int, Ref<cocos2d::CCNode>> doorNodes;
     };
 
@@ -28,15 +28,22 @@ void HookedLevelBrowserLayer::setupLevelBrowser(cocos2d::CCArray* p0) {
         }
     }
 
-    nm.send(RequestPlayerCountPacket::create(std::move(levelIds)));
-    nm.addListener<LevelPlayerCountPacket>(this, [this](std::shared_ptr<LevelPlayerCountPacket> packet) {
-        for (const auto& [levelId, playerCount] : packet->levels) {
+    nm.addListener<LevelPlayerCountPacket>(this, [this](LevelPlayerCountPacket& packet) {
+        for (const auto& [levelId, playerCount] : packet.levels) {
             m_fields->levels[levelId] = playerCount;
         }
 
-        this->refreshPagePlayerCounts();
+        this->queuePlayerCountRefresh();
     });
 
+    // the server pushes counts of the subscribed levels when they change, older servers have to be polled
+    if (nm.serverMatchesProtocol()) {
+        m_fields->countSubscription.set(std::move(levelIds));
+        return;
+    }
+
+    nm.send(RequestPlayerCountPacket::create(std::move(levelIds)));
+
     this->schedule(schedule_selector(HookedLevelBrowserLayer::updatePlayerCounts), 5.0f);
 }
 
@@ -60,6 +67,18 @@ void HookedLevelBrowserLayer::refreshPagePlayerCounts() {
     }
 }
 
+void HookedLevelBrowserLayer::queuePlayerCountRefresh() {
+    if (m_fields->refreshQueued) return;
+
+    m_fields->refreshQueued = true;
+    this->scheduleOnce(schedule_selector(HookedLevelBrowserLayer::selRefreshPagePlayerCounts), 0.f);
+}
+
+void HookedLevelBrowserLayer::selRefreshPagePlayerCounts(float) {
+    m_fields->refreshQueued = false;
+    this->refreshPagePlayerCounts();
+}
+
 void HookedLevelBrowserLayer::updatePlayerCounts(float) {
     auto& nm = NetworkManager::get();
     if (nm.established() && m_list->m_listView) {
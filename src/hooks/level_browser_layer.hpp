@@ -4,16 +4,22 @@
 #include <Geode/modify/LevelBrowserLayer.hpp>
 
 #include <data/types/gd.hpp>
+#include <managers/player_count.hpp>
 
 class $modify(HookedLevelBrowserLayer, LevelBrowserLayer) {
     struct Fields {
         std::unordered_map<LevelId, uint16_t> levels;
+        PlayerCountManager::Subscription countSubscription;
+        bool refreshQueued = false;
     };
 
     $override
     void setupLevelBrowser(cocos2d::CCArray* p0);
 
     void refreshPagePlayerCounts();
+    // Refreshes the cells once at the end of the frame, no matter how many count packets arrive before that
+    void queuePlayerCountRefresh();
+    void selRefreshPagePlayerCounts(float);
     void updatePlayerCounts(float);
 
     constexpr bool isValidLevelType(GJLevelType level) {
@@ -49,6 +49,10 @@ void GlobedLevelCell::updatePlayerCount(int count, bool inLists) {
         }
     }
 
+    // setString rebuilds every glyph of the label, most refreshes don't change anything
+    if (m_fields->shownCount == count) return;
+    m_fields->shownCount = count;
+
     if (count == 0) {
         m_fields->playerCountLabel->setVisible(false);
         m_fields->playerCountIcon->setVisible(false);
@@ -61,6 +65,5 @@ void GlobedLevelCell::updatePlayerCount(int count, bool inLists) {
         } else {
             m_fields->playerCountLabel->setString(fmt::format("{} {}", count, count == 1 ? "player" : "players").c_str());
         }
-       
     }
 }
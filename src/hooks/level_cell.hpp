@@ -7,7 +7,9 @@ class $modify(GlobedLevelCell, LevelCell) {
     struct Fields {
         cocos2d::CCLabelBMFont* playerCountLabel = nullptr;
         cocos2d::CCSprite* playerCountIcon = nullptr;
+        std::optional<int> shownCount; // what the label shows right now, so unchanged counts don't rebuild it
     };
 
+    // Does nothing if `count` is already shown
     void updatePlayerCount(int count, bool inLists = false);
 };
@@ -0,0 +1,37 @@
+#include "level_hooks.hpp"
+
+using namespace geode::prelude;
+
+namespace globed {
+    static std::vector<Hook*>& levelHooks() {
+        static std::vector<Hook*> hooks;
+        return hooks;
+    }
+
+    static bool levelHooksEnabled = false;
+    static GJBaseGameLayer* levelHooksOwner = nullptr;
+
+    void registerLevelHook(Hook* hook) {
+        levelHooks().push_back(hook);
+    }
+
+    void setLevelHooksEnabled(GJBaseGameLayer* level, bool state) {
+        levelHooksOwner = level;
+
+        if (levelHooksEnabled == state) return;
+        levelHooksEnabled = state;
+
+        for (auto* hook : levelHooks()) {
+            auto res = state ? hook->enable() : hook->disable();
+            if (!res) {
+                log::warn("Failed to {} hook {}: {}", state ? "enable" : "disable", hook->getDisplayName(), res.unwrapErr());
+            }
+        }
+    }
+
+    void releaseLevelHooks(GJBaseGameLayer* level) {
+        if (level != levelHooksOwner) return;
+
+        setLevelHooksEnabled(nullptr, false);
+    }
+}
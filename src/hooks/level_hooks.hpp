@@ -0,0 +1,30 @@
+#pragma once
+#include <defs/geode.hpp>
+
+// Hooks that run every frame, or for every player object, but only do anything while connected and in a level.
+// They start out disabled and are only enabled by `GlobedGJBGL` for levels that globed is active in,
+// so playing offline calls straight into the vanilla functions.
+namespace globed {
+    void registerLevelHook(geode::Hook* hook);
+
+    // Called by a level when it sets up, enables or disables the hooks for it
+    void setLevelHooksEnabled(GJBaseGameLayer* level, bool state);
+    // Called by a level when it's exited, disables the hooks unless a newer level already took over.
+    // Levels can overlap, for example the editor is only exited after the level started from it sets up.
+    void releaseLevelHooks(GJBaseGameLayer* level);
+
+    // Call from `onModify` with the names of the hooks to register
+    template <typename Self>
+    void deferLevelHooks(Self& self, std::initializer_list<const char*> names) {
+        for (const char* name : names) {
+            auto hook = self.getHook(name);
+            if (!hook) {
+                geode::log::warn("Failed to find level hook {}: {}", name, hook.unwrapErr());
+                continue;
+            }
+
+            hook.unwrap()->setAutoEnable(false);
+            registerLevelHook(hook.unwrap());
+        }
+    }
+}
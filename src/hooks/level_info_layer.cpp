@@ -1,4 +1,6 @@
 #include "level_info_layer.hpp"
+#include "gjgamelevel.hpp"
+#include <managers/level_prefetch.hpp>
 #include <net/manager.hpp>
 
 using namespace geode::prelude;
@@ -20,6 +22,9 @@ void HookedLevelInfoLayer::onPlay(CCObject* s) {
         return;
     }
 
+    // join while the level is loading, so everyone is already there on the first frame
+    LevelPrefetchManager::get().prefetch(HookedGJGameLevel::getLevelIDFrom(m_level));
+
     LevelInfoLayer::onPlay(s);
 }
 
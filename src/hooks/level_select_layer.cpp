@@ -35,7 +35,11 @@ public:
         return true;
     }
 
+    // Does nothing if `players` is already shown
     void updateCount(size_t players) {
+        if (shownCount == players) return;
+        shownCount = players;
+
         if (players == 0) {
             this->setVisible(false);
             return;
@@ -57,6 +61,12 @@ public:
         // this->setContentSize(label->getScaledContentSize());
     }
 
+    // the next `updateCount` has to show the label again, whatever the count is
+    void hide() {
+        this->setVisible(false);
+        shownCount.reset();
+    }
+
     static PlayerCountLabel* create(bool compressed) {
         auto ret = new PlayerCountLabel;
         if (ret->init(compressed)) {
@@ -72,6 +82,7 @@ private:
     CCSprite* icon = nullptr;
     CCLabelBMFont* label = nullptr;
     bool compressed;
+    std::optional<size_t> shownCount;
 };
 
 bool HookedLevelSelectLayer::init(int p0) {
@@ -80,20 +91,24 @@ bool HookedLevelSelectLayer::init(int p0) {
     auto& nm = NetworkManager::get();
     if (!nm.established()) return true;
 
-    nm.addListener<LevelPlayerCountPacket>(this, [this](auto packet) {
+    nm.addListener<LevelPlayerCountPacket>(this, [this](auto& packet) {
         auto currentLayer = getChildOfType<LevelSelectLayer>(CCScene::get(), 0);
         if (currentLayer && this != currentLayer) return;
 
-        m_fields->levels.clear();
-        for (const auto& level : packet->levels) {
+        // pushed updates only contain the levels that changed
+        for (const auto& level : packet.levels) {
             m_fields->levels[level.first] = level.second;
         }
 
-        this->updatePlayerCounts();
+        this->queuePlayerCountRefresh();
     });
 
-    this->schedule(schedule_selector(HookedLevelSelectLayer::sendRequest), 5.f);
-    this->sendRequest(0.f);
+    if (nm.serverMatchesProtocol()) {
+        m_fields->countSubscription.set(std::vector<LevelId>(MAIN_LEVELS.begin(), MAIN_LEVELS.end()));
+    } else {
+        this->schedule(schedule_selector(HookedLevelSelectLayer::sendRequest), 5.f);
+        this->sendRequest(0.f);
+    }
 
     return true;
 }
@@ -104,6 +119,18 @@ void HookedLevelSelectLayer::sendRequest(float) {
     }
 }
 
+void HookedLevelSelectLayer::queuePlayerCountRefresh() {
+    if (m_fields->refreshQueued) return;
+
+    m_fields->refreshQueued = true;
+    this->scheduleOnce(schedule_selector(HookedLevelSelectLayer::selUpdatePlayerCounts), 0.f);
+}
+
+void HookedLevelSelectLayer::selUpdatePlayerCounts(float) {
+    m_fields->refreshQueued = false;
+    this->updatePlayerCounts();
+}
+
 void HookedLevelSelectLayer::updatePlayerCounts() {
     auto* bsl = getChildOfType<BoomScrollLayer>(this, 0);
     if (!bsl) return;
@@ -117,7 +144,7 @@ void HookedLevelSelectLayer::updatePlayerCounts() {
 
         LevelId levelId = HookedGJGameLevel::getLevelIDFrom(page->m_level);
         if (levelId < 0) {
-            if (label) label->setVisible(false);
+            if (label) label->hide();
             continue;
         }
 
@@ -133,7 +160,7 @@ void HookedLevelSelectLayer::updatePlayerCounts() {
         }
 
         if (!NetworkManager::get().established()) {
-            label->setVisible(false);
+            label->hide();
         } else if (m_fields->levels.contains(levelId)) {
             auto players = m_fields->levels[levelId];
             label->updateCount(players);
@@ -4,12 +4,15 @@
 #include <Geode/modify/LevelSelectLayer.hpp>
 
 #include <data/types/gd.hpp>
+#include <managers/player_count.hpp>
 
 class $modify(HookedLevelSelectLayer, LevelSelectLayer) {
     static inline const auto MAIN_LEVELS = std::to_array<LevelId>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22});
 
     struct Fields {
         std::unordered_map<int, uint16_t> levels;
+        PlayerCountManager::Subscription countSubscription;
+        bool refreshQueued = false;
     };
 
     $override
@@ -20,4 +23,7 @@ class $modify(HookedLevelSelectLayer, LevelSelectLayer) {
 
     void sendRequest(float);
     void updatePlayerCounts();
+    // Updates the labels once at the end of the frame, no matter how many count packets arrive before that
+    void queuePlayerCountRefresh();
+    void selUpdatePlayerCounts(float);
 };
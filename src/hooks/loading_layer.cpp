@@ -1,6 +1,7 @@
 #include "loading_layer.hpp"
 
 #include "game_manager.hpp"
+#include <managers/startup.hpp>
 #include <util/format.hpp>
 #include <util/time.hpp>
 #include <util/cocos.hpp>
@@ -9,6 +10,9 @@
 
 using namespace geode::prelude;
 
+// main thread time spent creating textures per frame, the rest of the frame is left for drawing the loading screen
+constexpr auto PRELOAD_FRAME_BUDGET = util::time::millis(4);
+
 static void loadingFinishedReimpl(bool fromRefresh) {
     // reimplementation of the function
     auto* scene = MenuLayer::scene(fromRefresh);
@@ -28,6 +32,9 @@ void HookedLoadingLayer::loadingFinishedHook() {
 
         m_fields->preloadingStage++;
 
+        // get the network requests going, so they finish while the assets are being preloaded
+        StartupManager::get().begin();
+
         auto* gm = GameManager::get();
         auto* hgm = static_cast<HookedGameManager*>(gm);
 
@@ -45,7 +52,6 @@ void HookedLoadingLayer::loadingFinishedHook() {
         return;
     } else if (m_fields->preloadingStage == 1000) {
         log::info("Asset preloading finished in {}.", util::format::formatDuration(util::time::systemNow() - m_fields->loadingStartedTime));
-        util::cocos::cleanupThreadPool();
         loadingFinishedReimpl(m_fromRefresh);
     }
 }
@@ -84,25 +90,24 @@ void HookedLoadingLayer::preloadingStage1(float) {
 
 void HookedLoadingLayer::preloadingStage2(float) {
     using util::cocos::AssetPreloadStage;
-    using util::cocos::preloadAssets;
 
     auto& settings = GlobedSettings::get();
+    std::optional<AssetPreloadStage> stage;
 
     switch (m_fields->preloadingStage) {
         // death effects
         case 1: {
             // only preload them if they are enabled, they take like half the loading time
             if (settings.players.deathEffects && !settings.players.defaultDeathEffect) {
-                preloadAssets(AssetPreloadStage::DeathEffect);
-                static_cast<HookedGameManager*>(GameManager::get())->setDeathEffectsPreloaded(true);
+                stage = AssetPreloadStage::DeathEffect;
             }
         } break;
-        case 2: preloadAssets(AssetPreloadStage::Cube); break;
-        case 3: preloadAssets(AssetPreloadStage::Ship); break;
-        case 4: preloadAssets(AssetPreloadStage::Ball); break;
-        case 5: preloadAssets(AssetPreloadStage::Ufo); break;
-        case 6: preloadAssets(AssetPreloadStage::Wave); break;
-        case 7: preloadAssets(AssetPreloadStage::Other); break;
+        case 2: stage = AssetPreloadStage::Cube; break;
+        case 3: stage = AssetPreloadStage::Ship; break;
+        case 4: stage = AssetPreloadStage::Ball; break;
+        case 5: stage = AssetPreloadStage::Ufo; break;
+        case 6: stage = AssetPreloadStage::Wave; break;
+        case 7: stage = AssetPreloadStage::Other; break;
         case 8: {
             static_cast<HookedGameManager*>(GameManager::get())->setAssetsPreloaded(true);
             this->finishLoading();
@@ -110,6 +115,30 @@ void HookedLoadingLayer::preloadingStage2(float) {
         }
     };
 
+    if (!stage) {
+        this->nextPreloadingStage();
+        return;
+    }
+
+    // the job is polled every frame, so the loading screen keeps drawing while the pool decodes
+    m_fields->preloadJob = std::make_unique<util::cocos::AssetPreloadJob>(*stage);
+    this->schedule(schedule_selector(HookedLoadingLayer::preloadingTick), 0.f);
+}
+
+void HookedLoadingLayer::preloadingTick(float) {
+    if (!m_fields->preloadJob->poll(PRELOAD_FRAME_BUDGET)) return;
+
+    this->unschedule(schedule_selector(HookedLoadingLayer::preloadingTick));
+    m_fields->preloadJob.reset();
+
+    if (m_fields->preloadingStage == 1) {
+        static_cast<HookedGameManager*>(GameManager::get())->setDeathEffectsPreloaded(true);
+    }
+
+    this->nextPreloadingStage();
+}
+
+void HookedLoadingLayer::nextPreloadingStage() {
     m_fields->preloadingStage++;
     this->setLabelTextForStage();
 
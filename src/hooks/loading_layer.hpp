@@ -4,6 +4,7 @@
 #include <Geode/modify/LoadingLayer.hpp>
 
 #include <managers/settings.hpp>
+#include <util/cocos.hpp>
 #include <util/ui.hpp>
 #include <util/time.hpp>
 
@@ -16,6 +17,7 @@ class $modify(HookedLoadingLayer, LoadingLayer) {
     struct Fields {
         int preloadingStage = 0;
         util::time::system_time_point loadingStartedTime;
+        std::unique_ptr<util::cocos::AssetPreloadJob> preloadJob;
     };
 
 #ifndef GLOBED_LOADING_FINISHED_MIDHOOK
@@ -35,4 +37,6 @@ class $modify(HookedLoadingLayer, LoadingLayer) {
     void preloadingStage1(float);
     void preloadingStage2(float);
     void preloadingStage3(float);
+    void preloadingTick(float);
+    void nextPreloadingStage();
 };
@@ -5,6 +5,7 @@
 #include <managers/error_queues.hpp>
 #include <managers/game_server.hpp>
 #include <managers/settings.hpp>
+#include <managers/startup.hpp>
 #include <managers/friend_list.hpp>
 #include <net/manager.hpp>
 #include <ui/menu/main/globed_menu_layer.hpp>
@@ -23,52 +24,14 @@ bool HookedMenuLayer::init() {
         flm.maybeLoad();
     }
 
-    // auto connect
-    util::misc::callOnce("menu-layer-init-autoconnect", []{
-        if (!GlobedSettings::get().globed.autoconnect) return;
-
-        auto& csm = CentralServerManager::get();
-        auto& gsm = GameServerManager::get();
-        auto& am = GlobedAccountManager::get();
-
-        auto lastId = gsm.loadLastConnected();
-        if (lastId.empty()) return;
-
-        am.autoInitialize();
-
-        if (csm.standalone()) {
-            auto result = NetworkManager::get().connectStandalone();
-            if (result.isErr()) {
-                ErrorQueues::get().warn(fmt::format("Failed to connect: {}", result.unwrapErr()));
-            }
-        } else {
-            auto cacheResult = gsm.loadFromCache();
-            if (cacheResult.isErr()) {
-                ErrorQueues::get().debugWarn(fmt::format("failed to autoconnect: {}", cacheResult.unwrapErr()));
-                return;
-            }
-
-            auto lastServer = gsm.getServer(lastId);
-
-            if (!lastServer.has_value()) {
-                ErrorQueues::get().debugWarn("failed to autoconnect, game server not found");
-                return;
-            };
-
-            if (!am.hasAuthKey()) {
-                // no authkey, don't autoconnect
-                return;
-            }
-
-            am.requestAuthToken([lastServer] {
-                auto result = NetworkManager::get().connect(lastServer.value());
-                if (result.isErr()) {
-                    ErrorQueues::get().warn(fmt::format("Failed to connect: {}", result.unwrapErr()));
-                }
-            });
-        }
+    // get the account keys ready before anything needs them
+    util::misc::callOnce<"menu-layer-init-derive-keys">([]{
+        GlobedAccountManager::get().deriveKeysInBackground();
     });
 
+    // fetching servers, autoconnecting, etc. usually already started during the loading screen
+    StartupManager::get().begin();
+
     m_fields->btnActive = NetworkManager::get().established();
     this->updateGlobedButton();
 
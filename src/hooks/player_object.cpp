@@ -1,6 +1,7 @@
 #include "player_object.hpp"
 
 #include <hooks/gjbasegamelayer.hpp>
+#include <hooks/game_manager.hpp>
 #include <util/ui.hpp>
 #include <util/debug.hpp>
 
@@ -26,15 +27,18 @@ void ComplexPlayerObject::playDeathEffect() {
     auto* rp = static_cast<ComplexVisualPlayer*>(this->getUserObject());
     int deathEffect = rp->storedIcons.deathEffect;
 
-    auto* gm = GameManager::get();
+    auto* gm = static_cast<HookedGameManager*>(GameManager::get());
+
+    // loading the sheet right now would be a hitch mid-gameplay, so play the default effect until it's loaded in the background
+    if (!util::ui::isDeathEffectLoaded(deathEffect)) {
+        gm->prewarmDeathEffect(deathEffect);
+        deathEffect = 1;
+    }
 
     // we need to do this because the orig func reads the death effect ID from GameManager
     int oldEffect = gm->getPlayerDeathEffect();
     gm->setPlayerDeathEffect(deathEffect);
 
-    // also make sure the death effect is properly loaded
-    util::ui::tryLoadDeathEffect(deathEffect);
-
     PlayerObject::playDeathEffect();
     gm->setPlayerDeathEffect(oldEffect);
 }
@@ -53,9 +57,9 @@ void HookedPlayerObject::playSpiderDashEffect(cocos2d::CCPoint from, cocos2d::CC
 
     auto* gpl = GlobedGJBGL::get();
     if (this == gpl->m_player1) {
-        gpl->m_fields->spiderTp1 = SpiderTeleportData { .from = from, .to = to };
+        gpl->queuePlayerEvent(PlayerEventType::SpiderTeleport, false, SpiderTeleportData { .from = from, .to = to });
     } else if (this == gpl->m_player2) {
-        gpl->m_fields->spiderTp2 = SpiderTeleportData { .from = from, .to = to };
+        gpl->queuePlayerEvent(PlayerEventType::SpiderTeleport, true, SpiderTeleportData { .from = from, .to = to });
     }
 
     PlayerObject::playSpiderDashEffect(from, to);
@@ -70,9 +74,9 @@ void HookedPlayerObject::incrementJumps() {
     auto* gpl = GlobedGJBGL::get();
 
     if (this == gpl->m_player1) {
-        gpl->m_fields->didJustJumpp1 = true;
+        gpl->queuePlayerEvent(PlayerEventType::Jump, false);
     } else if (this == gpl->m_player2) {
-        gpl->m_fields->didJustJumpp2 = true;
+        gpl->queuePlayerEvent(PlayerEventType::Jump, true);
     }
 
     PlayerObject::incrementJumps();
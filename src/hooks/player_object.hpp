@@ -3,6 +3,8 @@
 
 #include <Geode/modify/PlayerObject.hpp>
 
+#include "level_hooks.hpp"
+
 class ComplexVisualPlayer;
 
 constexpr int COMPLEX_PLAYER_OBJECT_TAG = 3458738;
@@ -21,6 +23,10 @@ class $modify(ComplexPlayerObject, PlayerObject) {
 
 // Unlike `ComplexPlayerObject`, this one is made specifically for vanilla player objects, so it is a separate $modify class.
 class $modify(HookedPlayerObject, PlayerObject) {
+    static void onModify(auto& self) {
+        globed::deferLevelHooks(self, {"PlayerObject::playSpiderDashEffect", "PlayerObject::incrementJumps", "PlayerObject::update"});
+    }
+
     struct Fields {
         bool forcedPlatFlag = false;
     };
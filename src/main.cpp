@@ -9,14 +9,25 @@
 
 #include <hooks/all.hpp>
 #include <audio/manager.hpp>
+#include <audio/voice_playback_manager.hpp>
 #include <crypto/box.hpp>
+#include <game/lerp_logger.hpp>
+#include <managers/admin.hpp>
+#include <managers/block_list.hpp>
+#include <managers/error_queues.hpp>
+#include <managers/game_server.hpp>
+#include <managers/power.hpp>
+#include <managers/profile_cache.hpp>
+#include <managers/room.hpp>
 #include <managers/settings.hpp>
+#include <net/manager.hpp>
 #include <ui/error_check_node.hpp>
 #include <ui/notification/panel.hpp>
 #include <util/all.hpp>
 
 using namespace geode::prelude;
 
+void initSingletons();
 void setupErrorCheckNode();
 void setupCustomKeybinds();
 void printDebugInfo();
@@ -60,7 +71,13 @@ $on_mod(Loaded) {
     // ).expect("failed to hook fmod").unwrap();
 #endif // GLOBED_VOICE_SUPPORT
 
+    GLOBED_PROFILE_THREAD("Main");
+#ifdef GLOBED_PROFILER
+    util::profiler::TraceRecorder::get().start();
+#endif
+
     CryptoBox::initLibrary();
+    initSingletons();
     setupErrorCheckNode();
     setupCustomKeybinds();
 
@@ -73,6 +90,31 @@ $on_mod(Loaded) {
 #endif
 }
 
+// Singletons used in hot paths are created up front, see `SingletonBase::initialize`.
+// They are destroyed in the reverse order, so everything here can rely on the ones above it, even in its destructor.
+void initSingletons() {
+    ErrorQueues::initialize();
+    GlobedSettings::initialize();
+    ProfileCacheManager::initialize();
+    BlockListManager::initialize();
+    LerpLogger::initialize();
+
+    // used by NetworkManager when disconnecting, which also happens when it's destroyed
+    RoomManager::initialize();
+    GameServerManager::initialize();
+    AdminManager::initialize();
+
+    // voice packets go from the network thread straight to these
+    GlobedAudioManager::initialize();
+    VoicePlaybackManager::initialize();
+
+    // starts the network threads, so it goes after everything they use
+    NetworkManager::initialize();
+
+    // applies the power mode to the network threads
+    PowerManager::initialize();
+}
+
 // error check node runs on every scene and shows popups/notifications if an error has occured in another thread
 void setupErrorCheckNode() {
     auto ecn = ErrorCheckNode::create();
@@ -103,6 +145,29 @@ void setupCustomKeybinds() {
         { Keybind::create(KEY_B, Modifier::None) },
         Category::PLAY,
     });
+
+# ifdef GLOBED_PROFILER
+    BindManager::get()->registerBindable({
+        "profiler-dump-trace"_spr,
+        "Dump trace",
+        "Writes the last 30 seconds of profiler zones, packets and audio callbacks into a trace file (open it in ui.perfetto.dev).",
+        { Keybind::create(KEY_F9, Modifier::None) },
+        Category::GLOBAL,
+    });
+
+    new EventListener([](InvokeBindEvent* event) {
+        if (!event->isDown()) return ListenerResult::Propagate;
+
+        auto result = util::profiler::TraceRecorder::get().dump();
+        if (result.isOk()) {
+            ErrorQueues::get().success(fmt::format("Trace saved to {}", result.unwrap().filename()));
+        } else {
+            ErrorQueues::get().warn(fmt::format("Failed to save trace: {}", result.unwrapErr()));
+        }
+
+        return ListenerResult::Stop;
+    }, InvokeBindFilter(nullptr, "profiler-dump-trace"_spr));
+# endif // GLOBED_PROFILER
 #endif // GLOBED_HAS_KEYBINDS
 }
 
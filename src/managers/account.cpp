@@ -11,22 +11,50 @@
 
 using namespace geode::prelude;
 
-GlobedAccountManager::GlobedAccountManager() {}
+// Checks the age of the session token every now and then, see `GlobedAccountManager::refreshAuthTokenIfStale`
+class AuthTokenRefresher : public CCObject {
+public:
+    static constexpr float INTERVAL = 60.f;
+
+    static AuthTokenRefresher& get() {
+        static AuthTokenRefresher instance;
+        return instance;
+    }
+
+    void update(float) {
+        GlobedAccountManager::get().refreshAuthTokenIfStale();
+    }
+
+private:
+    AuthTokenRefresher() {
+        CCScheduler::get()->scheduleSelector(
+            schedule_selector(AuthTokenRefresher::update), this, INTERVAL, false
+        );
+    }
+};
+
+GlobedAccountManager::GlobedAccountManager() {
+    AuthTokenRefresher::get();
+}
 
 void GlobedAccountManager::initialize(const std::string_view name, int accountId, int userId, const std::string_view central) {
+    auto keys = this->deriveKeys(makeIdentity(name, accountId, userId, central));
+
     GDData data = {
         .accountName = std::string(name),
         .accountId = accountId,
         .userId = userId,
         .central = std::string(central),
-        .precomputedHash = this->computeGDDataHash(name, accountId, userId, central)
+        .precomputedHash = std::move(keys.precomputedHash)
     };
 
     *gdData.lock() = data;
-    auto cryptoKey = util::crypto::hexDecode(data.precomputedHash);
-    cryptoBox = std::make_unique<SecretBox>(cryptoKey);
+    cryptoBox = std::move(keys.cryptoBox);
 
     initialized = true;
+
+    // the saved token belongs to this account and central server, so it's correct to pick it up even when switching
+    *authToken.lock() = Mod::get()->getSavedValue<std::string>(this->getKeyFor("auth-token"));
 }
 
 void GlobedAccountManager::autoInitialize() {
@@ -43,6 +71,27 @@ void GlobedAccountManager::autoInitialize() {
     this->initialize(gjam->m_username, gjam->m_accountID, GameManager::get()->m_playerUserID.value(), activeCentralUrl);
 }
 
+geode::Task<GlobedAccountManager::DerivedKeys> GlobedAccountManager::deriveKeysAsync(const std::string_view name, int accountId, int userId, const std::string_view central) {
+    using KeyTask = geode::Task<DerivedKeys>;
+
+    return KeyTask::run([this, identity = makeIdentity(name, accountId, userId, central)](auto, auto) -> KeyTask::Result {
+        return this->deriveKeys(identity);
+    }, "Account key derivation");
+}
+
+void GlobedAccountManager::deriveKeysInBackground() {
+    auto* gjam = GJAccountManager::sharedState();
+    auto active = CentralServerManager::get().getActive();
+
+    // the task is cancelled once every handle to it is gone, so keep one around
+    backgroundTask = this->deriveKeysAsync(
+        gjam->m_username,
+        gjam->m_accountID,
+        GameManager::get()->m_playerUserID.value(),
+        active ? active->url : ""
+    );
+}
+
 void GlobedAccountManager::storeAuthKey(const util::data::byte* source, size_t size) {
     GLOBED_REQUIRE(initialized, "Attempting to call GlobedAccountManager::storeAuthKey before initializing the instance")
 
@@ -80,6 +129,12 @@ void GlobedAccountManager::requestAuthToken(std::optional<std::function<void()>>
     this->cancelAuthTokenRequest();
 
     requestCallbackStored = std::move(callback);
+    this->startAuthTokenRequest(false);
+}
+
+void GlobedAccountManager::startAuthTokenRequest(bool background) {
+    requestPending = true;
+    requestInBackground = background;
 
     auto task = WebRequestManager::get().requestAuthToken();
 
@@ -87,13 +142,70 @@ void GlobedAccountManager::requestAuthToken(std::optional<std::function<void()>>
     requestListener.setFilter(task);
 }
 
+bool GlobedAccountManager::hasFreshAuthToken() {
+    auto issuedAt = tokenIssuedAt(*authToken.lock());
+    if (!issuedAt) return false;
+
+    return util::time::systemNow() - *issuedAt < AUTH_TOKEN_REFRESH_AGE;
+}
+
+void GlobedAccountManager::refreshAuthTokenIfStale() {
+    if (!initialized || requestPending || CentralServerManager::get().standalone()) return;
+
+    // nothing to refresh, a token is only requested once the user wants to connect
+    if (authToken.lock()->empty() || this->hasFreshAuthToken() || !this->hasAuthKey()) return;
+
+    log::debug("session token is getting old, requesting a new one");
+
+    requestCallbackStored.reset();
+    this->startAuthTokenRequest(true);
+}
+
+void GlobedAccountManager::clearAuthToken() {
+    authToken.lock()->clear();
+
+    // saved values aren't thread safe, and this gets called from the network thread
+    Loader::get()->queueInMainThread([this] {
+        if (initialized) {
+            Mod::get()->setSavedValue<std::string>(this->getKeyFor("auth-token"), "");
+        }
+    });
+}
+
+std::optional<util::time::system_time_point> GlobedAccountManager::tokenIssuedAt(std::string_view token) {
+    // <base64 of "accountid.userid.name.timestamp">.<base64 of the signature>
+    auto claimsEnd = token.find('.');
+    if (claimsEnd == std::string_view::npos) return std::nullopt;
+
+    util::data::bytevector claims;
+    try {
+        claims = util::crypto::base64Decode(token.substr(0, claimsEnd), util::crypto::Base64Variant::URLSAFE_NO_PAD);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+
+    std::string_view claimsStr(reinterpret_cast<const char*>(claims.data()), claims.size());
+
+    auto tsStart = claimsStr.rfind('.');
+    if (tsStart == std::string_view::npos) return std::nullopt;
+
+    auto timestamp = util::format::parse<int64_t>(claimsStr.substr(tsStart + 1));
+    if (!timestamp) return std::nullopt;
+
+    return util::time::system_time_point(util::time::seconds(*timestamp));
+}
+
 void GlobedAccountManager::requestCallback(WebRequestManager::Task::Event* event) {
     if (!event || !event->getValue()) return;
 
+    requestPending = false;
+
     auto result = std::move(*event->getValue());
 
     if (result.isOk()) {
-        *this->authToken.lock() = std::move(result.unwrap());
+        auto token = std::move(result.unwrap());
+        Mod::get()->setSavedValue(this->getKeyFor("auth-token"), token);
+        *this->authToken.lock() = std::move(token);
 
         if (requestCallbackStored.has_value()) {
             requestCallbackStored.value()();
@@ -103,6 +215,11 @@ void GlobedAccountManager::requestCallback(WebRequestManager::Task::Event* event
     }
 
     auto error = event->getValue()->unwrapErr();
+
+    if (requestInBackground) {
+        log::warn("failed to refresh the session token: {}", util::format::webError(error));
+        return;
+    }
     std::string reason;
     if (error.code == 401) {
         // invalid auth? or banned
@@ -167,14 +284,29 @@ std::optional<std::string> GlobedAccountManager::getAdminPassword() {
 
 void GlobedAccountManager::cancelAuthTokenRequest() {
     requestListener.getFilter().cancel();
+    requestPending = false;
 }
 
-std::string GlobedAccountManager::computeGDDataHash(const std::string_view name, int accountId, int userId, const std::string_view central) {
-    auto hash = util::crypto::simpleHash(fmt::format(
-        "{}-{}-{}-{}", name, accountId, userId, central
-    ));
+std::string GlobedAccountManager::makeIdentity(const std::string_view name, int accountId, int userId, const std::string_view central) {
+    return fmt::format("{}-{}-{}-{}", name, accountId, userId, central);
+}
+
+GlobedAccountManager::DerivedKeys GlobedAccountManager::deriveKeys(const std::string& identity) {
+    if (auto cache = keyCache.lock(); cache->contains(identity)) {
+        return cache->at(identity);
+    }
+
+    // computed without holding the lock, if two threads race here they just get the same result
+    auto hash = util::crypto::simpleHash(identity);
+
+    DerivedKeys keys {
+        .precomputedHash = util::crypto::hexEncode(hash),
+        .cryptoBox = std::make_shared<SecretBox>(hash),
+    };
+
+    keyCache.lock()->emplace(identity, keys);
 
-    return util::crypto::hexEncode(hash);
+    return keys;
 }
 
 // NOTE: this does not check for initialized, callers must do it themselves
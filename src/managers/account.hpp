@@ -8,6 +8,7 @@
 #include <managers/web.hpp>
 
 #include <util/singleton.hpp>
+#include <util/time.hpp>
 
 // all methods of GlobedAccountManager will store/load values with keys that are
 // user-specific and central-server-specific, so that switching server or accounts doesn't reset authkeys.
@@ -26,6 +27,12 @@ public:
         std::string precomputedHash;
     };
 
+    // everything derived from `GDData`, computed once per account and then cached
+    struct DerivedKeys {
+        std::string precomputedHash;
+        std::shared_ptr<SecretBox> cryptoBox;
+    };
+
     asp::AtomicBool initialized = false;
     asp::Mutex<GDData> gdData;
     asp::Mutex<std::string> authToken;
@@ -36,6 +43,11 @@ public:
     // Grabs the values from other manager classes and calls `initialize` for you.
     void autoInitialize();
 
+    // Derives the keys for the given account on a worker thread, so that a later `initialize` doesn't have to.
+    geode::Task<DerivedKeys> deriveKeysAsync(const std::string_view name, int accountId, int userId, const std::string_view central);
+    // Like `deriveKeysAsync` but for the current account and central server. Can only be called on the main thread.
+    void deriveKeysInBackground();
+
     void storeAuthKey(const util::data::byte* source, size_t size);
     void storeAuthKey(const util::data::bytevector& source);
     void clearAuthKey();
@@ -45,6 +57,18 @@ public:
 
     void requestAuthToken(std::optional<std::function<void()>> callback);
 
+    // Session tokens expire after a day with the default central server config. Once a token is older than this,
+    // it gets replaced in the background so that connecting doesn't have to wait for a new one. The expiry is up to
+    // the central server though, so a login rejecting the token gets retried once with a new one, see `NetworkManager`.
+    static constexpr auto AUTH_TOKEN_REFRESH_AGE = util::time::hours(12);
+
+    // Whether there is a session token that isn't close to expiring. Tokens are saved, so this can be true right after launch
+    bool hasFreshAuthToken();
+    // Requests a new session token if the current one is old. Failures are only logged, the old token is kept until it's rejected
+    void refreshAuthTokenIfStale();
+    // Clears the session token, including the saved one. Can be called from any thread, the saved one is cleared on the main thread
+    void clearAuthToken();
+
     // admin password stuff
 
     void storeAdminPassword(const std::string_view password);
@@ -55,12 +79,24 @@ public:
 private:
     WebRequestManager::Listener requestListener;
     std::optional<std::function<void()>> requestCallbackStored;
-    std::unique_ptr<SecretBox> cryptoBox;
+    bool requestPending = false;
+    bool requestInBackground = false;
+    std::shared_ptr<SecretBox> cryptoBox;
+
+    // keyed by `makeIdentity`
+    asp::Mutex<std::unordered_map<std::string, DerivedKeys>> keyCache;
+    std::optional<geode::Task<DerivedKeys>> backgroundTask;
 
     void requestCallback(WebRequestManager::Task::Event* event);
     void cancelAuthTokenRequest();
+    void startAuthTokenRequest(bool background);
+
+    // when the central server issued the token, read from its claims
+    static std::optional<util::time::system_time_point> tokenIssuedAt(std::string_view token);
 
-    std::string computeGDDataHash(const std::string_view name, int accountId, int userId, const std::string_view central);
+    static std::string makeIdentity(const std::string_view name, int accountId, int userId, const std::string_view central);
+    // returns the cached keys for this identity, or derives and caches them. thread safe
+    DerivedKeys deriveKeys(const std::string& identity);
 
     // uses the precomputed hash from GDData and appends it to the given 'key'
     // i.e. getKeyFor("auth-totp-key") => "auth-totp-key-ab12cd34ef"
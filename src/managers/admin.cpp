@@ -6,6 +6,7 @@
 #include <ui/menu/admin/user_popup.hpp>
 #include <ui/general/audio_visualizer.hpp>
 #include <ui/general/intermediary_loading_popup.hpp>
+#include <util/format.hpp>
 
 bool AdminManager::authorized() {
     return authorized_;
@@ -19,6 +20,7 @@ void AdminManager::setAuthorized(ComputedRole&& role) {
 void AdminManager::deauthorize() {
     authorized_ = false;
     role = {};
+    this->clearUserCache();
 }
 
 ComputedRole& AdminManager::getRole() {
@@ -26,16 +28,70 @@ ComputedRole& AdminManager::getRole() {
 }
 
 void AdminManager::openUserPopup(const PlayerRoomPreviewAccountData& rpdata) {
+    if (auto* cached = this->getCachedUser(std::to_string(rpdata.accountId))) {
+        AdminUserPopup::create(cached->entry, rpdata)->show();
+        return;
+    }
+
     // load the data from the server
     auto& nm = NetworkManager::get();
     IntermediaryLoadingPopup::create([&nm, rpdata = rpdata](auto popup) {
         nm.send(AdminGetUserStatePacket::create(std::to_string(rpdata.accountId)));
-        nm.addListener<AdminUserDataPacket>(popup, [popup, rpdata = std::move(rpdata)](auto packet) {
+        nm.addListener<AdminUserDataPacket>(popup, [popup, rpdata = std::move(rpdata)](auto& packet) {
             // delay the cration to avoid deadlock
-            Loader::get()->queueInMainThread([popup, userEntry = std::move(packet->userEntry), accountData = std::move(rpdata)] {
+            Loader::get()->queueInMainThread([popup, userEntry = std::move(packet.userEntry), accountData = std::move(rpdata)] {
+                AdminManager::get().cacheUser(userEntry, accountData);
                 AdminUserPopup::create(userEntry, accountData)->show();
                 popup->onClose(popup);
             });
         });
     }, [](auto) {})->show();
 }
+
+void AdminManager::cacheUser(const UserEntry& entry, const std::optional<PlayerRoomPreviewAccountData>& accountData) {
+    auto& cached = userCache[entry.accountId];
+
+    // an offline lookup has no account data, keep the one we got from a profile fetch earlier
+    bool keepAccountData = cached.accountData.has_value() && !cached.accountData->name.empty()
+        && (!accountData.has_value() || accountData->name.empty());
+
+    cached.entry = entry;
+    if (!keepAccountData) {
+        cached.accountData = accountData;
+    }
+    cached.fetchedAt = util::time::now();
+
+    if (cached.accountData.has_value() && !cached.accountData->name.empty()) {
+        userCacheNames[util::format::toLowercase(cached.accountData->name.str())] = entry.accountId;
+    } else if (entry.userName.has_value()) {
+        userCacheNames[util::format::toLowercase(*entry.userName)] = entry.accountId;
+    }
+}
+
+const AdminManager::CachedUser* AdminManager::getCachedUser(std::string_view query) {
+    int accountId = 0;
+
+    auto [ptr, ec] = std::from_chars(query.data(), query.data() + query.size(), accountId);
+    if (ec != std::errc{} || ptr != query.data() + query.size()) {
+        auto it = userCacheNames.find(util::format::toLowercase(query));
+        if (it == userCacheNames.end()) return nullptr;
+
+        accountId = it->second;
+    }
+
+    auto it = userCache.find(accountId);
+    if (it == userCache.end()) return nullptr;
+
+    if (util::time::now() - it->second.fetchedAt > USER_CACHE_TTL) {
+        // names are only checked on lookup, a stale mapping just misses
+        userCache.erase(it);
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void AdminManager::clearUserCache() {
+    userCache.clear();
+    userCacheNames.clear();
+}
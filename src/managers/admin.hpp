@@ -2,10 +2,12 @@
 
 #include <asp/sync/Atomic.hpp>
 
+#include <data/types/admin.hpp>
 #include <data/types/user.hpp>
 #include <data/types/gd.hpp>
 
 #include <util/singleton.hpp>
+#include <util/time.hpp>
 
 class AdminManager : public SingletonBase<AdminManager> {
     friend class SingletonBase;
@@ -18,7 +20,25 @@ public:
 
     void openUserPopup(const PlayerRoomPreviewAccountData& rpdata);
 
+    struct CachedUser {
+        UserEntry entry;
+        std::optional<PlayerRoomPreviewAccountData> accountData;
+        util::time::time_point fetchedAt;
+    };
+
+    // How long a looked up user is shown again without asking the server
+    static constexpr auto USER_CACHE_TTL = util::time::seconds(60);
+
+    // Remember a looked up user. Account data without a name does not replace account data that has one.
+    void cacheUser(const UserEntry& entry, const std::optional<PlayerRoomPreviewAccountData>& accountData);
+    // Finds a cached user by account ID or name (case insensitive), like `AdminGetUserStatePacket` takes. Expired entries are not returned.
+    const CachedUser* getCachedUser(std::string_view query);
+    void clearUserCache();
+
 private:
     asp::sync::AtomicBool authorized_;
     ComputedRole role = {};
+
+    std::unordered_map<int, CachedUser> userCache;
+    std::unordered_map<std::string, int> userCacheNames; // lowercase name -> account ID
 };
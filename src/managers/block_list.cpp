@@ -67,10 +67,12 @@ Result<> BlockListManager::load() {
     auto blocklist = blocklistR.unwrap();
     auto whitelist = whitelistR.unwrap();
 
+    _bl.reserve(blocklist.size());
     for (int elem : blocklist) {
         _bl.insert(elem);
     }
 
+    _wl.reserve(whitelist.size());
     for (int elem : whitelist) {
         _wl.insert(elem);
     }
@@ -87,17 +89,13 @@ bool BlockListManager::isExplicitlyAllowed(int playerId) {
 }
 
 void BlockListManager::blacklist(int playerId) {
-    if (_wl.contains(playerId)) {
-        _wl.erase(playerId);
-    }
+    _wl.erase(playerId);
     _bl.insert(playerId);
     this->save();
 }
 
 void BlockListManager::whitelist(int playerId) {
-    if (_bl.contains(playerId)) {
-        _bl.erase(playerId);
-    }
+    _bl.erase(playerId);
     _wl.insert(playerId);
     this->save();
 }
@@ -106,6 +104,14 @@ bool BlockListManager::isHidden(int playerId) {
     return hiddenPlayers.contains(playerId);
 }
 
+std::vector<bool> BlockListManager::areExplicitlyBlocked(std::span<const int> playerIds) {
+    return _bl.containsMany(playerIds);
+}
+
+std::vector<bool> BlockListManager::areHidden(std::span<const int> playerIds) {
+    return hiddenPlayers.containsMany(playerIds);
+}
+
 void BlockListManager::setHidden(int playerId, bool state) {
     if (state) {
         hiddenPlayers.insert(playerId);
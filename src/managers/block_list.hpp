@@ -1,6 +1,7 @@
 #pragma once
 #include <defs/minimal_geode.hpp>
 
+#include <util/collections.hpp>
 #include <util/singleton.hpp>
 
 class BlockListManager : public SingletonBase<BlockListManager> {
@@ -20,9 +21,13 @@ public:
     bool isHidden(int playerId);
     void setHidden(int playerId, bool state);
 
+    // Batch versions of `isExplicitlyBlocked` and `isHidden` for list UIs, results are in the same order as `playerIds`
+    std::vector<bool> areExplicitlyBlocked(std::span<const int> playerIds);
+    std::vector<bool> areHidden(std::span<const int> playerIds);
+
 private:
-    std::set<int> _bl, _wl;
-    std::set<int> hiddenPlayers;
+    util::collections::FlatSet<int> _bl, _wl;
+    util::collections::FlatSet<int> hiddenPlayers;
 
     void save();
     Result<> load();
@@ -2,65 +2,107 @@
 
 #include <defs/minimal_geode.hpp>
 
+ErrorQueues::ErrorQueues() {
+    pending.reserve(QUEUE_CAPACITY);
+}
+
+std::string ErrorQueues::Message::format() const {
+    if (count > 1) {
+        return fmt::format("{} (x{})", this->view(), count);
+    }
+
+    return std::string(this->view());
+}
+
 void ErrorQueues::warn(const std::string_view message, bool print) {
     if (print) log::warn("{}", message);
-    _warns.push(std::string(message));
+    this->push(Kind::Warning, message);
 }
 
 void ErrorQueues::error(const std::string_view message, bool print) {
     if (print) log::error("{}", message);
-    _errors.push(std::string(message));
+    this->push(Kind::Error, message);
 }
 
 void ErrorQueues::success(const std::string_view message, bool print) {
     if (print) log::info("{}", message);
-    _successes.push(std::string(message));
+    this->push(Kind::Success, message);
 }
 
 void ErrorQueues::notice(const std::string_view message, bool print) {
     if (print) log::warn("[Server notice] {}", message);
-    _notices.push(std::string(message));
+    this->push(Kind::Notice, message);
 }
 
 void ErrorQueues::debugWarn(const std::string_view message, bool print) {
     if (print) log::warn("{}", message);
 #if defined(GLOBED_DEBUG) && GLOBED_DEBUG
-    _warns.push(std::string(message));
+    this->push(Kind::Warning, message);
 #endif
 }
 
-std::vector<std::string> ErrorQueues::getWarnings() {
-    std::vector<std::string> out;
-    while (auto msg = _warns.tryPop()) {
-        out.push_back(msg.value());
+void ErrorQueues::push(Kind kind, std::string_view message) {
+    auto idx = static_cast<size_t>(kind);
+
+    // zero means "nothing pushed since the last poll"
+    uint64_t hash = std::hash<std::string_view>{}(message) | 1;
+
+    if (lastHash[idx].exchange(hash, std::memory_order_acq_rel) == hash) {
+        repeats[idx].fetch_add(1, std::memory_order_relaxed);
+        return;
     }
 
-    return out;
+    size_t length = std::min(message.size(), Message::MAX_LENGTH);
+    // don't cut a utf-8 sequence in half
+    if (length < message.size()) {
+        while (length > 0 && (static_cast<uint8_t>(message[length]) & 0xc0) == 0x80) length--;
+    }
+
+    Message msg;
+    msg.hash = hash;
+    msg.count = 1;
+    msg.length = static_cast<uint16_t>(length);
+    msg.kind = kind;
+    std::copy_n(message.data(), length, msg.text);
+
+    if (!queue.tryPush(std::move(msg))) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
-std::vector<std::string> ErrorQueues::getErrors() {
-    std::vector<std::string> out;
-    while (auto msg = _errors.tryPop()) {
-        out.push_back(msg.value());
+void ErrorQueues::poll() {
+    while (auto msg = queue.tryPop()) {
+        if (auto* existing = this->findPending(msg->kind, msg->hash)) {
+            existing->count += msg->count;
+        } else if (pending.size() < QUEUE_CAPACITY) {
+            pending.push_back(*msg);
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
-    return out;
-}
+    // repeats that were never queued belong to the last message of their kind, if it wasn't shown already.
+    // a repeat racing with this can get lost, which is fine, the counts are only informative
+    for (size_t i = 0; i < KIND_COUNT; i++) {
+        uint64_t hash = lastHash[i].exchange(0, std::memory_order_acq_rel);
+        uint32_t count = repeats[i].exchange(0, std::memory_order_relaxed);
+
+        if (count == 0) continue;
 
-std::vector<std::string> ErrorQueues::getSuccesses() {
-    std::vector<std::string> out;
-    while (auto msg = _successes.tryPop()) {
-        out.push_back(msg.value());
+        if (auto* existing = this->findPending(static_cast<Kind>(i), hash)) {
+            existing->count += count;
+        }
     }
 
-    return out;
+    if (uint32_t count = dropped.exchange(0, std::memory_order_relaxed)) {
+        log::warn("Error queue full, dropped {} messages", count);
+    }
 }
 
-std::vector<std::string> ErrorQueues::getNotices() {
-    std::vector<std::string> out;
-    while (auto msg = _notices.tryPop()) {
-        out.push_back(msg.value());
+ErrorQueues::Message* ErrorQueues::findPending(Kind kind, uint64_t hash) {
+    for (auto& msg : pending) {
+        if (msg.kind == kind && msg.hash == hash) return &msg;
     }
 
-    return out;
-}
\ No newline at end of file
+    return nullptr;
+}
@@ -1,29 +1,89 @@
 #pragma once
 
-#include <asp/sync.hpp>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include <util/collections.hpp>
 #include <util/singleton.hpp>
 
 /*
 * ErrorQueues is a thread safe singleton for propagating errors to the main thread,
 * so they can be shown to the end user.
+*
+* Messages go through a single lock-free queue of fixed size messages, so pushing never locks or allocates.
+* Repeats of the same message are coalesced into one with a count, both while still in the queue and while waiting to be shown,
+* so a storm of identical errors (e.g. while reconnecting) ends up as a single notification.
 */
 
 class ErrorQueues : public SingletonBase<ErrorQueues> {
+    friend class SingletonBase;
+    ErrorQueues();
+
 public:
+    enum class Kind : uint8_t {
+        Warning,
+        Error,
+        Success,
+        Notice, // notices are messages coming directly from the server
+    };
+
+    static constexpr size_t KIND_COUNT = 4;
+
+    struct Message {
+        // longer messages are truncated
+        static constexpr size_t MAX_LENGTH = 1000;
+
+        uint64_t hash;
+        uint32_t count; // how many times it was pushed
+        uint16_t length;
+        Kind kind;
+        char text[MAX_LENGTH];
+
+        std::string_view view() const {
+            return std::string_view(text, length);
+        }
+
+        // the text, followed by the amount of repeats if there were any
+        std::string format() const;
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 64;
+
     void warn(const std::string_view message, bool print = true);
     void error(const std::string_view message, bool print = true);
     void success(const std::string_view message, bool print = true);
-    // notices are messages coming directly from the server
     void notice(const std::string_view message, bool print = true);
 
     // debugWarn shows a warn notification in debug, in release only prints a message (noop if `print` = false)
     void debugWarn(const std::string_view message, bool print = true);
 
-    std::vector<std::string> getWarnings();
-    std::vector<std::string> getErrors();
-    std::vector<std::string> getSuccesses();
-    std::vector<std::string> getNotices();
+    // Main thread only. Moves everything pushed since the last call to the pending messages.
+    void poll();
+
+    // Main thread only. Calls `callback` with every pending message of the given kind and removes them,
+    // messages of other kinds stay pending until they are taken.
+    template <typename F>
+    void take(Kind kind, F&& callback) {
+        for (const auto& msg : pending) {
+            if (msg.kind == kind) callback(msg);
+        }
+
+        std::erase_if(pending, [kind](const Message& msg) { return msg.kind == kind; });
+    }
+
 private:
-    asp::Channel<std::string> _warns, _errors, _successes, _notices;
-};
\ No newline at end of file
+    util::collections::MpscQueue<Message, QUEUE_CAPACITY> queue;
+
+    // last message pushed of each kind, repeats of it only bump `repeats` until the next `poll`
+    std::array<std::atomic<uint64_t>, KIND_COUNT> lastHash{};
+    std::array<std::atomic<uint32_t>, KIND_COUNT> repeats{};
+    std::atomic<uint32_t> dropped = 0;
+
+    // consumer side, never grows past `QUEUE_CAPACITY`
+    std::vector<Message> pending;
+
+    void push(Kind kind, std::string_view message);
+    Message* findPending(Kind kind, uint64_t hash);
+};
@@ -31,7 +31,16 @@ bool FriendListManager::isFriend(int playerId) {
     return friends.contains(playerId);
 }
 
+std::vector<bool> FriendListManager::areFriends(std::span<const int> playerIds) {
+    return friends.containsMany(playerIds);
+}
+
+const util::collections::FlatSet<int>& FriendListManager::getFriends() {
+    return friends;
+}
+
 void FriendListManager::insertPlayers(cocos2d::CCArray* players) {
+    friends.reserve(friends.size() + players->count());
     for (auto* elem : CCArrayExt<GJUserScore*>(players)) {
         friends.insert(elem->m_accountID);
     }
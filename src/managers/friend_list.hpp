@@ -1,6 +1,7 @@
 #pragma once
 #include <defs/geode.hpp>
 
+#include <util/collections.hpp>
 #include <util/singleton.hpp>
 
 class FriendListManager : public SingletonBase<FriendListManager> {
@@ -29,11 +30,15 @@ public:
     void invalidate();
 
     bool isFriend(int playerId);
+    // Batch version of `isFriend` for list UIs, results are in the same order as `playerIds`
+    std::vector<bool> areFriends(std::span<const int> playerIds);
+
+    const util::collections::FlatSet<int>& getFriends();
 
 private:
     void insertPlayers(cocos2d::CCArray* players);
 
     Ref<DummyNode> dummyNode;
-    std::set<int> friends;
+    util::collections::FlatSet<int> friends;
     bool loaded = false;
 };
\ No newline at end of file
@@ -22,11 +22,14 @@ Result<> GameServerManager::addOrUpdateServer(const std::string_view serverId_,
 
     int ping = -1;
     uint16_t playerCount = 0;
+    LatencyStats latency;
 
     auto data = _data.lock();
     if (data->servers.contains(serverId)) {
-        ping = data->servers.at(serverId).server.ping;
-        playerCount = data->servers.at(serverId).server.playerCount;
+        auto& existing = data->servers.at(serverId).server;
+        ping = existing.ping;
+        playerCount = existing.playerCount;
+        latency = existing.latency;
     }
 
     GameServer server = {
@@ -36,6 +39,7 @@ Result<> GameServerManager::addOrUpdateServer(const std::string_view serverId_,
         .address = std::string(address),
         .ping = ping,
         .playerCount = playerCount,
+        .latency = latency,
     };
 
     GameServerManager::GameServerData gsdata = {
@@ -43,6 +47,7 @@ Result<> GameServerManager::addOrUpdateServer(const std::string_view serverId_,
     };
 
     data->servers[serverId] = gsdata;
+    this->markDirty();
 
     return Ok();
 
@@ -50,10 +55,11 @@ Result<> GameServerManager::addOrUpdateServer(const std::string_view serverId_,
 
 void GameServerManager::clear() {
     _data.lock()->servers.clear();
+    this->markDirty();
 }
 
 size_t GameServerManager::count() {
-    return _data.lock()->servers.size();
+    return this->snapshot()->servers.size();
 }
 
 void GameServerManager::setActive(const std::string_view id) {
@@ -62,6 +68,7 @@ void GameServerManager::setActive(const std::string_view id) {
     if (!data->servers.contains(idstr)) return;
 
     data->active = id;
+    this->markDirty();
 
     this->saveLastConnected(id);
 }
@@ -69,6 +76,7 @@ void GameServerManager::setActive(const std::string_view id) {
 void GameServerManager::clearActive() {
     auto data = _data.lock();
     data->active.clear();
+    this->markDirty();
 
     this->saveLastConnected("");
 }
@@ -80,42 +88,62 @@ void GameServerManager::clearAllExcept(const std::string_view id) {
     auto value = data->servers.at(key);
     data->servers.clear();
     data->servers.emplace(std::move(key), std::move(value));
+    this->markDirty();
 }
 
 std::string GameServerManager::getActiveId() {
-    return _data.lock()->active;
+    return this->snapshot()->active;
 }
 
 std::optional<GameServer> GameServerManager::getActiveServer() {
-    auto active = this->getActiveId();
-    if (active.empty()) {
+    auto snap = this->snapshot();
+    if (snap->active.empty()) {
         return std::nullopt;
     }
 
-    return this->getServer(active);
+    auto it = snap->servers.find(snap->active);
+    if (it == snap->servers.end()) {
+        return std::nullopt;
+    }
+
+    return it->second;
 }
 
-std::optional<GameServer> GameServerManager::getServer(const std::string_view id_) {
-    std::string id(id_);
+std::optional<GameServer> GameServerManager::getServer(const std::string_view id) {
+    auto snap = this->snapshot();
 
-    auto data = _data.lock();
-    if (!data->servers.contains(id)) {
+    auto it = snap->servers.find(std::string(id));
+    if (it == snap->servers.end()) {
         return std::nullopt;
     }
 
-    return data->servers.at(id).server;
+    return it->second;
 }
 
 std::unordered_map<std::string, GameServer> GameServerManager::getAllServers() {
-    auto data = _data.lock();
+    return this->snapshot()->servers;
+}
+
+std::shared_ptr<const GameServerManager::Snapshot> GameServerManager::snapshot() {
+    if (_dirty.exchange(false, std::memory_order_acq_rel)) {
+        auto data = _data.lock();
 
-    std::unordered_map<std::string, GameServer> out;
+        auto snap = std::make_shared<Snapshot>();
+        snap->active = data->active;
+        snap->servers.reserve(data->servers.size());
 
-    for (const auto& [_, gsd] : data->servers) {
-        out.insert(std::make_pair(gsd.server.id, gsd.server));
+        for (const auto& [_, gsd] : data->servers) {
+            snap->servers.emplace(gsd.server.id, gsd.server);
+        }
+
+        std::atomic_store_explicit(&_published, std::shared_ptr<const Snapshot>(std::move(snap)), std::memory_order_release);
     }
 
-    return out;
+    return std::atomic_load_explicit(&_published, std::memory_order_acquire);
+}
+
+void GameServerManager::markDirty() {
+    _dirty.store(true, std::memory_order_release);
 }
 
 int GameServerManager::getActivePing() {
@@ -150,6 +178,10 @@ void GameServerManager::clearCache() {
     this->updateCache("");
 }
 
+bool GameServerManager::isCached(const std::string_view response) {
+    return _data.lock()->cachedServerResponse == response;
+}
+
 Result<> GameServerManager::loadFromCache() {
     const size_t MAGIC_LEN = sizeof(NetworkManager::SERVER_MAGIC);
 
@@ -212,15 +244,10 @@ uint32_t GameServerManager::startPing(const std::string_view serverId) {
     auto pingId = util::rng::Random::get().generate<uint32_t>();
 
     auto data = _data.lock();
-    auto& gsdata = data->servers.at(std::string(serverId));
-
-    if (gsdata.pendingPings.size() > 50) {
-        log::warn("over 50 pending pings for the game server {}, clearing", serverId);
-        gsdata.pendingPings.clear();
-    }
-
-    auto now = util::time::now();
-    gsdata.pendingPings[pingId] = now;
+    data->pendingPings[pingId] = PendingPing {
+        .serverId = std::string(serverId),
+        .start = util::time::now(),
+    };
 
     return pingId;
 }
@@ -230,17 +257,102 @@ void GameServerManager::finishPing(uint32_t pingId, uint32_t playerCount) {
 
     auto data = _data.lock();
 
-    for (auto& [_, server] : data->servers) {
-        if (server.pendingPings.contains(pingId)) {
-            auto start = server.pendingPings.at(pingId);
-            auto timeTook = util::time::asMillis(now - start);
+    auto it = data->pendingPings.find(pingId);
+    if (it == data->pendingPings.end()) return;
+
+    auto pending = std::move(it->second);
+    data->pendingPings.erase(it);
+
+    // the server could have been removed while the ping was in flight
+    auto server = data->servers.find(pending.serverId);
+    if (server == data->servers.end()) return;
+
+    auto& gs = server->second.server;
+    gs.latency.addSample(util::time::asMillis(now - pending.start));
+    gs.ping = std::lround(gs.latency.smoothed);
+    gs.playerCount = playerCount;
+    this->markDirty();
+}
+
+void GameServerManager::expirePing(uint32_t pingId) {
+    auto data = _data.lock();
+
+    auto it = data->pendingPings.find(pingId);
+    if (it == data->pendingPings.end()) return;
 
-            server.server.ping = timeTook;
-            server.server.playerCount = playerCount;
-            server.pendingPings.erase(pingId);
-            return;
+    auto server = data->servers.find(it->second.serverId);
+    data->pendingPings.erase(it);
+
+    if (server != data->servers.end()) {
+        server->second.server.latency.addLoss();
+        this->markDirty();
+    }
+}
+
+std::optional<GameServer> GameServerManager::bestServer(const std::string_view region, const std::string_view exclude) {
+    // a server that loses most pings is likely down, even if the few answers were fast
+    constexpr float MAX_LOSS = 0.5f;
+
+    auto snap = this->snapshot();
+    const GameServer* best = nullptr;
+
+    for (const auto& [id, server] : snap->servers) {
+        if (id == exclude || id == STANDALONE_ID) continue;
+        if (!region.empty() && server.region != region) continue;
+        if (!server.latency.hasSamples() || server.latency.loss > MAX_LOSS) continue;
+
+        if (!best || server.latency.score() < best->latency.score()) {
+            best = &server;
         }
     }
+
+    return best ? std::optional(*best) : std::nullopt;
+}
+
+void LatencyStats::addSample(int rttMs) {
+    // same gains as the TCP retransmission timer (RFC 6298)
+    constexpr float RTT_GAIN = 1.f / 8.f;
+    constexpr float JITTER_GAIN = 1.f / 4.f;
+    constexpr float LOSS_GAIN = 1.f / 8.f;
+
+    float rtt = static_cast<float>(rttMs);
+
+    if (!this->hasSamples()) {
+        smoothed = rtt;
+        jitter = rtt / 2.f;
+    } else {
+        jitter += JITTER_GAIN * (std::abs(smoothed - rtt) - jitter);
+        smoothed += RTT_GAIN * (rtt - smoothed);
+    }
+
+    loss -= LOSS_GAIN * loss;
+
+    recent[samples % WINDOW] = rttMs;
+    samples++;
+}
+
+void LatencyStats::addLoss() {
+    constexpr float LOSS_GAIN = 1.f / 8.f;
+    loss += LOSS_GAIN * (1.f - loss);
+}
+
+int LatencyStats::percentile(float p) const {
+    size_t count = std::min(samples, WINDOW);
+    if (count == 0) return -1;
+
+    std::array<int, WINDOW> sorted;
+    std::copy_n(recent.begin(), count, sorted.begin());
+
+    auto nth = sorted.begin() + std::min<size_t>(static_cast<size_t>(p * count), count - 1);
+    std::nth_element(sorted.begin(), nth, sorted.begin() + count);
+
+    return *nth;
+}
+
+float LatencyStats::score() const {
+    // the tail matters more than the average, a server with regular spikes is worse than a slightly slower stable one
+    float tail = std::max(smoothed, static_cast<float>(this->percentile(0.9f)));
+    return (tail + jitter) / (1.f - std::min(loss, 0.9f));
 }
 
 void GameServerManager::startKeepalive() {
@@ -248,7 +360,11 @@ void GameServerManager::startKeepalive() {
 
     if (!active.empty()) {
         auto pingId = this->startPing(active);
-        _data.lock()->activePingId = pingId;
+
+        // only the latest keepalive can be answered, drop the previous one if it got lost
+        auto data = _data.lock();
+        data->pendingPings.erase(data->activePingId);
+        data->activePingId = pingId;
     }
 }
 
@@ -1,13 +1,41 @@
 #pragma once
 #include <defs/minimal_geode.hpp>
 
+#include <array>
 #include <unordered_map>
+#include <memory>
+#include <atomic>
 #include <asp/sync.hpp> // mutex
 
 #include <util/crypto.hpp> // base64
 #include <util/time.hpp>
 #include <util/singleton.hpp>
 
+// Rolling round trip statistics of a server, fed by background pings and keepalives
+struct LatencyStats {
+    static constexpr size_t WINDOW = 32;
+
+    float smoothed = -1.f; // EWMA of the round trip time in milliseconds, -1 before the first sample
+    float jitter = 0.f;    // EWMA of the deviation from `smoothed`
+    float loss = 0.f;      // EWMA of the fraction of pings that were never answered
+
+    std::array<int, WINDOW> recent{}; // last `WINDOW` samples, oldest is overwritten first
+    size_t samples = 0;
+
+    void addSample(int rttMs);
+    void addLoss();
+
+    bool hasSamples() const {
+        return smoothed >= 0.f;
+    }
+
+    // Round trip time that `p` (0 to 1) of the recent samples were at or below, -1 without samples
+    int percentile(float p) const;
+
+    // Lower is better. Jitter and loss count against a server, as they show up as stutter in levels
+    float score() const;
+};
+
 struct GameServer {
     std::string id;
     std::string name;
@@ -16,9 +44,11 @@ struct GameServer {
 
     int ping;
     uint32_t playerCount;
+    LatencyStats latency;
 };
 
-// This class is fully thread safe to use.
+// This class is fully thread safe to use. Reads go through an immutable snapshot that is republished after changes,
+// so they don't contend with the network thread updating pings.
 class GameServerManager : public SingletonBase<GameServerManager> {
 protected:
     friend class SingletonBase;
@@ -32,6 +62,12 @@ public:
 
     asp::AtomicBool pendingChanges;
 
+    // Immutable view of the servers, shared between everyone reading it until something changes
+    struct Snapshot {
+        std::unordered_map<std::string, GameServer> servers;
+        std::string active;
+    };
+
     Result<> addServer(const std::string_view serverId, const std::string_view name, const std::string_view address, const std::string_view region);
     Result<> addOrUpdateServer(const std::string_view serverId, const std::string_view name, const std::string_view address, const std::string_view region);
     void clear();
@@ -47,10 +83,16 @@ public:
     std::optional<GameServer> getActiveServer();
     std::optional<GameServer> getServer(const std::string_view id);
     std::unordered_map<std::string, GameServer> getAllServers();
+    // Current snapshot, cheap to call and never blocks unless there are unpublished changes.
+    // Prefer this over `getAllServers` when you only need to iterate over the servers.
+    std::shared_ptr<const Snapshot> snapshot();
 
     // return ping on the active server
     int getActivePing();
 
+    // Server with the best latency in `region` (or any region if empty), skipping `exclude` and servers that aren't answering pings
+    std::optional<GameServer> bestServer(const std::string_view region, const std::string_view exclude = "");
+
     // save the given address as a last connected standalone address
     void saveStandalone(const std::string_view addr);
     std::string loadStandalone();
@@ -60,29 +102,44 @@ public:
 
     void updateCache(const std::string_view response);
     void clearCache();
+    // whether `response` is the same as the cached server response, so there is nothing new to parse
+    bool isCached(const std::string_view response);
     Result<> loadFromCache();
 
     /* pings */
 
     uint32_t startPing(const std::string_view serverId);
     void finishPing(uint32_t pingId, uint32_t playerCount);
+    // forget about a ping that never got a response, does nothing if it was already finished
+    void expirePing(uint32_t pingId);
 
     void startKeepalive();
     void finishKeepalive(uint32_t playerCount);
 
 protected:
-    // expansion of GameServer with pending pings
     struct GameServerData {
         GameServer server;
-        std::unordered_map<uint32_t, util::time::time_point> pendingPings;
+    };
+
+    struct PendingPing {
+        std::string serverId;
+        util::time::time_point start;
     };
 
     struct InnerData {
         std::unordered_map<std::string, GameServerData> servers;
+        std::unordered_map<uint32_t, PendingPing> pendingPings;
         std::string active; // current game server ID
-        uint32_t activePingId;
+        uint32_t activePingId = 0;
         std::string cachedServerResponse;
     };
 
     asp::Mutex<InnerData> _data;
+
+    // set after every change to `_data`, the next `snapshot()` call republishes it.
+    // ping results only set this flag, so a round of pings gets published once instead of once per server
+    std::atomic_bool _dirty = true;
+    std::shared_ptr<const Snapshot> _published = std::make_shared<const Snapshot>();
+
+    void markDirty();
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "icon_loader.hpp"
+
+#include <hooks/game_manager.hpp>
+#include <ui/game/player/complex_visual_player.hpp>
+#include <util/misc.hpp>
+
+using namespace geode::prelude;
+
+// `addImageAsync` wants a cocos object to call back into
+class IconLoadTarget : public CCObject {
+public:
+    void onLoaded(CCObject* obj) {
+        IconLoadManager::get().onLoaded(static_cast<CCTexture2D*>(obj));
+    }
+};
+
+IconLoadManager::IconLoadManager() {
+    // lives as long as the manager does, never released
+    target = new IconLoadTarget;
+    maxInFlight = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+}
+
+bool IconLoadManager::request(ComplexVisualPlayer* player, const PlayerIconData& icons, PlayerIconTypeMask types) {
+    this->cancel(player);
+
+    auto* gm = static_cast<HookedGameManager*>(GameManager::get());
+    size_t waitingOn = 0;
+
+    for (auto type = PlayerIconType::Cube; type <= PlayerIconType::Jetpack; type = (PlayerIconType)((int)type + 1)) {
+        if (!(types & iconTypeBit(type))) continue;
+
+        int iconId = util::misc::getIconWithType(icons, type);
+        int iconType = (int)util::misc::convertEnum<IconType>(type);
+
+        if (gm->getCachedIcon(iconId, iconType)) continue;
+
+        int key = gm->keyForIcon(iconId, iconType);
+
+        auto it = pending.find(key);
+        if (it == pending.end()) {
+            auto sheetName = gm->sheetNameForIcon(iconId, iconType);
+            if (sheetName.empty()) continue;
+
+            it = pending.emplace(key, PendingIcon {
+                .iconId = iconId,
+                .iconType = iconType,
+                .sheetName = std::move(sheetName),
+            }).first;
+
+            queued.push_back(key);
+        }
+
+        it->second.waiters.push_back(player);
+        waitingOn++;
+    }
+
+    if (waitingOn == 0) return false;
+
+    remaining[player] = waitingOn;
+    this->startQueued();
+
+    return true;
+}
+
+void IconLoadManager::cancel(ComplexVisualPlayer* player) {
+    if (remaining.erase(player) == 0) return;
+
+    // the icons themselves keep loading, other players may still need them
+    for (auto& [key, icon] : pending) {
+        std::erase(icon.waiters, player);
+    }
+}
+
+void IconLoadManager::startQueued() {
+    auto* textureCache = CCTextureCache::sharedTextureCache();
+
+    while (inFlight < maxInFlight && !queued.empty()) {
+        int key = queued.front();
+        queued.pop_front();
+
+        inFlight++;
+
+        textureCache->addImageAsync(
+            (pending.at(key).sheetName + ".png").c_str(),
+            target,
+            menu_selector(IconLoadTarget::onLoaded),
+            key,
+            kCCTexture2DPixelFormat_RGBA8888
+        );
+    }
+}
+
+void IconLoadManager::onLoaded(CCTexture2D* texture) {
+    inFlight--;
+
+    int key = texture->getTag();
+    auto it = pending.find(key);
+
+    if (it == pending.end()) {
+        log::warn("icon loader got a texture it did not request: {}", key);
+        this->startQueued();
+        return;
+    }
+
+    auto icon = std::move(it->second);
+    pending.erase(it);
+
+    // registers the icon and its frames, our hook then puts it into the icon cache
+    GameManager::get()->loadIcon(icon.iconId, icon.iconType, -1);
+
+    for (auto* waiter : icon.waiters) {
+        auto rit = remaining.find(waiter);
+        if (rit == remaining.end()) continue;
+
+        if (--rit->second == 0) {
+            remaining.erase(rit);
+            waiter->onFinishedLoadingIconAsync();
+        }
+    }
+
+    this->startQueued();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <deque>
+
+#include <defs/geode.hpp>
+#include <data/types/gd.hpp>
+#include <util/singleton.hpp>
+
+class ComplexVisualPlayer;
+
+// Loads player icons asynchronously for the whole process. The same icon is only ever requested once at a time,
+// and every player waiting on it gets notified when it finishes. The amount of icons being decoded at once is capped to the CPU count.
+class IconLoadManager : public SingletonBase<IconLoadManager> {
+public:
+    IconLoadManager();
+
+    // Request the icons of the given types in `icons` for the player, calling `onFinishedLoadingIconAsync` once all of them are loaded.
+    // Replaces any earlier request from the same player. Returns false if all icons were already loaded,
+    // in which case nothing gets called.
+    bool request(ComplexVisualPlayer* player, const PlayerIconData& icons, PlayerIconTypeMask types = ALL_ICON_TYPES);
+
+    // Drop the pending request of a player, must be called before it gets destroyed
+    void cancel(ComplexVisualPlayer* player);
+
+private:
+    struct PendingIcon {
+        int iconId;
+        int iconType;
+        std::string sheetName;
+        std::vector<ComplexVisualPlayer*> waiters;
+    };
+
+    cocos2d::CCObject* target;
+    size_t maxInFlight;
+    size_t inFlight = 0;
+
+    // keyed by `GameManager::keyForIcon`
+    std::unordered_map<int, PendingIcon> pending;
+    std::deque<int> queued;
+    std::unordered_map<ComplexVisualPlayer*, size_t> remaining;
+
+    void startQueued();
+    void onLoaded(cocos2d::CCTexture2D* texture);
+
+    friend class IconLoadTarget;
+};
@@ -0,0 +1,59 @@
+#include "icon_thumbnails.hpp"
+
+using namespace geode::prelude;
+
+CCTexture2D* IconThumbnailCache::textureFor(const GlobedSimplePlayer::Icons& icons) {
+    uint64_t key = keyFor(icons);
+
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        if (it->second != lru.begin()) {
+            lru.splice(lru.begin(), lru, it->second);
+        }
+
+        return it->second->texture->getSprite()->getTexture();
+    }
+
+    auto* rt = this->render(icons);
+    if (!rt) return nullptr;
+
+    lru.emplace_front(Entry { key, rt });
+    cache.emplace(key, lru.begin());
+
+    while (cache.size() > CAPACITY) {
+        cache.erase(lru.back().key);
+        lru.pop_back();
+    }
+
+    return rt->getSprite()->getTexture();
+}
+
+void IconThumbnailCache::clear() {
+    cache.clear();
+    lru.clear();
+}
+
+uint64_t IconThumbnailCache::keyFor(const GlobedSimplePlayer::Icons& icons) {
+    return (static_cast<uint64_t>(icons.type) << 56)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(icons.id)) << 40)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(icons.color1)) << 24)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(icons.color2)) << 8)
+        | static_cast<uint8_t>(icons.color3); // -1 (no glow) becomes 0xff
+}
+
+CCRenderTexture* IconThumbnailCache::render(const GlobedSimplePlayer::Icons& icons) {
+    auto* player = GlobedSimplePlayer::create(icons);
+    if (!player) return nullptr;
+
+    auto size = player->getContentSize() + CCSize{PADDING * 2.f, PADDING * 2.f};
+    auto* rt = CCRenderTexture::create(static_cast<int>(std::ceil(size.width)), static_cast<int>(std::ceil(size.height)));
+    if (!rt) return nullptr;
+
+    player->setPosition({PADDING, PADDING});
+
+    rt->beginWithClear(0.f, 0.f, 0.f, 0.f);
+    player->visit();
+    rt->end();
+
+    return rt;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <list>
+
+#include <defs/geode.hpp>
+#include <ui/general/simple_player.hpp>
+#include <util/singleton.hpp>
+
+// Player icons rendered once into a texture, for list rows that would otherwise each build a full `GlobedSimplePlayer`.
+// Bounded, once it holds more than `CAPACITY` icons the least recently used ones are evicted.
+class IconThumbnailCache : public SingletonBase<IconThumbnailCache> {
+public:
+    static constexpr size_t CAPACITY = 256;
+    // room around the icon for the glow outline, in points
+    static constexpr float PADDING = 4.f;
+
+    // Returns the texture with the icon rendered into it, rendering it first if it's not cached.
+    // The texture is `PADDING` larger than the icon on each side, and upside down like any render texture.
+    cocos2d::CCTexture2D* textureFor(const GlobedSimplePlayer::Icons& icons);
+
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t key;
+        // the render texture itself is kept so it can restore its contents after the gl context is lost
+        geode::Ref<cocos2d::CCRenderTexture> texture;
+    };
+
+    // most recently used first
+    std::list<Entry> lru;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> cache;
+
+    static uint64_t keyFor(const GlobedSimplePlayer::Icons& icons);
+    cocos2d::CCRenderTexture* render(const GlobedSimplePlayer::Icons& icons);
+};
@@ -0,0 +1,111 @@
+#include "level_prefetch.hpp"
+
+#include <data/packets/client/game.hpp>
+#include <hooks/game_manager.hpp>
+#include <managers/profile_cache.hpp>
+#include <managers/settings.hpp>
+#include <net/manager.hpp>
+
+using namespace geode::prelude;
+
+// Calls `LevelPrefetchManager::update` on the main thread every second, to drop prefetched levels that were never opened
+class PrefetchExpiry : public CCObject {
+public:
+    static PrefetchExpiry& get() {
+        static PrefetchExpiry instance;
+        return instance;
+    }
+
+    void update(float) {
+        LevelPrefetchManager::get().update();
+    }
+
+private:
+    PrefetchExpiry() {
+        CCScheduler::get()->scheduleSelector(schedule_selector(PrefetchExpiry::update), this, 1.f, false);
+    }
+};
+
+LevelPrefetchManager::LevelPrefetchManager() {
+    PrefetchExpiry::get();
+}
+
+void LevelPrefetchManager::prefetch(LevelId levelId) {
+    auto& nm = NetworkManager::get();
+    if (levelId <= 0 || !nm.established() || GJBaseGameLayer::get() != nullptr) return;
+
+    pending = levelId;
+    prefetchedAt = util::time::now();
+
+    nm.send(LevelJoinPacket::create(levelId));
+    nm.send(RequestPlayerProfilesPacket::create(0));
+}
+
+bool LevelPrefetchManager::consume(LevelId levelId) {
+    if (pending == 0) return false;
+
+    if (pending != levelId) {
+        this->leave();
+        return false;
+    }
+
+    pending = 0;
+    return NetworkManager::get().established();
+}
+
+void LevelPrefetchManager::resync() {
+    if (pending == 0) return;
+
+    auto& nm = NetworkManager::get();
+    if (!nm.established()) return;
+
+    nm.send(LevelJoinPacket::create(pending));
+    nm.send(RequestPlayerProfilesPacket::create(0));
+}
+
+void LevelPrefetchManager::loadProfiles(const std::vector<PlayerAccountData>& players) {
+    auto* gm = static_cast<HookedGameManager*>(GameManager::get());
+    if (GlobedSettings::get().globed.demandLoadIcons && !gm->getAssetsPreloaded()) {
+        std::vector<PlayerIconData> icons;
+        icons.reserve(players.size());
+
+        for (const auto& player : players) {
+            icons.push_back(player.icons);
+        }
+
+        // everyone starts as a cube, the other gamemodes are loaded by the players once the level is known
+        gm->loadIconsFor(icons, iconTypeBit(PlayerIconType::Cube));
+    }
+
+    // death effects are only loaded once they're needed, start loading them now instead of when the player dies
+    auto& snapshot = GlobedSettings::get().snapshot();
+    if (snapshot.deathEffects && !snapshot.defaultDeathEffect) {
+        for (const auto& player : players) {
+            gm->prewarmDeathEffect(player.icons.deathEffect);
+        }
+    }
+
+    auto& pcm = ProfileCacheManager::get();
+    for (const auto& player : players) {
+        pcm.insert(player);
+    }
+}
+
+void LevelPrefetchManager::update() {
+    if (pending == 0 || util::time::now() - prefetchedAt < PREFETCH_TIMEOUT) return;
+
+    // the level is still loading, `consume` will be called soon
+    if (GJBaseGameLayer::get() != nullptr) return;
+
+    log::debug("prefetched level {} was never opened, leaving", pending);
+    this->leave();
+}
+
+void LevelPrefetchManager::leave() {
+    pending = 0;
+
+    auto& nm = NetworkManager::get();
+    if (nm.established()) {
+        nm.send(LevelLeavePacket::create());
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <data/types/gd.hpp>
+#include <util/singleton.hpp>
+#include <util/time.hpp>
+
+// Joins a level on the server as soon as the player presses play, instead of waiting for `GlobedGJBGL` to be set up.
+// Profiles, icons and death effects of the other players then load while the game is still loading the level itself,
+// and `GlobedGJBGL` picks up the join instead of sending its own.
+class LevelPrefetchManager : public SingletonBase<LevelPrefetchManager> {
+    friend class SingletonBase;
+    LevelPrefetchManager();
+
+public:
+    // if no level is opened within this time, e.g. because the level failed to download, we leave the level again
+    static constexpr auto PREFETCH_TIMEOUT = util::time::seconds(15);
+
+    // Join `levelId` and request the profiles of everyone on it. Does nothing if not connected or already inside of a level.
+    void prefetch(LevelId levelId);
+
+    // Returns whether `levelId` was already joined by `prefetch`. Clears the pending join either way,
+    // leaving the prefetched level if it's a different one.
+    bool consume(LevelId levelId);
+
+    // Join the pending level again, the server forgets it when the session is lost or a room is joined
+    void resync();
+
+    // Cache the received profiles and start loading their icons and death effects
+    void loadProfiles(const std::vector<PlayerAccountData>& players);
+
+private:
+    friend class PrefetchExpiry;
+
+    LevelId pending = 0;
+    util::time::time_point prefetchedAt;
+
+    void update();
+    void leave();
+};
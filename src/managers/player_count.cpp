@@ -0,0 +1,66 @@
+#include "player_count.hpp"
+
+#include <data/packets/client/general.hpp>
+#include <net/manager.hpp>
+
+using namespace geode::prelude;
+
+PlayerCountManager::Subscription::Subscription() : id(PlayerCountManager::get().nextId++) {}
+
+PlayerCountManager::Subscription::~Subscription() {
+    // layers can outlive the manager when the game is closing
+    if (!PlayerCountManager::destructed) {
+        this->clear();
+    }
+}
+
+void PlayerCountManager::Subscription::set(std::vector<LevelId> levelIds) {
+    PlayerCountManager::get().update(id, std::move(levelIds));
+}
+
+void PlayerCountManager::Subscription::clear() {
+    PlayerCountManager::get().remove(id);
+}
+
+void PlayerCountManager::resync() {
+    this->send(true);
+}
+
+void PlayerCountManager::update(uint32_t id, std::vector<LevelId>&& levelIds) {
+    auto& current = subscriptions[id];
+
+    // counts are only pushed when subscribing or when they change, and a new layer can subscribe to levels
+    // that another one already did (e.g. while replacing it), so it would never get the current counts otherwise
+    bool changed = current != levelIds;
+    current = std::move(levelIds);
+
+    this->send(changed);
+}
+
+void PlayerCountManager::remove(uint32_t id) {
+    if (subscriptions.erase(id)) {
+        this->send(false);
+    }
+}
+
+void PlayerCountManager::send(bool force) {
+    std::vector<LevelId> levels;
+    for (const auto& [_, ids] : subscriptions) {
+        levels.insert(levels.end(), ids.begin(), ids.end());
+    }
+
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+    if (levels.size() > SubscribePlayerCountsPacket::MAX_LEVELS) {
+        levels.resize(SubscribePlayerCountsPacket::MAX_LEVELS);
+    }
+
+    if (!force && levels == lastSent) return;
+
+    auto& nm = NetworkManager::get();
+    if (!nm.established() || !nm.serverMatchesProtocol()) return;
+
+    lastSent = levels;
+    nm.send(SubscribePlayerCountsPacket::create(std::move(levels)));
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <data/types/gd.hpp>
+#include <util/singleton.hpp>
+
+// Keeps track of which levels the open layers want player counts for, and subscribes to all of them at once.
+// The server then pushes `LevelPlayerCountPacket`s only when counts change, instead of every layer polling on a timer.
+class PlayerCountManager : public SingletonBase<PlayerCountManager> {
+public:
+    // Subscription owned by a layer, unsubscribes when destroyed. Meant to be stored in the `Fields` of a hook.
+    class Subscription {
+    public:
+        Subscription();
+        ~Subscription();
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        // Replace the levels of this subscription
+        void set(std::vector<LevelId> levelIds);
+        void clear();
+
+    private:
+        uint32_t id;
+    };
+
+    // Resend the subscribed levels, the server forgets them when the connection is lost
+    void resync();
+
+private:
+    friend class Subscription;
+
+    std::unordered_map<uint32_t, std::vector<LevelId>> subscriptions;
+    std::vector<LevelId> lastSent;
+    uint32_t nextId = 1;
+
+    void update(uint32_t id, std::vector<LevelId>&& levelIds);
+    void remove(uint32_t id);
+    void send(bool force);
+};
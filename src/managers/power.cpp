@@ -0,0 +1,55 @@
+#include "power.hpp"
+
+#include <managers/settings.hpp>
+#include <net/manager.hpp>
+
+using namespace geode::prelude;
+using util::power::PowerSource;
+
+// Calls `PowerManager::update` on the main thread, every `POLL_INTERVAL`
+class PowerPoller : public CCObject {
+public:
+    static PowerPoller& get() {
+        static PowerPoller instance;
+        return instance;
+    }
+
+    void update(float) {
+        PowerManager::get().update();
+    }
+
+private:
+    PowerPoller() {
+        auto interval = util::time::asMicros(PowerManager::POLL_INTERVAL) / 1'000'000.f;
+        CCScheduler::get()->scheduleSelector(schedule_selector(PowerPoller::update), this, interval, false);
+    }
+};
+
+PowerManager::PowerManager() {
+    this->update();
+    PowerPoller::get();
+}
+
+bool PowerManager::savingPower() const {
+    return saving;
+}
+
+void PowerManager::update() {
+    auto source = util::power::currentSource();
+
+    // an unknown source is treated as being plugged in, better to waste some battery than to lag for no reason
+    bool nowSaving = GlobedSettings::get().globed.batterySaver && source == PowerSource::Battery;
+    bool nowInLevel = GJBaseGameLayer::get() != nullptr;
+
+    if (nowSaving != saving) {
+        log::debug("power saving {} (power source: {})", nowSaving ? "enabled" : "disabled", source == PowerSource::Battery ? "battery" : "external");
+    }
+
+    if (nowSaving != saving || nowInLevel != inLevel) {
+        // in levels packets flow all the time anyway, only idle menus benefit from sleeping longer
+        NetworkManager::get().setLowPowerIdle(nowSaving && !nowInLevel);
+    }
+
+    saving = nowSaving;
+    inLevel = nowInLevel;
+}
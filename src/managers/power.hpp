@@ -0,0 +1,29 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <util/power.hpp>
+#include <util/singleton.hpp>
+#include <util/time.hpp>
+
+// Decides whether Globed should save power, which is when the `batterySaver` setting is enabled and the device runs on battery.
+// Polls the power source on the main thread and tells `NetworkManager` to idle more slowly while in menus.
+// In levels, `GlobedGJBGL` asks `savingPower` and lowers the send rate and voice decoding on its own.
+class PowerManager : public SingletonBase<PowerManager> {
+    friend class SingletonBase;
+    PowerManager();
+
+public:
+    // how often the power source is read from the OS
+    static constexpr auto POLL_INTERVAL = util::time::seconds(10);
+
+    // Whether power saving is on right now, based on the last poll
+    bool savingPower() const;
+
+private:
+    friend class PowerPoller;
+
+    bool saving = false;
+    bool inLevel = false;
+
+    void update();
+};
@@ -1,19 +1,160 @@
 #include "profile_cache.hpp"
 
+#include <data/bytebuffer.hpp>
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+static int64_t unixNow() {
+    return util::time::asSeconds(util::time::systemNow().time_since_epoch());
+}
+
+ProfileCacheManager::ProfileCacheManager() {
+    auto result = this->load();
+    if (result.isErr()) {
+        log::warn("Failed to load cached profiles: {}", result.unwrapErr());
+        this->clear();
+    }
+}
+
 void ProfileCacheManager::insert(const PlayerAccountData& data) {
-    cache[data.accountId] = data;
+    if (auto* entry = this->touch(data.accountId)) {
+        entry->fetchedAt = unixNow();
+
+        // re-requested profiles are usually the same as before
+        if (entry->data == data) return;
+
+        entry->data = data;
+        entry->version = nextVersion++;
+    } else {
+        lru.emplace_front(Entry { data, nextVersion++, unixNow() });
+        cache.emplace(data.accountId, lru.begin());
+        this->evict();
+    }
+
+    changes.push_back(data.accountId);
 }
 
 std::optional<PlayerAccountData> ProfileCacheManager::getData(int32_t accountId) {
-    if (cache.contains(accountId)) {
-        return cache.at(accountId);
+    if (auto* data = this->findData(accountId)) {
+        return *data;
     }
 
     return std::nullopt;
 }
 
+const PlayerAccountData* ProfileCacheManager::findData(int32_t accountId) {
+    auto* entry = this->touch(accountId);
+    return entry ? &entry->data : nullptr;
+}
+
 void ProfileCacheManager::clear() {
     cache.clear();
+    lru.clear();
+    changes.clear();
+}
+
+void ProfileCacheManager::setCapacity(size_t capacity) {
+    this->capacity = std::max<size_t>(capacity, 1);
+    this->evict();
+}
+
+size_t ProfileCacheManager::size() const {
+    return cache.size();
+}
+
+uint32_t ProfileCacheManager::getVersion(int32_t accountId) {
+    auto it = cache.find(accountId);
+    return it == cache.end() ? 0 : it->second->version;
+}
+
+bool ProfileCacheManager::isStale(int32_t accountId) {
+    auto it = cache.find(accountId);
+    return it != cache.end() && unixNow() - it->second->fetchedAt > STALE_AFTER;
+}
+
+std::filesystem::path ProfileCacheManager::storePath() {
+    return Mod::get()->getSaveDir() / "profiles.bin";
+}
+
+Result<> ProfileCacheManager::save() {
+    ByteBuffer bb;
+    bb.writeU32(FILE_MAGIC);
+    bb.writeU8(FILE_VERSION);
+    bb.writeU32(lru.size());
+
+    // most recently used first, so that `load` can restore the order by appending
+    for (const auto& entry : lru) {
+        bb.writeI64(entry.fetchedAt);
+        bb.writeValue(entry.data);
+    }
+
+    return geode::utils::file::writeBinary(this->storePath(), bb.data());
+}
+
+Result<> ProfileCacheManager::load() {
+    this->clear();
+
+    auto path = this->storePath();
+    if (!std::filesystem::exists(path)) return Ok();
+
+    GLOBED_UNWRAP_INTO(geode::utils::file::readBinary(path), auto data);
+
+    ByteBuffer bb(std::move(data));
+
+#define READ_OR_ERR(dest, expr) \
+    auto dest##R = expr; \
+    if (dest##R.isErr()) return Err(ByteBuffer::strerror(dest##R.unwrapErr())); \
+    auto dest = dest##R.unwrap();
+
+    READ_OR_ERR(magic, bb.readU32());
+    READ_OR_ERR(version, bb.readU8());
+
+    if (magic != FILE_MAGIC || version != FILE_VERSION) {
+        // written by an incompatible version, just start over
+        return Ok();
+    }
+
+    READ_OR_ERR(count, bb.readU32());
+
+    int64_t now = unixNow();
+
+    for (uint32_t i = 0; i < count && cache.size() < capacity; i++) {
+        READ_OR_ERR(fetchedAt, bb.readI64());
+        READ_OR_ERR(profile, bb.readValue<PlayerAccountData>());
+
+        if (now - fetchedAt > EXPIRE_AFTER || cache.contains(profile.accountId)) continue;
+
+        lru.emplace_back(Entry { std::move(profile), nextVersion++, fetchedAt });
+        cache.emplace(lru.back().data.accountId, std::prev(lru.end()));
+    }
+
+#undef READ_OR_ERR
+
+    return Ok();
+}
+
+std::vector<int32_t> ProfileCacheManager::takeChanges() {
+    return std::exchange(changes, {});
+}
+
+ProfileCacheManager::Entry* ProfileCacheManager::touch(int32_t accountId) {
+    auto it = cache.find(accountId);
+    if (it == cache.end()) return nullptr;
+
+    // move to the front, splicing doesn't invalidate any iterators
+    if (it->second != lru.begin()) {
+        lru.splice(lru.begin(), lru, it->second);
+    }
+
+    return &*it->second;
+}
+
+void ProfileCacheManager::evict() {
+    while (cache.size() > capacity) {
+        cache.erase(lru.back().data.accountId);
+        lru.pop_back();
+    }
 }
 
 void ProfileCacheManager::setOwnDataAuto() {
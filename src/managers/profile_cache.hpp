@@ -1,16 +1,55 @@
 #pragma once
 #include <asp/sync.hpp>
 
+#include <list>
+
 #include <defs/geode.hpp>
 #include <data/types/gd.hpp>
+#include <util/memory.hpp>
 #include <util/singleton.hpp>
 
+// Cache of the profiles of other players. Bounded, once it holds more than `capacity` profiles the least recently used ones are evicted.
+// Persisted to disk between sessions, see `save` and `load`.
 class ProfileCacheManager : public SingletonBase<ProfileCacheManager> {
+protected:
+    friend class SingletonBase;
+    ProfileCacheManager();
+
 public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    // profiles older than this are still shown, but refetched from the server
+    static constexpr int64_t STALE_AFTER = 6 * 60 * 60;
+    // profiles older than this are dropped when loading
+    static constexpr int64_t EXPIRE_AFTER = 30 * 24 * 60 * 60;
+
     void insert(const PlayerAccountData& data);
     std::optional<PlayerAccountData> getData(int32_t accountId);
+    // Like `getData` but without a copy. The pointer stays valid until the profile is evicted, which can only happen in `insert`, or `clear`.
+    const PlayerAccountData* findData(int32_t accountId);
     void clear();
 
+    // Sets the maximum amount of cached profiles, evicting the least recently used ones if needed
+    void setCapacity(size_t capacity);
+    size_t size() const;
+
+    // Every cached profile has a version that changes whenever `insert` actually changes it, 0 means it's not cached.
+    // Versions are never reused, even if a profile is evicted and then inserted again.
+    uint32_t getVersion(int32_t accountId);
+
+    // Whether the profile was fetched more than `STALE_AFTER` seconds ago, usually because it was loaded from disk.
+    // Profiles that are not cached are not considered stale.
+    bool isStale(int32_t accountId);
+
+    // Write all cached profiles to `profiles.bin` in the save directory
+    geode::Result<> save();
+    // Replace the cache with the profiles stored on disk, skipping expired ones
+    geode::Result<> load();
+
+    // Returns the account IDs whose profiles were added or changed since the last call.
+    // Meant for the level layer, which mirrors profiles onto remote players and shouldn't have to compare all of them.
+    std::vector<int32_t> takeChanges();
+
     // gather player's icons and call `setOwnData`;
     void setOwnDataAuto();
     void setOwnData(const PlayerIconData& data);
@@ -22,7 +61,30 @@ public:
     bool pendingChanges = false;
 
 private:
-    std::unordered_map<int32_t, PlayerAccountData> cache;
+    static constexpr uint32_t FILE_MAGIC = 0x47505243; // GPRC
+    static constexpr uint8_t FILE_VERSION = 1;
+
+    struct Entry {
+        PlayerAccountData data;
+        uint32_t version;
+        int64_t fetchedAt; // unix timestamp in seconds
+    };
+
+    using EntryList = std::list<Entry, util::memory::TrackingAllocator<Entry, util::memory::MemoryTag::ProfileCache>>;
+
+    // most recently used first, list nodes never move so pointers into them stay valid
+    EntryList lru;
+    std::unordered_map<
+        int32_t, EntryList::iterator, std::hash<int32_t>, std::equal_to<int32_t>,
+        util::memory::TrackingAllocator<std::pair<const int32_t, EntryList::iterator>, util::memory::MemoryTag::ProfileCache>
+    > cache;
+    size_t capacity = DEFAULT_CAPACITY;
+    uint32_t nextVersion = 1;
+    std::vector<int32_t> changes;
+
+    Entry* touch(int32_t accountId);
+    std::filesystem::path storePath();
+    void evict();
     PlayerAccountData ownData;
     SpecialUserData ownSpecialData;
 };
\ No newline at end of file
@@ -1,15 +1,22 @@
 #include "role.hpp"
 
+#include <util/cocos.hpp>
+
+using namespace geode::prelude;
+
 void RoleManager::setAllRoles(std::vector<GameServerRole>&& allRoles) {
     this->allRoles = std::move(allRoles);
+    displayCache.clear();
 }
 
 void RoleManager::setAllRoles(const std::vector<GameServerRole>& allRoles) {
     this->allRoles = allRoles;
+    displayCache.clear();
 }
 
 void RoleManager::clearAllRoles() {
     allRoles.clear();
+    displayCache.clear();
 }
 
 std::vector<GameServerRole>& RoleManager::getAllRoles() {
@@ -53,4 +60,31 @@ ComputedRole RoleManager::compute(const std::vector<uint8_t>& roles) {
     }
 
     return computed;
-}
\ No newline at end of file
+}
+// The badge icon can name a sprite of ours or one of the game, resolving it once means creating a badge is a single lookup
+static std::string resolveBadgeFrame(const std::string& icon) {
+    auto* cache = CCSpriteFrameCache::sharedSpriteFrameCache();
+
+    if (!icon.empty()) {
+        auto ours = util::cocos::spr(icon);
+        if (cache->spriteFrameByName(ours.c_str())) return ours;
+        if (cache->spriteFrameByName(icon.c_str())) return icon;
+    }
+
+    return util::cocos::spr("button-secret.png");
+}
+
+const RoleManager::DisplayRole& RoleManager::getDisplay(const std::vector<uint8_t>& roles) {
+    auto it = displayCache.find(roles);
+    if (it != displayCache.end()) return it->second;
+
+    auto computed = this->compute(roles);
+
+    DisplayRole display = {
+        .badgeFrame = resolveBadgeFrame(computed.badgeIcon),
+        .nameColor = computed.nameColor.value_or(RichColor(ccc3(255, 255, 255))),
+    };
+    display.computed = std::move(computed);
+
+    return displayCache.emplace(roles, std::move(display)).first->second;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include <data/types/user.hpp>
 
 #include <util/singleton.hpp>
@@ -8,12 +10,25 @@ class RoleManager : public SingletonBase<RoleManager> {
     friend class SingletonBase;
 
 public:
+    // What name labels, chat and user cells show for a set of roles
+    struct DisplayRole {
+        ComputedRole computed;
+        std::string badgeFrame; // sprite frame that exists, with the fallbacks of `util::ui::createBadge` already applied
+        RichColor nameColor;
+    };
+
     void setAllRoles(std::vector<GameServerRole>&& allRoles);
     void setAllRoles(const std::vector<GameServerRole>& allRoles);
     void clearAllRoles();
     std::vector<GameServerRole>& getAllRoles();
     ComputedRole compute(const std::vector<uint8_t>& roles);
 
+    // Same as `compute`, but cached per set of roles until the server sends new role definitions. Main thread only.
+    const DisplayRole& getDisplay(const std::vector<uint8_t>& roles);
+
 private:
     std::vector<GameServerRole> allRoles;
+    // keyed by the role IDs rather than by account, so every user with the same roles shares an entry
+    // and a user whose roles change simply maps to another one
+    std::map<std::vector<uint8_t>, DisplayRole> displayCache;
 };
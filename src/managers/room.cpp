@@ -1,5 +1,7 @@
 #include "room.hpp"
 
+#include <algorithm>
+
 RoomManager::RoomManager() {
     this->setGlobal();
 }
@@ -25,6 +27,12 @@ bool RoomManager::isInRoom() {
 }
 
 void RoomManager::setInfo(const RoomInfo& info) {
+    // the player list belongs to the previous room
+    if (info.id != roomInfo.id) {
+        players.clear();
+        playersVersion.reset();
+    }
+
     roomInfo = info;
 }
 
@@ -35,3 +43,47 @@ void RoomManager::setGlobal() {
         .settings = {}
     });
 }
+
+const std::vector<PlayerRoomPreviewAccountData>& RoomManager::getPlayers() {
+    return players;
+}
+
+void RoomManager::setPlayers(uint32_t version, std::vector<PlayerRoomPreviewAccountData> players) {
+    this->players = std::move(players);
+    playersVersion = version;
+}
+
+RoomManager::DiffResult RoomManager::applyDiff(uint32_t version, const std::vector<PlayerRoomPreviewAccountData>& updated, const std::vector<int32_t>& removed) {
+    if (!playersVersion) return DiffResult::Gap;
+
+    // signed distance, so that the version wrapping around still counts as newer
+    int32_t distance = static_cast<int32_t>(version - playersVersion.value());
+    if (distance <= 0) return DiffResult::Outdated;
+    if (distance != 1) {
+        // the list can't be trusted anymore
+        playersVersion.reset();
+        return DiffResult::Gap;
+    }
+
+    for (int32_t accountId : removed) {
+        std::erase_if(players, [accountId](const auto& player) {
+            return player.accountId == accountId;
+        });
+    }
+
+    for (const auto& player : updated) {
+        auto it = std::find_if(players.begin(), players.end(), [&player](const auto& p) {
+            return p.accountId == player.accountId;
+        });
+
+        if (it == players.end()) {
+            players.push_back(player);
+        } else {
+            *it = player;
+        }
+    }
+
+    playersVersion = version;
+
+    return DiffResult::Applied;
+}
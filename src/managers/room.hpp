@@ -2,6 +2,7 @@
 #include <asp/sync.hpp>
 
 #include <data/types/room.hpp>
+#include <data/types/gd.hpp>
 
 #include <util/singleton.hpp>
 
@@ -10,6 +11,15 @@ class RoomManager : public SingletonBase<RoomManager> {
     RoomManager();
 
 public:
+    enum class DiffResult {
+        // the diff was applied to the player list
+        Applied,
+        // the diff is older than the player list, nothing changed
+        Outdated,
+        // a diff was missed (or there is no player list yet), the full list has to be requested again
+        Gap,
+    };
+
     RoomInfo& getInfo();
     uint32_t getId();
 
@@ -22,6 +32,14 @@ public:
     void setInfo(const RoomInfo& info);
     void setGlobal();
 
+    // Players in the current room, as of the last full list plus every diff since then
+    const std::vector<PlayerRoomPreviewAccountData>& getPlayers();
+    void setPlayers(uint32_t version, std::vector<PlayerRoomPreviewAccountData> players);
+    DiffResult applyDiff(uint32_t version, const std::vector<PlayerRoomPreviewAccountData>& updated, const std::vector<int32_t>& removed);
+
 private:
     RoomInfo roomInfo;
-};
\ No newline at end of file
+    std::vector<PlayerRoomPreviewAccountData> players;
+    // version of `players`, `std::nullopt` if there is no list for the current room yet
+    std::optional<uint32_t> playersVersion;
+};
@@ -4,8 +4,59 @@
 
 using namespace geode::prelude;
 
+// Save container key of a setting, built at compile time from the describe names of its category (`CatD`) and itself (`SetD`).
+// Flags are stored as `_gflag-<name>`, everything else as `_gsetting-<category><name>`.
+template <typename CatD, typename SetD>
+struct SettingKey {
+    static constexpr std::string_view category = CatD::name;
+    static constexpr std::string_view setting = SetD::name;
+    static constexpr bool IsFlag = category == "flags";
+
+    static constexpr std::string_view prefix = IsFlag ? "_gflag-" : "_gsetting-";
+    static constexpr size_t Length = prefix.size() + (IsFlag ? 0 : category.size()) + setting.size();
+
+    static constexpr auto storage = [] {
+        std::array<char, Length + 1> out{};
+        size_t pos = 0;
+
+        auto append = [&](std::string_view part) {
+            for (char c : part) out[pos++] = c;
+        };
+
+        append(prefix);
+        if (!IsFlag) append(category);
+        append(setting);
+
+        return out;
+    }();
+
+    static constexpr std::string_view value{storage.data(), Length};
+};
+
+// Polls on the main thread and calls `flushIfIdle`, so that `scheduleFlush` can be called from anywhere
+// while the save container is only ever touched from the main thread.
+class SettingsFlusher : public CCObject {
+public:
+    static SettingsFlusher& get() {
+        static SettingsFlusher instance;
+        return instance;
+    }
+
+    void update(float) {
+        GlobedSettings::get().flushIfIdle();
+    }
+
+private:
+    SettingsFlusher() {
+        CCScheduler::get()->scheduleSelector(
+            schedule_selector(SettingsFlusher::update), this, GlobedSettings::FLUSH_DELAY / 2.f, false
+        );
+    }
+};
+
 GlobedSettings::GlobedSettings() {
     this->reload();
+    SettingsFlusher::get();
 }
 
 void GlobedSettings::reflect(TaskType taskType) {
@@ -14,10 +65,9 @@ void GlobedSettings::reflect(TaskType taskType) {
     // iterate through all categories
     boost::mp11::mp_for_each<SetMd>([&, this](auto cd) -> void {
         using CatType = typename util::misc::MemberPtrToUnderlying<decltype(cd.pointer)>::type;
-        auto catName = cd.name;
 
         auto& category = this->*cd.pointer;
-        bool isFlag = std::string_view(catName) == "flags";
+        constexpr bool isFlag = std::string_view(decltype(cd)::name) == "flags";
 
         // iterate through all settings in the category
         using CatMd = boost::describe::describe_members<CatType, boost::describe::mod_public>;
@@ -26,14 +76,7 @@ void GlobedSettings::reflect(TaskType taskType) {
             using InnerType = SetTy::Type;
             constexpr InnerType Default = SetTy::Default;
 
-            auto setName = setd.name;
-
-            std::string settingKey;
-            if (isFlag) {
-                settingKey = fmt::format("_gflag-{}", setName);
-            } else {
-                settingKey = fmt::format("_gsetting-{}{}", catName, setName);
-            }
+            constexpr std::string_view settingKey = SettingKey<decltype(cd), decltype(setd)>::value;
 
             auto& setting = category.*setd.pointer;
 
@@ -43,9 +86,18 @@ void GlobedSettings::reflect(TaskType taskType) {
                     if (this->has(settingKey) || setting.get() != Default || isFlag) {
                         this->store(settingKey, setting.get());
                     }
+
+                    setting.clearDirty();
+                } break;
+                case TaskType::FlushSettings: {
+                    if (setting.isDirty()) {
+                        this->store(settingKey, setting.get());
+                        setting.clearDirty();
+                    }
                 } break;
                 case TaskType::LoadSettings: {
                     this->loadOptionalInto(settingKey, setting.ref());
+                    setting.clearDirty();
                 } break;
                 case TaskType::ResetSettings: {
                     // flags cant be cleared unless hard resetting
@@ -53,6 +105,7 @@ void GlobedSettings::reflect(TaskType taskType) {
                 } [[fallthrough]];
                 case TaskType::HardResetSettings: {
                     setting.set(Default);
+                    setting.clearDirty();
                     this->clear(settingKey);
                 } break;
             }
@@ -62,20 +115,73 @@ void GlobedSettings::reflect(TaskType taskType) {
 
 void GlobedSettings::hardReset() {
     this->reflect(TaskType::HardResetSettings);
+    this->refreshSnapshot();
 }
 
 void GlobedSettings::reset() {
     this->reflect(TaskType::ResetSettings);
+    this->refreshSnapshot();
 }
 
 void GlobedSettings::reload() {
     this->reflect(TaskType::LoadSettings);
+    this->refreshSnapshot();
+}
+
+void GlobedSettings::refreshSnapshot() {
+    // write into the slot that isn't published, then swap it in
+    auto* next = currentSnapshot.load(std::memory_order_relaxed) == &snapshots[0] ? &snapshots[1] : &snapshots[0];
+
+    next->playerOpacity = players.playerOpacity.get();
+    next->nameOpacity = players.nameOpacity.get();
+    next->voiceVolume = communication.voiceVolume.get();
+    next->crowdModeThreshold = players.crowdModeThreshold.get();
+    next->frameBudget = globed.frameBudget.get();
+
+    next->overlayEnabled = overlay.enabled.get();
+    next->showNames = players.showNames.get();
+    next->dualName = players.dualName.get();
+    next->statusIcons = players.statusIcons.get();
+    next->deathEffects = players.deathEffects.get();
+    next->defaultDeathEffect = players.defaultDeathEffect.get();
+    next->hideNearby = players.hideNearby.get();
+    next->forceVisibility = players.forceVisibility.get();
+    next->hidePracticePlayers = players.hidePracticePlayers.get();
+    next->progressIndicators = levelUi.progressIndicators.get();
+    next->voiceEnabled = communication.voiceEnabled.get();
+    next->voicePanning = communication.voicePanning.get();
+    next->onlyFriends = communication.onlyFriends.get();
+
+    currentSnapshot.store(next, std::memory_order_release);
 }
 
 void GlobedSettings::save() {
+    flushPending = false;
     this->reflect(TaskType::SaveSettings);
 }
 
+void GlobedSettings::flush() {
+    if (!flushPending.exchange(false)) return;
+
+    this->reflect(TaskType::FlushSettings);
+}
+
+void GlobedSettings::scheduleFlush() {
+    this->refreshSnapshot();
+
+    lastChange = util::time::now();
+    flushPending = true;
+}
+
+void GlobedSettings::flushIfIdle() {
+    if (!flushPending) return;
+
+    auto idle = chrono::duration<float>(util::time::now() - lastChange.load()).count();
+    if (idle < FLUSH_DELAY) return;
+
+    this->flush();
+}
+
 bool GlobedSettings::has(std::string_view key) {
     return Mod::get()->hasSavedValue(key);
 }
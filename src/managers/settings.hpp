@@ -1,10 +1,40 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include <defs/geode.hpp>
 #include <defs/util.hpp>
 #include <data/basic.hpp>
 
 #include <util/singleton.hpp>
+#include <util/time.hpp>
+
+// Plain copy of the settings that are read every frame or per player, so hot loops don't go through the `Setting` wrappers.
+// Rebuilt whenever a setting changes, see `GlobedSettings::snapshot()`.
+struct alignas(64) SettingsSnapshot {
+    float playerOpacity;
+    float nameOpacity;
+    float voiceVolume;
+    int crowdModeThreshold;
+    int frameBudget; // microseconds
+
+    bool overlayEnabled;
+    bool showNames;
+    bool dualName;
+    bool statusIcons;
+    bool deathEffects;
+    bool defaultDeathEffect;
+    bool hideNearby;
+    bool forceVisibility;
+    bool hidePracticePlayers;
+    bool progressIndicators;
+    bool voiceEnabled;
+    bool voicePanning;
+    bool onlyFriends;
+};
+
+static_assert(sizeof(SettingsSnapshot) == 64, "SettingsSnapshot should fit in a single cache line");
 
 class GlobedSettings : public SingletonBase<GlobedSettings> {
     friend class SingletonBase;
@@ -14,6 +44,20 @@ public:
     // Save all settings to the geode save container
     void save();
 
+    // Write only the settings that changed since the last save or flush
+    void flush();
+
+    // Request a `flush()` once settings stop changing for `FLUSH_DELAY` seconds. Safe to call repeatedly, e.g. from a slider callback.
+    void scheduleFlush();
+
+    static constexpr float FLUSH_DELAY = 0.5f;
+
+    // Latest snapshot of the hot settings. Cheap to call, but don't hold onto the reference across frames,
+    // it may be overwritten after two more settings changes.
+    const SettingsSnapshot& snapshot() const {
+        return *currentSnapshot.load(std::memory_order_acquire);
+    }
+
     template <typename T>
     using TypeFixup = std::conditional_t<std::is_same_v<T, float>, globed::ConstexprFloat, T>;
 
@@ -70,12 +114,32 @@ public:
 
         Setting& operator=(const Type& other) {
             value = other;
-            GlobedSettings::get().save();
+            this->markDirty();
             return *this;
         }
 
+        // Marks the setting as changed, it will be written by the next flush
+        void markDirty() {
+            dirty = true;
+            GlobedSettings::get().scheduleFlush();
+        }
+
+        bool isDirty() const {
+            return dirty;
+        }
+
+        void clearDirty() {
+            dirty = false;
+        }
+
+        // For code that writes through `ref()` directly, so it can mark the setting changed afterwards
+        bool* dirtyRef() {
+            return &dirty;
+        }
+
     protected:
         InnerTy value;
+        bool dirty = false;
     };
 
     template <
@@ -114,7 +178,7 @@ public:
 
         LimitedSetting& operator=(const Type& other) {
             this->set(other);
-            GlobedSettings::get().save();
+            this->markDirty();
             return *this;
         }
 
@@ -143,11 +207,15 @@ public:
         LimitedSetting<int, 0, 0, 240> tpsCap;
         Setting<bool, true> preloadAssets;
         Setting<bool, false> deferPreloadAssets;
+        Setting<bool, false> demandLoadIcons;
         LimitedSetting<int, (int)InvitesFrom::Friends, 0, 2> invitesFrom;
         Setting<bool, false> increaseLevelList;
         Setting<int, 60000> fragmentationLimit;
         Setting<bool, false> compressedPlayerCount;
         Setting<bool, true> useDiscordRPC;
+        LimitedSetting<int, 2000, 0, 16000> frameBudget; // microseconds per frame, 0 disables the watchdog
+        Setting<bool, false> lowLatencySockets;
+        Setting<bool, true> batterySaver;
     };
 
     struct Overlay {
@@ -155,6 +223,8 @@ public:
         LimitedSetting<float, 0.3f, 0.f, 1.f> opacity;
         Setting<bool, true> hideConditionally;
         LimitedSetting<int, 3, 0, 3> position; // 0-3 topleft, topright, bottomleft, bottomright
+        Setting<bool, false> networkStats;
+        Setting<bool, false> detailedStats;
     };
 
     struct Communication {
@@ -164,9 +234,12 @@ public:
         LimitedSetting<float, 1.0f, 0.f, 2.f> voiceVolume;
         Setting<bool, false> onlyFriends;
         Setting<bool, true> lowerAudioLatency;
+        Setting<bool, false> voiceMixer;
+        Setting<bool, true> voiceActivityDetection;
+        Setting<bool, true> voicePanning;
         Setting<int, 0> audioDevice;
         Setting<bool, true> deafenNotification;
-        Setting<bool, false> voiceLoopback; // TODO unimpl
+        Setting<bool, false> voiceLoopback;
     };
 
     struct LevelUI {
@@ -180,6 +253,7 @@ public:
         LimitedSetting<float, 1.0f, 0.f, 1.f> playerOpacity;
         Setting<bool, true> showNames;
         Setting<bool, true> dualName;
+        Setting<bool, false> batchedNames;
         LimitedSetting<float, 1.0f, 0.f, 1.f> nameOpacity;
         Setting<bool, true> statusIcons;
         Setting<bool, true> deathEffects;
@@ -188,6 +262,10 @@ public:
         Setting<bool, false> forceVisibility;
         Setting<bool, false> ownName;
         Setting<bool, false> hidePracticePlayers;
+        Setting<bool, false> extrapolation;
+        Setting<bool, true> linkedExtrapolation;
+        Setting<bool, false> cubicInterpolation;
+        LimitedSetting<int, 50, 0, 1000> crowdModeThreshold; // 0 disables crowd mode
     };
 
     struct Advanced {};
@@ -223,11 +301,25 @@ public:
     void reload();
 
     enum class TaskType {
-        SaveSettings, LoadSettings, ResetSettings, HardResetSettings
+        SaveSettings, FlushSettings, LoadSettings, ResetSettings, HardResetSettings
     };
 
     void reflect(TaskType type);
 
+private:
+    std::atomic<bool> flushPending = false;
+    std::atomic<util::time::time_point> lastChange;
+
+    std::array<SettingsSnapshot, 2> snapshots{};
+    std::atomic<const SettingsSnapshot*> currentSnapshot = &snapshots[0];
+
+    void refreshSnapshot();
+
+    friend class SettingsFlusher;
+    void flushIfIdle();
+
+public:
+
     bool has(std::string_view key);
     void clear(std::string_view key);
 
@@ -263,15 +355,15 @@ public:
 /* Enable reflection */
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Globed, (
-    autoconnect, tpsCap, preloadAssets, deferPreloadAssets, increaseLevelList, fragmentationLimit, compressedPlayerCount, useDiscordRPC
+    autoconnect, tpsCap, preloadAssets, deferPreloadAssets, demandLoadIcons, increaseLevelList, fragmentationLimit, compressedPlayerCount, useDiscordRPC, frameBudget, lowLatencySockets, batterySaver
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Overlay, (
-    enabled, opacity, hideConditionally, position
+    enabled, opacity, hideConditionally, position, networkStats, detailedStats
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Communication, (
-    voiceEnabled, voiceProximity, classicProximity, voiceVolume, onlyFriends, lowerAudioLatency, deafenNotification, voiceLoopback
+    voiceEnabled, voiceProximity, classicProximity, voiceVolume, onlyFriends, lowerAudioLatency, voiceMixer, voiceActivityDetection, voicePanning, deafenNotification, voiceLoopback
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::LevelUI, (
@@ -279,7 +371,7 @@ GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::LevelUI, (
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Players, (
-    playerOpacity, showNames, dualName, nameOpacity, statusIcons, deathEffects, defaultDeathEffect, hideNearby, forceVisibility, ownName, hidePracticePlayers
+    playerOpacity, showNames, dualName, batchedNames, nameOpacity, statusIcons, deathEffects, defaultDeathEffect, hideNearby, forceVisibility, ownName, hidePracticePlayers, extrapolation, linkedExtrapolation, cubicInterpolation, crowdModeThreshold
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Advanced, ());
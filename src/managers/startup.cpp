@@ -0,0 +1,234 @@
+#include "startup.hpp"
+
+#include <managers/account.hpp>
+#include <managers/central_server.hpp>
+#include <managers/error_queues.hpp>
+#include <managers/game_server.hpp>
+#include <managers/settings.hpp>
+#include <net/manager.hpp>
+#include <util/format.hpp>
+
+using namespace geode::prelude;
+
+void StartupManager::begin() {
+    if (started) return;
+    started = true;
+    beganAt = util::time::now();
+
+    auto& csm = CentralServerManager::get();
+    auto& gsm = GameServerManager::get();
+    auto& am = GlobedAccountManager::get();
+
+    bool standalone = csm.standalone();
+
+    if (standalone) {
+        this->skip(Stage::ServerList);
+        this->skip(Stage::Ping);
+    } else {
+        // the cached list is usually still correct, so autoconnect doesn't have to wait for the fresh one
+        auto cacheResult = gsm.loadFromCache();
+        if (cacheResult.isErr()) {
+            log::debug("startup: no usable cached server list: {}", cacheResult.unwrapErr());
+        }
+
+        haveServerList = cacheResult.isOk() && gsm.count() > 0;
+    }
+
+    auto lastId = gsm.loadLastConnected();
+    if (GlobedSettings::get().globed.autoconnect && !lastId.empty()) {
+        am.autoInitialize();
+
+        // no authkey, don't autoconnect
+        if (standalone || am.hasAuthKey()) {
+            autoconnectServer = std::move(lastId);
+        }
+    }
+
+    if (standalone || autoconnectServer.empty()) {
+        this->skip(Stage::AuthToken);
+    }
+
+    if (autoconnectServer.empty()) {
+        this->skip(Stage::Connect);
+    }
+
+    this->advance();
+}
+
+bool StartupManager::isFinished(Stage stage) {
+    auto state = this->info(stage).state;
+    return state == StageState::Done || state == StageState::Skipped;
+}
+
+util::time::micros StartupManager::stageDuration(Stage stage) {
+    return this->info(stage).took;
+}
+
+StartupManager::StageInfo& StartupManager::info(Stage stage) {
+    return stages[static_cast<size_t>(stage)];
+}
+
+bool StartupManager::canStart(Stage stage) {
+    switch (stage) {
+        case Stage::ServerList: return true;
+        case Stage::AuthToken: return true;
+        case Stage::Ping: return this->isFinished(Stage::ServerList) && haveServerList;
+        case Stage::Connect: return this->isFinished(Stage::AuthToken) && (haveServerList || this->isFinished(Stage::ServerList));
+    }
+
+    return false;
+}
+
+void StartupManager::start(Stage stage) {
+    auto& si = this->info(stage);
+    si.state = StageState::Running;
+    si.startedAt = util::time::now();
+
+    switch (stage) {
+        case Stage::ServerList: this->runServerList(); break;
+        case Stage::AuthToken: this->runAuthToken(); break;
+        case Stage::Ping: this->runPing(); break;
+        case Stage::Connect: this->runConnect(); break;
+    }
+}
+
+void StartupManager::finish(Stage stage) {
+    auto& si = this->info(stage);
+    if (si.state != StageState::Running) return;
+
+    si.state = StageState::Done;
+    si.took = util::time::as<util::time::micros>(util::time::now() - si.startedAt);
+
+    log::debug("startup: {} finished in {}", stageName(stage), util::format::formatDuration(si.took));
+
+    this->advance();
+}
+
+void StartupManager::skip(Stage stage) {
+    auto& si = this->info(stage);
+    if (si.state != StageState::Pending) return;
+
+    si.state = StageState::Skipped;
+}
+
+void StartupManager::advance() {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        auto stage = static_cast<Stage>(i);
+
+        // `start` can finish a stage right away and call back into `advance`, so check the state again every time
+        if (this->info(stage).state == StageState::Pending && this->canStart(stage)) {
+            this->start(stage);
+        }
+    }
+
+    // a stage whose dependencies can no longer be satisfied gets skipped, so that the summary below is still logged
+    if (this->isFinished(Stage::ServerList) && !haveServerList) {
+        this->skip(Stage::Ping);
+        if (this->isFinished(Stage::AuthToken)) this->skip(Stage::Connect);
+    }
+
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        if (!this->isFinished(static_cast<Stage>(i))) return;
+    }
+
+    if (!reported) {
+        reported = true;
+        log::info("Startup tasks finished in {}", util::format::formatDuration(util::time::now() - beganAt));
+    }
+}
+
+void StartupManager::runServerList() {
+    auto request = WebRequestManager::get().fetchServers();
+
+    serversListener.bind(this, &StartupManager::onServersFetched);
+    serversListener.setFilter(std::move(request));
+}
+
+void StartupManager::onServersFetched(WebRequestManager::Event* event) {
+    if (!event || !event->getValue()) return;
+
+    auto result = std::move(*event->getValue());
+
+    if (result.isErr()) {
+        // not shown to the user here, the servers layer retries and reports it
+        log::warn("startup: failed to fetch servers: {}", util::format::webError(result.unwrapErr()));
+        this->finish(Stage::ServerList);
+        return;
+    }
+
+    auto response = result.unwrap();
+
+    auto& gsm = GameServerManager::get();
+    if (!gsm.isCached(response) || gsm.count() == 0) {
+        gsm.updateCache(response);
+        auto loadResult = gsm.loadFromCache();
+        gsm.pendingChanges = true;
+
+        if (loadResult.isErr()) {
+            log::warn("startup: failed to parse server list: {}", loadResult.unwrapErr());
+        }
+    }
+
+    haveServerList = gsm.count() > 0;
+
+    this->finish(Stage::ServerList);
+}
+
+void StartupManager::runAuthToken() {
+    auto& am = GlobedAccountManager::get();
+
+    // the token saved last session is usually still good, then the connection doesn't wait on the central server at all
+    if (am.hasFreshAuthToken()) {
+        this->finish(Stage::AuthToken);
+        return;
+    }
+
+    // on failure the callback is never called and an error is shown, so there is nothing to connect with either
+    am.requestAuthToken([this] {
+        this->finish(Stage::AuthToken);
+    });
+}
+
+void StartupManager::runPing() {
+    NetworkManager::get().pingServers();
+    this->finish(Stage::Ping);
+}
+
+void StartupManager::runConnect() {
+    auto& nm = NetworkManager::get();
+
+    Result<> result = Ok();
+
+    if (CentralServerManager::get().standalone()) {
+        result = nm.connectStandalone();
+    } else {
+        auto server = GameServerManager::get().getServer(autoconnectServer);
+
+        if (!server.has_value()) {
+            ErrorQueues::get().debugWarn("failed to autoconnect, game server not found");
+            this->finish(Stage::Connect);
+            return;
+        }
+
+        result = nm.connect(server.value());
+    }
+
+    if (result.isErr()) {
+        ErrorQueues::get().warn(fmt::format("Failed to connect: {}", result.unwrapErr()));
+    } else {
+        log::info("Autoconnecting to {} after {}", autoconnectServer, util::format::formatDuration(util::time::now() - beganAt));
+    }
+
+    this->finish(Stage::Connect);
+}
+
+const char* StartupManager::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::ServerList: return "server list";
+        case Stage::AuthToken: return "auth token";
+        case Stage::Ping: return "ping";
+        case Stage::Connect: return "connect";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <defs/geode.hpp>
+#include <array>
+
+#include <managers/web.hpp>
+#include <util/singleton.hpp>
+#include <util/time.hpp>
+
+// Runs the network side of the launch as a small task graph, so that independent stages run at the same time
+// (and alongside asset preloading) instead of one after another once the main menu opens.
+//
+//   ServerList ──────────── Ping
+//   AuthToken ──┬────────── Connect
+//   ServerList ─┘ (the cached list is enough)
+class StartupManager : public SingletonBase<StartupManager> {
+protected:
+    friend class SingletonBase;
+    StartupManager() = default;
+
+public:
+    enum class Stage {
+        ServerList,
+        AuthToken,
+        Ping,
+        Connect,
+    };
+
+    static constexpr size_t STAGE_COUNT = 4;
+
+    // Starts every stage that has nothing to wait for. Only the first call does anything, must be called on the main thread.
+    void begin();
+
+    // Whether the stage has finished or was skipped
+    bool isFinished(Stage stage);
+    // How long the stage took, zero if it was skipped or is still running
+    util::time::micros stageDuration(Stage stage);
+
+private:
+    enum class StageState {
+        Pending,
+        Running,
+        Done,
+        Skipped,
+    };
+
+    struct StageInfo {
+        StageState state = StageState::Pending;
+        util::time::time_point startedAt;
+        util::time::micros took{};
+    };
+
+    std::array<StageInfo, STAGE_COUNT> stages;
+    bool started = false;
+    bool reported = false;
+    util::time::time_point beganAt;
+
+    // whether `GameServerManager` has a server list, either from the cache or freshly fetched
+    bool haveServerList = false;
+    // server to autoconnect to, empty if autoconnect is disabled or not possible
+    std::string autoconnectServer;
+
+    WebRequestManager::Listener serversListener;
+
+    StageInfo& info(Stage stage);
+    bool canStart(Stage stage);
+    void start(Stage stage);
+    void finish(Stage stage);
+    void skip(Stage stage);
+    // starts every pending stage whose dependencies have finished
+    void advance();
+
+    void runServerList();
+    void runAuthToken();
+    void runPing();
+    void runConnect();
+
+    void onServersFetched(WebRequestManager::Event* event);
+
+    static const char* stageName(Stage stage);
+};
@@ -33,27 +33,38 @@ static std::string makeCentralUrl(std::string_view suffix) {
     return makeUrl(active->url, suffix);
 }
 
-static RequestTask mapTask(web::WebTask&& param) {
-    return param.map([] (web::WebResponse* response) -> Result<std::string, WebRequestError> {
-        int code = response->code();
+static Result<std::string, WebRequestError> mapResponse(web::WebResponse* response) {
+    int code = response->code();
 
-        if (!response->ok()) {
-            auto data = response->string().unwrapOr("failed to parse response as a string");
-            return Err(WebRequestError(code, data));
-        }
+    if (!response->ok()) {
+        auto data = response->string().unwrapOr("failed to parse response as a string");
+        return Err(WebRequestError(code, data));
+    }
 
-        auto strResult = response->string();
-        if (!strResult) {
-            return Err(WebRequestError(code, "failed to parse response as a string"));
-        }
+    auto strResult = response->string();
+    if (!strResult) {
+        return Err(WebRequestError(code, "failed to parse response as a string"));
+    }
 
-        auto resp = strResult.unwrap();
-        return Ok(resp);
-    }, [](auto) -> std::monostate {
+    auto resp = strResult.unwrap();
+    return Ok(resp);
+}
+
+static RequestTask mapTask(web::WebTask&& param) {
+    return param.map(&mapResponse, [](auto) -> std::monostate {
         return {};
     });
 }
 
+static web::WebRequest makeRequest(int timeoutS) {
+    return web::WebRequest()
+#ifdef GLOBED_DEBUG
+        .certVerification(false)
+#endif
+        .userAgent(util::net::webUserAgent())
+        .timeout(util::time::seconds(timeoutS));
+}
+
 RequestTask WebRequestManager::requestAuthToken() {
     auto& gam = GlobedAccountManager::get();
 
@@ -76,12 +87,21 @@ RequestTask WebRequestManager::testServer(std::string_view url) {
     return this->get(makeUrl(url, "version"), 5);
 }
 
+static constexpr std::string_view CREDITS_URL = "https://credits.globed.dev/credits";
+
 RequestTask WebRequestManager::fetchCredits() {
-    return this->get("https://credits.globed.dev/credits", 5);
+    return this->getCached(CREDITS_URL, 5, [](auto&) {});
+}
+
+std::optional<std::string> WebRequestManager::cachedCredits() {
+    auto cached = this->loadCached(CREDITS_URL);
+    if (!cached) return std::nullopt;
+
+    return std::move(cached->body);
 }
 
 RequestTask WebRequestManager::fetchServers() {
-    return this->get(makeCentralUrl("servers"), 3, [&](web::WebRequest& req) {
+    return this->getCached(makeCentralUrl("servers"), 3, [&](web::WebRequest& req) {
         req.param("protocol", NetworkManager::get().getUsedProtocol());
     });
 }
@@ -125,18 +145,96 @@ RequestTask WebRequestManager::get(std::string_view url, int timeoutS, std::func
     log::debug("GET request: {}", url);
 #endif
 
-    auto request = web::WebRequest()
+    auto request = makeRequest(timeoutS);
+    additional(request);
+
+    return mapTask(request.get(url));
+}
+
+
+RequestTask WebRequestManager::getCached(std::string_view url, int timeoutS, std::function<void(web::WebRequest&)> additional) {
 #ifdef GLOBED_DEBUG
-        .certVerification(false)
+    log::debug("GET request (cached): {}", url);
 #endif
-        .userAgent(util::net::webUserAgent())
-        .timeout(util::time::seconds(timeoutS));
 
+    std::erase_if(inFlight, [](const auto& entry) { return !entry.second.isPending(); });
+
+    std::string key(url);
+    if (auto it = inFlight.find(key); it != inFlight.end()) {
+        return it->second;
+    }
+
+    auto cached = this->loadCached(url);
+
+    auto request = makeRequest(timeoutS);
     additional(request);
 
-    return mapTask(request.get(url));
+    if (cached) {
+        if (!cached->etag.empty()) request.header("If-None-Match", cached->etag);
+        if (!cached->lastModified.empty()) request.header("If-Modified-Since", cached->lastModified);
+    }
+
+    auto task = request.get(url).map([this, url = std::string(url), cached = std::move(cached)](web::WebResponse* response) -> Result<std::string, WebRequestError> {
+        if (response->code() == 304 && cached) {
+            return Ok(cached->body);
+        }
+
+        auto result = mapResponse(response);
+        if (!result) return result;
+
+        auto etag = response->header("ETag");
+        auto lastModified = response->header("Last-Modified");
+
+        if (etag || lastModified) {
+            this->storeCached(url, CachedResponse {
+                .etag = etag.value_or(""),
+                .lastModified = lastModified.value_or(""),
+                .body = result.unwrap(),
+            });
+        }
+
+        return result;
+    }, [](auto) -> std::monostate {
+        return {};
+    });
+
+    inFlight.emplace(std::move(key), task);
+    return task;
 }
 
+std::optional<WebRequestManager::CachedResponse> WebRequestManager::loadCached(std::string_view url) {
+    auto cache = Mod::get()->getSavedValue<matjson::Value>(std::string(CACHE_KEY));
+
+    std::string key(url);
+    if (!cache.is_object() || !cache.contains(key) || !cache[key].is_object()) return std::nullopt;
+
+    const auto& entry = cache[key];
+    auto field = [&entry](const char* name) -> std::string {
+        return entry.contains(name) && entry[name].is_string() ? entry[name].as_string() : std::string();
+    };
+
+    return CachedResponse {
+        .etag = field("etag"),
+        .lastModified = field("lastModified"),
+        .body = field("body"),
+    };
+}
+
+void WebRequestManager::storeCached(std::string_view url, const CachedResponse& response) {
+    auto cache = Mod::get()->getSavedValue<matjson::Value>(std::string(CACHE_KEY));
+    if (!cache.is_object()) {
+        cache = matjson::Object();
+    }
+
+    matjson::Object entry;
+    entry["etag"] = response.etag;
+    entry["lastModified"] = response.lastModified;
+    entry["body"] = response.body;
+
+    cache[std::string(url)] = entry;
+
+    Mod::get()->setSavedValue(std::string(CACHE_KEY), cache);
+}
 
 RequestTask WebRequestManager::post(std::string_view url) {
     return post(url, 5);
@@ -151,13 +249,7 @@ RequestTask WebRequestManager::post(std::string_view url, int timeoutS, std::fun
     log::debug("POST request: {}", url);
 #endif
 
-    auto request = web::WebRequest()
-#ifdef GLOBED_DEBUG
-        .certVerification(false)
-#endif
-        .userAgent(util::net::webUserAgent())
-        .timeout(util::time::seconds(timeoutS));
-
+    auto request = makeRequest(timeoutS);
     additional(request);
 
     return mapTask(request.post(url));
@@ -28,6 +28,8 @@ public:
     Task requestAuthToken();
     Task testServer(std::string_view url);
     Task fetchCredits();
+    // Body of the last credits response, from the previous `fetchCredits` in this or an earlier session
+    std::optional<std::string> cachedCredits();
     Task fetchServers();
     Task challengeStart();
     Task challengeFinish(std::string_view authcode);
@@ -42,4 +44,22 @@ private:
     Task post(std::string_view url, int timeoutS);
     Task post(std::string_view url, int timeoutS, std::function<void(geode::utils::web::WebRequest&)> additional);
 
+    // Like `get`, but remembers the response body along with its `ETag` and `Last-Modified` headers.
+    // The next request for the same url is conditional, and a `304 Not Modified` resolves to the remembered body.
+    Task getCached(std::string_view url, int timeoutS, std::function<void(geode::utils::web::WebRequest&)> additional);
+
+    struct CachedResponse {
+        std::string etag;
+        std::string lastModified;
+        std::string body;
+    };
+
+    static constexpr std::string_view CACHE_KEY = "_globed-web-cache";
+
+    // `getCached` requests that haven't finished yet, by url. Asking for the same url again while one is running
+    // (e.g. the server list from startup and from the servers layer) shares the running task instead of starting another.
+    std::unordered_map<std::string, Task> inFlight;
+
+    std::optional<CachedResponse> loadCached(std::string_view url);
+    void storeCached(std::string_view url, const CachedResponse& response);
 };
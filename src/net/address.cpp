@@ -41,38 +41,70 @@ std::string NetworkAddress::toString() const {
 }
 
 Result<sockaddr_in> NetworkAddress::resolve() const {
+    GLOBED_UNWRAP_INTO(this->resolveAll(), auto addresses);
+    return Ok(addresses.front());
+}
+
+Result<std::vector<sockaddr_in>> NetworkAddress::resolveAll() const {
     if (host.empty()) {
         return Err("empty IP address or domain name, cannot resolve");
     }
 
-    // if it's cached then just use our cache
-    if (dnsCache.contains(host)) {
-        sockaddr_in out;
-        out.sin_family = AF_INET;
-        out.sin_port = util::net::hostToNetworkPort(port);
-        out.sin_addr = dnsCache.at(host);
-        return Ok(out);
+    auto toSockaddrs = [this](const std::vector<in_addr>& addresses) {
+        std::vector<sockaddr_in> out;
+        out.reserve(addresses.size());
+
+        for (auto& inaddr : addresses) {
+            sockaddr_in addr;
+            std::memset(&addr, 0, sizeof(sockaddr_in));
+            addr.sin_family = AF_INET;
+            addr.sin_port = util::net::hostToNetworkPort(port);
+            addr.sin_addr = inaddr;
+            out.push_back(addr);
+        }
+
+        return out;
+    };
+
+    // ip addresses don't need any resolving
+    in_addr literal;
+    if (util::net::stringToInAddr(host.c_str(), literal)) {
+        return Ok(toSockaddrs({literal}));
     }
 
-    // for some reason this must be heap allocated or windows complains
-    auto addr = std::make_unique<sockaddr_in>();
-    addr->sin_family = AF_INET;
+    std::optional<std::vector<in_addr>> stale;
 
-    auto ipResult = util::net::stringToInAddr(host.c_str(), addr->sin_addr);
+    // if it's cached then just use our cache
+    {
+        auto cache = dnsCache.lock();
+        auto it = cache->find(host);
+        if (it != cache->end()) {
+            if (util::time::now() - it->second.resolvedAt < DNS_CACHE_TTL) {
+                return Ok(toSockaddrs(it->second.addresses));
+            }
+
+            stale = it->second.addresses;
+        }
+    }
+
+    auto result = util::net::getaddrinfoAll(host);
+    if (!result) {
+        // better to try the old addresses than to fail right away
+        if (stale) {
+            return Ok(toSockaddrs(stale.value()));
+        }
 
-    // if this is not a valid IP address, try getaddrinfo
-    if (!ipResult) {
-        GLOBED_UNWRAP(util::net::getaddrinfo(host, *addr));
+        return Err(result.unwrapErr());
     }
 
-    // add to cache
-    dnsCache.emplace(std::make_pair(host, addr->sin_addr));
+    auto addresses = result.unwrap();
+
+    (*dnsCache.lock())[host] = DnsCacheEntry {
+        .addresses = addresses,
+        .resolvedAt = util::time::now(),
+    };
 
-    sockaddr_in copy;
-    std::memcpy(&copy, addr.get(), sizeof(sockaddr_in));
-    copy.sin_family = AF_INET;
-    copy.sin_port = util::net::hostToNetworkPort(port);
-    return Ok(copy);
+    return Ok(toSockaddrs(addresses));
 }
 
 Result<std::string> NetworkAddress::resolveToString() const {
@@ -1,5 +1,8 @@
 #pragma once
 #include <string_view>
+#include <vector>
+#include <asp/sync.hpp>
+#include <util/time.hpp>
 
 // for sockaddr_in
 #ifdef GEODE_IS_WINDOWS
@@ -10,7 +13,16 @@
 
 // Represents an IPv4 address and a port
 class NetworkAddress {
-    static inline std::unordered_map<std::string, in_addr> dnsCache;
+    // how long resolved addresses are cached before asking the resolver again
+    static constexpr auto DNS_CACHE_TTL = util::time::seconds(300);
+
+    struct DnsCacheEntry {
+        std::vector<in_addr> addresses;
+        util::time::time_point resolvedAt;
+    };
+
+    // shared between the network threads
+    static inline asp::Mutex<std::unordered_map<std::string, DnsCacheEntry>> dnsCache;
 
 public:
     static constexpr uint16_t DEFAULT_PORT = 4202;
@@ -36,6 +48,10 @@ public:
     // Note that this might block for DNS lookup if contained host was not an IP address.
     geode::Result<sockaddr_in> resolve() const;
 
+    // Same as `resolve` but returns every address the host resolves to, the first one being the same as returned by `resolve`.
+    // Used for trying multiple addresses when connecting.
+    geode::Result<std::vector<sockaddr_in>> resolveAll() const;
+
     // Combination of `resolve` and `toString`, returns the input in format `host:port` but does do DNS resolution.
     // Note that this might block for DNS lookup if contained host was not an IP address.
     geode::Result<std::string> resolveToString() const;
@@ -1,4 +1,5 @@
 #include "game_socket.hpp"
+#include "packet_capture.hpp"
 
 #include <data/bytebuffer.hpp>
 #include <data/packets/all.hpp>
@@ -14,7 +15,24 @@
 # include <poll.h>
 #endif
 
-constexpr size_t DATA_BUF_SIZE = 2 << 18;
+#include <bit>
+#include <lz4.h>
+
+// `tcpBuffer` size between big frames, grows to fit a bigger frame and is shrunk back once it has been decoded
+constexpr size_t TCP_BUF_INITIAL_SIZE = 1 << 16;
+// sanity limit for the length prefix, anything above this is a broken stream rather than a real packet
+constexpr size_t MAX_TCP_FRAME_SIZE = 2 << 23;
+// when receiving in batches, `udpBuffer` is split into this many slots
+constexpr size_t UDP_BATCH_SIZE = 8;
+// most datagrams are well under a kilobyte, a slot only grows to `UDP_MAX_SLOT_SIZE` after a datagram didn't fit
+constexpr size_t UDP_INITIAL_SLOT_SIZE = 1 << 12;
+constexpr size_t UDP_MAX_SLOT_SIZE = 1 << 16;
+// initial capacity of the send scratch buffers, enough for most packets
+constexpr size_t SEND_BUF_INITIAL_SIZE = 4096;
+// udp receive buffer with low latency options, enough to absorb a burst of player data in a full level
+constexpr int LOW_LATENCY_RECV_BUF_SIZE = 1 << 20;
+// biggest packet we are willing to decompress, compressed packets are usually 3-5x smaller than this
+constexpr size_t MAX_DECOMPRESSED_SIZE = MAX_TCP_FRAME_SIZE * 4;
 
 using namespace util::data;
 using namespace util::debug;
@@ -22,11 +40,11 @@ using PollResult = GameSocket::PollResult;
 using ReceivedPacket = GameSocket::ReceivedPacket;
 
 GameSocket::GameSocket() {
-    dataBuffer = new byte[DATA_BUF_SIZE];
-}
+    udpSlotSize = UDP_INITIAL_SLOT_SIZE;
+    udpBuffer.resize(udpSlotSize * UDP_BATCH_SIZE);
+    tcpBuffer.resize(TCP_BUF_INITIAL_SIZE);
 
-GameSocket::~GameSocket() {
-    delete[] dataBuffer;
+    sendScratch.lock()->tcp.reserve(SEND_BUF_INITIAL_SIZE);
 }
 
 Result<> GameSocket::connect(const NetworkAddress& address, bool isRecovering) {
@@ -42,8 +60,28 @@ Result<> GameSocket::connect(const NetworkAddress& address, bool isRecovering) {
     log::debug("Connecting to {} (resolved to {})", address.toString(), resolved);
 #endif
 
+    // drop any leftovers from the previous connection
+    tcpBufStart = 0;
+    tcpBufEnd = 0;
+
+    if (tcpBuffer.size() > TCP_BUF_INITIAL_SIZE) {
+        tcpBuffer = bytevector(TCP_BUF_INITIAL_SIZE);
+    }
+
+    // the new server may never send a big datagram
+    if (udpSlotSize > UDP_INITIAL_SLOT_SIZE) {
+        udpSlotSize = UDP_INITIAL_SLOT_SIZE;
+        udpBuffer = bytevector(udpSlotSize * UDP_BATCH_SIZE);
+    }
+
+    socketGeneration.fetch_add(1);
+
     GLOBED_UNWRAP(tcpSocket.connect(address))
-    GLOBED_UNWRAP(udpSocket.connect(address))
+    // use the address tcp ended up connecting to, in case the host has multiple
+    GLOBED_UNWRAP(udpSocket.connect(tcpSocket.peerAddress()))
+
+    this->applyLowLatencyOptions(*sendScratch.lock());
+    udpDropsBase = util::net::receiveDropCount(udpSocket.socket_).value_or(0);
 
     // send a magic byte telling the server whether we are recovering or not
     uint8_t byte = isRecovering ? MARKER_CONN_RECOVERY : MARKER_CONN_INITIAL;
@@ -55,6 +93,52 @@ Result<> GameSocket::connect(const NetworkAddress& address, bool isRecovering) {
 void GameSocket::disconnect() {
     tcpSocket.disconnect();
     udpSocket.disconnect();
+    socketGeneration.fetch_add(1);
+}
+
+void GameSocket::applyLowLatencyOptions(SendScratch& scratch) {
+    // the udp socket is reused between connections, so clear whatever the previous one has set
+    if (scratch.marker.attached()) {
+        (void) scratch.marker.mark(util::net::TrafficClass::BestEffort);
+        scratch.marker.detach();
+    }
+
+    if (!lowLatency) return;
+
+    auto bufSize = util::net::setReceiveBufferSize(udpSocket.socket_, LOW_LATENCY_RECV_BUF_SIZE);
+    if (bufSize) {
+        log::debug("udp receive buffer set to {} bytes", bufSize.unwrap());
+    } else {
+        log::warn("Failed to set the udp receive buffer size: {}", bufSize.unwrapErr());
+    }
+
+    if (auto res = util::net::setNoDelay(tcpSocket.socket_, true); !res) {
+        log::warn("Failed to set TCP_NODELAY: {}", res.unwrapErr());
+    }
+
+    if (auto res = scratch.marker.attach(udpSocket.socket_, tcpSocket.peerAddress()); !res) {
+        log::warn("Failed to set up traffic marking: {}", res.unwrapErr());
+    }
+}
+
+void GameSocket::markTraffic(SendScratch& scratch, util::net::TrafficClass cls) {
+    if (!scratch.marker.attached()) return;
+
+    if (auto res = scratch.marker.mark(cls); !res) {
+        log::warn("Failed to mark traffic, disabling marking for this connection: {}", res.unwrapErr());
+        scratch.marker.detach();
+    }
+}
+
+util::net::TrafficClass GameSocket::trafficClassFor(const Packet& packet) {
+    return packet.getPacketId() == VoicePacket::PACKET_ID ? util::net::TrafficClass::Voice : util::net::TrafficClass::Interactive;
+}
+
+std::optional<uint32_t> GameSocket::udpReceiveDrops() {
+    auto drops = util::net::receiveDropCount(udpSocket.socket_);
+    if (!drops) return std::nullopt;
+
+    return *drops - udpDropsBase.load();
 }
 
 bool GameSocket::isConnected() {
@@ -62,24 +146,89 @@ bool GameSocket::isConnected() {
 }
 
 Result<std::shared_ptr<Packet>> GameSocket::recvPacketTCP() {
-    ByteBuffer bb;
-    bb.grow(4);
+    // keep receiving until we have at least one full frame buffered
+    while (!this->hasBufferedTcpFrame()) {
+        GLOBED_UNWRAP(this->fillTcpBuffer());
+    }
+
+    return this->decodeBufferedTcpFrame();
+}
+
+Result<std::shared_ptr<Packet>> GameSocket::decodeBufferedTcpFrame() {
+    uint32_t packetSize = this->peekTcpFrameSize();
+    byte* frame = tcpBuffer.data() + tcpBufStart + sizeof(uint32_t);
+    tcpBufStart += sizeof(uint32_t) + packetSize;
+
+    // decode straight from the stream buffer, the frame stays untouched until the next fill
+    auto buf = ByteBuffer::view(frame, packetSize);
+
+    return this->decodePacket(buf, false);
+}
+
+bool GameSocket::hasBufferedTcpFrame() {
+    size_t available = tcpBufEnd - tcpBufStart;
+    if (available < sizeof(uint32_t)) return false;
+
+    return available - sizeof(uint32_t) >= this->peekTcpFrameSize();
+}
+
+uint32_t GameSocket::peekTcpFrameSize() {
+    if (tcpBufEnd - tcpBufStart < sizeof(uint32_t)) return 0;
+
+    uint32_t size;
+    std::memcpy(&size, tcpBuffer.data() + tcpBufStart, sizeof(uint32_t));
+    return util::data::maybeByteswap(size);
+}
+
+Result<> GameSocket::fillTcpBuffer() {
+    size_t available = tcpBufEnd - tcpBufStart;
+    size_t wantedSize = TCP_BUF_INITIAL_SIZE;
+
+    if (available >= sizeof(uint32_t)) {
+        size_t frameSize = this->peekTcpFrameSize() + sizeof(uint32_t);
+        GLOBED_REQUIRE_SAFE(frameSize <= MAX_TCP_FRAME_SIZE, "packet is too big, rejecting")
+
+        wantedSize = std::max(wantedSize, std::bit_ceil(frameSize));
+    }
+
+    if (wantedSize > tcpBuffer.size()) {
+        // big lists can exceed the default size, grow the buffer instead of rejecting them
+        tcpBuffer.resize(wantedSize);
+    } else if (wantedSize < tcpBuffer.size() && available <= wantedSize) {
+        // the big frame has been decoded, don't keep its memory around until the next one
+        bytevector smaller(wantedSize);
+        std::memcpy(smaller.data(), tcpBuffer.data() + tcpBufStart, available);
+
+        tcpBuffer = std::move(smaller);
+        tcpBufStart = 0;
+        tcpBufEnd = available;
+    }
+
+    // move the partial frame to the front so the rest of it can fit
+    if (tcpBufStart > 0) {
+        if (available > 0) {
+            std::memmove(tcpBuffer.data(), tcpBuffer.data() + tcpBufStart, available);
+        }
 
-    // receive the packet length
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(bb.data().data()), 4));
+        tcpBufStart = 0;
+        tcpBufEnd = available;
+    }
 
-    auto packetSize = bb.readU32().value_or(0); // must always be 4 bytes so cant error
-    GLOBED_REQUIRE_SAFE(packetSize < DATA_BUF_SIZE, "packet is too big, rejecting")
+    GLOBED_REQUIRE_SAFE(tcpSocket.connected, "attempting to receive on a disconnected socket")
 
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(dataBuffer), packetSize));
+    int result = tcpSocket.receive(reinterpret_cast<char*>(tcpBuffer.data() + tcpBufEnd), tcpBuffer.size() - tcpBufEnd).result;
+    if (result < 0) return Err(util::net::lastErrorString());
+    if (result == 0) return Err("connection was closed by the server");
 
-    ByteBuffer buf(dataBuffer, packetSize);
+    tcpBufEnd += result;
+    bytesReceived.fetch_add(result);
 
-    return this->decodePacket(buf);
+    return Ok();
 }
 
 Result<ReceivedPacket> GameSocket::recvPacketUDP() {
-    auto recvResult = udpSocket.receive(reinterpret_cast<char*>(dataBuffer), DATA_BUF_SIZE);
+    // a single datagram can use the whole buffer
+    auto recvResult = udpSocket.receive(reinterpret_cast<char*>(udpBuffer.data()), udpBuffer.size());
 
     ReceivedPacket out;
     out.fromConnected = recvResult.fromServer;
@@ -88,14 +237,31 @@ Result<ReceivedPacket> GameSocket::recvPacketUDP() {
         return Err("udp recv failed");
     }
 
-    ByteBuffer buf(dataBuffer, (size_t)recvResult.result);
+    if (recvResult.truncated) {
+        this->growUdpSlots();
+        return Err("udp datagram did not fit in the receive buffer");
+    }
 
-    GLOBED_UNWRAP_INTO(this->decodePacket(buf), out.packet);
+    bytesReceived.fetch_add(recvResult.result);
+
+    auto buf = ByteBuffer::view(udpBuffer.data(), (size_t)recvResult.result);
+
+    GLOBED_UNWRAP_INTO(this->decodePacket(buf, true), out.packet);
+    GLOBED_REQUIRE_SAFE(out.packet.get() != nullptr, "received a duplicate packet")
 
     return Ok(std::move(out));
 }
 
 Result<ReceivedPacket> GameSocket::recvPacket(int timeoutMs) {
+    // if an earlier recv already brought in a full frame, don't bother polling
+    if (this->hasBufferedTcpFrame()) {
+        GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
+        return Ok(ReceivedPacket {
+            .packet = std::move(packet),
+            .fromConnected = true
+        });
+    }
+
     // negative value means poll indefinitely until either tcp or udp receives data
     GLOBED_UNWRAP_INTO(this->poll(timeoutMs), auto pollResult);
 
@@ -103,53 +269,259 @@ Result<ReceivedPacket> GameSocket::recvPacket(int timeoutMs) {
         return Err("timed out");
     }
 
-    // prioritize TCP, if the result is Tcp or Both, we care about TCP.
-    if (pollResult != PollResult::Udp) {
-        GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
-        return Ok(ReceivedPacket {
+    // prioritize UDP, if the result is Udp or Both, we care about UDP. tcp data will still be there on the next call
+    if (pollResult != PollResult::Tcp) {
+        return this->recvPacketUDP();
+    }
+
+    GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
+    return Ok(ReceivedPacket {
+        .packet = std::move(packet),
+        .fromConnected = true
+    });
+}
+
+Result<ReceivedPacket> GameSocket::recvPacket() {
+    return this->recvPacket(-1);
+}
+
+Result<> GameSocket::recvPackets(int timeoutMs, std::vector<ReceivedPacket>& out) {
+    // if there is a buffered frame already, don't wait, but still check if udp has anything
+    GLOBED_UNWRAP_INTO(this->poll(this->hasBufferedTcpFrame() ? 0 : timeoutMs), auto pollResult);
+
+    bool tcpReadable = pollResult == PollResult::Tcp || pollResult == PollResult::Both;
+    bool udp = pollResult == PollResult::Udp || pollResult == PollResult::Both;
+
+    if (!tcpReadable && !udp && !this->hasBufferedTcpFrame()) {
+        return Err("timed out");
+    }
+
+    // udp first, it carries the latency sensitive stuff (player data, voice) and never needs more than one recv
+    if (udp) {
+        GLOBED_UNWRAP(this->recvPacketsUDP(out));
+    }
+
+    // a single recv per wakeup, so that a big frame (e.g. a level list) is read over several iterations
+    // instead of blocking here until all of it arrives, while datagrams pile up
+    if (tcpReadable) {
+        GLOBED_UNWRAP(this->fillTcpBuffer());
+    }
+
+    while (this->hasBufferedTcpFrame()) {
+        GLOBED_UNWRAP_INTO(this->decodeBufferedTcpFrame(), auto packet);
+        out.push_back(ReceivedPacket {
             .packet = std::move(packet),
             .fromConnected = true
         });
     }
 
-    // else it's a udp packet
-    return this->recvPacketUDP();
+    return Ok();
 }
 
-Result<ReceivedPacket> GameSocket::recvPacket() {
-    return this->recvPacket(-1);
+Result<> GameSocket::recvPacketsUDP(std::vector<ReceivedPacket>& out) {
+    RecvResult results[UDP_BATCH_SIZE];
+
+    GLOBED_UNWRAP_INTO(udpSocket.receiveBatch(reinterpret_cast<char*>(udpBuffer.data()), udpSlotSize, UDP_BATCH_SIZE, results), size_t count);
+
+    bool anyTruncated = false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (results[i].result < 0) continue;
+
+        // the rest of it is gone, drop it like a lost datagram
+        if (results[i].truncated) {
+            anyTruncated = true;
+            continue;
+        }
+
+        bytesReceived.fetch_add(results[i].result);
+
+        auto buf = ByteBuffer::view(udpBuffer.data() + i * udpSlotSize, (size_t)results[i].result);
+
+        GLOBED_UNWRAP_INTO(this->decodePacket(buf, true), auto packet);
+
+        // replayed or duplicated by the network, just drop it
+        if (!packet) continue;
+
+        out.push_back(ReceivedPacket {
+            .packet = std::move(packet),
+            .fromConnected = results[i].fromServer
+        });
+    }
+
+    // bigger slots for the next batch, so the next datagram of that size isn't lost too
+    if (anyTruncated) {
+        this->growUdpSlots();
+    }
+
+    return Ok();
+}
+
+void GameSocket::growUdpSlots() {
+    if (udpSlotSize >= UDP_MAX_SLOT_SIZE) return;
+
+    log::debug("udp datagram was truncated, growing receive slots to {} bytes", UDP_MAX_SLOT_SIZE);
+
+    // the real size of the datagram is unknown on most platforms, go straight to the biggest possible one
+    udpSlotSize = UDP_MAX_SLOT_SIZE;
+    udpBuffer = bytevector(udpSlotSize * UDP_BATCH_SIZE);
 }
 
 Result<> GameSocket::sendPacket(std::shared_ptr<Packet> packet) {
     GLOBED_REQUIRE_SAFE(this->isConnected(), "attempting to send a packet while disconnected")
 
-    ByteBuffer buf;
+    auto scratch = sendScratch.lock();
+    ByteBuffer& buf = scratch->tcp;
+    buf.clear();
+
     GLOBED_UNWRAP(this->encodePacket(*packet, buf))
 
+    util::debug::PacketLogger::get().record(packet->getPacketId(), packet->getEncrypted(), true, buf.size());
+
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), packet->getEncrypted(), buf, true);
     }
 
     if (packet->getUseTcp()) {
-        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.rawData()), buf.size()));
     } else {
-        GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        this->markTraffic(*scratch, trafficClassFor(*packet));
+        GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(buf.rawData()), buf.size()));
     }
 
+    bytesSent.fetch_add(buf.size());
+    packetsSent.fetch_add(1);
+
+    return Ok();
+}
+
+Result<> GameSocket::sendPackets(const std::vector<std::shared_ptr<Packet>>& packets) {
+    GLOBED_REQUIRE_SAFE(this->isConnected(), "attempting to send a packet while disconnected")
+
+    auto scratch = sendScratch.lock();
+
+    // tcp packets are length prefixed, so they can just go one after another in the same buffer
+    ByteBuffer& tcpBuf = scratch->tcp;
+    tcpBuf.clear();
+
+    // udp buffers are kept around between calls, only the first `udpCount` are in use
+    size_t udpCount = 0;
+
+    // packets are encrypted once everything is encoded, so the boxes can process them in batches.
+    // that keeps pointers to the udp buffers around, so make sure the vector doesn't reallocate midway
+    scratch->deferred.clear();
+    scratch->udp.reserve(packets.size());
+
+    // only filled when dumping, the dump has to happen after encryption
+    struct DumpEntry {
+        packetid_t id;
+        bool encrypted;
+        ByteBuffer* buffer;
+        size_t start, end;
+    };
+
+    std::vector<DumpEntry> dumps;
+
+    for (auto& packet : packets) {
+        bool tcp = packet->getUseTcp();
+
+        if (!tcp && udpCount == scratch->udp.size()) {
+            scratch->udp.emplace_back().reserve(SEND_BUF_INITIAL_SIZE);
+        }
+
+        ByteBuffer& buf = tcp ? tcpBuf : scratch->udp[udpCount++];
+        if (!tcp) {
+            buf.clear();
+
+            if (udpCount > scratch->classes.size()) {
+                scratch->classes.resize(udpCount);
+            }
+
+            scratch->classes[udpCount - 1] = trafficClassFor(*packet);
+        }
+
+        size_t startPos = buf.getPosition();
+        GLOBED_UNWRAP(this->encodePacket(*packet, buf, &scratch->deferred))
+
+        util::debug::PacketLogger::get().record(packet->getPacketId(), packet->getEncrypted(), true, buf.size() - startPos);
+
+        if (dumpPackets) {
+            dumps.push_back(DumpEntry {
+                .id = packet->getPacketId(),
+                .encrypted = packet->getEncrypted(),
+                .buffer = &buf,
+                .start = startPos,
+                .end = buf.size(),
+            });
+        }
+    }
+
+    this->encryptDeferred(*scratch);
+
+    for (auto& dump : dumps) {
+        auto single = ByteBuffer::view(dump.buffer->rawData() + dump.start, dump.end - dump.start);
+        this->dumpPacket(dump.id, dump.encrypted, single, true);
+    }
+
+    if (tcpBuf.size() > 0) {
+        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(tcpBuf.rawData()), tcpBuf.size()));
+        bytesSent.fetch_add(tcpBuf.size());
+    }
+
+    if (udpCount > 0) {
+        auto& datagrams = scratch->datagrams;
+        datagrams.clear();
+
+        for (size_t i = 0; i < udpCount; i++) {
+            auto& buf = scratch->udp[i];
+            datagrams.push_back(UdpSocket::Datagram {
+                .data = reinterpret_cast<const char*>(buf.rawData()),
+                .size = static_cast<unsigned int>(buf.size()),
+            });
+        }
+
+        if (scratch->marker.attached()) {
+            // the class is per socket, so every change of class needs its own batch
+            size_t start = 0;
+            while (start < udpCount) {
+                size_t end = start + 1;
+                while (end < udpCount && scratch->classes[end] == scratch->classes[start]) end++;
+
+                this->markTraffic(*scratch, scratch->classes[start]);
+                GLOBED_UNWRAP(udpSocket.sendBatch(datagrams.data() + start, end - start));
+
+                start = end;
+            }
+        } else {
+            GLOBED_UNWRAP(udpSocket.sendBatch(datagrams.data(), datagrams.size()));
+        }
+
+        for (auto& datagram : datagrams) {
+            bytesSent.fetch_add(datagram.size);
+        }
+    }
+
+    packetsSent.fetch_add(packets.size());
+
     return Ok();
 }
 
 Result<> GameSocket::sendPacketTo(std::shared_ptr<Packet> packet, const NetworkAddress& address) {
     GLOBED_REQUIRE_SAFE(!packet->getUseTcp(), "cannot send a TCP packet to a UDP connection")
 
-    ByteBuffer buf;
+    auto scratch = sendScratch.lock();
+    ByteBuffer& buf = scratch->tcp;
+    buf.clear();
+
     GLOBED_UNWRAP(this->encodePacket(*packet, buf))
 
+    util::debug::PacketLogger::get().record(packet->getPacketId(), packet->getEncrypted(), true, buf.size());
+
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), packet->getEncrypted(), buf, true);
     }
 
-    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf.data().data()), buf.size(), address), auto res)
+    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf.rawData()), buf.size(), address), auto res)
 
     GLOBED_REQUIRE_SAFE(
         res == buf.size(),
@@ -169,37 +541,50 @@ Result<> GameSocket::sendRecoveryData(int accountId, uint32_t secretKey) {
 
 void GameSocket::cleanupBox() {
     cryptoBox = std::unique_ptr<CryptoBox>(nullptr);
+    sessionBox = std::unique_ptr<SessionBox>(nullptr);
 }
 
 void GameSocket::createBox() {
     cryptoBox = std::make_unique<CryptoBox>();
+    sessionBox = std::unique_ptr<SessionBox>(nullptr);
+}
+
+void GameSocket::createSessionBox(SessionCipher cipher) {
+    GLOBED_REQUIRE(cryptoBox.get() != nullptr, "attempted to create a session box when no cryptobox is initialized")
+    sessionBox = std::make_unique<SessionBox>(cryptoBox->deriveSessionKey(), true, cipher);
 }
 
 void GameSocket::togglePacketLogging(bool state) {
+    auto& capture = PacketCapture::get();
+
+    if (state) {
+        auto result = capture.start();
+        if (!result) {
+            log::warn("Failed to start packet capture: {}", result.unwrapErr());
+            return;
+        }
+    } else {
+        capture.stop();
+    }
+
     dumpPackets = state;
 }
 
 Result<PollResult> GameSocket::poll(int timeoutMs) {
-    if (!tcpSocket.connected) {
-        GLOBED_UNWRAP_INTO(udpSocket.poll(timeoutMs), auto res);
-        return Ok(res ? PollResult::Udp : PollResult::None);
+    uint32_t generation = socketGeneration.load();
+    if (generation != polledGeneration) {
+        poller.invalidate();
+        polledGeneration = generation;
     }
 
-    GLOBED_SOCKET_POLLFD fds[2];
-
-    fds[0].fd = tcpSocket.socket_;
-    fds[0].events = POLLIN;
-    fds[1].fd = udpSocket.socket_;
-    fds[1].events = POLLIN;
+    // the udp socket always goes first, so its bit stays the same whether tcp is connected or not
+    util::net::socket_t sockets[2] = { udpSocket.socket_, tcpSocket.socket_ };
+    size_t count = tcpSocket.connected ? 2 : 1;
 
-    int result = GLOBED_SOCKET_POLL(fds, 2, timeoutMs);
+    GLOBED_UNWRAP_INTO(poller.wait(sockets, count, timeoutMs), uint32_t ready);
 
-    if (result == -1) {
-        return Err(util::net::lastErrorString());
-    }
-
-    bool tcp = fds[0].revents & POLLIN;
-    bool udp = fds[1].revents & POLLIN;
+    bool udp = ready & 0b01;
+    bool tcp = ready & 0b10;
 
     if (tcp && udp) {
         return Ok(PollResult::Both);
@@ -212,17 +597,30 @@ Result<PollResult> GameSocket::poll(int timeoutMs) {
     }
 }
 
-Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
+Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer, std::vector<DeferredEncryption>* deferred) {
     PacketHeader header = {
         .id = packet.getPacketId(),
-        .encrypted = packet.getEncrypted(),
+        .flags = packet.getEncrypted() ? PacketHeader::FLAG_ENCRYPTED : uint8_t(0),
     };
 
     bool tcp = packet.getUseTcp();
 
-    // reserve space for packet length when using TCP
+    // udp packets use the smaller session prefix when the server supports it
+    bool session = header.encrypted() && !tcp && sessionBox;
+    size_t prefixLength = header.encrypted() ? (session ? SessionBox::PREFIX_LEN : CryptoBox::PREFIX_LEN) : 0;
+
     size_t startPos = buffer.getPosition();
 
+    // reserve everything upfront, including the space needed for in-place encryption, so that we don't reallocate midway
+    buffer.reserve(
+        startPos
+        + (tcp ? sizeof(uint32_t) : 0)
+        + PacketHeader::SIZE
+        + packet.getEncodedSizeHint()
+        + prefixLength
+    );
+
+    // reserve space for packet length when using TCP
     if (tcp) {
         buffer.writeU32(0);
     }
@@ -233,15 +631,29 @@ Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
     if (packet.getEncrypted()) {
         GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to encrypt a packet when no cryptobox is initialized")
 
-        // grow the vector by CryptoBox::PREFIX_LEN extra bytes to do in-place encryption
-        buffer.grow(CryptoBox::PREFIX_LEN);
+        // grow the vector by the prefix length to do in-place encryption
+        buffer.grow(prefixLength);
         uint32_t headerSize = PacketHeader::SIZE;
         if (tcp) {
             headerSize += sizeof(uint32_t);
         }
 
-        auto rawSize = buffer.size() - headerSize - startPos - CryptoBox::PREFIX_LEN;
-        cryptoBox->encryptInPlace(buffer.data().data() + startPos + headerSize, rawSize);
+        auto rawSize = buffer.size() - headerSize - startPos - prefixLength;
+        byte* message = buffer.data().data() + startPos + headerSize;
+
+        if (deferred) {
+            // the buffer may still grow, so remember the offset rather than the pointer
+            deferred->push_back(DeferredEncryption {
+                .buffer = &buffer,
+                .offset = startPos + headerSize,
+                .size = rawSize,
+                .session = session,
+            });
+        } else if (session) {
+            sessionBox->encryptInPlace(message, rawSize);
+        } else {
+            cryptoBox->encryptInPlace(message, rawSize);
+        }
     }
 
     // write length
@@ -257,55 +669,120 @@ Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
     return Ok();
 }
 
-Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
+void GameSocket::encryptDeferred(SendScratch& scratch) {
+    if (scratch.deferred.empty()) return;
+
+    scratch.boxItems.clear();
+    scratch.sessionItems.clear();
+
+    for (auto& entry : scratch.deferred) {
+        auto& items = entry.session ? scratch.sessionItems : scratch.boxItems;
+        items.push_back(CryptoBatchItem {
+            .data = entry.buffer->rawData() + entry.offset,
+            .size = entry.size,
+        });
+    }
+
+    if (!scratch.boxItems.empty()) {
+        cryptoBox->encryptInPlaceBatch(scratch.boxItems.data(), scratch.boxItems.size());
+    }
+
+    if (!scratch.sessionItems.empty()) {
+        sessionBox->encryptInPlaceBatch(scratch.sessionItems.data(), scratch.sessionItems.size());
+    }
+
+    scratch.deferred.clear();
+}
+
+Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer, bool udp) {
     // read header
     auto header = buffer.readValue<PacketHeader>().unwrap(); // we know that the header must be present by now.
 
     // packet size without the header
     size_t messageLength = buffer.size() - buffer.getPosition();
 
-    auto packet = matchPacket(header.id);
+    auto* properties = ServerPacketTypes::propertiesOf(header.id);
 
-    GLOBED_REQUIRE_SAFE(packet.get() != nullptr, std::string("invalid server-side packet: ") + std::to_string(header.id))
+    GLOBED_REQUIRE_SAFE(properties != nullptr, std::string("invalid server-side packet: ") + std::to_string(header.id))
 
-    if (packet->getEncrypted() && !header.encrypted) {
+    if (properties->encrypted && !header.encrypted()) {
         GLOBED_REQUIRE_SAFE(false, "server sent a cleartext packet when expected an encrypted one")
     }
 
-    if (header.encrypted) {
+    auto packet = matchPacket(header.id);
+
+    if (header.encrypted()) {
         GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to decrypt a packet when no cryptobox is initialized")
-        bytevector& bufvec = buffer.data();
+        byte* message = buffer.rawData() + PacketHeader::SIZE;
+
+        if (udp && sessionBox) {
+            auto decrypted = sessionBox->decryptInPlace(message, messageLength);
+            if (!decrypted) {
+                return Ok(nullptr);
+            }
+
+            messageLength = *decrypted;
+        } else {
+            messageLength = cryptoBox->decryptInPlace(message, messageLength);
+        }
 
-        messageLength = cryptoBox->decryptInPlace(bufvec.data() + PacketHeader::SIZE, messageLength);
         buffer.resize(messageLength + PacketHeader::SIZE);
     }
 
+    if (header.compressed()) {
+        GLOBED_UNWRAP(this->decompressPacket(buffer, messageLength));
+    }
+
+    util::debug::PacketLogger::get().record(header.id, header.encrypted(), false, buffer.size());
+
     if (dumpPackets) {
-        this->dumpPacket(header.id, buffer, false);
+        this->dumpPacket(header.id, header.encrypted(), buffer, false);
     }
 
     auto result = packet->decode(buffer);
     if (result.isErr()) {
-        return Err(fmt::format("Decoding packet ID {} failed: {}", header.id, ByteBuffer::strerror(result.unwrapErr())));
+        // the schema hash tells which layout of the packet this client expected, handy when the server was built from different sources
+        return Err(fmt::format(
+            "Decoding packet ID {} (schema {:08x}) failed: {}",
+            header.id, packet->getSchemaHash(), ByteBuffer::strerror(result.unwrapErr())
+        ));
     }
 
+    packetsReceived.fetch_add(1);
+
     return Ok(std::move(packet));
 }
 
-void GameSocket::dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending) {
-    log::debug("{} packet {}", sending ? "Sending" : "Receiving", id);
+Result<> GameSocket::decompressPacket(ByteBuffer& buffer, size_t messageLength) {
+    GLOBED_REQUIRE_SAFE(messageLength >= sizeof(uint32_t), "compressed packet is missing the uncompressed size")
 
-    auto folder = Mod::get()->getSaveDir() / "packets";
-    (void) geode::utils::file::createDirectoryAll(folder);
-    util::misc::callOnce("networkmanager-log-to-file", [&] {
-        log::debug("Packet log folder: {}", folder);
-    });
+    const byte* message = buffer.rawData() + PacketHeader::SIZE;
+
+    uint32_t rawSize;
+    std::memcpy(&rawSize, message, sizeof(uint32_t));
+    rawSize = util::data::maybeByteswap(rawSize);
 
-    auto datetime = util::format::formatDateTime(util::time::systemNow());
-    auto filepath = folder / fmt::format("{}-{}.bin", id, datetime);
+    GLOBED_REQUIRE_SAFE(rawSize <= MAX_DECOMPRESSED_SIZE, "compressed packet is too big, rejecting")
 
-    std::ofstream fs(filepath, std::ios::binary);
+    // the header is copied as well, so the packet can be decoded and dumped the same way as an uncompressed one
+    decompressBuffer.resize(PacketHeader::SIZE + rawSize);
+    std::memcpy(decompressBuffer.data(), buffer.rawData(), PacketHeader::SIZE);
+
+    int written = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(message + sizeof(uint32_t)),
+        reinterpret_cast<char*>(decompressBuffer.data() + PacketHeader::SIZE),
+        static_cast<int>(messageLength - sizeof(uint32_t)),
+        static_cast<int>(rawSize)
+    );
+
+    GLOBED_REQUIRE_SAFE(written == static_cast<int>(rawSize), "failed to decompress the packet")
+
+    buffer = ByteBuffer::view(decompressBuffer.data(), decompressBuffer.size());
+    buffer.setPosition(PacketHeader::SIZE);
+
+    return Ok();
+}
 
-    const auto& vec = buffer.data();
-    fs.write(reinterpret_cast<const char*>(vec.data()), vec.size());
+void GameSocket::dumpPacket(packetid_t id, bool encrypted, ByteBuffer& buffer, bool sending) {
+    PacketCapture::get().capture(id, sending, encrypted, buffer.rawData(), buffer.size());
 }
\ No newline at end of file
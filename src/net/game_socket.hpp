@@ -6,6 +6,9 @@
 
 #include <data/packets/packet.hpp>
 #include <crypto/box.hpp>
+#include <crypto/session_box.hpp>
+#include <util/net.hpp>
+#include <asp/sync.hpp>
 
 class GameSocket {
     static constexpr uint8_t MARKER_CONN_INITIAL = 0xe0;
@@ -13,7 +16,6 @@ class GameSocket {
 
 public:
     GameSocket();
-    ~GameSocket();
 
     Result<> connect(const NetworkAddress& address, bool isRecovering);
     void disconnect();
@@ -27,6 +29,12 @@ public:
     // Try to receive a packet on the TCP socket
     Result<std::shared_ptr<Packet>> recvPacketTCP();
 
+    // Returns true if a full TCP frame is already buffered and can be decoded without calling `recv`
+    bool hasBufferedTcpFrame();
+
+    // Decode the next buffered TCP frame, only call if `hasBufferedTcpFrame` returned true
+    Result<std::shared_ptr<Packet>> decodeBufferedTcpFrame();
+
     // Try to receive a packet on the UDP socket
     Result<ReceivedPacket> recvPacketUDP();
 
@@ -36,9 +44,21 @@ public:
     // Try to receive a packet, returns "timed out" if timeout is reached.
     Result<ReceivedPacket> recvPacket(int timeoutMs);
 
+    // Wait up to `timeoutMs` for data, then receive every packet that is pending on either socket and append them to `out`.
+    // UDP is drained first, TCP gets a single `recv` per call and only complete frames are decoded.
+    // Returns "timed out" if timeout is reached. On error, `out` still contains the packets decoded before the failure.
+    Result<> recvPackets(int timeoutMs, std::vector<ReceivedPacket>& out);
+
+    // Receive all pending UDP datagrams at once and append the decoded packets to `out`.
+    Result<> recvPacketsUDP(std::vector<ReceivedPacket>& out);
+
     // Send a packet to the currently active connection. Throws if disconnected
     Result<> sendPacket(std::shared_ptr<Packet> packet);
 
+    // Send multiple packets to the currently active connection. All TCP packets are written with a single `sendAll`,
+    // and UDP packets are sent as one batch.
+    Result<> sendPackets(const std::vector<std::shared_ptr<Packet>>& packets);
+
     // Send a UDP packet to a specific address
     Result<> sendPacketTo(std::shared_ptr<Packet> packet, const NetworkAddress& address);
 
@@ -46,9 +66,15 @@ public:
 
     void cleanupBox();
     void createBox();
+    // Switches encrypted UDP packets to a `SessionBox`, keyed from the crypto box. Must be called after the handshake.
+    void createSessionBox(SessionCipher cipher);
 
     void togglePacketLogging(bool enabled);
 
+    // Datagrams the OS dropped on the UDP socket since the last connect because its receive buffer was full,
+    // nullopt if the platform can't tell
+    std::optional<uint32_t> udpReceiveDrops();
+
     enum class PollResult {
         None, Tcp, Udp, Both
     };
@@ -62,15 +88,98 @@ private:
     UdpSocket udpSocket;
 
     std::unique_ptr<CryptoBox> cryptoBox;
-    util::data::byte* dataBuffer;
+    // only set when the server supports it, used instead of `cryptoBox` for encrypted UDP packets
+    std::unique_ptr<SessionBox> sessionBox;
+
+    // datagrams are received here, split into `UDP_BATCH_SIZE` slots of `udpSlotSize` bytes.
+    // starts small and grows once a datagram gets truncated
+    util::data::bytevector udpBuffer;
+    size_t udpSlotSize;
+
+    // TCP stream buffer, one `recv` can fill it with multiple length-prefixed frames.
+    // [tcpBufStart, tcpBufEnd) is the data that has been received but not yet decoded.
+    util::data::bytevector tcpBuffer;
+    size_t tcpBufStart = 0;
+    size_t tcpBufEnd = 0;
+
+    // compressed packets are decompressed here, reused between packets
+    util::data::bytevector decompressBuffer;
 
     bool dumpPackets = false;
 
+    // set before `connect`, enables the options in `applyLowLatencyOptions`
+    asp::AtomicBool lowLatency;
+    // the kernel drop counter is per socket, and the udp socket outlives connections
+    asp::AtomicU32 udpDropsBase;
+
+    // total amount of bytes sent and received over both sockets, including headers added by `encodePacket`
+    asp::AtomicSizeT bytesSent;
+    asp::AtomicSizeT bytesReceived;
+    // packets successfully sent and decoded, a datagram or a TCP read can contain several of them
+    asp::AtomicSizeT packetsSent;
+    asp::AtomicSizeT packetsReceived;
+
+    // only used by the thread that polls. `socketGeneration` is bumped on every connect and disconnect,
+    // which tells the poller that its registered sockets might not be valid anymore.
+    util::net::SocketPoller poller;
+    asp::AtomicU32 socketGeneration;
+    uint32_t polledGeneration = 0;
+
+    // reused for every send so that encoding doesn't have to grow a fresh buffer each time.
+    // sends mostly come from the network thread, but `disconnect` can send from any thread, hence the mutex.
+    // an encrypted packet encoded by `sendPackets`, which is encrypted together with the rest of the batch
+    struct DeferredEncryption {
+        ByteBuffer* buffer;
+        size_t offset;
+        size_t size;
+        bool session;
+    };
+
+    struct SendScratch {
+        ByteBuffer tcp;
+        std::vector<ByteBuffer> udp;
+        std::vector<UdpSocket::Datagram> datagrams;
+        std::vector<DeferredEncryption> deferred;
+        std::vector<CryptoBatchItem> boxItems;
+        std::vector<CryptoBatchItem> sessionItems;
+        // class of each entry in `datagrams`, consecutive datagrams of the same class are sent as one batch
+        std::vector<util::net::TrafficClass> classes;
+        // attached to the udp socket only with `lowLatency`, sends change its class so it lives under the same lock
+        util::net::TrafficMarker marker;
+    };
+
+    asp::Mutex<SendScratch> sendScratch;
+
     // Write a packet, packet header, and optionally length if the packet is TCP to the given buffer.
-    Result<> encodePacket(Packet& packet, ByteBuffer& buffer);
+    // If `deferred` is not null, encrypted packets are left unencrypted (with room for the prefix) and recorded there instead.
+    Result<> encodePacket(Packet& packet, ByteBuffer& buffer, std::vector<DeferredEncryption>* deferred = nullptr);
+
+    // Encrypt all packets recorded by `encodePacket`, in one batch per box
+    void encryptDeferred(SendScratch& scratch);
+
+    // Decode a packet from a buffer. Returns nullptr if it was an encrypted UDP packet that was already received.
+    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer, bool udp);
+
+    // Decompress the packet in `buffer` and replace it with a view of the decompressed data, positioned right after the header
+    Result<> decompressPacket(ByteBuffer& buffer, size_t messageLength);
+
+    // Bigger udp receive buffer, `TCP_NODELAY` and QoS marking. All of them are best effort, failures are only logged.
+    void applyLowLatencyOptions(SendScratch& scratch);
+
+    // Switch the marker to the class of `packet` before sending it, detaches the marker if that fails
+    void markTraffic(SendScratch& scratch, util::net::TrafficClass cls);
+
+    static util::net::TrafficClass trafficClassFor(const Packet& packet);
+
+    void dumpPacket(packetid_t id, bool encrypted, ByteBuffer& buffer, bool sending);
+
+    // Returns the size of the frame body at `tcpBufStart`, or 0 if the length prefix isn't fully buffered yet
+    uint32_t peekTcpFrameSize();
 
-    // Decode a packet from a buffer
-    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer);
+    // Receive more data into `tcpBuffer`, compacting it first if needed.
+    // The buffer grows to fit the frame being received and shrinks back once no big frame is pending.
+    Result<> fillTcpBuffer();
 
-    void dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending);
+    // Called after a datagram didn't fit in its slot
+    void growUdpSlots();
 };
@@ -4,7 +4,10 @@
 
 using namespace geode::prelude;
 
-PacketListener::~PacketListener() {}
+PacketListener::~PacketListener() {
+    // unlinks the listener from the pool, no-op if it was never registered
+    NetworkManager::get().unregisterPacketListener(packetId, this);
+}
 
 bool PacketListener::init(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal) {
     this->callback = std::move(fn);
@@ -16,8 +19,8 @@ bool PacketListener::init(packetid_t packetId, CallbackFn&& fn, CCObject* owner,
     return true;
 }
 
-void PacketListener::invokeCallback(std::shared_ptr<Packet> packet) {
-    callback(std::move(packet));
+void PacketListener::invokeCallback(Packet& packet) {
+    callback(packet);
 }
 
 PacketListener* PacketListener::create(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal) {
@@ -5,14 +5,14 @@
 
 class PacketListener : public cocos2d::CCObject {
 public:
-    using CallbackFn = std::function<void(std::shared_ptr<Packet>)>;
+    using CallbackFn = std::function<void(Packet&)>;
 
     ~PacketListener();
 
     // higher priority - runs earlier
     static PacketListener* create(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal);
 
-    void invokeCallback(std::shared_ptr<Packet> packet);
+    void invokeCallback(Packet& packet);
 
     packetid_t packetId;
     cocos2d::CCObject* owner;
@@ -20,7 +20,19 @@ public:
     bool isFinal;
 
 private:
+    friend class PacketListenerPool;
+
+    // Intrusive links into the list of listeners for `hook.packetId`, owned by `PacketListenerPool`.
+    // Lets the pool check for duplicates and unlink the listener in its destructor without searching.
+    struct Hook {
+        PacketListener* prev = nullptr;
+        PacketListener* next = nullptr;
+        packetid_t packetId = 0;
+        bool linked = false;
+    };
+
     CallbackFn callback;
+    Hook hook;
 
     bool init(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal);
 };
@@ -7,29 +7,91 @@
 #include <Geode/ui/GeodeUI.hpp>
 #include <asp/sync.hpp>
 #include <asp/thread.hpp>
+#include <atomic>
+#include <deque>
 
 #include <data/packets/all.hpp>
+#include <data/packets/pool.hpp>
 #include <defs/minimal_geode.hpp>
 #include <managers/account.hpp>
 #include <managers/admin.hpp>
 #include <managers/error_queues.hpp>
 #include <managers/game_server.hpp>
+#include <managers/level_prefetch.hpp>
+#include <managers/player_count.hpp>
 #include <managers/profile_cache.hpp>
 #include <managers/friend_list.hpp>
 #include <managers/settings.hpp>
 #include <managers/room.hpp>
 #include <managers/role.hpp>
 #include <util/cocos.hpp>
+#include <util/collections.hpp>
+#include <util/crypto.hpp>
+#include <util/debug.hpp>
 #include <util/format.hpp>
 #include <util/time.hpp>
 #include <util/net.hpp>
+#include <util/profiler.hpp>
+#include <util/thread.hpp>
 #include <ui/notification/panel.hpp>
 
 using namespace asp::sync;
 using namespace geode::prelude;
 using ConnectionState = NetworkManager::ConnectionState;
 
-static constexpr uint16_t PROTOCOL_VERSION = 6;
+static constexpr uint16_t PROTOCOL_VERSION = 7;
+
+// at most this many bulk packets are sent at once, so they can't hold up realtime packets queued right after them
+static constexpr size_t BULK_PACKETS_PER_FLUSH = 8;
+
+// minimum duration over which loss rate and bytes per second are calculated
+static constexpr auto TRAFFIC_STATS_WINDOW = util::time::seconds(1);
+
+// server pings that don't get a response within `PING_TICK * (PING_WHEEL_SLOTS - 1)` are dropped
+static constexpr auto PING_TICK = util::time::millis(100);
+// servers are pinged this often even when the server list isn't open, so that their latency stats stay current
+static constexpr auto BACKGROUND_PING_INTERVAL = util::time::seconds(30);
+static constexpr size_t PING_WHEEL_SLOTS = 50;
+
+// path MTU probes binary search for the largest `ConnectionTestPacket` that gets a response, between these sizes
+static constexpr uint16_t PMTU_PROBE_MIN = 1300;
+#ifdef GEODE_IS_MACOS
+// macos refuses to send udp datagrams above ~9kb by default ("message too long")
+static constexpr uint16_t PMTU_PROBE_MAX = 9000;
+#else
+static constexpr uint16_t PMTU_PROBE_MAX = 65000;
+#endif
+// the search stops once the bounds are this close together
+static constexpr uint16_t PMTU_PROBE_PRECISION = 256;
+static constexpr auto PMTU_PROBE_TIMEOUT = util::time::millis(1000);
+static constexpr uint8_t PMTU_PROBE_ATTEMPTS = 2;
+// the path is probed again when this much level data is lost, at most once per cooldown
+static constexpr float PMTU_REPROBE_LOSS = 0.2f;
+static constexpr auto PMTU_REPROBE_COOLDOWN = util::time::seconds(120);
+
+// how long idle threads wait for work, and how often the active server ping is refreshed, normally and in low power mode.
+// both threads are woken up right away when there's something to do, so this mostly decides how often they wake up for nothing
+static constexpr int RECV_IDLE_TIMEOUT_MS = 100;
+static constexpr int RECV_IDLE_TIMEOUT_LOW_POWER_MS = 500;
+static constexpr auto SEND_IDLE_TIMEOUT = util::time::millis(50);
+static constexpr auto SEND_IDLE_TIMEOUT_LOW_POWER = util::time::millis(250);
+static constexpr auto ACTIVE_PING_INTERVAL = util::time::seconds(5);
+static constexpr auto ACTIVE_PING_INTERVAL_LOW_POWER = util::time::seconds(20);
+
+// keepalives double as clock sync exchanges. right after connecting a few are sent in quick succession so the clock
+// is synced before a level is joined, after that they only need to keep up with drift between the two clocks.
+static constexpr size_t CLOCK_SYNC_BURST = 4;
+static constexpr auto CLOCK_SYNC_BURST_INTERVAL = util::time::millis(250);
+static constexpr auto CLOCK_SYNC_INTERVAL = util::time::seconds(15);
+
+// how long the server has to answer the handshake, and then the login (or the recovery data), before the attempt fails
+static constexpr auto HANDSHAKE_TIMEOUT = util::time::seconds(5);
+static constexpr auto LOGIN_TIMEOUT = util::time::seconds(5);
+// a lost connection is retried this many times, waiting the backoff times the attempt number in between
+static constexpr uint8_t MAX_RECOVERY_ATTEMPTS = 3;
+static constexpr auto RECOVERY_BACKOFF = util::time::seconds(10);
+// how often a waiting recovery checks if it was cancelled
+static constexpr auto RECOVERY_POLL_INTERVAL = util::time::millis(200);
 
 // yes, really
 struct AtomicConnectionState {
@@ -45,28 +107,56 @@ struct AtomicConnectionState {
     }
 };
 
-static std::string formatListenerKey(packetid_t id) {
-    return util::cocos::spr(fmt::format("packet-listener-{}", id));
-}
+// User object keys (`<mod id>/packet-listener-<id>`) for every server packet, built at compile time.
+// GEODE_MOD_ID is defined by the geode sdk, so this matches what `util::cocos::spr` would produce.
+static constexpr std::string_view LISTENER_KEY_PREFIX = GEODE_MOD_ID "/packet-listener-";
 
-struct WeakRefDummy {
-    std::shared_ptr<WeakRefController> ctrl;
+struct ListenerKey {
+    std::array<char, LISTENER_KEY_PREFIX.size() + 5> data{}; // packetid_t has at most 5 digits
+    size_t length = 0;
 };
 
-template <typename T>
-static void* addrFromWeakRef(const WeakRef<T>& ref) {
-    // Do not do this.
-    auto dummy = reinterpret_cast<const WeakRefDummy&>(ref);
-    return dummy.ctrl ? dummy.ctrl->get() : nullptr;
-}
+static constexpr std::array<ListenerKey, ServerPacketTypes::size> LISTENER_KEYS = [] {
+    std::array<ListenerKey, ServerPacketTypes::size> out{};
 
-template <typename T>
-static const WeakRefController& controllerFromWeakRef(const WeakRef<T>& ref) {
-    // Do not do this.
-    auto dummy = reinterpret_cast<const WeakRefDummy&>(ref);
-    return *dummy.ctrl;
-}
+    for (size_t i = 0; i < out.size(); i++) {
+        auto& key = out[i];
+        for (char c : LISTENER_KEY_PREFIX) key.data[key.length++] = c;
+
+        char digits[5];
+        size_t count = 0;
+        packetid_t id = ServerPacketTypes::sortedIds[i];
+        do {
+            digits[count++] = '0' + id % 10;
+            id /= 10;
+        } while (id != 0);
+
+        while (count > 0) key.data[key.length++] = digits[--count];
+    }
+
+    return out;
+}();
+
+// `setUserObject` wants a `std::string`, so the keys are interned once instead of formatted on every add or remove
+static const std::string& listenerKey(packetid_t id) {
+    static const auto interned = [] {
+        std::array<std::string, ServerPacketTypes::size> out;
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i].assign(LISTENER_KEYS[i].data.data(), LISTENER_KEYS[i].length);
+        }
+        return out;
+    }();
+
+    size_t idx = ServerPacketTypes::indexOf(id);
+    if (idx < interned.size()) [[likely]] {
+        return interned[idx];
+    }
 
+    // only the main thread adds and removes listeners
+    static std::string fallback;
+    fallback = util::cocos::spr(fmt::format("packet-listener-{}", id));
+    return fallback;
+}
 
 // Packet listener pool. Most of the functions must not be used on a different thread than main.
 class PacketListenerPool : public CCObject {
@@ -82,80 +172,158 @@ public:
     }
 
     // Must be called from the main thread. Delivers packets to all listeners that are tied to an object.
+    // Stops early once the frame is over budget, but always delivers at least `MIN_MAIL_PER_FRAME` packets so a flood can't stall it.
     void update(float dt) {
-        if (packetQueue.empty()) return;
+        bool hasOverflow = overflowPending.load(std::memory_order_acquire) != 0;
+        if (mailbox.empty() && !hasOverflow) return;
 
-        // clear any dead listeners
-        this->removeDeadListeners();
+        GLOBED_PROFILE_ZONE("PacketListenerPool::update");
+        util::debug::MainThreadTimer::Scope mainThreadScope(util::debug::MainThreadTimer::Section::PacketListeners);
+        auto& timer = util::debug::MainThreadTimer::get();
 
-        while (auto packet_ = packetQueue.tryPop()) {
-            auto& packet = packet_.value();
-            packetid_t id = packet->getPacketId();
+        size_t delivered = 0;
+        auto canContinue = [&] {
+            return delivered < MIN_MAIL_PER_FRAME || timer.hasBudget();
+        };
 
-            bool invoked = false;
-            auto& lsm = listeners[id];
+        while (canContinue()) {
+            auto packet = mailbox.tryPop();
+            if (!packet) break;
 
-            for (auto& listener : lsm) {
-                if (auto l = listener.lock()) {
-                    l->invokeCallback(packet);
-                }
+            this->dispatch(**packet);
+            delivered++;
+        }
+
+        // the producer only writes to the overflow channel while it is non-empty, so draining it after the ring keeps the order
+        if (hasOverflow) {
+            while (canContinue()) {
+                auto packet = overflowQueue.tryPop();
+                if (!packet) break;
+
+                overflowPending.fetch_sub(1, std::memory_order_release);
+                this->dispatch(**packet);
+                delivered++;
             }
         }
     }
 
-    void removeDeadListeners() {
-        for (auto& [id, listeners] : listeners) {
-            for (int i = listeners.size() - 1; i >= 0; i--) {
-                auto addr = addrFromWeakRef(listeners[i]);
+    void dispatch(Packet& packet) {
+        packetid_t id = packet.getPacketId();
 
-                if (!listeners[i].valid()) {
-#ifdef GLOBED_DEBUG
-                    log::debug("Unregistering listener {} (id {})", addr, id);
-#endif
-                    // log::debug("removing listener for {}", id);
-                    listeners.erase(listeners.begin() + i);
-                }
-            }
+        auto& slot = this->slotFor(id);
+
+        // callbacks may add listeners (appended to the tail, so they run too) or destroy other ones (which unlink themselves).
+        // the current one is kept alive, so its `next` is only read after the callback, when it's up to date.
+        for (auto* listener = slot.head; listener;) {
+            Ref<PacketListener> keepAlive(listener);
+            listener->invokeCallback(packet);
+            listener = listener->hook.next;
         }
     }
 
     void registerListener(packetid_t id, PacketListener* listener) {
+        auto& hook = listener->hook;
+
+        if (hook.linked) {
+            log::warn("duped listener ({}, id {}, owner {}), not adding again", listener, id, listener->owner);
+            return;
+        }
+
 #ifdef GLOBED_DEBUG
         log::debug("Registering listener {} (id {}) for {}", listener, id, listener->owner);
 #endif
 
-        auto& ls = listeners[id];
+        auto& slot = this->slotFor(id);
 
-        this->removeDeadListeners();
+        hook.packetId = id;
+        hook.prev = slot.tail;
+        hook.next = nullptr;
+        hook.linked = true;
 
-        // verify it's not a duplicate
-        bool duped = false;
-        for (auto& l : ls) {
-            if (l.lock() == listener) {
-                duped = true;
-                break;
-            }
+        if (slot.tail) {
+            slot.tail->hook.next = listener;
+        } else {
+            slot.head = listener;
         }
 
-        if (!duped) {
-            ls.push_back(WeakRef(listener));
+        slot.tail = listener;
+    }
+
+    // Called from the listener's destructor
+    void unregisterListener(PacketListener* listener) {
+        auto& hook = listener->hook;
+        if (!hook.linked) return;
+
+#ifdef GLOBED_DEBUG
+        log::debug("Unregistering listener {} (id {})", listener, hook.packetId);
+#endif
+
+        auto& slot = this->slotFor(hook.packetId);
+
+        if (hook.prev) {
+            hook.prev->hook.next = hook.next;
         } else {
-            log::warn("duped listener ({}, id {}, owner {}), not adding again", listener, id, listener->owner);
+            slot.head = hook.next;
         }
+
+        if (hook.next) {
+            hook.next->hook.prev = hook.prev;
+        } else {
+            slot.tail = hook.prev;
+        }
+
+        hook = {};
     }
 
-    // Push a packet to the queue. Thread safe.
+    // Push a packet to the queue. Must only be called from the network (in) thread.
     void pushPacket(std::shared_ptr<Packet> packet) {
-        packetQueue.push(std::move(packet));
+        // once we overflowed, keep using the overflow channel until the main thread drains it, so packets stay in order
+        if (overflowPending.load(std::memory_order_acquire) == 0 && mailbox.tryPush(std::move(packet))) {
+            return;
+        }
+
+        overflowCount.fetch_add(1, std::memory_order_relaxed);
+        overflowPending.fetch_add(1, std::memory_order_release);
+        overflowQueue.push(std::move(packet));
+    }
+
+    // Returns how many packets did not fit into the ring buffer since startup
+    size_t getOverflowCount() {
+        return overflowCount.load(std::memory_order_relaxed);
     }
 
 private:
-    std::unordered_map<packetid_t, std::vector<WeakRef<PacketListener>>> listeners;
-    asp::Channel<std::shared_ptr<Packet>> packetQueue;
+    static constexpr size_t PACKET_QUEUE_SIZE = 1024;
+    static constexpr size_t MIN_MAIL_PER_FRAME = 32;
+
+    // intrusive list of listeners, linked through `PacketListener::hook`, in registration order
+    struct ListenerSlot {
+        PacketListener* head = nullptr;
+        PacketListener* tail = nullptr;
+    };
+
+    // indexed by `ServerPacketTypes::indexOf`, IDs that aren't known server packets go into `unknownListeners`
+    std::array<ListenerSlot, ServerPacketTypes::size> listeners;
+    std::unordered_map<packetid_t, ListenerSlot> unknownListeners;
+    util::collections::SpscQueue<std::shared_ptr<Packet>, PACKET_QUEUE_SIZE> mailbox;
+
+    // fallback for when the main thread is stalled (i.e. loading) and the ring fills up
+    asp::Channel<std::shared_ptr<Packet>> overflowQueue;
+    std::atomic<size_t> overflowPending = 0;
+    std::atomic<size_t> overflowCount = 0;
 
     PacketListenerPool() {
         CCScheduler::get()->scheduleSelector(schedule_selector(PacketListenerPool::update), this, 0.f, false);
     }
+
+    ListenerSlot& slotFor(packetid_t id) {
+        size_t idx = ServerPacketTypes::indexOf(id);
+        if (idx < listeners.size()) {
+            return listeners[idx];
+        }
+
+        return unknownListeners[id];
+    }
 };
 
 class NetworkManager::Impl {
@@ -165,9 +333,10 @@ protected:
 
     static constexpr int BUILTIN_LISTENER_PRIORITY = -10000000;
 
-    struct TaskPingServers {};
     struct TaskSendPacket {
         std::shared_ptr<Packet> packet;
+        util::time::time_point queuedAt;
+        bool latest = false; // may be replaced by a newer packet of the same type, see `NetworkManager::sendLatest`
     };
     struct TaskPingActive {};
 
@@ -177,13 +346,21 @@ protected:
         PacketListener::CallbackFn callback;
     };
 
-    using Task = std::variant<TaskPingServers, TaskSendPacket, TaskPingActive>;
+    using Task = std::variant<TaskSendPacket, TaskPingActive>;
 
     AtomicConnectionState state;
     GameSocket socket;
-    asp::Thread<NetworkManager::Impl*> threadRecv, threadMain;
+    asp::Thread<NetworkManager::Impl*> threadRecv, threadMain, threadPing;
     asp::Channel<Task> taskQueue;
 
+    // server pinging has its own socket and thread, so a big server list never delays real packets
+    GameSocket pingSocket;
+    AtomicBool pingRequested;
+    util::collections::TimerWheel<uint32_t, PING_WHEEL_SLOTS> pingWheel; // only used by the ping thread
+    util::time::time_point lastPingTick; // only used by the ping thread
+    util::time::time_point lastServerPings; // only used by the ping thread
+    std::vector<GameSocket::ReceivedPacket> pingRecvBatch; // only used by the ping thread
+
     // Note that we intentionally don't use Ref here,
     // as we use the destructor to know if the object owning the listener has been destroyed.
     asp::Mutex<std::unordered_map<packetid_t, GlobalListener>> listeners;
@@ -195,16 +372,107 @@ protected:
     util::time::time_point lastReceivedPacket;
     util::time::time_point lastSentKeepalive;
     util::time::time_point lastTcpExchange;
+    std::vector<GameSocket::ReceivedPacket> recvBatch; // only used by the recv thread
+    std::vector<std::shared_ptr<Packet>> sendBatch; // only used by the main network thread
+    std::array<std::deque<TaskSendPacket>, TRAFFIC_LANE_COUNT> lanes; // only used by the main network thread
+    asp::Mutex<std::array<LaneStats, TRAFFIC_LANE_COUNT>> laneStats;
+
+    struct TrafficStats {
+        // level data stream, updated by the receive thread
+        bool streamStarted = false;
+        uint32_t baseSequence = 0;
+        uint32_t highestSequence = 0;
+        int64_t lastTransit = 0; // microseconds, relative to an unknown offset
+        ConnectionStats out;
+
+        // the rates are calculated over windows of at least `TRAFFIC_STATS_WINDOW`
+        util::time::time_point windowStart;
+        size_t windowBytesIn = 0;
+        size_t windowBytesOut = 0;
+        size_t windowPacketsIn = 0;
+        size_t windowPacketsOut = 0;
+        uint64_t windowExpected = 0;
+        uint64_t windowReceived = 0;
+
+        uint64_t expected() const {
+            return streamStarted ? static_cast<uint64_t>(highestSequence - baseSequence) + 1 : 0;
+        }
+    };
+
+    asp::Mutex<TrafficStats> trafficStats;
+
+    // Progress of the current connection attempt, see `updateConnection`. Each phase ends when the next one starts,
+    // a phase that hasn't been reached yet (or was skipped, like the handshake when resuming a session) is left at zero.
+    struct ConnectAttempt {
+        util::time::time_point started;
+        util::time::time_point resolved;
+        util::time::time_point connected;  // handshake or recovery data sent
+        util::time::time_point handshaken; // handshake response received
+        util::time::time_point loggedIn;
+        util::time::time_point deadline;   // of the phase that waits on the server
+        util::time::time_point retryAt;    // when recovering, the next attempt is not made before this
+
+        static float phaseMs(util::time::time_point from, util::time::time_point to) {
+            if (from == util::time::time_point{} || to == util::time::time_point{}) return 0.f;
+            return util::time::asMicros(to - from) / 1000.f;
+        }
+    };
+
+    // written by the main network thread, and by the receive thread once the server answers
+    asp::Mutex<ConnectAttempt> connectAttempt;
+
+    // Binary search for the largest UDP packet that makes it to the server and back, see `updatePathMtuProbe`
+    struct PathMtuProbe {
+        bool active = false;
+        bool acked = false; // whether any probe got a response, if none did the server likely doesn't answer them at all
+        uint16_t low = 0;   // largest size that got a response
+        uint16_t high = 0;  // smallest size that didn't
+        uint16_t current = 0;
+        uint8_t attempt = 0;
+        uint32_t uid = 0;
+        util::time::time_point sentAt;
+        util::time::time_point finishedAt;
+    };
+
+    PathMtuProbe pmtuProbe; // only used by the main network thread
+    AtomicBool pmtuRequested;
+    AtomicU32 pmtuAckedUid; // set by the receive thread
+    AtomicU32 pathMtu; // result for the current server and network, 0 if unknown
+    std::string pmtuCacheKey; // set by the main network thread before logging in
+    // cached limits of the server being connected to, by local address. read in `connect` so the network thread can pick one
+    // once it knows which local address the connection ended up on, without touching the save container
+    std::unordered_map<std::string, int> pmtuCandidates;
+    std::optional<RoomInfo> pendingRoomRejoin; // only used on the main thread
 
     AtomicBool suspended;
+    AtomicBool lowPowerIdle;
+
+    // the estimator is only touched on keepalive exchanges, the result is published separately so `serverTime` stays cheap
+    asp::Mutex<util::time::ClockSync> clockSync;
+    std::atomic<int64_t> clockOffset = 0; // microseconds, server minus local
+    // microseconds, each written by its own thread, see `getThreadCpuTime`
+    std::atomic<int64_t> recvThreadCpu = 0;
+    std::atomic<int64_t> mainThreadCpu = 0;
+    AtomicBool clockSynced;
     AtomicBool standalone;
     AtomicBool recovering;
+    AtomicBool restartLoginRequested; // set by the receive thread, the network thread does the restart
+    AtomicBool retryingLogin; // the login is being retried with a new token, after the old one was rejected
     AtomicU8 recoverAttempt;
     AtomicBool ignoreProtocolMismatch;
     AtomicBool wasFromRecovery;
     AtomicBool cancellingRecovery;
     AtomicU32 secretKey;
     AtomicU32 serverTps;
+    // picked by the server during the handshake, reset before the handshake is sent and read once the response arrives
+    SessionCipher sessionCipher = SessionCipher::XChaCha20Poly1305;
+
+    // built on the main thread in `connect`, because it needs the icons and the auth token. the network thread fills in
+    // the fragmentation limit and sends it, either together with the handshake or after the handshake response
+    std::shared_ptr<LoginPacket> pendingLogin;
+    // public key of the server from the last successful handshake, lets the login be sent in the same flight as the handshake
+    std::optional<util::data::bytearray<CryptoBox::KEY_LEN>> cachedServerKey;
+    bool pipelinedLogin = false; // only used by the network threads
 
     Impl() {
         // initialize winsock
@@ -215,12 +483,28 @@ protected:
         // start up the threads
 
         threadRecv.setLoopFunction(&NetworkManager::Impl::threadRecvFunc);
-        threadRecv.setStartFunction([] { geode::utils::thread::setName("Network Thread (in)"); });
+        threadRecv.setStartFunction([] {
+            geode::utils::thread::setName("Network Thread (in)");
+            GLOBED_PROFILE_THREAD("Network Thread (in)");
+            util::thread::configureCurrent(util::thread::Priority::TimeCritical, util::thread::CoreHint::Performance);
+        });
         threadRecv.start(this);
 
         threadMain.setLoopFunction(&NetworkManager::Impl::threadMainFunc);
-        threadMain.setStartFunction([] { geode::utils::thread::setName("Network Thread (out)"); });
+        threadMain.setStartFunction([] {
+            geode::utils::thread::setName("Network Thread (out)");
+            GLOBED_PROFILE_THREAD("Network Thread (out)");
+            util::thread::configureCurrent(util::thread::Priority::High, util::thread::CoreHint::Performance);
+        });
         threadMain.start(this);
+
+        lastPingTick = util::time::now();
+        threadPing.setLoopFunction(&NetworkManager::Impl::threadPingFunc);
+        threadPing.setStartFunction([] {
+            geode::utils::thread::setName("Network Thread (ping)");
+            GLOBED_PROFILE_THREAD("Network Thread (ping)");
+        });
+        threadPing.start(this);
     }
 
     ~Impl() {
@@ -230,6 +514,7 @@ protected:
         log::debug("waiting for network threads to terminate..");
         threadRecv.stopAndWait();
         threadMain.stopAndWait();
+        threadPing.stopAndWait();
 
         if (state != ConnectionState::Disconnected) {
             log::debug("disconnecting from the server..");
@@ -264,15 +549,28 @@ protected:
         lastSentKeepalive = util::time::now();
         lastTcpExchange = util::time::now();
 
+        // the new server may have a different clock, but the old offset stays published until the first new sample
+        // replaces it, so a level that is still open doesn't fall back to the local clock in the meantime
+        clockSync.lock()->reset();
+
         if (!standalone) {
             GLOBED_REQUIRE_SAFE(!GlobedAccountManager::get().authToken.lock()->empty(), "attempting to connect with no authtoken set in account manager")
         }
 
         connectedAddress = address;
         connectedServerId = std::string(serverId);
+        socket.lowLatency = GlobedSettings::get().globed.lowLatencySockets.get();
+
+        *laneStats.lock() = {};
+        this->resetTrafficStats();
         recovering = false;
+        restartLoginRequested = false;
         recoverAttempt = 0;
 
+        pendingLogin = this->buildLoginPacket();
+        cachedServerKey = this->loadServerKey();
+        this->loadPathMtuCandidates();
+
         state = ConnectionState::TcpConnecting;
 
         // actual connection is deferred - the network thread does DNS resolution and TCP connection.
@@ -286,6 +584,7 @@ protected:
         state = ConnectionState::Disconnected;
         standalone = false;
         recovering = false;
+        restartLoginRequested = false;
         cancellingRecovery = false;
         recoverAttempt = 0;
 
@@ -296,7 +595,8 @@ protected:
 
         socket.disconnect();
 
-        // singletons could have been destructed before NetworkManager, so this could be UB. Additionally will break autoconnect.
+        // these singletons are initialized before NetworkManager (see `initSingletons`), so they are still alive here even when it's being destroyed.
+        // this does break autoconnect though.
         if (!noclear) {
             RoomManager::get().setGlobal();
             GameServerManager::get().clearActive();
@@ -317,14 +617,16 @@ protected:
         ErrorQueues::get().debugWarn(reason);
     }
 
-    void send(std::shared_ptr<Packet> packet) {
+    void send(std::shared_ptr<Packet> packet, bool latest = false) {
         taskQueue.push(TaskSendPacket {
-            .packet = std::move(packet)
+            .packet = std::move(packet),
+            .queuedAt = util::time::now(),
+            .latest = latest,
         });
     }
 
     void pingServers() {
-        taskQueue.push(TaskPingServers {});
+        pingRequested = true;
     }
 
     void updateServerPing() {
@@ -343,7 +645,7 @@ protected:
 
     void addListener(CCNode* target, PacketListener* listener) {
         if (target) {
-            target->setUserObject(formatListenerKey(listener->packetId), listener);
+            target->setUserObject(listenerKey(listener->packetId), listener);
         } else {
             // if target is nullptr we leak the listener,
             // essentially saying it should live for the entire duration of the program.
@@ -358,14 +660,13 @@ protected:
     }
 
     void removeListener(cocos2d::CCNode* target, packetid_t id) {
-        auto key = util::cocos::spr(fmt::format("packet-listener-{}", id));
-
-        target->setUserObject(key, nullptr);
+        target->setUserObject(listenerKey(id), nullptr);
 
         // the listener will unregister itself in the destructor.
     }
 
     void unregisterPacketListener(packetid_t packet, PacketListener* listener, bool suppressUnhandled) {
+        PacketListenerPool::get().unregisterListener(listener);
     }
 
     void suppressUnhandledUntil(packetid_t id, util::time::system_time_point point) {
@@ -384,12 +685,12 @@ protected:
 
     template <HasPacketID Pty>
     void addGlobalListener(PacketCallbackSpecific<Pty>&& callback) {
-        this->addGlobalListener(Pty::PACKET_ID, [callback = std::move(callback)](std::shared_ptr<Packet> pkt) {
-            callback(std::static_pointer_cast<Pty>(pkt));
+        this->addGlobalListener(Pty::PACKET_ID, [callback = std::move(callback)](Packet& pkt) {
+            callback(static_cast<Pty&>(pkt));
         });
     }
 
-    // adds a global listener, which always runs NOT on the main thread and always before other listeners
+    // adds a global listener, which always runs on the network thread, before other listeners
     void addInternalListener(packetid_t id, PacketCallback&& callback) {
         GlobalListener listener {
             .packetId = id,
@@ -405,18 +706,8 @@ protected:
 
     template <HasPacketID Pty>
     void addInternalListener(PacketCallbackSpecific<Pty>&& callback) {
-        this->addInternalListener(Pty::PACKET_ID, [cb = std::move(callback)](std::shared_ptr<Packet> packet) {
-            cb(std::static_pointer_cast<Pty>(std::move(packet)));
-        });
-    }
-
-    // same as `addInternalListener` but runs the callback on the main thread
-    template <HasPacketID Pty>
-    void addInternalListenerSync(PacketCallbackSpecific<Pty>&& callback) {
-        this->addInternalListener<Pty>([cb = std::move(callback)](std::shared_ptr<Pty> packet) {
-            Loader::get()->queueInMainThread([cb = std::move(cb), packet = std::move(packet)] {
-                cb(std::move(packet));
-            });
+        this->addInternalListener(Pty::PACKET_ID, [cb = std::move(callback)](Packet& packet) {
+            cb(static_cast<Pty&>(packet));
         });
     }
 
@@ -425,59 +716,91 @@ protected:
     void setupGlobalListeners() {
         // Connection packets
 
-        addInternalListenerSync<CryptoHandshakeResponsePacket>([this](auto packet) {
-            this->onCryptoHandshakeResponse(std::move(packet));
+        // the handshake is handled entirely on the network thread, so that logging in doesn't wait for the next frame
+
+        addInternalListener<SessionCipherPacket>([this](auto& packet) {
+            // the server only ever picks a cipher we said we support. if it doesn't, falling back to another one
+            // would only make every encrypted packet fail to authenticate, on both sides
+            if (packet.cipher == (uint8_t) SessionCipher::Aes256Gcm && AesGcmSecretBox::isAvailable()) {
+                sessionCipher = SessionCipher::Aes256Gcm;
+            } else if (packet.cipher == (uint8_t) SessionCipher::XChaCha20Poly1305) {
+                sessionCipher = SessionCipher::XChaCha20Poly1305;
+            } else {
+                this->disconnectWithMessage(fmt::format("server picked an unsupported session cipher ({})", packet.cipher));
+            }
         });
 
-        addInternalListener<KeepaliveResponsePacket>([](auto packet) {
-            GameServerManager::get().finishKeepalive(packet->playerCount);
+        addInternalListener<CryptoHandshakeResponsePacket>([this](auto& packet) {
+            this->onCryptoHandshakeResponse(packet);
         });
 
-        addInternalListener<KeepaliveTCPResponsePacket>([](auto) {});
+        addInternalListener<KeepaliveResponsePacket>([this](auto& packet) {
+            GameServerManager::get().finishKeepalive(packet.playerCount);
+            this->onClockSample(packet.clientTime, packet.serverTime);
+        });
+
+        addInternalListener<KeepaliveTCPResponsePacket>([](auto&) {});
+
+        addInternalListener<ConnectionTestResponsePacket>([this](auto& packet) {
+            pmtuAckedUid = packet.uid;
+        });
 
-        addInternalListener<ServerDisconnectPacket>([this](auto packet) {
-            this->disconnectWithMessage(packet->message);
+        addInternalListener<ServerDisconnectPacket>([this](auto& packet) {
+            this->disconnectWithMessage(packet.message);
         });
 
-        addInternalListener<LoggedInPacket>([this](auto packet) {
-            this->onLoggedIn(std::move(packet));
+        addInternalListener<LoggedInPacket>([this](auto& packet) {
+            this->onLoggedIn(packet);
         });
 
-        addInternalListener<LoginFailedPacket>([this](auto packet) {
-            ErrorQueues::get().error(fmt::format("<cr>Authentication failed!</c> The server rejected the login attempt.\n\nReason: <cy>{}</c>", packet->message));
-            GlobedAccountManager::get().authToken.lock()->clear();
+        addInternalListener<LoginFailedPacket>([this](auto& packet) {
+            GlobedAccountManager::get().clearAuthToken();
+
+            // a saved token can expire sooner than `AUTH_TOKEN_REFRESH_AGE` if the central server says so, get a new one and try again, once
+            if (packet.tokenRejected && !retryingLogin) {
+                log::info("Login token was rejected ({}), requesting a new one", packet.message);
+                retryingLogin = true;
+
+                auto address = connectedAddress;
+                auto serverId = connectedServerId;
+                this->disconnect(true);
+
+                Loader::get()->queueInMainThread([this, address = std::move(address), serverId = std::move(serverId)] {
+                    GlobedAccountManager::get().requestAuthToken([this, address, serverId] {
+                        GLOBED_RESULT_ERRC(this->connect(address, serverId, false));
+                    });
+                });
+
+                return;
+            }
+
+            retryingLogin = false;
+            ErrorQueues::get().error(fmt::format("<cr>Authentication failed!</c> The server rejected the login attempt.\n\nReason: <cy>{}</c>", packet.message));
             this->disconnect(true);
         });
 
-        addInternalListener<ProtocolMismatchPacket>([this](auto packet) {
-            this->onProtocolMismatch(std::move(packet));
+        addInternalListener<ProtocolMismatchPacket>([this](auto& packet) {
+            this->onProtocolMismatch(packet);
         });
 
-        addInternalListener<ClaimThreadFailedPacket>([this](auto packet) {
+        addInternalListener<ClaimThreadFailedPacket>([this](auto& packet) {
             this->disconnectWithMessage("failed to claim udp thread");
         });
 
-        addInternalListener<LoginRecoveryFailecPacket>([this](auto packet) {
+        addInternalListener<LoginRecoveryFailecPacket>([this](auto& packet) {
             log::debug("Login recovery failed, retrying regular connection");
-
-            // failed to recover login, try regular connection
-            this->disconnect(true);
-            auto result = this->connect(connectedAddress, connectedServerId, standalone, true);
-
-            if (!result) {
-                log::warn("failed to reconnect: {}", result.unwrapErr());
-                this->onConnectionError("[Globed] failed to reconnect");
-            }
+            // the connection state belongs to the network thread, which could otherwise fail the attempt at the same time
+            restartLoginRequested = true;
         });
 
-        addGlobalListener<ServerNoticePacket>([](auto packet) {
-            ErrorQueues::get().notice(packet->message);
+        addGlobalListener<ServerNoticePacket>([](auto& packet) {
+            ErrorQueues::get().notice(packet.message);
         });
 
-        addGlobalListener<ServerBannedPacket>([this](auto packet) {
+        addGlobalListener<ServerBannedPacket>([this](auto& packet) {
             using namespace std::chrono;
 
-            std::string reason = packet->message;
+            std::string reason = packet.message;
             if (reason.empty()) {
                 reason = "No reason given";
             }
@@ -485,16 +808,16 @@ protected:
             auto msg = fmt::format(
                 "<cy>You have been</c> <cr>Banned:</c>\n{}\n<cy>Expires at:</c>\n{}\n<cy>Question/Appeals? Join the </c><cb>Discord.</c>",
                 reason,
-                packet->timestamp == 0 ? "Permanent" : util::format::formatDateTime(sys_seconds(seconds(packet->timestamp)), false)
+                packet.timestamp == 0 ? "Permanent" : util::format::formatDateTime(sys_seconds(seconds(packet.timestamp)), false)
             );
 
             this->disconnectWithMessage(msg);
         });
 
-        addGlobalListener<ServerMutedPacket>([](auto packet) {
+        addGlobalListener<ServerMutedPacket>([](auto& packet) {
             using namespace std::chrono;
 
-            std::string reason = packet->reason;
+            std::string reason = packet.reason;
             if (reason.empty()) {
                 reason = "No reason given";
             }
@@ -502,7 +825,7 @@ protected:
             auto msg = fmt::format(
                 "<cy>You have been</c> <cr>Muted:</c>\n{}\n<cy>Expires at:</c>\n{}\n<cy>Question/Appeals? Join the </c><cb>Discord.</c>",
                 reason,
-                packet->timestamp == 0 ? "Permanent" : util::format::formatDateTime(sys_seconds(seconds(packet->timestamp)), false)
+                packet.timestamp == 0 ? "Permanent" : util::format::formatDateTime(sys_seconds(seconds(packet.timestamp)), false)
             );
 
             ErrorQueues::get().notice(msg);
@@ -510,18 +833,18 @@ protected:
 
         // General packets
 
-        addGlobalListener<RolesUpdatedPacket>([](auto packet) {
+        addGlobalListener<RolesUpdatedPacket>([](auto& packet) {
             auto& pcm = ProfileCacheManager::get();
-            pcm.setOwnSpecialData(packet->specialUserData);
+            pcm.setOwnSpecialData(packet.specialUserData);
         });
 
         // Room packets
 
-        addGlobalListener<RoomInvitePacket>([](auto packet) {
+        addGlobalListener<RoomInvitePacket>([](auto& packet) {
             using InvitesFrom = GlobedSettings::InvitesFrom;
 
             // check if allowed
-            int inviter = packet->playerData.accountId;
+            int inviter = packet.playerData.accountId;
             InvitesFrom setting = static_cast<InvitesFrom>((int)GlobedSettings::get().globed.invitesFrom);
 
             if (setting == InvitesFrom::Nobody) {
@@ -530,54 +853,106 @@ protected:
                 return;
             }
 
-            GlobedNotificationPanel::get()->addInviteNotification(packet->roomID, packet->password, packet->playerData);
+            GlobedNotificationPanel::get()->addInviteNotification(packet.roomID, packet.password, packet.playerData);
         });
 
-        addGlobalListener<RoomInfoPacket>([](auto packet) {
+        addGlobalListener<RoomInfoPacket>([](auto& packet) {
             ErrorQueues::get().success("Room configuration updated");
 
-            RoomManager::get().setInfo(packet->info);
+            RoomManager::get().setInfo(packet.info);
+        });
+
+        // keeps the player list up to date while no room layer is open, runs after (and is a no-op for) the layer's own listener
+        addGlobalListener<RoomPlayersDiffPacket>([](auto& packet) {
+            RoomManager::get().applyDiff(packet.version, packet.updated, packet.removed);
         });
 
-        addGlobalListener<RoomJoinedPacket>([](auto packet) {});
+        addGlobalListener<RoomJoinedPacket>([this](auto& packet) {
+            // we are back in the room we were in before the session was lost
+            if (pendingRoomRejoin) {
+                RoomManager::get().setInfo(pendingRoomRejoin.value());
+                pendingRoomRejoin.reset();
+            }
+
+            // joining a room takes us out of the level, including one that is still loading
+            LevelPrefetchManager::get().resync();
+        });
+
+        // profiles can arrive before the level is done loading, see `LevelPrefetchManager`
+        addGlobalListener<PlayerProfilesPacket>([](auto& packet) {
+            LevelPrefetchManager::get().loadProfiles(packet.players);
+        });
+
+        addGlobalListener<RoomJoinFailedPacket>([this](auto& packet) {
+            pendingRoomRejoin.reset();
 
-        addGlobalListener<RoomJoinFailedPacket>([](auto packet) {
             // TODO: handle reason
             std::string reason = "N/A";
-            if (packet->wasInvalid) reason = "Room doesn't exist";
-            if (packet->wasProtected) reason = "Room password is wrong";
-            if (packet->wasFull) reason = "Room is full";
-            if (!packet->wasProtected) ErrorQueues::get().error(fmt::format("Failed to join room: {}", reason)); //TEMPORARY disable wrong password alerts
+            if (packet.wasInvalid) reason = "Room doesn't exist";
+            if (packet.wasProtected) reason = "Room password is wrong";
+            if (packet.wasFull) reason = "Room is full";
+            if (!packet.wasProtected) ErrorQueues::get().error(fmt::format("Failed to join room: {}", reason)); //TEMPORARY disable wrong password alerts
         });
 
         // Admin packets
 
-        addGlobalListener<AdminAuthSuccessPacket>([this](auto packet) {
-            AdminManager::get().setAuthorized(std::move(packet->role));
+        addGlobalListener<AdminAuthSuccessPacket>([this](auto& packet) {
+            AdminManager::get().setAuthorized(std::move(packet.role));
             ErrorQueues::get().success("Successfully authorized");
         });
 
-        addGlobalListener<AdminAuthFailedPacket>([this](auto packet) {
+        addGlobalListener<AdminAuthFailedPacket>([this](auto& packet) {
             ErrorQueues::get().warn("Login failed");
 
             auto& am = GlobedAccountManager::get();
             am.clearAdminPassword();
         });
 
-        addGlobalListener<AdminSuccessMessagePacket>([](auto packet) {
-            ErrorQueues::get().success(packet->message);
+        addGlobalListener<AdminSuccessMessagePacket>([](auto& packet) {
+            ErrorQueues::get().success(packet.message);
         });
 
-        addGlobalListener<AdminErrorPacket>([](auto packet) {
-            ErrorQueues::get().warn(packet->message);
+        addGlobalListener<AdminErrorPacket>([](auto& packet) {
+            ErrorQueues::get().warn(packet.message);
         });
     }
 
-    void onCryptoHandshakeResponse(std::shared_ptr<CryptoHandshakeResponsePacket> packet) {
-        log::debug("handshake successful, logging in");
-        auto key = packet->data.key;
+    void onCryptoHandshakeResponse(CryptoHandshakeResponsePacket& packet) {
+        {
+            auto attempt = connectAttempt.lock();
+            attempt->handshaken = util::time::now();
+            attempt->deadline = attempt->handshaken + LOGIN_TIMEOUT;
+        }
+
+        auto key = packet.data.key;
+        bool loginSent = pipelinedLogin && cachedServerKey == key;
+
+        if (!loginSent) {
+            socket.cryptoBox->setPeerKey(key.data());
+        }
+
+        if (this->serverMatchesProtocol()) {
+            socket.createSessionBox(sessionCipher);
+            log::debug("using {} for udp packets", sessionCipher == SessionCipher::Aes256Gcm ? "AES-256-GCM" : "XChaCha20-Poly1305");
+        }
+
+        if (loginSent) {
+            log::debug("handshake successful, login was already sent");
+            return;
+        }
+
+        // either the first connection to this server, or it restarted and the server dropped our login
+        log::debug("handshake successful, logging in{}", pipelinedLogin ? " (cached server key was outdated)" : "");
+        this->send(pendingLogin);
+
+        cachedServerKey = key;
+        Loader::get()->queueInMainThread([serverId = connectedServerId, key] {
+            GlobedSettings::get().store(fmt::format("_gskey-{}", serverId), util::crypto::base64Encode(key.data(), key.size()));
+        });
+    }
 
-        socket.cryptoBox->setPeerKey(key.data());
+    // Runs on the main thread, the fragmentation limit is filled in later by `finishLoginPacket`
+    std::shared_ptr<LoginPacket> buildLoginPacket() {
         auto& am = GlobedAccountManager::get();
         std::string authtoken;
 
@@ -596,7 +971,7 @@ protected:
         }
 
         auto gddata = am.gdData.lock();
-        auto pkt = LoginPacket::create(
+        return std::make_shared<LoginPacket>(
             gddata->accountId,
             gddata->userId,
             gddata->accountName,
@@ -605,16 +980,52 @@ protected:
             settings.globed.fragmentationLimit,
             util::net::loginPlatformString()
         );
+    }
+
+    // Runs on the main network thread once the tcp connection is up
+    void finishLoginPacket() {
+        // the setting acts as an upper bound, the measured limit of this server and network is used if we have one
+        pmtuCacheKey = this->pathMtuCacheKey();
+
+        auto it = pmtuCandidates.find(pmtuCacheKey);
+        if (it != pmtuCandidates.end()) {
+            pathMtu = it->second;
+            pendingLogin->fragmentationLimit = std::min<uint16_t>(pendingLogin->fragmentationLimit, it->second);
+        } else {
+            pathMtu = 0;
+            pmtuRequested = true;
+        }
+    }
+
+    std::optional<util::data::bytearray<CryptoBox::KEY_LEN>> loadServerKey() {
+        auto encoded = GlobedSettings::get().loadOptional<std::string>(fmt::format("_gskey-{}", connectedServerId));
+        if (!encoded) return std::nullopt;
 
-        this->send(pkt);
+        auto decoded = util::crypto::base64Decode(*encoded);
+        if (decoded.size() != CryptoBox::KEY_LEN) return std::nullopt;
+
+        util::data::bytearray<CryptoBox::KEY_LEN> key;
+        std::copy(decoded.begin(), decoded.end(), key.begin());
+        return key;
     }
 
-    void onLoggedIn(std::shared_ptr<LoggedInPacket> packet) {
+    void onLoggedIn(LoggedInPacket& packet) {
         log::info("Successfully logged into the server!");
-        serverTps = packet->tps;
-        secretKey = packet->secretKey;
+        retryingLogin = false;
+        serverTps = packet.tps;
+        secretKey = packet.secretKey;
+        connectAttempt.lock()->loggedIn = util::time::now();
         state = ConnectionState::Established;
 
+        // when recovery succeeds, the server kept the whole session (crypto keys, room and level),
+        // but if it failed and we did a fresh login instead, the room has to be joined again.
+        bool resumed = recovering;
+        bool rejoinRoom = !resumed && wasFromRecovery;
+
+        if (!resumed) {
+            this->resetLevelDataStream();
+        }
+
         if (recovering || wasFromRecovery) {
             recovering = false;
             recoverAttempt = 0;
@@ -626,12 +1037,26 @@ protected:
         GameServerManager::get().setActive(connectedServerId);
 
         // these are not thread-safe, so delay it
-        Loader::get()->queueInMainThread([specialUserData = std::move(packet->specialUserData), allRoles = std::move(packet->allRoles)] {
+        Loader::get()->queueInMainThread([this, resumed, rejoinRoom, specialUserData = std::move(packet.specialUserData), allRoles = std::move(packet.allRoles)] {
             auto& pcm = ProfileCacheManager::get();
             pcm.setOwnSpecialData(specialUserData);
 
-            RoomManager::get().setGlobal();
+            auto& rm = RoomManager::get();
+            if (rejoinRoom && rm.isInRoom()) {
+                auto& info = rm.getInfo();
+                this->send(JoinRoomPacket::create(info.id, info.password));
+                pendingRoomRejoin = info;
+                rm.setGlobal();
+            } else if (!resumed) {
+                rm.setGlobal();
+            }
+
             RoleManager::get().setAllRoles(allRoles);
+            PlayerCountManager::get().resync();
+
+            if (!resumed) {
+                LevelPrefetchManager::get().resync();
+            }
         });
 
         // claim the tcp thread to allow udp packets through
@@ -647,12 +1072,12 @@ protected:
         }
     }
 
-    void onProtocolMismatch(std::shared_ptr<ProtocolMismatchPacket> packet) {
-        log::warn("Failed to connect because of protocol mismatch. Server: {}, client: {}", packet->serverProtocol, this->getUsedProtocol());
+    void onProtocolMismatch(ProtocolMismatchPacket& packet) {
+        log::warn("Failed to connect because of protocol mismatch. Server: {}, client: {}", packet.serverProtocol, this->getUsedProtocol());
 
 #ifdef GLOBED_DEBUG
         // if we are in debug mode, allow the user to override it
-        Loader::get()->queueInMainThread([this, serverProtocol = packet->serverProtocol] {
+        Loader::get()->queueInMainThread([this, serverProtocol = packet.serverProtocol] {
             geode::createQuickPopup("Globed Error",
                 fmt::format("Protocol mismatch (client: v{}, server: v{}). Override the protocol for this session and allow to connect to the server anyway? <cy>(Not recommended!)</c>", this->getUsedProtocol(), serverProtocol),
                 "Cancel", "Yes", [this](FLAlertLayer*, bool override) {
@@ -665,16 +1090,16 @@ protected:
 #else
         // if we are not in debug, show an error telling the user to update the mod
 
-        if (packet->serverProtocol < this->getUsedProtocol()) {
+        if (packet.serverProtocol < this->getUsedProtocol()) {
             std::string message = "Your Globed version is <cy>too new</c> for this server. Downgrade the mod to an older version or ask the server owner to update their server.";
             ErrorQueues::get().error(message);
         } else {
-            Loader::get()->queueInMainThread([packet = std::move(packet)] {
+            Loader::get()->queueInMainThread([minClientVersion = packet.minClientVersion] {
                 std::string message = fmt::format(
                     "Your Globed version is <cr>outdated</c>, please <cg>update</c> Globed in order to connect."
                     " Installed version: <cy>{}</c>, required: <cy>{}</c> (or newer)",
                     Mod::get()->getVersion().toString(),
-                    packet->minClientVersion
+                    minClientVersion
                 );
                 geode::createQuickPopup("Globed Error", message, "Cancel", "Update", [](FLAlertLayer*, bool update) {
                     if (!update) return;
@@ -703,10 +1128,19 @@ protected:
         return ignoreProtocolMismatch ? 0xffff : PROTOCOL_VERSION;
     }
 
+    bool serverMatchesProtocol() {
+        // with a mismatch override we have no idea what the server understands, so stick to what every version has
+        return !ignoreProtocolMismatch;
+    }
+
     uint32_t getServerTps() {
         return established() ? serverTps.load() : 0;
     }
 
+    uint16_t getPathMtu() {
+        return established() ? pathMtu.load() : 0;
+    }
+
     bool isStandalone() {
         return standalone;
     }
@@ -725,29 +1159,59 @@ protected:
         suspended = false;
     }
 
+    void setLowPowerIdle(bool enabled) {
+        lowPowerIdle = enabled;
+    }
+
+    /* clock sync */
+
+    void onClockSample(uint64_t clientTime, uint64_t serverTime) {
+        auto sync = clockSync.lock();
+        sync->addSample(static_cast<int64_t>(clientTime), static_cast<int64_t>(serverTime), util::time::monotonicMicros());
+
+        if (sync->synced()) {
+            clockOffset = sync->offset();
+            clockSynced = true;
+        }
+    }
+
+    util::time::millis clockSyncInterval() {
+        return clockSync.lock()->sampleCount() < CLOCK_SYNC_BURST ? CLOCK_SYNC_BURST_INTERVAL : CLOCK_SYNC_INTERVAL;
+    }
+
+    double serverTime() {
+        return static_cast<double>(util::time::monotonicMicros() + clockOffset.load()) / 1'000'000.0;
+    }
+
     /* worker threads */
 
     void threadRecvFunc() {
+        recvThreadCpu.store(util::thread::cpuTime().count(), std::memory_order_relaxed);
+
         if (this->suspended || state == ConnectionState::TcpConnecting) {
             std::this_thread::sleep_for(util::time::millis(100));
             return;
         }
 
-        auto packet_ = socket.recvPacket(100);
-        if (packet_.isErr()) {
-            auto error = std::move(packet_.unwrapErr());
+        recvBatch.clear();
+        auto result = socket.recvPackets(lowPowerIdle ? RECV_IDLE_TIMEOUT_LOW_POWER_MS : RECV_IDLE_TIMEOUT_MS, recvBatch);
+
+        GLOBED_PROFILE_ZONE("net: handle received");
+
+        // handle whatever was decoded before a potential error
+        for (auto& received : recvBatch) {
+            this->handleReceivedPacket(std::move(received.packet), received.fromConnected);
+        }
+
+        if (result.isErr()) {
+            auto error = std::move(result.unwrapErr());
             if (error != "timed out") {
                 this->onConnectionError(error);
             }
-
-            return;
         }
+    }
 
-        // this is awesome
-        auto packet__ = packet_.unwrap();
-        auto packet = std::move(packet__.packet);
-        bool fromServer = packet__.fromConnected;
-
+    void handleReceivedPacket(std::shared_ptr<Packet>&& packet, bool fromServer) {
         packetid_t id = packet->getPacketId();
 
         if (id == PingResponsePacket::PACKET_ID) {
@@ -762,6 +1226,12 @@ protected:
 
         lastReceivedPacket = util::time::now();
 
+        if (auto* ld = packet->tryDowncast<LevelDataPacket>()) {
+            this->recordLevelData(ld->sequence, ld->timestamp);
+        } else if (auto* qld = packet->tryDowncast<QuantizedLevelDataPacket>()) {
+            this->recordLevelData(qld->sequence, qld->timestamp);
+        }
+
         this->callListener(std::move(packet));
     }
 
@@ -770,9 +1240,9 @@ protected:
 
         // go through internal listeners
         auto ls = listeners.lock();
-        if (ls->contains(packetId)) {
-            auto listener = ls->at(packetId);
-            listener.callback(packet);
+        if (auto it = ls->find(packetId); it != ls->end()) {
+            auto& listener = it->second;
+            listener.callback(*packet);
             if (listener.isFinal) return;
         }
 
@@ -782,126 +1252,347 @@ protected:
         PacketListenerPool::get().pushPacket(std::move(packet));
     }
 
+    void recordLevelData(uint32_t sequence, uint32_t timestamp) {
+        // the offset between our clock and the server's doesn't matter, only the differences between transit times do
+        int64_t transit = util::time::sinceEpochPrecise().count() - static_cast<int64_t>(timestamp) * 1000;
+
+        auto stats = trafficStats.lock();
+        int32_t diff = static_cast<int32_t>(sequence - stats->highestSequence);
+
+        if (!stats->streamStarted) {
+            stats->streamStarted = true;
+            stats->baseSequence = sequence;
+            stats->highestSequence = sequence;
+            stats->lastTransit = transit;
+            stats->out.received++;
+            return;
+        }
+
+        // a duplicate tells us nothing new
+        if (diff == 0) return;
+
+        if (diff > 0) {
+            stats->highestSequence = sequence;
+        } else {
+            stats->out.outOfOrder++;
+        }
+
+        stats->out.received++;
+
+        // J(i) = J(i-1) + (|D(i-1,i)| - J(i-1)) / 16
+        float d = std::abs(transit - stats->lastTransit) / 1000.f;
+        stats->out.jitterMs += (d - stats->out.jitterMs) / 16.f;
+        stats->lastTransit = transit;
+    }
+
+    // The sequence numbers of level data belong to the server thread, a fresh login gets a new one that starts over from 0
+    void resetLevelDataStream() {
+        auto stats = trafficStats.lock();
+
+        // the rate window would compare against the old stream otherwise
+        stats->windowExpected = 0;
+        stats->windowReceived = 0;
+        stats->out.received = 0;
+        stats->streamStarted = false;
+    }
+
+    void resetTrafficStats() {
+        auto stats = trafficStats.lock();
+        *stats = {};
+        stats->windowStart = util::time::now();
+        stats->windowBytesIn = socket.bytesReceived.load();
+        stats->windowBytesOut = socket.bytesSent.load();
+        stats->windowPacketsIn = socket.packetsReceived.load();
+        stats->windowPacketsOut = socket.packetsSent.load();
+    }
+
+    ConnectionStats getConnectionStats() {
+        auto stats = trafficStats.lock();
+
+        uint64_t expected = stats->expected();
+        stats->out.lost = expected > stats->out.received ? expected - stats->out.received : 0;
+
+        auto now = util::time::now();
+        auto elapsed = now - stats->windowStart;
+
+        if (elapsed >= TRAFFIC_STATS_WINDOW) {
+            size_t bytesIn = socket.bytesReceived.load();
+            size_t bytesOut = socket.bytesSent.load();
+            size_t packetsIn = socket.packetsReceived.load();
+            size_t packetsOut = socket.packetsSent.load();
+            float secs = util::time::asMicros(elapsed) / 1'000'000.f;
+
+            stats->out.bytesInPerSec = static_cast<uint32_t>((bytesIn - stats->windowBytesIn) / secs);
+            stats->out.bytesOutPerSec = static_cast<uint32_t>((bytesOut - stats->windowBytesOut) / secs);
+            stats->out.packetsInPerSec = (packetsIn - stats->windowPacketsIn) / secs;
+            stats->out.packetsOutPerSec = (packetsOut - stats->windowPacketsOut) / secs;
+
+            // packets that arrive late can make the received count go above the expected count for a window
+            uint64_t expectedInWindow = expected - std::min(stats->windowExpected, expected);
+            uint64_t receivedInWindow = stats->out.received - std::min(stats->windowReceived, stats->out.received);
+            stats->out.lossRate = expectedInWindow == 0 || receivedInWindow >= expectedInWindow
+                ? 0.f
+                : static_cast<float>(expectedInWindow - receivedInWindow) / expectedInWindow;
+
+            stats->windowStart = now;
+            stats->windowBytesIn = bytesIn;
+            stats->windowBytesOut = bytesOut;
+            stats->windowPacketsIn = packetsIn;
+            stats->windowPacketsOut = packetsOut;
+            stats->windowExpected = expected;
+            stats->windowReceived = stats->out.received;
+
+            // a syscall, so only once per window
+            auto drops = socket.udpReceiveDrops();
+            stats->out.socketDrops = drops ? static_cast<int64_t>(*drops) : -1;
+        }
+
+        auto attempt = connectAttempt.lock();
+        // with a resumed session or a pipelined login, the login phase starts right after the tcp connection
+        auto loginFrom = attempt->handshaken == util::time::time_point{} ? attempt->connected : attempt->handshaken;
+        stats->out.dnsMs = ConnectAttempt::phaseMs(attempt->started, attempt->resolved);
+        stats->out.tcpMs = ConnectAttempt::phaseMs(attempt->resolved, attempt->connected);
+        stats->out.handshakeMs = ConnectAttempt::phaseMs(attempt->connected, attempt->handshaken);
+        stats->out.loginMs = ConnectAttempt::phaseMs(loginFrom, attempt->loggedIn);
+
+        return stats->out;
+    }
+
+    util::time::micros getThreadCpuTime() {
+        return util::time::micros(recvThreadCpu.load(std::memory_order_relaxed) + mainThreadCpu.load(std::memory_order_relaxed));
+    }
+
     void handlePingResponse(std::shared_ptr<Packet>&& packet) {
         if (auto* pingr = packet->tryDowncast<PingResponsePacket>()) {
             GameServerManager::get().finishPing(pingr->id, pingr->playerCount);
         }
     }
 
-    void threadMainFunc() {
-        if (this->suspended) {
-            std::this_thread::sleep_for(util::time::millis(100));
-            return;
+    /* connection lifecycle */
+
+    // Advances the connection by one step, runs on the main network thread. Connecting itself blocks, but every phase that
+    // waits on the server has a deadline, so a server that stops answering can't leave the connection stuck in it.
+    // Returns false if the rest of the tick should be skipped, e.g. because the attempt just failed.
+    bool updateConnection() {
+        switch (static_cast<ConnectionState>(state)) {
+            case ConnectionState::TcpConnecting:
+                return recovering ? this->stepRecovery() : this->stepConnect();
+
+            case ConnectionState::Authenticating:
+                return this->checkAuthenticating();
+
+            case ConnectionState::Established:
+                // the tcp socket disconnected unexpectedly, try to get the session back
+                if (!socket.isConnected()) {
+                    ErrorQueues::get().warn("[Globed] connection lost, reconnecting..");
+                    this->beginRecovery();
+                    return false;
+                }
+
+                return true;
+
+            default:
+                return true;
         }
+    }
 
-        // Initial tcp connection.
-        if (state == ConnectionState::TcpConnecting && !recovering) {
-            // try to connect
-            auto result = socket.connect(connectedAddress, recovering);
+    // Resolves the server address and opens the sockets, timing both. `NetworkAddress` caches what it resolves,
+    // so resolving up front only moves the lookup out of `GameSocket::connect`.
+    Result<> openSocket() {
+        {
+            auto attempt = connectAttempt.lock();
+            *attempt = {};
+            attempt->started = util::time::now();
+        }
 
-            if (!result) {
-                this->disconnect(true);
+        GLOBED_UNWRAP(connectedAddress.resolveAll());
+        connectAttempt.lock()->resolved = util::time::now();
 
-                auto reason = result.unwrapErr();
-                log::warn("TCP connection failed: <cy>{}</c>", reason);
+        GLOBED_UNWRAP(socket.connect(connectedAddress, recovering));
+        return Ok();
+    }
 
-                ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>{}</c>", reason));
-                return;
-            } else {
-                log::debug("tcp connection successful, sending the handshake");
-                state = ConnectionState::Authenticating;
+    // Must be called before the first packet of the phase goes out, the response can arrive before `send` returns
+    void startWaiting(util::time::seconds timeout) {
+        auto attempt = connectAttempt.lock();
+        attempt->connected = util::time::now();
+        attempt->deadline = attempt->connected + timeout;
+    }
 
-                socket.createBox();
+    void failConnect(const std::string_view reason) {
+        this->disconnect(true);
+        ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>{}</c>", reason));
+    }
 
-                uint16_t proto = this->getUsedProtocol();
+    // Initial connection, sends the handshake
+    bool stepConnect() {
+        auto result = this->openSocket();
 
-                this->send(CryptoHandshakeStartPacket::create(
-                    proto,
-                    CryptoPublicKey(socket.cryptoBox->extractPublicKey())
-                ));
-            }
+        if (!result) {
+            auto reason = result.unwrapErr();
+            log::warn("TCP connection failed: <cy>{}</c>", reason);
+            this->failConnect(reason);
+            return false;
         }
-        // Connection recovery loop itself
-        else if (state == ConnectionState::TcpConnecting && recovering) {
-            log::debug("recovery attempt {}", recoverAttempt.load());
 
-            // initiate TCP connection
-            auto result = socket.connect(connectedAddress, recovering);
+        log::debug("tcp connection successful, sending the handshake");
 
-            bool failed = false;
+        socket.createBox();
+        sessionCipher = SessionCipher::XChaCha20Poly1305;
+        this->finishLoginPacket();
 
-            if (!result) {
-                failed = true;
-            } else {
-                log::debug("tcp connection successful, sending recovery data");
-                state = ConnectionState::Authenticating;
+        uint16_t proto = this->getUsedProtocol();
 
-                // if we are recovering, next steps are slightly different
-                // first send our account ID and secret key (handled on the lowest level by the server)
-                auto result = socket.sendRecoveryData(GJAccountManager::get()->m_accountID, secretKey);
+        auto handshake = CryptoHandshakeStartPacket::create(
+            proto,
+            CryptoPublicKey(socket.cryptoBox->extractPublicKey()),
+            SessionBox::supportedCiphers()
+        );
 
-                if (!result) {
-                    failed = true;
-                } else {
-                    // the rest is done in a global listener
-                    return;
-                }
+        // with a key from an earlier connection the login goes out right away, in the same write as the handshake.
+        // if the server restarted since, it drops the login and we send it again after the handshake response
+        pipelinedLogin = cachedServerKey.has_value();
+
+        this->startWaiting(HANDSHAKE_TIMEOUT);
+        state = ConnectionState::Authenticating;
+
+        if (pipelinedLogin) {
+            socket.cryptoBox->setPeerKey(cachedServerKey->data());
+
+            auto sent = socket.sendPackets({handshake, pendingLogin});
+            if (!sent) {
+                this->failConnect(sent.unwrapErr());
+                return false;
             }
+        } else {
+            this->send(handshake);
+        }
 
-            if (failed) {
-                auto attemptNumber = recoverAttempt.load() + 1;
-                recoverAttempt = attemptNumber;
+        return true;
+    }
 
-                if (attemptNumber > 3) {
-                    // give up
-                    this->failedRecovery();
-                    return;
-                }
+    void beginRecovery() {
+        recovering = true;
+        cancellingRecovery = false;
+        recoverAttempt = 0;
+        connectAttempt.lock()->retryAt = {};
+        state = ConnectionState::TcpConnecting;
+    }
+
+    // One attempt at recovering the connection. The server keeps our session for a while after losing us,
+    // so instead of logging in again we only send our account ID and secret key.
+    // Packets queued in the meantime are kept and go out once the session is back.
+    bool stepRecovery() {
+        if (cancellingRecovery) {
+            log::debug("recovery attempts were cancelled.");
+            recovering = false;
+            recoverAttempt = 0;
+            state = ConnectionState::Disconnected;
+            return false;
+        }
 
-                auto sleepPeriod = util::time::millis(10000) * attemptNumber;
+        // waiting after a failed attempt
+        if (util::time::now() < connectAttempt.lock()->retryAt) {
+            std::this_thread::sleep_for(RECOVERY_POLL_INTERVAL);
+            return false;
+        }
 
-                log::debug("tcp connect failed, sleeping for {} before trying again", util::format::formatDuration(sleepPeriod));
+        log::debug("recovery attempt {}", recoverAttempt.load());
 
-                // wait for a bit before trying again
+        auto result = this->openSocket();
 
-                // we sleep 50 times because we want to check if the user cancelled the recovery
-                for (size_t i = 0; i < 50; i++) {
-                    std::this_thread::sleep_for(sleepPeriod / 50);
+        if (result) {
+            log::debug("tcp connection successful, sending recovery data");
 
-                    if (cancellingRecovery) {
-                        log::debug("recovery attempts were cancelled.");
-                        recovering = false;
-                        recoverAttempt = 0;
-                        state = ConnectionState::Disconnected;
-                        return;
-                    }
-                }
+            this->startWaiting(LOGIN_TIMEOUT);
+            state = ConnectionState::Authenticating;
 
-                return;
-            }
+            // handled on the lowest level by the server, the rest is done in a global listener
+            result = socket.sendRecoveryData(GJAccountManager::get()->m_accountID, secretKey);
+            if (result) return false;
         }
-        // Detect if the tcp socket has unexpectedly disconnected and start recovering the connection
-        else if (state == ConnectionState::Established && !socket.isConnected()) {
-            ErrorQueues::get().warn("[Globed] connection lost, reconnecting..");
 
-            state = ConnectionState::TcpConnecting;
-            recovering = true;
-            cancellingRecovery = false;
-            recoverAttempt = 0;
+        this->failedRecoveryAttempt();
+        return false;
+    }
+
+    // Waiting for the server to answer the handshake, the login or the recovery data
+    bool checkAuthenticating() {
+        bool timedOut, handshaken;
+
+        {
+            auto attempt = connectAttempt.lock();
+            // the receive thread may have just finished logging in
+            if (attempt->loggedIn != util::time::time_point{}) return true;
+
+            timedOut = util::time::now() > attempt->deadline;
+            handshaken = attempt->handshaken != util::time::time_point{};
+        }
+
+        bool lost = !socket.isConnected();
+        if (!timedOut && !lost) return true;
+
+        if (recovering) {
+            log::debug("recovery attempt {}", lost ? "was rejected" : "timed out");
+            socket.disconnect();
+            this->failedRecoveryAttempt();
+        } else if (lost) {
+            // likely the server doesn't expect us
+            this->failConnect("server abruptly disconnected during the handshake");
+        } else {
+            this->failConnect(handshaken ? "server took too long to respond to the login" : "server took too long to respond to the handshake");
+        }
+
+        return false;
+    }
+
+    // Schedules the next recovery attempt, or gives up
+    void failedRecoveryAttempt() {
+        auto attemptNumber = recoverAttempt.load() + 1;
+        recoverAttempt = attemptNumber;
+
+        // the session can't be kept if we leave, but a working server nearby beats waiting up to a minute on this one
+        if (this->tryFailover()) {
             return;
         }
-        // Detect if we disconnected while authenticating, likely the server doesn't expect us
-        else if (state == ConnectionState::Authenticating && !socket.isConnected()) {
-            this->disconnect(true);
 
-            ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>server abruptly disconnected during the handshake</c>"));
+        if (attemptNumber > MAX_RECOVERY_ATTEMPTS) {
+            this->failedRecovery();
             return;
         }
-        // Detect if authentication is taking too long
-        else if (state == ConnectionState::Authenticating && !recovering && (util::time::now() - lastReceivedPacket) > util::time::seconds(5)) {
-            this->disconnect(true);
 
-            ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>server took too long to respond to the handshake</c>"));
+        auto backoff = RECOVERY_BACKOFF * attemptNumber;
+        log::debug("recovery attempt failed, waiting {} before trying again", util::format::formatDuration(backoff));
+
+        connectAttempt.lock()->retryAt = util::time::now() + backoff;
+        state = ConnectionState::TcpConnecting;
+    }
+
+    // The server no longer has our session, so log in again from scratch. The login packet and server key of the original
+    // connection are reused, so unlike `connect` this doesn't have to wait for the main thread to rebuild them.
+    // Runs on the main network thread, see `restartLoginRequested`.
+    void restartWithLogin() {
+        recovering = false;
+        recoverAttempt = 0;
+        wasFromRecovery = true;
+        socket.disconnect();
+        state = ConnectionState::TcpConnecting;
+    }
+
+    void threadMainFunc() {
+        mainThreadCpu.store(util::thread::cpuTime().count(), std::memory_order_relaxed);
+
+        if (this->suspended) {
+            std::this_thread::sleep_for(util::time::millis(100));
+            return;
+        }
+
+        // before `checkAuthenticating` gets to see the socket the server closed on us
+        if (restartLoginRequested.exchange(false) && state == ConnectionState::Authenticating) {
+            this->restartWithLogin();
+        }
+
+        if (!this->updateConnection()) {
             return;
         }
 
@@ -909,18 +1600,33 @@ protected:
             this->maybeSendKeepalive();
         }
 
-        // poll for any incoming packets
+        this->updatePathMtuProbe();
+
+        // poll for any incoming packets, without waiting if some bulk packets are still left over
+
+        while (true) {
+            auto idleTimeout = lowPowerIdle ? SEND_IDLE_TIMEOUT_LOW_POWER : SEND_IDLE_TIMEOUT;
+            auto task_ = taskQueue.popTimeout(this->hasQueuedPackets() ? util::time::millis(0) : idleTimeout);
+            if (!task_ && !this->hasQueuedPackets()) break;
 
-        while (auto task_ = taskQueue.popTimeout(util::time::millis(50))) {
-            auto task = task_.value();
+            GLOBED_PROFILE_ZONE("net: send queued");
+
+            // sort every packet that is queued right now into its lane, and send them together
+            for (; task_; task_ = taskQueue.tryPop()) {
+                auto task = std::move(task_.value());
+
+                if (std::holds_alternative<TaskSendPacket>(task)) {
+                    auto& send = std::get<TaskSendPacket>(task);
+                    this->enqueue(std::move(send));
+                    continue;
+                }
 
-            if (std::holds_alternative<TaskPingServers>(task)) {
-                this->handlePingTask();
-            } else if (std::holds_alternative<TaskSendPacket>(task)) {
-                this->handleSendPacketTask(std::move(std::get<TaskSendPacket>(task)));
-            } else if (std::holds_alternative<TaskPingActive>(task)) {
-                this->handlePingActive();
+                if (std::holds_alternative<TaskPingActive>(task)) {
+                    this->handlePingActive();
+                }
             }
+
+            this->flushLanes();
         }
 
         std::this_thread::yield();
@@ -941,6 +1647,9 @@ protected:
             socket.disconnect();
         } else if (sinceLastPacket > util::time::seconds(10) && sinceLastKeepalive > util::time::seconds(3)) {
             this->sendKeepalive();
+        } else if (sinceLastKeepalive > this->clockSyncInterval()) {
+            // in a level packets never stop coming, so without this the clock would only be synced by the overlay ping
+            this->sendKeepalive();
         }
 
         // send a tcp keepalive to keep the nat hole open
@@ -951,11 +1660,151 @@ protected:
 
     void sendKeepalive() {
         // send a keepalive
-        this->send(KeepalivePacket::create());
+        this->send(KeepalivePacket::create(util::time::monotonicMicros()));
         lastSentKeepalive = util::time::now();
         GameServerManager::get().startKeepalive();
     }
 
+    /* path MTU discovery */
+
+    // Keyed by the server and the local address, so that e.g. switching from wifi to mobile data is probed separately
+    std::string pathMtuCacheKey() {
+        auto local = socket.tcpSocket.localAddress();
+        return fmt::format("_gpmtu-{}-{}", connectedServerId, local ? local.unwrap() : "unknown");
+    }
+
+    void loadPathMtuCandidates() {
+        pmtuCandidates.clear();
+
+        auto prefix = fmt::format("_gpmtu-{}-", connectedServerId);
+        auto& container = Mod::get()->getSaveContainer();
+
+        for (const auto& [key, value] : container.as_object()) {
+            if (key.starts_with(prefix) && value.is_number()) {
+                pmtuCandidates[key] = value.as_int();
+            }
+        }
+    }
+
+    void probePathMtu() {
+        pmtuRequested = true;
+    }
+
+    // Runs on the main network thread. Large datagrams are fragmented by IP, and some networks drop fragments,
+    // so the limit sent to the server is measured instead of relying on the user to calibrate it.
+    void updatePathMtuProbe() {
+        auto& probe = pmtuProbe;
+
+        if (!this->established()) {
+            probe.active = false;
+            return;
+        }
+
+        auto now = util::time::now();
+
+        if (!probe.active) {
+            bool requested = pmtuRequested.exchange(false);
+            bool lossSpike = !requested
+                && now - probe.finishedAt > PMTU_REPROBE_COOLDOWN
+                && this->getConnectionStats().lossRate >= PMTU_REPROBE_LOSS;
+
+            if (!requested && !lossSpike) return;
+
+            log::debug("starting path MTU probe ({})", requested ? "requested" : "loss spike");
+
+            probe.active = true;
+            probe.acked = false;
+            probe.low = PMTU_PROBE_MIN;
+            probe.high = PMTU_PROBE_MAX + 1;
+
+            // most paths handle the largest size fine, in which case a single round trip is enough
+            this->sendPathMtuProbe(PMTU_PROBE_MAX);
+            return;
+        }
+
+        if (pmtuAckedUid == probe.uid) {
+            probe.acked = true;
+            probe.low = probe.current;
+        } else if (now - probe.sentAt < PMTU_PROBE_TIMEOUT) {
+            return;
+        } else if (++probe.attempt < PMTU_PROBE_ATTEMPTS) {
+            // a single lost datagram doesn't mean the size is too big
+            this->sendPathMtuProbe(probe.current, probe.attempt);
+            return;
+        } else {
+            probe.high = probe.current;
+        }
+
+        if (probe.high - probe.low > PMTU_PROBE_PRECISION) {
+            this->sendPathMtuProbe(probe.low + (probe.high - probe.low) / 2);
+            return;
+        }
+
+        probe.active = false;
+        probe.finishedAt = now;
+
+        if (!probe.acked) {
+            log::warn("path MTU probe got no responses, keeping the current packet limit");
+            return;
+        }
+
+        uint16_t result = probe.low;
+        log::info("path MTU probe finished, packet limit is {} bytes", result);
+
+        if (result == pathMtu) return;
+        pathMtu = result;
+
+        // the limit is sent when logging in, so this only has an effect from the next connection on
+        Loader::get()->queueInMainThread([key = pmtuCacheKey, result] {
+            GlobedSettings::get().store(key, static_cast<int>(result));
+        });
+    }
+
+    void sendPathMtuProbe(uint16_t size, uint8_t attempt = 0) {
+        auto& probe = pmtuProbe;
+        probe.current = size;
+        probe.attempt = attempt;
+        probe.uid++;
+        probe.sentAt = util::time::now();
+
+        this->send(ConnectionTestPacket::create(probe.uid, util::crypto::secureRandom(size)));
+    }
+
+    // Runs on the main network thread. Disconnects and moves on to the best other server in the same region,
+    // if one has been answering the background pings
+    bool tryFailover() {
+        if (standalone) return false;
+
+        auto& gsm = GameServerManager::get();
+        auto current = gsm.getServer(connectedServerId);
+        if (!current) return false;
+
+        auto next = gsm.bestServer(current->region, current->id);
+        if (!next) return false;
+
+        log::info("{} is not responding, failing over to {} ({} ms)", current->id, next->id, next->ping);
+
+        recovering = false;
+        recoverAttempt = 0;
+        state = ConnectionState::Disconnected;
+
+        // `connect` builds the login packet, which reads game state
+        Loader::get()->queueInMainThread([this, from = current->name, to = std::move(*next)] {
+            ErrorQueues::get().warn(fmt::format("[Globed] {} is not responding, switching to {}", from, to.name));
+
+            RoomManager::get().setGlobal();
+            GameServerManager::get().clearActive();
+
+            auto result = this->connect(NetworkAddress(to.address), to.id, false);
+            if (!result) {
+                log::warn("failed to fail over: {}", result.unwrapErr());
+                this->onConnectionError("[Globed] failed to switch servers");
+            }
+        });
+
+        return true;
+    }
+
     void failedRecovery() {
         recovering = false;
         recoverAttempt = 0;
@@ -964,22 +1813,78 @@ protected:
         ErrorQueues::get().error("Connection to the server was lost. Failed to reconnect after 3 attempts.");
     }
 
-    void handlePingTask() {
+    void threadPingFunc() {
+        if (this->suspended) {
+            std::this_thread::sleep_for(util::time::millis(100));
+            return;
+        }
+
+        // background pings are skipped when idling on battery, the server list still asks for them explicitly
+        bool backgroundDue = !lowPowerIdle && util::time::now() - lastServerPings >= BACKGROUND_PING_INTERVAL;
+
+        if (pingRequested.exchange(false) || backgroundDue) {
+            lastServerPings = util::time::now();
+            this->sendServerPings();
+        }
+
+        // wait for responses until the next wheel tick is due
+        auto untilTick = util::time::as<util::time::millis>(lastPingTick + PING_TICK - util::time::now());
+
+        pingRecvBatch.clear();
+        auto result = pingSocket.recvPackets(std::max<int>(untilTick.count(), 0), pingRecvBatch);
+
+        for (auto& received : pingRecvBatch) {
+            this->handlePingResponse(std::move(received.packet));
+        }
+
+        if (result.isErr()) {
+            auto error = std::move(result.unwrapErr());
+            if (error != "timed out") {
+                log::debug("ping socket error: {}", error);
+            }
+        }
+
+        auto now = util::time::now();
+        while (now - lastPingTick >= PING_TICK) {
+            lastPingTick += PING_TICK;
+            pingWheel.tick([](uint32_t pingId) {
+                GameServerManager::get().expirePing(pingId);
+            });
+        }
+    }
+
+    void sendServerPings() {
         auto& gsm = GameServerManager::get();
-        auto active = gsm.getActiveId();
+        auto snapshot = gsm.snapshot();
+        const auto& active = snapshot->active;
+        const auto& servers = snapshot->servers;
+
+        // resolve everything first, so that a slow DNS lookup doesn't inflate the ping of servers that were pinged before it
+        std::vector<std::pair<std::string, NetworkAddress>> targets;
+        targets.reserve(servers.size());
 
-        for (auto& [serverId, server] : gsm.getAllServers()) {
+        for (auto& [serverId, server] : servers) {
             if (serverId == active) continue;
 
             NetworkAddress addr(server.address);
+            auto resolved = addr.resolveToString();
+            if (!resolved) {
+                log::debug("failed to resolve {}: {}", server.address, resolved.unwrapErr());
+                continue;
+            }
 
 #ifdef GLOBED_DEBUG
-            auto addrString = addr.resolveToString().value_or("<unresolved>");
-            log::debug("sending ping to {}", addrString);
+            log::debug("sending ping to {}", resolved.unwrap());
 #endif
 
+            targets.emplace_back(serverId, std::move(addr));
+        }
+
+        for (auto& [serverId, addr] : targets) {
             auto pingId = gsm.startPing(serverId);
-            auto result = socket.sendPacketTo(PingPacket::create(pingId), addr);
+            pingWheel.schedule(pingId);
+
+            auto result = pingSocket.sendPacketTo(PingPacket::create(pingId), addr);
 
             if (result.isErr()) {
                 log::debug("failed to send ping: {}", result.unwrapErr());
@@ -988,22 +1893,102 @@ protected:
         }
     }
 
-    void handleSendPacketTask(TaskSendPacket task) {
-        if (task.packet->getUseTcp()) {
-            lastTcpExchange = util::time::now();
+    bool hasQueuedPackets() {
+        return std::any_of(lanes.begin(), lanes.end(), [](auto& lane) { return !lane.empty(); });
+    }
+
+    // puts a packet into its lane, in place of an older unsent one if both are `latest`
+    void enqueue(TaskSendPacket&& send) {
+        auto id = send.packet->getPacketId();
+        auto laneIdx = static_cast<size_t>(NetworkManager::laneFor(id));
+        auto& lane = lanes[laneIdx];
+
+        if (send.latest) {
+            // only the newest packet of the type counts, anything queued before it can be replaced.
+            // a packet that wasn't sent with `sendLatest` (like a delta keyframe) must still go out, and so must everything after it
+            for (auto it = lane.rbegin(); it != lane.rend(); ++it) {
+                if (it->packet->getPacketId() != id) continue;
+
+                if (it->latest) {
+                    // keep the original queue time, the delay stats should show how long this state actually waited
+                    it->packet = std::move(send.packet);
+                    (*laneStats.lock())[laneIdx].superseded++;
+                    return;
+                }
+
+                break;
+            }
+        }
+
+        lane.push_back(std::move(send));
+    }
+
+    // sends the queued packets lane by lane, each lane as its own batch
+    void flushLanes() {
+        // whatever is left over from an old connection should not be sent to the next one
+        if (state == ConnectionState::Disconnected) {
+            for (auto& lane : lanes) lane.clear();
+            return;
+        }
+
+        for (size_t i = 0; i < TRAFFIC_LANE_COUNT; i++) {
+            auto& lane = lanes[i];
+            if (lane.empty()) continue;
+
+            size_t count = lane.size();
+            if (static_cast<TrafficLane>(i) == TrafficLane::Bulk) {
+                count = std::min(count, BULK_PACKETS_PER_FLUSH);
+            }
+
+            auto now = util::time::now();
+
+            {
+                auto stats = laneStats.lock();
+                auto& stat = (*stats)[i];
+
+                for (size_t j = 0; j < count; j++) {
+                    float delay = util::time::asMicros(now - lane[j].queuedAt) / 1000.f;
+
+                    stat.avgQueueDelayMs = stat.packets == 0 ? delay : std::lerp(stat.avgQueueDelayMs, delay, 0.05f);
+                    stat.maxQueueDelayMs = std::max(stat.maxQueueDelayMs, delay);
+                    stat.packets++;
+
+                    sendBatch.push_back(std::move(lane[j].packet));
+                }
+            }
+
+            lane.erase(lane.begin(), lane.begin() + count);
+
+            this->flushSendBatch();
+        }
+    }
+
+    LaneStats getLaneStats(TrafficLane lane) {
+        return (*laneStats.lock())[static_cast<size_t>(lane)];
+    }
+
+    void flushSendBatch() {
+        if (sendBatch.empty()) return;
+
+        for (auto& packet : sendBatch) {
+            if (packet->getUseTcp()) {
+                lastTcpExchange = util::time::now();
+                break;
+            }
         }
 
         try {
-            auto result = socket.sendPacket(task.packet);
+            auto result = sendBatch.size() == 1 ? socket.sendPacket(sendBatch[0]) : socket.sendPackets(sendBatch);
             if (!result) {
                 auto error = result.unwrapErr();
-                log::debug("failed to send packet {}: {}", task.packet->getPacketId(), error);
+                log::debug("failed to send {} packet(s) (first id {}): {}", sendBatch.size(), sendBatch[0]->getPacketId(), error);
                 this->onConnectionError(error);
-                return;
             }
         } catch (const std::exception& e) {
             this->onConnectionError(e.what());
         }
+
+        sendBatch.clear();
     }
 
     void handlePingActive() {
@@ -1014,7 +1999,9 @@ protected:
 
         bool isPingUnknown = GameServerManager::get().getActivePing() == -1;
 
-        if (sinceLastKeepalive > util::time::seconds(5) || isPingUnknown) {
+        auto interval = lowPowerIdle ? ACTIVE_PING_INTERVAL_LOW_POWER : ACTIVE_PING_INTERVAL;
+
+        if (sinceLastKeepalive > interval || isPingUnknown) {
             this->sendKeepalive();
         }
     }
@@ -1062,6 +2049,63 @@ void NetworkManager::send(std::shared_ptr<Packet> packet) {
     impl->send(std::move(packet));
 }
 
+void NetworkManager::sendLatest(std::shared_ptr<Packet> packet) {
+    impl->send(std::move(packet), true);
+}
+
+void NetworkManager::sendEncoded(packetid_t id, bool encrypted, bool tcp, bool latest, void* ctx, void (*write)(void*, ByteBuffer&)) {
+    auto raw = PacketPool<RawPacket>::get().acquire();
+    raw->reset(id, encrypted, tcp);
+    write(ctx, raw->buffer);
+
+    impl->send(std::move(raw), latest);
+}
+
+NetworkManager::TrafficLane NetworkManager::laneFor(packetid_t id) {
+    switch (id) {
+        case PlayerDataPacket::PACKET_ID:
+        case PlayerDataDeltaPacket::PACKET_ID:
+        case PlayerViewportPacket::PACKET_ID:
+        case LinkedPlayerDataPacket::PACKET_ID:
+        case VoicePacket::PACKET_ID:
+        case KeepalivePacket::PACKET_ID:
+            return TrafficLane::Realtime;
+
+        case RequestPlayerProfilesPacket::PACKET_ID:
+        case RequestPlayerProfilesBatchPacket::PACKET_ID:
+        case PlayerMetadataPacket::PACKET_ID:
+        case SyncIconsPacket::PACKET_ID:
+        case RequestGlobalPlayerListPacket::PACKET_ID:
+        case RequestLevelListPacket::PACKET_ID:
+        case RequestPlayerCountPacket::PACKET_ID:
+        case SubscribePlayerCountsPacket::PACKET_ID:
+        case RequestPlayerListPagePacket::PACKET_ID:
+        case RequestRoomPlayerListPacket::PACKET_ID:
+        case RequestRoomListPacket::PACKET_ID:
+        case RequestRoomListPagePacket::PACKET_ID:
+            return TrafficLane::Bulk;
+
+        default:
+            return TrafficLane::Interactive;
+    }
+}
+
+NetworkManager::LaneStats NetworkManager::getLaneStats(TrafficLane lane) {
+    return impl->getLaneStats(lane);
+}
+
+NetworkManager::ConnectionStats NetworkManager::getConnectionStats() {
+    return impl->getConnectionStats();
+}
+
+util::time::micros NetworkManager::getThreadCpuTime() {
+    return impl->getThreadCpuTime();
+}
+
+void NetworkManager::dispatchLocal(std::shared_ptr<Packet> packet) {
+    PacketListenerPool::get().pushPacket(std::move(packet));
+}
+
 void NetworkManager::pingServers() {
     impl->pingServers();
 }
@@ -1095,10 +2139,22 @@ uint16_t NetworkManager::getUsedProtocol() {
     return impl->getUsedProtocol();
 }
 
+bool NetworkManager::serverMatchesProtocol() {
+    return impl->serverMatchesProtocol();
+}
+
 uint32_t NetworkManager::getServerTps() {
     return impl->getServerTps();
 }
 
+uint16_t NetworkManager::getPathMtu() {
+    return impl->getPathMtu();
+}
+
+void NetworkManager::probePathMtu() {
+    impl->probePathMtu();
+}
+
 bool NetworkManager::standalone() {
     return impl->isStandalone();
 }
@@ -1123,6 +2179,18 @@ void NetworkManager::resume() {
     impl->resume();
 }
 
+void NetworkManager::setLowPowerIdle(bool enabled) {
+    impl->setLowPowerIdle(enabled);
+}
+
+double NetworkManager::serverTime() {
+    return impl->serverTime();
+}
+
+bool NetworkManager::isClockSynced() {
+    return impl->clockSynced;
+}
+
 void NetworkManager::unregisterPacketListener(packetid_t packet, PacketListener* listener, bool suppressUnhandled) {
     impl->unregisterPacketListener(packet, listener, suppressUnhandled);
 }
@@ -3,6 +3,7 @@
 #include <Geode/utils/Result.hpp>
 
 #include <util/singleton.hpp>
+#include <util/time.hpp>
 
 using packetid_t = uint16_t;
 
@@ -10,6 +11,7 @@ class PacketListener;
 class NetworkAddress;
 struct GameServer;
 class Packet;
+class ByteBuffer;
 
 template <typename T>
 concept HasPacketID = requires { T::PACKET_ID; };
@@ -21,10 +23,12 @@ protected:
     ~NetworkManager();
 
 public:
-    using PacketCallback = std::function<void(std::shared_ptr<Packet>)>;
+    // Listeners borrow the packet for the duration of the call. They may move data out of it,
+    // but to keep the packet itself around afterwards, use `Packet::retain`.
+    using PacketCallback = std::function<void(Packet&)>;
 
     template <HasPacketID Pty>
-    using PacketCallbackSpecific = std::function<void(std::shared_ptr<Pty>)>;
+    using PacketCallbackSpecific = std::function<void(Pty&)>;
 
     static constexpr unsigned char SERVER_MAGIC[10] = {0xdd, 0xee, 'g', 'l', 'o', 'b', 'e', 'd', 0xda, 0xee};
 
@@ -35,6 +39,41 @@ public:
         Established,     // fully connected to a server
     };
 
+    // Outgoing packets are sent in the order of their lane, bulk packets are additionally limited per send
+    enum class TrafficLane : int {
+        Realtime,    // player data, voice and keepalives
+        Interactive, // logging in, joining rooms and levels, admin actions
+        Bulk,        // player lists, profiles, metadata and icon syncs
+    };
+
+    static constexpr size_t TRAFFIC_LANE_COUNT = 3;
+
+    struct LaneStats {
+        uint64_t packets = 0;
+        float avgQueueDelayMs = 0.f; // smoothed time between `send` and the packet going out
+        float maxQueueDelayMs = 0.f; // since the last connection
+        uint64_t superseded = 0;     // packets from `sendLatest` that were replaced by a newer one before going out
+    };
+
+    // Statistics of the level data stream and of the traffic in general, since the last connection
+    struct ConnectionStats {
+        uint64_t received = 0;   // level data packets received
+        uint64_t lost = 0;       // level data packets that never arrived, based on gaps in sequence numbers
+        uint64_t outOfOrder = 0; // level data packets that arrived after a newer one
+        float lossRate = 0.f;    // fraction of level data packets lost during the last measurement window (about a second)
+        float jitterMs = 0.f;    // interarrival jitter of level data packets, as defined in RFC 3550
+        uint32_t bytesInPerSec = 0;
+        uint32_t bytesOutPerSec = 0;
+        float packetsInPerSec = 0.f;
+        float packetsOutPerSec = 0.f;
+        int64_t socketDrops = -1; // datagrams dropped by the OS because the receive buffer was full, -1 if the platform can't tell
+        // how long each phase of the last connection attempt took, 0 if it wasn't reached or was skipped
+        float dnsMs = 0.f;
+        float tcpMs = 0.f;
+        float handshakeMs = 0.f;
+        float loginMs = 0.f;
+    };
+
     // Connect to a server
     geode::Result<> connect(const NetworkAddress& address, const std::string_view serverId, bool standalone);
 
@@ -56,6 +95,31 @@ public:
     // Sends a packet to the currently established connection. Throws if disconnected.
     void send(std::shared_ptr<Packet> packet);
 
+    // Fast path for packets sent every frame. The body is serialized with the concrete type into a pooled `RawPacket`,
+    // so there is no virtual `encode` call, and at steady state no packet object is allocated.
+    template <HasPacketID Pty>
+    void send(const Pty& packet) {
+        this->sendTyped(packet, false);
+    }
+
+    // For state that only matters in its newest version, like player data and metadata. If an older packet of the same type,
+    // also sent with `sendLatest`, is still waiting in the send queue, it is replaced by this one instead of both going out.
+    void sendLatest(std::shared_ptr<Packet> packet);
+
+    template <HasPacketID Pty>
+    void sendLatest(const Pty& packet) {
+        this->sendTyped(packet, true);
+    }
+
+    // Same as above, but `write` serializes the body of a `Pty` packet into the given `ByteBuffer` by itself.
+    // Useful when the data doesn't live in a packet, e.g. the voice frames.
+    template <HasPacketID Pty, typename F>
+    void sendEncoded(F&& write) {
+        this->sendEncoded(Pty::PACKET_ID, Pty::ENCRYPTED, Pty::SHOULD_USE_TCP, false, &write, [](void* ctx, ByteBuffer& buf) {
+            (*static_cast<std::remove_reference_t<F>*>(ctx))(buf);
+        });
+    }
+
     // Pings all known servers and stores the pings in `GameServerManager`
     void pingServers();
 
@@ -73,8 +137,8 @@ public:
     // Same as addListener(packetid_t, PacketCallback) but hacky syntax xd
     template <HasPacketID Pty>
     void addListener(cocos2d::CCNode* target, PacketCallbackSpecific<Pty>&& callback, int priority = 0, bool isFinal = false) {
-        this->addListener(target, Pty::PACKET_ID, [callback = std::move(callback)](std::shared_ptr<Packet> pkt) {
-            return callback(std::static_pointer_cast<Pty>(pkt));
+        this->addListener(target, Pty::PACKET_ID, [callback = std::move(callback)](Packet& pkt) {
+            return callback(static_cast<Pty&>(pkt));
         }, priority, isFinal);
     }
 
@@ -96,9 +160,37 @@ public:
     // Returns the protocol version of this client
     uint16_t getUsedProtocol();
 
+    // Returns whether the server speaks the same protocol as this client, and with it every packet this client knows about
+    // (player data deltas, viewports, paged lists, player count pushes, and so on). False with a protocol mismatch override,
+    // since then the server may be older, and only packets every version understands should be sent.
+    bool serverMatchesProtocol();
+
     // Get the TPS of the currently connected server, or 0
     uint32_t getServerTps();
 
+    // Get the largest UDP packet size measured for the current server and network, or 0 if it's not known yet.
+    // It's measured in the background after logging in, and is sent to the server as the packet limit on the next login.
+    uint16_t getPathMtu();
+
+    // Measure the packet limit again in the background, does nothing if not connected
+    void probePathMtu();
+
+    // Returns which lane packets with this ID are sent through
+    static TrafficLane laneFor(packetid_t id);
+
+    // Returns the statistics of one of the outgoing traffic lanes
+    LaneStats getLaneStats(TrafficLane lane);
+
+    // Returns loss, jitter and throughput statistics of the current connection
+    ConnectionStats getConnectionStats();
+
+    // Returns the CPU time used by the network threads so far. Each thread updates its own once per loop,
+    // so this can lag behind by up to one idle timeout.
+    util::time::micros getThreadCpuTime();
+
+    // Hands a packet to the listeners as if it was just received from the server, for benchmarks
+    void dispatchLocal(std::shared_ptr<Packet> packet);
+
     // Returns true if we are connected to a standalone game server, not tied to any central server.
     bool standalone();
 
@@ -116,10 +208,33 @@ public:
     // Resume all network threads
     void resume();
 
+    // With `enabled`, idle network threads wake up less often and the menu ping keepalive is sent less frequently.
+    // Doesn't change how quickly packets are sent or handled, see `PowerManager`.
+    void setLowPowerIdle(bool enabled);
+
+    // Current time on the server clock in seconds, estimated from keepalive exchanges. Player data is timestamped with it,
+    // so that everyone in a level agrees on the timestamps. Until the first keepalive response it is the local clock.
+    double serverTime();
+    bool isClockSynced();
+
 private:
     class Impl;
     Impl* impl;
 
     friend class PacketListener;
     void unregisterPacketListener(packetid_t packet, PacketListener* listener, bool suppressUnhandled = true);
+
+    void sendEncoded(packetid_t id, bool encrypted, bool tcp, bool latest, void* ctx, void (*write)(void*, ByteBuffer&));
+
+    template <HasPacketID Pty>
+    void sendTyped(const Pty& packet, bool latest) {
+        auto write = [&](ByteBuffer& buf) {
+            buf.reserve(buf.template encodedSizeHint<Pty>(packet));
+            buf.template writeValue<Pty>(packet);
+        };
+
+        this->sendEncoded(Pty::PACKET_ID, Pty::ENCRYPTED, Pty::SHOULD_USE_TCP, latest, &write, [](void* ctx, ByteBuffer& buf) {
+            (*static_cast<decltype(write)*>(ctx))(buf);
+        });
+    }
 };
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "packet_capture.hpp"
+
+#include <util/format.hpp>
+#include <util/thread.hpp>
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+// how often the writer thread moves captured packets into the file
+static constexpr auto WRITE_INTERVAL = util::time::millis(250);
+
+template <typename T>
+static void writeLE(uint8_t* out, T value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+template <typename T>
+static T readLE(const uint8_t* in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+PacketCapture::PacketCapture() {
+    ring.lock()->buffer.resize(RING_SIZE);
+
+    writerThread.setLoopFunction(&PacketCapture::writerFunc);
+    writerThread.setStartFunction([] {
+        geode::utils::thread::setName("Packet Capture Writer");
+        util::thread::configureCurrent(util::thread::Priority::Background);
+    });
+    writerThread.start(this);
+}
+
+PacketCapture::~PacketCapture() {
+    writerThread.stopAndWait();
+    this->stop();
+}
+
+Result<> PacketCapture::start() {
+    auto fs = file.lock();
+    if (capturing) return Ok();
+
+    auto folder = Mod::get()->getSaveDir() / "packets";
+    (void) geode::utils::file::createDirectoryAll(folder);
+
+    auto datetime = util::format::formatDateTime(util::time::systemNow());
+    auto filepath = folder / fmt::format("capture-{}.gcap", datetime);
+
+    fs->open(filepath, std::ios::binary);
+    if (!fs->is_open()) {
+        return Err(fmt::format("failed to open {}", filepath));
+    }
+
+    uint8_t header[sizeof(uint32_t) + sizeof(uint16_t)];
+    writeLE(header, FILE_MAGIC);
+    writeLE(header + sizeof(uint32_t), FILE_VERSION);
+    fs->write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // anything captured before this point belongs to no file
+    auto r = ring.lock();
+    r->head = 0;
+    r->size = 0;
+    dropped = 0;
+
+    capturing = true;
+
+    log::debug("Capturing packets into {}", filepath);
+
+    return Ok();
+}
+
+void PacketCapture::stop() {
+    if (!capturing) return;
+    capturing = false;
+
+    this->flush();
+
+    auto fs = file.lock();
+    fs->close();
+
+    if (dropped > 0) {
+        log::warn("Packet capture dropped {} packets", dropped.load());
+    }
+}
+
+bool PacketCapture::isCapturing() {
+    return capturing;
+}
+
+void PacketCapture::capture(packetid_t id, bool outgoing, bool encrypted, const uint8_t* data, size_t size) {
+    if (!capturing) return;
+
+    uint8_t header[RECORD_HEADER_SIZE];
+    auto timestamp = util::time::as<util::time::micros>(util::time::systemNow().time_since_epoch()).count();
+    writeLE<uint64_t>(header, timestamp);
+    writeLE<uint16_t>(header + 8, id);
+    header[10] = (outgoing ? 1 : 0) | (encrypted ? 2 : 0);
+    writeLE<uint32_t>(header + 11, size);
+
+    auto r = ring.lock();
+
+    size_t total = RECORD_HEADER_SIZE + size;
+    if (r->size + total > RING_SIZE) {
+        dropped.fetch_add(1);
+        return;
+    }
+
+    auto push = [&](const uint8_t* src, size_t len) {
+        size_t tail = (r->head + r->size) % RING_SIZE;
+        size_t first = std::min(len, RING_SIZE - tail);
+
+        std::memcpy(r->buffer.data() + tail, src, first);
+        std::memcpy(r->buffer.data(), src + first, len - first);
+
+        r->size += len;
+    };
+
+    push(header, RECORD_HEADER_SIZE);
+    push(data, size);
+}
+
+size_t PacketCapture::getDroppedCount() {
+    return dropped;
+}
+
+void PacketCapture::writerFunc() {
+    std::this_thread::sleep_for(WRITE_INTERVAL);
+
+    if (capturing) {
+        this->flush();
+    }
+}
+
+void PacketCapture::flush() {
+    auto fs = file.lock();
+
+    // copy out quickly, so that the network threads aren't blocked while writing to disk
+    {
+        auto r = ring.lock();
+        if (r->size == 0) return;
+
+        writeBuffer.resize(r->size);
+
+        size_t first = std::min(r->size, RING_SIZE - r->head);
+        std::memcpy(writeBuffer.data(), r->buffer.data() + r->head, first);
+        std::memcpy(writeBuffer.data() + first, r->buffer.data(), r->size - first);
+
+        r->head = (r->head + r->size) % RING_SIZE;
+        r->size = 0;
+    }
+
+    if (!fs->is_open()) return;
+
+    fs->write(reinterpret_cast<const char*>(writeBuffer.data()), writeBuffer.size());
+    fs->flush();
+}
+
+Result<std::vector<PacketCapture::CapturedPacket>> PacketCapture::readFile(const std::filesystem::path& path) {
+    std::ifstream fs(path, std::ios::binary);
+    if (!fs.is_open()) {
+        return Err(fmt::format("failed to open {}", path));
+    }
+
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+
+    GLOBED_REQUIRE_SAFE(contents.size() >= sizeof(uint32_t) + sizeof(uint16_t), "capture file is too short")
+    GLOBED_REQUIRE_SAFE(readLE<uint32_t>(contents.data()) == FILE_MAGIC, "not a packet capture file")
+
+    auto version = readLE<uint16_t>(contents.data() + sizeof(uint32_t));
+    GLOBED_REQUIRE_SAFE(version == FILE_VERSION, fmt::format("unsupported capture file version: {}", version))
+
+    std::vector<CapturedPacket> out;
+    size_t pos = sizeof(uint32_t) + sizeof(uint16_t);
+
+    while (pos + RECORD_HEADER_SIZE <= contents.size()) {
+        const uint8_t* header = contents.data() + pos;
+        uint32_t length = readLE<uint32_t>(header + 11);
+
+        // a capture that was cut off (for example by a crash) still has every record before the last one intact
+        if (pos + RECORD_HEADER_SIZE + length > contents.size()) break;
+
+        const uint8_t* data = header + RECORD_HEADER_SIZE;
+
+        out.push_back(CapturedPacket {
+            .timestamp = readLE<uint64_t>(header),
+            .id = readLE<uint16_t>(header + 8),
+            .outgoing = (header[10] & 1) != 0,
+            .encrypted = (header[10] & 2) != 0,
+            .data = std::vector<uint8_t>(data, data + length),
+        });
+
+        pos += RECORD_HEADER_SIZE + length;
+    }
+
+    return Ok(std::move(out));
+}
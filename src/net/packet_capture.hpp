@@ -0,0 +1,73 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
+
+#include <data/packets/packet.hpp>
+#include <util/singleton.hpp>
+
+// Records sent and received packets into a ring buffer in memory, and a background thread appends them to a capture file.
+// Capturing a packet is one copy under a short lock, so it can stay enabled without slowing down the network threads.
+//
+// File format (little endian): u32 magic, u16 version, then records of
+// u64 timestamp (microseconds since the unix epoch), u16 packet id, u8 flags (1 = outgoing, 2 = encrypted), u32 length, data.
+class PacketCapture : public SingletonBase<PacketCapture> {
+protected:
+    friend class SingletonBase;
+    PacketCapture();
+    ~PacketCapture();
+
+public:
+    static constexpr uint32_t FILE_MAGIC = 0x50414347; // "GCAP"
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr size_t RING_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t RECORD_HEADER_SIZE = 15;
+
+    struct CapturedPacket {
+        uint64_t timestamp;
+        packetid_t id;
+        bool outgoing;
+        bool encrypted;
+        std::vector<uint8_t> data;
+    };
+
+    // Start writing captured packets to a new file in the `packets` folder, does nothing if already capturing
+    Result<> start();
+
+    // Write out everything that was captured so far and close the file
+    void stop();
+
+    bool isCapturing();
+
+    // Record a packet, does nothing unless capturing. The packet is dropped if the ring buffer is full.
+    void capture(packetid_t id, bool outgoing, bool encrypted, const uint8_t* data, size_t size);
+
+    // Returns how many packets were dropped because the writer thread could not keep up
+    size_t getDroppedCount();
+
+    // Read all packets from a capture file, for replaying or inspecting it
+    static Result<std::vector<CapturedPacket>> readFile(const std::filesystem::path& path);
+
+private:
+    struct Ring {
+        std::vector<uint8_t> buffer;
+        size_t head = 0; // position of the oldest byte that wasn't written to the file yet
+        size_t size = 0; // amount of bytes that weren't written to the file yet
+    };
+
+    asp::Mutex<Ring> ring;
+    asp::Mutex<std::ofstream> file;
+    asp::AtomicBool capturing;
+    asp::AtomicSizeT dropped;
+
+    asp::Thread<PacketCapture*> writerThread;
+    std::vector<uint8_t> writeBuffer; // only used by `flush`, under the file lock
+
+    void writerFunc();
+
+    // move everything out of the ring buffer into the file
+    void flush();
+};
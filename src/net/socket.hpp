@@ -6,6 +6,7 @@ class NetworkAddress;
 struct RecvResult {
     bool fromServer; // true if the packet comes from the currently connected server
     int result;
+    bool truncated = false; // the datagram didn't fit in the buffer, `result` is not its real size
 };
 
 class Socket {
@@ -2,10 +2,13 @@
 
 #include "address.hpp"
 #include <util/net.hpp>
+#include <util/time.hpp>
 
 #ifdef GEODE_IS_WINDOWS
 # include <WinSock2.h>
+# include <WS2tcpip.h>
 #else
+# include <sys/socket.h>
 # include <netinet/in.h>
 # include <fcntl.h>
 # include <poll.h>
@@ -14,6 +17,64 @@
 
 using namespace geode::prelude;
 
+// delay before trying the next address, as recommended by RFC 8305
+constexpr auto CONNECT_ATTEMPT_DELAY = util::time::millis(250);
+constexpr auto CONNECT_TIMEOUT = util::time::seconds(5);
+constexpr size_t MAX_CONNECT_ATTEMPTS = 4;
+
+static void closeRawSocket(util::net::socket_t sock) {
+#ifdef GEODE_IS_WINDOWS
+    ::closesocket(sock);
+#else
+    ::close(sock);
+#endif
+}
+
+static Result<> setRawNonBlocking(util::net::socket_t sock, bool nb) {
+#ifdef GEODE_IS_WINDOWS
+    unsigned long mode = nb ? 1 : 0;
+    if (SOCKET_ERROR == ioctlsocket(sock, FIONBIO, &mode)) return Err(util::net::lastErrorString());
+#else
+    int flags = fcntl(sock, F_GETFL);
+
+    if (nb) {
+        if (fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0) return Err(util::net::lastErrorString());
+    } else {
+        if (fcntl(sock, F_SETFL, flags & (~O_NONBLOCK)) < 0) return Err(util::net::lastErrorString());
+    }
+#endif
+
+    return Ok();
+}
+
+// creates a non-blocking socket and starts connecting it, without waiting for the result
+static Result<util::net::socket_t> startConnect(const sockaddr_in& addr) {
+    auto sock = static_cast<util::net::socket_t>(socket(AF_INET, SOCK_STREAM, 0));
+    GLOBED_REQUIRE_SAFE(sock != static_cast<util::net::socket_t>(-1), "failed to create a tcp socket: socket failed");
+
+    auto result = setRawNonBlocking(sock, true);
+    if (!result) {
+        closeRawSocket(sock);
+        return Err(result.unwrapErr());
+    }
+
+    // on a non-blocking socket this errors with EWOULDBLOCK, real failures get reported by poll
+    (void) ::connect(sock, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(sockaddr_in));
+
+    return Ok(sock);
+}
+
+static int pendingSocketError(util::net::socket_t sock) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &len) != 0) {
+        return util::net::lastErrorCode();
+    }
+
+    return error;
+}
+
 TcpSocket::TcpSocket() : socket_(0) {
     destAddr_ = std::make_unique<sockaddr_in>();
     std::memset(destAddr_.get(), 0, sizeof(sockaddr_in));
@@ -24,31 +85,107 @@ TcpSocket::~TcpSocket() {
 }
 
 Result<> TcpSocket::connect(const NetworkAddress& address) {
-    destAddr_->sin_family = AF_INET;
+    GLOBED_UNWRAP_INTO(address.resolveAll(), auto candidates);
 
-    GLOBED_UNWRAP_INTO(address.resolve(), *destAddr_)
+    if (candidates.size() > MAX_CONNECT_ATTEMPTS) {
+        candidates.resize(MAX_CONNECT_ATTEMPTS);
+    }
 
-    // create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    socket_ = sock;
+    struct Attempt {
+        util::net::socket_t sock;
+        size_t candidate;
+    };
 
-    GLOBED_REQUIRE_SAFE(sock != -1, "failed to create a tcp socket: socket failed");
+    std::vector<Attempt> attempts;
+    size_t nextCandidate = 0;
 
-    // attempt a connection with a 5 second timeout
-    GLOBED_UNWRAP(this->setNonBlocking(true));
+    auto start = util::time::now();
+    auto deadline = start + CONNECT_TIMEOUT;
+    auto nextAttemptAt = start;
 
-    // on a non-blocking socket this always errors with EWOULDBLOCK, ignore the status code
-    (void) ::connect(socket_, reinterpret_cast<struct sockaddr*>(destAddr_.get()), sizeof(sockaddr_in));
+    std::string lastError = "connection timed out, failed to connect after 5 seconds.";
 
-    GLOBED_UNWRAP(this->setNonBlocking(false));
+    while (util::time::now() < deadline) {
+        auto now = util::time::now();
 
-    // im crying why does this actually poll for double the length????
-    GLOBED_UNWRAP_INTO(this->poll(2500, false), auto pollResult);
+        // start the next attempt when it's time, or right away if all the previous ones have failed already
+        if (nextCandidate < candidates.size() && (now >= nextAttemptAt || attempts.empty())) {
+            auto result = startConnect(candidates[nextCandidate]);
+            if (result) {
+                attempts.push_back(Attempt { .sock = result.unwrap(), .candidate = nextCandidate });
+            } else {
+                lastError = result.unwrapErr();
+            }
 
-    GLOBED_REQUIRE_SAFE(pollResult, "connection timed out, failed to connect after 5 seconds.")
+            nextCandidate++;
+            nextAttemptAt = now + CONNECT_ATTEMPT_DELAY;
+            continue;
+        }
 
-    connected = true;
-    return Ok();
+        if (attempts.empty()) break;
+
+        GLOBED_SOCKET_POLLFD fds[MAX_CONNECT_ATTEMPTS];
+        for (size_t i = 0; i < attempts.size(); i++) {
+            fds[i].fd = attempts[i].sock;
+            fds[i].events = POLLOUT;
+            fds[i].revents = 0;
+        }
+
+        auto waitUntil = nextCandidate < candidates.size() ? std::min(nextAttemptAt, deadline) : deadline;
+        int waitMs = std::max<int>(util::time::as<util::time::millis>(waitUntil - now).count(), 0);
+
+        if (GLOBED_SOCKET_POLL(fds, attempts.size(), waitMs) == -1) {
+            lastError = util::net::lastErrorString();
+            break;
+        }
+
+        // go backwards so that removing a failed attempt doesn't shift the ones we haven't checked yet
+        for (size_t i = attempts.size(); i-- > 0;) {
+            if (fds[i].revents == 0) continue;
+
+            int error = pendingSocketError(attempts[i].sock);
+
+            if (error == 0 && (fds[i].revents & POLLOUT)) {
+                // we have a winner, cancel everything else
+                for (size_t j = 0; j < attempts.size(); j++) {
+                    if (j != i) closeRawSocket(attempts[j].sock);
+                }
+
+                socket_ = attempts[i].sock;
+                *destAddr_ = candidates[attempts[i].candidate];
+
+                GLOBED_UNWRAP(this->setNonBlocking(false));
+
+                connected = true;
+                return Ok();
+            }
+
+            lastError = util::net::lastErrorString(error);
+            closeRawSocket(attempts[i].sock);
+            attempts.erase(attempts.begin() + i);
+        }
+    }
+
+    for (auto& attempt : attempts) {
+        closeRawSocket(attempt.sock);
+    }
+
+    return Err(lastError);
+}
+
+const sockaddr_in& TcpSocket::peerAddress() const {
+    return *destAddr_;
+}
+
+Result<std::string> TcpSocket::localAddress() const {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+
+    if (0 != getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &len)) {
+        return Err(util::net::lastErrorString());
+    }
+
+    return util::net::inAddrToString(addr.sin_addr);
 }
 
 Result<int> TcpSocket::send(const char* data, unsigned int dataSize) {
@@ -151,20 +288,7 @@ Result<bool> TcpSocket::poll(int msDelay, bool in) {
 }
 
 Result<> TcpSocket::setNonBlocking(bool nb) {
-#ifdef GEODE_IS_WINDOWS
-    unsigned long mode = nb ? 1 : 0;
-    if (SOCKET_ERROR == ioctlsocket(socket_, FIONBIO, &mode)) return Err(util::net::lastErrorString());
-#else
-    int flags = fcntl(socket_, F_GETFL);
-
-    if (nb) {
-        if (fcntl(socket_, F_SETFL, flags | O_NONBLOCK) < 0) return Err(util::net::lastErrorString());
-    } else {
-        if (fcntl(socket_, F_SETFL, flags & (~O_NONBLOCK)) < 0) return Err(util::net::lastErrorString());
-    }
-#endif
-
-    return Ok();
+    return setRawNonBlocking(socket_, nb);
 }
 
 void TcpSocket::maybeDisconnect() {
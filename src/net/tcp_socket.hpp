@@ -13,6 +13,8 @@ public:
     TcpSocket();
     ~TcpSocket();
 
+    // Connects to the address, if the host resolves to multiple addresses they are tried in parallel,
+    // with each attempt starting a bit after the previous one (like happy eyeballs), and the first one to connect is used.
     Result<> connect(const NetworkAddress& address) override;
     Result<int> send(const char* data, unsigned int dataSize) override;
     Result<> sendAll(const char* data, unsigned int dataSize);
@@ -24,6 +26,12 @@ public:
     Result<bool> poll(int msDelay, bool in = true) override;
     Result<> setNonBlocking(bool nb) override;
 
+    // The address that the last successful `connect` ended up connecting to
+    const sockaddr_in& peerAddress() const;
+
+    // The local address of the connected socket, which tells apart the networks the user connects from
+    Result<std::string> localAddress() const;
+
     asp::AtomicBool connected = false;
 
 #ifdef GLOBED_IS_UNIX
@@ -36,6 +36,14 @@ Result<> UdpSocket::connect(const NetworkAddress& address) {
     return Ok();
 }
 
+Result<> UdpSocket::connect(const sockaddr_in& address) {
+    *destAddr_ = address;
+    destAddr_->sin_family = AF_INET;
+
+    connected = true;
+    return Ok();
+}
+
 Result<int> UdpSocket::send(const char* data, unsigned int dataSize) {
     GLOBED_REQUIRE_SAFE(connected, "attempting to call UdpSocket::send on a disconnected socket")
 
@@ -65,16 +73,81 @@ Result<int> UdpSocket::sendTo(const char* data, unsigned int dataSize, const Net
     return Ok(retval);
 }
 
+Result<> UdpSocket::sendBatch(const Datagram* datagrams, size_t count) {
+    GLOBED_REQUIRE_SAFE(connected, "attempting to call UdpSocket::sendBatch on a disconnected socket")
+
+#if GLOBED_HAS_RECVMMSG
+    constexpr size_t MAX_BATCH = 16;
+
+    mmsghdr msgs[MAX_BATCH];
+    iovec iovecs[MAX_BATCH];
+
+    size_t sent = 0;
+    while (sent < count) {
+        size_t batch = std::min(count - sent, MAX_BATCH);
+        std::memset(msgs, 0, sizeof(mmsghdr) * batch);
+
+        for (size_t i = 0; i < batch; i++) {
+            iovecs[i].iov_base = const_cast<char*>(datagrams[sent + i].data);
+            iovecs[i].iov_len = datagrams[sent + i].size;
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = destAddr_.get();
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        int result = sendmmsg(socket_, msgs, batch, 0);
+        if (result == -1) {
+            return Err(util::net::lastErrorString());
+        }
+
+        // sendmmsg may send less than requested, retry with the rest
+        sent += result;
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        GLOBED_UNWRAP(this->send(datagrams[i].data, datagrams[i].size));
+    }
+#endif
+
+    return Ok();
+}
+
 void UdpSocket::disconnect() {
     connected = false;
 }
 
 RecvResult UdpSocket::receive(char* buffer, int bufferSize) {
     sockaddr_in source;
+    bool truncated = false;
+
+#ifdef GEODE_IS_WINDOWS
     socklen_t addrLen = sizeof(source);
 
     int result = recvfrom(socket_, buffer, bufferSize, 0, reinterpret_cast<struct sockaddr*>(&source), &addrLen);
 
+    // windows fails the call instead, the truncated datagram is discarded either way
+    if (result == -1 && util::net::lastErrorCode() == WSAEMSGSIZE) {
+        truncated = true;
+        result = bufferSize;
+    }
+#else
+    iovec iov {
+        .iov_base = buffer,
+        .iov_len = static_cast<size_t>(bufferSize),
+    };
+
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &source;
+    msg.msg_namelen = sizeof(source);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    int result = recvmsg(socket_, &msg, 0);
+    truncated = result >= 0 && (msg.msg_flags & MSG_TRUNC);
+#endif
+
     bool fromServer = false;
     if (this->connected) {
         fromServer = util::net::sameSockaddr(source, *destAddr_);
@@ -83,9 +156,69 @@ RecvResult UdpSocket::receive(char* buffer, int bufferSize) {
     return RecvResult {
         .fromServer = fromServer,
         .result = result,
+        .truncated = truncated,
     };
 }
 
+Result<size_t> UdpSocket::receiveBatch(char* buffer, int slotSize, size_t count, RecvResult* results) {
+#if GLOBED_HAS_RECVMMSG
+    constexpr size_t MAX_BATCH = 16;
+    count = std::min(count, MAX_BATCH);
+
+    mmsghdr msgs[MAX_BATCH];
+    iovec iovecs[MAX_BATCH];
+    sockaddr_in sources[MAX_BATCH];
+
+    std::memset(msgs, 0, sizeof(mmsghdr) * count);
+
+    for (size_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = buffer + i * slotSize;
+        iovecs[i].iov_len = slotSize;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &sources[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    int result = recvmmsg(socket_, msgs, count, MSG_DONTWAIT, nullptr);
+
+    if (result == -1) {
+        auto code = util::net::lastErrorCode();
+        if (code == EWOULDBLOCK || code == EAGAIN) {
+            return Ok(0);
+        }
+
+        return Err(util::net::lastErrorString(code));
+    }
+
+    for (int i = 0; i < result; i++) {
+        results[i].result = static_cast<int>(msgs[i].msg_len);
+        results[i].truncated = msgs[i].msg_hdr.msg_flags & MSG_TRUNC;
+        results[i].fromServer = this->connected && util::net::sameSockaddr(sources[i], *destAddr_);
+    }
+
+    return Ok(static_cast<size_t>(result));
+#else
+    // no recvmmsg, poll with no timeout before every datagram so we never block
+    size_t received = 0;
+
+    while (received < count) {
+        GLOBED_UNWRAP_INTO(this->poll(0), bool pending);
+        if (!pending) break;
+
+        auto res = this->receive(buffer + received * slotSize, slotSize);
+        if (res.result < 0) {
+            if (received > 0) break;
+            return Err(util::net::lastErrorString());
+        }
+
+        results[received++] = res;
+    }
+
+    return Ok(received);
+#endif
+}
+
 bool UdpSocket::close() {
     if (!connected) return true;
 
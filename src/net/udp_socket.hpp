@@ -13,9 +13,24 @@ public:
     ~UdpSocket();
 
     Result<> connect(const NetworkAddress& address) override;
+    // Connect to an already resolved address
+    Result<> connect(const sockaddr_in& address);
     Result<int> send(const char* data, unsigned int dataSize) override;
     Result<int> sendTo(const char* data, unsigned int dataSize, const NetworkAddress& address);
+
+    struct Datagram {
+        const char* data;
+        unsigned int size;
+    };
+
+    // Send multiple datagrams to the connected address, in one syscall where the platform allows it (`sendmmsg`)
+    Result<> sendBatch(const Datagram* datagrams, size_t count);
     RecvResult receive(char* buffer, int bufferSize) override;
+
+    // Receive up to `count` datagrams that are already pending, without blocking.
+    // `buffer` is split into `count` slots of `slotSize` bytes, datagram `i` lands in slot `i` and its result in `results[i]`.
+    // Returns the amount of datagrams received, which can be 0.
+    Result<size_t> receiveBatch(char* buffer, int slotSize, size_t count, RecvResult* results);
     bool close() override;
     virtual void disconnect();
     Result<bool> poll(int msDelay, bool in = true) override;
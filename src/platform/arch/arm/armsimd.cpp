@@ -1,5 +1,9 @@
 #include "armsimd.hpp"
 
+#include <util/data.hpp>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 #include <util/misc.hpp>
 #include <arm_neon.h>
 
@@ -29,3 +33,484 @@ float globed::simd::arm::pcmVolume(const float* pcm, std::size_t samples) {
     return util::misc::pcmVolumeSlow(pcm, samples);
 #endif
 }
+
+// `data` does not have to be aligned, byte buffers hand out pointers to arbitrary offsets
+template <typename T>
+static void byteswapTail(T* data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        T value;
+        std::memcpy(&value, data + i, sizeof(T));
+        value = util::data::byteswap(value);
+        std::memcpy(data + i, &value, sizeof(T));
+    }
+}
+
+void globed::simd::arm::byteswap16(uint16_t* data, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 8 * 8;
+
+    for (size_t i = 0; i < aligned; i += 8) {
+        uint8x16_t vec = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(data + i), vrev16q_u8(vec));
+    }
+
+    byteswapTail(data + aligned, count - aligned);
+#else
+    byteswapTail(data, count);
+#endif
+}
+
+void globed::simd::arm::byteswap32(uint32_t* data, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    for (size_t i = 0; i < aligned; i += 4) {
+        uint8x16_t vec = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(data + i), vrev32q_u8(vec));
+    }
+
+    byteswapTail(data + aligned, count - aligned);
+#else
+    byteswapTail(data, count);
+#endif
+}
+
+void globed::simd::arm::byteswap64(uint64_t* data, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 2 * 2;
+
+    for (size_t i = 0; i < aligned; i += 2) {
+        uint8x16_t vec = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(data + i), vrev64q_u8(vec));
+    }
+
+    byteswapTail(data + aligned, count - aligned);
+#else
+    byteswapTail(data, count);
+#endif
+}
+
+static void lerpTail(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = from[i] + (to[i] - from[i]) * ratio[i];
+    }
+}
+
+// wraps the difference into [-180, 180] by subtracting the nearest multiple of 360, same as the vector version
+static void lerpAngleTail(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float diff = to[i] - from[i];
+        diff -= 360.f * std::nearbyint(diff / 360.f);
+        out[i] = from[i] + diff * ratio[i];
+    }
+}
+
+void globed::simd::arm::lerp(const float* from, const float* to, const float* ratio, float* out, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    for (size_t i = 0; i < aligned; i += 4) {
+        float32x4_t fromVec = vld1q_f32(from + i);
+        float32x4_t diffVec = vsubq_f32(vld1q_f32(to + i), fromVec);
+        vst1q_f32(out + i, vfmaq_f32(fromVec, diffVec, vld1q_f32(ratio + i)));
+    }
+
+    lerpTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+#else
+    lerpTail(from, to, ratio, out, count);
+#endif
+}
+
+void globed::simd::arm::lerpAngle(const float* from, const float* to, const float* ratio, float* out, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    float32x4_t fullTurn = vdupq_n_f32(360.f);
+    float32x4_t invFullTurn = vdupq_n_f32(1.f / 360.f);
+
+    for (size_t i = 0; i < aligned; i += 4) {
+        float32x4_t fromVec = vld1q_f32(from + i);
+        float32x4_t diffVec = vsubq_f32(vld1q_f32(to + i), fromVec);
+
+        float32x4_t turns = vrndnq_f32(vmulq_f32(diffVec, invFullTurn));
+        diffVec = vmlsq_f32(diffVec, turns, fullTurn);
+
+        vst1q_f32(out + i, vfmaq_f32(fromVec, diffVec, vld1q_f32(ratio + i)));
+    }
+
+    lerpAngleTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+#else
+    lerpAngleTail(from, to, ratio, out, count);
+#endif
+}
+
+// cubic hermite between `from` and `to` for ratios in [0, 1], and a straight line along `toTangent` past the end
+static void hermiteTail(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float t = std::min(ratio[i], 1.f);
+        float past = ratio[i] - t;
+
+        float t2 = t * t;
+        float h01 = t2 * (3.f - 2.f * t);
+        float h10 = t * (t - 1.f) * (t - 1.f);
+        float h11 = t2 * (t - 1.f);
+
+        out[i] = from[i] + h01 * (to[i] - from[i]) + h10 * fromTangent[i] + (h11 + past) * toTangent[i];
+    }
+}
+
+void globed::simd::arm::hermite(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, std::size_t count) {
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    float32x4_t one = vdupq_n_f32(1.f);
+    float32x4_t three = vdupq_n_f32(3.f);
+
+    for (size_t i = 0; i < aligned; i += 4) {
+        float32x4_t ratioVec = vld1q_f32(ratio + i);
+        float32x4_t t = vminq_f32(ratioVec, one);
+        float32x4_t past = vsubq_f32(ratioVec, t);
+
+        float32x4_t t2 = vmulq_f32(t, t);
+        float32x4_t tm1 = vsubq_f32(t, one);
+        float32x4_t h01 = vmulq_f32(t2, vmlsq_n_f32(three, t, 2.f));
+        float32x4_t h10 = vmulq_f32(t, vmulq_f32(tm1, tm1));
+        float32x4_t h11 = vfmaq_f32(past, t2, tm1);
+
+        float32x4_t fromVec = vld1q_f32(from + i);
+        float32x4_t result = vfmaq_f32(fromVec, h01, vsubq_f32(vld1q_f32(to + i), fromVec));
+        result = vfmaq_f32(result, h10, vld1q_f32(fromTangent + i));
+        result = vfmaq_f32(result, h11, vld1q_f32(toTangent + i));
+
+        vst1q_f32(out + i, result);
+    }
+
+    hermiteTail(from + aligned, to + aligned, fromTangent + aligned, toTangent + aligned, ratio + aligned, out + aligned, count - aligned);
+#else
+    hermiteTail(from, to, fromTangent, toTangent, ratio, out, count);
+#endif
+}
+
+void globed::simd::arm::mixAdd(float* out, const float* in, float gain, std::size_t count) {
+    size_t i = 0;
+
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    for (; i < aligned; i += 4) {
+        vst1q_f32(out + i, vmlaq_n_f32(vld1q_f32(out + i), vld1q_f32(in + i), gain));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] += in[i] * gain;
+    }
+}
+
+float globed::simd::arm::dot(const float* a, const float* b, std::size_t count) {
+    size_t i = 0;
+    float sum = 0.f;
+
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+    float32x4_t sumVec = vdupq_n_f32(0.0f);
+
+    for (; i < aligned; i += 4) {
+        sumVec = vmlaq_f32(sumVec, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+
+    sum = vaddvq_f32(sumVec);
+#endif
+
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+void globed::simd::arm::distance(const float* x, const float* y, float* out, std::size_t count) {
+    size_t i = 0;
+
+#ifdef GLOBED_IS_64BIT
+    size_t aligned = count / 4 * 4;
+
+    for (; i < aligned; i += 4) {
+        float32x4_t xv = vld1q_f32(x + i);
+        float32x4_t yv = vld1q_f32(y + i);
+        vst1q_f32(out + i, vsqrtq_f32(vmlaq_f32(vmulq_f32(xv, xv), yv, yv)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+    }
+}
+
+#ifdef GLOBED_IS_64BIT
+// converts hex characters to their values, clears bytes of `valid` for anything that isn't a hex digit
+static inline uint8x16_t hexValues(uint8x16_t chars, uint8x16_t& valid) {
+    uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+    uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(9));
+
+    // fold to lowercase, this can't turn anything else into a letter
+    uint8x16_t letter = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t isLetter = vcleq_u8(letter, vdupq_n_u8(5));
+
+    valid = vandq_u8(valid, vorrq_u8(isDigit, isLetter));
+
+    return vorrq_u8(vandq_u8(isDigit, digit), vandq_u8(isLetter, vaddq_u8(letter, vdupq_n_u8(10))));
+}
+
+static inline uint8x16_t base64Values(uint8x16_t chars, uint8_t char62, uint8_t char63, uint8x16_t& valid) {
+    uint8x16_t upper = vsubq_u8(chars, vdupq_n_u8('A'));
+    uint8x16_t isUpper = vcleq_u8(upper, vdupq_n_u8(25));
+    uint8x16_t lower = vsubq_u8(chars, vdupq_n_u8('a'));
+    uint8x16_t isLower = vcleq_u8(lower, vdupq_n_u8(25));
+    uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+    uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(9));
+    uint8x16_t is62 = vceqq_u8(chars, vdupq_n_u8(char62));
+    uint8x16_t is63 = vceqq_u8(chars, vdupq_n_u8(char63));
+
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(isUpper, isLower), vorrq_u8(isDigit, vorrq_u8(is62, is63))));
+
+    return vorrq_u8(
+        vorrq_u8(vandq_u8(isUpper, upper), vandq_u8(isLower, vaddq_u8(lower, vdupq_n_u8(26)))),
+        vorrq_u8(
+            vandq_u8(isDigit, vaddq_u8(digit, vdupq_n_u8(52))),
+            vorrq_u8(vandq_u8(is62, vdupq_n_u8(62)), vandq_u8(is63, vdupq_n_u8(63)))
+        )
+    );
+}
+#endif
+
+std::size_t globed::simd::arm::hexEncodeBulk(const uint8_t* src, std::size_t len, char* out) {
+#ifdef GLOBED_IS_64BIT
+    const uint8x16_t lut = vld1q_u8(reinterpret_cast<const uint8_t*>("0123456789abcdef"));
+    const uint8x16_t nibble = vdupq_n_u8(0x0f);
+
+    size_t aligned = len / 16 * 16;
+
+    for (size_t i = 0; i < aligned; i += 16) {
+        uint8x16_t bytes = vld1q_u8(src + i);
+
+        uint8x16x2_t chars;
+        chars.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(bytes, 4));
+        chars.val[1] = vqtbl1q_u8(lut, vandq_u8(bytes, nibble));
+
+        vst2q_u8(reinterpret_cast<uint8_t*>(out + i * 2), chars);
+    }
+
+    return aligned;
+#else
+    return 0;
+#endif
+}
+
+std::size_t globed::simd::arm::hexDecodeBulk(const char* src, std::size_t len, uint8_t* out) {
+    size_t i = 0;
+
+#ifdef GLOBED_IS_64BIT
+    for (; i + 32 <= len; i += 32) {
+        // deinterleaves into high and low nibbles
+        uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i));
+
+        uint8x16_t valid = vdupq_n_u8(0xff);
+        uint8x16_t hi = hexValues(chars.val[0], valid);
+        uint8x16_t lo = hexValues(chars.val[1], valid);
+
+        if (vminvq_u8(valid) != 0xff) {
+            break;
+        }
+
+        vst1q_u8(out + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+#endif
+
+    return i;
+}
+
+std::size_t globed::simd::arm::base64EncodeBulk(const uint8_t* src, std::size_t len, char* out, bool urlsafe) {
+    size_t i = 0;
+
+#ifdef GLOBED_IS_64BIT
+    const char* alphabet = urlsafe
+        ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+        : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const uint8x16x4_t table = vld1q_u8_x4(reinterpret_cast<const uint8_t*>(alphabet));
+    const uint8x16_t sextet = vdupq_n_u8(0x3f);
+
+    size_t o = 0;
+
+    for (; i + 48 <= len; i += 48, o += 64) {
+        uint8x16x3_t in = vld3q_u8(src + i);
+
+        uint8x16x4_t idx;
+        idx.val[0] = vshrq_n_u8(in.val[0], 2);
+        idx.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), sextet);
+        idx.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), sextet);
+        idx.val[3] = vandq_u8(in.val[2], sextet);
+
+        uint8x16x4_t chars;
+        chars.val[0] = vqtbl4q_u8(table, idx.val[0]);
+        chars.val[1] = vqtbl4q_u8(table, idx.val[1]);
+        chars.val[2] = vqtbl4q_u8(table, idx.val[2]);
+        chars.val[3] = vqtbl4q_u8(table, idx.val[3]);
+
+        vst4q_u8(reinterpret_cast<uint8_t*>(out + o), chars);
+    }
+#endif
+
+    return i;
+}
+
+std::size_t globed::simd::arm::base64DecodeBulk(const char* src, std::size_t len, uint8_t* out, bool urlsafe) {
+    size_t i = 0;
+
+#ifdef GLOBED_IS_64BIT
+    const uint8_t char62 = urlsafe ? '-' : '+';
+    const uint8_t char63 = urlsafe ? '_' : '/';
+
+    size_t o = 0;
+
+    // the last group may have padding, leave it to libsodium
+    for (; i + 64 + 4 <= len; i += 64, o += 48) {
+        uint8x16x4_t chars = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+
+        uint8x16_t valid = vdupq_n_u8(0xff);
+        uint8x16_t a = base64Values(chars.val[0], char62, char63, valid);
+        uint8x16_t b = base64Values(chars.val[1], char62, char63, valid);
+        uint8x16_t c = base64Values(chars.val[2], char62, char63, valid);
+        uint8x16_t d = base64Values(chars.val[3], char62, char63, valid);
+
+        if (vminvq_u8(valid) != 0xff) {
+            break;
+        }
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+
+        vst3q_u8(out + o, bytes);
+    }
+#endif
+
+    return i;
+}
+
+// adler-32 with the modulo deferred as long as the sums can't overflow, like zlib
+static constexpr uint32_t ADLER_MOD = 65521;
+static constexpr size_t ADLER_NMAX = 5552;
+
+static uint32_t adler32Tail(uint32_t a, uint32_t b, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t n = std::min(len, ADLER_NMAX);
+        len -= n;
+
+        for (size_t i = 0; i < n; i++) {
+            a += data[i];
+            b += a;
+        }
+
+        data += n;
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+
+    return (b << 16) | a;
+}
+
+uint32_t globed::simd::arm::adler32(const uint8_t* data, std::size_t len) {
+    uint32_t a = 1, b = 0;
+
+#ifdef GLOBED_IS_64BIT
+    // based on the neon kernel in chromium's zlib (adler32_simd.c)
+    constexpr size_t BLOCK = 32;
+
+    size_t blocks = len / BLOCK;
+    len -= blocks * BLOCK;
+
+    static constexpr uint16_t TAPS[BLOCK] = {
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+    };
+
+    while (blocks > 0) {
+        size_t n = std::min(ADLER_NMAX / BLOCK, blocks);
+        blocks -= n;
+
+        // `a` gets added to `b` once for every byte in these blocks
+        uint32x4_t vb = vsetq_lane_u32(a * n, vdupq_n_u32(0), 3);
+        uint32x4_t va = vdupq_n_u32(0);
+
+        // per column byte sums, weighted by their position at the end. can't overflow within NMAX
+        uint16x8_t col1 = vdupq_n_u16(0);
+        uint16x8_t col2 = vdupq_n_u16(0);
+        uint16x8_t col3 = vdupq_n_u16(0);
+        uint16x8_t col4 = vdupq_n_u16(0);
+
+        do {
+            uint8x16_t bytes1 = vld1q_u8(data);
+            uint8x16_t bytes2 = vld1q_u8(data + 16);
+
+            // sum of `a` at the start of every block, multiplied by the block size below
+            vb = vaddq_u32(vb, va);
+            va = vpadalq_u16(va, vpadalq_u8(vpaddlq_u8(bytes1), bytes2));
+
+            col1 = vaddw_u8(col1, vget_low_u8(bytes1));
+            col2 = vaddw_u8(col2, vget_high_u8(bytes1));
+            col3 = vaddw_u8(col3, vget_low_u8(bytes2));
+            col4 = vaddw_u8(col4, vget_high_u8(bytes2));
+
+            data += BLOCK;
+        } while (--n);
+
+        vb = vshlq_n_u32(vb, 5);
+
+        vb = vmlal_u16(vb, vget_low_u16(col1), vld1_u16(TAPS));
+        vb = vmlal_u16(vb, vget_high_u16(col1), vld1_u16(TAPS + 4));
+        vb = vmlal_u16(vb, vget_low_u16(col2), vld1_u16(TAPS + 8));
+        vb = vmlal_u16(vb, vget_high_u16(col2), vld1_u16(TAPS + 12));
+        vb = vmlal_u16(vb, vget_low_u16(col3), vld1_u16(TAPS + 16));
+        vb = vmlal_u16(vb, vget_high_u16(col3), vld1_u16(TAPS + 20));
+        vb = vmlal_u16(vb, vget_low_u16(col4), vld1_u16(TAPS + 24));
+        vb = vmlal_u16(vb, vget_high_u16(col4), vld1_u16(TAPS + 28));
+
+        a += vaddvq_u32(va);
+        b += vaddvq_u32(vb);
+
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+#endif
+
+    return adler32Tail(a, b, data, len);
+}
+
+util::simd::Kernels globed::simd::arm::resolveKernels() {
+#ifdef GLOBED_IS_64BIT
+    // neon is mandatory on arm64, so there is nothing to detect
+    return util::simd::Kernels {
+        .name = "neon",
+        .pcmVolume = pcmVolume,
+        .adler32 = adler32,
+        .byteswap16 = byteswap16,
+        .byteswap32 = byteswap32,
+        .byteswap64 = byteswap64,
+        .lerp = lerp,
+        .lerpAngle = lerpAngle,
+        .mixAdd = mixAdd,
+        .dot = dot,
+        .distance = distance,
+        .hermite = hermite,
+        .hexEncodeBulk = hexEncodeBulk,
+        .hexDecodeBulk = hexDecodeBulk,
+        .base64EncodeBulk = base64EncodeBulk,
+        .base64DecodeBulk = base64DecodeBulk,
+    };
+#else
+    return util::simd::scalarKernels();
+#endif
+}
@@ -1,7 +1,43 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+
+#include <util/simd.hpp>
 
 namespace globed::simd::arm {
     float pcmVolume(const float* pcm, std::size_t samples);
-}
\ No newline at end of file
+
+    // Reverse the byte order of every element in place
+    void byteswap16(uint16_t* data, std::size_t count);
+    void byteswap32(uint32_t* data, std::size_t count);
+    void byteswap64(uint64_t* data, std::size_t count);
+
+    // out[i] = from[i] + (to[i] - from[i]) * ratio[i], `lerpAngle` takes the shortest way around for angles in degrees.
+    void lerp(const float* from, const float* to, const float* ratio, float* out, std::size_t count);
+    void lerpAngle(const float* from, const float* to, const float* ratio, float* out, std::size_t count);
+
+    // out[i] += in[i] * gain
+    void mixAdd(float* out, const float* in, float gain, std::size_t count);
+
+    // sum of a[i] * b[i]
+    float dot(const float* a, const float* b, std::size_t count);
+
+    // out[i] = sqrt(x[i] * x[i] + y[i] * y[i])
+    void distance(const float* x, const float* y, float* out, std::size_t count);
+
+    // Cubic hermite interpolation, see `util::simd::hermite`
+    void hermite(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, std::size_t count);
+
+    // Bulk hex / base64 codecs, see `util::simd::hexEncodeBulk` and friends
+    std::size_t hexEncodeBulk(const uint8_t* src, std::size_t len, char* out);
+    std::size_t hexDecodeBulk(const char* src, std::size_t len, uint8_t* out);
+    std::size_t base64EncodeBulk(const uint8_t* src, std::size_t len, char* out, bool urlsafe);
+    std::size_t base64DecodeBulk(const char* src, std::size_t len, uint8_t* out, bool urlsafe);
+
+    // Adler-32 checksum
+    uint32_t adler32(const uint8_t* data, std::size_t len);
+
+    // The kernel table for `util::simd`, neon on arm64 and scalar on 32-bit arm
+    util::simd::Kernels resolveKernels();
+}
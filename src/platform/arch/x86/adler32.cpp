@@ -0,0 +1,185 @@
+#include "x86simd.hpp"
+
+// adler-32 with the modulo deferred as long as the sums can't overflow, like zlib.
+// the vector kernels are based on the ones in chromium's zlib (adler32_simd.c).
+
+namespace globed::simd::x86 {
+    static constexpr uint32_t ADLER_MOD = 65521;
+    // largest n such that 255n(n+1)/2 + (n+1)(MOD-1) fits in 32 bits
+    static constexpr size_t ADLER_NMAX = 5552;
+
+    static uint32_t adler32Tail(uint32_t a, uint32_t b, const uint8_t* data, size_t len) {
+        while (len > 0) {
+            size_t n = len < ADLER_NMAX ? len : ADLER_NMAX;
+            len -= n;
+
+            for (size_t i = 0; i < n; i++) {
+                a += data[i];
+                b += a;
+            }
+
+            data += n;
+            a %= ADLER_MOD;
+            b %= ADLER_MOD;
+        }
+
+        return (b << 16) | a;
+    }
+
+    static inline uint32_t GLOBED_FEATURE_AVX2 hsum256(__m256i vec) {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(vec), _mm256_extracti128_si256(vec, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+    }
+
+    uint32_t GLOBED_FEATURE_SSSE3 adler32SSSE3(const uint8_t* data, size_t len) {
+        constexpr size_t BLOCK = 32;
+
+        uint32_t a = 1, b = 0;
+        size_t blocks = len / BLOCK;
+        len -= blocks * BLOCK;
+
+        // weight of each byte in the block for `b`
+        const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+        const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+
+        while (blocks > 0) {
+            size_t n = ADLER_NMAX / BLOCK;
+            if (n > blocks) n = blocks;
+            blocks -= n;
+
+            // `a` gets added to `b` once for every byte in these blocks
+            __m128i vps = _mm_set_epi32(0, 0, 0, static_cast<int>(a * n));
+            __m128i vb = _mm_set_epi32(0, 0, 0, static_cast<int>(b));
+            __m128i va = zero;
+
+            do {
+                __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                __m128i bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+
+                // sum of `a` at the start of every block, multiplied by the block size below
+                vps = _mm_add_epi32(vps, va);
+
+                va = _mm_add_epi32(va, _mm_sad_epu8(bytes1, zero));
+                va = _mm_add_epi32(va, _mm_sad_epu8(bytes2, zero));
+
+                vb = _mm_add_epi32(vb, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+                vb = _mm_add_epi32(vb, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+
+                data += BLOCK;
+            } while (--n);
+
+            vb = _mm_add_epi32(vb, _mm_slli_epi32(vps, 5));
+
+            // horizontal sums, `va` only has values in the low dword of each qword
+            va = _mm_add_epi32(va, _mm_shuffle_epi32(va, _MM_SHUFFLE(1, 0, 3, 2)));
+            a += static_cast<uint32_t>(_mm_cvtsi128_si32(va));
+
+            vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 3, 0, 1)));
+            vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+            b = static_cast<uint32_t>(_mm_cvtsi128_si32(vb));
+
+            a %= ADLER_MOD;
+            b %= ADLER_MOD;
+        }
+
+        return adler32Tail(a, b, data, len);
+    }
+
+    uint32_t GLOBED_FEATURE_AVX2 adler32AVX2(const uint8_t* data, size_t len) {
+        constexpr size_t BLOCK = 32;
+
+        uint32_t a = 1, b = 0;
+        size_t blocks = len / BLOCK;
+        len -= blocks * BLOCK;
+
+        const __m256i tap = _mm256_setr_epi8(
+            32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+            16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+        );
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi16(1);
+
+        while (blocks > 0) {
+            size_t n = ADLER_NMAX / BLOCK;
+            if (n > blocks) n = blocks;
+            blocks -= n;
+
+            __m256i vps = _mm256_setr_epi32(static_cast<int>(a * n), 0, 0, 0, 0, 0, 0, 0);
+            __m256i vb = _mm256_setr_epi32(static_cast<int>(b), 0, 0, 0, 0, 0, 0, 0);
+            __m256i va = zero;
+
+            do {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+
+                vps = _mm256_add_epi32(vps, va);
+                va = _mm256_add_epi32(va, _mm256_sad_epu8(bytes, zero));
+                vb = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+
+                data += BLOCK;
+            } while (--n);
+
+            vb = _mm256_add_epi32(vb, _mm256_slli_epi32(vps, 5));
+
+            a += hsum256(va);
+            b = hsum256(vb);
+
+            a %= ADLER_MOD;
+            b %= ADLER_MOD;
+        }
+
+        return adler32Tail(a, b, data, len);
+    }
+
+    uint32_t GLOBED_FEATURE_AVX512BW adler32AVX512(const uint8_t* data, size_t len) {
+        constexpr size_t BLOCK = 64;
+
+        alignas(64) static constexpr int8_t TAPS[BLOCK] = {
+            64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49,
+            48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33,
+            32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+            16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+        };
+
+        uint32_t a = 1, b = 0;
+        size_t blocks = len / BLOCK;
+        len -= blocks * BLOCK;
+
+        const __m512i tap = _mm512_load_si512(TAPS);
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i ones = _mm512_set1_epi16(1);
+
+        while (blocks > 0) {
+            size_t n = ADLER_NMAX / BLOCK;
+            if (n > blocks) n = blocks;
+            blocks -= n;
+
+            __m512i vps = _mm512_maskz_set1_epi32(1, static_cast<int>(a * n));
+            __m512i vb = _mm512_maskz_set1_epi32(1, static_cast<int>(b));
+            __m512i va = zero;
+
+            do {
+                __m512i bytes = _mm512_loadu_si512(data);
+
+                vps = _mm512_add_epi32(vps, va);
+                va = _mm512_add_epi32(va, _mm512_sad_epu8(bytes, zero));
+                vb = _mm512_add_epi32(vb, _mm512_madd_epi16(_mm512_maddubs_epi16(bytes, tap), ones));
+
+                data += BLOCK;
+            } while (--n);
+
+            vb = _mm512_add_epi32(vb, _mm512_slli_epi32(vps, 6));
+
+            a += static_cast<uint32_t>(_mm512_reduce_add_epi32(va));
+            b = static_cast<uint32_t>(_mm512_reduce_add_epi32(vb));
+
+            a %= ADLER_MOD;
+            b %= ADLER_MOD;
+        }
+
+        return adler32Tail(a, b, data, len);
+    }
+}
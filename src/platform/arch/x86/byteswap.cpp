@@ -0,0 +1,68 @@
+#include "x86simd.hpp"
+
+#include <util/data.hpp>
+#include <cstring>
+
+namespace globed::simd::x86 {
+    // shuffle masks that reverse the bytes of every 2, 4 or 8 byte element in a 16 byte lane
+    static const __m128i* shuffleMask(size_t width) {
+        alignas(16) static const uint8_t masks[3][16] = {
+            {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+            {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+            {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8},
+        };
+
+        return reinterpret_cast<const __m128i*>(masks[width == 2 ? 0 : width == 4 ? 1 : 2]);
+    }
+
+    // `data` does not have to be aligned, byte buffers hand out pointers to arbitrary offsets
+    template <typename T>
+    static void byteswapTail(T* data, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            T value;
+            std::memcpy(&value, data + i, sizeof(T));
+            value = util::data::byteswap(value);
+            std::memcpy(data + i, &value, sizeof(T));
+        }
+    }
+
+    template <typename T>
+    static void GLOBED_FEATURE_SSSE3 byteswapSSSE3(T* data, size_t count) {
+        constexpr size_t perVec = 16 / sizeof(T);
+        size_t aligned = count / perVec * perVec;
+
+        __m128i mask = _mm_load_si128(shuffleMask(sizeof(T)));
+
+        for (size_t i = 0; i < aligned; i += perVec) {
+            __m128i vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_shuffle_epi8(vec, mask));
+        }
+
+        byteswapTail(data + aligned, count - aligned);
+    }
+
+    template <typename T>
+    static void GLOBED_FEATURE_AVX2 byteswapAVX2(T* data, size_t count) {
+        constexpr size_t perVec = 32 / sizeof(T);
+        size_t aligned = count / perVec * perVec;
+
+        // vpshufb works within each 128 bit lane, so the same mask is used for both halves
+        __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(shuffleMask(sizeof(T))));
+
+        for (size_t i = 0; i < aligned; i += perVec) {
+            __m256i vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_shuffle_epi8(vec, mask));
+        }
+
+        byteswapTail(data + aligned, count - aligned);
+    }
+
+    void byteswap16SSSE3(uint16_t* data, size_t count) { byteswapSSSE3(data, count); }
+    void byteswap32SSSE3(uint32_t* data, size_t count) { byteswapSSSE3(data, count); }
+    void byteswap64SSSE3(uint64_t* data, size_t count) { byteswapSSSE3(data, count); }
+
+    void byteswap16AVX2(uint16_t* data, size_t count) { byteswapAVX2(data, count); }
+    void byteswap32AVX2(uint32_t* data, size_t count) { byteswapAVX2(data, count); }
+    void byteswap64AVX2(uint64_t* data, size_t count) { byteswapAVX2(data, count); }
+
+}
@@ -0,0 +1,218 @@
+#include "x86simd.hpp"
+
+#include <cstring>
+
+// hex and base64 kernels, they only handle whole blocks and leave the rest (and all error reporting) to libsodium.
+// base64 is based on the algorithms by Wojciech Muła, http://0x80.pl/articles/index.html#base64-algorithm-new
+
+namespace globed::simd::x86 {
+    alignas(16) static const char HEX_DIGITS[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+    /* hex */
+
+    size_t GLOBED_FEATURE_SSSE3 hexEncodeSSSE3(const uint8_t* src, size_t len, char* out) {
+        const __m128i lut = _mm_load_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+
+        size_t aligned = len / 16 * 16;
+
+        for (size_t i = 0; i < aligned; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+            __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+            __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(bytes, nibble));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+        }
+
+        return aligned;
+    }
+
+    size_t GLOBED_FEATURE_AVX2 hexEncodeAVX2(const uint8_t* src, size_t len, char* out) {
+        const __m256i lut = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS)));
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+        size_t aligned = len / 32 * 32;
+
+        for (size_t i = 0; i < aligned; i += 32) {
+            // unpacking works within 128-bit lanes, so order the quadwords as [0, 2, 1, 3] first to get sequential output
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            bytes = _mm256_permute4x64_epi64(bytes, 0xd8);
+
+            __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+            __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(bytes, nibble));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2), _mm256_unpacklo_epi8(hi, lo));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2 + 32), _mm256_unpackhi_epi8(hi, lo));
+        }
+
+        // the rest fits into ssse3 blocks
+        return aligned + hexEncodeSSSE3(src + aligned, len - aligned, out + aligned * 2);
+    }
+
+    // converts hex characters to their values, clears bytes of `valid` for anything that isn't a hex digit
+    static inline __m128i GLOBED_FEATURE_SSSE3 hexValues(__m128i chars, __m128i& valid) {
+        __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+        // fold to lowercase, this can't turn anything else into a letter
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+        valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isLetter));
+
+        return _mm_or_si128(
+            _mm_and_si128(isDigit, digit),
+            _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10)))
+        );
+    }
+
+    size_t GLOBED_FEATURE_SSSE3 hexDecodeSSSE3(const char* src, size_t len, uint8_t* out) {
+        // even bytes are the high nibble
+        const __m128i weights = _mm_set1_epi16(0x0110);
+
+        size_t i = 0;
+
+        for (; i + 32 <= len; i += 32) {
+            __m128i valid = _mm_set1_epi8(-1);
+            __m128i a = hexValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), valid);
+            __m128i b = hexValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), valid);
+
+            if (_mm_movemask_epi8(valid) != 0xffff) {
+                break;
+            }
+
+            __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), bytes);
+        }
+
+        return i;
+    }
+
+    static inline __m256i GLOBED_FEATURE_AVX2 hexValues256(__m256i chars, __m256i& valid) {
+        __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+        __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+        valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isLetter));
+
+        return _mm256_or_si256(
+            _mm256_and_si256(isDigit, digit),
+            _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10)))
+        );
+    }
+
+    size_t GLOBED_FEATURE_AVX2 hexDecodeAVX2(const char* src, size_t len, uint8_t* out) {
+        const __m256i weights = _mm256_set1_epi16(0x0110);
+
+        size_t i = 0;
+
+        for (; i + 64 <= len; i += 64) {
+            __m256i valid = _mm256_set1_epi8(-1);
+            __m256i a = hexValues256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), valid);
+            __m256i b = hexValues256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)), valid);
+
+            if (_mm256_movemask_epi8(valid) != -1) {
+                break;
+            }
+
+            // packing works within lanes too, [a0, b0, a1, b1] -> [a0, a1, b0, b1]
+            __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+            bytes = _mm256_permute4x64_epi64(bytes, 0xd8);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 2), bytes);
+        }
+
+        return i + hexDecodeSSSE3(src + i, len - i, out + i / 2);
+    }
+
+    /* base64 */
+
+    size_t GLOBED_FEATURE_SSSE3 base64EncodeSSSE3(const uint8_t* src, size_t len, char* out, bool urlsafe) {
+        // every 3 input bytes go into one 32-bit lane, then get split into four 6-bit indices
+        const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+        // offsets from the sextet to the character, indexed by a reduced sextet computed below
+        const __m128i offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            (urlsafe ? '-' : '+') - 62, (urlsafe ? '_' : '/') - 63, 'A', 0, 0
+        );
+
+        size_t i = 0;
+        size_t o = 0;
+
+        // 12 bytes are used, but 16 are loaded
+        for (; i + 16 <= len; i += 12, o += 16) {
+            __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), spread);
+
+            __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+            __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+            __m128i sextets = _mm_or_si128(t0, t1);
+
+            // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+            __m128i reduced = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+            __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+            reduced = _mm_or_si128(reduced, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+            __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, reduced), sextets);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), chars);
+        }
+
+        return i;
+    }
+
+    size_t GLOBED_FEATURE_SSSE3 base64DecodeSSSE3(const char* src, size_t len, uint8_t* out, bool urlsafe) {
+        const __m128i char62 = _mm_set1_epi8(urlsafe ? '-' : '+');
+        const __m128i char63 = _mm_set1_epi8(urlsafe ? '_' : '/');
+        const __m128i gather = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+        size_t i = 0;
+        size_t o = 0;
+
+        // the last group may have padding, leave it to libsodium
+        for (; i + 16 + 4 <= len; i += 16, o += 12) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+            __m128i upper = _mm_sub_epi8(chars, _mm_set1_epi8('A'));
+            __m128i isUpper = _mm_cmpeq_epi8(_mm_min_epu8(upper, _mm_set1_epi8(25)), upper);
+            __m128i lower = _mm_sub_epi8(chars, _mm_set1_epi8('a'));
+            __m128i isLower = _mm_cmpeq_epi8(_mm_min_epu8(lower, _mm_set1_epi8(25)), lower);
+            __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+            __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            __m128i is62 = _mm_cmpeq_epi8(chars, char62);
+            __m128i is63 = _mm_cmpeq_epi8(chars, char63);
+
+            __m128i valid = _mm_or_si128(_mm_or_si128(isUpper, isLower), _mm_or_si128(isDigit, _mm_or_si128(is62, is63)));
+            if (_mm_movemask_epi8(valid) != 0xffff) {
+                break;
+            }
+
+            __m128i sextets = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(isUpper, upper),
+                    _mm_and_si128(isLower, _mm_add_epi8(lower, _mm_set1_epi8(26)))
+                ),
+                _mm_or_si128(
+                    _mm_and_si128(isDigit, _mm_add_epi8(digit, _mm_set1_epi8(52))),
+                    _mm_or_si128(_mm_and_si128(is62, _mm_set1_epi8(62)), _mm_and_si128(is63, _mm_set1_epi8(63)))
+                )
+            );
+
+            // merge pairs of sextets into 12 bits, then pairs of those into 24 bits per 32-bit lane
+            __m128i merged = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+            merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+            __m128i bytes = _mm_shuffle_epi8(merged, gather);
+
+            // only 12 bytes are valid, don't write past them
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + o), bytes);
+            uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+            std::memcpy(out + o + 8, &last, sizeof(last));
+        }
+
+        return i;
+    }
+}
@@ -0,0 +1,190 @@
+#include "x86simd.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace globed::simd::x86 {
+    static void lerpTail(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = from[i] + (to[i] - from[i]) * ratio[i];
+        }
+    }
+
+    // wraps the difference into [-180, 180] by subtracting the nearest multiple of 360, same as the vector versions
+    static void lerpAngleTail(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            float diff = to[i] - from[i];
+            diff -= 360.f * std::nearbyint(diff / 360.f);
+            out[i] = from[i] + diff * ratio[i];
+        }
+    }
+
+    // cubic hermite between `from` and `to` for ratios in [0, 1], and a straight line along `toTangent` past the end
+    static void hermiteTail(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            float t = std::min(ratio[i], 1.f);
+            float past = ratio[i] - t;
+
+            float t2 = t * t;
+            float h01 = t2 * (3.f - 2.f * t);
+            float h10 = t * (t - 1.f) * (t - 1.f);
+            float h11 = t2 * (t - 1.f);
+
+            out[i] = from[i] + h01 * (to[i] - from[i]) + h10 * fromTangent[i] + (h11 + past) * toTangent[i];
+        }
+    }
+
+    void lerpSSE(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 4 * 4;
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            __m128 fromVec = _mm_loadu_ps(from + i);
+            __m128 diffVec = _mm_sub_ps(_mm_loadu_ps(to + i), fromVec);
+            __m128 result = _mm_add_ps(fromVec, _mm_mul_ps(diffVec, _mm_loadu_ps(ratio + i)));
+            _mm_storeu_ps(out + i, result);
+        }
+
+        lerpTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    void lerpAngleSSE(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 4 * 4;
+
+        __m128 fullTurn = _mm_set1_ps(360.f);
+        __m128 invFullTurn = _mm_set1_ps(1.f / 360.f);
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            __m128 fromVec = _mm_loadu_ps(from + i);
+            __m128 diffVec = _mm_sub_ps(_mm_loadu_ps(to + i), fromVec);
+
+            // sse2 has no round instruction, but the conversion rounds to nearest
+            __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(diffVec, invFullTurn)));
+            diffVec = _mm_sub_ps(diffVec, _mm_mul_ps(turns, fullTurn));
+
+            __m128 result = _mm_add_ps(fromVec, _mm_mul_ps(diffVec, _mm_loadu_ps(ratio + i)));
+            _mm_storeu_ps(out + i, result);
+        }
+
+        lerpAngleTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    void GLOBED_FEATURE_AVX lerpAVX(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 8 * 8;
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            __m256 fromVec = _mm256_loadu_ps(from + i);
+            __m256 diffVec = _mm256_sub_ps(_mm256_loadu_ps(to + i), fromVec);
+            __m256 result = _mm256_add_ps(fromVec, _mm256_mul_ps(diffVec, _mm256_loadu_ps(ratio + i)));
+            _mm256_storeu_ps(out + i, result);
+        }
+
+        lerpTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    void GLOBED_FEATURE_AVX lerpAngleAVX(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 8 * 8;
+
+        __m256 fullTurn = _mm256_set1_ps(360.f);
+        __m256 invFullTurn = _mm256_set1_ps(1.f / 360.f);
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            __m256 fromVec = _mm256_loadu_ps(from + i);
+            __m256 diffVec = _mm256_sub_ps(_mm256_loadu_ps(to + i), fromVec);
+
+            __m256 turns = _mm256_round_ps(_mm256_mul_ps(diffVec, invFullTurn), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            diffVec = _mm256_sub_ps(diffVec, _mm256_mul_ps(turns, fullTurn));
+
+            __m256 result = _mm256_add_ps(fromVec, _mm256_mul_ps(diffVec, _mm256_loadu_ps(ratio + i)));
+            _mm256_storeu_ps(out + i, result);
+        }
+
+        lerpAngleTail(from + aligned, to + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    void hermiteSSE(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 4 * 4;
+
+        __m128 one = _mm_set1_ps(1.f);
+        __m128 two = _mm_set1_ps(2.f);
+        __m128 three = _mm_set1_ps(3.f);
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            __m128 ratioVec = _mm_loadu_ps(ratio + i);
+            __m128 t = _mm_min_ps(ratioVec, one);
+            __m128 past = _mm_sub_ps(ratioVec, t);
+
+            __m128 t2 = _mm_mul_ps(t, t);
+            __m128 tm1 = _mm_sub_ps(t, one);
+            __m128 h01 = _mm_mul_ps(t2, _mm_sub_ps(three, _mm_mul_ps(two, t)));
+            __m128 h10 = _mm_mul_ps(t, _mm_mul_ps(tm1, tm1));
+            __m128 h11 = _mm_add_ps(_mm_mul_ps(t2, tm1), past);
+
+            __m128 fromVec = _mm_loadu_ps(from + i);
+            __m128 result = _mm_add_ps(fromVec, _mm_mul_ps(h01, _mm_sub_ps(_mm_loadu_ps(to + i), fromVec)));
+            result = _mm_add_ps(result, _mm_mul_ps(h10, _mm_loadu_ps(fromTangent + i)));
+            result = _mm_add_ps(result, _mm_mul_ps(h11, _mm_loadu_ps(toTangent + i)));
+
+            _mm_storeu_ps(out + i, result);
+        }
+
+        hermiteTail(from + aligned, to + aligned, fromTangent + aligned, toTangent + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    void GLOBED_FEATURE_AVX hermiteAVX(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+        size_t aligned = count / 8 * 8;
+
+        __m256 one = _mm256_set1_ps(1.f);
+        __m256 two = _mm256_set1_ps(2.f);
+        __m256 three = _mm256_set1_ps(3.f);
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            __m256 ratioVec = _mm256_loadu_ps(ratio + i);
+            __m256 t = _mm256_min_ps(ratioVec, one);
+            __m256 past = _mm256_sub_ps(ratioVec, t);
+
+            __m256 t2 = _mm256_mul_ps(t, t);
+            __m256 tm1 = _mm256_sub_ps(t, one);
+            __m256 h01 = _mm256_mul_ps(t2, _mm256_sub_ps(three, _mm256_mul_ps(two, t)));
+            __m256 h10 = _mm256_mul_ps(t, _mm256_mul_ps(tm1, tm1));
+            __m256 h11 = _mm256_add_ps(_mm256_mul_ps(t2, tm1), past);
+
+            __m256 fromVec = _mm256_loadu_ps(from + i);
+            __m256 result = _mm256_add_ps(fromVec, _mm256_mul_ps(h01, _mm256_sub_ps(_mm256_loadu_ps(to + i), fromVec)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(h10, _mm256_loadu_ps(fromTangent + i)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(h11, _mm256_loadu_ps(toTangent + i)));
+
+            _mm256_storeu_ps(out + i, result);
+        }
+
+        hermiteTail(from + aligned, to + aligned, fromTangent + aligned, toTangent + aligned, ratio + aligned, out + aligned, count - aligned);
+    }
+
+    static void distanceTail(const float* x, const float* y, float* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        }
+    }
+
+    void distanceSSE(const float* x, const float* y, float* out, size_t count) {
+        size_t aligned = count / 4 * 4;
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            __m128 xv = _mm_loadu_ps(x + i);
+            __m128 yv = _mm_loadu_ps(y + i);
+            _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(xv, xv), _mm_mul_ps(yv, yv))));
+        }
+
+        distanceTail(x + aligned, y + aligned, out + aligned, count - aligned);
+    }
+
+    void GLOBED_FEATURE_AVX distanceAVX(const float* x, const float* y, float* out, size_t count) {
+        size_t aligned = count / 8 * 8;
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            __m256 xv = _mm256_loadu_ps(x + i);
+            __m256 yv = _mm256_loadu_ps(y + i);
+            _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(xv, xv), _mm256_mul_ps(yv, yv))));
+        }
+
+        distanceTail(x + aligned, y + aligned, out + aligned, count - aligned);
+    }
+}
@@ -63,4 +63,66 @@ namespace globed::simd::x86 {
 
         return sum / samples;
     }
-}
\ No newline at end of file
+
+    void mixAddSSE(float* out, const float* in, float gain, size_t count) {
+        size_t aligned = count / 4 * 4;
+        __m128 gainVec = _mm_set1_ps(gain);
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            __m128 result = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), gainVec));
+            _mm_storeu_ps(out + i, result);
+        }
+
+        for (size_t i = aligned; i < count; i++) {
+            out[i] += in[i] * gain;
+        }
+    }
+
+    void GLOBED_FEATURE_AVX mixAddAVX(float* out, const float* in, float gain, size_t count) {
+        size_t aligned = count / 8 * 8;
+        __m256 gainVec = _mm256_set1_ps(gain);
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            __m256 result = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(in + i), gainVec));
+            _mm256_storeu_ps(out + i, result);
+        }
+
+        for (size_t i = aligned; i < count; i++) {
+            out[i] += in[i] * gain;
+        }
+    }
+
+    float dotSSE(const float* a, const float* b, size_t count) {
+        size_t aligned = count / 4 * 4;
+        __m128 sumVec = _mm_setzero_ps();
+
+        for (size_t i = 0; i < aligned; i += 4) {
+            sumVec = _mm_add_ps(sumVec, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+
+        float sum = vec128sum(sumVec);
+
+        for (size_t i = aligned; i < count; i++) {
+            sum += a[i] * b[i];
+        }
+
+        return sum;
+    }
+
+    float GLOBED_FEATURE_AVX dotAVX(const float* a, const float* b, size_t count) {
+        size_t aligned = count / 8 * 8;
+        __m256 sumVec = _mm256_setzero_ps();
+
+        for (size_t i = 0; i < aligned; i += 8) {
+            sumVec = _mm256_add_ps(sumVec, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+
+        float sum = vec128sum(_mm_add_ps(_mm256_castps256_ps128(sumVec), _mm256_extractf128_ps(sumVec, 1)));
+
+        for (size_t i = aligned; i < count; i++) {
+            sum += a[i] * b[i];
+        }
+
+        return sum;
+    }
+}
@@ -56,6 +56,7 @@ namespace globed::simd::x86 {
                 FEATURE(ebx, avx2, 5);
                 FEATURE(ebx, avx512, 16);
                 FEATURE(ebx, avx512dq, 17);
+                FEATURE(ebx, avx512bw, 30);
             }
 
             std::vector<std::string> featureList;
@@ -71,6 +72,7 @@ namespace globed::simd::x86 {
             features.avx2 ? featureList.push_back("avx2") : (void)0;
             features.avx512 ? featureList.push_back("avx512") : (void)0;
             features.avx512dq ? featureList.push_back("avx512dq") : (void)0;
+            features.avx512bw ? featureList.push_back("avx512bw") : (void)0;
 
             // log::debug("Supported cpu features: {}", featureList);
 
@@ -112,15 +114,65 @@ namespace globed::simd::x86 {
         return _mm512_reduce_add_ps(vec);
     }
 
-    float pcmVolume(const float* pcm, size_t samples) {
+    util::simd::Kernels resolveKernels() {
         const auto& features = getFeatures();
 
+        // sse2 is always there on x86_64, everything else gets checked
+        util::simd::Kernels k = util::simd::scalarKernels();
+        k.name = "sse2";
+
+        k.pcmVolume = pcmVolumeSSE;
+        k.lerp = lerpSSE;
+        k.lerpAngle = lerpAngleSSE;
+        k.mixAdd = mixAddSSE;
+        k.dot = dotSSE;
+        k.distance = distanceSSE;
+        k.hermite = hermiteSSE;
+
+        if (features.ssse3) {
+            k.name = "ssse3";
+            k.adler32 = adler32SSSE3;
+            k.byteswap16 = byteswap16SSSE3;
+            k.byteswap32 = byteswap32SSSE3;
+            k.byteswap64 = byteswap64SSSE3;
+            k.hexEncodeBulk = hexEncodeSSSE3;
+            k.hexDecodeBulk = hexDecodeSSSE3;
+            k.base64EncodeBulk = base64EncodeSSSE3;
+            k.base64DecodeBulk = base64DecodeSSSE3;
+        }
+
+        if (features.avx) {
+            k.name = "avx";
+            k.lerp = lerpAVX;
+            k.lerpAngle = lerpAngleAVX;
+            k.mixAdd = mixAddAVX;
+            k.dot = dotAVX;
+            k.distance = distanceAVX;
+            k.hermite = hermiteAVX;
+        }
+
+        // there are no avx512bw byteswap kernels, the arrays swapped here are too small for them to pay off
+        if (features.avx2) {
+            k.name = "avx2";
+            k.pcmVolume = pcmVolumeAVX2;
+            k.adler32 = adler32AVX2;
+            k.byteswap16 = byteswap16AVX2;
+            k.byteswap32 = byteswap32AVX2;
+            k.byteswap64 = byteswap64AVX2;
+            k.hexEncodeBulk = hexEncodeAVX2;
+            k.hexDecodeBulk = hexDecodeAVX2;
+        }
+
         if (features.avx512dq) {
-            return pcmVolumeAVX512(pcm, samples);
-        } else if (features.avx2) {
-            return pcmVolumeAVX2(pcm, samples);
-        } else {
-            return pcmVolumeSSE(pcm, samples);
+            k.name = "avx512";
+            k.pcmVolume = pcmVolumeAVX512;
+        }
+
+        if (features.avx512bw) {
+            k.name = "avx512";
+            k.adler32 = adler32AVX512;
         }
+
+        return k;
     }
-}
\ No newline at end of file
+}
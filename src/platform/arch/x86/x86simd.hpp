@@ -2,24 +2,30 @@
 #include <immintrin.h>
 #include <stdint.h>
 
+#include <util/simd.hpp>
+
 // everything here was done just for fun and educational purposes don't judge me too harshly :D
 
 #if defined(__clang__) || defined(__GNUC__)
+# define GLOBED_FEATURE_SSSE3 __attribute__((__target__("ssse3")))
 # define GLOBED_FEATURE_AVX __attribute__((__target__("avx")))
 # define GLOBED_FEATURE_AVX2 __attribute__((__target__("avx2")))
 # define GLOBED_FEATURE_AVX512 __attribute__((__target__("avx512f")))
 # define GLOBED_FEATURE_AVX512DQ __attribute__((__target__("avx512dq")))
+# define GLOBED_FEATURE_AVX512BW __attribute__((__target__("avx512bw")))
 #else // __clang__
 // on msvc there's no need to set these
+# define GLOBED_FEATURE_SSSE3
 # define GLOBED_FEATURE_AVX
 # define GLOBED_FEATURE_AVX2
 # define GLOBED_FEATURE_AVX512
 # define GLOBED_FEATURE_AVX512DQ
+# define GLOBED_FEATURE_AVX512BW
 #endif // __clang__
 
 namespace globed::simd::x86 {
     struct CPUFeatures {
-        bool sse3, pclmulqdq, ssse3, sse4_1, sse4_2, aes, avx, sse, sse2, avx2, avx512, avx512dq;
+        bool sse3, pclmulqdq, ssse3, sse4_1, sse4_2, aes, avx, sse, sse2, avx2, avx512, avx512dq, avx512bw;
     };
 
     /* Generic functions */
@@ -33,11 +39,11 @@ namespace globed::simd::x86 {
     float GLOBED_FEATURE_AVX512 vec512sum(__m512 vec);
 
 
-    /* Functions that auto pick the fastest algorithm */
+    /* Kernel table */
 
 
-    // Calculate the volume of pcm samples, picking the fastest possible implementation.
-    float pcmVolume(const float* pcm, size_t samples);
+    // Picks the fastest implementation of every `util::simd` kernel for this cpu, falling back to the scalar ones.
+    util::simd::Kernels resolveKernels();
 
 
     /* Functions written with a specific algorithm */
@@ -46,4 +52,35 @@ namespace globed::simd::x86 {
     float pcmVolumeSSE(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX2 pcmVolumeAVX2(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX512DQ pcmVolumeAVX512(const float* pcm, size_t samples);
-}
\ No newline at end of file
+    void mixAddSSE(float* out, const float* in, float gain, size_t count);
+    void GLOBED_FEATURE_AVX mixAddAVX(float* out, const float* in, float gain, size_t count);
+    float dotSSE(const float* a, const float* b, size_t count);
+    float GLOBED_FEATURE_AVX dotAVX(const float* a, const float* b, size_t count);
+
+    void GLOBED_FEATURE_SSSE3 byteswap16SSSE3(uint16_t* data, size_t count);
+    void GLOBED_FEATURE_SSSE3 byteswap32SSSE3(uint32_t* data, size_t count);
+    void GLOBED_FEATURE_SSSE3 byteswap64SSSE3(uint64_t* data, size_t count);
+    void GLOBED_FEATURE_AVX2 byteswap16AVX2(uint16_t* data, size_t count);
+    void GLOBED_FEATURE_AVX2 byteswap32AVX2(uint32_t* data, size_t count);
+    void GLOBED_FEATURE_AVX2 byteswap64AVX2(uint64_t* data, size_t count);
+
+    void lerpSSE(const float* from, const float* to, const float* ratio, float* out, size_t count);
+    void lerpAngleSSE(const float* from, const float* to, const float* ratio, float* out, size_t count);
+    void GLOBED_FEATURE_AVX lerpAVX(const float* from, const float* to, const float* ratio, float* out, size_t count);
+    void GLOBED_FEATURE_AVX lerpAngleAVX(const float* from, const float* to, const float* ratio, float* out, size_t count);
+    void hermiteSSE(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count);
+    void GLOBED_FEATURE_AVX hermiteAVX(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count);
+    void distanceSSE(const float* x, const float* y, float* out, size_t count);
+    void GLOBED_FEATURE_AVX distanceAVX(const float* x, const float* y, float* out, size_t count);
+
+    size_t GLOBED_FEATURE_SSSE3 hexEncodeSSSE3(const uint8_t* src, size_t len, char* out);
+    size_t GLOBED_FEATURE_AVX2 hexEncodeAVX2(const uint8_t* src, size_t len, char* out);
+    size_t GLOBED_FEATURE_SSSE3 hexDecodeSSSE3(const char* src, size_t len, uint8_t* out);
+    size_t GLOBED_FEATURE_AVX2 hexDecodeAVX2(const char* src, size_t len, uint8_t* out);
+    size_t GLOBED_FEATURE_SSSE3 base64EncodeSSSE3(const uint8_t* src, size_t len, char* out, bool urlsafe);
+    size_t GLOBED_FEATURE_SSSE3 base64DecodeSSSE3(const char* src, size_t len, uint8_t* out, bool urlsafe);
+
+    uint32_t GLOBED_FEATURE_SSSE3 adler32SSSE3(const uint8_t* data, size_t len);
+    uint32_t GLOBED_FEATURE_AVX2 adler32AVX2(const uint8_t* data, size_t len);
+    uint32_t GLOBED_FEATURE_AVX512BW adler32AVX512(const uint8_t* data, size_t len);
+}
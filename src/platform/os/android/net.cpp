@@ -1,7 +1,14 @@
 #include <util/net.hpp>
+#include <defs/assert.hpp>
 
 #include <sys/types.h>
+#include <sys/epoll.h>
+#include <linux/sock_diag.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <netdb.h>
+#include <unistd.h>
+#include <algorithm>
 
 void util::net::initialize() {}
 void util::net::cleanup() {}
@@ -14,3 +21,138 @@ std::string util::net::lastErrorString(int code, bool gai) {
     if (gai) return fmt::format("[Unix gai error {}]: {}", code, gai_strerror(code));
     return fmt::format("[Unix error {}]: {}", code, strerror(code));
 }
+
+std::optional<uint32_t> util::net::receiveDropCount(socket_t socket) {
+    uint32_t meminfo[SK_MEMINFO_VARS] = {};
+    socklen_t len = sizeof(meminfo);
+
+    // the drop counter is the last field and was added later than the rest, old kernels return a shorter array
+    if (getsockopt(socket, SOL_SOCKET, SO_MEMINFO, meminfo, &len) == -1 || len <= SK_MEMINFO_DROPS * sizeof(uint32_t)) {
+        return std::nullopt;
+    }
+
+    return meminfo[SK_MEMINFO_DROPS];
+}
+
+/* SocketPoller (epoll) */
+
+class util::net::SocketPoller::Impl {
+public:
+    int epfd = -1;
+    socket_t registered[MAX_SOCKETS];
+    size_t registeredCount = 0;
+    bool valid = false;
+
+    bool matches(const socket_t* sockets, size_t count) {
+        return valid && count == registeredCount && std::equal(sockets, sockets + count, registered);
+    }
+
+    Result<> reregister(const socket_t* sockets, size_t count) {
+        // closed sockets remove themselves from the epoll set, so errors here are expected and harmless
+        for (size_t i = 0; i < registeredCount; i++) {
+            epoll_ctl(epfd, EPOLL_CTL_DEL, registered[i], nullptr);
+        }
+
+        registeredCount = 0;
+        valid = false;
+
+        for (size_t i = 0; i < count; i++) {
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u32 = i;
+
+            if (epoll_ctl(epfd, EPOLL_CTL_ADD, sockets[i], &event) == -1) {
+                return Err(util::net::lastErrorString());
+            }
+
+            registered[registeredCount++] = sockets[i];
+        }
+
+        valid = true;
+        return Ok();
+    }
+};
+
+util::net::SocketPoller::SocketPoller() : impl(new Impl()) {
+    impl->epfd = epoll_create1(EPOLL_CLOEXEC);
+    GLOBED_REQUIRE(impl->epfd != -1, "failed to create an epoll instance");
+}
+
+util::net::SocketPoller::~SocketPoller() {
+    if (impl->epfd != -1) {
+        ::close(impl->epfd);
+    }
+
+    delete impl;
+}
+
+Result<uint32_t> util::net::SocketPoller::wait(const socket_t* sockets, size_t count, int timeoutMs) {
+    GLOBED_REQUIRE_SAFE(count <= MAX_SOCKETS, "too many sockets passed to SocketPoller::wait")
+
+    if (!impl->matches(sockets, count)) {
+        GLOBED_UNWRAP(impl->reregister(sockets, count));
+    }
+
+    epoll_event events[MAX_SOCKETS];
+    int result = epoll_wait(impl->epfd, events, MAX_SOCKETS, timeoutMs);
+
+    if (result == -1) {
+        // a signal interrupting the wait is the same as a timeout for us
+        if (errno == EINTR) return Ok(0);
+        return Err(util::net::lastErrorString());
+    }
+
+    uint32_t mask = 0;
+    for (int i = 0; i < result; i++) {
+        mask |= 1u << events[i].data.u32;
+    }
+
+    return Ok(mask);
+}
+
+void util::net::SocketPoller::invalidate() {
+    impl->valid = false;
+}
+
+/* TrafficMarker (IP_TOS) */
+
+class util::net::TrafficMarker::Impl {
+public:
+    socket_t socket = -1;
+    TrafficClass current = TrafficClass::BestEffort;
+};
+
+util::net::TrafficMarker::TrafficMarker() : impl(new Impl()) {}
+
+util::net::TrafficMarker::~TrafficMarker() {
+    delete impl;
+}
+
+Result<> util::net::TrafficMarker::attach(socket_t socket, const sockaddr_in& destination) {
+    impl->socket = socket;
+    impl->current = TrafficClass::BestEffort;
+    return Ok();
+}
+
+void util::net::TrafficMarker::detach() {
+    impl->socket = -1;
+}
+
+bool util::net::TrafficMarker::attached() const {
+    return impl->socket != -1;
+}
+
+Result<> util::net::TrafficMarker::mark(TrafficClass cls) {
+    GLOBED_REQUIRE_SAFE(this->attached(), "attempting to mark traffic of a detached socket")
+
+    if (cls == impl->current) return Ok();
+
+    // DSCP is the upper 6 bits of the TOS byte, the lower 2 are ECN and are left to the OS
+    int tos = static_cast<int>(cls) << 2;
+    if (setsockopt(impl->socket, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) == -1) {
+        return Err(util::net::lastErrorString());
+    }
+
+    impl->current = cls;
+    return Ok();
+}
@@ -0,0 +1,21 @@
+#include <util/power.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace util::power;
+
+PowerSource util::power::currentSource() {
+    // readable by apps on most devices, some vendors lock it down with selinux and then we just don't know
+    FILE* file = std::fopen("/sys/class/power_supply/battery/status", "r");
+    if (!file) return PowerSource::Unknown;
+
+    char status[32] = {};
+    bool read = std::fgets(status, sizeof(status), file) != nullptr;
+    std::fclose(file);
+
+    if (!read) return PowerSource::Unknown;
+
+    // "Charging", "Discharging", "Full" or "Not charging", the last two mean it's plugged in
+    return std::strncmp(status, "Discharging", 11) == 0 ? PowerSource::Battery : PowerSource::External;
+}
@@ -2,6 +2,7 @@
 
 #include <platform/arch/arm/armsimd.hpp>
 
-float util::simd::calcPcmVolume(const float* pcm, size_t samples) {
-    return globed::simd::arm::pcmVolume(pcm, samples);
+const util::simd::Kernels& util::simd::kernels() {
+    static const Kernels table = globed::simd::arm::resolveKernels();
+    return table;
 }
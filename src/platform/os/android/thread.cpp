@@ -0,0 +1,123 @@
+#include <util/thread.hpp>
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace util::thread;
+
+// nice values, matching the `THREAD_PRIORITY_*` constants of android.os.Process
+static int niceValue(Priority priority) {
+    switch (priority) {
+        case Priority::Background: return 10;   // THREAD_PRIORITY_BACKGROUND
+        case Priority::Normal: return 0;        // THREAD_PRIORITY_DEFAULT
+        case Priority::High: return -8;         // THREAD_PRIORITY_URGENT_DISPLAY
+        case Priority::TimeCritical: return -16; // THREAD_PRIORITY_AUDIO
+    }
+
+    return 0;
+}
+
+Result<> util::thread::setPriority(Priority priority) {
+    // on linux, `PRIO_PROCESS` with a thread id only changes that one thread
+    if (setpriority(PRIO_PROCESS, gettid(), niceValue(priority)) == -1) {
+        return Err(fmt::format("setpriority failed: {}", strerror(errno)));
+    }
+
+    return Ok();
+}
+
+struct CoreClusters {
+    cpu_set_t all;
+    cpu_set_t performance; // every core faster than the slowest cluster, so big and prime cores
+    cpu_set_t efficiency;
+    bool heterogeneous = false;
+};
+
+static uint64_t maxFrequency(int cpu) {
+    char path[96];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+
+    FILE* file = std::fopen(path, "r");
+    if (!file) return 0;
+
+    unsigned long long freq = 0;
+    if (std::fscanf(file, "%llu", &freq) != 1) freq = 0;
+    std::fclose(file);
+
+    return freq;
+}
+
+// clusters are told apart by their maximum frequency, which is what the kernel's own energy model ends up doing too
+static const CoreClusters& coreClusters() {
+    static const CoreClusters clusters = [] {
+        CoreClusters out;
+        CPU_ZERO(&out.all);
+        CPU_ZERO(&out.performance);
+        CPU_ZERO(&out.efficiency);
+
+        int count = std::min<int>(sysconf(_SC_NPROCESSORS_CONF), CPU_SETSIZE);
+
+        std::vector<uint64_t> freqs(count);
+        uint64_t slowest = UINT64_MAX, fastest = 0;
+
+        for (int i = 0; i < count; i++) {
+            freqs[i] = maxFrequency(i);
+            if (freqs[i] == 0) continue;
+
+            slowest = std::min(slowest, freqs[i]);
+            fastest = std::max(fastest, freqs[i]);
+        }
+
+        out.heterogeneous = fastest != 0 && slowest != fastest;
+
+        for (int i = 0; i < count; i++) {
+            CPU_SET(i, &out.all);
+            if (freqs[i] == 0) continue;
+
+            if (freqs[i] > slowest) {
+                CPU_SET(i, &out.performance);
+            } else {
+                CPU_SET(i, &out.efficiency);
+            }
+        }
+
+        return out;
+    }();
+
+    return clusters;
+}
+
+Result<> util::thread::setCoreHint(CoreHint hint) {
+    auto& clusters = coreClusters();
+    if (!clusters.heterogeneous) return Ok();
+
+    const cpu_set_t* set = &clusters.all;
+    switch (hint) {
+        case CoreHint::Any: break;
+        case CoreHint::Performance: set = &clusters.performance; break;
+        case CoreHint::Efficiency: set = &clusters.efficiency; break;
+    }
+
+    // pid 0 means the calling thread
+    if (sched_setaffinity(0, sizeof(cpu_set_t), set) == -1) {
+        return Err(fmt::format("sched_setaffinity failed: {}", strerror(errno)));
+    }
+
+    return Ok();
+}
+
+util::time::micros util::thread::cpuTime() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return util::time::micros(0);
+    }
+
+    return util::time::micros(static_cast<long long>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000);
+}
@@ -1,7 +1,14 @@
 #include <util/net.hpp>
+#include <defs/assert.hpp>
 
 #include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <netdb.h>
+#include <unistd.h>
+#include <algorithm>
 
 void util::net::initialize() {}
 void util::net::cleanup() {}
@@ -14,3 +21,138 @@ std::string util::net::lastErrorString(int code, bool gai) {
     if (gai) return fmt::format("[Unix gai error {}]: {}", code, gai_strerror(code));
     return fmt::format("[Unix error {}]: {}", code, strerror(code));
 }
+
+std::optional<uint32_t> util::net::receiveDropCount(socket_t socket) {
+    // there is no per-socket drop counter on darwin, only the system wide `udps_fullsock` stat
+    return std::nullopt;
+}
+
+/* SocketPoller (kqueue) */
+
+class util::net::SocketPoller::Impl {
+public:
+    int kq = -1;
+    socket_t registered[MAX_SOCKETS];
+    size_t registeredCount = 0;
+    bool valid = false;
+
+    bool matches(const socket_t* sockets, size_t count) {
+        return valid && count == registeredCount && std::equal(sockets, sockets + count, registered);
+    }
+
+    Result<> reregister(const socket_t* sockets, size_t count) {
+        struct kevent changes[MAX_SOCKETS];
+
+        // closed sockets remove themselves from the kqueue, so errors here are expected and harmless
+        for (size_t i = 0; i < registeredCount; i++) {
+            EV_SET(&changes[i], registered[i], EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+            kevent(kq, &changes[i], 1, nullptr, 0, nullptr);
+        }
+
+        registeredCount = 0;
+        valid = false;
+
+        for (size_t i = 0; i < count; i++) {
+            EV_SET(&changes[i], sockets[i], EVFILT_READ, EV_ADD, 0, 0, reinterpret_cast<void*>(i));
+        }
+
+        if (count > 0 && kevent(kq, changes, count, nullptr, 0, nullptr) == -1) {
+            return Err(util::net::lastErrorString());
+        }
+
+        std::copy(sockets, sockets + count, registered);
+        registeredCount = count;
+        valid = true;
+
+        return Ok();
+    }
+};
+
+util::net::SocketPoller::SocketPoller() : impl(new Impl()) {
+    impl->kq = kqueue();
+    GLOBED_REQUIRE(impl->kq != -1, "failed to create a kqueue");
+}
+
+util::net::SocketPoller::~SocketPoller() {
+    if (impl->kq != -1) {
+        ::close(impl->kq);
+    }
+
+    delete impl;
+}
+
+Result<uint32_t> util::net::SocketPoller::wait(const socket_t* sockets, size_t count, int timeoutMs) {
+    GLOBED_REQUIRE_SAFE(count <= MAX_SOCKETS, "too many sockets passed to SocketPoller::wait")
+
+    if (!impl->matches(sockets, count)) {
+        GLOBED_UNWRAP(impl->reregister(sockets, count));
+    }
+
+    timespec timeout = {
+        .tv_sec = timeoutMs / 1000,
+        .tv_nsec = (timeoutMs % 1000) * 1'000'000,
+    };
+
+    struct kevent events[MAX_SOCKETS];
+    int result = kevent(impl->kq, nullptr, 0, events, MAX_SOCKETS, timeoutMs < 0 ? nullptr : &timeout);
+
+    if (result == -1) {
+        // a signal interrupting the wait is the same as a timeout for us
+        if (errno == EINTR) return Ok(0);
+        return Err(util::net::lastErrorString());
+    }
+
+    uint32_t mask = 0;
+    for (int i = 0; i < result; i++) {
+        mask |= 1u << reinterpret_cast<uintptr_t>(events[i].udata);
+    }
+
+    return Ok(mask);
+}
+
+void util::net::SocketPoller::invalidate() {
+    impl->valid = false;
+}
+
+/* TrafficMarker (IP_TOS) */
+
+class util::net::TrafficMarker::Impl {
+public:
+    socket_t socket = -1;
+    TrafficClass current = TrafficClass::BestEffort;
+};
+
+util::net::TrafficMarker::TrafficMarker() : impl(new Impl()) {}
+
+util::net::TrafficMarker::~TrafficMarker() {
+    delete impl;
+}
+
+Result<> util::net::TrafficMarker::attach(socket_t socket, const sockaddr_in& destination) {
+    impl->socket = socket;
+    impl->current = TrafficClass::BestEffort;
+    return Ok();
+}
+
+void util::net::TrafficMarker::detach() {
+    impl->socket = -1;
+}
+
+bool util::net::TrafficMarker::attached() const {
+    return impl->socket != -1;
+}
+
+Result<> util::net::TrafficMarker::mark(TrafficClass cls) {
+    GLOBED_REQUIRE_SAFE(this->attached(), "attempting to mark traffic of a detached socket")
+
+    if (cls == impl->current) return Ok();
+
+    // DSCP is the upper 6 bits of the TOS byte, the lower 2 are ECN and are left to the OS
+    int tos = static_cast<int>(cls) << 2;
+    if (setsockopt(impl->socket, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) == -1) {
+        return Err(util::net::lastErrorString());
+    }
+
+    impl->current = cls;
+    return Ok();
+}
@@ -0,0 +1,8 @@
+#include <util/power.hpp>
+
+using namespace util::power;
+
+PowerSource util::power::currentSource() {
+    // the battery state is only exposed through UIDevice, which would need objective-c
+    return PowerSource::Unknown;
+}
@@ -0,0 +1,24 @@
+#include <util/power.hpp>
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <IOKit/ps/IOPowerSources.h>
+#include <IOKit/ps/IOPSKeys.h>
+
+using namespace util::power;
+
+PowerSource util::power::currentSource() {
+    CFTypeRef info = IOPSCopyPowerSourcesInfo();
+    if (!info) return PowerSource::Unknown;
+
+    CFStringRef type = IOPSGetProvidingPowerSourceType(info);
+
+    PowerSource source = PowerSource::Unknown;
+    if (type) {
+        source = CFStringCompare(type, CFSTR(kIOPSBatteryPowerValue), 0) == kCFCompareEqualTo
+            ? PowerSource::Battery
+            : PowerSource::External;
+    }
+
+    CFRelease(info);
+    return source;
+}
@@ -0,0 +1,43 @@
+#include <util/thread.hpp>
+
+#include <pthread.h>
+#include <pthread/qos.h>
+#include <cstring>
+#include <time.h>
+
+using namespace util::thread;
+
+static qos_class_t qosClass(Priority priority) {
+    switch (priority) {
+        // QOS_CLASS_BACKGROUND can starve a thread for seconds, too much for preloading
+        case Priority::Background: return QOS_CLASS_UTILITY;
+        case Priority::Normal: return QOS_CLASS_DEFAULT;
+        case Priority::High: return QOS_CLASS_USER_INITIATED;
+        case Priority::TimeCritical: return QOS_CLASS_USER_INTERACTIVE;
+    }
+
+    return QOS_CLASS_DEFAULT;
+}
+
+Result<> util::thread::setPriority(Priority priority) {
+    int result = pthread_set_qos_class_self_np(qosClass(priority), 0);
+    if (result != 0) {
+        return Err(fmt::format("pthread_set_qos_class_self_np failed: {}", strerror(result)));
+    }
+
+    return Ok();
+}
+
+Result<> util::thread::setCoreHint(CoreHint hint) {
+    // there is no affinity API, the scheduler places threads on P or E cores based on their QoS class
+    return Ok();
+}
+
+util::time::micros util::thread::cpuTime() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return util::time::micros(0);
+    }
+
+    return util::time::micros(static_cast<long long>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000);
+}
@@ -1,7 +1,9 @@
 #include <util/net.hpp>
 #include <util/format.hpp>
+#include <defs/assert.hpp>
 
 #include <WinSock2.h>
+#include <qos2.h>
 
 void util::net::initialize() {
     WSADATA wsaData;
@@ -35,4 +37,136 @@ std::string util::net::lastErrorString(int code, bool gai) {
     std::string formatted = fmt::format("[Win error {}]: {}", code, util::format::trim(s));
     LocalFree(s);
     return formatted;
-}
\ No newline at end of file
+}
+
+std::optional<uint32_t> util::net::receiveDropCount(socket_t socket) {
+    // winsock doesn't expose per-socket drops
+    return std::nullopt;
+}
+
+/* SocketPoller (WSAPoll) */
+
+// IOCP would need overlapped sockets all the way down, for two sockets WSAPoll does the job just as well.
+class util::net::SocketPoller::Impl {};
+
+util::net::SocketPoller::SocketPoller() : impl(new Impl()) {}
+
+util::net::SocketPoller::~SocketPoller() {
+    delete impl;
+}
+
+Result<uint32_t> util::net::SocketPoller::wait(const socket_t* sockets, size_t count, int timeoutMs) {
+    GLOBED_REQUIRE_SAFE(count <= MAX_SOCKETS, "too many sockets passed to SocketPoller::wait")
+
+    WSAPOLLFD fds[MAX_SOCKETS];
+    for (size_t i = 0; i < count; i++) {
+        fds[i].fd = static_cast<SOCKET>(sockets[i]);
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    int result = WSAPoll(fds, count, timeoutMs);
+
+    if (result == SOCKET_ERROR) {
+        return Err(util::net::lastErrorString());
+    }
+
+    uint32_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (fds[i].revents & POLLIN) {
+            mask |= 1u << i;
+        }
+    }
+
+    return Ok(mask);
+}
+
+void util::net::SocketPoller::invalidate() {}
+
+/* TrafficMarker (qWAVE) */
+
+// setting IP_TOS directly needs admin rights (and a registry tweak) on Windows, qWAVE flows are the supported way.
+// the flow is only created once something other than best effort is requested.
+class util::net::TrafficMarker::Impl {
+public:
+    HANDLE qos = nullptr;
+    QOS_FLOWID flowId = 0;
+    SOCKET socket = INVALID_SOCKET;
+    sockaddr_in destination = {};
+    TrafficClass current = TrafficClass::BestEffort;
+
+    static QOS_TRAFFIC_TYPE trafficType(TrafficClass cls) {
+        switch (cls) {
+            case TrafficClass::Voice: return QOSTrafficTypeVoice;
+            case TrafficClass::Interactive: return QOSTrafficTypeAudioVideo;
+            default: return QOSTrafficTypeBestEffort;
+        }
+    }
+};
+
+util::net::TrafficMarker::TrafficMarker() : impl(new Impl()) {}
+
+util::net::TrafficMarker::~TrafficMarker() {
+    this->detach();
+
+    if (impl->qos) {
+        QOSCloseHandle(impl->qos);
+    }
+
+    delete impl;
+}
+
+Result<> util::net::TrafficMarker::attach(socket_t socket, const sockaddr_in& destination) {
+    this->detach();
+
+    // created lazily, so that nothing qWAVE related happens unless the setting is enabled
+    if (!impl->qos) {
+        QOS_VERSION version = { 1, 0 };
+
+        if (!QOSCreateHandle(&version, &impl->qos)) {
+            impl->qos = nullptr;
+            return Err(fmt::format("qWAVE is not available: {}", util::net::lastErrorString(GetLastError())));
+        }
+    }
+
+    impl->socket = static_cast<SOCKET>(socket);
+    impl->destination = destination;
+    impl->current = TrafficClass::BestEffort;
+
+    return Ok();
+}
+
+void util::net::TrafficMarker::detach() {
+    if (impl->flowId != 0) {
+        QOSRemoveSocketFromFlow(impl->qos, 0, impl->flowId, 0);
+        impl->flowId = 0;
+    }
+
+    impl->socket = INVALID_SOCKET;
+}
+
+bool util::net::TrafficMarker::attached() const {
+    return impl->socket != INVALID_SOCKET;
+}
+
+Result<> util::net::TrafficMarker::mark(TrafficClass cls) {
+    GLOBED_REQUIRE_SAFE(this->attached(), "attempting to mark traffic of a detached socket")
+
+    if (cls == impl->current) return Ok();
+
+    QOS_TRAFFIC_TYPE type = Impl::trafficType(cls);
+
+    if (impl->flowId == 0) {
+        if (!QOSAddSocketToFlow(
+            impl->qos, impl->socket, reinterpret_cast<PSOCKADDR>(&impl->destination), type, QOS_NON_ADAPTIVE_FLOW, &impl->flowId
+        )) {
+            impl->flowId = 0;
+            return Err(util::net::lastErrorString(GetLastError()));
+        }
+    } else if (!QOSSetFlow(impl->qos, impl->flowId, QOSSetTrafficType, sizeof(type), &type, 0, nullptr)) {
+        return Err(util::net::lastErrorString(GetLastError()));
+    }
+
+    impl->current = cls;
+    return Ok();
+}
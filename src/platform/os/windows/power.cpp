@@ -0,0 +1,17 @@
+#include <util/power.hpp>
+
+#include <Windows.h>
+
+using namespace util::power;
+
+PowerSource util::power::currentSource() {
+    SYSTEM_POWER_STATUS status;
+    if (!GetSystemPowerStatus(&status)) return PowerSource::Unknown;
+
+    // desktops without a battery report ac power
+    switch (status.ACLineStatus) {
+        case 0: return PowerSource::Battery;
+        case 1: return PowerSource::External;
+        default: return PowerSource::Unknown;
+    }
+}
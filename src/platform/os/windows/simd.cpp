@@ -1,8 +1,8 @@
 #include <util/simd.hpp>
-#include <util/misc.hpp>
 
 #include <platform/arch/x86/x86simd.hpp>
 
-float util::simd::calcPcmVolume(const float *pcm, size_t samples) {
-    return globed::simd::x86::pcmVolume(pcm, samples);
+const util::simd::Kernels& util::simd::kernels() {
+    static const Kernels table = globed::simd::x86::resolveKernels();
+    return table;
 }
@@ -0,0 +1,67 @@
+#include <util/thread.hpp>
+
+#include <Windows.h>
+
+using namespace util::thread;
+
+static int threadPriority(Priority priority) {
+    switch (priority) {
+        case Priority::Background: return THREAD_PRIORITY_BELOW_NORMAL;
+        case Priority::Normal: return THREAD_PRIORITY_NORMAL;
+        case Priority::High: return THREAD_PRIORITY_ABOVE_NORMAL;
+        case Priority::TimeCritical: return THREAD_PRIORITY_TIME_CRITICAL;
+    }
+
+    return THREAD_PRIORITY_NORMAL;
+}
+
+Result<> util::thread::setPriority(Priority priority) {
+    if (!SetThreadPriority(GetCurrentThread(), threadPriority(priority))) {
+        return Err(fmt::format("SetThreadPriority failed: error {}", GetLastError()));
+    }
+
+    return Ok();
+}
+
+Result<> util::thread::setCoreHint(CoreHint hint) {
+    // EcoQoS: throttled threads are scheduled onto E cores of hybrid cpus, explicitly unthrottled ones onto P cores.
+    // leaving the control mask empty hands the decision back to the OS.
+    THREAD_POWER_THROTTLING_STATE state = {};
+    state.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+
+    switch (hint) {
+        case CoreHint::Any: break;
+        case CoreHint::Performance: {
+            state.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+            state.StateMask = 0;
+        } break;
+        case CoreHint::Efficiency: {
+            state.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+            state.StateMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        } break;
+    }
+
+    // not available before windows 10 1709, it's only a hint so that is fine
+    if (!SetThreadInformation(GetCurrentThread(), ThreadPowerThrottling, &state, sizeof(state))) {
+        auto error = GetLastError();
+        if (error == ERROR_INVALID_PARAMETER) return Ok();
+
+        return Err(fmt::format("SetThreadInformation failed: error {}", error));
+    }
+
+    return Ok();
+}
+
+util::time::micros util::thread::cpuTime() {
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return util::time::micros(0);
+    }
+
+    // both are in 100 nanosecond units
+    auto ticks = [](const FILETIME& ft) {
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+
+    return util::time::micros((ticks(kernel) + ticks(user)) / 10);
+}
@@ -31,63 +31,47 @@ void ErrorCheckNode::updateErrors(float) {
         return;
     }
 
-    std::vector<std::string> warnings, successes;
-
-    try {
-        warnings = ErrorQueues::get().getWarnings();
-        successes = ErrorQueues::get().getSuccesses();
-    } catch (const std::system_error& e) {
-        // sometimes, when exiting the game, macos will do weird stuff and throw an exception trying to lock a mutex.
-        // we want to prevent that.
-        log::warn("failed to pop the warnings: {}", e.what());
-        return;
-    }
+    auto& eq = ErrorQueues::get();
+    eq.poll();
 
-    for (auto& warn : warnings) {
-        Notification::create(warn, NotificationIcon::Warning, 2.0f)->show();
-    }
+    eq.take(ErrorQueues::Kind::Warning, [](const ErrorQueues::Message& warn) {
+        Notification::create(warn.format(), NotificationIcon::Warning, 2.0f)->show();
+    });
 
-    for (auto& success : successes) {
-        Notification::create(success, NotificationIcon::Success, 1.25f)->show();
-    }
+    eq.take(ErrorQueues::Kind::Success, [](const ErrorQueues::Message& success) {
+        Notification::create(success.format(), NotificationIcon::Success, 1.25f)->show();
+    });
 
-    // if we are in PlayLayer, don't show errors unless paused
+    // if we are in PlayLayer, don't show errors unless paused, they stay pending until then
 
     auto playlayer = GlobedGJBGL::get();
     if (playlayer && !playlayer->isPaused()) {
         return;
     }
 
-    try {
-        auto errors = ErrorQueues::get().getErrors();
-        auto notices = ErrorQueues::get().getNotices();
-
-        for (auto& error : errors) {
-            if (canShowFLAlert()) {
-                log::debug("showing error: {}", error);
-                auto alert = static_cast<HookedFLAlertLayer*>(FLAlertLayer::create("Globed error", error, "Ok"));
-                alert->setID("error-popup"_spr);
-                alert->blockClosingFor(BLOCK_CLOSING_FOR);
-                alert->show();
-            } else {
-                log::warn("cant show flalert, ignoring error: {}", error);
-            }
+    eq.take(ErrorQueues::Kind::Error, [](const ErrorQueues::Message& error) {
+        if (canShowFLAlert()) {
+            log::debug("showing error: {}", error.view());
+            auto alert = static_cast<HookedFLAlertLayer*>(FLAlertLayer::create("Globed error", error.format(), "Ok"));
+            alert->setID("error-popup"_spr);
+            alert->blockClosingFor(BLOCK_CLOSING_FOR);
+            alert->show();
+        } else {
+            log::warn("cant show flalert, ignoring error: {}", error.view());
         }
-
-        for (auto& notice : notices) {
-            if (canShowFLAlert()) {
-                log::debug("showing notice: {}", notice);
-                auto alert = static_cast<HookedFLAlertLayer*>(FLAlertLayer::create("Globed notice", notice, "Ok"));
-                alert->setID("notice-popup"_spr);
-                alert->blockClosingFor(BLOCK_CLOSING_FOR);
-                alert->show();
-            } else {
-                log::warn("cant show flalert, ignoring notice: {}", notice);
-            }
+    });
+
+    eq.take(ErrorQueues::Kind::Notice, [](const ErrorQueues::Message& notice) {
+        if (canShowFLAlert()) {
+            log::debug("showing notice: {}", notice.view());
+            auto alert = static_cast<HookedFLAlertLayer*>(FLAlertLayer::create("Globed notice", notice.format(), "Ok"));
+            alert->setID("notice-popup"_spr);
+            alert->blockClosingFor(BLOCK_CLOSING_FOR);
+            alert->show();
+        } else {
+            log::warn("cant show flalert, ignoring notice: {}", notice.view());
         }
-    } catch (const std::exception& e) {
-        log::warn("failed to pop the errors/notices: {}", e.what());
-    }
+    });
 }
 
 bool ErrorCheckNode::canShowFLAlert() {
@@ -18,22 +18,33 @@
 using namespace geode::prelude;
 
 PlayerAccountData getAccountData(int id) {
-    if (ProfileCacheManager::get().getData(id)) return ProfileCacheManager::get().getData(id).value();
+    if (auto* data = ProfileCacheManager::get().findData(id)) return *data;
     if (id == GJAccountManager::sharedState()->m_accountID) return ProfileCacheManager::get().getOwnAccountData();
     return PlayerAccountData::DEFAULT_DATA;
 }
 
-bool GlobedChatCell::init(const std::string& username, int accid, const std::string& messageText) {
-    if (!CCLayerColor::init())
-        return false;
+bool GlobedChatCell::init() {
+    if (!CCLayerColor::init()) return false;
 
-    user = username;
+    this->setContentSize(ccp(290, CELL_HEIGHT));
+    this->setAnchorPoint(ccp(0, 0));
+
+    return true;
+}
+
+void GlobedChatCell::setData(const ChatHistory::Message& message, int accid, std::string_view username) {
+    if (boundSeq == message.seq) return;
+
+    boundSeq = message.seq;
     accountId = accid;
 
-    auto GAM = GJAccountManager::sharedState();
+    this->removeAllChildren();
 
-    this->setContentSize(ccp(290, CELL_HEIGHT));
-    this->setAnchorPoint(ccp(0, 0));
+    // no profile yet, fall back to the name the sender had when the message arrived
+    PlayerAccountData data = getAccountData(accid);
+    if (data.accountId != accid) {
+        data.name = username.empty() ? std::string_view("N/A") : username;
+    }
 
     // background
     Build<CCScale9Sprite>::create("square02_001.png")
@@ -57,20 +68,18 @@ bool GlobedChatCell::init(const std::string& username, int accid, const std::str
         .parent(this)
         .collect();
 
-    Build<GlobedSimplePlayer>::create(getAccountData(accid).icons)
+    Build<GlobedSimplePlayer>::create(data.icons)
         .scale(0.475f)
         .id("playericon")
         .zOrder(-1)
         .parent(playerBundle);
 
-    auto* nameLabel = Build<CCLabelBMFont>::create(username.c_str(), "goldFont.fnt")
+    auto* nameLabel = Build<CCLabelBMFont>::create(data.name.c_str(), "goldFont.fnt")
         .scale(0.5f)
         .id("playername")
         .zOrder(2)
         .collect();
 
-    PlayerAccountData data = getAccountData(accid);
-
     CCSprite* badgeIcon = util::ui::createBadgeIfSpecial(data.specialUserData);
     if (badgeIcon) {
         util::ui::rescaleToMatch(badgeIcon, util::ui::BADGE_SIZE);
@@ -93,7 +102,7 @@ bool GlobedChatCell::init(const std::string& username, int accid, const std::str
     // this also *must* be called after updateLayout().
     usernameButton->setZOrder(10);
 
-    auto messageTextLabel = CCLabelBMFont::create(messageText.c_str(), "chatFont.fnt");
+    auto messageTextLabel = CCLabelBMFont::create(message.text.c_str(), "chatFont.fnt");
 
     messageTextLabel->setPosition(4, 17);
     messageTextLabel->limitLabelWidth(260.0f, 0.8f, 0.0f);
@@ -105,17 +114,15 @@ bool GlobedChatCell::init(const std::string& username, int accid, const std::str
     messageTextLabel->setColor(textColor);
 
     this->addChild(messageTextLabel);
-
-    return true;
 }
 
 void GlobedChatCell::onUser(CCObject* sender) {
     ProfilePage::create(accountId, GJAccountManager::sharedState()->m_accountID == accountId)->show();
 }
 
-GlobedChatCell* GlobedChatCell::create(const std::string& username, int aid, const std::string& messageText) {
+GlobedChatCell* GlobedChatCell::create() {
     auto* ret = new GlobedChatCell;
-    if (ret->init(username, aid, messageText)) {
+    if (ret->init()) {
         ret->autorelease();
         return ret;
     }
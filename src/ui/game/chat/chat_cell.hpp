@@ -2,16 +2,23 @@
 #include <defs/all.hpp>
 
 #include <data/types/gd.hpp>
-#include <game/player_store.hpp>
+#include <game/chat_history.hpp>
 
 class GlobedChatCell : public cocos2d::CCLayerColor {
 public:
     static constexpr float CELL_HEIGHT = 44.f;
 
-    std::string user;
-    int accountId;
+    int accountId = 0;
+
+    // Fills the cell in for this message. Cells are reused by the list as it scrolls, so this rebuilds everything unless it's the same message.
+    // `username` is used when the profile of the sender is not known.
+    void setData(const ChatHistory::Message& message, int accid, std::string_view username);
 
     void onUser(cocos2d::CCObject* sender);
-    bool init(const std::string& username, int accid, const std::string& messageText);
-    static GlobedChatCell* create(const std::string& username, int aid, const std::string& messageText);
-};
\ No newline at end of file
+    static GlobedChatCell* create();
+
+private:
+    uint64_t boundSeq = -1;
+
+    bool init() override;
+};
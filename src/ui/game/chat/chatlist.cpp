@@ -19,10 +19,6 @@ bool GlobedChatListPopup::setup() {
 
     auto winSize = CCDirector::sharedDirector()->getWinSize();
 
-    scroll = ScrollLayer::create(ccp(300, 150));
-    scroll->setAnchorPoint(ccp(0, 0));
-    scroll->ignoreAnchorPointForPosition(false);
-
     menu = CCMenu::create();
 
     menu->setPosition({this->m_title->getPositionX(),25});
@@ -50,21 +46,23 @@ bool GlobedChatListPopup::setup() {
     menu->setTouchPriority(-510);
 
     background = CCScale9Sprite::create("square02_small.png");
-    background->setContentSize(scroll->getContentSize());
+    background->setContentSize({LIST_WIDTH, LIST_HEIGHT});
     background->setOpacity(75);
     background->setPosition(winSize / 2);
     this->addChild(background);
-    background->addChild(scroll);
-
-    scroll->m_contentLayer->removeAllChildren();
 
-    this->setTouchEnabled(true);
-    CCTouchDispatcher::get()->addTargetedDelegate(this, -129, true);
-    CCTouchDispatcher::get()->addTargetedDelegate(scroll, -130, true);
+    list = Build<VirtualList>::create(
+        CCSize{LIST_WIDTH, LIST_HEIGHT},
+        GlobedChatCell::CELL_HEIGHT + 3.f,
+        [] { return GlobedChatCell::create(); },
+        [this](CCNode* cell, size_t index) { this->bindCell(static_cast<GlobedChatCell*>(cell), index); }
+    )
+        .parent(background)
+        .collect();
 
-    for (auto message : GlobedGJBGL::get()->m_fields->chatMessages) {
-        this->createMessage(message.first, message.second);
-    }
+    // newest messages are at the bottom
+    this->updateChat(0.f);
+    list->scrollToBottom();
 
     this->schedule(schedule_selector(GlobedChatListPopup::updateChat));
 
@@ -90,8 +88,8 @@ void GlobedChatListPopup::onChat(CCObject* sender) {
 
         auto GAM = GJAccountManager::sharedState();
 
-        GlobedGJBGL::get()->m_fields->chatMessages.push_back({GAM->m_accountID, inp->getString()});
-        createMessage(GAM->m_accountID, inp->getString());
+        // shows up in the list on the next update
+        GlobedGJBGL::get()->m_fields->chatHistory.push(GAM->m_accountID, inp->getString());
 
         //GlobedGJBGL::get()->m_fields->chatOverlay->addMessage(GAM->m_accountID, inp->getString());
 
@@ -99,43 +97,31 @@ void GlobedChatListPopup::onChat(CCObject* sender) {
     }
 }
 
-void GlobedChatListPopup::createMessage(int accountID, const std::string& message) {
-    auto& pcm = ProfileCacheManager::get();
-    auto& playerStore = GlobedGJBGL::get()->m_fields->playerStore->getAll();
-
-    std::string username = "N/A";
+void GlobedChatListPopup::updateChat(float dt) {
+    auto& history = GlobedGJBGL::get()->m_fields->chatHistory;
+    if (history.totalPushed() == seenMessages) return;
 
-    PlayerAccountData yeah = PlayerAccountData::DEFAULT_DATA;
-    // if account ID is ours, then display our username
-    if (accountID == GJAccountManager::sharedState()->m_accountID) username = GJAccountManager::sharedState()->m_username;
-    // if account ID is in the player cache, get the username from there
-    if (pcm.getData(accountID)) username = pcm.getData(accountID).value().name;
+    seenMessages = history.totalPushed();
 
-    auto cell = GlobedChatCell::create(username, accountID, message);
-    cell->setPositionY(5.f);
-    cell->setPositionX(5.f);
-    scroll->m_contentLayer->addChild(cell);
-    scroll->m_contentLayer->setAnchorPoint(ccp(0, 1));
+    // follow new messages only if the user hasn't scrolled up to read older ones.
+    // once the history is full the size stays the same but every index shifts, cells showing the same message as before are left as is
+    bool follow = list->isScrolledToBottom();
+    list->setCount(history.size());
 
-    // move all of them up to accomodate for a new message
-    for (GlobedChatCell* gucci : messageCells) {
-        gucci->setPositionY(gucci->getPositionY() + GlobedChatCell::CELL_HEIGHT + 3.f);
+    if (follow) {
+        list->scrollToBottom();
     }
-    messageCells.push_back(cell);
+}
 
-    auto cells = scroll->m_contentLayer->getChildrenCount();
-    float height = std::max<float>(scroll->getContentSize().height, GlobedChatCell::CELL_HEIGHT * cells + (3.f * (cells + 1)) + 3.f);
-    scroll->m_contentLayer->setContentSize(ccp(scroll->m_contentLayer->getContentSize().width, height));
+void GlobedChatListPopup::bindCell(GlobedChatCell* cell, size_t index) {
+    auto& history = GlobedGJBGL::get()->m_fields->chatHistory;
+    if (index >= history.size()) return;
 
-    //scroll->moveToBottom();
-}
+    auto& message = history.at(index);
+    auto& sender = history.senderOf(message);
 
-void GlobedChatListPopup::updateChat(float dt) {
-    // if we have more messages stored then the amount we have displaying, display the rest of them
-    auto& messages = GlobedGJBGL::get()->m_fields->chatMessages;
-    if (messages.size() > messageCells.size()) {
-        this->createMessage(messages.back().first, messages.back().second);
-    }
+    cell->setData(message, sender.accountId, sender.name.view());
+    cell->setPosition(5.f, 3.f);
 }
 
 GlobedChatListPopup* GlobedChatListPopup::create() {
@@ -1,35 +1,38 @@
 #pragma once
 #include <defs/all.hpp>
 #include <Geode/ui/TextInput.hpp>
+
+#include <ui/general/virtual_list.hpp>
 #include "chat_cell.hpp"
 
+// Only creates cells for the messages that are visible, new messages are picked up from `ChatHistory` every frame
 class GlobedChatListPopup : public geode::Popup<> {
 protected:
     static constexpr float POPUP_WIDTH = 342.f;
     static constexpr float POPUP_HEIGHT = 240.f;
+    static constexpr float LIST_WIDTH = 300.f;
+    static constexpr float LIST_HEIGHT = 150.f;
 
 	bool setup() override;
 
     CCMenuItemSpriteExtra* reviewButton;
     cocos2d::extension::CCScale9Sprite* background;
-    geode::ScrollLayer* scroll = nullptr;
-    cocos2d::CCLayer* layer2;
+    VirtualList* list = nullptr;
     geode::TextInput* inp;
     cocos2d::CCMenu* menu;
-    std::vector<GlobedChatCell*> messageCells;
 
-    float nextY = 0.f;
-    int messages = 0;
+    // `ChatHistory::totalPushed` as of the last update
+    uint64_t seenMessages = 0;
 
     void onChat(cocos2d::CCObject* sender);
     void onClose(cocos2d::CCObject* sender) override;
 
     void updateChat(float dt);
+    void bindCell(GlobedChatCell* cell, size_t index);
 
     virtual void keyBackClicked() override;
     virtual void keyDown(cocos2d::enumKeyCodes) override;
 
 public:
 	static GlobedChatListPopup* create();
-    void createMessage(int accountID, const std::string& message);
 };
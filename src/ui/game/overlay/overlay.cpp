@@ -1,9 +1,20 @@
 #include "overlay.hpp"
 
+#include <audio/voice_playback_manager.hpp>
 #include <managers/settings.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/memory.hpp>
+#include <util/profiler.hpp>
+#include <util/trace.hpp>
 
 using namespace geode::prelude;
 
+static constexpr auto DETAILED_STATS_INTERVAL = util::time::seconds(1);
+// the overlay has to stay readable with a full level, the rest is summarized in one line
+static constexpr size_t DETAILED_MAX_PLAYERS = 5;
+static constexpr size_t DETAILED_MAX_PACKET_TYPES = 5;
+
 bool GlobedOverlay::init() {
     if (!CCNode::init()) return false;
 
@@ -45,6 +56,35 @@ bool GlobedOverlay::init() {
         .parent(this)
         .id("ping-label"_spr);
 
+    if (settings.networkStats) {
+        Build<CCLabelBMFont>::create("", "bigFont.fnt")
+            .opacity(static_cast<uint8_t>(settings.opacity * 255))
+            .scale(0.6f)
+            .store(statsLabel)
+            .parent(this)
+            .id("network-stats-label"_spr);
+    }
+
+    if (settings.detailedStats) {
+        Build<CCLabelBMFont>::create("", "chatFont.fnt")
+            .opacity(static_cast<uint8_t>(settings.opacity * 255))
+            .scale(0.5f)
+            .store(detailedLabel)
+            .parent(this)
+            .id("detailed-stats-label"_spr);
+    }
+
+#ifdef GLOBED_PROFILER
+    if (Loader::get()->getLaunchFlag("globed-profiler")) {
+        Build<CCLabelBMFont>::create("", "chatFont.fnt")
+            .opacity(static_cast<uint8_t>(settings.opacity * 255))
+            .scale(0.5f)
+            .store(profilerLabel)
+            .parent(this)
+            .id("profiler-label"_spr);
+    }
+#endif
+
 #ifdef GLOBED_DEBUG
     std::string versionStr = Mod::get()->getVersion().toVString();
     Build<CCLabelBMFont>::create(versionStr.c_str(), "bigFont.fnt")
@@ -70,6 +110,143 @@ void GlobedOverlay::updatePing(uint32_t ms) {
     this->updateLayout();
 }
 
+void GlobedOverlay::updateNetworkStats(const NetworkManager::ConnectionStats& stats) {
+    if (!statsLabel) return;
+
+    auto fmted = fmt::format(
+        "{:.1f}% loss, {:.1f} ms jitter, {} reordered | in {:.1f} KB/s, out {:.1f} KB/s",
+        stats.lossRate * 100.f, stats.jitterMs, stats.outOfOrder,
+        stats.bytesInPerSec / 1024.f, stats.bytesOutPerSec / 1024.f
+    );
+
+    if (stats.socketDrops > 0) {
+        fmted += fmt::format(" | {} dropped", stats.socketDrops);
+    }
+
+    statsLabel->setString(fmted.c_str());
+    statsLabel->setVisible(true);
+    this->updateLayout();
+}
+
+bool GlobedOverlay::wantsDetailedStats() {
+    return detailedLabel && util::time::now() - lastDetailedUpdate >= DETAILED_STATS_INTERVAL;
+}
+
+void GlobedOverlay::updateDetailedStats(const NetworkManager::ConnectionStats& stats, PlayerInterpolator& interpolator, const PlayerSlots& slots) {
+    if (!detailedLabel) return;
+
+    lastDetailedUpdate = util::time::now();
+
+    std::string text = fmt::format(
+        "packets: in {:.1f}/s, out {:.1f}/s | {:.1f}% loss, {:.1f} ms jitter\n",
+        stats.packetsInPerSec, stats.packetsOutPerSec, stats.lossRate * 100.f, stats.jitterMs
+    );
+
+    text += fmt::format(
+        "connect: dns {:.0f} ms, tcp {:.0f} ms, handshake {:.0f} ms, login {:.0f} ms\n",
+        stats.dnsMs, stats.tcpMs, stats.handshakeMs, stats.loginMs
+    );
+
+    auto summary = util::debug::PacketLogger::get().getSummary();
+    for (size_t i = 0; i < std::min(summary.types.size(), DETAILED_MAX_PACKET_TYPES); i++) {
+        auto& type = summary.types[i];
+        if (type.packetsPerSec == 0.f) break;
+
+        text += fmt::format(
+            "packet {}: {:.1f}/s, {:.1f} KB/s\n",
+            type.id, type.packetsPerSec, type.bytesPerSec / 1024.f
+        );
+    }
+
+    // players with the fewest buffered frames are the ones that will stutter first
+    std::vector<std::pair<int, PlayerInterpolator::BufferStats>> buffers;
+    buffers.reserve(slots.size());
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        buffers.emplace_back(slots.idAt(slot), interpolator.getBufferStatsAt(slot));
+    }
+
+    std::sort(buffers.begin(), buffers.end(), [](const auto& a, const auto& b) {
+        return a.second.depth < b.second.depth;
+    });
+
+    for (size_t i = 0; i < std::min(buffers.size(), DETAILED_MAX_PLAYERS); i++) {
+        auto& [playerId, buf] = buffers[i];
+        text += fmt::format(
+            "player {}: {} frames buffered, {:.0f} ms delay, {:.1f} ms jitter, {:+.1f}% clock\n",
+            playerId, buf.depth, buf.playoutDelay * 1000.f, buf.jitter * 1000.f, (buf.rate - 1.f) * 100.f
+        );
+    }
+
+    if (buffers.size() > DETAILED_MAX_PLAYERS) {
+        text += fmt::format("({} more players)\n", buffers.size() - DETAILED_MAX_PLAYERS);
+    }
+
+#ifdef GLOBED_VOICE_SUPPORT
+    size_t voiceStreams = 0, starving = 0;
+    uint32_t underruns = 0;
+    VoicePlaybackManager::get().forEachStream([&](int, AudioStream& stream) {
+        voiceStreams++;
+        if (stream.starving) starving++;
+        underruns += stream.underruns.load();
+    });
+
+    text += fmt::format("voice: {} streams, {} silent, {} underruns\n", voiceStreams, starving, underruns);
+#endif // GLOBED_VOICE_SUPPORT
+
+    auto mainThread = util::debug::MainThreadTimer::get().takeStats();
+    text += fmt::format(
+        "main thread: {} per frame, {} over budget, {} deferred\n",
+        util::format::formatDuration(mainThread.averagePerFrame), mainThread.overruns, mainThread.deferred
+    );
+
+    auto memory = util::memory::MemoryTracker::get().snapshot();
+    text += fmt::format("memory: {}", util::format::formatBytes(std::max<int64_t>(memory.total, 0)));
+    for (size_t i = 0; i < util::memory::TAG_COUNT; i++) {
+        text += fmt::format(
+            "{} {} {}",
+            i == 0 ? " |" : ",",
+            util::memory::tagName(static_cast<util::memory::MemoryTag>(i)),
+            util::format::formatBytes(std::max<int64_t>(memory.bytes[i], 0))
+        );
+    }
+
+    detailedLabel->setString(text.c_str());
+    this->updateLayout();
+}
+
+void GlobedOverlay::updateProfiler() {
+#ifdef GLOBED_PROFILER
+    if (!profilerLabel) return;
+
+    auto& profiler = util::profiler::Profiler::get();
+    // goes through the recorder so that the drained events still end up in traces
+    util::profiler::TraceRecorder::get().collect();
+
+    constexpr size_t MAX_ZONES = 10;
+
+    std::string text;
+    auto stats = profiler.stats();
+    for (size_t i = 0; i < std::min(stats.size(), MAX_ZONES); i++) {
+        auto& zone = stats[i];
+        text += fmt::format(
+            "{}: p50 {}, p99 {}, max {} ({}x)\n",
+            zone.name,
+            util::format::formatDuration(zone.p50),
+            util::format::formatDuration(zone.p99),
+            util::format::formatDuration(zone.max),
+            zone.count
+        );
+    }
+
+    if (auto dropped = profiler.droppedEvents()) {
+        text += fmt::format("{} events dropped", dropped);
+    }
+
+    profilerLabel->setString(text.c_str());
+    this->updateLayout();
+#endif
+}
+
 void GlobedOverlay::updateWithDisconnected() {
     auto& settings = GlobedSettings::get();
     if (!settings.overlay.enabled) return;
@@ -80,6 +257,7 @@ void GlobedOverlay::updateWithDisconnected() {
     }
 
     pingLabel->setString("Not connected");
+    if (statsLabel) statsLabel->setVisible(false);
     this->updateLayout();
 }
 
@@ -93,6 +271,7 @@ void GlobedOverlay::updateWithEditor() {
     }
 
     pingLabel->setString("N/A (Local level)");
+    if (statsLabel) statsLabel->setVisible(false);
     this->updateLayout();
 }
 
@@ -1,11 +1,21 @@
 #pragma once
 #include <defs/all.hpp>
 
+#include <game/interpolator.hpp>
+#include <net/manager.hpp>
+#include <util/time.hpp>
+
 class GlobedOverlay : public cocos2d::CCNode {
 public:
     bool init();
 
     void updatePing(uint32_t ms);
+    void updateNetworkStats(const NetworkManager::ConnectionStats& stats);
+    // whether the detailed stats are enabled and due for an update, they refresh less often than the rest
+    bool wantsDetailedStats();
+    void updateDetailedStats(const NetworkManager::ConnectionStats& stats, PlayerInterpolator& interpolator, const PlayerSlots& slots);
+    // slowest profiler zones, only does anything with the `globed-profiler` launch flag in a `GLOBED_PROFILER` build
+    void updateProfiler();
     void updateWithDisconnected();
     void updateWithEditor();
 
@@ -14,5 +24,10 @@ public:
 private:
     cocos2d::CCLabelBMFont
         *pingLabel = nullptr,
-        *versionLabel = nullptr;
+        *statsLabel = nullptr,
+        *versionLabel = nullptr,
+        *profilerLabel = nullptr,
+        *detailedLabel = nullptr;
+
+    util::time::time_point lastDetailedUpdate;
 };
@@ -1,10 +1,11 @@
 #include "complex_visual_player.hpp"
 
 #include "remote_player.hpp"
+#include <hooks/gjbasegamelayer.hpp>
 #include <hooks/game_manager.hpp>
+#include <managers/icon_loader.hpp>
 #include <managers/settings.hpp>
 #include <util/misc.hpp>
-#include <util/rng.hpp>
 #include <util/math.hpp>
 #include <util/debug.hpp>
 #include <util/ui.hpp>
@@ -47,15 +48,22 @@ bool ComplexVisualPlayer::init(RemotePlayer* parent, bool isSecond) {
 
     playerIcon->setRemotePlayer(this);
     // this->enableTrail();
+    this->disableTrail();
 
     // // restore the old streak
     // hgm->setPlayerStreak(oldStreak);
     // hgm->setPlayerShipStreak(oldShipStreak);
 
-    Build<GlobedNameLabel>::create(data.name)
-        .visible(settings.players.showNames && (!isSecond || settings.players.dualName))
-        .pos(0.f, 25.f)
+    showName = settings.players.showNames && (!isSecond || settings.players.dualName);
+
+    labelAnchor = Build<CCNode>::create()
         .parent(this)
+        .collect();
+
+    Build<GlobedNameLabel>::create(data.name.str())
+        .visible(showName)
+        .pos(0.f, 25.f)
+        .parent(labelAnchor)
         .store(nameLabel);
 
     this->updateIcons(data.icons);
@@ -64,8 +72,8 @@ bool ComplexVisualPlayer::init(RemotePlayer* parent, bool isSecond) {
         statusIcons = Build<PlayerStatusIcons>::create(playerOpacity)
             .scale(0.8f)
             .anchorPoint(0.5f, 0.f)
-            .pos(0.f, settings.players.showNames ? 40.f : 25.f)
-            .parent(this)
+            .pos(0.f, showName ? 40.f : 25.f)
+            .parent(labelAnchor)
             .id("status-icons"_spr)
             .collect();
     }
@@ -77,13 +85,13 @@ bool ComplexVisualPlayer::init(RemotePlayer* parent, bool isSecond) {
 }
 
 void ComplexVisualPlayer::updateIcons(const PlayerIconData& icons) {
-    auto* gm = GameManager::get();
     auto& settings = GlobedSettings::get();
 
     // update the name and the badge
     const auto& accountData = parent->getAccountData();
-    nameLabel->updateData(accountData.name, accountData.specialUserData);
+    nameLabel->updateData(accountData.name.str(), accountData.specialUserData);
     nameLabel->updateOpacity(settings.players.nameOpacity);
+    this->updateBatchedName(accountData);
 
     playerIcon->togglePlatformerMode(gameLayer->m_level->isPlatformer());
 
@@ -93,8 +101,10 @@ void ComplexVisualPlayer::updateIcons(const PlayerIconData& icons) {
         storedIcons.deathEffect = 1;
     }
 
-    // android is funny and quirky
-    if (static_cast<HookedGameManager*>(gm)->getAssetsPreloaded() GEODE_ANDROID(|| true)) {
+    // only load the gamemodes this level can use, see `GlobedGJBGL::getLevelIconTypes`
+    requestedIconTypes = static_cast<GlobedGJBGL*>(gameLayer)->getLevelIconTypes() | iconTypeBit(playerIconType);
+
+    if (this->hasIconsLoaded(requestedIconTypes)) {
         this->updatePlayerObjectIcons(true);
         this->updateIconType(playerIconType);
     } else {
@@ -127,7 +137,7 @@ void ComplexVisualPlayer::updateData(
         bool isSpeaking,
         float loudness
 ) {
-    auto& settings = GlobedSettings::get();
+    auto& settings = GlobedSettings::get().snapshot();
 
     wasRotating = data.isRotating;
 
@@ -135,6 +145,11 @@ void ComplexVisualPlayer::updateData(
     bool cameNearby = isNearby && !wasNearby;
     wasNearby = isNearby;
 
+    if (!isNearby) {
+        this->updateDataCulled(data);
+        return;
+    }
+
     auto displacement = data.position - playerIcon->getPosition();
 
     // TODO: super broken lol
@@ -160,9 +175,6 @@ void ComplexVisualPlayer::updateData(
     playerIcon->setPosition(data.position);
     playerIcon->setRotation(data.rotation);
 
-    float innerRot = data.isSideways ? (data.isUpsideDown ? 90.f : -90.f) : 0.f;
-    playerIcon->m_mainLayer->setRotation(innerRot);
-
     float distanceTo90deg = std::fmod(std::abs(data.rotation), 90.f);
     if (distanceTo90deg > 45.f) {
         distanceTo90deg = 90.f - distanceTo90deg;
@@ -172,11 +184,11 @@ void ComplexVisualPlayer::updateData(
         this->cancelPlatformerJumpAnim();
     }
 
-    // set the pos for status icons and name (ask rob not me)
-    nameLabel->setPosition(data.position + CCPoint{0.f, 25.f});
+    // the name and status icons follow the anchor, only the batched name lives elsewhere
+    labelAnchor->setPosition(data.position);
 
-    if (statusIcons) {
-        statusIcons->setPosition(data.position + CCPoint{0.f, nameLabel->isVisible() ? 40.f : 25.f});
+    if (batchedName) {
+        batchedName->setPosition(data.position + CCPoint{0.f, 25.f});
     }
 
     if (!playerData.isDead && playerIcon->getOpacity() == 0) {
@@ -191,17 +203,6 @@ void ComplexVisualPlayer::updateData(
 
     PlayerIconType iconType = data.iconType;
 
-    // setFlipX doesnt work here for jetpack and stuff
-    float mult = data.isMini ? 0.6f : 1.0f;
-    playerIcon->setScaleX((data.isLookingLeft ? -1.0f : 1.0f) * mult);
-
-    // swing is not flipped
-    if (iconType == PlayerIconType::Swing) {
-        playerIcon->setScaleY(mult);
-    } else {
-        playerIcon->setScaleY((data.isUpsideDown ? -1.0f : 1.0f) * mult);
-    }
-
     bool switchedMode = iconType != playerIconType;
 
     bool turningOffSwing = (playerIconType == PlayerIconType::Swing && switchedMode);
@@ -211,16 +212,42 @@ void ComplexVisualPlayer::updateData(
         this->updateIconType(iconType);
     }
 
-    if (switchedMode || (settings.players.hideNearby && isNearby)) {
+    // diff against the last applied state, a player that isn't doing anything only gets their position and rotation updated
+    uint16_t flags = packVisualFlags(data);
+    uint16_t changed = flags ^ visualFlags;
+
+    if (cameNearby || switchedMode || hasVisualFlag(FLAG_STALE)) {
+        changed |= FLAGS_REFRESH;
+    }
+
+    visualFlags = flags;
+
+    if (changed & (FLAG_MINI | FLAG_LOOKING_LEFT | FLAG_UPSIDE_DOWN | FLAG_SIDEWAYS)) {
+        float innerRot = data.isSideways ? (data.isUpsideDown ? 90.f : -90.f) : 0.f;
+        playerIcon->m_mainLayer->setRotation(innerRot);
+
+        // setFlipX doesnt work here for jetpack and stuff
+        float mult = data.isMini ? 0.6f : 1.0f;
+        playerIcon->setScaleX((data.isLookingLeft ? -1.0f : 1.0f) * mult);
+
+        // swing is not flipped
+        if (iconType == PlayerIconType::Swing) {
+            playerIcon->setScaleY(mult);
+        } else {
+            playerIcon->setScaleY((data.isUpsideDown ? -1.0f : 1.0f) * mult);
+        }
+    }
+
+    if (switchedMode || settings.hideNearby) {
         this->updateOpacity();
     }
 
-    if (statusIcons && isNearby) {
+    if (statusIcons) {
         statusIcons->updateStatus(playerData.isPaused, playerData.isPracticing, isSpeaking, playerData.isInEditor, loudness);
     }
 
     // animate dashing
-    if (data.isDashing != wasDashing) {
+    if (changed & FLAG_DASHING) {
         // TODO: fix dash
         // if (data.isDashing) {
         //     auto kf = ObjectToolbox::sharedState()->intKeyToFrame(0x6d7);
@@ -236,20 +263,12 @@ void ComplexVisualPlayer::updateData(
         //     playerIcon->stopDashing();
         //     playerIcon->setRotation(0.f);
         // }
-
-        wasDashing = data.isDashing;
     }
 
     // animate robot and spider
     if (iconType == PlayerIconType::Robot || iconType == PlayerIconType::Spider) {
-        if (wasGrounded != data.isGrounded || wasStationary != data.isStationary || wasFalling != data.isFalling || switchedMode || cameNearby) {
-            wasGrounded = data.isGrounded;
-            wasStationary = data.isStationary;
-            wasFalling = data.isFalling;
-
-            if (isNearby) {
-                iconType == PlayerIconType::Robot ? this->updateRobotAnimation() : this->updateSpiderAnimation();
-            }
+        if (changed & (FLAG_GROUNDED | FLAG_STATIONARY | FLAG_FALLING)) {
+            iconType == PlayerIconType::Robot ? this->updateRobotAnimation() : this->updateSpiderAnimation();
         }
     }
 
@@ -264,10 +283,9 @@ void ComplexVisualPlayer::updateData(
             playerIcon->m_swingFireMiddle->animateFireIn();
         }
 
-        if (cameNearby || ((wasUpsideDown != data.isUpsideDown || switchedMode) && isNearby)) {
-            wasUpsideDown = data.isUpsideDown;
+        if (changed & FLAG_UPSIDE_DOWN) {
             // now depending on the gravity, toggle either the bottom or top fire
-            this->animateSwingFire(!wasUpsideDown);
+            this->animateSwingFire(!data.isUpsideDown);
         }
     }
 
@@ -278,43 +296,34 @@ void ComplexVisualPlayer::updateData(
         playerIcon->m_swingFireMiddle->setVisible(false);
         playerIcon->m_swingFireBottom->setVisible(false);
 
-        if (isNearby) {
-            playerIcon->m_swingFireTop->animateFireOut();
-            playerIcon->m_swingFireMiddle->animateFireOut();
-            playerIcon->m_swingFireBottom->animateFireOut();
-        }
+        playerIcon->m_swingFireTop->animateFireOut();
+        playerIcon->m_swingFireMiddle->animateFireOut();
+        playerIcon->m_swingFireBottom->animateFireOut();
     }
 
     // remove robot fire
     else if (turningOffRobot) {
-        if (isNearby) {
-            this->animateRobotFire(false);
-        } else {
-            // just setVisible false
-            this->onAnimateRobotFireOut();
-        }
+        this->animateRobotFire(false);
     }
 
-    if (wasPaused != playerData.isPaused) {
-        wasPaused = playerData.isPaused;
-
-        if (wasPaused) {
-            CCNode::onExit();
-        } else {
-            CCNode::onEnter();
-        }
-    }
+    this->setAnimationsPaused(playerData.isPaused);
 
     bool shouldBeVisible;
     if (isSecond && !playerData.isDualMode) {
         shouldBeVisible = false;
-    } else if (settings.players.hidePracticePlayers && playerData.isPracticing) {
+    } else if (settings.hidePracticePlayers && playerData.isPracticing) {
         shouldBeVisible = false;
     } else {
-        shouldBeVisible = (data.isVisible || settings.players.forceVisibility) && !isForciblyHidden;
+        shouldBeVisible = (data.isVisible || settings.forceVisibility) && !isForciblyHidden;
     }
 
-    this->setVisible(shouldBeVisible);
+    if (this->isVisible() != shouldBeVisible) {
+        this->setVisible(shouldBeVisible);
+
+        if (batchedName) {
+            batchedName->setVisible(shouldBeVisible);
+        }
+    }
 
     if (!shouldBeVisible) {
         playerIcon->m_playEffects = false;
@@ -322,10 +331,91 @@ void ComplexVisualPlayer::updateData(
     }
 }
 
+uint16_t ComplexVisualPlayer::packVisualFlags(const SpecificIconData& data) {
+    uint16_t flags = 0;
+    if (data.isMini) flags |= FLAG_MINI;
+    if (data.isLookingLeft) flags |= FLAG_LOOKING_LEFT;
+    if (data.isUpsideDown) flags |= FLAG_UPSIDE_DOWN;
+    if (data.isSideways) flags |= FLAG_SIDEWAYS;
+    if (data.isDashing) flags |= FLAG_DASHING;
+    if (data.isGrounded) flags |= FLAG_GROUNDED;
+    if (data.isStationary) flags |= FLAG_STATIONARY;
+    if (data.isFalling) flags |= FLAG_FALLING;
+
+    return flags;
+}
+
+void ComplexVisualPlayer::updateDataCulled(const SpecificIconData& data) {
+    // only keep the position up to date, it's needed for the progress arrow and for noticing when the player comes back.
+    // icon type, animations, trails and labels are caught up by `updateData` once they are nearby again,
+    // and hiding the node means none of its children get visited in the meantime.
+    wasNearby = false;
+    this->setAnimationsPaused(true);
+    playerIcon->setPosition(data.position);
+
+    playerIcon->m_startPosition = data.position;
+    playerIcon->m_lastPosition = data.position;
+    playerIcon->m_realXPosition = data.position.x;
+    playerIcon->m_realYPosition = data.position.y;
+
+    this->setVisible(false);
+    playerIcon->m_playEffects = false;
+    if (playerIcon->m_regularTrail) playerIcon->m_regularTrail->setVisible(false);
+
+    if (batchedName) {
+        batchedName->setVisible(false);
+    }
+}
+
+void ComplexVisualPlayer::updateBatchedName(const PlayerAccountData& data) {
+    this->removeBatchedName();
+
+    auto* batch = static_cast<GlobedGJBGL*>(gameLayer)->m_fields->nameBatch;
+
+    // badges and special name colors need the regular label
+    if (!batch || !showName || data.specialUserData.roles) {
+        nameLabel->setVisible(showName);
+        return;
+    }
+
+    nameLabel->setVisible(false);
+
+    batchedName = batch->createLabel(data.name.str());
+    batchedName->setOpacity(static_cast<unsigned char>(GlobedSettings::get().snapshot().nameOpacity * 255.f));
+    batchedName->setPosition(playerIcon->getPosition() + CCPoint{0.f, 25.f});
+    batchedName->setVisible(this->isVisible());
+}
+
+void ComplexVisualPlayer::removeBatchedName() {
+    if (batchedName) {
+        batchedName->removeFromParent();
+        batchedName = nullptr;
+    }
+}
+
+void ComplexVisualPlayer::resetForReuse() {
+    IconLoadManager::get().cancel(this);
+
+    playerIcon->stopActionByTag(SPIDER_TELEPORT_COLOR_ACTION);
+    this->cancelPlatformerJumpAnim();
+
+    visualFlags = FLAG_STATIONARY | FLAG_STALE;
+    wasRotating = false;
+    wasNearby = false;
+    // the node got removed and added back, which already resumed everything
+    animationsPaused = false;
+    p1sticky = false;
+    p2sticky = false;
+    tpColorDelta = 0.f;
+}
+
 void ComplexVisualPlayer::updateIconType(PlayerIconType newType) {
     PlayerIconType oldType = playerIconType;
     playerIconType = newType;
 
+    // toggling the gamemode resets the scale and animations of the icon
+    visualFlags |= FLAG_STALE;
+
     const auto& accountData = parent->getAccountData();
     const auto& icons = accountData.icons;
 
@@ -335,7 +425,16 @@ void ComplexVisualPlayer::updateIconType(PlayerIconType newType) {
         this->callToggleWith(newType, true, false);
     }
 
-    this->callUpdateWith(newType, util::misc::getIconWithType(icons, newType));
+    // first time in a gamemode the level has no portal for, load it now.
+    // updating the frame before that would load the icon synchronously, `onFinishedLoadingIconAsync` does it instead
+    if (newType != PlayerIconType::Unknown && !(requestedIconTypes & iconTypeBit(newType))) {
+        requestedIconTypes |= iconTypeBit(newType);
+        this->tryLoadIconsAsync();
+    }
+
+    if (this->hasIconsLoaded(iconTypeBit(newType))) {
+        this->callUpdateWith(newType, util::misc::getIconWithType(icons, newType));
+    }
 }
 
 void ComplexVisualPlayer::playDeathEffect() {
@@ -474,19 +573,19 @@ void ComplexVisualPlayer::spiderTeleportUpdateColor() {
 }
 
 void ComplexVisualPlayer::updateRobotAnimation() {
-    if (wasGrounded && wasStationary) {
+    if (hasVisualFlag(FLAG_GROUNDED) && hasVisualFlag(FLAG_STATIONARY)) {
         // if on ground and not moving, play the idle animation
         playerIcon->m_robotSprite->tweenToAnimation("idle01", 0.1f);
         this->animateRobotFire(false);
-    } else if (wasGrounded && !wasStationary) {
+    } else if (hasVisualFlag(FLAG_GROUNDED) && !hasVisualFlag(FLAG_STATIONARY)) {
         // if on ground and moving, play the running animation
         playerIcon->m_robotSprite->tweenToAnimation("run", 0.1f);
         this->animateRobotFire(false);
-    } else if (wasFalling) {
+    } else if (hasVisualFlag(FLAG_FALLING)) {
         // if in the air and falling, play falling animation
         playerIcon->m_robotSprite->tweenToAnimation("fall_loop", 0.1f);
         this->animateRobotFire(false);
-    } else if (!wasFalling) {
+    } else if (!hasVisualFlag(FLAG_FALLING)) {
         // if in the air and not falling, play jumping animation
         playerIcon->m_robotSprite->tweenToAnimation("jump_loop", 0.1f);
         this->animateRobotFire(true);
@@ -496,13 +595,13 @@ void ComplexVisualPlayer::updateRobotAnimation() {
 void ComplexVisualPlayer::updateSpiderAnimation() {
     // this is practically the same as the robot animation
 
-    if (!wasGrounded && wasFalling) {
+    if (!hasVisualFlag(FLAG_GROUNDED) && hasVisualFlag(FLAG_FALLING)) {
         playerIcon->m_spiderSprite->tweenToAnimation("fall_loop", 0.1f);
-    } else if (!wasGrounded && !wasFalling) {
+    } else if (!hasVisualFlag(FLAG_GROUNDED) && !hasVisualFlag(FLAG_FALLING)) {
         playerIcon->m_spiderSprite->tweenToAnimation("jump_loop", 0.1f);
-    } else if (wasGrounded && wasStationary) {
+    } else if (hasVisualFlag(FLAG_GROUNDED) && hasVisualFlag(FLAG_STATIONARY)) {
         playerIcon->m_spiderSprite->tweenToAnimation("idle01", 0.1f);
-    } else if (wasGrounded && !wasStationary) {
+    } else if (hasVisualFlag(FLAG_GROUNDED) && !hasVisualFlag(FLAG_STATIONARY)) {
         playerIcon->m_spiderSprite->tweenToAnimation("run", 0.1f);
     }
 }
@@ -547,6 +646,18 @@ void ComplexVisualPlayer::animateSwingFire(bool goingDown) {
     }
 }
 
+void ComplexVisualPlayer::setAnimationsPaused(bool paused) {
+    if (animationsPaused == paused) return;
+    animationsPaused = paused;
+
+    // the whole tree, not just this node
+    if (paused) {
+        CCNode::onExit();
+    } else {
+        CCNode::onEnter();
+    }
+}
+
 void ComplexVisualPlayer::onAnimateRobotFireOut() {
     playerIcon->m_robotFire->setVisible(false);
 }
@@ -588,10 +699,10 @@ void ComplexVisualPlayer::updatePlayerObjectIcons(bool skipFrames) {
 }
 
 void ComplexVisualPlayer::updateOpacity() {
-    auto& settings = GlobedSettings::get();
+    auto& settings = GlobedSettings::get().snapshot();
 
     float mult = 1.f;
-    if (settings.players.hideNearby) {
+    if (settings.hideNearby) {
         // calculate distance
         auto p1pos = this->gameLayer->m_player1->getPosition();
         auto p2pos = this->gameLayer->m_player2->getPosition();
@@ -604,15 +715,19 @@ void ComplexVisualPlayer::updateOpacity() {
         mult = distance / 150.f;
     }
 
-    unsigned char opacity = static_cast<unsigned char>(settings.players.playerOpacity * mult * 255.f);
+    unsigned char opacity = static_cast<unsigned char>(settings.playerOpacity * mult * 255.f);
 
     playerIcon->setOpacity(opacity);
     playerIcon->m_spiderSprite->GJRobotSprite::setOpacity(opacity);
     playerIcon->m_robotSprite->GJRobotSprite::setOpacity(opacity);
 
     // set name opacity too if hideNearby is enabled
-    if (settings.players.hideNearby) {
-        nameLabel->updateOpacity(settings.players.nameOpacity * mult);
+    if (settings.hideNearby) {
+        nameLabel->updateOpacity(settings.nameOpacity * mult);
+
+        if (batchedName) {
+            batchedName->setOpacity(static_cast<unsigned char>(settings.nameOpacity * mult * 255.f));
+        }
     }
 }
 
@@ -683,75 +798,23 @@ bool ComplexVisualPlayer::getP2StickyState() {
     return p2sticky;
 }
 
-void ComplexVisualPlayer::tryLoadIconsAsync() {
-    if (iconsLoaded != 0) return;
-    auto* gm = GameManager::get();
-    auto* textureCache = CCTextureCache::sharedTextureCache();
-    auto* sfCache = CCSpriteFrameCache::sharedSpriteFrameCache();
-
-    for (auto type = PlayerIconType::Cube; type <= PlayerIconType::Jetpack; type = (PlayerIconType)((int)type + 1)) {
-        auto iconId = util::misc::getIconWithType(storedIcons, type);
-        std::string sheetName = gm->sheetNameForIcon(storedIcons.cube, (int)IconType::Cube);
-
-        if (!sheetName.empty()) {
-            int key = gm->keyForIcon(iconId, (int)util::misc::convertEnum<IconType>(type));
-            // essentially addIconDelegate
-            gm->m_iconDelegates[key].push_back(this);
-
-            if (!gm->m_isIconBeingLoaded[key]) {
-                gm->m_isIconBeingLoaded[key] = true;
-
-                auto uniqueId = util::rng::Random::get().generate<int>();
-                asyncLoadRequests[uniqueId] = AsyncLoadRequest {
-                    .key = key,
-                    .iconId = iconId,
-                    .iconType = type
-                };
-
-                textureCache->addImageAsync(
-                    (sheetName + ".png").c_str(),
-                    this,
-                    menu_selector(ComplexVisualPlayer::asyncIconLoadedIntermediary),
-                    uniqueId,
-                    kCCTexture2DPixelFormat_RGBA8888
-                );
-            }
-        }
-    }
-}
-
-void ComplexVisualPlayer::onFinishedLoadingIconAsync() {
-    iconsLoaded++;
-
-    if (iconsLoaded == (int)PlayerIconType::Jetpack) {
-        // if all icons loaded, we good
-        iconsLoaded = 0;
+bool ComplexVisualPlayer::hasIconsLoaded(PlayerIconTypeMask types) {
+    auto* hgm = static_cast<HookedGameManager*>(GameManager::get());
 
-        this->updatePlayerObjectIcons(true);
-        this->updateIconType(playerIconType);
-    }
+    // android is funny and quirky
+    return hgm->getAssetsPreloaded() || hgm->hasLoadedIcons(storedIcons, types) GEODE_ANDROID(|| true);
 }
 
-void ComplexVisualPlayer::asyncIconLoadedIntermediary(cocos2d::CCObject* obj) {
-    auto* texture = static_cast<CCTexture2D*>(obj);
-    int uniqueId = texture->getTag();
-    if (!asyncLoadRequests.contains(uniqueId)) {
-        log::warn("async load requests does not contain the tag: {}", uniqueId);
-        return;
-    }
-
-    auto request = asyncLoadRequests[uniqueId];
-    asyncLoadRequests.erase(uniqueId);
-
-    auto* gm = GameManager::get();
-    gm->loadIcon(request.iconId, (int)util::misc::convertEnum<IconType>(request.iconType), -1);
-    gm->m_isIconBeingLoaded[request.key] = 0;
-
-    for (const auto delegate : gm->m_iconDelegates[request.key]) {
-        static_cast<ComplexVisualPlayer*>(delegate)->onFinishedLoadingIconAsync();
+void ComplexVisualPlayer::tryLoadIconsAsync() {
+    // if everything is already loaded, there is nothing to wait for
+    if (!IconLoadManager::get().request(this, storedIcons, requestedIconTypes)) {
+        this->onFinishedLoadingIconAsync();
     }
+}
 
-    gm->m_iconDelegates.erase(request.key);
+void ComplexVisualPlayer::onFinishedLoadingIconAsync() {
+    this->updatePlayerObjectIcons(true);
+    this->updateIconType(playerIconType);
 }
 
 void ComplexVisualPlayer::cancelPlatformerJumpAnim() {
@@ -771,6 +834,19 @@ void ComplexVisualPlayer::disableTrail() {
     // playerIcon->deactivateStreak();
     // playerIcon->m_regularTrail->stopStroke();
     // playerIcon->fadeOutStreak2(0.2f);
+
+    // remote trails are never drawn, but the motion streaks made by `setupStreak` still rebuild their vertices
+    // every frame for each player. the nodes have to stay around since PlayerObject keeps using them
+    for (auto* streak : {playerIcon->m_regularTrail, playerIcon->m_shipStreak}) {
+        if (!streak) continue;
+
+        streak->unscheduleUpdate();
+        streak->setVisible(false);
+    }
+
+    if (playerIcon->m_waveTrail) {
+        playerIcon->m_waveTrail->setVisible(false);
+    }
 }
 
 bool ComplexVisualPlayer::isPlayerNearby(const GameCameraState& camState) {
@@ -810,4 +886,9 @@ ComplexVisualPlayer* ComplexVisualPlayer::create(RemotePlayer* parent, bool isSe
 
     delete ret;
     return nullptr;
-}
\ No newline at end of file
+}
+
+ComplexVisualPlayer::~ComplexVisualPlayer() {
+    IconLoadManager::get().cancel(this);
+    this->removeBatchedName();
+}
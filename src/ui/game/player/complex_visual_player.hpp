@@ -25,6 +25,13 @@ public:
         bool isSpeaking,
         float loudness
     );
+    // Cheap path for players that are far outside of the camera, or drawn by the crowd renderer. Only updates the position,
+    // the next `updateData` call catches up on everything else.
+    void updateDataCulled(const SpecificIconData& data);
+    // Drops the animation state and pending icon loads of the previous player, see `RemotePlayer::reuse`
+    void resetForReuse();
+    // Removes the name from the level's `NameLabelBatch`, if it's drawn by it. It gets added back by `updateIcons`.
+    void removeBatchedName();
     void updateIconType(PlayerIconType newType);
     void playDeathEffect();
     void playSpiderTeleport(const SpiderTeleportData& data);
@@ -46,47 +53,60 @@ public:
     void callUpdateWith(PlayerIconType type, int icon);
 
     static ComplexVisualPlayer* create(RemotePlayer* parent, bool isSecond);
+    ~ComplexVisualPlayer();
 
 protected:
     friend class ComplexPlayerObject;
     friend class RemotePlayer;
+    friend class IconLoadManager;
     RemotePlayer* parent;
 
     bool isSecond;
 
     GJBaseGameLayer* gameLayer;
     ComplexPlayerObject* playerIcon;
+    // moved along with `playerIcon` but never rotated or flipped, the name and the status icons sit on it
+    Ref<cocos2d::CCNode> labelAnchor;
     Ref<GlobedNameLabel> nameLabel;
+    Ref<cocos2d::CCSprite> batchedName; // used instead of `nameLabel` when the name is drawn by `NameLabelBatch`
+    bool showName = false;
     PlayerIconType playerIconType = PlayerIconType::Unknown;
     Ref<PlayerStatusIcons> statusIcons;
     bool isPlatformer;
     bool isEditor;
 
-    // these 3 used in robot and spider anims
-    bool wasGrounded = false;
-    bool wasStationary = true;
-    bool wasFalling = false;
-
     // used in spider anims
     cocos2d::ccColor3B storedMainColor, storedSecondaryColor;
     float tpColorDelta = 0.f;
 
-    // used in swing anims
-    bool wasUpsideDown = false;
+    // bits of `visualFlags`
+    static constexpr uint16_t FLAG_MINI = 1 << 0;
+    static constexpr uint16_t FLAG_LOOKING_LEFT = 1 << 1;
+    static constexpr uint16_t FLAG_UPSIDE_DOWN = 1 << 2;
+    static constexpr uint16_t FLAG_SIDEWAYS = 1 << 3;
+    static constexpr uint16_t FLAG_DASHING = 1 << 4;
+    static constexpr uint16_t FLAG_GROUNDED = 1 << 5;
+    static constexpr uint16_t FLAG_STATIONARY = 1 << 6;
+    static constexpr uint16_t FLAG_FALLING = 1 << 7;
+    // set when the icon was changed behind our back (e.g. by toggling the gamemode), forces a full refresh
+    static constexpr uint16_t FLAG_STALE = 1 << 15;
+
+    static constexpr uint16_t FLAGS_REFRESH = FLAG_MINI | FLAG_LOOKING_LEFT | FLAG_UPSIDE_DOWN | FLAG_SIDEWAYS
+        | FLAG_DASHING | FLAG_GROUNDED | FLAG_STATIONARY | FLAG_FALLING;
+
+    // the visual state that was last applied to the icon, `updateData` only calls into cocos for the bits that differ
+    uint16_t visualFlags = FLAG_STATIONARY | FLAG_STALE;
 
     // used in platformer squish anim
     bool wasRotating = false;
     bool didPerformPlatformerJump = false;
 
-    // used in dashing anim
-    bool wasDashing = false;
-
-    // used to call onEnter, onExit
-    bool wasPaused = false;
-
     // used for many anims
     bool wasNearby = false;
 
+    // see `setAnimationsPaused`
+    bool animationsPaused = false;
+
     // uhh yeah forcibly hiding players
     bool isForciblyHidden = false;
 
@@ -94,16 +114,8 @@ protected:
     bool p1sticky = false, p2sticky = false;
 
     PlayerIconData storedIcons;
-
-    // used for async icon loading
-    struct AsyncLoadRequest {
-        int key;
-        int iconId;
-        PlayerIconType iconType;
-    };
-
-    int iconsLoaded = 0;
-    std::unordered_map<int, AsyncLoadRequest> asyncLoadRequests;
+    // gamemodes whose icons were requested for `storedIcons`, the rest are only loaded once the player switches to them
+    PlayerIconTypeMask requestedIconTypes = 0;
 
     static constexpr int ROBOT_FIRE_ACTION = 1000727;
     static constexpr int SWING_FIRE_ACTION = 1000728;
@@ -119,16 +131,25 @@ protected:
     void onAnimateRobotFireOut();
 
     void animateSwingFire(bool goingDown);
+    // Pauses every action and scheduled selector in the player's node tree, which includes the robot and spider animations.
+    // Used for paused players, and for culled ones so that nobody steps animations that can't be seen.
+    void setAnimationsPaused(bool paused);
     void updateOpacity();
+    void updateBatchedName(const PlayerAccountData& data);
 
+    bool hasIconsLoaded(PlayerIconTypeMask types);
     void tryLoadIconsAsync();
+    // called by `IconLoadManager` once all the requested icons are loaded
     void onFinishedLoadingIconAsync();
-    // fucking hell i hate this
-    void asyncIconLoadedIntermediary(cocos2d::CCObject*);
 
     void cancelPlatformerJumpAnim();
     void enableTrail();
     void disableTrail();
 
     bool isPlayerNearby(const GameCameraState& camState);
+
+    static uint16_t packVisualFlags(const SpecificIconData& data);
+    bool hasVisualFlag(uint16_t flag) const {
+        return (visualFlags & flag) != 0;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "crowd_renderer.hpp"
+
+using namespace geode::prelude;
+
+bool CrowdRenderer::init() {
+    if (!CCNode::init()) return false;
+
+    auto* frame = CCSpriteFrameCache::get()->spriteFrameByName("crowd-icon.png"_spr);
+    if (!frame) return false;
+
+    batch = CCSpriteBatchNode::createWithTexture(frame->getTexture());
+    this->addChild(batch);
+
+    return true;
+}
+
+void CrowdRenderer::begin() {
+    used = 0;
+}
+
+void CrowdRenderer::drawPlayer(const CCPoint& position, const ccColor3B& color, unsigned char opacity) {
+    // sprites are reused between frames, new ones are only made when the crowd grows
+    if (used == sprites.size()) {
+        auto* sprite = CCSprite::createWithSpriteFrameName("crowd-icon.png"_spr);
+        batch->addChild(sprite);
+        sprites.push_back(sprite);
+    }
+
+    auto* sprite = sprites[used++];
+    sprite->setPosition(position);
+    sprite->setColor(color);
+    sprite->setOpacity(opacity);
+    sprite->setVisible(true);
+}
+
+void CrowdRenderer::end() {
+    for (size_t i = used; i < sprites.size(); i++) {
+        sprites[i]->setVisible(false);
+    }
+}
+
+CrowdRenderer* CrowdRenderer::create() {
+    auto ret = new CrowdRenderer;
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <defs/all.hpp>
+
+// Draws remote players as small tinted squares, all of them in a single batched draw call.
+// Used in crowd mode for players that aren't close enough to the camera to be worth a full `ComplexVisualPlayer`.
+class CrowdRenderer : public cocos2d::CCNode {
+public:
+    // Call at the start of every frame, before any `drawPlayer` calls
+    void begin();
+    void drawPlayer(const cocos2d::CCPoint& position, const cocos2d::ccColor3B& color, unsigned char opacity);
+    // Hides every sprite that wasn't used this frame
+    void end();
+
+    static CrowdRenderer* create();
+
+private:
+    cocos2d::CCSpriteBatchNode* batch = nullptr;
+    std::vector<cocos2d::CCSprite*> sprites;
+    size_t used = 0;
+
+    bool init() override;
+};
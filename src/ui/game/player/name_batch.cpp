@@ -0,0 +1,49 @@
+#include "name_batch.hpp"
+
+using namespace geode::prelude;
+
+bool NameLabelBatch::init() {
+    if (!CCNode::init()) return false;
+
+    layout = CCLabelBMFont::create("", "chatFont.fnt");
+    if (!layout) return false;
+
+    batch = CCSpriteBatchNode::createWithTexture(layout->getTexture());
+    this->addChild(batch);
+
+    return true;
+}
+
+CCSprite* NameLabelBatch::createLabel(const std::string& text) {
+    auto* texture = batch->getTexture();
+
+    auto* holder = CCSprite::createWithTexture(texture, CCRectZero);
+    holder->setCascadeOpacityEnabled(true);
+    holder->setCascadeColorEnabled(true);
+    batch->addChild(holder);
+
+    layout->setString(text.c_str());
+    auto offset = layout->getContentSize() / 2.f;
+
+    for (auto* glyph : CCArrayExt<CCSprite*>(layout->getChildren())) {
+        // glyphs left over from a longer string are hidden, not removed
+        if (!glyph->isVisible()) continue;
+
+        auto* sprite = CCSprite::createWithTexture(texture, glyph->getTextureRect(), glyph->isTextureRectRotated());
+        sprite->setPosition(glyph->getPosition() - offset);
+        holder->addChild(sprite);
+    }
+
+    return holder;
+}
+
+NameLabelBatch* NameLabelBatch::create() {
+    auto ret = new NameLabelBatch;
+    if (ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
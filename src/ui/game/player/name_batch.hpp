@@ -0,0 +1,20 @@
+#pragma once
+#include <defs/all.hpp>
+
+// Draws player names through a single sprite batch using the chat font texture, instead of one `CCLabelBMFont` per player.
+// A name is laid out into glyph sprites once when it's created, afterwards moving or hiding it is as cheap as for any other sprite.
+class NameLabelBatch : public cocos2d::CCNode {
+public:
+    // Creates a label centered on its position. The returned sprite holds one child per glyph, cascades opacity and color to them,
+    // and is owned by the batch until it gets removed from its parent.
+    cocos2d::CCSprite* createLabel(const std::string& text);
+
+    static NameLabelBatch* create();
+
+private:
+    cocos2d::CCSpriteBatchNode* batch = nullptr;
+    // never drawn, only used to lay out glyphs
+    Ref<cocos2d::CCLabelBMFont> layout;
+
+    bool init() override;
+};
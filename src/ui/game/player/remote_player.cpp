@@ -31,11 +31,13 @@ void RemotePlayer::updateAccountData(const PlayerAccountData& data, bool force)
     }
 
     this->accountData = data;
+    this->crowdColor = GameManager::get()->colorForIdx(data.icons.color1);
     player1->updateIcons(data.icons);
     player2->updateIcons(data.icons);
 
     if (progressIcon) {
         progressIcon->updateIcons(data.icons);
+        progressDirty = true;
     }
 
     if (progressArrow) {
@@ -45,6 +47,25 @@ void RemotePlayer::updateAccountData(const PlayerAccountData& data, bool force)
     defaultTicks = 0;
 }
 
+void RemotePlayer::reuse(PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow) {
+    this->progressIcon = progressIcon;
+    this->progressArrow = progressArrow;
+
+    defaultTicks = 0;
+    lastPercentage = 0.f;
+    wasPracticing = false;
+    isEditorBuilding = false;
+    wasHidden = false;
+    lastFrameFlags = {};
+    lastVisualState = {};
+    profileVersion = 0;
+    progressDirty = true;
+
+    player1->resetForReuse();
+    player2->resetForReuse();
+    this->setForciblyHidden(false);
+}
+
 const PlayerAccountData& RemotePlayer::getAccountData() const {
     return accountData;
 }
@@ -57,19 +78,16 @@ void RemotePlayer::updateData(
 ) {
     player1->updateData(data.player1, data, *gameCameraState, speaking, loudness);
     player2->updateData(data.player2, data, *gameCameraState, speaking, loudness);
+    wasHidden = false;
 
-    isEditorBuilding = data.isEditorBuilding;
-
-    lastPercentage = data.currentPercentage;
+    this->updateProgressState(data);
     lastFrameFlags = frameFlags;
     lastVisualState = data;
 
-    wasPracticing = data.isPracticing;
-
     // don't update any anims if hidden
     if (isForciblyHidden) return;
 
-    if (frameFlags.pendingDeath && GlobedSettings::get().players.deathEffects) {
+    if (frameFlags.pendingDeath && GlobedSettings::get().snapshot().deathEffects) {
         player1->playDeathEffect();
     }
 
@@ -90,8 +108,72 @@ void RemotePlayer::updateData(
     }
 }
 
+void RemotePlayer::updateCrowd(const VisualPlayerState& data, CrowdRenderer* crowd) {
+    player1->updateDataCulled(data.player1);
+    player2->updateDataCulled(data.player2);
+    wasHidden = false;
+
+    this->updateProgressState(data);
+    lastVisualState = data;
+
+    if (isForciblyHidden) return;
+
+    auto& settings = GlobedSettings::get().snapshot();
+    if (settings.hidePracticePlayers && data.isPracticing) return;
+
+    auto opacity = static_cast<unsigned char>(settings.playerOpacity * 255.f);
+
+    if (data.player1.isVisible || settings.forceVisibility) {
+        crowd->drawPlayer(data.player1.position, crowdColor, opacity);
+    }
+
+    if (data.isDualMode && (data.player2.isVisible || settings.forceVisibility)) {
+        crowd->drawPlayer(data.player2.position, crowdColor, opacity);
+    }
+}
+
+void RemotePlayer::updateBuilding(const VisualPlayerState& data) {
+    // nothing moves while building, so the icons only have to be hidden once
+    if (!isEditorBuilding) {
+        player1->updateDataCulled(data.player1);
+        player2->updateDataCulled(data.player2);
+    }
+
+    this->updateProgressState(data);
+    lastVisualState = data;
+}
+
+void RemotePlayer::updateHidden(const VisualPlayerState& data) {
+    // same as with builders, the icons stay hidden until `updateData` catches them up again
+    if (!wasHidden) {
+        player1->updateDataCulled(data.player1);
+        player2->updateDataCulled(data.player2);
+        wasHidden = true;
+    }
+
+    this->updateProgressState(data);
+    lastVisualState = data;
+}
+
+bool RemotePlayer::isHidden() const {
+    return wasHidden;
+}
+
+void RemotePlayer::updateProgressState(const VisualPlayerState& data) {
+    if (data.currentPercentage != lastPercentage || data.isPracticing != wasPracticing || data.isEditorBuilding != isEditorBuilding) {
+        progressDirty = true;
+    }
+
+    isEditorBuilding = data.isEditorBuilding;
+    lastPercentage = data.currentPercentage;
+    wasPracticing = data.isPracticing;
+}
+
 void RemotePlayer::updateProgressIcon() {
     if (progressIcon) {
+        if (!progressDirty) return;
+        progressDirty = false;
+
         progressIcon->updatePosition(lastPercentage, wasPracticing);
 
         if (isForciblyHidden || isEditorBuilding) {
@@ -128,6 +210,7 @@ bool RemotePlayer::isValidPlayer() {
 
 void RemotePlayer::setForciblyHidden(bool state) {
     isForciblyHidden = state;
+    progressDirty = true;
     player1->setForciblyHidden(state);
     player2->setForciblyHidden(state);
 
@@ -144,6 +227,11 @@ bool RemotePlayer::getForciblyHidden() {
     return isForciblyHidden;
 }
 
+void RemotePlayer::removeBatchedNames() {
+    player1->removeBatchedName();
+    player2->removeBatchedName();
+}
+
 void RemotePlayer::removeProgressIndicators() {
     if (progressIcon) {
         progressIcon->removeFromParent();
@@ -2,6 +2,7 @@
 #include <defs/all.hpp>
 
 #include "complex_visual_player.hpp"
+#include "crowd_renderer.hpp"
 #include <ui/game/progress/progress_icon.hpp>
 #include <ui/game/progress/progress_arrow.hpp>
 #include <data/types/gd.hpp>
@@ -12,6 +13,9 @@ class RemotePlayer : public cocos2d::CCNode {
 public:
     bool init(GameCameraState* gameCameraState, PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow, const PlayerAccountData& data);
     void updateAccountData(const PlayerAccountData& data, bool force = false);
+    // Resets the state left over from the last player, so a pooled instance can be handed to someone new.
+    // The caller still has to call `updateAccountData` to re-skin it.
+    void reuse(PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow);
     const PlayerAccountData& getAccountData() const;
 
     void updateData(
@@ -20,6 +24,14 @@ public:
         bool speaking,
         float loudness
     );
+    // Crowd mode path, the player is drawn by `crowd` and the visual players are hidden until `updateData` is called again
+    void updateCrowd(const VisualPlayerState& data, CrowdRenderer* crowd);
+    // For players that are building in the editor, only the status is kept up to date and both icons are hidden
+    void updateBuilding(const VisualPlayerState& data);
+    // For players that are hidden (blocked, or in practice with `hidePracticePlayers`), the icons are hidden once
+    // and only the status is kept up to date. The interpolator doesn't move them in the meantime either
+    void updateHidden(const VisualPlayerState& data);
+    bool isHidden() const;
     void updateProgressIcon();
     void updateProgressArrow(
         cocos2d::CCPoint cameraOrigin,
@@ -35,6 +47,8 @@ public:
     void setDefaultTicks(unsigned int ticks);
     void incDefaultTicks();
     void removeProgressIndicators();
+    // Names drawn by the level's `NameLabelBatch` aren't children of this node, so they have to be removed separately
+    void removeBatchedNames();
 
     void setForciblyHidden(bool state);
     bool getForciblyHidden();
@@ -51,6 +65,7 @@ public:
 
     FrameFlags lastFrameFlags;
     VisualPlayerState lastVisualState;
+    uint32_t profileVersion = 0; // version of the cached profile that was last applied, see `ProfileCacheManager::getVersion`
 
 protected:
     unsigned int defaultTicks = 0;
@@ -58,9 +73,14 @@ protected:
     bool wasPracticing = false;
     bool isForciblyHidden = false;
     bool isEditorBuilding = false;
+    bool wasHidden = false;
+    bool progressDirty = true; // progress only changes with new network data, so the icon is updated only when this is set
 
 
     GameCameraState* gameCameraState;
+    cocos2d::ccColor3B crowdColor = {255, 255, 255};
 
     PlayerAccountData accountData;
+
+    void updateProgressState(const VisualPlayerState& data);
 };
\ No newline at end of file
@@ -9,24 +9,24 @@ bool PlayerStatusIcons::init(unsigned char opacity) {
 
     this->opacity = opacity;
 
-    this->updateStatus(false, false, false, false, 0.f);
-    this->schedule(schedule_selector(PlayerStatusIcons::updateLoudnessIcon), 0.25f);
+    this->updateStatus(false, false, false, false, 0.f, true);
 
     return true;
 }
 
-void PlayerStatusIcons::updateLoudnessIcon(float dt) {
-    Loudness lcat = this->loudnessToCategory(lastLoudness * 2.f);
-    if (lcat != wasLoudness) {
-        wasLoudness = lcat;
-        this->updateStatus(wasPaused, wasPracticing, wasSpeaking, wasEditing, lastLoudness, true);
-    }
-}
-
 void PlayerStatusIcons::updateStatus(bool paused, bool practicing, bool speaking, bool editing, float loudness, bool force) {
-    lastLoudness = loudness;
+    Loudness lcat = speaking ? this->loudnessToCategory(loudness * 2.f) : wasLoudness;
+    bool loudnessChanged = lcat != wasLoudness;
+    wasLoudness = lcat;
+
+    if (!force && wasPaused == paused && wasPracticing == practicing && wasSpeaking == speaking && wasEditing == editing) {
+        if (loudnessChanged && speakerIcon) {
+            speakerIcon->setDisplayFrame(CCSpriteFrameCache::get()->spriteFrameByName(speakerSprite(lcat)));
+        }
+
+        return;
+    }
 
-    if (!force && wasPaused == paused && wasPracticing == practicing && wasSpeaking == speaking && wasEditing == editing) return;
     wasPaused = paused;
     wasPracticing = practicing;
     wasSpeaking = speaking;
@@ -39,6 +39,7 @@ void PlayerStatusIcons::updateStatus(bool paused, bool practicing, bool speaking
 
     this->setVisible(true);
     this->removeAllChildren();
+    speakerIcon = nullptr;
 
     float width = 25.f;
 
@@ -77,14 +78,7 @@ void PlayerStatusIcons::updateStatus(bool paused, bool practicing, bool speaking
     }
 
     if (wasSpeaking) {
-        std::string sprite;
-        switch (wasLoudness) {
-            case Loudness::Low: sprite = "speaker-icon.png"_spr; break;
-            case Loudness::Medium: sprite = "speaker-icon-yellow.png"_spr; break;
-            case Loudness::High: sprite = "speaker-icon-red.png"_spr; break;
-        }
-
-        auto speakSpr = Build<CCSprite>::createSpriteName(sprite.c_str())
+        speakerIcon = Build<CCSprite>::createSpriteName(speakerSprite(wasLoudness))
             .opacity(opacity)
             .zOrder(1)
             .scale(0.85f)
@@ -92,7 +86,7 @@ void PlayerStatusIcons::updateStatus(bool paused, bool practicing, bool speaking
             .parent(iconWrapper)
             .collect();
 
-        width += speakSpr->getScaledContentSize().width;
+        width += speakerIcon->getScaledContentSize().width;
         count++;
     }
 
@@ -138,6 +132,14 @@ PlayerStatusIcons::Loudness PlayerStatusIcons::loudnessToCategory(float loudness
     // }
 }
 
+const char* PlayerStatusIcons::speakerSprite(Loudness loudness) {
+    switch (loudness) {
+        case Loudness::Medium: return "speaker-icon-yellow.png"_spr;
+        case Loudness::High: return "speaker-icon-red.png"_spr;
+        default: return "speaker-icon.png"_spr;
+    }
+}
+
 PlayerStatusIcons* PlayerStatusIcons::create(unsigned char opacity) {
     auto ret = new PlayerStatusIcons;
     if (ret->init(opacity)) {
@@ -1,10 +1,10 @@
 #pragma once
 #include <defs/all.hpp>
 
+// Called every frame, but the icons are only rebuilt when the status changes, and a new loudness level only swaps the speaker sprite
 class PlayerStatusIcons : public cocos2d::CCNode {
 public:
     void updateStatus(bool paused, bool practicing, bool speaking, bool editing, float loudness, bool force = false);
-    void updateLoudnessIcon(float dt);
 
     static PlayerStatusIcons* create(unsigned char opacity);
 
@@ -14,13 +14,14 @@ private:
     };
 
     cocos2d::CCNode* iconWrapper = nullptr;
+    cocos2d::CCSprite* speakerIcon = nullptr;
     bool wasPaused = false, wasPracticing = false, wasSpeaking = false, wasEditing = false;
     Loudness wasLoudness = Loudness::Low;
-    float lastLoudness = 0.f;
     float nameScale = 0.f;
     unsigned char opacity = 255;
 
     bool init(unsigned char opacity);
 
     static Loudness loudnessToCategory(float loudness);
+    static const char* speakerSprite(Loudness loudness);
 };
\ No newline at end of file
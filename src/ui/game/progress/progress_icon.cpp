@@ -17,6 +17,9 @@ void PlayerProgressIcon::updateIcons(const PlayerIconData& data) {
     // if (practiceSprite) practiceSprite->removeFromParent();
     if (playerIcon) playerIcon->removeFromParent();
 
+    // the new line has to be toggled again
+    lastProgress = -1.f;
+
     auto& settings = GlobedSettings::get();
     auto gm = GameManager::get();
     auto color1 = gm->colorForIdx(data.color1);
@@ -48,6 +51,13 @@ void PlayerProgressIcon::updatePosition(float progress, bool isPracticing) {
     if (!parent) return;
 
     CCSize pbSize = parent->getScaledContentSize();
+
+    if (progress == lastProgress && isPracticing == lastPracticing && pbSize.width == lastWidth) return;
+
+    lastProgress = progress;
+    lastPracticing = isPracticing;
+    lastWidth = pbSize.width;
+
     float prOffset = (pbSize.width - 2.f) * progress;
 
     bool lineIsVisible = progress > 0.01f && progress < 0.99f;
@@ -56,10 +66,11 @@ void PlayerProgressIcon::updatePosition(float progress, bool isPracticing) {
     this->toggleLine(lineIsVisible);
     this->togglePracticeSprite(practiceSpriteVisible);
 
-    if (forceOnTop) {
-        this->setZOrder(100000);
-    } else {
-        this->setZOrder((int)(progress * 10000)); // straight from globed1
+    int zOrder = forceOnTop ? 100000 : (int)(progress * 10000); // straight from globed1
+
+    // setting the z order always makes the parent re-sort its children, even if it is the same
+    if (zOrder != this->getZOrder()) {
+        this->setZOrder(zOrder);
     }
     this->setPositionX(prOffset);
 }
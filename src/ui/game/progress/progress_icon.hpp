@@ -20,5 +20,10 @@ private:
     GlobedSimplePlayer* playerIcon = nullptr;
     bool forceOnTop = false;
 
+    // last state passed to `updatePosition`, which skips all the work if nothing changed
+    float lastProgress = -1.f;
+    float lastWidth = -1.f;
+    bool lastPracticing = false;
+
     bool init();
 };
@@ -13,11 +13,11 @@ bool GlobedUserActionsPopup::setup(int accountId) {
     this->accountId = accountId;
 
     auto& pcm = ProfileCacheManager::get();
-    auto data = pcm.getData(accountId);
+    auto* data = pcm.findData(accountId);
 
     std::string name = "Player";
-    if (data.has_value()) {
-        name = data->name;
+    if (data) {
+        name = data->name.str();
     }
 
     this->setTitle(name);
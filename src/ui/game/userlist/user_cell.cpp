@@ -10,14 +10,32 @@
 #include <hooks/gjbasegamelayer.hpp>
 #include <hooks/gjgamelevel.hpp>
 #include <ui/general/ask_input_popup.hpp>
+#include <ui/general/icon_thumbnail.hpp>
 #include <util/format.hpp>
 #include <util/ui.hpp>
 
 using namespace geode::prelude;
 
-bool GlobedUserCell::init(const PlayerStore::Entry& entry, const PlayerAccountData& data) {
+bool GlobedUserCell::init() {
     if (!CCLayer::init()) return false;
 
+    this->schedule(schedule_selector(GlobedUserCell::updateVisualizer), 1.f / 60.f);
+
+    return true;
+}
+
+void GlobedUserCell::setData(const PlayerStore::Entry& entry, const PlayerAccountData& data) {
+    // same player scrolled back into the same cell, only the progress can be different
+    if (menu && accountData == data) {
+        this->refreshData(entry);
+        return;
+    }
+
+    this->removeAllChildren();
+    actionsButton = muteButton = hideButton = kickButton = teleportButton = linkButton = nullptr;
+    buttonsWrapper = nullptr;
+    audioVisualizer = nullptr;
+
     accountData = data;
 
     auto winSize = CCDirector::get()->getWinSize();
@@ -38,7 +56,7 @@ bool GlobedUserCell::init(const PlayerStore::Entry& entry, const PlayerAccountDa
         .id("name-layout"_spr)
         .store(usernameLayout);
 
-    auto sp = Build<GlobedSimplePlayer>::create(data.icons)
+    auto sp = Build<GlobedIconThumbnail>::create(data.icons)
         .scale(0.6f)
         .parent(usernameLayout)
         .id("player-icon"_spr)
@@ -55,7 +73,7 @@ bool GlobedUserCell::init(const PlayerStore::Entry& entry, const PlayerAccountDa
         .intoMenuItem([this] {
             bool myself = accountData.accountId == GJAccountManager::get()->m_accountID;
             if (!myself) {
-                GameLevelManager::sharedState()->storeUserName(accountData.userId, accountData.accountId, accountData.name);
+                GameLevelManager::sharedState()->storeUserName(accountData.userId, accountData.accountId, accountData.name.str());
             }
 
             ProfilePage::create(accountData.accountId, myself)->show();
@@ -82,24 +100,25 @@ bool GlobedUserCell::init(const PlayerStore::Entry& entry, const PlayerAccountDa
 
     this->makeButtons();
 
-    this->refreshData(entry);
-    this->schedule(schedule_selector(GlobedUserCell::updateVisualizer), 1.f / 60.f);
-
-    return true;
+    _data = entry;
+    this->updatePercentage();
 }
 
 void GlobedUserCell::refreshData(const PlayerStore::Entry& entry) {
     if (_data != entry) {
         _data = entry;
+        this->updatePercentage();
+    }
+}
 
-        bool platformer = GJBaseGameLayer::get()->m_level->isPlatformer();
-        if (platformer && _data.localBest != 0) {
-            percentageLabel->setString(util::format::formatPlatformerTime(_data.localBest).c_str());
-            usernameLayout->updateLayout();
-        } else if (!platformer) {
-            percentageLabel->setString(fmt::format("{}%", _data.localBest).c_str());
-            usernameLayout->updateLayout();
-        }
+void GlobedUserCell::updatePercentage() {
+    bool platformer = GJBaseGameLayer::get()->m_level->isPlatformer();
+    if (platformer && _data.localBest != 0) {
+        percentageLabel->setString(util::format::formatPlatformerTime(_data.localBest).c_str());
+        usernameLayout->updateLayout();
+    } else if (!platformer) {
+        percentageLabel->setString(fmt::format("{}%", _data.localBest).c_str());
+        usernameLayout->updateLayout();
     }
 }
 
@@ -299,9 +318,10 @@ void GlobedUserCell::makeButtons() {
     buttonsWrapper->updateLayout();
 }
 
-GlobedUserCell* GlobedUserCell::create(const PlayerStore::Entry& entry, const PlayerAccountData& data) {
+GlobedUserCell* GlobedUserCell::create() {
     auto ret = new GlobedUserCell;
-    if (ret->init(entry, data)) {
+    if (ret->init()) {
+        ret->autorelease();
         return ret;
     }
 
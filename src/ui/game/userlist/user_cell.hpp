@@ -9,16 +9,18 @@ class GlobedUserCell : public cocos2d::CCLayer {
 public:
     static constexpr float CELL_HEIGHT = 25.f;
 
+    // Fills the cell in for this player. Cells are reused by the list as it scrolls, so this rebuilds everything if the player changed
+    void setData(const PlayerStore::Entry& entry, const PlayerAccountData& data);
     void refreshData(const PlayerStore::Entry& entry);
     void updateVisualizer(float dt);
 
-    static GlobedUserCell* create(const PlayerStore::Entry& entry, const PlayerAccountData& data);
+    static GlobedUserCell* create();
 
     PlayerAccountData accountData;
 
 private:
-    cocos2d::CCLabelBMFont* percentageLabel;
-    cocos2d::CCMenu *menu, *usernameLayout;
+    cocos2d::CCLabelBMFont* percentageLabel = nullptr;
+    cocos2d::CCMenu *menu = nullptr, *usernameLayout = nullptr;
     CCMenuItemSpriteExtra
         *actionsButton = nullptr,
         *muteButton = nullptr,
@@ -31,7 +33,8 @@ private:
     GlobedAudioVisualizer* audioVisualizer = nullptr;
     PlayerStore::Entry _data;
 
-    bool init(const PlayerStore::Entry& entry, const PlayerAccountData& data);
+    bool init() override;
     void makeButtons();
+    void updatePercentage();
     void updateUsernameLayout();
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <managers/profile_cache.hpp>
 #include <managers/friend_list.hpp>
 #include <managers/settings.hpp>
+#include <util/debug.hpp>
 #include <util/ui.hpp>
 #include <util/misc.hpp>
 
@@ -23,7 +24,19 @@ bool GlobedUserListPopup::setup() {
         .parent(m_mainLayer)
         .store(listLayer);
 
+    list = Build<VirtualList>::create(
+        CCSize{LIST_WIDTH, LIST_HEIGHT},
+        GlobedUserCell::CELL_HEIGHT,
+        [] { return GlobedUserCell::create(); },
+        [this](CCNode* cell, size_t index) { this->bindCell(static_cast<GlobedUserCell*>(cell), index); }
+    )
+        .parent(listLayer)
+        .collect();
+
+    list->setRowColors(util::ui::BG_COLOR_BROWN, util::ui::BG_COLOR_DARKBROWN);
+
     this->hardRefresh();
+    this->schedule(schedule_selector(GlobedUserListPopup::reloadList), 1.f);
 
     Build<CCSprite>::createSpriteName("GJ_updateBtn_001.png")
         .scale(0.9f)
@@ -97,17 +110,17 @@ void GlobedUserListPopup::reorderWithVolume(float) {
     if (!volumeSortEnabled) return;
 
     auto& vpm = VoicePlaybackManager::get();
+    auto& pcm = ProfileCacheManager::get();
 
-    std::unordered_map<int, GlobedUserCell*> cellMap;
-    std::vector<int> cellIndices;
+    auto nameOf = [&pcm](int id) -> std::string_view {
+        if (id == pcm.getOwnAccountData().accountId) return pcm.getOwnAccountData().name;
 
-    for (auto* entry : CCArrayExt<GlobedUserCell*>(listLayer->m_list->m_entries)) {
-        cellMap[entry->accountData.accountId] = entry;
-        cellIndices.push_back(entry->accountData.accountId);
-    }
+        auto* data = pcm.findData(id);
+        return data ? std::string_view(data->name) : std::string_view();
+    };
 
     auto now = util::time::now();
-    std::sort(cellIndices.begin(), cellIndices.end(), [&vpm, &cellMap, now = now](int idx1, int idx2) -> bool {
+    std::sort(playerIds.begin(), playerIds.end(), [&vpm, &nameOf, now = now](int idx1, int idx2) -> bool {
         constexpr util::time::seconds limit(5);
 
         auto time1 = vpm.getLastPlaybackTime(idx1);
@@ -123,7 +136,7 @@ void GlobedUserListPopup::reorderWithVolume(float) {
 
             // if there's a 0 second difference, sort by playername
             if (std::abs(secs2 - secs1) == 0) {
-                return util::misc::compareName(cellMap[idx1]->accountData.name, cellMap[idx2]->accountData.name);
+                return util::misc::compareName(nameOf(idx1), nameOf(idx2));
             }
 
             // otherwise sort by recently speaking
@@ -135,120 +148,99 @@ void GlobedUserListPopup::reorderWithVolume(float) {
         }
 
         // if both users haven't spoken, sort by name
-        return util::misc::compareName(cellMap[idx1]->accountData.name, cellMap[idx2]->accountData.name);
+        return util::misc::compareName(nameOf(idx1), nameOf(idx2));
     });
 
-    auto sorted = CCArray::create();
-    for (int idx : cellIndices) {
-        sorted->addObject(cellMap[idx]);
-    }
-
-    float scrollPos = util::ui::getScrollPos(listLayer->m_list);
-
-    listLayer->m_list->removeFromParent();
-    listLayer->m_list = Build<ListView>::create(sorted, GlobedUserCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT)
-        .parent(listLayer);
+    list->rebindAll();
+}
 
-    util::ui::setScrollPos(listLayer->m_list, scrollPos);
+void GlobedUserListPopup::reloadList(float) {
+    // a frame that is already over budget doesn't need a list rebuild on top, it's retried on the next tick
+    if (!util::debug::MainThreadTimer::get().tryRun(reloadDeferrals)) return;
+
+    auto ids = this->getSortedPlayers();
+
+    // someone joined or left, only the visible cells get rebound either way
+    if (ids != playerIds) {
+        playerIds = std::move(ids);
+        list->setCount(playerIds.size());
+        this->setTitle(fmt::format("Players ({})", playerIds.size()));
+    } else {
+        list->rebindAll();
+    }
+}
 
-    vpm.getLastPlaybackTime(0);
+void GlobedUserListPopup::hardRefresh() {
+    playerIds = this->getSortedPlayers();
+    list->setCount(playerIds.size());
+    this->setTitle(fmt::format("Players ({})", playerIds.size()));
 }
 
-void GlobedUserListPopup::reloadList(float) {
+std::vector<int> GlobedUserListPopup::getSortedPlayers() {
     auto playLayer = GlobedGJBGL::get();
-    if (!playLayer) return;
+    if (!playLayer) return {};
 
     auto& playerStore = playLayer->m_fields->playerStore->getAll();
     auto& pcm = ProfileCacheManager::get();
+    int ownId = pcm.getOwnAccountData().accountId;
 
-    size_t existingCount = listLayer->m_list->m_entries->count();
+    std::vector<int> ids;
+    ids.reserve(playerStore.size());
 
-    // if the count is different, hard refresh
-    if (playerStore.size() != existingCount) {
-        this->hardRefresh();
-        return;
-    }
-
-    size_t refreshed = 0;
-    for (auto* cell : CCArrayExt<GlobedUserCell*>(listLayer->m_list->m_entries)) {
-        for (const auto& [playerId, entry] : playerStore) {
-            if (playerId == cell->accountData.accountId) {
-                cell->refreshData(entry);
-                refreshed++;
-            }
+    for (const auto& [playerId, _] : playerStore) {
+        // players without a profile can't be shown yet
+        if (playerId == ownId || pcm.findData(playerId)) {
+            ids.push_back(playerId);
         }
     }
 
-    // if fails, do hard refresh
-    if (refreshed != existingCount) {
-        this->hardRefresh();
-    }
-}
+    auto nameOf = [&pcm, ownId](int id) -> std::string_view {
+        if (id == ownId) return pcm.getOwnAccountData().name;
+        return pcm.findData(id)->name;
+    };
 
-void GlobedUserListPopup::hardRefresh() {
-    float lastScrollPos = -1.f;
-    if (listLayer->m_list) {
-        lastScrollPos = util::ui::getScrollPos(listLayer->m_list);
-        listLayer->m_list->removeFromParent();
-    }
+    // friends go first, look them all up at once instead of twice per comparison
+    auto isFriend = FriendListManager::get().areFriends(ids);
 
-    listLayer->m_list = Build<ListView>::create(createPlayerCells(), GlobedUserCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT)
-        .parent(listLayer)
-        .collect();
+    std::vector<int> sorted;
+    sorted.reserve(ids.size());
 
-    if (lastScrollPos != -1.f) {
-        util::ui::setScrollPos(listLayer->m_list, lastScrollPos);
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (isFriend[i]) sorted.push_back(ids[i]);
     }
-}
-
-CCArray* GlobedUserListPopup::createPlayerCells() {
-    auto cells = CCArray::create();
-
-    auto playLayer = GlobedGJBGL::get();
-    auto& playerStore = playLayer->m_fields->playerStore->getAll();
-    auto& pcm = ProfileCacheManager::get();
-    auto& ownData = pcm.getOwnAccountData();
 
-    std::vector<int> playerIds;
+    size_t friendCount = sorted.size();
 
-    for (const auto& [playerId, _] : playerStore) {
-        playerIds.push_back(playerId);
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (!isFriend[i]) sorted.push_back(ids[i]);
     }
 
-    auto& flm = FriendListManager::get();
-    std::sort(playerIds.begin(), playerIds.end(), [&flm, &pcm, &playerStore](const auto& p1, const auto& p2) -> bool {
-        bool isFriend1 = flm.isFriend(p1);
-        bool isFriend2 = flm.isFriend(p2);
+    auto byName = [&nameOf](int p1, int p2) -> bool {
+        return util::misc::compareName(nameOf(p1), nameOf(p2));
+    };
 
-        if (isFriend1 != isFriend2) {
-            return isFriend1;
-        } else {
-            auto accData1 = pcm.getData(p1);
-            auto accData2 = pcm.getData(p2);
-            if (!accData1 || !accData2) return false;
+    std::sort(sorted.begin(), sorted.begin() + friendCount, byName);
+    std::sort(sorted.begin() + friendCount, sorted.end(), byName);
 
-            return util::misc::compareName(accData1.value().name, accData2.value().name);
-        }
-    });
+    return sorted;
+}
 
-    this->setTitle(fmt::format("Players ({})", playerIds.size()));
+void GlobedUserListPopup::bindCell(GlobedUserCell* cell, size_t index) {
+    auto playLayer = GlobedGJBGL::get();
+    if (!playLayer || index >= playerIds.size()) return;
 
-    for (const auto playerId : playerIds) {
-        auto& entry = playerStore.at(playerId);
+    int playerId = playerIds[index];
 
-        GlobedUserCell* cell;
-        if (playerId == ownData.accountId) {
-            cell = GlobedUserCell::create(entry, ownData);
-        } else {
-            auto pcmdata = pcm.getData(playerId);
-            if (!pcmdata) continue;
-            cell = GlobedUserCell::create(entry, pcmdata.value());
-        }
+    auto& pcm = ProfileCacheManager::get();
+    auto& ownData = pcm.getOwnAccountData();
 
-        cells->addObject(cell);
-    }
+    auto entry = playLayer->m_fields->playerStore->get(playerId).value_or(PlayerStore::Entry {});
 
-    return cells;
+    if (playerId == ownData.accountId) {
+        cell->setData(entry, ownData);
+    } else if (auto* data = pcm.findData(playerId)) {
+        cell->setData(entry, *data);
+    }
 }
 
 void GlobedUserListPopup::onToggleVoiceSort(cocos2d::CCObject* sender) {
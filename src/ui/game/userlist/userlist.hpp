@@ -2,6 +2,10 @@
 #include <defs/all.hpp>
 #include <Geode/utils/web.hpp>
 
+#include <ui/general/virtual_list.hpp>
+
+class GlobedUserCell;
+
 class GlobedUserListPopup : public geode::Popup<> {
 public:
     static constexpr float POPUP_WIDTH = 400.f;
@@ -13,14 +17,19 @@ public:
 
 private:
     GJCommentListLayer* listLayer = nullptr;
+    VirtualList* list = nullptr;
+    // sorted, the list only creates cells for the visible part of it
+    std::vector<int> playerIds;
     bool volumeSortEnabled = false;
+    uint8_t reloadDeferrals = 0; // see `util::debug::MainThreadTimer::tryRun`
     Slider* volumeSlider = nullptr;
 
     bool setup() override;
     void reloadList(float);
     void reorderWithVolume(float);
     void hardRefresh();
-    cocos2d::CCArray* createPlayerCells();
+    std::vector<int> getSortedPlayers();
+    void bindCell(GlobedUserCell* cell, size_t index);
     void onToggleVoiceSort(cocos2d::CCObject* sender);
     void onVolumeChanged(cocos2d::CCObject* sender);
 };
@@ -2,7 +2,6 @@
 
 #include "overlay_cell.hpp"
 #include <audio/voice_playback_manager.hpp>
-#include <hooks/gjbasegamelayer.hpp>
 #include <managers/profile_cache.hpp>
 
 using namespace geode::prelude;
@@ -22,42 +21,53 @@ bool GlobedVoiceOverlay::init() {
     return true;
 }
 
-void GlobedVoiceOverlay::addPlayer(int accountId) {
-    auto& pcm = ProfileCacheManager::get();
-    auto data = pcm.getData(accountId);
+void GlobedVoiceOverlay::addPlayer(int accountId, float loudness) {
+    if (cells.contains(accountId)) return;
 
-    PlayerAccountData accdata = PlayerAccountData::DEFAULT_DATA;
-    if (data.has_value()) {
-        accdata = data.value();
-    }
+    auto& pcm = ProfileCacheManager::get();
+    auto* data = pcm.findData(accountId);
 
-    auto* cell = VoiceOverlayCell::create(accdata);
+    auto* cell = VoiceOverlayCell::create(data ? *data : PlayerAccountData::DEFAULT_DATA);
+    cell->updateVolume(loudness);
     this->addChild(cell);
-}
-
-void GlobedVoiceOverlay::updateOverlay() {
-#ifdef GLOBED_VOICE_SUPPORT
-    auto& vpm = VoicePlaybackManager::get();
 
-    this->removeAllChildren();
-
-    bool isProximity = GlobedGJBGL::get()->m_fields->isVoiceProximity;
+    cells.emplace(accountId, cell);
+}
 
-    vpm.forEachStream([this, isProximity = isProximity](int accountId, AudioStream& stream) {
-        if (!stream.starving && (!isProximity || stream.getVolume() > 0.005f)) {
-            this->addPlayer(accountId);
-        }
-    });
+void GlobedVoiceOverlay::removePlayer(int accountId) {
+    auto it = cells.find(accountId);
+    if (it == cells.end()) return;
 
-    this->updateLayout();
-#endif // GLOBED_VOICE_SUPPORT
+    it->second->removeFromParent();
+    cells.erase(it);
 }
 
-void GlobedVoiceOverlay::updateOverlaySoft() {
-    auto& vpm = VoicePlaybackManager::get();
+void GlobedVoiceOverlay::updateOverlay() {
+    using Kind = VoicePlaybackManager::SpeakerEvent::Kind;
+
+    bool relayout = false;
+
+    for (const auto& event : VoicePlaybackManager::get().speakerEvents()) {
+        switch (event.kind) {
+            case Kind::Started: {
+                this->addPlayer(event.playerId, event.loudness);
+                relayout = true;
+            } break;
+            case Kind::Stopped: {
+                this->removePlayer(event.playerId);
+                relayout = true;
+            } break;
+            case Kind::Loudness: {
+                auto it = cells.find(event.playerId);
+                if (it != cells.end()) {
+                    it->second->updateVolume(event.loudness);
+                }
+            } break;
+        }
+    }
 
-    for (auto* cell : CCArrayExt<VoiceOverlayCell*>(this->getChildren())) {
-        cell->updateVolume(vpm.getLoudness(cell->accountId));
+    if (relayout) {
+        this->updateLayout();
     }
 }
 
@@ -1,14 +1,20 @@
 #pragma once
 #include <Geode/Geode.hpp>
 
+class VoiceOverlayCell;
+
 class GlobedVoiceOverlay : public cocos2d::CCNode {
 public:
     static GlobedVoiceOverlay* create();
 
+    // Applies the speaker events from the last `VoicePlaybackManager::updateAllEstimators` call,
+    // only the cells of players that started, stopped or got louder/quieter are touched.
     void updateOverlay();
-    void updateOverlaySoft();
-    void addPlayer(int accountId);
 
 private:
+    std::unordered_map<int, VoiceOverlayCell*> cells;
+
     bool init() override;
+    void addPlayer(int accountId, float loudness);
+    void removePlayer(int accountId);
 };
@@ -0,0 +1,43 @@
+#include "icon_thumbnail.hpp"
+
+#include <managers/icon_thumbnails.hpp>
+
+using namespace geode::prelude;
+
+bool GlobedIconThumbnail::init(const GlobedSimplePlayer::Icons& icons) {
+    if (!CCNode::init()) return false;
+
+    this->updateIcons(icons);
+
+    return true;
+}
+
+void GlobedIconThumbnail::updateIcons(const GlobedSimplePlayer::Icons& icons) {
+    auto* texture = IconThumbnailCache::get().textureFor(icons);
+    if (!texture) return;
+
+    if (sprite) {
+        sprite->setTexture(texture);
+        sprite->setTextureRect(CCRect{CCPointZero, texture->getContentSize()});
+    } else {
+        sprite = CCSprite::createWithTexture(texture);
+        sprite->setFlipY(true);
+        this->addChild(sprite);
+    }
+
+    // the texture has some padding for the glow, the node itself is only as big as the icon
+    float padding = IconThumbnailCache::PADDING * 2.f;
+    this->setContentSize(texture->getContentSize() - CCSize{padding, padding});
+    sprite->setPosition(this->getContentSize() / 2);
+}
+
+GlobedIconThumbnail* GlobedIconThumbnail::create(const GlobedSimplePlayer::Icons& icons) {
+    auto ret = new GlobedIconThumbnail;
+    if (ret->init(icons)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include "simple_player.hpp"
+
+// Static player icon drawn from `IconThumbnailCache`, a single sprite instead of the several that make up a `GlobedSimplePlayer`.
+// Has the same content size as a `GlobedSimplePlayer` with the same icons, so it can be used in its place in list rows.
+class GlobedIconThumbnail : public cocos2d::CCNode {
+public:
+    static GlobedIconThumbnail* create(const GlobedSimplePlayer::Icons& icons);
+
+    void updateIcons(const GlobedSimplePlayer::Icons& icons);
+
+protected:
+    cocos2d::CCSprite* sprite = nullptr;
+
+    bool init(const GlobedSimplePlayer::Icons& icons);
+};
@@ -0,0 +1,132 @@
+#include "virtual_list.hpp"
+
+using namespace geode::prelude;
+
+bool VirtualList::init(const CCSize& size, float rowHeight, CellFactory&& factory, CellBinder&& binder) {
+    if (!CCNode::init()) return false;
+
+    this->rowHeight = rowHeight;
+    this->factory = std::move(factory);
+    this->binder = std::move(binder);
+    this->setContentSize(size);
+
+    Build<ScrollLayer>::create(size)
+        .parent(this)
+        .store(scroll);
+
+    // enough rows to cover the view when it's scrolled between two entries
+    size_t rowCount = static_cast<size_t>(size.height / rowHeight) + 2;
+
+    for (size_t i = 0; i < rowCount; i++) {
+        auto& row = rows.emplace_back();
+
+        row.background = Build<CCLayerColor>::create(evenColor, size.width, rowHeight)
+            .visible(false)
+            .parent(scroll->m_contentLayer)
+            .collect();
+
+        row.cell = this->factory();
+        row.background->addChild(row.cell);
+    }
+
+    this->updateContentHeight();
+    this->scheduleUpdate();
+
+    return true;
+}
+
+void VirtualList::setCount(size_t count) {
+    this->count = count;
+    this->updateContentHeight();
+    this->rebindAll();
+}
+
+size_t VirtualList::getCount() {
+    return count;
+}
+
+void VirtualList::rebindAll() {
+    dirty = true;
+}
+
+void VirtualList::rebind(size_t index) {
+    auto& row = rows[index % rows.size()];
+    if (row.index == index) {
+        binder(row.cell, index);
+    }
+}
+
+void VirtualList::setRowColors(const ccColor4B& even, const ccColor4B& odd) {
+    evenColor = even;
+    oddColor = odd;
+    this->rebindAll();
+}
+
+void VirtualList::scrollToTop() {
+    auto* cl = scroll->m_contentLayer;
+    cl->setPositionY(this->getContentHeight() - cl->getContentHeight());
+}
+
+void VirtualList::scrollToBottom() {
+    scroll->m_contentLayer->setPositionY(0.f);
+}
+
+bool VirtualList::isScrolledToBottom() {
+    // the content layer is anchored at its bottom, so the bottom is in view at 0
+    return scroll->m_contentLayer->getPositionY() >= -1.f;
+}
+
+void VirtualList::updateContentHeight() {
+    auto* cl = scroll->m_contentLayer;
+
+    float oldHeight = cl->getContentHeight();
+    float newHeight = std::max(this->getContentHeight(), count * rowHeight);
+
+    // keep the same entries at the top of the view, the content layer is anchored at its bottom
+    float minPos = this->getContentHeight() - newHeight;
+    float pos = cl->getPositionY() - (newHeight - oldHeight);
+
+    cl->setContentSize({this->getContentWidth(), newHeight});
+    cl->setPositionY(std::clamp(pos, minPos, 0.f));
+}
+
+void VirtualList::update(float) {
+    auto* cl = scroll->m_contentLayer;
+    float contentHeight = cl->getContentHeight();
+
+    // the view covers [-y; -y + height] of the content layer, and entry 0 is at the very top
+    float viewTop = -cl->getPositionY() + this->getContentHeight();
+    size_t first = static_cast<size_t>(std::max((contentHeight - viewTop) / rowHeight, 0.f));
+
+    for (size_t i = first; i < first + rows.size(); i++) {
+        auto& row = rows[i % rows.size()];
+
+        if (i >= count) {
+            row.background->setVisible(false);
+            row.index = -1;
+            continue;
+        }
+
+        if (row.index != i || dirty) {
+            row.index = i;
+            row.background->setPositionY(contentHeight - (i + 1) * rowHeight);
+            row.background->setColor(i % 2 == 0 ? ccColor3B{evenColor.r, evenColor.g, evenColor.b} : ccColor3B{oddColor.r, oddColor.g, oddColor.b});
+            row.background->setOpacity(i % 2 == 0 ? evenColor.a : oddColor.a);
+            row.background->setVisible(true);
+            binder(row.cell, i);
+        }
+    }
+
+    dirty = false;
+}
+
+VirtualList* VirtualList::create(const CCSize& size, float rowHeight, CellFactory factory, CellBinder binder) {
+    auto ret = new VirtualList;
+    if (ret->init(size, rowHeight, std::move(factory), std::move(binder))) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <defs/all.hpp>
+
+// Scrollable list of fixed height rows that only keeps enough cells around to fill the visible area.
+// Cells are made once by the factory, and whenever a cell scrolls onto a different entry the binder is called to fill it in.
+// The entries themselves are not stored here, rows are identified by index, so the owner keeps the (sorted) data.
+class VirtualList : public cocos2d::CCNode {
+public:
+    using CellFactory = std::function<cocos2d::CCNode*()>;
+    using CellBinder = std::function<void(cocos2d::CCNode* cell, size_t index)>;
+
+    static VirtualList* create(const cocos2d::CCSize& size, float rowHeight, CellFactory factory, CellBinder binder);
+
+    // Changes the amount of entries, rebinds visible rows on the next frame, keeping the scroll position
+    void setCount(size_t count);
+    size_t getCount();
+
+    // Rebinds all visible rows on the next frame, call when the data behind them has changed
+    void rebindAll();
+    // Rebinds a single row if it's visible
+    void rebind(size_t index);
+
+    // Alternating row backgrounds, transparent by default
+    void setRowColors(const cocos2d::ccColor4B& even, const cocos2d::ccColor4B& odd);
+
+    void scrollToTop();
+    void scrollToBottom();
+    bool isScrolledToBottom();
+
+private:
+    struct Row {
+        Ref<cocos2d::CCLayerColor> background;
+        Ref<cocos2d::CCNode> cell;
+        size_t index = -1;
+    };
+
+    geode::ScrollLayer* scroll = nullptr;
+    std::vector<Row> rows;
+    CellFactory factory;
+    CellBinder binder;
+    float rowHeight;
+    size_t count = 0;
+    bool dirty = true;
+    cocos2d::ccColor4B evenColor = {0, 0, 0, 0}, oddColor = {0, 0, 0, 0};
+
+    bool init(const cocos2d::CCSize& size, float rowHeight, CellFactory&& factory, CellBinder&& binder);
+    void update(float) override;
+    void updateContentHeight();
+};
@@ -1,6 +1,7 @@
 #include "admin_popup.hpp"
 
 #include "send_notice_popup.hpp"
+#include "user_list_popup.hpp"
 #include "user_popup.hpp"
 #include <data/packets/client/admin.hpp>
 #include <data/packets/server/admin.hpp>
@@ -61,14 +62,74 @@ bool AdminPopup::setup() {
     bool authorized = am.authorized();
     if (!authorized) return false;
 
-    nm.addListener<AdminUserDataPacket>(this, [](auto packet) {
-        AdminUserPopup::create(packet->userEntry, packet->accountData)->show();
+    nm.addListener<AdminUserDataPacket>(this, [](auto& packet) {
+        AdminManager::get().cacheUser(packet.userEntry, packet.accountData);
+        AdminUserPopup::create(packet.userEntry, packet.accountData)->show();
     });
 
-    nm.addListener<AdminErrorPacket>(this, [this](auto packet) {
+    nm.addListener<AdminUsersDataPacket>(this, [this](auto& packet) {
+        auto& am = AdminManager::get();
+
+        for (const auto& [entry, accountData] : packet.users) {
+            am.cacheUser(entry, accountData);
+        }
+
+        // a search only warms up the cache, a lookup of multiple users shows them
+        if (!this->pendingLookup) return;
+
+        auto players = std::move(*this->pendingLookup);
+        this->pendingLookup.reset();
+
+        for (const auto& [entry, accountData] : packet.users) {
+            if (accountData.has_value()) {
+                players.push_back(*accountData);
+            } else {
+                players.emplace_back(entry.accountId, 0, entry.userName.value_or(""), PlayerIconDataSimple{}, 0, SpecialUserData{});
+            }
+        }
+
+        if (!packet.missing.empty()) {
+            std::string missing;
+            for (const auto& name : packet.missing) {
+                if (!missing.empty()) missing += ", ";
+                missing += name;
+            }
+
+            ErrorQueues::get().warn(fmt::format("Unable to find: {}", missing));
+        }
+
+        if (!players.empty()) {
+            AdminUserListPopup::create("Users", std::move(players))->show();
+        }
+    });
+
+    nm.addListener<AdminUserSearchResultsPacket>(this, [this](auto& packet) {
+        if (packet.players.empty()) {
+            ErrorQueues::get().warn("No online users found");
+            return;
+        }
+
+        // fetch everyone's state in one packet now, so opening any of them later doesn't wait on the server
+        auto& am = AdminManager::get();
+        std::vector<std::string> uncached;
+        for (const auto& player : packet.players) {
+            auto id = std::to_string(player.accountId);
+            if (!am.getCachedUser(id) && uncached.size() < AdminGetUsersPacket::MAX_PLAYERS) {
+                uncached.push_back(std::move(id));
+            }
+        }
+
+        if (!uncached.empty()) {
+            NetworkManager::get().send(AdminGetUsersPacket::create(std::move(uncached)));
+        }
+
+        AdminUserListPopup::create("Search results", std::move(packet.players))->show();
+    });
+
+    nm.addListener<AdminErrorPacket>(this, [this](auto& packet) {
         // incredibly scary code
 
-        if (packet->message.find("failed to find the user by name") != std::string::npos) {
+        if (packet.message.find("failed to find the user by name") != std::string::npos) {
             // try to search the user in gd
             auto username = this->userInput->getString();
             IntermediaryLoadingPopup::create([this, username = std::move(username)](auto popup) {
@@ -97,7 +158,7 @@ bool AdminPopup::setup() {
                 glm->m_levelManagerDelegate = nullptr;
             })->show();
         } else {
-            ErrorQueues::get().warn(packet->message);
+            ErrorQueues::get().warn(packet.message);
         }
     }, true);
 
@@ -166,17 +227,22 @@ bool AdminPopup::setup() {
         .parent(m_mainLayer)
         .collect();
 
-    Build<InputNode>::create(POPUP_WIDTH * 0.75f, "user", "chatFont.fnt", std::string(util::misc::STRING_ALPHANUMERIC), 16)
+    Build<InputNode>::create(POPUP_WIDTH * 0.6f, "user, or multiple separated by commas", "chatFont.fnt", std::string(util::misc::STRING_ALPHANUMERIC) + ", ", 256)
         .parent(findUserWrapper)
         .store(userInput);
 
     Build<ButtonSprite>::create("Find", "bigFont.fnt", "GJ_button_01.png", 0.5f)
         .intoMenuItem([this](auto) {
-            auto user = this->userInput->getString();
-            if (!user.empty()) {
-                auto& nm = NetworkManager::get();
-                nm.send(AdminGetUserStatePacket::create(user));
-            }
+            this->findUsers(this->userInput->getString());
+        })
+        .parent(findUserWrapper);
+
+    Build<CCSprite>::createSpriteName("gj_findBtn_001.png")
+        .scale(0.8f)
+        .intoMenuItem([this](auto) {
+            AskInputPopup::create("Search online users", [this](auto prefix) {
+                this->searchUsers(prefix);
+            }, 16, "Start of the name", util::misc::STRING_ALPHANUMERIC, 1.f)->show();
         })
         .parent(findUserWrapper);
 
@@ -185,6 +251,58 @@ bool AdminPopup::setup() {
     return true;
 }
 
+void AdminPopup::findUsers(const std::string_view input) {
+    std::vector<std::string> queries;
+    for (auto part : util::format::split(input, ",")) {
+        auto query = util::format::trim(part);
+        if (!query.empty()) {
+            queries.push_back(std::move(query));
+        }
+    }
+
+    if (queries.empty()) return;
+
+    auto& am = AdminManager::get();
+    auto& nm = NetworkManager::get();
+
+    if (queries.size() == 1) {
+        if (auto* cached = am.getCachedUser(queries[0])) {
+            AdminUserPopup::create(cached->entry, cached->accountData)->show();
+        } else {
+            nm.send(AdminGetUserStatePacket::create(queries[0]));
+        }
+
+        return;
+    }
+
+    // everyone already in the cache is shown right away, the rest is looked up in a single packet
+    std::vector<PlayerRoomPreviewAccountData> found;
+    std::vector<std::string> uncached;
+
+    for (auto& query : queries) {
+        auto* cached = am.getCachedUser(query);
+        if (cached && cached->accountData.has_value()) {
+            found.push_back(*cached->accountData);
+        } else if (uncached.size() < AdminGetUsersPacket::MAX_PLAYERS) {
+            uncached.push_back(std::move(query));
+        }
+    }
+
+    if (uncached.empty()) {
+        AdminUserListPopup::create("Users", std::move(found))->show();
+        return;
+    }
+
+    pendingLookup = std::move(found);
+    nm.send(AdminGetUsersPacket::create(std::move(uncached)));
+}
+
+void AdminPopup::searchUsers(const std::string_view prefix) {
+    if (prefix.empty()) return;
+
+    NetworkManager::get().send(AdminSearchUsersPacket::create(prefix));
+}
+
 AdminPopup* AdminPopup::create() {
     auto ret = new AdminPopup;
     if (ret->init(POPUP_WIDTH, POPUP_HEIGHT)) {
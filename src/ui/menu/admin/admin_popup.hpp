@@ -1,6 +1,8 @@
 #pragma once
 #include <defs/all.hpp>
 
+#include <data/types/gd.hpp>
+
 class AdminPopup : public geode::Popup<> {
 public:
     static constexpr float POPUP_WIDTH = 400.f;
@@ -10,6 +12,10 @@ public:
 
 private:
     geode::InputNode *messageInput, *userInput;
+    // users found in the cache while a lookup of the others is in flight, shown together once it finishes
+    std::optional<std::vector<PlayerRoomPreviewAccountData>> pendingLookup;
 
     bool setup() override;
+    void findUsers(const std::string_view input);
+    void searchUsers(const std::string_view prefix);
 };
@@ -0,0 +1,34 @@
+#include "user_list_popup.hpp"
+
+#include <ui/menu/room/player_list_cell.hpp>
+#include <util/ui.hpp>
+
+using namespace geode::prelude;
+
+bool AdminUserListPopup::setup(std::vector<PlayerRoomPreviewAccountData>&& players) {
+    auto cells = CCArray::create();
+    for (const auto& player : players) {
+        cells->addObject(PlayerListCell::create(player, false));
+    }
+
+    auto listview = ListView::create(cells, PlayerListCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT);
+    auto* listLayer = GJCommentListLayer::create(listview, "", util::ui::BG_COLOR_BROWN, LIST_WIDTH, LIST_HEIGHT, false);
+
+    float xpos = (m_mainLayer->getScaledContentSize().width - LIST_WIDTH) / 2;
+    listLayer->setPosition({xpos, 40.f});
+    m_mainLayer->addChild(listLayer);
+
+    return true;
+}
+
+AdminUserListPopup* AdminUserListPopup::create(const std::string_view title, std::vector<PlayerRoomPreviewAccountData>&& players) {
+    auto ret = new AdminUserListPopup;
+    if (ret->init(POPUP_WIDTH, POPUP_HEIGHT, std::move(players))) {
+        ret->setTitle(std::string(title));
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <defs/all.hpp>
+
+#include <data/types/gd.hpp>
+
+// Results of an admin search or a lookup of multiple users, each row opens `AdminUserPopup` through the admin user cache
+class AdminUserListPopup : public geode::Popup<std::vector<PlayerRoomPreviewAccountData>&&> {
+public:
+    static constexpr float POPUP_WIDTH = 420.f;
+    static constexpr float POPUP_HEIGHT = 260.f;
+    static constexpr float LIST_WIDTH = 340.f;
+    static constexpr float LIST_HEIGHT = 180.f;
+
+    static AdminUserListPopup* create(const std::string_view title, std::vector<PlayerRoomPreviewAccountData>&& players);
+
+private:
+    bool setup(std::vector<PlayerRoomPreviewAccountData>&& players) override;
+};
@@ -87,7 +87,7 @@ void AdminUserPopup::onProfileLoaded() {
         .intoMenuItem([this] {
             auto& data = accountData.value();
 
-            GameLevelManager::sharedState()->storeUserName(data.userId, data.accountId, data.name);
+            GameLevelManager::sharedState()->storeUserName(data.userId, data.accountId, data.name.str());
             ProfilePage::create(data.accountId, false)->show();
         })
         .parent(nameLayout)
@@ -367,9 +367,11 @@ void AdminUserPopup::sendUpdateUser() {
     }
 
     if (!userEntry.userName.has_value()) {
-        userEntry.userName = accountData->name;
+        userEntry.userName = accountData->name.str();
     }
 
+    AdminManager::get().cacheUser(userEntry, accountData);
+
     auto& nm = NetworkManager::get();
     nm.send(AdminUpdateUserPacket::create(this->userEntry));
 }
@@ -397,6 +399,9 @@ void AdminUserPopup::getUserInfoFinished(GJUserScore* score) {
 
     userEntry.userName = score->m_userName;
 
+    // so looking them up again doesn't fetch the profile again
+    AdminManager::get().cacheUser(userEntry, accountData);
+
     this->onProfileLoaded();
 }
 
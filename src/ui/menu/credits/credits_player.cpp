@@ -6,12 +6,7 @@ bool GlobedCreditsPlayer::init(const std::string_view name, const std::string_vi
     if (!CCNode::init()) return false;
 
     this->accountId = accountId;
-
-    auto* sp = Build<GlobedSimplePlayer>::create(icons)
-        .anchorPoint({0.5f, 0.5f})
-        .zOrder(0)
-        .parent(this)
-        .collect();
+    this->icons = icons;
 
     // shadow
     auto* shadow = Build<CCSprite>::createSpriteName("shadow-thing-idk.png"_spr)
@@ -38,19 +33,29 @@ bool GlobedCreditsPlayer::init(const std::string_view name, const std::string_vi
 
     GameLevelManager::get()->storeUserName(userId, accountId, gd::string(std::string(name)));
 
-    float width = sp->getScaledContentSize().width * 1.1f;
-    float height = sp->getScaledContentSize().height * 1.1f + nameLabel->getScaledContentSize().height;
+    float width = ICON_SIZE * 1.1f;
+    float height = ICON_SIZE * 1.1f + nameLabel->getScaledContentSize().height;
 
     this->setContentSize({width, height});
 
     CCPoint delta = CCPoint{width, height} / 2;
-    sp->setPosition(sp->getPosition() + delta);
     shadow->setPosition(shadow->getPosition() + delta);
     menu->setPosition(menu->getPosition() + delta);
 
     return true;
 }
 
+void GlobedCreditsPlayer::loadIcon() {
+    if (icon) return;
+
+    Build<GlobedIconThumbnail>::create(icons)
+        .anchorPoint({0.5f, 0.5f})
+        .pos(this->getContentSize() / 2)
+        .zOrder(0)
+        .parent(this)
+        .store(icon);
+}
+
 GlobedCreditsPlayer* GlobedCreditsPlayer::create(const std::string_view name, const std::string_view nickname, int accountId, int userId, const GlobedSimplePlayer::Icons& icons) {
     auto ret = new GlobedCreditsPlayer;
     if (ret->init(name, nickname, accountId, userId, icons)) {
@@ -1,16 +1,22 @@
 #pragma once
 #include <defs/geode.hpp>
 
-#include <ui/general/simple_player.hpp>
+#include <ui/general/icon_thumbnail.hpp>
 
-// simpleplayer plus shadow and name
+// simpleplayer plus shadow and name. The icon itself is only made once `loadIcon` is called, when the player scrolls into view.
 class GlobedCreditsPlayer : public cocos2d::CCNode {
 public:
+    // space left for the icon until it's loaded, about the size of a cube
+    static constexpr float ICON_SIZE = 30.f;
 
     static GlobedCreditsPlayer* create(const std::string_view name, const std::string_view nickname, int accountId, int userId, const GlobedSimplePlayer::Icons& icons);
 
+    void loadIcon();
+
 private:
     bool init(const std::string_view name, const std::string_view nickname, int accountId, int userId, const GlobedSimplePlayer::Icons& icons);
 
     int accountId;
+    GlobedSimplePlayer::Icons icons;
+    GlobedIconThumbnail* icon = nullptr;
 };
@@ -106,6 +106,24 @@ struct matjson::Serialize<CreditsResponse> {
 };
 
 static std::optional<CreditsResponse> g_cachedResponse;
+// the response `g_cachedResponse` was parsed from
+static std::string g_cachedBody;
+// whether the credits were checked with the server this session, until then the ones saved from last time are shown
+static bool g_upToDate = false;
+
+static std::optional<CreditsResponse> parseCredits(const std::string& body, std::string& error) {
+    auto creditsDataOpt = matjson::parse(body, error);
+
+    if (creditsDataOpt && !creditsDataOpt->is<CreditsResponse>()) {
+        error = "invalid json response";
+    }
+
+    if (!creditsDataOpt || !error.empty()) {
+        return std::nullopt;
+    }
+
+    return creditsDataOpt.value().as<CreditsResponse>();
+}
 
 bool GlobedCreditsPopup::setup() {
     using Icons = GlobedSimplePlayer::Icons;
@@ -132,55 +150,100 @@ bool GlobedCreditsPopup::setup() {
             ->setAutoScale(false)
     );
 
-    // if not cached, make a request
+    auto& wrm = WebRequestManager::get();
+
+    // show the credits saved from last time right away, they are only rebuilt if the server has something newer
     if (!g_cachedResponse) {
-        auto& wrm = WebRequestManager::get();
+        if (auto body = wrm.cachedCredits()) {
+            std::string parseError;
+            if (auto credits = parseCredits(*body, parseError)) {
+                g_cachedResponse = std::move(credits);
+                g_cachedBody = std::move(*body);
+            }
+        }
+    }
+
+    if (g_cachedResponse) {
+        this->setupFromCache();
+    }
+
+    // the request is conditional, so if nothing changed the server doesn't send the credits again
+    if (!g_upToDate) {
         eventListener.bind(this, &GlobedCreditsPopup::requestCallback);
         eventListener.setFilter(wrm.fetchCredits());
-    } else {
-        // otherwise use the cached response
-        this->setupFromCache();
     }
 
+    this->scheduleUpdate();
+
     return true;
 }
 
+void GlobedCreditsPopup::update(float dt) {
+    if (unloadedPlayers.empty()) return;
+
+    auto bottomLeft = scrollLayer->convertToWorldSpace({0.f, -ICON_LOAD_MARGIN});
+    auto topRight = scrollLayer->convertToWorldSpace({LIST_WIDTH, LIST_HEIGHT + ICON_LOAD_MARGIN});
+
+    std::erase_if(unloadedPlayers, [&](GlobedCreditsPlayer* player) {
+        float y = player->convertToWorldSpace(player->getContentSize() / 2).y;
+        if (y < bottomLeft.y || y > topRight.y) return false;
+
+        player->loadIcon();
+        return true;
+    });
+}
+
 void GlobedCreditsPopup::requestCallback(WebRequestManager::Task::Event* e) {
     if (!e || !e->getValue()) return;
 
     auto result = e->getValue();
     if (result->isErr()) {
         auto err = result->unwrapErr();
+
+        // the saved credits are already shown, they will do
+        if (g_cachedResponse) {
+            log::warn("Failed to refresh credits: {} (code {})", err.message, err.code);
+            return;
+        }
+
         ErrorQueues::get().error(fmt::format("Failed to load credits.\n\nReason: <cy>{}</c> (code {})", err.message, err.code));
         return;
     }
 
     auto response = result->unwrap();
+    g_upToDate = true;
 
-    std::string parseError;
-    auto creditsDataOpt = matjson::parse(response, parseError);
-
-    if (creditsDataOpt && !creditsDataOpt->is<CreditsResponse>()) {
-        parseError = "invalid json response";
+    if (g_cachedResponse && response == g_cachedBody) {
+        return;
     }
 
-    if (!creditsDataOpt || !parseError.empty()) {
+    std::string parseError;
+    auto credits = parseCredits(response, parseError);
+
+    if (!credits) {
         FLAlertLayer::create("Error", fmt::format("Failed to parse credits response.\n\nReason: <cy>{}</c>", parseError), "Ok")->show();
         return;
     }
 
-    g_cachedResponse = creditsDataOpt.value().as<CreditsResponse>();
+    g_cachedResponse = std::move(credits);
+    g_cachedBody = std::move(response);
     this->setupFromCache();
 }
 
 void GlobedCreditsPopup::setupFromCache() {
     GLOBED_REQUIRE(g_cachedResponse, "setupFromCache called when no cached response is available");
 
+    // when the saved credits turn out to be outdated, they are replaced
+    scrollLayer->m_contentLayer->removeAllChildren();
+    unloadedPlayers.clear();
+
 #define ADD_PLAYER(array, obj) \
-    array->addObject( \
-        GlobedCreditsPlayer::create(obj.gameName, obj.name, obj.accountId, obj.userId, \
-            GlobedSimplePlayer::Icons(obj.iconId, obj.color1, obj.color2, obj.color3)) \
-    )
+    do { \
+        auto* player = GlobedCreditsPlayer::create(obj.gameName, obj.name, obj.accountId, obj.userId, \
+            GlobedSimplePlayer::Icons(obj.iconId, obj.color1, obj.color2, obj.color3)); \
+        array->addObject(player); \
+        unloadedPlayers.push_back(player); \
+    } while (0)
 
     /* Owner */
 
@@ -3,23 +3,29 @@
 
 #include <managers/web.hpp>
 
+class GlobedCreditsPlayer;
+
 class GlobedCreditsPopup : public geode::Popup<> {
 public:
     static constexpr float POPUP_WIDTH = 380.f;
     static constexpr float POPUP_HEIGHT = 250.f;
     static constexpr float LIST_WIDTH = 340.f;
     static constexpr float LIST_HEIGHT = 190.f;
+    // players this far outside the list get their icons too, so they are already there when scrolled to
+    static constexpr float ICON_LOAD_MARGIN = 40.f;
 
     static GlobedCreditsPopup* create();
 
 protected:
     WebRequestManager::Listener eventListener;
     geode::ScrollLayer* scrollLayer;
+    std::vector<GlobedCreditsPlayer*> unloadedPlayers;
 
     void requestCallback(WebRequestManager::Task::Event* e);
     void setupFromCache();
 
     bool setup() override;
+    void update(float dt) override;
 
     cocos2d::CCArray* createCells();
 };
@@ -71,29 +71,61 @@ bool GlobedLevelListLayer::init() {
 
     util::ui::prepareLayer(this);
 
-    NetworkManager::get().addListener<LevelListPacket>(this, [this](std::shared_ptr<LevelListPacket> packet) {
-        this->levelList.clear();
-        this->levelPages.clear();
-        this->sortedLevelIds.clear();
-
-        for (const auto& level : packet->levels) {
-            this->levelList.emplace(level.levelId, level.playerCount);
-            this->sortedLevelIds.push_back(level.levelId);
+    NetworkManager::get().addListener<LevelListPacket>(this, [this](LevelListPacket& packet) {
+        // chunks still arriving from before a refresh would get mixed into the new list
+        if (!this->receivingLevels || packet.requestId != this->requestId) return;
+
+        if (this->resetOnNextList) {
+            this->resetOnNextList = false;
+            this->levelList.clear();
+            this->sortedLevelIds.clear();
+            this->firstPageShown = false;
         }
 
-        // sort the levels
-        auto comparator = [this](int a, int b) {
-            if (!this->levelList.contains(a) || !this->levelList.contains(b)) return false;
+        // the server already sorts the levels, so each chunk just gets appended
+        for (const auto& level : packet.levels) {
+            if (this->levelList.emplace(level.levelId, level.playerCount).second) {
+                this->sortedLevelIds.push_back(level.levelId);
+            }
+        }
 
-            auto aVal = this->levelList.at(a);
-            auto bVal = this->levelList.at(b);
+        this->receivingLevels = !packet.isFinal;
+        if (packet.isFinal) {
+            this->listVersion = packet.version;
+        }
 
-            return aVal > bVal;
-        };
+        // show the first page as soon as it's complete, rest of the list can keep arriving in the background
+        if (!this->firstPageShown && (sortedLevelIds.size() >= this->getPageSize() || packet.isFinal)) {
+            this->firstPageShown = true;
+            this->currentPage = 0;
+            this->reloadPage();
+        } else if (!this->loading && this->hasNextPage()) {
+            btnPageNext->setVisible(true);
+            this->prefetchPages();
+        }
+    });
 
-        std::sort(sortedLevelIds.begin(), sortedLevelIds.end(), comparator);
+    NetworkManager::get().addListener<LevelListDeltaPacket>(this, [this](LevelListDeltaPacket& packet) {
+        if (!this->receivingLevels || packet.requestId != this->requestId) return;
 
-        this->currentPage = 0;
+        // we don't have the list this delta was made against, start over
+        if (packet.baseVersion != this->listVersion) {
+            this->requestLevelList(0);
+            return;
+        }
+
+        for (const auto& level : packet.changes) {
+            this->setPlayerCount(level.levelId, level.playerCount);
+        }
+
+        this->listVersion = packet.version;
+        this->receivingLevels = false;
+        this->resetOnNextList = false;
+
+        // stay on the same page if it still exists
+        size_t pageSize = this->getPageSize();
+        size_t pageCount = std::max<size_t>((sortedLevelIds.size() + pageSize - 1) / pageSize, 1);
+        this->currentPage = std::min<int>(this->currentPage, pageCount - 1);
         this->reloadPage();
     });
 
@@ -114,52 +146,81 @@ void GlobedLevelListLayer::reloadPage() {
     btnPagePrev->setVisible(false);
     btnPageNext->setVisible(false);
 
-    // if empty, don't make a request
-    if (levelList.empty()) {
-        this->loadLevelsFinished(CCArray::create(), "");
-        return;
+    // if every level is cached (or the list is empty), don't make a request.
+    // if a fetch is already running, the page is shown or fetched once it finishes
+    if (fetchingPage == -1 && !this->fetchPage(currentPage)) {
+        this->showPage();
     }
+}
 
-    // if cached, reuse it
-    if (currentPage < levelPages.size()) {
-        auto& page = levelPages.at(currentPage);
-        auto array = CCArray::create();
-        for (const auto elem : page) {
-            array->addObject(elem);
-        }
+std::vector<LevelId> GlobedLevelListLayer::missingLevels(int page) {
+    size_t pageSize = this->getPageSize();
 
-        this->loadLevelsFinished(array, "");
-        return;
-    }
+    size_t startIdx = std::min(page * pageSize, sortedLevelIds.size());
+    size_t endIdx = std::min((page + 1) * pageSize, sortedLevelIds.size());
 
-    size_t pageSize = settings.globed.increaseLevelList ? INCREASED_LIST_PAGE_SIZE : LIST_PAGE_SIZE;
+    std::vector<LevelId> out;
+    for (size_t i = startIdx; i < endIdx; i++) {
+        LevelId id = sortedLevelIds[i];
+        if (!levelCache.contains(id) && !unavailableLevels.contains(id)) {
+            out.push_back(id);
+        }
+    }
 
-    size_t startIdx = currentPage * pageSize;
-    size_t endIdx = std::min((currentPage + 1) * pageSize, sortedLevelIds.size());
+    return out;
+}
 
-    // now join them to a comma separated string
-    std::ostringstream oss;
+bool GlobedLevelListLayer::fetchPage(int page) {
+    if (page < 0) return false;
 
-    bool first = true;
-    for (size_t i = startIdx; i < endIdx; i++) {
-        if (first) {
-            first = false;
-        } else {
-            oss << ",";
-        }
+    auto missing = this->missingLevels(page);
+    if (missing.empty()) return false;
 
-        oss << sortedLevelIds[i];
+    // now join them to a comma separated string
+    std::string query;
+    for (LevelId id : missing) {
+        if (!query.empty()) query += ',';
+        query += std::to_string(id);
     }
 
+    fetchingPage = page;
+    fetchingLevels = std::move(missing);
+
     auto glm = GameLevelManager::sharedState();
     glm->m_levelManagerDelegate = this;
-    glm->getOnlineLevels(GJSearchObject::create((SearchType)26, oss.str()));
+    glm->getOnlineLevels(GJSearchObject::create((SearchType)26, query));
+
+    return true;
+}
+
+void GlobedLevelListLayer::prefetchPages() {
+    if (fetchingPage != -1) return;
+
+    // fetch the neighbouring pages in the background, so turning a page doesn't have to wait for the GD servers.
+    // pages that are still arriving aren't prefetched, their levels aren't known yet
+    if (this->hasNextPage() && this->fetchPage(currentPage + 1)) return;
+    this->fetchPage(currentPage - 1);
+}
+
+void GlobedLevelListLayer::onFetchFinished() {
+    fetchingPage = -1;
+    fetchingLevels.clear();
+    GameLevelManager::sharedState()->m_levelManagerDelegate = nullptr;
+
+    if (!loading) {
+        this->prefetchPages();
+    } else if (!firstPageShown) {
+        // the list was refreshed in the meantime, the first page gets loaded once it arrives
+        return;
+    } else if (!this->fetchPage(currentPage)) {
+        // the page that finished was either the current one, or a prefetch that the current page was waiting on
+        this->showPage();
+    }
 }
 
 void GlobedLevelListLayer::loadListCommon() {
     loading = false;
     this->removeLoadingCircle();
-    GameLevelManager::sharedState()->m_levelManagerDelegate = nullptr;
 }
 
 void GlobedLevelListLayer::removeLoadingCircle() {
@@ -185,40 +246,21 @@ void GlobedLevelListLayer::showLoadingUi() {
         .collect();
 }
 
-void GlobedLevelListLayer::loadLevelsFinished(cocos2d::CCArray* p0, char const* p1, int p2) {
+void GlobedLevelListLayer::showPage() {
     this->loadListCommon();
 
-    // guys im not gonna try and sort a ccarray manually
-
-    std::vector<Ref<GJGameLevel>> sortedLevels;
-    sortedLevels.reserve(p0->count());
-
-    for (GJGameLevel* level : CCArrayExt<GJGameLevel*>(p0)) {
-        sortedLevels.push_back(level);
-    }
-
-    // compare by player count (descending)
-    auto comparator = [this](GJGameLevel* a, GJGameLevel* b) {
-        LevelId levelIdA = HookedGJGameLevel::getLevelIDFrom(a);
-        LevelId levelIdB = HookedGJGameLevel::getLevelIDFrom(b);
-        if (!this->levelList.contains(levelIdA) || !this->levelList.contains(levelIdB)) return false;
-
-        auto aVal = this->levelList.at(levelIdA);
-        auto bVal = this->levelList.at(levelIdB);
+    size_t pageSize = this->getPageSize();
 
-        return aVal > bVal;
-    };
-
-    std::sort(sortedLevels.begin(), sortedLevels.end(), comparator);
-
-    // add to cache
-    if (levelPages.size() <= currentPage) {
-        levelPages.push_back(sortedLevels);
-    }
+    size_t startIdx = std::min(currentPage * pageSize, sortedLevelIds.size());
+    size_t endIdx = std::min((currentPage + 1) * pageSize, sortedLevelIds.size());
 
+    // the server sorts levels by player count, so the page is already in order
     CCArray* finalArray = CCArray::create();
-    for (GJGameLevel* level : sortedLevels) {
-        finalArray->addObject(level);
+    for (size_t i = startIdx; i < endIdx; i++) {
+        auto it = levelCache.find(sortedLevelIds[i]);
+        if (it != levelCache.end()) {
+            finalArray->addObject(it->second);
+        }
     }
 
     if (listLayer->m_listView) listLayer->m_listView->removeFromParent();
@@ -239,16 +281,38 @@ void GlobedLevelListLayer::loadLevelsFinished(cocos2d::CCArray* p0, char const*
         btnPagePrev->setVisible(true);
     }
 
-    size_t pageSize = settings.globed.increaseLevelList ? INCREASED_LIST_PAGE_SIZE : LIST_PAGE_SIZE;
-
-    if (currentPage < (sortedLevelIds.size() / pageSize)) {
+    if (this->hasNextPage()) {
         btnPageNext->setVisible(true);
     }
+
+    this->prefetchPages();
+}
+
+void GlobedLevelListLayer::loadLevelsFinished(cocos2d::CCArray* p0, char const* p1, int p2) {
+    for (GJGameLevel* level : CCArrayExt<GJGameLevel*>(p0)) {
+        levelCache[HookedGJGameLevel::getLevelIDFrom(level)] = level;
+    }
+
+    for (LevelId id : fetchingLevels) {
+        if (!levelCache.contains(id)) {
+            unavailableLevels.insert(id);
+        }
+    }
+
+    this->onFetchFinished();
 }
 
 void GlobedLevelListLayer::loadLevelsFailed(char const* p0, int p1) {
-    this->loadListCommon();
     log::warn("failed to load levels: {}, {}", p1, p0);
+
+    fetchingPage = -1;
+    fetchingLevels.clear();
+    GameLevelManager::sharedState()->m_levelManagerDelegate = nullptr;
+
+    // show whatever is cached, the refresh button can be used to try again
+    if (loading) {
+        this->showPage();
+    }
 }
 
 void GlobedLevelListLayer::loadLevelsFinished(cocos2d::CCArray* p0, char const* p1) {
@@ -268,16 +332,76 @@ void GlobedLevelListLayer::refreshLevels() {
     btnPagePrev->setVisible(false);
     btnPageNext->setVisible(false);
 
-    auto& nm = NetworkManager::get();
-    if (!nm.established()) return;
+    if (!NetworkManager::get().established()) return;
 
-    // request the level list from the server
-    nm.send(RequestLevelListPacket::create());
+    // if we have the whole list, the server only has to send what changed since
+    this->requestLevelList(receivingLevels ? 0 : listVersion);
 
     // remove existing listview and put a loading circle
     this->showLoadingUi();
 }
 
+void GlobedLevelListLayer::requestLevelList(uint32_t knownVersion) {
+    // fetched levels stay cached either way, so a refresh only has to fetch the levels that weren't on the list before
+    unavailableLevels.clear();
+    receivingLevels = true;
+
+    if (knownVersion == 0) {
+        levelList.clear();
+        sortedLevelIds.clear();
+        firstPageShown = false;
+        resetOnNextList = false;
+    } else {
+        resetOnNextList = true;
+    }
+
+    NetworkManager::get().send(RequestLevelListPacket::create(knownVersion, ++requestId));
+}
+
+void GlobedLevelListLayer::setPlayerCount(LevelId id, unsigned short count) {
+    // `sortedLevelIds` is ordered by player count (descending), so levels are found and placed with a binary search
+    auto countOf = [this](LevelId level) { return levelList.at(level); };
+
+    auto it = levelList.find(id);
+    if (it != levelList.end()) {
+        unsigned short oldCount = it->second;
+        auto first = std::lower_bound(sortedLevelIds.begin(), sortedLevelIds.end(), oldCount, [&](LevelId level, unsigned short c) {
+            return countOf(level) > c;
+        });
+
+        auto pos = std::find(first, sortedLevelIds.end(), id);
+        if (pos != sortedLevelIds.end()) {
+            sortedLevelIds.erase(pos);
+        }
+
+        levelList.erase(it);
+    }
+
+    if (count == 0) return;
+
+    auto pos = std::upper_bound(sortedLevelIds.begin(), sortedLevelIds.end(), count, [&](unsigned short c, LevelId level) {
+        return c > countOf(level);
+    });
+
+    sortedLevelIds.insert(pos, id);
+    levelList.emplace(id, count);
+}
+
+size_t GlobedLevelListLayer::getPageSize() {
+    return settings.globed.increaseLevelList ? INCREASED_LIST_PAGE_SIZE : LIST_PAGE_SIZE;
+}
+
+bool GlobedLevelListLayer::hasNextPage() {
+    size_t pageSize = this->getPageSize();
+
+    // while the list is still arriving, only allow going to pages that are already complete
+    if (receivingLevels) {
+        return (currentPage + 2) * pageSize <= sortedLevelIds.size();
+    }
+
+    return currentPage < (sortedLevelIds.size() / pageSize);
+}
+
 void GlobedLevelListLayer::keyBackClicked() {
     util::ui::navigateBack();
 }
@@ -19,14 +19,33 @@ private:
     CCMenuItemSpriteExtra *btnPagePrev = nullptr, *btnPageNext = nullptr;
     std::unordered_map<LevelId, unsigned short> levelList;
     std::vector<LevelId> sortedLevelIds;
-    std::vector<std::vector<Ref<GJGameLevel>>> levelPages;
+    // every level fetched while the layer is open, kept across refreshes so only new levels have to be fetched
+    std::unordered_map<LevelId, Ref<GJGameLevel>> levelCache;
+    // levels that the GD servers didn't return (e.g. deleted ones), so they aren't requested over and over
+    std::unordered_set<LevelId> unavailableLevels;
+    std::vector<LevelId> fetchingLevels;
+    int fetchingPage = -1; // page that is being fetched from the GD servers, -1 if none
     int currentPage = 0;
     bool loading = false;
+    bool receivingLevels = false; // more `LevelListPacket`s are expected
+    bool firstPageShown = false;
+    bool resetOnNextList = false; // asked for a delta, but the server can still answer with the full list
+    uint32_t listVersion = 0;
+    uint32_t requestId = 0; // of the last `RequestLevelListPacket`, responses to older ones are dropped
 
     bool init() override;
     void keyBackClicked() override;
     void refreshLevels();
+    void requestLevelList(uint32_t knownVersion);
+    void setPlayerCount(LevelId id, unsigned short count);
     void reloadPage();
+    void showPage();
+    bool fetchPage(int page);
+    void prefetchPages();
+    std::vector<LevelId> missingLevels(int page);
+    void onFetchFinished();
+    size_t getPageSize();
+    bool hasNextPage();
 
     void loadListCommon();
     void removeLoadingCircle();
@@ -14,6 +14,7 @@ constexpr int TAG_PRIVATE = 1021;
 constexpr int TAG_OPEN_INV = 1022;
 constexpr int TAG_COLLISION = 1023;
 constexpr int TAG_2P = 1024;
+constexpr int TAG_LIMIT_SPEAKERS = 1025;
 
 bool CreateRoomPopup::setup(RoomLayer* parent) {
     this->setTitle("Create Room", "goldFont.fnt", 1.0f);
@@ -145,6 +146,7 @@ bool CreateRoomPopup::setup(RoomLayer* parent) {
         {"Private Room", TAG_PRIVATE},
         {"Open Invites", TAG_OPEN_INV},
         {"Collision", TAG_COLLISION},
+        {"Limit Speakers", TAG_LIMIT_SPEAKERS},
         // {"2-Player Mode", TAG_2P},
     });
 
@@ -206,6 +208,7 @@ void CreateRoomPopup::onCheckboxToggled(cocos2d::CCObject* p) {
         case TAG_COLLISION: settingFlags.collision = state; break;
         case TAG_OPEN_INV: settingFlags.publicInvites = state; break;
         case TAG_PRIVATE: settingFlags.isHidden = state; break;
+        case TAG_LIMIT_SPEAKERS: settingFlags.limitSpeakers = state; break;
     }
 }
 
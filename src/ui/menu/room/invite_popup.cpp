@@ -27,14 +27,29 @@ bool InvitePopup::setup() {
 
     auto& rm = RoomManager::get();
 
-    nm.addListener<GlobalPlayerListPacket>(this, [this](std::shared_ptr<GlobalPlayerListPacket> packet) {
+    paged = nm.serverMatchesProtocol();
+    pageStarts.assign(1, PageCursor{});
+
+    nm.addListener<GlobalPlayerListPacket>(this, [this](GlobalPlayerListPacket& packet) {
         this->isWaiting = false;
-        this->playerList = packet->data;
+        this->playerList = packet.data;
+        this->searchPrefix.clear();
         this->applyFilter("");
         this->sortPlayerList();
         this->onLoaded(!roomBtnMenu);
     });
 
+    nm.addListener<PlayerListPagePacket>(this, [this](PlayerListPagePacket& packet) {
+        // a newer request is still on the way, this page is already outdated
+        if (this->pendingPages == 0 || --this->pendingPages != 0) return;
+
+        this->playerList = packet.players;
+        this->hasMorePages = packet.hasMore;
+        this->applyFilter(searchPrefix);
+        this->onLoaded(!roomBtnMenu, false);
+        this->updatePageButtons();
+    });
+
     auto popupLayout = util::ui::getPopupLayout(m_size);
 
     auto listview = ListView::create(CCArray::create(), PlayerListCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT);
@@ -44,6 +59,58 @@ bool InvitePopup::setup() {
     listLayer->setPosition({xpos, 85.f});
     m_mainLayer->addChild(listLayer);
 
+    Build<CCMenu>::create()
+        .pos(0.f, 0.f)
+        .contentSize(m_size)
+        .id("page-btn-menu"_spr)
+        .parent(m_mainLayer)
+        .store(pageBtnMenu);
+
+    Build<CCSprite>::createSpriteName("GJ_arrow_03_001.png")
+        .scale(0.6f)
+        .intoMenuItem([this](auto) {
+            this->changePage(false);
+        })
+        .pos(xpos - 18.f, 85.f + LIST_HEIGHT / 2.f)
+        .id("prev-page-btn"_spr)
+        .parent(pageBtnMenu)
+        .store(prevPageButton);
+
+    Build<CCSprite>::createSpriteName("GJ_arrow_03_001.png")
+        .scale(0.6f)
+        .with([](auto* spr) {
+            spr->setFlipX(true);
+        })
+        .intoMenuItem([this](auto) {
+            this->changePage(true);
+        })
+        .pos(xpos + LIST_WIDTH + 18.f, 85.f + LIST_HEIGHT / 2.f)
+        .id("next-page-btn"_spr)
+        .parent(pageBtnMenu)
+        .store(nextPageButton);
+
+    this->updatePageButtons();
+
+    // friends only toggle
+    auto* friendsMenu = Build<CCMenu>::create()
+        .layout(RowLayout::create()->setGap(5.f)->setAxisAlignment(AxisAlignment::Start))
+        .anchorPoint(0.f, 0.5f)
+        .pos(xpos, 70.f)
+        .contentSize(LIST_WIDTH, 20.f)
+        .id("friends-only-menu"_spr)
+        .parent(m_mainLayer)
+        .collect();
+
+    Build(CCMenuItemToggler::createWithStandardSprites(this, menu_selector(InvitePopup::onFriendsOnly), 0.5f))
+        .id("friends-only-btn"_spr)
+        .parent(friendsMenu);
+
+    Build<CCLabelBMFont>::create("Friends only", "bigFont.fnt")
+        .scale(0.35f)
+        .parent(friendsMenu);
+
+    friendsMenu->updateLayout();
+
     this->reloadPlayerList();
 
     Build<CCSprite>::createSpriteName("GJ_updateBtn_001.png")
@@ -72,9 +139,7 @@ bool InvitePopup::setup() {
     Build<CCSprite>::createSpriteName("gj_findBtn_001.png")
         .intoMenuItem([this](auto) {
             AskInputPopup::create("Search Player", [this](const std::string_view input) {
-                this->applyFilter(input);
-                this->sortPlayerList();
-                this->onLoaded(true);
+                this->setSearch(input);
             }, 16, "Username", util::misc::STRING_ALPHANUMERIC, 3.f)->show();
         })
         .scaleMult(1.1f)
@@ -85,9 +150,7 @@ bool InvitePopup::setup() {
     // clear search button
     Build<CCSprite>::createSpriteName("gj_findBtnOff_001.png")
         .intoMenuItem([this](auto) {
-            this->applyFilter("");
-            this->sortPlayerList();
-            this->onLoaded(true);
+            this->setSearch("");
         })
         .scaleMult(1.1f)
         .id("search-clear-btn"_spr)
@@ -98,7 +161,7 @@ bool InvitePopup::setup() {
     return true;
 }
 
-void InvitePopup::onLoaded(bool stateChanged) {
+void InvitePopup::onLoaded(bool stateChanged, bool keepScroll) {
     this->removeLoadingCircle();
 
     auto cells = CCArray::create();
@@ -117,7 +180,7 @@ void InvitePopup::onLoaded(bool stateChanged) {
         .parent(listLayer)
         .collect();
 
-    if (previousCellCount != 0 && !stateChanged) {
+    if (previousCellCount != 0 && !stateChanged && keepScroll) {
         util::ui::setScrollPos(listLayer->m_list, scrollPos);
     }
 
@@ -165,7 +228,9 @@ void InvitePopup::reloadPlayerList(bool sendPacket) {
     this->removeLoadingCircle();
 
     // send the request
-    if (sendPacket) {
+    if (sendPacket && paged) {
+        this->requestPage();
+    } else if (sendPacket) {
         if (!isWaiting) {
             NetworkManager::get().send(RequestGlobalPlayerListPacket::create());
             isWaiting = true;
@@ -179,6 +244,77 @@ void InvitePopup::reloadPlayerList(bool sendPacket) {
     loadingCircle->show();
 }
 
+void InvitePopup::requestPage() {
+    auto packet = RequestPlayerListPagePacket::create();
+    packet->namePrefix = searchPrefix;
+    packet->afterName = pageStarts.back().name;
+    packet->afterId = pageStarts.back().accountId;
+    packet->limit = PAGE_SIZE;
+
+    // past the limit the server is asked for everyone and `applyFilter` drops the non friends, so pages may come back short
+    const auto& friends = FriendListManager::get().getFriends();
+    if (friendsOnly && !friends.empty() && friends.size() <= RequestPlayerListPagePacket::MAX_IDS) {
+        packet->onlyIds.assign(friends.begin(), friends.end());
+    }
+
+    NetworkManager::get().send(packet);
+    pendingPages++;
+}
+
+void InvitePopup::changePage(bool forward) {
+    if (!paged || this->isLoading()) return;
+
+    if (forward) {
+        if (!hasMorePages || playerList.empty()) return;
+
+        const auto& last = playerList.back();
+        pageStarts.push_back(PageCursor{last.name, last.accountId});
+    } else {
+        if (pageStarts.size() <= 1) return;
+
+        pageStarts.pop_back();
+    }
+
+    this->reloadPlayerList();
+    this->updatePageButtons();
+}
+
+void InvitePopup::updatePageButtons() {
+    prevPageButton->setVisible(paged && pageStarts.size() > 1);
+    nextPageButton->setVisible(paged && hasMorePages);
+}
+
+void InvitePopup::onFriendsOnly(cocos2d::CCObject* sender) {
+    friendsOnly = !static_cast<CCMenuItemToggler*>(sender)->isOn();
+
+    if (paged) {
+        pageStarts.assign(1, PageCursor{});
+        this->reloadPlayerList();
+    } else {
+        this->applyFilter(searchPrefix);
+        this->sortPlayerList();
+        this->onLoaded(true);
+    }
+
+    this->updatePageButtons();
+}
+
+void InvitePopup::setSearch(std::string_view input) {
+    searchPrefix = input;
+
+    // the server does the matching, by name prefix
+    if (paged) {
+        pageStarts.assign(1, PageCursor{});
+        this->reloadPlayerList();
+        this->updatePageButtons();
+        return;
+    }
+
+    this->applyFilter(input);
+    this->sortPlayerList();
+    this->onLoaded(true);
+}
+
 bool InvitePopup::isLoading() {
     return loadingCircle != nullptr;
 }
@@ -200,7 +336,7 @@ void InvitePopup::sortPlayerList() {
             return isFriend1;
         } else {
             // convert both names to lowercase
-            std::string name1 = p1.name, name2 = p2.name;
+            std::string name1 = p1.name.str(), name2 = p2.name.str();
             std::transform(name1.begin(), name1.end(), name1.begin(), ::tolower);
             std::transform(name2.begin(), name2.end(), name2.begin(), ::tolower);
 
@@ -211,25 +347,36 @@ void InvitePopup::sortPlayerList() {
 }
 
 void InvitePopup::applyFilter(const std::string_view input) {
+    auto& flm = FriendListManager::get();
+
     filteredPlayerList.clear();
 
-    if (input.empty()) {
+    // pages already only have the matching players, unless there were too many friends to send to the server
+    if (input.empty() || paged) {
         for (const auto& item : playerList) {
+            if (friendsOnly && !flm.isFriend(item.accountId)) continue;
+
             filteredPlayerList.push_back(item);
         }
 
-        clearSearchButton->removeFromParent();
-        return;
-    }
+        if (input.empty()) {
+            clearSearchButton->removeFromParent();
+            return;
+        }
+    } else {
+        auto filt = util::format::toLowercase(input);
 
-    auto filt = util::format::toLowercase(input);
+        for (const auto& item : playerList) {
+            if (friendsOnly && !flm.isFriend(item.accountId)) continue;
 
-    for (const auto& item : playerList) {
-        auto name = util::format::toLowercase(item.name);
-        if (name.find(filt) != std::string::npos) {
-            filteredPlayerList.push_back(item);
+            auto name = util::format::toLowercase(item.name);
+            if (name.find(filt) != std::string::npos) {
+                filteredPlayerList.push_back(item);
+            }
         }
     }
+
+    clearSearchButton->removeFromParent();
     buttonMenu->addChild(clearSearchButton);
     buttonMenu->updateLayout();
 }
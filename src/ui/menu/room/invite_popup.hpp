@@ -8,13 +8,30 @@ public:
     constexpr static float POPUP_HEIGHT = 280.f;
     constexpr static float LIST_WIDTH = 340.f;
     constexpr static float LIST_HEIGHT = 180.f;
+    constexpr static uint16_t PAGE_SIZE = 50;
 
     static InvitePopup* create();
 
 protected:
+    // where a page of the list starts, the page holds the players after this one
+    struct PageCursor {
+        PlayerName name;
+        int accountId = 0;
+    };
+
+    // when the server supports it only the current page is kept, otherwise this is the whole list
     std::vector<PlayerPreviewAccountData> playerList;
     std::vector<PlayerPreviewAccountData> filteredPlayerList;
 
+    bool paged = false;
+    std::vector<PageCursor> pageStarts; // one per page up to the current one, going back pops it
+    bool hasMorePages = false;
+    size_t pendingPages = 0; // only the response to the last request is shown
+    std::string searchPrefix;
+    bool friendsOnly = false;
+    cocos2d::CCMenu* pageBtnMenu = nullptr;
+    CCMenuItemSpriteExtra *prevPageButton = nullptr, *nextPageButton = nullptr;
+
     LoadingCircle* loadingCircle = nullptr;
     GJCommentListLayer* listLayer = nullptr;
     cocos2d::CCMenu* buttonMenu;
@@ -24,9 +41,14 @@ protected:
     bool isWaiting = false;
 
     bool setup() override;
-    void onLoaded(bool stateChanged);
+    void onLoaded(bool stateChanged, bool keepScroll = true);
     void removeLoadingCircle();
     void reloadPlayerList(bool sendPacket = true);
+    void requestPage();
+    void changePage(bool forward);
+    void updatePageButtons();
+    void onFriendsOnly(cocos2d::CCObject* sender);
+    void setSearch(std::string_view input);
     void addButtons();
     bool isLoading();
     void sortPlayerList();
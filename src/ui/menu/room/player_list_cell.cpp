@@ -11,13 +11,26 @@
 
 using namespace geode::prelude;
 
-bool PlayerListCell::init(const PlayerRoomPreviewAccountData& data, bool forInviting) {
+bool PlayerListCell::init(bool forInviting) {
     if (!CCLayer::init()) return false;
+    this->forInviting = forInviting;
+
+    return true;
+}
+
+void PlayerListCell::setData(const PlayerRoomPreviewAccountData& data) {
+    if (hasData && this->data == data) return;
+
     this->data = data;
+    this->hasData = true;
 
-    auto* gm = GameManager::get();
+    // the invite cooldown belongs to the previous player
+    this->stopAllActions();
+    this->removeAllChildren();
+    playButton = nullptr;
+    inviteButton = nullptr;
 
-    Build<GlobedSimplePlayer>::create(GlobedSimplePlayer::Icons(data))
+    Build<GlobedIconThumbnail>::create(GlobedSimplePlayer::Icons(data))
         .scale(0.65f)
         .parent(this)
         .anchorPoint(0.5f, 0.5f)
@@ -81,8 +94,6 @@ bool PlayerListCell::init(const PlayerRoomPreviewAccountData& data, bool forInvi
     if (AdminManager::get().authorized()) {
         this->createAdminButton();
     }
-
-    return true;
 }
 
 void PlayerListCell::createInviteButton() {
@@ -170,13 +181,22 @@ void PlayerListCell::createAdminButton() {
 }
 
 void PlayerListCell::onOpenProfile(cocos2d::CCObject*) {
-    GameLevelManager::sharedState()->storeUserName(data.userId, data.accountId, data.name);
+    GameLevelManager::sharedState()->storeUserName(data.userId, data.accountId, data.name.str());
     ProfilePage::create(data.accountId, false)->show();
 }
 
 PlayerListCell* PlayerListCell::create(const PlayerRoomPreviewAccountData& data, bool forInviting) {
+    auto ret = create(forInviting);
+    if (ret) {
+        ret->setData(data);
+    }
+
+    return ret;
+}
+
+PlayerListCell* PlayerListCell::create(bool forInviting) {
     auto ret = new PlayerListCell;
-    if (ret->init(data, forInviting)) {
+    if (ret->init(forInviting)) {
         ret->autorelease();
         return ret;
     }
@@ -2,16 +2,21 @@
 #include <defs/all.hpp>
 #include <data/types/gd.hpp>
 
-#include <ui/general/simple_player.hpp>
+#include <ui/general/icon_thumbnail.hpp>
 
 class PlayerListCell : public cocos2d::CCLayer {
 public:
     static constexpr float CELL_HEIGHT = 30.0f;
 
     static PlayerListCell* create(const PlayerRoomPreviewAccountData& data, bool forInviting);
+    // Empty cell, meant to be filled in with `setData` by a list that reuses its cells
+    static PlayerListCell* create(bool forInviting);
+
+    // Rebuilds the cell for another player, does nothing if the data did not change
+    void setData(const PlayerRoomPreviewAccountData& data);
 
 protected:
-    bool init(const PlayerRoomPreviewAccountData& data, bool forInviting);
+    bool init(bool forInviting);
     void onOpenProfile(cocos2d::CCObject*);
 
     void createInviteButton();
@@ -22,8 +27,10 @@ protected:
     void enableInvites();
 
     PlayerRoomPreviewAccountData data;
+    bool forInviting = false;
+    bool hasData = false;
 
-    cocos2d::CCMenu* menu;
+    cocos2d::CCMenu* menu = nullptr;
     CCMenuItemSpriteExtra *playButton = nullptr, *inviteButton = nullptr;
-    GlobedSimplePlayer* simplePlayer;
+    GlobedIconThumbnail* simplePlayer = nullptr;
 };
\ No newline at end of file
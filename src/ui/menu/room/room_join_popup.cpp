@@ -46,8 +46,8 @@ bool RoomJoinPopup::setup() {
             // test packet to check if pass needed (or just joining the room)
             NetworkManager::get().send(JoinRoomPacket::create(code, ""));
 
-            nm.addListener<RoomJoinFailedPacket>(this, [this, code](std::shared_ptr<RoomJoinFailedPacket> packet) {
-                if (packet->wasProtected) {
+            nm.addListener<RoomJoinFailedPacket>(this, [this, code](RoomJoinFailedPacket& packet) {
+                if (packet.wasProtected) {
                     Loader::get()->queueInMainThread([this, code] {
                         RoomPasswordPopup::create(code)->show();
                         this->onClose(nullptr);
@@ -55,7 +55,7 @@ bool RoomJoinPopup::setup() {
                 }
             });
 
-            nm.addListener<RoomJoinedPacket>(this, [this](std::shared_ptr<RoomJoinedPacket> packet) {
+            nm.addListener<RoomJoinedPacket>(this, [this](RoomJoinedPacket& packet) {
                 this->onClose(nullptr);
             });
 
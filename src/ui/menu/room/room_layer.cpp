@@ -15,7 +15,6 @@
 #include <managers/room.hpp>
 #include <ui/general/ask_input_popup.hpp>
 #include <util/ui.hpp>
-#include <util/cocos.hpp>
 #include <util/misc.hpp>
 #include <util/format.hpp>
 
@@ -41,51 +40,76 @@ bool RoomLayer::init() {
 
     auto& rm = RoomManager::get();
 
-    nm.addListener<RoomPlayerListPacket>(this, [this](std::shared_ptr<RoomPlayerListPacket> packet) {
+    nm.addListener<RoomPlayerListPacket>(this, [this](RoomPlayerListPacket& packet) {
         this->isWaiting = false;
-        this->playerList = packet->players;
+        auto& rm = RoomManager::get();
+        bool changed = rm.getId() != packet.info.id;
+        rm.setInfo(packet.info);
+        rm.setPlayers(packet.version, std::move(packet.players));
+        this->playerList = rm.getPlayers();
         this->applyFilter("");
         this->sortPlayerList();
-        auto& rm = RoomManager::get();
-        bool changed = rm.getId() != packet->info.id;
-        rm.setInfo(packet->info);
         this->onLoaded(changed || !roomBtnMenu);
     });
 
-    nm.addListener<RoomJoinedPacket>(this, [this](auto) {
+    nm.addListener<RoomPlayersDiffPacket>(this, [this](RoomPlayersDiffPacket& packet) {
+        auto& rm = RoomManager::get();
+
+        switch (rm.applyDiff(packet.version, packet.updated, packet.removed)) {
+            case RoomManager::DiffResult::Applied: break;
+            case RoomManager::DiffResult::Outdated: return;
+            case RoomManager::DiffResult::Gap: {
+                this->reloadPlayerList(true);
+                return;
+            }
+        }
+
+        // keep the search, `updateList` then only rebuilds the rows that changed
+        this->playerList = rm.getPlayers();
+        this->applyFilter(filterInput);
+        this->sortPlayerList();
+        this->onLoaded(false);
+    });
+
+    nm.addListener<RoomJoinedPacket>(this, [this](auto&) {
         this->reloadPlayerList(true);
     });
 
-    nm.addListener<RoomCreatedPacket>(this, [this](std::shared_ptr<RoomCreatedPacket> packet) {
+    nm.addListener<RoomCreatedPacket>(this, [this](RoomCreatedPacket& packet) {
         auto ownData = ProfileCacheManager::get().getOwnData();
         auto ownSpecialData = ProfileCacheManager::get().getOwnSpecialData();
 
         auto* gjam = GJAccountManager::sharedState();
 
-        this->playerList = {PlayerRoomPreviewAccountData(
+        auto& rm = RoomManager::get();
+        rm.setInfo(packet.info);
+
+        // a new room starts at version 0, with just us in it
+        rm.setPlayers(0, {PlayerRoomPreviewAccountData(
             gjam->m_accountID,
             GameManager::get()->m_playerUserID.value(),
             gjam->m_username,
             PlayerIconDataSimple(ownData),
             0,
             ownSpecialData
-        )};
+        )});
+
+        this->playerList = rm.getPlayers();
         this->applyFilter("");
 
-        RoomManager::get().setInfo(packet->info);
         this->onLoaded(true);
     });
 
-    nm.addListener<RoomCreateFailedPacket>(this, [this](std::shared_ptr<RoomCreateFailedPacket> packet) {
-        ErrorQueues::get().error(fmt::format("Failed to create room: <cy>{}</c>", packet->reason));
+    nm.addListener<RoomCreateFailedPacket>(this, [this](RoomCreateFailedPacket& packet) {
+        ErrorQueues::get().error(fmt::format("Failed to create room: <cy>{}</c>", packet.reason));
         this->onLoaded(true);
     });
 
-    nm.addListener<RoomInfoPacket>(this, [this](std::shared_ptr<RoomInfoPacket> packet) {
+    nm.addListener<RoomInfoPacket>(this, [this](RoomInfoPacket& packet) {
         log::debug("recv info");
         ErrorQueues::get().success("Room configuration updated");
 
-        RoomManager::get().setInfo(packet->info);
+        RoomManager::get().setInfo(packet.info);
         // idk maybe refresh or something something idk
 
         this->recreateInviteButton();
@@ -93,13 +117,26 @@ bool RoomLayer::init() {
 
     auto popupLayout = util::ui::getPopupLayout(m_size);
 
-    auto listview = ListView::create(CCArray::create(), PlayerListCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT);
-    listLayer = GJCommentListLayer::create(listview, "", util::ui::BG_COLOR_DARK_BLUE, LIST_WIDTH, LIST_HEIGHT, true);
+    listLayer = GJCommentListLayer::create(nullptr, "", util::ui::BG_COLOR_DARK_BLUE, LIST_WIDTH, LIST_HEIGHT, true);
 
     float xpos = (this->getScaledContentSize().width - LIST_WIDTH) / 2;
     listLayer->setPosition({xpos, 85.f});
     this->addChild(listLayer);
 
+    // public rooms can have a lot of people, only the visible cells get created
+    list = Build<VirtualList>::create(
+        CCSize{LIST_WIDTH, LIST_HEIGHT},
+        PlayerListCell::CELL_HEIGHT,
+        [] { return PlayerListCell::create(false); },
+        [this](CCNode* cell, size_t index) {
+            static_cast<PlayerListCell*>(cell)->setData(filteredPlayerList[index]);
+        }
+    )
+        .parent(listLayer)
+        .collect();
+
+    list->setRowColors(util::ui::BG_COLOR_DARKER_BLUE, util::ui::BG_COLOR_DARKER_BLUE);
+
     Build<CCMenu>::create()
         .layout(ColumnLayout::create()->setGap(1.f)->setAxisAlignment(AxisAlignment::End)->setAxisReverse(true))
         .scale(0.875f)
@@ -194,29 +231,8 @@ void RoomLayer::update(float) {
 void RoomLayer::onLoaded(bool stateChanged) {
     this->removeLoadingCircle();
 
-    auto cells = CCArray::create();
-
-    for (const auto& pdata : filteredPlayerList) {
-        auto* cell = PlayerListCell::create(pdata, false);
-        cells->addObject(cell);
-    }
-
-    // preserve scroll position
-    float scrollPos = util::ui::getScrollPos(listLayer->m_list);
-    int previousCellCount = listLayer->m_list->m_entries->count();
-
-    listLayer->m_list->removeFromParent();
-    listLayer->m_list = Build<ListView>::create(cells, PlayerListCell::CELL_HEIGHT, LIST_WIDTH, LIST_HEIGHT)
-        .parent(listLayer)
-        .collect();
-
-    for (auto* cell : CCArrayExt<PlayerListCell*>(cells)) {
-        static_cast<GenericListCell*>(cell->getParent())->m_backgroundLayer->setColor(util::cocos::convert<ccColor3B>(util::ui::BG_COLOR_DARKER_BLUE));
-    }
-
-    if (previousCellCount != 0 && !stateChanged) {
-        util::ui::setScrollPos(listLayer->m_list, scrollPos);
-    }
+    this->updateList(std::move(shownPlayerList), stateChanged);
+    shownPlayerList = filteredPlayerList;
 
     auto& rm = RoomManager::get();
     if (stateChanged) {
@@ -229,6 +245,24 @@ void RoomLayer::onLoaded(bool stateChanged) {
     this->recreateInviteButton();
 }
 
+void RoomLayer::updateList(std::vector<PlayerRoomPreviewAccountData> previous, bool stateChanged) {
+    if (previous.size() != filteredPlayerList.size()) {
+        // the scroll position is kept, cells that are still showing the same player don't get rebuilt
+        list->setCount(filteredPlayerList.size());
+    } else {
+        // only rebuild the rows that actually changed since the last refresh
+        for (size_t i = 0; i < previous.size(); i++) {
+            if (previous[i] != filteredPlayerList[i]) {
+                list->rebind(i);
+            }
+        }
+    }
+
+    if (stateChanged) {
+        list->scrollToTop();
+    }
+}
+
 void RoomLayer::addButtons() {
     // remove existing buttons
     if (roomBtnMenu) roomBtnMenu->removeFromParent();
@@ -351,7 +385,7 @@ void RoomLayer::sortPlayerList() {
             return isFriend1;
         } else {
             // convert both names to lowercase
-            std::string name1 = p1.name, name2 = p2.name;
+            std::string name1 = p1.name.str(), name2 = p2.name.str();
             std::transform(name1.begin(), name1.end(), name1.begin(), ::tolower);
             std::transform(name2.begin(), name2.end(), name2.begin(), ::tolower);
 
@@ -362,6 +396,7 @@ void RoomLayer::sortPlayerList() {
 }
 
 void RoomLayer::applyFilter(const std::string_view input) {
+    filterInput = std::string(input);
     filteredPlayerList.clear();
 
     if (input.empty()) {
@@ -382,7 +417,11 @@ void RoomLayer::applyFilter(const std::string_view input) {
         }
     }
 
-    buttonMenu->addChild(clearSearchButton);
+    // diffs reapply the search, so the button can already be there
+    if (!clearSearchButton->getParent()) {
+        buttonMenu->addChild(clearSearchButton);
+    }
+
     buttonMenu->updateLayout();
 }
 
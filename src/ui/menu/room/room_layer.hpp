@@ -2,6 +2,8 @@
 #include <defs/all.hpp>
 #include <data/types/gd.hpp>
 
+#include <ui/general/virtual_list.hpp>
+
 class RoomLayer : public cocos2d::CCLayer {
 public:
     constexpr static float POPUP_WIDTH = 420.f;
@@ -16,9 +18,14 @@ public:
 protected:
     std::vector<PlayerRoomPreviewAccountData> playerList;
     std::vector<PlayerRoomPreviewAccountData> filteredPlayerList;
+    // what the list is currently showing, the next refresh is diffed against it
+    std::vector<PlayerRoomPreviewAccountData> shownPlayerList;
+    // current search, kept when the list is updated by a diff
+    std::string filterInput;
 
     LoadingCircle* loadingCircle = nullptr;
     GJCommentListLayer* listLayer = nullptr;
+    VirtualList* list = nullptr;
     cocos2d::CCMenu* buttonMenu;
     Ref<CCMenuItemSpriteExtra> clearSearchButton, settingsButton, inviteButton, refreshButton;
     cocos2d::CCNode* roomIdButton = nullptr;
@@ -29,6 +36,7 @@ protected:
     bool init() override;
     void update(float) override;
     void onLoaded(bool stateChanged);
+    void updateList(std::vector<PlayerRoomPreviewAccountData> previous, bool stateChanged);
     void removeLoadingCircle();
     void addButtons();
     bool isLoading();
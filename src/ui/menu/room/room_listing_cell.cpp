@@ -2,23 +2,38 @@
 
 #include "room_password_popup.hpp"
 #include "room_listing_popup.hpp"
-#include <ui/general/simple_player.hpp>
+#include <ui/general/icon_thumbnail.hpp>
 #include <net/manager.hpp>
 #include <util/ui.hpp>
 
 using namespace geode::prelude;
 
-bool RoomListingCell::init(const RoomListingInfo& rli, RoomListingPopup* parent) {
+bool RoomListingCell::init(RoomListingPopup* parent) {
     if (!CCLayerColor::init())
         return false;
 
     this->parent = parent;
 
-    accountID = rli.owner.accountId;
-
     this->setContentSize({RoomListingPopup::LIST_WIDTH, CELL_HEIGHT});
     this->setAnchorPoint({0.f, 0.f});
 
+    return true;
+}
+
+bool RoomListingCell::showsSameRoom(const RoomListingInfo& a, const RoomListingInfo& b) {
+    return a.id == b.id
+        && a.name == b.name
+        && a.hasPassword == b.hasPassword
+        && a.owner == b.owner;
+}
+
+void RoomListingCell::setData(const RoomListingInfo& rli) {
+    if (hasData && showsSameRoom(info, rli)) return;
+
+    this->info = rli;
+    this->hasData = true;
+    this->removeAllChildren();
+
     // background
     const float scaleMult = 3.f;
     Build<CCScale9Sprite>::create("square02_001.png")
@@ -42,7 +57,7 @@ bool RoomListingCell::init(const RoomListingInfo& rli, RoomListingPopup* parent)
         .parent(this)
         .collect();
 
-    auto* playerIcon = Build<GlobedSimplePlayer>::create(rli.owner)
+    auto* playerIcon = Build<GlobedIconThumbnail>::create(rli.owner)
         .scale(0.35f)
         .parent(playerBundle)
         .zOrder(-1)
@@ -86,13 +101,13 @@ bool RoomListingCell::init(const RoomListingInfo& rli, RoomListingPopup* parent)
 
     Build<ButtonSprite>::create("Join", "bigFont.fnt", "GJ_button_01.png", 0.8f)
         .scale(0.7f)
-        .intoMenuItem([this, rli](auto) {
-            if (rli.hasPassword) {
-                RoomPasswordPopup::create(rli.id)->show();
+        .intoMenuItem([this](auto) {
+            if (info.hasPassword) {
+                RoomPasswordPopup::create(info.id)->show();
                 return;
             }
 
-            NetworkManager::get().send(JoinRoomPacket::create(rli.id, std::string_view("")));
+            NetworkManager::get().send(JoinRoomPacket::create(info.id, std::string_view("")));
             this->parent->close();
         })
         .with([&](auto* btn) {
@@ -102,17 +117,25 @@ bool RoomListingCell::init(const RoomListingInfo& rli, RoomListingPopup* parent)
         .intoNewParent(CCMenu::create())
         .pos(0.f, 0.f)
         .parent(this);
-
-    return true;
 }
 
 void RoomListingCell::onUser(CCObject* sender) {
+    int accountID = info.owner.accountId;
     ProfilePage::create(accountID, GJAccountManager::sharedState()->m_accountID == accountID)->show();
 }
 
 RoomListingCell* RoomListingCell::create(const RoomListingInfo& rli, RoomListingPopup* parent) {
+    auto* ret = create(parent);
+    if (ret) {
+        ret->setData(rli);
+    }
+
+    return ret;
+}
+
+RoomListingCell* RoomListingCell::create(RoomListingPopup* parent) {
     auto* ret = new RoomListingCell();
-    if (ret->init(rli, parent)) {
+    if (ret->init(parent)) {
         ret->autorelease();
         return ret;
     }
@@ -10,10 +10,18 @@ public:
     static constexpr float CELL_HEIGHT = 35.f;
 
     void onUser(cocos2d::CCObject* sender);
-    bool init(const RoomListingInfo& info, RoomListingPopup* parent);
+    bool init(RoomListingPopup* parent);
     static RoomListingCell* create(const RoomListingInfo& info, RoomListingPopup* parent);
+    static RoomListingCell* create(RoomListingPopup* parent);
+
+    // Rebuilds the cell for another room, does nothing if none of the shown info changed
+    void setData(const RoomListingInfo& info);
+    // Whether both rooms would look the same in a cell
+    static bool showsSameRoom(const RoomListingInfo& a, const RoomListingInfo& b);
 
 private:
-    int accountID;
+    RoomListingInfo info;
+    bool hasData = false;
     RoomListingPopup* parent;
+
 };
\ No newline at end of file
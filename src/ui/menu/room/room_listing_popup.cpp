@@ -6,6 +6,8 @@
 #include <managers/friend_list.hpp>
 #include <managers/settings.hpp>
 #include <net/manager.hpp>
+#include <ui/general/ask_input_popup.hpp>
+#include <util/misc.hpp>
 #include <util/ui.hpp>
 
 using namespace geode::prelude;
@@ -21,29 +23,45 @@ bool RoomListingPopup::setup() {
 
     auto rlayout = util::ui::getPopupLayoutAnchored(m_size);
 
-    Build<ScrollLayer>::create(contentSize)
-        .anchorPoint(0.f, 0.f)
-        .contentSize(contentSize)
-        .store(scroll)
-        .with([&](auto* scroll) {
-            scroll->m_contentLayer->setLayout(
-                ColumnLayout::create()
-                    ->setGap(5.f)
-                    ->setAxisReverse(true)
-                    ->setAxisAlignment(AxisAlignment::End)
-                    ->setAutoGrowAxis(contentSize.height)
-            );
-
-            scroll->setPosition(rlayout.center - scroll->getScaledContentSize() / 2.f);
-        })
+    Build<VirtualList>::create(
+        contentSize,
+        RoomListingCell::CELL_HEIGHT + CELL_GAP,
+        [this] {
+            auto* cell = RoomListingCell::create(this);
+            cell->setPositionY(CELL_GAP / 2.f);
+            return cell;
+        },
+        [this](CCNode* cell, size_t index) {
+            static_cast<RoomListingCell*>(cell)->setData(rooms[index]);
+        }
+    )
+        .store(list)
+        .pos(rlayout.center - contentSize / 2.f)
         .zOrder(2)
         .parent(m_mainLayer);
 
+    nm.addListener<RoomListPacket>(this, [this](RoomListPacket& packet) {
+        this->updateRooms(std::move(packet.rooms));
+    });
+
+    nm.addListener<RoomListPagePacket>(this, [this](RoomListPagePacket& packet) {
+        // a newer request is still on the way, this page is already outdated
+        if (this->pendingPages == 0 || --this->pendingPages != 0) return;
 
-    nm.addListener<RoomListPacket>(this, [this](std::shared_ptr<RoomListPacket> packet) {
-        this->createCells(packet->rooms);
+        this->hasMore = packet.hasMore;
+
+        if (this->replaceRooms) {
+            this->replaceRooms = false;
+            this->serverOffset = packet.rooms.size();
+            this->updateRooms(std::move(packet.rooms));
+        } else {
+            this->serverOffset += packet.rooms.size();
+            this->appendRooms(std::move(packet.rooms));
+        }
     });
 
+    paged = nm.serverMatchesProtocol();
+
     auto winSize = CCDirector::sharedDirector()->getWinSize();
 
     Build<CCScale9Sprite>::create("square02_small.png")
@@ -80,22 +98,108 @@ bool RoomListingPopup::setup() {
         .id("add-room-btn"_spr)
         .parent(menu);
 
-    nm.send(RequestRoomListPacket::create());
+    if (paged) {
+        Build<CCSprite>::createSpriteName("gj_findBtn_001.png")
+            .scale(0.8f)
+            .intoMenuItem([this](auto) {
+                AskInputPopup::create("Search Room", [this](const std::string_view input) {
+                    this->nameFilter = input;
+                    this->requestPage(true);
+                }, 32, "Room name", util::misc::STRING_PRINTABLE_INPUT, 3.f)->show();
+            })
+            .pos(rlayout.topRight + CCPoint{-20.f, -20.f})
+            .id("search-btn"_spr)
+            .parent(menu);
+
+        auto* sortMenu = Build<CCMenu>::create()
+            .layout(RowLayout::create()->setGap(5.f))
+            .pos(rlayout.bottom + CCPoint{0.f, 16.f})
+            .contentSize(LIST_WIDTH / 2.f, 20.f)
+            .id("sort-menu"_spr)
+            .parent(m_mainLayer)
+            .collect();
+
+        Build(CCMenuItemToggler::createWithStandardSprites(this, menu_selector(RoomListingPopup::onSortByName), 0.5f))
+            .id("sort-by-name-btn"_spr)
+            .parent(sortMenu);
+
+        Build<CCLabelBMFont>::create("Sort by name", "bigFont.fnt")
+            .scale(0.35f)
+            .parent(sortMenu);
+
+        sortMenu->updateLayout();
+
+        this->scheduleUpdate();
+    }
+
+    this->onReload(nullptr);
 
     return true;
 }
 
+void RoomListingPopup::update(float dt) {
+    // load the next page once the end of the list scrolls into view
+    if (hasMore && pendingPages == 0 && list->isScrolledToBottom()) {
+        this->requestPage(false);
+    }
+}
+
 void RoomListingPopup::onReload(CCObject* sender) {
-    NetworkManager::get().send(RequestRoomListPacket::create());
+    if (paged) {
+        this->requestPage(true);
+    } else {
+        NetworkManager::get().send(RequestRoomListPacket::create());
+    }
+}
+
+void RoomListingPopup::onSortByName(CCObject* sender) {
+    sortByName = !static_cast<CCMenuItemToggler*>(sender)->isOn();
+    this->requestPage(true);
 }
 
-void RoomListingPopup::createCells(std::vector<RoomListingInfo> rlpv) {
-    scroll->m_contentLayer->removeAllChildren();
-    for (const RoomListingInfo& rlp : rlpv) {
-        RoomListingCell* rlc = RoomListingCell::create(rlp, this);
-        scroll->m_contentLayer->addChild(rlc);
+void RoomListingPopup::requestPage(bool reset) {
+    if (reset) {
+        replaceRooms = true;
+        hasMore = false;
+    }
+
+    auto packet = RequestRoomListPagePacket::create();
+    packet->nameFilter = nameFilter;
+    packet->sortByName = sortByName;
+    packet->offset = reset ? 0 : serverOffset;
+    packet->limit = RequestRoomListPagePacket::MAX_LIMIT;
+
+    NetworkManager::get().send(packet);
+    pendingPages++;
+}
+
+void RoomListingPopup::updateRooms(std::vector<RoomListingInfo> rlpv) {
+    auto previous = std::move(rooms);
+    rooms = std::move(rlpv);
+
+    if (previous.size() != rooms.size()) {
+        list->setCount(rooms.size());
+        return;
     }
-    scroll->m_contentLayer->updateLayout();
+
+    // same amount of rooms, only rebuild the rows that changed
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (!RoomListingCell::showsSameRoom(previous[i], rooms[i])) {
+            list->rebind(i);
+        }
+    }
+}
+
+void RoomListingPopup::appendRooms(std::vector<RoomListingInfo> rlpv) {
+    // pages are by offset, so a room that moved up the list since the last page can show up again
+    for (auto& room : rlpv) {
+        bool known = std::any_of(rooms.begin(), rooms.end(), [&room](const auto& r) { return r.id == room.id; });
+        if (!known) {
+            rooms.push_back(std::move(room));
+        }
+    }
+
+    list->setCount(rooms.size());
 }
 
 void RoomListingPopup::close() {
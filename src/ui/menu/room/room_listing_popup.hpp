@@ -2,6 +2,7 @@
 #include <defs/geode.hpp>
 
 #include <data/types/room.hpp>
+#include <ui/general/virtual_list.hpp>
 
 class RoomListingPopup : public geode::Popup<> {
 protected:
@@ -10,15 +11,30 @@ protected:
     static constexpr float POPUP_WIDTH = 380.f;
     static constexpr float POPUP_HEIGHT = 240.f;
     static constexpr float LIST_WIDTH = POPUP_WIDTH * 0.9f;
+    static constexpr float CELL_GAP = 5.f;
     static inline const cocos2d::CCSize contentSize = {LIST_WIDTH, 150.f};
 
 	bool setup() override;
 
-    geode::ScrollLayer* scroll = nullptr;
+    VirtualList* list = nullptr;
     cocos2d::extension::CCScale9Sprite* background;
+    std::vector<RoomListingInfo> rooms;
 
+    // when the server supports it, rooms are requested a page at a time as the list is scrolled down
+    bool paged = false;
+    bool hasMore = false;
+    bool replaceRooms = false; // the next page starts the list over, after a reload or a different search
+    size_t pendingPages = 0; // only the response to the last request is used
+    size_t serverOffset = 0; // rooms the server sent so far, can be more than `rooms` since duplicates get dropped
+    bool sortByName = false;
+    std::string nameFilter;
+
+    void update(float dt) override;
     void onReload(cocos2d::CCObject* sender);
-    void createCells(std::vector<RoomListingInfo> rlp);
+    void onSortByName(cocos2d::CCObject* sender);
+    void requestPage(bool reset);
+    void updateRooms(std::vector<RoomListingInfo> rlp);
+    void appendRooms(std::vector<RoomListingInfo> rlp);
 
 public:
 	static RoomListingPopup* create();
@@ -27,7 +27,8 @@ private:
         *cellInviteOnly,
         *cellCollision,
         *cellTwoPlayer,
-        *cellPublicInvites
+        *cellPublicInvites,
+        *cellLimitSpeakers
         ;
 
     bool setup() override;
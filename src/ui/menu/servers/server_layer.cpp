@@ -213,6 +213,12 @@ void GlobedServersLayer::requestCallback(typename WebRequestManager::Event* even
     auto response = result.unwrap();
 
     auto& gsm = GameServerManager::get();
+
+    // the server list did not change (most often a `304 Not Modified`), keep the already parsed servers
+    if (gsm.count() > 0 && gsm.isCached(response)) {
+        return;
+    }
+
     gsm.updateCache(response);
     auto loadResult = gsm.loadFromCache();
     gsm.pendingChanges = true;
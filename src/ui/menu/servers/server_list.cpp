@@ -45,15 +45,15 @@ void GlobedServerList::softRefresh() {
         return;
     }
 
-    auto active = gsm.getActiveId();
+    auto snapshot = gsm.snapshot();
 
     bool authenticated = NetworkManager::get().established();
 
     for (auto* obj : CCArrayExt<CCNode*>(listCells)) {
         auto slc = static_cast<ServerListCell*>(obj->getChildren()->objectAtIndex(2));
-        auto server = gsm.getServer(slc->gsview.id);
-        if (server.has_value()) {
-            slc->updateWith(server.value(), authenticated && slc->gsview.id == active);
+        auto it = snapshot->servers.find(slc->gsview.id);
+        if (it != snapshot->servers.end()) {
+            slc->updateWith(it->second, authenticated && slc->gsview.id == snapshot->active);
         }
     }
 }
@@ -66,10 +66,10 @@ CCArray* GlobedServerList::createServerList() {
 
     bool authenticated = nm.established();
 
-    auto activeServer = gsm.getActiveId();
+    auto snapshot = gsm.snapshot();
 
-    for (const auto& [serverId, server] : gsm.getAllServers()) {
-        bool active = authenticated && serverId == activeServer;
+    for (const auto& [serverId, server] : snapshot->servers) {
+        bool active = authenticated && serverId == snapshot->active;
         auto cell = ServerListCell::create(server, active);
         ret->addObject(cell);
     }
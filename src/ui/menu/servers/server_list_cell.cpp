@@ -89,12 +89,10 @@ void ServerListCell::updateWith(const GameServer& gsview, bool active) {
                         if (csm.standalone()) {
                             GLOBED_RESULT_ERRC(NetworkManager::get().connectStandalone());
                         } else {
-                            // check if the token is here, otherwise request it
+                            // check if the token is here and not about to expire, otherwise request a new one
                             auto& am = GlobedAccountManager::get();
 
-                            auto hasToken = !am.authToken.lock()->empty();
-
-                            if (hasToken) {
+                            if (am.hasFreshAuthToken()) {
                                 GLOBED_RESULT_ERRC(NetworkManager::get().connect(this->gsview));
                             } else {
                                 this->requestTokenAndConnect();
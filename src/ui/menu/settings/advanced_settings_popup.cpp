@@ -1,11 +1,11 @@
 #include "advanced_settings_popup.hpp"
 
+#include "debug_tools_popup.hpp"
+#include <game/lerp_logger.hpp>
+#include <game/session_recorder.hpp>
 #include <managers/account.hpp>
 #include <managers/settings.hpp>
 #include <net/manager.hpp>
-#include <net/address.hpp>
-#include <util/debug.hpp>
-#include <util/format.hpp>
 #include <util/ui.hpp>
 
 using namespace geode::prelude;
@@ -23,8 +23,8 @@ bool AdvancedSettingsPopup::setup() {
         .pos(rlayout.center)
         .intoNewParent(CCMenu::create())
         .layout(ColumnLayout::create()->setAxisReverse(true))
-        .contentSize(0.f, POPUP_HEIGHT - 20.f)
-        .pos(rlayout.center - CCPoint{0.f, 10.f})
+        .contentSize(0.f, 90.f)
+        .pos(rlayout.center + CCPoint{0.f, 30.f})
         .parent(m_mainLayer)
         .collect();
 
@@ -39,49 +39,82 @@ bool AdvancedSettingsPopup::setup() {
         .pos(rlayout.center - CCPoint{0.f, 30.f})
         .parent(menu);
 
-    Build<ButtonSprite>::create("DNS test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+    Build<ButtonSprite>::create("Debug tools", "bigFont.fnt", "GJ_button_01.png", 0.75f)
         .scale(0.8f)
         .intoMenuItem([this](auto) {
-            util::debug::Benchmarker bb;
-
-            auto res1 = bb.run([&] {
-                NetworkAddress addr1("1.1.1.1:80");
-                auto res = addr1.resolve();
-                if (!res) log::debug("failed to resolve 1.1.1.1:80: {}", res.unwrapErr());
-            });
-
-            auto res2 = bb.run([&] {
-                NetworkAddress addr1("availax.xyz:443");
-                auto res = addr1.resolve();
-                if (!res) log::debug("failed to resolve domain name: {}", res.unwrapErr());
-            });
-
-            // repeated query to check cache
-            auto res3 = bb.run([&] {
-                NetworkAddress addr1("availax.xyz:443");
-                auto res = addr1.resolve();
-                if (!res) log::debug("failed to resolve domain name: {}", res.unwrapErr());
-            });
-
-            log::debug("Resolutions took: {}, {}, {}", util::format::duration(res1), util::format::duration(res2), util::format::duration(res3));
+            DebugToolsPopup::create()->show();
         })
         .pos(rlayout.center - CCPoint{0.f, 60.f})
         .parent(menu);
 
-    auto* thing = Build(CCMenuItemToggler::createWithStandardSprites(this, menu_selector(AdvancedSettingsPopup::onPacketLog), 0.7f))
-        .parent(menu)
+    auto* toggles = Build<CCNode>::create()
+        .layout(ColumnLayout::create()->setAxisReverse(true)->setAutoScale(false)->setGap(2.f))
+        .contentSize(POPUP_WIDTH - 40.f, 64.f)
+        .anchorPoint(0.5f, 0.f)
+        .pos(rlayout.centerBottom + CCPoint{0.f, 8.f})
+        .parent(m_mainLayer)
         .collect();
 
+    this->addToggle(toggles, "Packet logging", menu_selector(AdvancedSettingsPopup::onPacketLog), false);
+    // dumped once it gets turned off
+    this->addToggle(toggles, "Interpolation logging", menu_selector(AdvancedSettingsPopup::onLerpLog), LerpLogger::isEnabled());
+    // starts with the next level
+    this->addToggle(toggles, "Session recording", menu_selector(AdvancedSettingsPopup::onSessionRecord), SessionRecorder::isEnabled());
+
     menu->updateLayout();
+    toggles->updateLayout();
 
     return true;
 }
 
+void AdvancedSettingsPopup::addToggle(CCNode* parent, const char* name, SEL_MenuHandler callback, bool enabled) {
+    auto* row = Build<CCMenu>::create()
+        .layout(RowLayout::create()->setGap(5.f)->setAxisAlignment(AxisAlignment::Start))
+        .contentSize(POPUP_WIDTH - 40.f, 20.f)
+        .parent(parent)
+        .collect();
+
+    Build(CCMenuItemToggler::createWithStandardSprites(this, callback, 0.6f))
+        .parent(row)
+        .collect()
+        ->toggle(enabled);
+
+    Build<CCLabelBMFont>::create(name, "bigFont.fnt")
+        .scale(0.4f)
+        .parent(row);
+
+    row->updateLayout();
+}
+
 void AdvancedSettingsPopup::onPacketLog(CCObject* p) {
     bool enabled = !static_cast<CCMenuItemToggler*>(p)->isOn();
     NetworkManager::get().togglePacketLogging(enabled);
 }
 
+void AdvancedSettingsPopup::onLerpLog(CCObject* p) {
+    bool enabled = !static_cast<CCMenuItemToggler*>(p)->isOn();
+    auto& logger = LerpLogger::get();
+
+    if (enabled) {
+        logger.clear();
+    } else {
+        logger.makeDump(Mod::get()->getSaveDir() / "interpolation.bin");
+    }
+
+    LerpLogger::setEnabled(enabled);
+}
+
+void AdvancedSettingsPopup::onSessionRecord(CCObject* p) {
+    bool enabled = !static_cast<CCMenuItemToggler*>(p)->isOn();
+
+    // a level that is being recorded right now keeps its file until it's exited
+    if (!enabled && SessionRecorder::isEnabled()) {
+        SessionRecorder::get().stop();
+    }
+
+    SessionRecorder::setEnabled(enabled);
+}
+
 AdvancedSettingsPopup* AdvancedSettingsPopup::create() {
     auto ret = new AdvancedSettingsPopup;
     if (ret->init(POPUP_WIDTH, POPUP_HEIGHT)) {
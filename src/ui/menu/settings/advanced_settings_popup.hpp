@@ -11,5 +11,10 @@ public:
 private:
     bool setup() override;
 
+    // A toggle with a label next to it, as a row of `parent`
+    void addToggle(cocos2d::CCNode* parent, const char* name, cocos2d::SEL_MenuHandler callback, bool enabled);
+
     void onPacketLog(cocos2d::CCObject*);
+    void onLerpLog(cocos2d::CCObject*);
+    void onSessionRecord(cocos2d::CCObject*);
 };
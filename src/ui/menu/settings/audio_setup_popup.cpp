@@ -4,7 +4,6 @@
 
 #include "audio_device_cell.hpp"
 #include <audio/manager.hpp>
-#include <audio/voice_playback_manager.hpp>
 #include <managers/settings.hpp>
 #include <util/misc.hpp>
 #include <util/ui.hpp>
@@ -33,22 +32,19 @@ bool AudioSetupPopup::setup() {
     recordButton = Build<CCSprite>::createSpriteName("GJ_playBtn2_001.png")
         .scale(0.485f)
         .intoMenuItem([this](auto) {
-            auto& vpm = VoicePlaybackManager::get();
-            vpm.prepareStream(-1);
-
             auto& vm = GlobedAudioManager::get();
             vm.setRecordBufferCapacity(1);
-            auto result = vm.startRecordingRaw([this, &vpm](const float* pcm, size_t samples) {
+            // the loopback plays the audio back directly, the callback only has to measure the volume
+            vm.setLoopbackEnabled(true);
+            auto result = vm.startRecordingRaw([this](const float* pcm, size_t samples) {
                 // calculate the avg audio volume
                 this->audioLevel = util::misc::calculatePcmVolume(pcm, samples);
-
-                // play back the audio
-                vpm.playRawDataStreamed(-1, pcm, samples);
             });
 
             if (result.isErr()) {
                 log::warn("failed to start recording: {}", result.unwrapErr());
                 Notification::create(result.unwrapErr(), NotificationIcon::Error)->show();
+                vm.setLoopbackEnabled(GlobedSettings::get().communication.voiceLoopback);
                 return;
             }
 
@@ -66,9 +62,7 @@ bool AudioSetupPopup::setup() {
 
             auto& vm = GlobedAudioManager::get();
             vm.haltRecording();
-
-            auto& vpm = VoicePlaybackManager::get();
-            vpm.removeStream(-1);
+            vm.setLoopbackEnabled(GlobedSettings::get().communication.voiceLoopback);
         })
         .parent(visualizerLayout)
         .id("stop-recording-button"_spr)
@@ -88,6 +82,14 @@ bool AudioSetupPopup::setup() {
         .id("audio-visualizer"_spr)
         .store(audioVisualizer);
 
+    Build<CCLabelBMFont>::create("", "bigFont.fnt")
+        .scale(0.3f)
+        .pos(screenCenter.width, screenCenter.height - 128.f)
+        .visible(false)
+        .parent(m_mainLayer)
+        .id("latency-label"_spr)
+        .store(latencyLabel);
+
     this->toggleButtons(false);
 
     listLayer = GJCommentListLayer::create(nullptr, "", util::ui::BG_COLOR_BROWN, LIST_WIDTH, LIST_HEIGHT, false);
@@ -104,6 +106,13 @@ bool AudioSetupPopup::setup() {
 
 void AudioSetupPopup::update(float) {
     audioVisualizer->setVolume(audioLevel);
+
+    // only known once the loopback has played something
+    double latency = GlobedAudioManager::get().getLoopbackLatency();
+    latencyLabel->setVisible(latency > 0.0);
+    if (latency > 0.0) {
+        latencyLabel->setString(fmt::format("Latency: {}ms", static_cast<int>(latency * 1000.0)).c_str());
+    }
 }
 
 cocos2d::CCArray* AudioSetupPopup::createDeviceCells() {
@@ -163,6 +172,7 @@ void AudioSetupPopup::onClose(cocos2d::CCObject* sender) {
     Popup::onClose(sender);
     auto& vm = GlobedAudioManager::get();
     vm.haltRecording();
+    vm.setLoopbackEnabled(GlobedSettings::get().communication.voiceLoopback);
 }
 
 void AudioSetupPopup::toggleButtons(bool recording) {
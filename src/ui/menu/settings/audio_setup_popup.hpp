@@ -21,6 +21,7 @@ private:
     Ref<CCMenuItemSpriteExtra> recordButton, stopRecordButton;
     GJCommentListLayer* listLayer;
     GlobedAudioVisualizer* audioVisualizer;
+    cocos2d::CCLabelBMFont* latencyLabel;
     asp::AtomicF32 audioLevel;
     cocos2d::CCMenu* visualizerLayout;
 
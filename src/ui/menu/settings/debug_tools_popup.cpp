@@ -0,0 +1,139 @@
+#include "debug_tools_popup.hpp"
+
+#include <bench/bench.hpp>
+#include <game/scenario_bench.hpp>
+#include <game/session_recorder.hpp>
+#include <net/address.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/ui.hpp>
+
+using namespace geode::prelude;
+
+bool DebugToolsPopup::setup() {
+    auto rlayout = util::ui::getPopupLayout(m_size);
+    this->setTitle("Debug tools");
+
+    auto* menu = Build<CCMenu>::create()
+        .layout(ColumnLayout::create()->setAxisReverse(true))
+        .contentSize(0.f, POPUP_HEIGHT - 45.f)
+        .pos(rlayout.center - CCPoint{0.f, 12.f})
+        .parent(m_mainLayer)
+        .collect();
+
+    Build<ButtonSprite>::create("DNS test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            util::debug::Benchmarker bb;
+
+            auto res1 = bb.run([&] {
+                NetworkAddress addr1("1.1.1.1:80");
+                auto res = addr1.resolve();
+                if (!res) log::debug("failed to resolve 1.1.1.1:80: {}", res.unwrapErr());
+            });
+
+            auto res2 = bb.run([&] {
+                NetworkAddress addr1("availax.xyz:443");
+                auto res = addr1.resolve();
+                if (!res) log::debug("failed to resolve domain name: {}", res.unwrapErr());
+            });
+
+            // repeated query to check cache
+            auto res3 = bb.run([&] {
+                NetworkAddress addr1("availax.xyz:443");
+                auto res = addr1.resolve();
+                if (!res) log::debug("failed to resolve domain name: {}", res.unwrapErr());
+            });
+
+            log::debug("Resolutions took: {}, {}, {}", util::format::duration(res1), util::format::duration(res2), util::format::duration(res3));
+        })
+        .parent(menu);
+
+    Build<ButtonSprite>::create("Encoding test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            bench::encoding().log();
+            Notification::create("Results were written to the log", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    Build<ButtonSprite>::create("Crypto test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            bench::crypto().log();
+            Notification::create("Results were written to the log", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    Build<ButtonSprite>::create("SIMD test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            bench::adler32().log();
+            bench::simdKernels().log();
+            Notification::create("Results were written to the log", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    Build<ButtonSprite>::create("Game test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            bench::game().log();
+            bench::collections().log();
+            Notification::create("Results were written to the log", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    // plays the level data of the newest packet capture through the interpolator with different settings
+    Build<ButtonSprite>::create("Lerp replay", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            auto report = bench::lerpReplay();
+            if (!report) {
+                Notification::create(report.unwrapErr(), NotificationIcon::Error)->show();
+                return;
+            }
+
+            report.unwrap().log();
+            Notification::create("Results were written to the log", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    // the newest session recording gets played back as ghosts in the next level, if it was recorded there
+    Build<ButtonSprite>::create("Play recording", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            auto path = SessionRecorder::latestRecording();
+            if (!path) {
+                Notification::create(path.unwrapErr(), NotificationIcon::Error)->show();
+                return;
+            }
+
+            SessionPlayback::queue(path.unwrap());
+            Notification::create("The recording will play in the next level", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    // synthetic players and voice in the next level, see `ScenarioBenchmark`. `globed-scenario-bench` runs it in every level
+    Build<ButtonSprite>::create("Scenario test", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.7f)
+        .intoMenuItem([this](auto) {
+            ScenarioBenchmark::queue();
+            Notification::create("The benchmark will run in the next level", NotificationIcon::Success)->show();
+        })
+        .parent(menu);
+
+    menu->updateLayout();
+
+    return true;
+}
+
+DebugToolsPopup* DebugToolsPopup::create() {
+    auto ret = new DebugToolsPopup;
+    if (ret->init(POPUP_WIDTH, POPUP_HEIGHT)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <defs/geode.hpp>
+
+// Benchmarks and other tests, opened from the advanced settings
+class DebugToolsPopup : public geode::Popup<> {
+public:
+    static constexpr float POPUP_WIDTH = 260.f;
+    static constexpr float POPUP_HEIGHT = 260.f;
+
+    static DebugToolsPopup* create();
+
+private:
+    bool setup() override;
+};
@@ -1,7 +1,6 @@
 #include "setting_cell.hpp"
 
 #include "audio_setup_popup.hpp"
-#include "frag_calibration_popup.hpp"
 #include "string_input_popup.hpp"
 #include "advanced_settings_popup.hpp"
 #include <managers/settings.hpp>
@@ -14,9 +13,10 @@ using namespace geode::prelude;
 namespace permission = geode::utils::permission;
 using permission::Permission;
 
-bool GlobedSettingCell::init(void* settingStorage, Type settingType, const char* nameText, const char* descText, const Limits& limits) {
+bool GlobedSettingCell::init(void* settingStorage, bool* settingDirty, Type settingType, const char* nameText, const char* descText, const Limits& limits) {
     if (!CCLayer::init()) return false;
     this->settingStorage = settingStorage;
+    this->settingDirty = settingDirty;
     this->settingType = settingType;
     this->descText = descText;
     this->limits = limits;
@@ -251,8 +251,10 @@ void GlobedSettingCell::onInteractiveButton(cocos2d::CCObject*) {
         AudioSetupPopup::create()->show();
 #endif // GLOBED_VOICE_SUPPORT
     } else if (settingType == Type::PacketFragmentation) {
-        if (NetworkManager::get().established()) {
-            FragmentationCalibartionPopup::create()->show();
+        auto& nm = NetworkManager::get();
+        if (nm.established()) {
+            nm.probePathMtu();
+            FLAlertLayer::create("Packet limit", "The maximum packet size is being measured in the background. <cy>Reconnect</c> to the server in a few seconds in order to see any change.", "Ok")->show();
         } else {
             FLAlertLayer::create("Error", "This action can only be done when connected to a server.", "Ok")->show();
         }
@@ -369,10 +371,11 @@ void GlobedSettingCell::storeAndSave(std::any&& value) {
         case Type::Int:
             *(int*)(settingStorage) = std::any_cast<int>(value); break;
         case Type::AdvancedSettings:
-            break;
+            return;
     }
 
-    GlobedSettings::get().save();
+    *settingDirty = true;
+    GlobedSettings::get().scheduleFlush();
 }
 
 void GlobedSettingCell::textChanged(CCTextInputNode* p0) {
@@ -394,9 +397,9 @@ void GlobedSettingCell::textInputReturn(CCTextInputNode* p0) {}
 bool GlobedSettingCell::allowTextInput(CCTextInputNode* p0) { return true; }
 void GlobedSettingCell::enterPressed(CCTextInputNode* p0) {}
 
-GlobedSettingCell* GlobedSettingCell::create(void* settingStorage, Type settingType, const char* name, const char* desc, const Limits& limits) {
+GlobedSettingCell* GlobedSettingCell::create(void* settingStorage, bool* settingDirty, Type settingType, const char* name, const char* desc, const Limits& limits) {
     auto ret = new GlobedSettingCell;
-    if (ret->init(settingStorage, settingType, name, desc, limits)) {
+    if (ret->init(settingStorage, settingDirty, settingType, name, desc, limits)) {
         ret->autorelease();
         return ret;
     }
@@ -18,12 +18,14 @@ public:
     static constexpr float CELL_HEIGHT = 37.5f;
 
     // The character parameters must be string literals, or must exist for the entire lifetime of the cell.
-    static GlobedSettingCell* create(void*, Type, const char*, const char*, const Limits&);
+    // `settingDirty` is the dirty flag of the setting, set whenever the cell writes into the storage
+    static GlobedSettingCell* create(void*, bool*, Type, const char*, const char*, const Limits&);
 
     void storeAndSave(std::any&& value);
 
 private:
     void* settingStorage;
+    bool* settingDirty;
     Type settingType;
     const char* descText;
     Limits limits;
@@ -39,7 +41,7 @@ private:
     CCMenuItemSpriteExtra* cornerButton = nullptr;
     CCMenuItemSpriteExtra* invitesFromButton = nullptr;
 
-    bool init(void*, Type, const char*, const char*, const Limits&);
+    bool init(void*, bool*, Type, const char*, const char*, const Limits&);
     void onCheckboxToggled(cocos2d::CCObject*);
     void onSliderChanged(cocos2d::CCObject*);
     void onInteractiveButton(cocos2d::CCObject*);
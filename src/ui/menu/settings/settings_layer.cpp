@@ -199,7 +199,7 @@ static void registerSetting(
         }
     }
 
-    cells->addObject(GlobedSettingCell::create(&setting.ref(), stype, name, description, limits));
+    cells->addObject(GlobedSettingCell::create(&setting.ref(), setting.dirtyRef(), stype, name, description, limits));
 }
 
 void GlobedSettingsLayer::createSettingsCells(int category) {
@@ -215,9 +215,13 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.globed.autoconnect, "Autoconnect", "Automatically connect to the last connected server on launch.");
             registerSetting(cat, settings.globed.preloadAssets, "Preload assets", "Increases the loading times but prevents most lagspikes in a level.");
             registerSetting(cat, settings.globed.deferPreloadAssets, "Defer preloading", "Instead of making the loading screen longer, load assets only when you join a level while connected.");
+            registerSetting(cat, settings.globed.demandLoadIcons, "Load icons on demand", "Instead of preloading every icon, only load the icons of players in the level as they join. Makes loading much faster and uses less memory, at the cost of a small lagspike when new players join.");
             registerSetting(cat, settings.globed.invitesFrom, "Receive invites from", "Controls who can invite you into a room.", Type::InvitesFrom);
-            registerSetting(cat, settings.globed.fragmentationLimit, "Packet limit", "Press the \"Test\" button to calibrate the maximum packet size. Should fix some of the issues with players not appearing in a level.", Type::PacketFragmentation);
+            registerSetting(cat, settings.globed.fragmentationLimit, "Packet limit", "Maximum packet size. It is measured automatically for every server and network, this setting only limits it further. Press the \"Auto\" button to measure it again.", Type::PacketFragmentation);
             registerSetting(cat, settings.globed.tpsCap, "TPS cap", "Maximum amount of packets per second sent between the client and the server. Useful only for very silly things.");
+            registerSetting(cat, settings.globed.frameBudget, "Frame budget", "Time in microseconds Globed may spend each frame before less important work (like refreshing profiles or the player list) is pushed to later frames. 0 to disable.");
+            registerSetting(cat, settings.globed.lowLatencySockets, "Low latency networking", "Use a bigger receive buffer, disable Nagle's algorithm and mark voice and player data packets for QoS, so routers that support it can prioritize them. Applies on the next connection. Dropped packets are shown in the network stats.");
+            registerSetting(cat, settings.globed.batterySaver, "Battery saver", "When running on battery, wake up the network threads less often in menus, and in levels send fewer updates and only play a few voices at once. Crowded levels always run at the full rate.");
 #ifndef GEODE_IS_ANDROID
             registerSetting(cat, settings.globed.useDiscordRPC, "Discord RPC", "If you have the Discord Rich Presence standalone mod, this option will toggle a Globed-specific RPC on your profile.", Type::DiscordRPC);
 #endif
@@ -240,9 +244,12 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.communication.voiceVolume, "Voice volume", "Controls how loud other players are.");
             registerSetting(cat, settings.communication.onlyFriends, "Only friends", "When enabled, you won't hear players that are not on your friend list in-game.");
             registerSetting(cat, settings.communication.lowerAudioLatency, "Lower audio latency", "Decreases the audio buffer size by 2 times, reducing the latency but potentially causing audio issues.");
+            registerSetting(cat, settings.communication.voiceMixer, "Mixed playback", "Plays all voices through a single audio stream instead of one per player, which is faster in rooms with many people talking. Applies to players that start talking after it's changed.");
+            registerSetting(cat, settings.communication.voiceActivityDetection, "Silence suppression", "Stops sending audio while you are not talking, saving bandwidth. Disable if the start or end of your words gets cut off.");
+            registerSetting(cat, settings.communication.voicePanning, "Stereo proximity chat", "With proximity chat, players to the left or right of you are heard from that side.");
             registerSetting(cat, settings.communication.deafenNotification, "Deafen notification", "Shows a notification when you deafen & undeafen.");
             registerSetting(cat, settings.communication.audioDevice, "Audio device", "The input device used for recording your voice.", Type::AudioDevice);
-            // MAKE_SETTING(communication, voiceLoopback, "Voice loopback", "When enabled, you will hear your own voice as you speak.");
+            registerSetting(cat, settings.communication.voiceLoopback, "Voice loopback", "When enabled, you will hear your own voice as you speak.");
 #endif // GLOBED_VOICE_SUPPORT
         } break;
 
@@ -256,12 +263,15 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.overlay.opacity, "Opacity", "Opacity of the displayed overlay.");
             registerSetting(cat, settings.overlay.hideConditionally, "Hide conditionally", "Hide the ping overlay when not connected to a server or in a non-uploaded level, instead of showing a substitute message.");
             registerSetting(cat, settings.overlay.position, "Position", "Position of the overlay on the screen.", Type::Corner);
+            registerSetting(cat, settings.overlay.networkStats, "Network stats", "Show packet loss, jitter and the amount of data sent and received under the ping.");
+            registerSetting(cat, settings.overlay.detailedStats, "Detailed stats", "Show packet rates, the busiest packet types, the interpolation buffer of every player, voice playback underruns and time spent by Globed each frame. Useful for tuning TPS and latency settings.");
         } break;
 
         case TAG_TAB_PLAYERS: {
             registerSetting(cat, settings.players.playerOpacity, "Opacity", "Opacity of other players.");
             registerSetting(cat, settings.players.showNames, "Player names", "Show names above players' icons.");
             registerSetting(cat, settings.players.dualName, "Dual name", "Show the name of the player on their secondary icon as well.");
+            registerSetting(cat, settings.players.batchedNames, "Batched names", "Draws the names of all players at once, which is a lot faster in levels with many players. Names of players with a badge or a special color are still drawn normally.");
             registerSetting(cat, settings.players.nameOpacity, "Name opacity", "Opacity of player names.");
             registerSetting(cat, settings.players.ownName, "Show own name", "Shows your own name above your icon as well.");
             registerSetting(cat, settings.players.deathEffects, "Death effects", "Play a death effect whenever a player dies.");
@@ -269,6 +279,10 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.players.hideNearby, "Hide nearby players", "Increases the transparency of players as they get closer to you, so that they don't obstruct your view.");
             registerSetting(cat, settings.players.statusIcons, "Status icons", "Show an icon above a player if they are paused, in practice mode, or currently speaking.");
             registerSetting(cat, settings.players.hidePracticePlayers, "Hide players in practice", "Hide players that are in practice mode.");
+            registerSetting(cat, settings.players.extrapolation, "Extrapolation", "Keep players moving for a short moment when their data arrives late, instead of freezing them in place. May cause small jumps when the data finally arrives.");
+            registerSetting(cat, settings.players.linkedExtrapolation, "Linked extrapolation", "Extrapolate the player you are linked to in two player mode, even if extrapolation is disabled for everyone else. Their data arrives faster and with less delay, so a late frame is rarely far off.");
+            registerSetting(cat, settings.players.cubicInterpolation, "Smooth interpolation", "Move players along a curve between their positions instead of a straight line. Makes curved movement (like ball or wave) look smoother, especially when the server sends data less often.");
+            registerSetting(cat, settings.players.crowdModeThreshold, "Crowd mode", "When there are more players on the level than this, the ones that aren't close to the center of the screen are drawn as simple squares. Helps a lot with performance in big events. 0 to disable.");
         } break;
     }
 }
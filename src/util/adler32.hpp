@@ -2,7 +2,8 @@
 #include <stdint.h>
 
 namespace util::crypto {
-    // Unoptimized adler-32 implementation.
+    // Unoptimized adler-32 implementation, meant for compile-time hashing.
+    // At runtime use `util::simd::adler32`, which is vectorized and defers the modulo.
     constexpr inline uint32_t adler32(const uint8_t* data, size_t length) {
         const uint32_t MOD = 65521;
 
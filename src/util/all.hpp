@@ -8,10 +8,15 @@
 #include "data.hpp"
 #include "debug.hpp"
 #include "format.hpp"
+#include "jobs.hpp"
 #include "lowlevel.hpp"
 #include "math.hpp"
 #include "misc.hpp"
 #include "net.hpp"
+#include "power.hpp"
+#include "profiler.hpp"
 #include "rng.hpp"
+#include "thread.hpp"
 #include "time.hpp"
+#include "trace.hpp"
 #include "ui.hpp"
@@ -5,11 +5,18 @@
 #include <hooks/game_manager.hpp>
 #include <util/format.hpp>
 #include <util/debug.hpp>
-#include <asp/thread.hpp>
+#include <util/memory.hpp>
+#include <util/jobs.hpp>
+#include <util/simd.hpp>
+#include <atomic>
+#include <fstream>
+#include <lz4.h>
 
 using namespace geode::prelude;
 
-constexpr size_t THREAD_COUNT = 25;
+// decoded textures are cached on disk, so later launches skip png decoding
+constexpr uint32_t TEXTURE_CACHE_MAGIC = 0x47544331; // GTC1
+constexpr size_t TEXTURE_CACHE_HEADER_SIZE = sizeof(uint32_t) * 4 + sizeof(uint8_t);
 
 // all of this is needed to disrespect the privacy of ccfileutils
 #include <Geode/modify/CCFileUtils.hpp>
@@ -61,18 +68,97 @@ namespace util::cocos {
         bool hasTexturePack;
         size_t gameSearchPathIdx = -1;
         std::vector<size_t> texturePackIndices;
-        std::unique_ptr<asp::thread::ThreadPool> threadPool;
+    };
 
-        void ensurePoolExists() {
-            if (!threadPool) {
-                threadPool = std::make_unique<asp::thread::ThreadPool>(THREAD_COUNT);
-            }
+    // lets us mark raw image data as premultiplied, like the png decoder does
+    class CachedImage : public CCImage {
+    public:
+        void setPremultiplied(bool state) {
+            m_bPreMulti = state;
         }
+    };
+
+    static std::filesystem::path textureCachePath(const uint8_t* png, size_t size) {
+        static const auto folder = Mod::get()->getSaveDir() / "texture-cache";
+        return folder / fmt::format("{:08x}-{:x}.bin", util::simd::adler32(png, size), size);
+    }
+
+    // Returns the decoded image for this png file if it's cached, otherwise nullptr
+    static CCImage* loadCachedImage(const uint8_t* png, size_t size) {
+        std::ifstream file(textureCachePath(png, size), std::ios::binary);
+        if (!file) return nullptr;
+
+        uint8_t header[TEXTURE_CACHE_HEADER_SIZE];
+        if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) return nullptr;
+
+        uint32_t magic, width, height, rawSize;
+        std::memcpy(&magic, header, sizeof(uint32_t));
+        std::memcpy(&width, header + 4, sizeof(uint32_t));
+        std::memcpy(&height, header + 8, sizeof(uint32_t));
+        std::memcpy(&rawSize, header + 12, sizeof(uint32_t));
+        bool premultiplied = header[16] != 0;
 
-        void destroyPool() {
-            threadPool = nullptr;
+        if (magic != TEXTURE_CACHE_MAGIC || rawSize != width * height * 4) return nullptr;
+
+        std::vector<char> compressed(std::istreambuf_iterator<char>(file), {});
+        auto raw = std::make_unique<char[]>(rawSize);
+
+        int written = LZ4_decompress_safe(compressed.data(), raw.get(), static_cast<int>(compressed.size()), static_cast<int>(rawSize));
+        if (written != static_cast<int>(rawSize)) return nullptr;
+
+        auto* image = new CachedImage;
+        if (!image->initWithImageData(raw.get(), rawSize, CCImage::kFmtRawData, width, height, 8)) {
+            delete image;
+            return nullptr;
         }
-    };
+
+        image->setPremultiplied(premultiplied);
+        return image;
+    }
+
+    // Best effort, a failed write just means the png gets decoded again next time
+    static void storeCachedImage(const uint8_t* png, size_t size, CCImage* image) {
+        // raw data is only understood as 8-bit rgba
+        if (!image->hasAlpha() || image->getBitsPerComponent() != 8) return;
+
+        uint32_t width = image->getWidth(), height = image->getHeight();
+        uint32_t rawSize = width * height * 4;
+        if (static_cast<uint32_t>(image->getDataLen()) != rawSize) return;
+
+        std::vector<char> compressed(LZ4_compressBound(static_cast<int>(rawSize)));
+        int compressedSize = LZ4_compress_default(
+            reinterpret_cast<const char*>(image->getData()), compressed.data(),
+            static_cast<int>(rawSize), static_cast<int>(compressed.size())
+        );
+
+        if (compressedSize <= 0) return;
+
+        uint8_t header[TEXTURE_CACHE_HEADER_SIZE];
+        std::memcpy(header, &TEXTURE_CACHE_MAGIC, sizeof(uint32_t));
+        std::memcpy(header + 4, &width, sizeof(uint32_t));
+        std::memcpy(header + 8, &height, sizeof(uint32_t));
+        std::memcpy(header + 12, &rawSize, sizeof(uint32_t));
+        header[16] = image->isPremultipliedAlpha();
+
+        auto path = textureCachePath(png, size);
+        auto tmpPath = path;
+        tmpPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        {
+            std::ofstream file(tmpPath, std::ios::binary);
+            if (!file) return;
+
+            file.write(reinterpret_cast<const char*>(header), sizeof(header));
+            file.write(compressed.data(), compressedSize);
+            if (!file) return;
+        }
+
+        // written to a temporary file first, so a crash mid-write can't leave a broken entry behind
+        std::filesystem::rename(tmpPath, path, ec);
+    }
 
     static void initPreloadState(PersistentPreloadState& state) {
         auto startTime = util::time::now();
@@ -122,8 +208,6 @@ namespace util::cocos {
             idx++;
         }
 
-        state.threadPool = std::make_unique<asp::thread::ThreadPool>(THREAD_COUNT);
-
         log::debug("initialized preload state in {}", util::format::formatDuration(util::time::now() - startTime));
         log::debug("texture quality: {}", state.texQuality == TextureQuality::High ? "High" : (state.texQuality == TextureQuality::Medium ? "Medium" : "Low"));
         log::debug("texture packs: {}", state.texturePackIndices.size());
@@ -131,30 +215,31 @@ namespace util::cocos {
             state.gameSearchPathIdx == -1 ? "<not found>" : HookedFileUtils::get().getSearchPath(state.gameSearchPathIdx));
     }
 
-    void loadAssetsParallel(const std::vector<std::string>& images) {
-        auto& state = getPreloadState();
-        state.ensurePoolExists();
-
-        auto& threadPool = *state.threadPool.get();
-
-        log::debug("preload: preparing {} textures", images.size());
-
-        static asp::Mutex<> cocosWorkMutex;
-
-        auto textureCache = CCTextureCache::sharedTextureCache();
-        auto sfCache  = CCSpriteFrameCache::sharedSpriteFrameCache();
-
-        auto& fileUtils = HookedFileUtils::get();
+    static asp::Mutex<> cocosWorkMutex;
 
+    struct ParallelAssetLoader::Shared {
         struct ImageLoadState {
             std::string key;
             gd::string path;
             CCTexture2D* texture = nullptr;
         };
 
-        asp::Mutex<std::vector<ImageLoadState>> imgStates;
+        // never resized once the loader is constructed. `texture` is written on the main thread before the sprite frame task
+        // for that image is pushed, so the pool always sees it set.
+        std::vector<ImageLoadState> images;
+        // every decode task pushes exactly one entry, nullptr if it failed
+        asp::Channel<std::pair<size_t, CCImage*>> decoded;
+        std::atomic_size_t framesPending = 0;
+    };
+
+    ParallelAssetLoader::ParallelAssetLoader(const std::vector<std::string>& images) : shared(std::make_shared<Shared>()) {
+        auto& jobs = util::jobs::JobSystem::get();
+
+        log::debug("preload: preparing {} textures", images.size());
+
+        auto textureCache = CCTextureCache::sharedTextureCache();
+        auto& fileUtils = HookedFileUtils::get();
 
-        auto _imguard = imgStates.lock();
         for (const auto& imgkey : images) {
             auto pathKey = fmt::format("{}.png", imgkey);
 
@@ -168,29 +253,24 @@ namespace util::cocos {
                 continue;
             }
 
-            _imguard->emplace_back(ImageLoadState {
+            shared->images.emplace_back(Shared::ImageLoadState {
                 .key = imgkey,
                 .path = fullpath,
                 .texture = nullptr
             });
         }
 
-        size_t imgCount = _imguard->size();
-        _imguard.unlock();
-
-        if (imgCount == 0) {
+        if (shared->images.empty()) {
             log::debug("preload: all textures already loaded, skipping pass");
             return;
         }
 
-        log::debug("preload: loading images ({} total)", imgCount);
-
-        asp::Channel<std::pair<size_t, CCImage*>> textureInitRequests;
+        log::debug("preload: loading images ({} total)", shared->images.size());
 
-        for (size_t i = 0; i < imgCount; i++) {
-            threadPool.pushTask([i, &fileUtils, &textureInitRequests, &imgStates] {
-                // this is a dangling reference, but we do not modify imgStates in any way, so it's not a big deal.
-                auto& imgState = imgStates.lock()->at(i);
+        for (size_t i = 0; i < shared->images.size(); i++) {
+            // nobody waits on a single texture, and the render thread needs those cores more
+            jobs.push("preload: decode image", util::jobs::Priority::Background, [i, &fileUtils, shared = shared] {
+                auto& imgState = shared->images.at(i);
 
                 // on android, resources are read from the apk file, so it's NOT thread safe. add a lock.
 #ifdef GEODE_IS_ANDROID
@@ -208,6 +288,12 @@ namespace util::cocos {
 
                 if (!buffer || filesize == 0) {
                     log::warn("failed to read image file: {}", imgState.path);
+                    shared->decoded.push(std::make_pair(i, nullptr));
+                    return;
+                }
+
+                if (auto* image = loadCachedImage(buf.get(), filesize)) {
+                    shared->decoded.push(std::make_pair(i, image));
                     return;
                 }
 
@@ -215,185 +301,239 @@ namespace util::cocos {
                 if (!image->initWithImageData(buf.get(), filesize, cocos2d::CCImage::kFmtPng)) {
                     delete image;
                     log::warn("failed to init image: {}", imgState.path);
+                    shared->decoded.push(std::make_pair(i, nullptr));
                     return;
                 }
 
-                textureInitRequests.push(std::make_pair(i, image));
+                storeCachedImage(buf.get(), filesize, image);
+
+                shared->decoded.push(std::make_pair(i, image));
             });
         }
+    }
 
-        log::debug("preload: initializing gl textures");
+    bool ParallelAssetLoader::poll(util::time::micros budget) {
+        auto deadline = util::time::now() + budget;
+        auto* textureCache = CCTextureCache::sharedTextureCache();
 
-        // initialize all the textures (must be done on the main thread)
-        while (true) {
-            if (textureInitRequests.empty()) {
-                if (threadPool.isDoingWork()) {
-                    std::this_thread::yield();
-                    continue;
-                } else if (textureInitRequests.empty()) {
-                    break;
-                }
-            }
+        // initialize the textures that are decoded by now (must be done on the main thread)
+        while (uploaded < shared->images.size() && util::time::now() < deadline) {
+            auto next = shared->decoded.tryPop();
+            if (!next) break;
+
+            uploaded++;
 
-            auto [idx, image] = textureInitRequests.popNow();
+            auto [idx, image] = *next;
+            if (!image) continue;
+
+            auto& imgState = shared->images.at(idx);
 
             auto texture = new CCTexture2D;
             if (!texture->initWithImage(image)) {
                 delete texture;
                 image->release();
-                log::warn("failed to init CCTexture2D: {}", imgStates.lock()->at(idx).path);
+                log::warn("failed to init CCTexture2D: {}", imgState.path);
                 continue;
             }
 
-            auto imguard = imgStates.lock();
-            imguard->at(idx).texture = texture;
-            textureCache->m_pTextures->setObject(texture, imguard->at(idx).path);
-            imguard.unlock();
+            imgState.texture = texture;
+
+            {
+                // sprite frame tasks of other images may be removing textures at the same time
+                auto _ = cocosWorkMutex.lock();
+                textureCache->m_pTextures->setObject(texture, imgState.path);
+            }
+
+            util::memory::MemoryTracker::get().add(util::memory::MemoryTag::Textures, util::memory::textureSize(texture));
 
             texture->release();
             image->release();
+
+            // the sprite frames can be parsed right away, while the rest is still decoding
+            this->queueSpriteFrames(idx);
+        }
+
+        return uploaded == shared->images.size() && shared->framesPending == 0;
+    }
+
+    void ParallelAssetLoader::wait() {
+        while (!this->poll(util::time::millis(100))) {
+            std::this_thread::yield();
         }
+    }
 
-        log::debug("preload: initialized textures, adding sprite frames");
+    void ParallelAssetLoader::queueSpriteFrames(size_t i) {
+        shared->framesPending++;
 
-        // now, add sprite frames
-        for (size_t i = 0; i < imgCount; i++) {
+        util::jobs::JobSystem::get().push("preload: sprite frames", util::jobs::Priority::Background, [i, shared = shared] {
             // this is the slow code but is essentially equivalent to the code below
             // auto imgState = imgStates.lock()->at(i);
             // auto plistKey = fmt::format("{}.plist", imgState.key);
             // auto fp = CCFileUtils::sharedFileUtils()->fullPathForFilename(plistKey.c_str(), false);
             // sfCache->addSpriteFramesWithFile(fp.c_str());
 
-            threadPool.pushTask([=, &imgStates] {
-                // this is a dangling reference, but we do not modify imgStates in any way, so it's not a big deal.
-                auto& imgState = imgStates.lock()->at(i);
+            struct PendingGuard {
+                std::atomic_size_t& counter;
+                ~PendingGuard() { counter--; }
+            } _pending { shared->framesPending };
 
-                if (!imgState.texture) return;
+            auto& imgState = shared->images.at(i);
+            auto* textureCache = CCTextureCache::sharedTextureCache();
 
-                auto plistKey = fmt::format("{}.plist", imgState.key);
+            auto plistKey = fmt::format("{}.plist", imgState.key);
 
-                {
-                    auto _ = cocosWorkMutex.lock();
+            {
+                auto _ = cocosWorkMutex.lock();
 
-                    if (static_cast<HookedGameManager*>(GameManager::get())->m_fields->loadedFrames.contains(plistKey)) {
-                        log::debug("already contains, skipping");
-                        return;
-                    }
+                if (static_cast<HookedGameManager*>(GameManager::get())->m_fields->loadedFrames.contains(plistKey)) {
+                    log::debug("already contains, skipping");
+                    return;
                 }
+            }
 
-                auto pathsv = std::string_view(imgState.path);
-                std::string fullPlistPath = std::string(pathsv.substr(0, pathsv.find(".png"))) + ".plist";
+            auto pathsv = std::string_view(imgState.path);
+            std::string fullPlistPath = std::string(pathsv.substr(0, pathsv.find(".png"))) + ".plist";
 
-                // file reading is not thread safe on android.
+            // file reading is not thread safe on android.
 
 #ifdef GEODE_IS_ANDROID
-                auto _ccdlock = cocosWorkMutex.lock();
+            auto _ccdlock = cocosWorkMutex.lock();
 #endif
 
-                CCDictionary* dict = CCDictionary::createWithContentsOfFileThreadSafe(fullPlistPath.c_str());
-                if (!dict) {
-                    log::debug("dict is nullptr for: {}, trying slower fallback option", fullPlistPath);
-                    gd::string fallbackPath;
-                    {
+            CCDictionary* dict = CCDictionary::createWithContentsOfFileThreadSafe(fullPlistPath.c_str());
+            if (!dict) {
+                log::debug("dict is nullptr for: {}, trying slower fallback option", fullPlistPath);
+                gd::string fallbackPath;
+                {
 #ifndef GEODE_IS_ANDROID
-                        auto _ = cocosWorkMutex.lock();
+                    auto _ = cocosWorkMutex.lock();
 #endif
-                        fallbackPath = fullPathForFilename(plistKey.c_str());
-                    }
-
-                    log::debug("attempted fallback: {}", fallbackPath);
-                    dict = CCDictionary::createWithContentsOfFileThreadSafe(fallbackPath.c_str());
+                    fallbackPath = fullPathForFilename(plistKey.c_str());
                 }
 
-                if (!dict) {
-                    log::warn("failed to find the plist for {}.", imgState.path);
+                log::debug("attempted fallback: {}", fallbackPath);
+                dict = CCDictionary::createWithContentsOfFileThreadSafe(fallbackPath.c_str());
+            }
+
+            if (!dict) {
+                log::warn("failed to find the plist for {}.", imgState.path);
 
 #ifndef GEODE_IS_ANDROID
-                    auto _ = cocosWorkMutex.lock();
+                auto _ = cocosWorkMutex.lock();
 #endif
 
-                    // remove the texture.
-                    textureCache->m_pTextures->removeObjectForKey(imgState.path);
-                    return;
-                }
+                // remove the texture.
+                util::memory::MemoryTracker::get().remove(util::memory::MemoryTag::Textures, util::memory::textureSize(imgState.texture));
+                textureCache->m_pTextures->removeObjectForKey(imgState.path);
+                return;
+            }
 
 #ifdef GEODE_IS_ANDROID
-                _ccdlock.unlock();
+            _ccdlock.unlock();
 #endif
 
-                {
-                    auto _ = cocosWorkMutex.lock();
+            {
+                auto _ = cocosWorkMutex.lock();
 
-                    _addSpriteFramesWithDictionary(dict, imgState.texture);
-                    static_cast<HookedGameManager*>(GameManager::get())->m_fields->loadedFrames.insert(plistKey);
-                }
+                _addSpriteFramesWithDictionary(dict, imgState.texture);
+                static_cast<HookedGameManager*>(GameManager::get())->m_fields->loadedFrames.insert(plistKey);
+            }
 
-                dict->release();
-            });
-        }
+            dict->release();
+        });
+    }
 
-        // wait for the creation of sprite frames to finish.
-        threadPool.join();
+    void loadAssetsParallel(const std::vector<std::string>& images) {
+        ParallelAssetLoader loader(images);
+        loader.wait();
 
         log::debug("preload: initialized sprite frames. done.");
     }
 
-    void preloadAssets(AssetPreloadStage stage) {
+    static std::vector<HookedGameManager::BatchedIconRange> iconRangesForStage(AssetPreloadStage stage) {
         using BatchedIconRange = HookedGameManager::BatchedIconRange;
 
-        log::debug("preloadAssets stage: {}", (int)stage);
-
-        auto* gm = static_cast<HookedGameManager*>(GameManager::get());
-
         switch (stage) {
-            case AssetPreloadStage::DeathEffect: {
-                std::vector<std::string> images;
-
-                for (size_t i = 1; i < 20; i++) {
-                    auto key = fmt::format("PlayerExplosion_{:02}", i);
-                    images.push_back(key);
-                }
-
-                loadAssetsParallel(images);
-            } break;
-            case AssetPreloadStage::Cube: gm->loadIconsBatched((int)IconType::Cube, 0, 484); break;
+            case AssetPreloadStage::Cube: return {{ .iconType = (int)IconType::Cube, .startId = 0, .endId = 484 }};
 
             // There are actually 169 ship icons, but for some reason, loading the last icon causes
             // a very strange bug when you have the Default mini icons option enabled.
             // I have no idea how loading a ship icon can cause a ball icon to become a cube,
             // and honestly I don't care enough.
             // https://github.com/dankmeme01/globed2/issues/93
-            case AssetPreloadStage::Ship: gm->loadIconsBatched((int)IconType::Ship, 1, 168); break;
-            case AssetPreloadStage::Ball: gm->loadIconsBatched((int)IconType::Ball, 0, 118); break;
-            case AssetPreloadStage::Ufo: gm->loadIconsBatched((int)IconType::Ufo, 1, 149); break;
-            case AssetPreloadStage::Wave: gm->loadIconsBatched((int)IconType::Wave, 1, 96); break;
-            case AssetPreloadStage::Other: {
-                std::vector<BatchedIconRange> ranges = {
-                    BatchedIconRange{
-                        .iconType = (int)IconType::Robot,
-                        .startId = 1,
-                        .endId = 68
-                    },
-                    BatchedIconRange{
-                        .iconType = (int)IconType::Spider,
-                        .startId = 1,
-                        .endId = 69
-                    },
-                    BatchedIconRange{
-                        .iconType = (int)IconType::Swing,
-                        .startId = 1,
-                        .endId = 43
-                    },
-                    BatchedIconRange{
-                        .iconType = (int)IconType::Jetpack,
-                        .startId = 1,
-                        .endId = 5
-                    },
-                };
-
-                gm->loadIconsBatched(ranges);
+            case AssetPreloadStage::Ship: return {{ .iconType = (int)IconType::Ship, .startId = 1, .endId = 168 }};
+            case AssetPreloadStage::Ball: return {{ .iconType = (int)IconType::Ball, .startId = 0, .endId = 118 }};
+            case AssetPreloadStage::Ufo: return {{ .iconType = (int)IconType::Ufo, .startId = 1, .endId = 149 }};
+            case AssetPreloadStage::Wave: return {{ .iconType = (int)IconType::Wave, .startId = 1, .endId = 96 }};
+            case AssetPreloadStage::Other: return {
+                BatchedIconRange{
+                    .iconType = (int)IconType::Robot,
+                    .startId = 1,
+                    .endId = 68
+                },
+                BatchedIconRange{
+                    .iconType = (int)IconType::Spider,
+                    .startId = 1,
+                    .endId = 69
+                },
+                BatchedIconRange{
+                    .iconType = (int)IconType::Swing,
+                    .startId = 1,
+                    .endId = 43
+                },
+                BatchedIconRange{
+                    .iconType = (int)IconType::Jetpack,
+                    .startId = 1,
+                    .endId = 5
+                },
+            };
+            default: return {};
+        }
+    }
 
-            } break;
+    AssetPreloadJob::AssetPreloadJob(AssetPreloadStage stage) {
+        log::debug("preloadAssets stage: {}", (int)stage);
+
+        if (stage == AssetPreloadStage::DeathEffect) {
+            std::vector<std::string> images;
+
+            for (size_t i = 1; i < 20; i++) {
+                auto key = fmt::format("PlayerExplosion_{:02}", i);
+                images.push_back(key);
+            }
+
+            loader = std::make_unique<ParallelAssetLoader>(images);
+            return;
+        }
+
+        auto* gm = static_cast<HookedGameManager*>(GameManager::get());
+        auto ranges = iconRangesForStage(stage);
+
+        loader = std::make_unique<ParallelAssetLoader>(gm->getIconSheets(ranges));
+        onFinished = [gm, ranges = std::move(ranges)] {
+            gm->cacheLoadedIcons(ranges);
+        };
+    }
+
+    bool AssetPreloadJob::poll(util::time::micros budget) {
+        if (!loader->poll(budget)) return false;
+
+        if (onFinished) {
+            onFinished();
+            onFinished = nullptr;
+        }
+
+        return true;
+    }
+
+    void AssetPreloadJob::wait() {
+        while (!this->poll(util::time::millis(100))) {
+            std::this_thread::yield();
+        }
+    }
+
+    void preloadAssets(AssetPreloadStage stage) {
+        switch (stage) {
             case AssetPreloadStage::AllWithoutDeathEffects: [[fallthrough]];
             case AssetPreloadStage::All: {
                 if (stage != AssetPreloadStage::AllWithoutDeathEffects) {
@@ -406,6 +546,9 @@ namespace util::cocos {
                 preloadAssets(AssetPreloadStage::Wave);
                 preloadAssets(AssetPreloadStage::Other);
             } break;
+            default: {
+                AssetPreloadJob(stage).wait();
+            } break;
         }
     }
 
@@ -428,6 +571,11 @@ namespace util::cocos {
 
         auto& settings = GlobedSettings::get();
 
+        // icons get loaded as players join instead, see `HookedGameManager::loadIconsFor`
+        if (settings.globed.demandLoadIcons) {
+            return false;
+        }
+
         // if we are on the loading screen, only load if not deferred
         if (onLoading) {
             return !settings.globed.deferPreloadAssets;
@@ -450,7 +598,7 @@ namespace util::cocos {
 
     PersistentPreloadState& getPreloadState() {
         static PersistentPreloadState state;
-        util::misc::callOnce("cocos-get-preload-state-init", [&] {
+        util::misc::callOnce<"cocos-get-preload-state-init">([&] {
             initPreloadState(state);
         });
 
@@ -460,10 +608,9 @@ namespace util::cocos {
     void resetPreloadState() {
         auto& state = getPreloadState();
         initPreloadState(state);
-    }
 
-    void cleanupThreadPool() {
-        getPreloadState().destroyPool();
+        // this happens when the game reloads, which also throws away every texture
+        util::memory::MemoryTracker::get().set(util::memory::MemoryTag::Textures, 0);
     }
 
     // transforms a string like "icon-41" into "icon-41-hd.png" depending on the current texture quality.
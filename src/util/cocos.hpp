@@ -1,11 +1,36 @@
 #pragma once
 #include <cocos2d.h>
+#include <functional>
+#include <memory>
+
+#include <util/time.hpp>
 
 namespace util::cocos {
     // Loads the given images in separate threads, in parallel. Blocks the thread until all images have been loaded.
     // This will ONLY load .png images.
     void loadAssetsParallel(const std::vector<std::string>& images);
 
+    // Non-blocking version of `loadAssetsParallel`. Images get decoded and their sprite frames parsed on the thread pool,
+    // while GL textures, which have to be created on the main thread, are created in `poll`. Every texture that is ready
+    // gets its sprite frames queued immediately, so decoding, uploading and sprite frame registration all overlap.
+    class ParallelAssetLoader {
+    public:
+        ParallelAssetLoader(const std::vector<std::string>& images);
+
+        // Does up to `budget` worth of main thread work, returns true once everything is loaded.
+        // Returns early if nothing is ready yet, so it has to be called again (usually the next frame) until it's done.
+        bool poll(util::time::micros budget);
+        // Blocks until everything is loaded
+        void wait();
+
+    private:
+        struct Shared;
+        std::shared_ptr<Shared> shared;
+        size_t uploaded = 0;
+
+        void queueSpriteFrames(size_t idx);
+    };
+
     enum class AssetPreloadStage {
         DeathEffect,
         Cube,
@@ -20,6 +45,19 @@ namespace util::cocos {
 
     void preloadAssets(AssetPreloadStage stage);
 
+    // Non-blocking version of `preloadAssets`, for a single stage (not `All` or `AllWithoutDeathEffects`). See `ParallelAssetLoader`.
+    class AssetPreloadJob {
+    public:
+        AssetPreloadJob(AssetPreloadStage stage);
+
+        bool poll(util::time::micros budget);
+        void wait();
+
+    private:
+        std::unique_ptr<ParallelAssetLoader> loader;
+        std::function<void()> onFinished;
+    };
+
     bool forcedSkipPreload();
     bool shouldTryToPreload(bool onLoading);
 
@@ -33,7 +71,6 @@ namespace util::cocos {
     struct PersistentPreloadState;
     PersistentPreloadState& getPreloadState();
     void resetPreloadState();
-    void cleanupThreadPool();
 
     gd::string fullPathForFilename(const std::string_view filename);
 
@@ -1,17 +1,30 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <queue>
 #include <map>
 #include <unordered_map>
+#include <atomic>
+#include <array>
+#include <optional>
+#include <span>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <initializer_list>
+#include <utility>
 
 namespace util::collections {
 
 /*
-* CappedQueue is a simple queue but when the size exceeds a limit, it removes the oldest element
+* CappedQueue is a fixed capacity ring buffer, when it is full pushing removes the oldest element.
+* All the storage lives inline, nothing is ever allocated. Index 0 is the oldest element.
 */
 
 template <typename T, size_t MaxSize>
 class CappedQueue {
+    static_assert(MaxSize > 0, "CappedQueue needs a capacity of at least 1");
+
 public:
     CappedQueue() = default;
     CappedQueue(const CappedQueue& other) = default;
@@ -21,68 +34,372 @@ public:
     CappedQueue& operator=(CappedQueue&&) = default;
 
     void push(T&& element) {
-        if (queue.size() >= MaxSize) {
-            queue.pop();
+        if (size_ == MaxSize) {
+            // overwrite the oldest one
+            storage[head] = std::move(element);
+            head = (head + 1) % MaxSize;
+        } else {
+            storage[(head + size_) % MaxSize] = std::move(element);
+            size_++;
         }
+    }
 
-        queue.push(std::move(element));
+    void push(const T& element) {
+        this->push(T(element));
     }
 
     size_t size() const {
-        return queue.size();
+        return size_;
     }
 
     bool empty() const {
-        return queue.empty();
+        return size_ == 0;
+    }
+
+    constexpr size_t capacity() const {
+        return MaxSize;
     }
 
     void clear() {
-        queue = {}; // queue does not have .clear() for whatever funny reason
+        head = 0;
+        size_ = 0;
+    }
+
+    const T& operator[](size_t index) const {
+        return storage[(head + index) % MaxSize];
+    }
+
+    T& operator[](size_t index) {
+        return storage[(head + index) % MaxSize];
+    }
+
+    const T& front() const {
+        return (*this)[0];
+    }
+
+    const T& back() const {
+        return (*this)[size_ - 1];
     }
 
-    T front() const {
-        return queue.front();
+    // The elements oldest first, as two contiguous parts. The second one is empty unless the elements wrap around the end of the buffer.
+    std::pair<std::span<const T>, std::span<const T>> spans() const {
+        size_t first = std::min(size_, MaxSize - head);
+        return {
+            std::span<const T>(storage.data() + head, first),
+            std::span<const T>(storage.data(), size_ - first)
+        };
     }
 
-    T back() const {
-        return queue.back();
+    // Calls `callback` with every element, oldest first
+    template <typename F>
+    void forEach(F&& callback) const {
+        auto [first, second] = this->spans();
+        for (const auto& element : first) callback(element);
+        for (const auto& element : second) callback(element);
     }
 
     std::vector<T> extract() const {
         std::vector<T> out;
+        out.reserve(size_);
 
-        std::queue<T> qcopy(queue);
-
-        while (!qcopy.empty()) {
-            out.push_back(qcopy.front());
-            qcopy.pop();
-        }
+        auto [first, second] = this->spans();
+        out.insert(out.end(), first.begin(), first.end());
+        out.insert(out.end(), second.begin(), second.end());
 
         return out;
     }
+
 protected:
-    std::queue<T> queue;
+    std::array<T, MaxSize> storage{};
+    size_t head = 0;
+    size_t size_ = 0;
+};
+
+/*
+* TimerWheel is a ring of `Slots` buckets, each tick expires everything in the next bucket.
+* Scheduling and expiring an element are both O(1), at the cost of the timeout granularity being one tick.
+*/
+
+template <typename T, size_t Slots>
+class TimerWheel {
+    static_assert(Slots > 1, "TimerWheel needs at least 2 slots");
+
+public:
+    TimerWheel() = default;
+
+    // Schedule `element` to expire after `ticks` ticks, clamped to [1, Slots - 1]
+    void schedule(T element, size_t ticks = Slots - 1) {
+        ticks = std::clamp<size_t>(ticks, 1, Slots - 1);
+        slots[(cursor + ticks) % Slots].push_back(std::move(element));
+    }
+
+    // Advance the wheel by one tick, calling `callback` with every element that expired
+    template <typename F>
+    void tick(F&& callback) {
+        cursor = (cursor + 1) % Slots;
+
+        auto& slot = slots[cursor];
+        for (auto& element : slot) {
+            callback(element);
+        }
+
+        slot.clear();
+    }
+
+    void clear() {
+        for (auto& slot : slots) {
+            slot.clear();
+        }
+    }
+
+private:
+    std::array<std::vector<T>, Slots> slots;
+    size_t cursor = 0;
+};
+
+/*
+* SpscQueue is a bounded lock-free queue for exactly one producer thread and one consumer thread.
+* `tryPush` returns false instead of blocking when the queue is full.
+*/
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+    static constexpr size_t CACHE_LINE = 64;
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Must only be called from the producer thread
+    bool tryPush(T&& element) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cachedHead_ == Capacity) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == Capacity) {
+                return false;
+            }
+        }
+
+        storage[tail & (Capacity - 1)] = std::move(element);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Must only be called from the consumer thread
+    std::optional<T> tryPop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return std::nullopt;
+            }
+        }
+
+        T value = std::move(storage[head & (Capacity - 1)]);
+        storage[head & (Capacity - 1)] = T{};
+        head_.store(head + 1, std::memory_order_release);
+
+        return value;
+    }
+
+    // Approximate when called while the other thread is active
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    constexpr size_t capacity() const {
+        return Capacity;
+    }
+
+private:
+    // consumer side
+    alignas(CACHE_LINE) std::atomic<size_t> head_ = 0;
+    size_t cachedTail_ = 0;
+
+    // producer side
+    alignas(CACHE_LINE) std::atomic<size_t> tail_ = 0;
+    size_t cachedHead_ = 0;
+
+    alignas(CACHE_LINE) std::array<T, Capacity> storage;
 };
 
-// i dont know if this works at all
-template <typename T, size_t N> requires std::is_move_constructible_v<T>
+/*
+* MpscQueue is a bounded lock-free queue for any number of producer threads and exactly one consumer thread.
+* Every slot is allocated upfront, `tryPush` returns false instead of blocking when the queue is full.
+*/
+
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "MpscQueue capacity must be a power of two");
+    static constexpr size_t CACHE_LINE = 64;
+
+public:
+    MpscQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe to call from any thread
+    bool tryPush(T&& element) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        while (true) {
+            auto& slot = slots[tail & (Capacity - 1)];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(tail);
+
+            if (diff == 0) {
+                // the slot is free, claim it
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(element);
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // the consumer hasn't popped this slot since the last lap
+                return false;
+            } else {
+                // another producer claimed it first
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Must only be called from the consumer thread
+    std::optional<T> tryPop() {
+        auto& slot = slots[head_ & (Capacity - 1)];
+
+        // either empty, or the producer that claimed the slot is still writing to it
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return std::nullopt;
+        }
+
+        T value = std::move(slot.value);
+        slot.sequence.store(head_ + Capacity, std::memory_order_release);
+        head_++;
+
+        return value;
+    }
+
+    constexpr size_t capacity() const {
+        return Capacity;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // consumer side, only touched by one thread
+    alignas(CACHE_LINE) size_t head_ = 0;
+
+    // producer side
+    alignas(CACHE_LINE) std::atomic<size_t> tail_ = 0;
+
+    alignas(CACHE_LINE) std::array<Slot, Capacity> slots;
+};
+
+/*
+* SmallVector stores up to `N` elements inline, without allocating, and moves them to the heap only once it grows past that.
+* The inline storage is uninitialized, so elements are constructed only when they are added.
+* Like `std::vector`, adding elements invalidates pointers and iterators when it has to grow.
+*/
+
+template <typename T, size_t N> requires std::is_move_constructible_v<T> && (N > 0)
 class SmallVector {
 public:
-    SmallVector() : size_(0), capacity_(N) {}
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
 
-    ~SmallVector() {
-        if (this->heapBacked()) {
-            delete[] heapStorage;
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> init) {
+        this->reserve(init.size());
+        for (const auto& value : init) {
+            this->push_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) {
+        this->reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), this->data());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        this->takeFrom(std::move(other));
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            this->clear();
+            this->reserve(other.size_);
+            std::uninitialized_copy(other.begin(), other.end(), this->data());
+            size_ = other.size_;
+        }
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            this->clear();
+            this->freeHeap();
+            this->takeFrom(std::move(other));
         }
+
+        return *this;
+    }
+
+    ~SmallVector() {
+        this->clear();
+        this->freeHeap();
     }
 
     void push_back(const T& value) {
+        this->emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        this->emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
         if (size_ == capacity_) {
-            this->expand();
+            // construct first, `args` may refer to an element that is about to be moved
+            T value(std::forward<Args>(args)...);
+            this->grow(capacity_ * 2);
+            return *std::construct_at(this->data() + size_++, std::move(value));
         }
 
-        T* dataptr = this->heapBacked() ? heapStorage : stackStorage;
-        dataptr[size_++] = value;
+        return *std::construct_at(this->data() + size_++, std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        std::destroy_at(this->data() + --size_);
+    }
+
+    void clear() {
+        std::destroy_n(this->data(), size_);
+        size_ = 0;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            this->grow(capacity);
+        }
     }
 
     size_t size() const {
@@ -93,148 +410,187 @@ public:
         return capacity_;
     }
 
-    const T& at(size_t index) const {
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    // Whether the elements have moved to the heap
+    bool spilled() const {
+        return heap != nullptr;
+    }
+
+    T* data() {
+        return heap ? heap : reinterpret_cast<T*>(inlineStorage);
+    }
+
+    const T* data() const {
+        return heap ? heap : reinterpret_cast<const T*>(inlineStorage);
+    }
+
+    T& at(size_t index) {
         if (index >= size_) {
             throw std::out_of_range("index out of range");
         }
 
-        if (this->heapBacked()) {
-            return stackStorage[index];
-        } else {
-            return heapStorage[index];
+        return this->data()[index];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
         }
+
+        return this->data()[index];
+    }
+
+    T& operator[](size_t index) {
+        return this->data()[index];
     }
 
     const T& operator[](size_t index) const {
-        return this->at(index);
+        return this->data()[index];
     }
+
+    T& front() { return this->data()[0]; }
+    const T& front() const { return this->data()[0]; }
+    T& back() { return this->data()[size_ - 1]; }
+    const T& back() const { return this->data()[size_ - 1]; }
+
+    iterator begin() { return this->data(); }
+    iterator end() { return this->data() + size_; }
+    const_iterator begin() const { return this->data(); }
+    const_iterator end() const { return this->data() + size_; }
+    const_iterator cbegin() const { return this->begin(); }
+    const_iterator cend() const { return this->end(); }
+
+    operator std::span<T>() { return std::span<T>(this->data(), size_); }
+    operator std::span<const T>() const { return std::span<const T>(this->data(), size_); }
+
 private:
-    bool heapBacked() {
-        return capacity_ != N;
-    }
+    T* heap = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) std::byte inlineStorage[N * sizeof(T)];
 
-    void expand() {
-        bool heap = this->heapBacked();
-        T* oldStorage = heap ? heapStorage : stackStorage;
+    void grow(size_t capacity) {
+        T* storage = std::allocator<T>{}.allocate(capacity);
 
-        capacity_ *= 2;
-        T* newStorage = new T[capacity_];
-        // move old elements
-        for (size_t i = 0; i < size_; i++) {
-            newStorage[i] = std::move(oldStorage[i]);
-        }
+        T* old = this->data();
+        std::uninitialized_move(old, old + size_, storage);
+        std::destroy_n(old, size_);
 
-        // if we were heap backed already before that (and are reallocating, free the previous pointer)
+        this->freeHeap();
+        heap = storage;
+        capacity_ = capacity;
+    }
 
+    void freeHeap() {
         if (heap) {
-            delete[] heapStorage;
+            std::allocator<T>{}.deallocate(heap, capacity_);
+            heap = nullptr;
+            capacity_ = N;
         }
-
-        heapStorage = newStorage;
     }
 
-    size_t size_, capacity_;
-    union {
-        T stackStorage[N];
-        T* heapStorage;
-    };
+    // expects this to be empty and not spilled
+    void takeFrom(SmallVector&& other) {
+        if (other.heap) {
+            // just steal the allocation
+            heap = std::exchange(other.heap, nullptr);
+            capacity_ = std::exchange(other.capacity_, N);
+            size_ = std::exchange(other.size_, 0);
+            return;
+        }
 
-    // iterators
+        std::uninitialized_move(other.begin(), other.end(), this->data());
+        size_ = other.size_;
+        other.clear();
+    }
+};
+
+/*
+* FlatSet is a set of integers stored as a sorted vector, for small read-mostly sets (block lists, friend lists).
+* Lookups are a binary search over contiguous memory, and a 64-bit bloom filter rejects most misses
+* without touching the vector at all, which is the common case for sets that are usually empty or tiny.
+*/
+template <typename T> requires std::is_integral_v<T>
+class FlatSet {
 public:
-    class iterator {
-    public:
-        using iterator_category = std::forward_iterator_tag;
-        using value_type = T;
-        using difference_type = std::ptrdiff_t;
-        using pointer = T*;
-        using reference = T&;
-
-        iterator(pointer ptr) : ptr_(ptr) {}
-
-        reference operator*() const { return *ptr_; }
-        pointer operator->() { return ptr_; }
-        iterator& operator++() {
-            ptr_++;
-            return *this;
-        }
-        iterator operator++(int) {
-            iterator temp = *this;
-            ++(*this);
-            return temp;
-        }
-        bool operator==(const iterator& other) const { return ptr_ == other.ptr_; }
-        bool operator!=(const iterator& other) const { return !(*this == other); }
+    bool contains(T value) const {
+        if (!(bloom & bloomBit(value))) return false;
 
-    private:
-        pointer ptr_;
-    };
+        return std::binary_search(items.begin(), items.end(), value);
+    }
 
-    class const_iterator {
-    public:
-        using iterator_category = std::forward_iterator_tag;
-        using value_type = const T;
-        using difference_type = std::ptrdiff_t;
-        using pointer = const T*;
-        using reference = const T&;
-
-        const_iterator(pointer ptr) : ptr_(ptr) {}
-
-        reference operator*() const { return *ptr_; }
-        pointer operator->() { return ptr_; }
-        const_iterator& operator++() {
-            ptr_++;
-            return *this;
-        }
-        const_iterator operator++(int) {
-            const_iterator temp = *this;
-            ++(*this);
-            return temp;
+    // Returns whether each of `values` is in the set, in the same order
+    std::vector<bool> containsMany(std::span<const T> values) const {
+        std::vector<bool> out(values.size());
+
+        for (size_t i = 0; i < values.size(); i++) {
+            out[i] = this->contains(values[i]);
         }
-        bool operator==(const const_iterator& other) const { return ptr_ == other.ptr_; }
-        bool operator!=(const const_iterator& other) const { return !(*this == other); }
 
-    private:
-        pointer ptr_;
-    };
+        return out;
+    }
 
-    iterator begin() {
-        if (this->heapBacked()) {
-            return iterator(heapStorage);
-        } else {
-            return iterator(stackStorage);
-        }
+    // Returns `true` if the value was inserted, `false` if it was already present
+    bool insert(T value) {
+        auto it = std::lower_bound(items.begin(), items.end(), value);
+        if (it != items.end() && *it == value) return false;
+
+        items.insert(it, value);
+        bloom |= bloomBit(value);
+        return true;
     }
 
-    iterator end() {
-        if (this->heapBacked()) {
-            return iterator(heapStorage + size_);
-        } else {
-            return iterator(stackStorage + size_);
+    // Returns `true` if the value was removed
+    bool erase(T value) {
+        auto it = std::lower_bound(items.begin(), items.end(), value);
+        if (it == items.end() || *it != value) return false;
+
+        items.erase(it);
+
+        // can't unset a single bit, other values may share it
+        bloom = 0;
+        for (T v : items) {
+            bloom |= bloomBit(v);
         }
+
+        return true;
     }
 
-    const_iterator begin() const {
-        if (this->heapBacked()) {
-            return const_iterator(heapStorage);
-        } else {
-            return const_iterator(stackStorage);
-        }
+    void clear() {
+        items.clear();
+        bloom = 0;
     }
 
-    const_iterator end() const {
-        if (this->heapBacked()) {
-            return const_iterator(heapStorage + size_);
-        } else {
-            return const_iterator(stackStorage + size_);
-        }
+    void reserve(size_t n) {
+        items.reserve(n);
+    }
+
+    size_t size() const {
+        return items.size();
     }
 
-    const_iterator cbegin() const {
-        return this->begin();
+    bool empty() const {
+        return items.empty();
     }
 
-    const_iterator cend() const {
-        return this->end();
+    auto begin() const {
+        return items.cbegin();
+    }
+
+    auto end() const {
+        return items.cend();
+    }
+
+private:
+    std::vector<T> items;
+    uint64_t bloom = 0;
+
+    static uint64_t bloomBit(T value) {
+        // fibonacci hashing, the top 6 bits pick the bit
+        return uint64_t(1) << ((static_cast<uint64_t>(value) * 0x9E3779B97F4A7C15ull) >> 58);
     }
 };
 
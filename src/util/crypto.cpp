@@ -49,6 +49,12 @@ bytevector pwHash(const byte* input, size_t len) {
     return out;
 }
 
+geode::Task<bytevector> pwHashAsync(std::string input) {
+    return geode::Task<bytevector>::run([input = std::move(input)](auto, auto) -> geode::Task<bytevector>::Result {
+        return pwHash(input);
+    }, "pwHash");
+}
+
 bytevector simpleHash(const std::string_view input) {
     return simpleHash(reinterpret_cast<const byte*>(input.data()), input.size());
 }
@@ -82,17 +88,55 @@ bool stringsEqual(const std::string_view s1, const std::string_view s2) {
     return (result == 0);
 }
 
-std::string base64Encode(const byte* source, size_t size, Base64Variant variant_) {
+static bool isUrlsafe(Base64Variant variant) {
+    return variant == Base64Variant::URLSAFE || variant == Base64Variant::URLSAFE_NO_PAD;
+}
+
+size_t base64EncodedLength(size_t size, Base64Variant variant) {
+    return sodium_base64_ENCODED_LEN(size, base64VariantToInt(variant));
+}
+
+size_t base64DecodedMaxLength(size_t size) {
+    // unpadded input can end in a partial group
+    return (size + 3) / 4 * 3;
+}
+
+size_t base64EncodeInto(const byte* source, size_t size, char* dest, Base64Variant variant_) {
     int variant = base64VariantToInt(variant_);
 
-    size_t length = sodium_base64_ENCODED_LEN(size, variant);
+    // simd handles whole blocks, libsodium does the rest along with padding and the null terminator
+    size_t done = util::simd::base64EncodeBulk(source, size, dest, isUrlsafe(variant_));
+    size_t written = done / 3 * 4;
 
-    std::string ret;
-    ret.resize(length);
+    size_t tailLength = sodium_base64_ENCODED_LEN(size - done, variant);
+    sodium_bin2base64(dest + written, tailLength, source + done, size - done, variant);
+
+    return written + tailLength - 1;
+}
 
-    sodium_bin2base64(ret.data(), length, source, size, variant);
+size_t base64DecodeInto(const byte* source, size_t size, byte* dest, size_t destSize, Base64Variant variant) {
+    auto chars = reinterpret_cast<const char*>(source);
 
-    ret.resize(length - 1); // get rid of the trailing null byte
+    size_t done = util::simd::base64DecodeBulk(chars, size, dest, isUrlsafe(variant));
+    size_t written = done / 4 * 3;
+
+    CRYPTO_REQUIRE(written <= destSize, "base64 output buffer too small")
+
+    size_t tailLength;
+    CRYPTO_ERR_CHECK(sodium_base642bin(
+        dest + written, destSize - written,
+        chars + done, size - done,
+        nullptr, &tailLength, nullptr, base64VariantToInt(variant)
+    ), "invalid base64 string")
+
+    return written + tailLength;
+}
+
+std::string base64Encode(const byte* source, size_t size, Base64Variant variant) {
+    std::string ret;
+    ret.resize(base64EncodedLength(size, variant));
+
+    ret.resize(base64EncodeInto(source, size, ret.data(), variant)); // get rid of the trailing null byte
 
     return ret;
 }
@@ -106,18 +150,9 @@ std::string base64Encode(const std::string_view source, Base64Variant variant) {
 }
 
 bytevector base64Decode(const byte* source, size_t size, Base64Variant variant) {
-    auto outMaxLen = size / 4 * 3;
-    bytevector out(outMaxLen);
+    bytevector out(base64DecodedMaxLength(size));
 
-    size_t outRealLen;
-    // crazy
-    CRYPTO_ERR_CHECK(sodium_base642bin(
-        out.data(), outMaxLen,
-        reinterpret_cast<const char*>(source), size,
-        nullptr, &outRealLen, nullptr, base64VariantToInt(variant)
-    ), "invalid base64 string")
-
-    out.resize(outRealLen); // necessary
+    out.resize(base64DecodeInto(source, size, out.data(), out.size(), variant)); // necessary
 
     return out;
 }
@@ -130,15 +165,43 @@ bytevector base64Decode(const bytevector& source, Base64Variant variant) {
     return base64Decode(source.data(), source.size(), variant);
 }
 
-std::string hexEncode(const byte* source, size_t size) {
-    auto outLen = size * 2 + 1;
+size_t hexEncodeInto(const byte* source, size_t size, char* dest) {
+    size_t done = util::simd::hexEncodeBulk(source, size, dest);
 
-    std::string ret;
-    ret.resize(outLen);
+    // branchless like libsodium, the input is often key material
+    for (size_t i = done; i < size; i++) {
+        unsigned int hi = source[i] >> 4;
+        unsigned int lo = source[i] & 0xf;
 
-    sodium_bin2hex(ret.data(), outLen, source, size);
+        dest[i * 2] = static_cast<char>(87U + hi + (((hi - 10U) >> 8) & ~38U));
+        dest[i * 2 + 1] = static_cast<char>(87U + lo + (((lo - 10U) >> 8) & ~38U));
+    }
+
+    return size * 2;
+}
 
-    ret.resize(outLen - 1); // get rid of the trailing null byte
+size_t hexDecodeInto(const byte* source, size_t size, byte* dest, size_t destSize) {
+    auto chars = reinterpret_cast<const char*>(source);
+
+    CRYPTO_REQUIRE(size / 2 <= destSize, "hex output buffer too small")
+
+    size_t done = util::simd::hexDecodeBulk(chars, size, dest);
+
+    size_t tailLength;
+    CRYPTO_ERR_CHECK(sodium_hex2bin(
+        dest + done / 2, destSize - done / 2,
+        chars + done, size - done,
+        nullptr, &tailLength, nullptr
+    ), "invalid hex string")
+
+    return done / 2 + tailLength;
+}
+
+std::string hexEncode(const byte* source, size_t size) {
+    std::string ret;
+    ret.resize(size * 2);
+
+    hexEncodeInto(source, size, ret.data());
 
     return ret;
 }
@@ -152,18 +215,9 @@ std::string hexEncode(const std::string_view source) {
 }
 
 bytevector hexDecode(const byte* source, size_t size) {
-    size_t outLen = size / 2;
-    bytevector out(outLen);
-
-    size_t realOutLen;
-
-    CRYPTO_ERR_CHECK(sodium_hex2bin(
-        out.data(), outLen,
-        reinterpret_cast<const char*>(source), size,
-        nullptr, &realOutLen, nullptr
-    ), "invalid hex string")
+    bytevector out(size / 2);
 
-    out.resize(realOutLen);
+    out.resize(hexDecodeInto(source, size, out.data(), out.size()));
 
     return out;
 }
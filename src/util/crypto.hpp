@@ -2,6 +2,8 @@
 #include <util/data.hpp>
 #include "adler32.hpp"
 
+#include <Geode/utils/Task.hpp>
+
 #define CRYPTO_REQUIRE(condition, message) GLOBED_REQUIRE(condition, "crypto error: " message)
 #define CRYPTO_ERR_CHECK(result, message) CRYPTO_REQUIRE(result == 0, message)
 
@@ -18,6 +20,9 @@ namespace util::crypto {
     // generate a hash from this buffer and return it together with the salt prepended
     data::bytevector pwHash(const data::byte* input, size_t len);
 
+    // `pwHash` on a worker thread, it is deliberately slow and can freeze the game on weaker devices
+    geode::Task<data::bytevector> pwHashAsync(std::string input);
+
     // generate a simple, consistent hash from this string
     data::bytevector simpleHash(const std::string_view input);
     // generate a simple, consistent hash from this bytevector
@@ -63,6 +68,23 @@ namespace util::crypto {
     // decodes the given hex bytevector into a bytevector
     data::bytevector hexDecode(const data::bytevector& source);
 
+    // Variants that write into a caller provided buffer instead of allocating, for hot paths.
+
+    // size of the buffer `base64EncodeInto` needs, including room for a null terminator
+    size_t base64EncodedLength(size_t size, Base64Variant variant = Base64Variant::STANDARD);
+    // upper bound for the size of the data `size` base64 characters decode into
+    size_t base64DecodedMaxLength(size_t size);
+
+    // encodes into `dest`, which must hold `base64EncodedLength(size, variant)` chars. returns the length of the output, without the null terminator
+    size_t base64EncodeInto(const data::byte* source, size_t size, char* dest, Base64Variant variant = Base64Variant::STANDARD);
+    // decodes into `dest`, returns the amount of bytes written. throws if the input is invalid or doesn't fit
+    size_t base64DecodeInto(const data::byte* source, size_t size, data::byte* dest, size_t destSize, Base64Variant variant = Base64Variant::STANDARD);
+
+    // encodes into `dest`, which must hold `size * 2` chars. no null terminator is written, returns `size * 2`
+    size_t hexEncodeInto(const data::byte* source, size_t size, char* dest);
+    // decodes into `dest`, which must hold at least `size / 2` bytes, returns the amount of bytes written. throws if the input is invalid
+    size_t hexDecodeInto(const data::byte* source, size_t size, data::byte* dest, size_t destSize);
+
     // convert a `Base64Variant` enum to an int for libsodium API
     int base64VariantToInt(Base64Variant variant);
 }
@@ -5,6 +5,7 @@
 #include <array>
 
 #include <util/misc.hpp>
+#include <util/simd.hpp>
 
 namespace util::data {
     using byte = uint8_t;
@@ -96,6 +97,20 @@ namespace util::data {
         return val;
     }
 
+    // Like `maybeByteswap` but for a whole array of primitives (which may be unaligned), converted in place with SIMD.
+    template <typename T>
+    inline void maybeByteswapArray(T* data, size_t count) {
+        static_assert(IsPrimitive<T>, "Unsupported type for maybeByteswapArray");
+
+        if constexpr (GLOBED_LITTLE_ENDIAN && sizeof(T) == 2) {
+            simd::byteswap16(reinterpret_cast<uint16_t*>(data), count);
+        } else if constexpr (GLOBED_LITTLE_ENDIAN && sizeof(T) == 4) {
+            simd::byteswap32(reinterpret_cast<uint32_t*>(data), count);
+        } else if constexpr (GLOBED_LITTLE_ENDIAN && sizeof(T) == 8) {
+            simd::byteswap64(reinterpret_cast<uint64_t*>(data), count);
+        }
+    }
+
     // Converts the bit count into bytes required to fit it.
     // That means, 15 or 16 bits equals 2 bytes, but 17 bits equals 3 bytes.
     constexpr size_t bitsToBytes(size_t bits) {
@@ -8,8 +8,11 @@
 #endif
 
 #include <any>
+#include <bit>
+#include <cstring>
 
 #include <util/format.hpp>
+#include <util/profiler.hpp>
 #include <util/rng.hpp>
 
 using namespace geode::prelude;
@@ -35,11 +38,9 @@ namespace util::debug {
     }
 
     time::micros Benchmarker::run(std::function<void()>&& func) {
-        auto& random = rng::Random::get();
-        auto id = fmt::format("bb-rng-{}", random.generate<uint32_t>());
-        this->start(id);
+        auto start = time::now();
         func();
-        return this->end(id);
+        return time::as<time::micros>(time::now() - start);
     }
 
     void Benchmarker::runAndLog(std::function<void()>&& func, const std::string_view identifier) {
@@ -47,26 +48,233 @@ namespace util::debug {
         log::debug("{} took {} to run", identifier, util::format::formatDuration(took));
     }
 
-    std::vector<size_t> DataWatcher::updateLastData(DataWatcher::WatcherEntry& entry) {
-        std::vector<size_t> changedBytes;
+    void MainThreadTimer::add(Section section, time::clock::duration took) {
+        frameSections[static_cast<size_t>(section)] += took;
 
-        for (size_t off = 0; off < entry.size; off++) {
-            auto rbyte = *(data::byte*)(entry.address + off);
-            if (rbyte != entry.lastData[off]) {
-                changedBytes.push_back(off);
-                entry.lastData[off] = rbyte;
+        if (--depth == 0) {
+            total += took;
+            frameSpent += took;
+            lifetime.spent += took;
+        }
+    }
+
+    void MainThreadTimer::frame(time::micros budget) {
+        if (this->budget.count() > 0 && frameSpent > this->budget) {
+            overruns++;
+            overrunStreak++;
+
+            for (size_t i = 0; i < SECTION_COUNT; i++) {
+                streakSections[i] += frameSections[i];
+            }
+
+            if (overrunStreak == SUSTAINED_OVERRUN) {
+                this->logOverrun();
+            }
+        } else {
+            if (overrunStreak >= SUSTAINED_OVERRUN) {
+                log::info("Main thread back within budget after {} frames", overrunStreak);
+            }
+
+            overrunStreak = 0;
+            streakSections = {};
+        }
+
+        frames++;
+        lifetime.frames++;
+        frameSpent = {};
+        frameSections = {};
+        this->budget = budget;
+    }
+
+    bool MainThreadTimer::hasBudget() const {
+        if (budget.count() == 0) return true;
+
+        auto spent = frameSpent;
+        if (depth > 0) {
+            spent += time::now() - outerStart;
+        }
+
+        return spent < budget;
+    }
+
+    bool MainThreadTimer::tryRun(uint8_t& deferrals) {
+        if (this->hasBudget() || deferrals >= MAX_DEFERRALS) {
+            deferrals = 0;
+            return true;
+        }
+
+        deferrals++;
+        deferred++;
+        return false;
+    }
+
+    MainThreadTimer::Stats MainThreadTimer::takeStats() {
+        Stats stats {
+            .averagePerFrame = frames == 0 ? time::micros(0) : time::as<time::micros>(total / frames),
+            .overruns = overruns,
+            .deferred = deferred,
+        };
+
+        total = {};
+        frames = 0;
+        overruns = 0;
+        deferred = 0;
+
+        return stats;
+    }
+
+    MainThreadTimer::Totals MainThreadTimer::totals() const {
+        return lifetime;
+    }
+
+    const char* MainThreadTimer::sectionName(Section section) {
+        switch (section) {
+            case Section::Update: return "selUpdate";
+            case Section::SendPlayerData: return "selSendPlayerData";
+            case Section::PeriodicalUpdate: return "selPeriodicalUpdate";
+            case Section::Estimators: return "selUpdateEstimators";
+            case Section::DiscordRPC: return "selUpdateDRPC";
+            case Section::PacketListeners: return "PacketListenerPool::update";
+            default: return "other";
+        }
+    }
+
+    void MainThreadTimer::logOverrun() {
+        size_t busiest = 0;
+        for (size_t i = 1; i < SECTION_COUNT; i++) {
+            if (streakSections[i] > streakSections[busiest]) busiest = i;
+        }
+
+        log::warn(
+            "Main thread over the {} budget for {} frames in a row, most of it in {} ({} per frame)",
+            util::format::formatDuration(budget),
+            overrunStreak,
+            sectionName(static_cast<Section>(busiest)),
+            util::format::formatDuration(time::as<time::micros>(streakSections[busiest] / overrunStreak))
+        );
+    }
+
+    bool DataWatcher::start(const std::string_view id, uintptr_t address, size_t size) {
+        if (size > MAX_WATCH_SIZE) {
+            log::warn("[DW] {} is {} bytes, only up to {} can be watched", id, size, MAX_WATCH_SIZE);
+            return false;
+        }
+
+        WatcherEntry* entry = nullptr;
+        for (size_t i = 0; i < _count; i++) {
+            if (_entries[i].id == id) {
+                entry = &_entries[i];
+                break;
+            }
+        }
+
+        if (!entry) {
+            if (_count == MAX_WATCHES) {
+                log::warn("[DW] can't watch {}, all {} slots are taken", id, MAX_WATCHES);
+                return false;
+            }
+
+            entry = &_entries[_count++];
+        }
+
+        entry->id = InlineString<32>(id);
+        entry->address = address;
+        entry->size = static_cast<uint32_t>(size);
+        entry->suppressed = 0;
+        entry->lastLog = {};
+        std::memcpy(entry->lastData.data(), reinterpret_cast<const void*>(address), size);
+
+        return true;
+    }
+
+    void DataWatcher::stop(const std::string_view id) {
+        for (size_t i = 0; i < _count; i++) {
+            if (_entries[i].id == id) {
+                // keep the used slots contiguous
+                std::swap(_entries[i], _entries[_count - 1]);
+                _count--;
+                return;
+            }
+        }
+    }
+
+    size_t DataWatcher::updateLastData(DataWatcher::WatcherEntry& entry, std::span<Range> out) {
+        auto* current = reinterpret_cast<const uint8_t*>(entry.address);
+        auto* last = entry.lastData.data();
+
+        size_t found = 0;
+        bool inRange = false;
+
+        // `inRange` is set while the previous byte changed too, so this one extends the last range
+        auto markChanged = [&](size_t off) {
+            if (inRange) {
+                if (found <= out.size()) out[found - 1].length++;
+                return;
+            }
+
+            found++;
+            inRange = true;
+
+            if (found <= out.size()) {
+                out[found - 1] = Range { static_cast<uint32_t>(off), 1 };
+            }
+        };
+
+        for (size_t block = 0; block < entry.size; block += BLOCK_SIZE) {
+            size_t len = std::min(BLOCK_SIZE, entry.size - block);
+
+            // the common case, nothing changed in this block. memcmp of a small constant size compiles down to a vector compare
+            if (len == BLOCK_SIZE && std::memcmp(current + block, last + block, BLOCK_SIZE) == 0) {
+                inRange = false;
+                continue;
+            }
+
+            for (size_t off = block; off < block + len; off++) {
+                if (current[off] != last[off]) {
+                    markChanged(off);
+                } else {
+                    inRange = false;
+                }
             }
+
+            std::memcpy(last + block, current + block, len);
         }
 
-        return changedBytes;
+        return found;
     }
 
     void DataWatcher::updateAll() {
-        for (auto& [key, value] : _entries) {
-            auto modified = this->updateLastData(value);
-            if (modified.empty()) continue;
+        if (_count == 0) return;
+
+        std::array<Range, 16> ranges;
+        std::array<char, 2 * 64> hex;
+        auto now = time::now();
 
-            log::debug("[DW] {} modified - {}, hexdump: {}", key, modified, hexDumpAddress(value.address, value.size));
+        for (size_t i = 0; i < _count; i++) {
+            auto& entry = _entries[i];
+
+            size_t found = this->updateLastData(entry, ranges);
+            if (found == 0) continue;
+
+            if (now - entry.lastLog < LOG_INTERVAL) {
+                entry.suppressed++;
+                continue;
+            }
+
+            size_t shown = std::min(found, ranges.size());
+            log::debug(
+                "[DW] {} modified, {} ranges{} (+{} changes not logged)",
+                entry.id, found, found > shown ? fmt::format(" ({} shown)", shown) : "", entry.suppressed
+            );
+
+            for (size_t r = 0; r < shown; r++) {
+                auto range = ranges[r];
+                size_t written = hexDumpInto(reinterpret_cast<const void*>(entry.address + range.offset), range.length, hex);
+                log::debug("[DW]   +{:#x} ({} bytes): {}{}", range.offset, range.length, std::string_view(hex.data(), written), written < range.length * 2 ? ".." : "");
+            }
+
+            entry.lastLog = now;
+            entry.suppressed = 0;
         }
     }
 
@@ -85,72 +293,165 @@ namespace util::debug {
             );
             log::debug("Average bytes per packet: {}", format::formatBytes((uint64_t)bytesPerPacket));
 
-            // sort packets by the counts
-            std::vector<std::pair<packetid_t, size_t>> pc(packetCounts.begin(), packetCounts.end());
-            std::sort(pc.begin(), pc.end(), [](const auto& a, const auto& b) {
-                return a.second > b.second;
-            });
+            if (untracked > 0) {
+                log::debug("Packets of untracked types: {}", untracked);
+            }
 
-            for (const auto& [id, count] : pc) {
-                log::debug("Packet {} - {} occurrences", id, count);
+            for (const auto& type : types) {
+                log::debug(
+                    "Packet {} - {} sent, {} received, {:.1f}/s, {}/s",
+                    type.id, type.totalOut, type.totalIn, type.packetsPerSec, format::formatBytes((uint64_t)type.bytesPerSec)
+                );
             }
         }
         log::debug("==== Packet summary end ====");
     }
+
+    static int64_t currentSecond() {
+        return time::asSeconds(time::now().time_since_epoch());
+    }
+
+    PacketLogger::TypeCounters* PacketLogger::slotFor(packetid_t id) {
+        // fibonacci hashing, packet ids are sequential so they would cluster otherwise
+        size_t start = (static_cast<uint32_t>(id) * 2654435769u) >> 24;
+
+        for (size_t i = 0; i < TYPE_SLOTS; i++) {
+            auto& slot = types[(start + i) % TYPE_SLOTS];
+
+            uint32_t current = slot.id.load(std::memory_order_acquire);
+            if (current == id) return &slot;
+
+            if (current == EMPTY_SLOT) {
+                // someone else can claim it first, for this or a different id
+                if (slot.id.compare_exchange_strong(current, id, std::memory_order_acq_rel) || current == id) {
+                    return &slot;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
     void PacketLogger::record(packetid_t id, bool encrypted, bool outgoing, size_t bytes) {
-#ifdef GLOBED_DEBUG_PACKETS
-# ifdef GLOBED_DEBUG_PACKETS_PRINT
+#ifdef GLOBED_DEBUG_PACKETS_PRINT
         log::debug("{} packet {}, encrypted: {}, bytes: {}", outgoing ? "Sending" : "Receiving", id, encrypted ? "true" : "false", bytes);
-# endif // GLOBED_DEBUG_PACKETS_PRINT
-        queue.push(PacketLog {
-            .id = id,
-            .encrypted = encrypted,
-            .outgoing = outgoing,
-            .bytes = bytes
-        });
-#endif // GLOBED_DEBUG_PACKETS
+#endif // GLOBED_DEBUG_PACKETS_PRINT
+
+        // recorded on the thread doing the sending or receiving, so they line up with its track in traces
+        if (outgoing) {
+            GLOBED_PROFILE_INSTANT("net: packet sent", id, bytes);
+        } else {
+            GLOBED_PROFILE_INSTANT("net: packet received", id, bytes);
+        }
+
+        auto* slot = this->slotFor(id);
+        if (!slot) {
+            overflowed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        constexpr auto relaxed = std::memory_order_relaxed;
+
+        (outgoing ? slot->packetsOut : slot->packetsIn).fetch_add(1, relaxed);
+        (outgoing ? slot->bytesOut : slot->bytesIn).fetch_add(bytes, relaxed);
+        if (encrypted) slot->encrypted.fetch_add(1, relaxed);
+
+        size_t bucket = bytes == 0 ? 0 : std::min<size_t>(std::bit_width(bytes) - 1, PacketTypeSummary::SIZE_BUCKETS - 1);
+        slot->sizes[bucket].fetch_add(1, relaxed);
+
+        // whoever moves a bucket to a new second resets it. a packet recorded by the other thread in between can get lost,
+        // which is fine for a rate
+        int64_t second = currentSecond();
+        auto& rate = slot->rate[second % RATE_BUCKETS];
+        int64_t seen = rate.second.load(std::memory_order_acquire);
+        if (seen != second && rate.second.compare_exchange_strong(seen, second, std::memory_order_acq_rel)) {
+            rate.packets.store(0, relaxed);
+            rate.bytes.store(0, relaxed);
+        }
+
+        rate.packets.fetch_add(1, relaxed);
+        rate.bytes.fetch_add(bytes, relaxed);
     }
 
     PacketLogSummary PacketLogger::getSummary() {
         PacketLogSummary summary = {};
 
-        for (auto& log : queue.extract()) {
-            summary.total++;
+        constexpr auto relaxed = std::memory_order_relaxed;
+        int64_t second = currentSecond();
 
-            summary.totalBytes += log.bytes;
-            if (log.outgoing) {
-                summary.totalOut++;
-                summary.totalBytesOut += log.bytes;
-            } else {
-                summary.totalIn++;
-                summary.totalBytesIn += log.bytes;
+        for (auto& slot : types) {
+            uint32_t id = slot.id.load(std::memory_order_acquire);
+            if (id == EMPTY_SLOT) continue;
+
+            PacketTypeSummary type = {};
+            type.id = static_cast<packetid_t>(id);
+            type.totalIn = slot.packetsIn.load(relaxed);
+            type.totalOut = slot.packetsOut.load(relaxed);
+            type.totalEncrypted = slot.encrypted.load(relaxed);
+            type.totalBytesIn = slot.bytesIn.load(relaxed);
+            type.totalBytesOut = slot.bytesOut.load(relaxed);
+
+            for (size_t i = 0; i < type.sizeHistogram.size(); i++) {
+                type.sizeHistogram[i] = slot.sizes[i].load(relaxed);
             }
 
-            log.encrypted ? summary.totalEncrypted++ : summary.totalCleartext++;
+            // only full seconds, a bucket that wasn't touched during its second still holds an older one and is skipped
+            uint64_t windowPackets = 0, windowBytes = 0;
+            for (int64_t s = second - (RATE_BUCKETS - 1); s < second; s++) {
+                auto& rate = slot.rate[s % RATE_BUCKETS];
+                if (rate.second.load(std::memory_order_acquire) != s) continue;
 
-            if (!summary.packetCounts.contains(log.id)) {
-                summary.packetCounts[log.id] = 0;
+                windowPackets += rate.packets.load(relaxed);
+                windowBytes += rate.bytes.load(relaxed);
             }
 
-            summary.packetCounts[log.id]++;
+            type.packetsPerSec = static_cast<float>(windowPackets) / (RATE_BUCKETS - 1);
+            type.bytesPerSec = static_cast<float>(windowBytes) / (RATE_BUCKETS - 1);
+
+            summary.totalIn += type.totalIn;
+            summary.totalOut += type.totalOut;
+            summary.totalEncrypted += type.totalEncrypted;
+            summary.totalBytesIn += type.totalBytesIn;
+            summary.totalBytesOut += type.totalBytesOut;
+
+            summary.types.push_back(type);
         }
 
-        summary.bytesPerPacket = (float)summary.totalBytes / summary.total;
-        summary.encryptedRatio = (float)summary.totalEncrypted / summary.total;
+        std::sort(summary.types.begin(), summary.types.end(), [](const auto& a, const auto& b) {
+            return a.bytesPerSec > b.bytesPerSec;
+        });
+
+        summary.total = summary.totalIn + summary.totalOut;
+        summary.totalCleartext = summary.total - summary.totalEncrypted;
+        summary.totalBytes = summary.totalBytesIn + summary.totalBytesOut;
+
+        summary.bytesPerPacket = summary.total == 0 ? 0.f : (float)summary.totalBytes / summary.total;
+        summary.encryptedRatio = summary.total == 0 ? 0.f : (float)summary.totalEncrypted / summary.total;
+
+        summary.untracked = overflowed.load(relaxed);
 
         return summary;
     }
 
     std::string hexDumpAddress(uintptr_t addr, size_t bytes) {
-        unsigned char* ptr = reinterpret_cast<unsigned char*>(addr);
+        std::string out(bytes * 2, '\0');
+        hexDumpInto(reinterpret_cast<const void*>(addr), bytes, out);
+
+        return out;
+    }
+
+    size_t hexDumpInto(const void* ptr, size_t bytes, std::span<char> out) {
+        constexpr char digits[] = "0123456789abcdef";
 
-        std::stringstream ss;
+        auto* data = reinterpret_cast<const uint8_t*>(ptr);
+        size_t count = std::min(bytes, out.size() / 2);
 
-        for (size_t i = 0; i < bytes; i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(i[ptr]);
+        for (size_t i = 0; i < count; i++) {
+            out[i * 2] = digits[data[i] >> 4];
+            out[i * 2 + 1] = digits[data[i] & 0xf];
         }
 
-        return ss.str();
+        return count * 2;
     }
 
     std::string hexDumpAddress(void* ptr, size_t bytes) {
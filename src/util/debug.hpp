@@ -1,4 +1,7 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <span>
 #include <unordered_map>
 
 #include <asp/sync.hpp>
@@ -10,6 +13,7 @@
 #include <util/singleton.hpp>
 
 namespace util::debug {
+    // For one-off measurements, `start` and `end` allocate. In hot paths use `GLOBED_PROFILE_ZONE` from util/profiler.hpp
     class Benchmarker : public SingletonBase<Benchmarker> {
     public:
         void start(const std::string_view id);
@@ -22,43 +26,158 @@ namespace util::debug {
         std::unordered_map<std::string, time::time_point> _entries;
     };
 
+    // Watches memory regions and logs when they change, used to find out what changed in GD structs between updates.
+    // All storage is fixed, so watches are cheap enough to leave on in release builds. Memory is compared in blocks,
+    // only blocks that differ are looked at byte by byte, and each watch logs at most once per `LOG_INTERVAL`.
     class DataWatcher : public SingletonBase<DataWatcher> {
     public:
+        static constexpr size_t MAX_WATCHES = 16;
+        static constexpr size_t MAX_WATCH_SIZE = 1024;
+        static constexpr size_t BLOCK_SIZE = 16;
+        static constexpr auto LOG_INTERVAL = time::seconds(1);
+
+        // Bytes `[offset, offset + length)` changed
+        struct Range {
+            uint32_t offset;
+            uint32_t length;
+        };
+
         struct WatcherEntry {
-            uintptr_t address;
-            size_t size;
-            data::bytevector lastData;
+            InlineString<32> id;
+            uintptr_t address = 0;
+            uint32_t size = 0;
+            uint32_t suppressed = 0; // changes that weren't logged because of the rate limit
+            time::time_point lastLog{};
+            alignas(BLOCK_SIZE) std::array<uint8_t, MAX_WATCH_SIZE> lastData{};
         };
 
-        void start(const std::string_view id, uintptr_t address, size_t size) {
-            auto idstr = std::string(id);
-            _entries.emplace(std::string(idstr), WatcherEntry {
-                .address = address,
-                .size = size,
-                .lastData = data::bytevector(size)
-            });
+        // Returns false if all slots are taken or `size` is over `MAX_WATCH_SIZE`. Starting a watch with an existing id replaces it.
+        bool start(const std::string_view id, uintptr_t address, size_t size);
 
-            this->updateLastData(_entries.at(idstr));
+        bool start(const std::string_view id, void* address, size_t size) {
+            return this->start(id, (uintptr_t)address, size);
         }
 
-        void start(const std::string_view id, void* address, size_t size) {
-            this->start(id, (uintptr_t)address, size);
-        }
+        void stop(const std::string_view id);
 
-        // returns the indexes of bytes that were modified since last read
-        std::vector<size_t> updateLastData(WatcherEntry& entry);
+        // Writes ranges of bytes modified since the last read into `out` and updates the stored copy.
+        // Returns the amount of ranges found, which can be more than `out.size()`, the ones that don't fit are dropped.
+        size_t updateLastData(WatcherEntry& entry, std::span<Range> out);
 
         void updateAll();
 
     private:
-        std::unordered_map<std::string, WatcherEntry> _entries;
+        std::array<WatcherEntry, MAX_WATCHES> _entries;
+        size_t _count = 0;
     };
 
-    struct PacketLog {
+    // How much of each frame the main thread spends in globed code. Top level entry points (scheduled functions, hooks) are measured
+    // with `MainThreadTimer::Scope`, a scope nested in another one counts towards its own section but not towards the frame total.
+    // It doubles as a budget watchdog, non-critical work asks `tryRun` first and gets pushed to a later frame while this one is over budget.
+    class MainThreadTimer : public SingletonBase<MainThreadTimer> {
+    public:
+        enum class Section : uint8_t {
+            Update,
+            SendPlayerData,
+            PeriodicalUpdate,
+            Estimators,
+            DiscordRPC,
+            PacketListeners,
+            Other,
+            Count,
+        };
+
+        static constexpr size_t SECTION_COUNT = static_cast<size_t>(Section::Count);
+
+        // Deferred work is skipped at most this many times in a row, so it can't be starved by a level that is always over budget
+        static constexpr uint8_t MAX_DEFERRALS = 8;
+        // This many frames in a row over budget get logged
+        static constexpr size_t SUSTAINED_OVERRUN = 30;
+
+        class Scope {
+        public:
+            Scope(Section section = Section::Other) : section(section), start(time::now()) {
+                auto& timer = MainThreadTimer::get();
+                if (timer.depth++ == 0) timer.outerStart = start;
+            }
+
+            ~Scope() { MainThreadTimer::get().add(section, time::now() - start); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Section section;
+            time::time_point start;
+        };
+
+        struct Stats {
+            time::micros averagePerFrame;
+            size_t overruns; // frames over budget
+            size_t deferred; // times non-critical work was pushed to a later frame
+        };
+
+        // Called once at the start of every frame. A budget of zero disables the watchdog.
+        void frame(time::micros budget);
+
+        // Whether the current frame still has time left, including the time spent in the scope that is currently running
+        bool hasBudget() const;
+
+        // For non-critical work, returns whether it should run now. `deferrals` belongs to the caller
+        // and counts how many times in a row it was skipped, it is reset whenever this returns true.
+        bool tryRun(uint8_t& deferrals);
+
+        // averages and counts since the last call, the average is zero if no frames have passed
+        Stats takeStats();
+
+        struct Totals {
+            time::clock::duration spent;
+            size_t frames;
+        };
+
+        // since startup, never reset by `takeStats`, so any number of readers can take the difference of two calls
+        Totals totals() const;
+
+        static const char* sectionName(Section section);
+
+    private:
+        time::clock::duration total{};
+        size_t frames = 0;
+        Totals lifetime{};
+        size_t overruns = 0;
+        size_t deferred = 0;
+
+        time::micros budget{0};
+        time::clock::duration frameSpent{};
+        std::array<time::clock::duration, SECTION_COUNT> frameSections{};
+        size_t depth = 0;
+        time::time_point outerStart;
+
+        // sections of the current streak of frames over budget
+        size_t overrunStreak = 0;
+        std::array<time::clock::duration, SECTION_COUNT> streakSections{};
+
+        void add(Section section, time::clock::duration took);
+        void logOverrun();
+    };
+
+    struct PacketTypeSummary {
+        // sizes are bucketed by powers of two, bucket `i` counts packets of [2^i, 2^(i+1)) bytes, the last one everything above
+        static constexpr size_t SIZE_BUCKETS = 16;
+
         packetid_t id;
-        bool encrypted;
-        bool outgoing;
-        size_t bytes;
+
+        uint64_t totalIn;
+        uint64_t totalOut;
+        uint64_t totalEncrypted;
+        uint64_t totalBytesIn;
+        uint64_t totalBytesOut;
+
+        // both directions, averaged over the last few full seconds
+        float packetsPerSec;
+        float bytesPerSec;
+
+        std::array<uint64_t, SIZE_BUCKETS> sizeHistogram;
     };
 
     struct PacketLogSummary {
@@ -74,7 +193,10 @@ namespace util::debug {
         uint64_t totalBytesIn;
         uint64_t totalBytesOut;
 
-        std::unordered_map<packetid_t, size_t> packetCounts;
+        // sorted by the rate of bytes, busiest first
+        std::vector<PacketTypeSummary> types;
+        // packets of types that didn't fit into the table, not included in the totals
+        uint64_t untracked;
 
         float bytesPerPacket;
         float encryptedRatio;
@@ -82,17 +204,54 @@ namespace util::debug {
         void print();
     };
 
+    // Counts packets of every type. `record` is called from the network threads and only does a few relaxed atomic adds
+    // into a fixed table, so it can stay enabled in release builds. `getSummary` is O(packet types) and can be called from anywhere.
     class PacketLogger : public SingletonBase<PacketLogger> {
     public:
+        // more than the amount of packet types, so probing stays short
+        static constexpr size_t TYPE_SLOTS = 256;
+        // rates are counted in one bucket per second, the current one is still filling up and is left out of the rate
+        static constexpr size_t RATE_BUCKETS = 4;
+
         void record(packetid_t id, bool encrypted, bool outgoing, size_t bytes);
         PacketLogSummary getSummary();
+
     private:
-        collections::CappedQueue<PacketLog, 25000> queue;
+        static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+        struct RateBucket {
+            std::atomic<int64_t> second = -1;
+            std::atomic<uint64_t> packets = 0;
+            std::atomic<uint64_t> bytes = 0;
+        };
+
+        struct TypeCounters {
+            // claimed once with a CAS and never released, so readers can skip `EMPTY_SLOT` without a lock
+            std::atomic<uint32_t> id = EMPTY_SLOT;
+
+            std::atomic<uint64_t> packetsIn = 0;
+            std::atomic<uint64_t> packetsOut = 0;
+            std::atomic<uint64_t> encrypted = 0;
+            std::atomic<uint64_t> bytesIn = 0;
+            std::atomic<uint64_t> bytesOut = 0;
+
+            std::array<std::atomic<uint64_t>, PacketTypeSummary::SIZE_BUCKETS> sizes{};
+            std::array<RateBucket, RATE_BUCKETS> rate;
+        };
+
+        std::array<TypeCounters, TYPE_SLOTS> types;
+        // packets of types that didn't fit into the table
+        std::atomic<uint64_t> overflowed = 0;
+
+        TypeCounters* slotFor(packetid_t id);
     };
 
     std::string hexDumpAddress(uintptr_t addr, size_t bytes);
     std::string hexDumpAddress(void* ptr, size_t bytes);
 
+    // Writes up to `out.size() / 2` bytes as hex into `out`, returns the amount of characters written
+    size_t hexDumpInto(const void* ptr, size_t bytes, std::span<char> out);
+
 #if GLOBED_CAN_USE_SOURCE_LOCATION
     std::string sourceLocation(const std::source_location loc = GLOBED_SOURCE);
     // crash the program immediately, print the location of the caller
@@ -0,0 +1,153 @@
+#include "jobs.hpp"
+
+#include <defs/geode.hpp>
+
+#include <cstring>
+
+#include <util/profiler.hpp>
+#include <util/simd.hpp>
+#include <util/thread.hpp>
+
+using namespace geode::prelude;
+
+namespace util::jobs {
+    // index of the worker running on the current thread, -1 on threads outside the pool
+    static thread_local size_t currentWorker = -1;
+
+    static util::thread::Priority threadPriorityFor(Priority priority) {
+        switch (priority) {
+            case Priority::High: return util::thread::Priority::High;
+            case Priority::Background: return util::thread::Priority::Background;
+            default: return util::thread::Priority::Normal;
+        }
+    }
+
+    JobSystem::JobSystem() {
+        // leave one core for the main thread, but always have a few workers so jobs that wait on disk can overlap
+        size_t count = std::max<size_t>(std::thread::hardware_concurrency(), 3) - 1;
+
+        for (size_t i = 0; i < count; i++) {
+            auto worker = std::make_unique<Worker>();
+            worker->system = this;
+            worker->index = i;
+            workers.push_back(std::move(worker));
+        }
+
+        for (auto& worker : workers) {
+            worker->thread.setLoopFunction(&Worker::loop);
+            worker->thread.setStartFunction([index = worker->index] {
+                currentWorker = index;
+
+                auto name = fmt::format("Globed Worker {}", index);
+                geode::utils::thread::setName(name);
+                GLOBED_PROFILE_THREAD(name);
+                util::thread::configureCurrent(util::thread::Priority::Normal);
+            });
+            worker->thread.start(worker.get());
+        }
+
+        log::debug("job system started with {} workers", count);
+    }
+
+    JobSystem::~JobSystem() {
+        for (auto& worker : workers) {
+            worker->thread.stopAndWait();
+        }
+    }
+
+    void JobSystem::push(const char* name, Priority priority, std::function<void()> func) {
+        uint32_t traceId = 0;
+
+#ifdef GLOBED_PROFILER
+        // same id `GLOBED_PROFILE_ZONE` would give this name
+        traceId = util::simd::adler32(reinterpret_cast<const uint8_t*>(name), std::strlen(name));
+        util::profiler::Profiler::get().registerZone(traceId, name);
+#endif
+
+        size_t target = currentWorker < workers.size() ? currentWorker : nextWorker++ % workers.size();
+
+        workers[target]->queues.lock()->at(static_cast<size_t>(priority)).push_back(Job {
+            .func = std::move(func),
+            .name = name,
+            .traceId = traceId,
+            .priority = priority,
+        });
+
+        pending++;
+        wakeup.push(true);
+    }
+
+    size_t JobSystem::workerCount() const {
+        return workers.size();
+    }
+
+    size_t JobSystem::pendingCount() const {
+        return pending.load(std::memory_order_relaxed);
+    }
+
+    std::optional<JobSystem::Job> JobSystem::take(Worker& self) {
+        if (pending.load() == 0) return std::nullopt;
+
+        // a more important job on another worker goes before a less important one of our own
+        for (size_t prio = 0; prio < PRIORITY_COUNT; prio++) {
+            {
+                auto queues = self.queues.lock();
+                auto& queue = queues->at(prio);
+
+                // newest first, its data is the most likely to still be in cache
+                if (!queue.empty()) {
+                    Job job = std::move(queue.back());
+                    queue.pop_back();
+                    pending--;
+                    return job;
+                }
+            }
+
+            for (size_t i = 1; i < workers.size(); i++) {
+                auto& victim = *workers[(self.index + i) % workers.size()];
+                auto queues = victim.queues.lock();
+                auto& queue = queues->at(prio);
+
+                // oldest first, which the owner is the least likely to get to soon
+                if (!queue.empty()) {
+                    Job job = std::move(queue.front());
+                    queue.pop_front();
+                    pending--;
+                    return job;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void JobSystem::run(Job& job) {
+#ifdef GLOBED_PROFILER
+        util::profiler::Zone zone(job.traceId);
+#endif
+
+        try {
+            job.func();
+        } catch (const std::exception& e) {
+            log::error("Job \"{}\" threw an exception: {}", job.name, e.what());
+        }
+    }
+
+    void JobSystem::Worker::loop() {
+        // idle workers don't hold on to their job, the token is only there to wake one up
+        auto job = system->take(*this);
+        if (!job) {
+            (void) system->wakeup.popTimeout(IDLE_TIMEOUT);
+            return;
+        }
+
+        // switching the thread priority is a syscall, so it's only done when the kind of work changes
+        static thread_local Priority runningAs = Priority::Normal;
+        if (job->priority != runningAs) {
+            runningAs = job->priority;
+            util::thread::configureCurrent(threadPriorityFor(runningAs));
+        }
+
+        system->run(*job);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
+
+#include <util/singleton.hpp>
+
+// Shared pool of worker threads for background work that isn't tied to a thread of its own, like asset preloading.
+// There is one worker per core (minus one for the main thread), each with its own queue. Workers take from the back
+// of their own queue and steal from the front of other queues once theirs is empty, so a burst of jobs pushed from
+// one thread still spreads over every core.
+//
+// Jobs must not block on each other, and anything that needs a specific thread or strict ordering (audio, networking,
+// decoding the frames of one voice stream) keeps its own thread instead.
+namespace util::jobs {
+    enum class Priority : uint8_t {
+        High,       // someone is waiting on the result soon
+        Normal,
+        Background, // preloading and other work nobody is waiting on, only runs when nothing else is queued
+        Count,
+    };
+
+    constexpr size_t PRIORITY_COUNT = static_cast<size_t>(Priority::Count);
+
+    class JobSystem : public SingletonBase<JobSystem> {
+    protected:
+        friend class SingletonBase;
+        JobSystem();
+        ~JobSystem();
+
+    public:
+        // How long an idle worker sleeps before checking if it's being stopped
+        static constexpr auto IDLE_TIMEOUT = std::chrono::milliseconds(50);
+
+        // Queue a job. `name` must be a string literal, it shows up as a profiler zone for every run of the job.
+        // Jobs pushed from a worker go to that worker's queue, others are spread over all workers.
+        void push(const char* name, Priority priority, std::function<void()> func);
+
+        void push(const char* name, std::function<void()> func) {
+            this->push(name, Priority::Normal, std::move(func));
+        }
+
+        size_t workerCount() const;
+        // Jobs that are queued but not running yet, approximate
+        size_t pendingCount() const;
+
+    private:
+        struct Job {
+            std::function<void()> func;
+            const char* name;
+            uint32_t traceId;
+            Priority priority;
+        };
+
+        struct Worker {
+            JobSystem* system;
+            size_t index;
+            asp::Mutex<std::array<std::deque<Job>, PRIORITY_COUNT>> queues;
+            asp::Thread<Worker*> thread;
+
+            void loop();
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic_size_t nextWorker = 0;
+        std::atomic_size_t pending = 0;
+        // one token per pushed job, idle workers sleep on it
+        asp::Channel<bool> wakeup;
+
+        std::optional<Job> take(Worker& self);
+        void run(Job& job);
+    };
+}
@@ -67,4 +67,17 @@ namespace util::math {
     inline bool smallerOrEqual(double val1, double val2, double errorMargin = DOUBLE_ERROR_MARGIN) {
         return val1 < val2 || equal(val1, val2, errorMargin);
     }
+
+    // Interpolate between two angles (in degrees), going the shorter way around the circle
+    inline float lerpAngle(float from, float to, float ratio) {
+        float diff = std::fmod(to - from, 360.f);
+
+        if (diff > 180.f) {
+            diff -= 360.f;
+        } else if (diff < -180.f) {
+            diff += 360.f;
+        }
+
+        return from + diff * ratio;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "memory.hpp"
+
+#include <defs/geode.hpp>
+#include <util/format.hpp>
+
+using namespace geode::prelude;
+
+namespace util::memory {
+    const char* tagName(MemoryTag tag) {
+        switch (tag) {
+            case MemoryTag::Textures: return "textures";
+            case MemoryTag::RemotePlayers: return "remote players";
+            case MemoryTag::AudioQueues: return "audio queues";
+            case MemoryTag::LerpLogger: return "interpolation log";
+            case MemoryTag::ProfileCache: return "profile cache";
+            default: return "unknown";
+        }
+    }
+
+    std::string MemorySnapshot::format() const {
+        std::string out = fmt::format("total: {}", util::format::formatBytes(std::max<int64_t>(total, 0)));
+
+        for (size_t i = 0; i < TAG_COUNT; i++) {
+            out += fmt::format(
+                "\n{}: {} (peak {})",
+                tagName(static_cast<MemoryTag>(i)),
+                util::format::formatBytes(std::max<int64_t>(bytes[i], 0)),
+                util::format::formatBytes(std::max<int64_t>(peak[i], 0))
+            );
+        }
+
+        return out;
+    }
+
+    void MemoryTracker::add(MemoryTag tag, size_t bytes) {
+        auto idx = static_cast<size_t>(tag);
+        int64_t value = this->bytes[idx].fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+        this->updatePeak(idx, value);
+    }
+
+    void MemoryTracker::remove(MemoryTag tag, size_t bytes) {
+        this->bytes[static_cast<size_t>(tag)].fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::set(MemoryTag tag, size_t bytes) {
+        auto idx = static_cast<size_t>(tag);
+        this->bytes[idx].store(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+        this->updatePeak(idx, static_cast<int64_t>(bytes));
+    }
+
+    int64_t MemoryTracker::get(MemoryTag tag) {
+        return bytes[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+    }
+
+    MemorySnapshot MemoryTracker::snapshot() {
+        MemorySnapshot out{};
+
+        for (size_t i = 0; i < TAG_COUNT; i++) {
+            out.bytes[i] = bytes[i].load(std::memory_order_relaxed);
+            out.peak[i] = peak[i].load(std::memory_order_relaxed);
+            out.total += out.bytes[i];
+        }
+
+        return out;
+    }
+
+    void MemoryTracker::resetPeaks() {
+        for (size_t i = 0; i < TAG_COUNT; i++) {
+            peak[i].store(bytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    void MemoryTracker::logSummary(std::string_view context) {
+        log::info("Memory usage ({}), {}", context, this->snapshot().format());
+    }
+
+    void MemoryTracker::updatePeak(size_t idx, int64_t value) {
+        int64_t current = peak[idx].load(std::memory_order_relaxed);
+        while (value > current && !peak[idx].compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    size_t textureSize(CCTexture2D* texture) {
+        if (!texture) return 0;
+
+        return static_cast<size_t>(texture->getPixelsWide()) * texture->getPixelsHigh() * texture->bitsPerPixelForFormat() / 8;
+    }
+
+    size_t nodeTreeSize(CCNode* node) {
+        if (!node) return 0;
+
+        size_t size;
+        if (typeinfo_cast<CCLabelBMFont*>(node)) {
+            size = sizeof(CCLabelBMFont);
+        } else if (typeinfo_cast<CCSprite*>(node)) {
+            size = sizeof(CCSprite);
+        } else {
+            size = sizeof(CCNode);
+        }
+
+        for (auto* child : CCArrayExt<CCNode*>(node->getChildren())) {
+            size += nodeTreeSize(child);
+        }
+
+        return size;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cocos2d {
+    class CCNode;
+    class CCTexture2D;
+}
+
+// Per-subsystem accounting of the memory globed holds on to. Containers are counted with `TrackingAllocator`,
+// which adds a relaxed atomic add to every allocation and deallocation, textures and node trees are estimated from their size.
+// The totals are approximate, heap bookkeeping and memory owned by the elements themselves (like long strings) is not included.
+namespace util::memory {
+    enum class MemoryTag : uint8_t {
+        Textures,      // textures uploaded by `preloadAssets` and on-demand icon loading
+        RemotePlayers, // node trees of remote players, including pooled ones
+        AudioQueues,   // sample queues of voice streams
+        LerpLogger,    // interpolation log rings
+        ProfileCache,  // cached profiles of other players
+        Count,
+    };
+
+    constexpr size_t TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+    const char* tagName(MemoryTag tag);
+
+    struct MemorySnapshot {
+        std::array<int64_t, TAG_COUNT> bytes;
+        std::array<int64_t, TAG_COUNT> peak; // highest value since the last `resetPeaks`
+        int64_t total;
+
+        // one line per subsystem, with the current and peak usage
+        std::string format() const;
+    };
+
+    // Not a `SingletonBase`, containers owned by other singletons free their memory while static objects are destroyed,
+    // so this must never be destroyed itself. Everything in it is trivially destructible.
+    class MemoryTracker {
+    public:
+        static MemoryTracker& get() {
+            static MemoryTracker instance;
+            return instance;
+        }
+
+        // Safe to call from any thread
+        void add(MemoryTag tag, size_t bytes);
+        void remove(MemoryTag tag, size_t bytes);
+        // For subsystems that are measured all at once rather than counted, replaces the current value
+        void set(MemoryTag tag, size_t bytes);
+
+        int64_t get(MemoryTag tag);
+        MemorySnapshot snapshot();
+
+        // Peaks start over from the current values, called when entering a level
+        void resetPeaks();
+
+        // Log the totals of every subsystem, `context` says where it was called from
+        void logSummary(std::string_view context);
+
+    private:
+        std::array<std::atomic<int64_t>, TAG_COUNT> bytes{};
+        std::array<std::atomic<int64_t>, TAG_COUNT> peak{};
+
+        void updatePeak(size_t idx, int64_t value);
+    };
+
+    // Standard allocator that counts every allocation towards `Tag`
+    template <typename T, MemoryTag Tag>
+    class TrackingAllocator {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = TrackingAllocator<U, Tag>;
+        };
+
+        TrackingAllocator() noexcept = default;
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U, Tag>&) noexcept {}
+
+        T* allocate(size_t n) {
+            auto* ptr = std::allocator<T>{}.allocate(n);
+            MemoryTracker::get().add(Tag, n * sizeof(T));
+            return ptr;
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept {
+            MemoryTracker::get().remove(Tag, n * sizeof(T));
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        template <typename U>
+        bool operator==(const TrackingAllocator<U, Tag>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const TrackingAllocator<U, Tag>&) const noexcept { return false; }
+    };
+
+    template <typename T, MemoryTag Tag>
+    using TrackedVector = std::vector<T, TrackingAllocator<T, Tag>>;
+
+    // Size of the pixel data of a texture, what it takes up in video memory (which is regular memory on phones)
+    size_t textureSize(cocos2d::CCTexture2D* texture);
+
+    // Rough size of a node and all its children, sprites and labels count as the size of their class and anything else as a `CCNode`.
+    // Call only on the main thread.
+    size_t nodeTreeSize(cocos2d::CCNode* node);
+}
@@ -2,7 +2,6 @@
 #include <data/types/game.hpp>
 #include <data/types/gd.hpp>
 
-#include <asp/sync.hpp>
 #include <util/simd.hpp>
 #include <util/lowlevel.hpp>
 
@@ -45,24 +44,6 @@ namespace util::misc {
         }
     }
 
-    void callOnce(const char* key, std::function<void()> func) {
-        static std::unordered_set<const char*> called;
-
-        if (called.contains(key)) {
-            return;
-        }
-
-        called.insert(key);
-        func();
-    }
-
-    void callOnceSync(const char* key, std::function<void()> func) {
-        static asp::Mutex<> mtx;
-
-        auto guard = mtx.lock();
-        callOnce(key, func);
-    }
-
     float calculatePcmVolume(const float* pcm, size_t samples) {
         return simd::calcPcmVolume(pcm, samples);
     }
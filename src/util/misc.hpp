@@ -2,7 +2,10 @@
 #include <defs/essential.hpp>
 #include <defs/geode.hpp>
 #include <data/types/basic/either.hpp>
+#include <data/types/basic/inline_string.hpp>
+#include <data/types/basic/varint.hpp>
 
+#include <atomic>
 #include <functional>
 #include <string_view>
 #include <type_traits>
@@ -85,6 +88,18 @@ namespace util::misc {
     template <typename T, typename Y>
     struct IsEither<Either<T, Y>> : std::true_type {};
 
+    template <typename>
+    struct IsInlineString : std::false_type {};
+
+    template <size_t N>
+    struct IsInlineString<InlineString<N>> : std::true_type {};
+
+    template <typename>
+    struct IsVarint : std::false_type {};
+
+    template <typename T>
+    struct IsVarint<Varint<T>> : std::true_type {};
+
     // If `target` is false, returns false. If `target` is true, modifies `target` to false and returns true.
     bool swapFlag(bool& target);
 
@@ -104,12 +119,60 @@ namespace util::misc {
     template <typename To, typename From>
     To convertEnum(From value);
 
-    // On first call, simply calls `func`. On repeated calls, given the same `key`, the function will not be called again. Not thread safe.
-    void callOnce(const char* key, std::function<void()> func);
+    // Token that lets a function run only once, like `std::once_flag`. After the first call has finished, `call` is a single atomic load.
+    // Threads that call it while the function is still running wait for it to finish. If the function throws, the next call runs it again.
+    class OnceFlag {
+    public:
+        template <typename F>
+        void call(F&& func) {
+            if (state.load(std::memory_order_acquire) == Done) [[likely]] return;
+
+            uint8_t expected = Idle;
+            if (!state.compare_exchange_strong(expected, Running, std::memory_order_acq_rel)) {
+                // another thread got here first
+                while (expected == Running) {
+                    state.wait(Running, std::memory_order_acquire);
+                    expected = state.load(std::memory_order_acquire);
+                }
+
+                if (expected == Done) return;
+                return this->call(std::forward<F>(func));
+            }
+
+            try {
+                func();
+            } catch (...) {
+                state.store(Idle, std::memory_order_release);
+                state.notify_all();
+                throw;
+            }
+
+            state.store(Done, std::memory_order_release);
+            state.notify_all();
+        }
 
-    // Same as `callOnce` but guaranteed to be thread-safe. Though, if another place ever calls the non-safe version, no guarantees are made.
-    // When using this, it is recommended that the function does not take long to execute, due to the simplicity of the implementation.
-    void callOnceSync(const char* key, std::function<void()> func);
+        bool done() const {
+            return state.load(std::memory_order_acquire) == Done;
+        }
+
+    private:
+        static constexpr uint8_t Idle = 0, Running = 1, Done = 2;
+        std::atomic<uint8_t> state = Idle;
+    };
+
+    // The `OnceFlag` used by `callOnce` for `Key`. Templated on the key alone, so every call site with the same key shares it
+    template <globed::ConstexprString Key>
+    OnceFlag& onceFlagFor() {
+        static OnceFlag flag;
+        return flag;
+    }
+
+    // On first call, simply calls `func`. On repeated calls, given the same `key`, the function will not be called again.
+    // Each key gets its own `OnceFlag`, so this is thread safe and doesn't allocate or lock. Don't call it recursively with the same key.
+    template <globed::ConstexprString Key, typename F>
+    void callOnce(F&& func) {
+        onceFlagFor<Key>().call(std::forward<F>(func));
+    }
 
     template <typename Ret, typename Func>
     concept OnceCellFunction = requires(Func func) {
@@ -2,6 +2,7 @@
 
 #include <defs/geode.hpp>
 #include <util/format.hpp>
+#include <algorithm>
 
 #ifdef GEODE_IS_WINDOWS
 # include <ws2tcpip.h>
@@ -9,6 +10,7 @@
 # include <sys/socket.h>
 # include <sys/types.h>
 # include <netinet/in.h>
+# include <netinet/tcp.h>
 # include <arpa/inet.h>
 # include <netdb.h>
 #endif
@@ -120,6 +122,44 @@ namespace util::net {
         return Ok();
     }
 
+    Result<std::vector<in_addr>> getaddrinfoAll(const std::string_view hostname) {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        struct addrinfo* result;
+
+        int code = ::getaddrinfo(std::string(hostname).c_str(), nullptr, &hints, &result);
+        if (code != 0) {
+            return Err(util::net::lastErrorString(code, true));
+        }
+
+        std::vector<in_addr> out;
+
+        for (auto* entry = result; entry != nullptr; entry = entry->ai_next) {
+            if (entry->ai_family != AF_INET) continue;
+
+            auto& addr = reinterpret_cast<struct sockaddr_in*>(entry->ai_addr)->sin_addr;
+
+            bool duplicate = std::any_of(out.begin(), out.end(), [&](const in_addr& other) {
+                return std::memcmp(&addr, &other, sizeof(in_addr)) == 0;
+            });
+
+            if (!duplicate) {
+                out.push_back(addr);
+            }
+        }
+
+        ::freeaddrinfo(result);
+
+        if (out.empty()) {
+            return Err("getaddrinfo returned no IPv4 addresses");
+        }
+
+        return Ok(std::move(out));
+    }
+
     Result<std::string> inAddrToString(const in_addr& addr) {
         std::string out;
         out.resize(16);
@@ -148,5 +188,29 @@ namespace util::net {
     uint16_t hostToNetworkPort(uint16_t port) {
         return ::htons(port);
     }
-}
 
+    Result<int> setReceiveBufferSize(socket_t socket, int bytes) {
+        if (0 != setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bytes), sizeof(bytes))) {
+            return Err(lastErrorString());
+        }
+
+        int actual = 0;
+        socklen_t len = sizeof(actual);
+
+        if (0 != getsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&actual), &len)) {
+            return Err(lastErrorString());
+        }
+
+        return Ok(actual);
+    }
+
+    Result<> setNoDelay(socket_t socket, bool enabled) {
+        int value = enabled ? 1 : 0;
+
+        if (0 != setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value))) {
+            return Err(lastErrorString());
+        }
+
+        return Ok();
+    }
+}
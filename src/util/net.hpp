@@ -1,7 +1,9 @@
 #pragma once
 #include <defs/minimal_geode.hpp>
 #include <defs/net.hpp>
+#include <optional>
 #include <string>
+#include <vector>
 
 struct sockaddr_in;
 struct in_addr;
@@ -41,9 +43,87 @@ namespace util::net {
     Result<std::string> getaddrinfo(const std::string_view hostname);
     Result<> getaddrinfo(const std::string_view hostname, sockaddr_in& out);
 
+    // getaddrinfo, but returns every IPv4 address of the host, in the order the resolver gave them
+    Result<std::vector<in_addr>> getaddrinfoAll(const std::string_view hostname);
+
     Result<std::string> inAddrToString(const in_addr& addr);
     Result<> stringToInAddr(const char* addr, in_addr& out);
 
     uint16_t hostToNetworkPort(uint16_t port);
 
+#ifdef GEODE_IS_WINDOWS
+    using socket_t = uintptr_t;
+#else
+    using socket_t = int;
+#endif
+
+    // Set `SO_RCVBUF` on a socket. Returns the size the OS actually went with, which may be capped
+    // (or doubled, on Linux) and should only be used for logging.
+    Result<int> setReceiveBufferSize(socket_t socket, int bytes);
+
+    // Enable or disable `TCP_NODELAY` on a TCP socket
+    Result<> setNoDelay(socket_t socket, bool enabled);
+
+    // Amount of datagrams the OS dropped for this socket because its receive buffer was full.
+    // Only Android can tell (`SO_MEMINFO`), returns nullopt everywhere else.
+    std::optional<uint32_t> receiveDropCount(socket_t socket);
+
+    // DSCP code points used for outgoing traffic, see RFC 4594
+    enum class TrafficClass : uint8_t {
+        BestEffort = 0,
+        Interactive = 34, // AF41, player data
+        Voice = 46, // EF
+    };
+
+    // Marks the outgoing packets of one socket with a `TrafficClass`. Uses `IP_TOS` on unix,
+    // and qWAVE flows on Windows, which pick the DSCP value themselves from the traffic type.
+    // Routers are free to ignore the marking, it mostly matters on home networks with QoS enabled.
+    class TrafficMarker {
+    public:
+        TrafficMarker();
+        ~TrafficMarker();
+
+        TrafficMarker(const TrafficMarker&) = delete;
+        TrafficMarker& operator=(const TrafficMarker&) = delete;
+
+        // Start marking packets sent from `socket` to `destination`, with `TrafficClass::BestEffort` until `mark` is called
+        Result<> attach(socket_t socket, const sockaddr_in& destination);
+
+        // Stop marking, must be called before the socket is closed
+        void detach();
+
+        bool attached() const;
+
+        // Change the class of the packets sent from now on. Does nothing if the class is the same as before.
+        Result<> mark(TrafficClass cls);
+
+    private:
+        class Impl;
+        Impl* impl;
+    };
+
+    // Waits for a small set of sockets to become readable, using the best mechanism the platform has
+    // (epoll on Android, kqueue on macOS and iOS, WSAPoll on Windows). The sockets stay registered between calls,
+    // call `invalidate` whenever one of them is closed or recreated.
+    class SocketPoller {
+    public:
+        static constexpr size_t MAX_SOCKETS = 4;
+
+        SocketPoller();
+        ~SocketPoller();
+
+        SocketPoller(const SocketPoller&) = delete;
+        SocketPoller& operator=(const SocketPoller&) = delete;
+
+        // Wait up to `timeoutMs` milliseconds (negative means indefinitely) for any of the sockets to become readable.
+        // Bit `i` of the returned mask is set if `sockets[i]` is readable, 0 means the wait timed out.
+        Result<uint32_t> wait(const socket_t* sockets, size_t count, int timeoutMs);
+
+        // Drop all registrations, they get redone on the next `wait`
+        void invalidate();
+
+    private:
+        class Impl;
+        Impl* impl;
+    };
 }
\ No newline at end of file
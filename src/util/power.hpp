@@ -0,0 +1,13 @@
+#pragma once
+
+namespace util::power {
+    enum class PowerSource {
+        Unknown,
+        Battery,
+        External, // plugged in, or a device without a battery
+    };
+
+    // Where the device is drawing power from right now. Reads from the OS every time,
+    // so it's fine to call every few seconds but not every frame.
+    PowerSource currentSource();
+}
@@ -0,0 +1,100 @@
+#include "profiler.hpp"
+
+#ifdef GLOBED_PROFILER
+
+#include <algorithm>
+
+namespace util::profiler {
+    void Profiler::registerZone(uint32_t id, const char* name) {
+        auto names = zoneNames.lock();
+        auto [it, inserted] = names->try_emplace(id, name);
+
+        if (!inserted && it->second != name) {
+            log::warn("profiler zones \"{}\" and \"{}\" have the same id, pick a different name for one of them", it->second, name);
+        }
+    }
+
+    ThreadRing& Profiler::createThreadRing() {
+        auto rings = this->rings.lock();
+        size_t index = rings->size();
+
+        rings->push_back(std::make_shared<ThreadRing>(index, fmt::format("Thread {}", index)));
+        return *rings->back();
+    }
+
+    void Profiler::nameThisThread(std::string_view name) {
+        auto& ring = currentThreadRing();
+        if (ring.name != name) {
+            ring.name = std::string(name);
+        }
+    }
+
+    void Profiler::collect(std::function<void(const ThreadRing&, const ZoneEvent&)> sink) {
+        // rings are never removed, a copy of the pointers is enough to drain them without holding the lock
+        auto rings = *this->rings.lock();
+        auto samples = this->samples.lock();
+
+        for (auto& ring : rings) {
+            dropped += ring->drain([&](const ZoneEvent& event) {
+                if (sink) sink(*ring, event);
+                if (event.instant) return;
+
+                auto took = std::chrono::duration_cast<std::chrono::nanoseconds>(event.end - event.start).count();
+
+                auto& zone = (*samples)[event.zoneId];
+                zone.durations[zone.count % SAMPLE_WINDOW] = static_cast<uint32_t>(std::min<int64_t>(took, UINT32_MAX));
+                zone.count++;
+            });
+        }
+    }
+
+    std::vector<Profiler::ZoneStats> Profiler::stats() {
+        std::vector<ZoneStats> out;
+        std::vector<uint32_t> sorted;
+
+        auto samples = this->samples.lock();
+        out.reserve(samples->size());
+
+        for (const auto& [id, zone] : *samples) {
+            size_t n = std::min<uint64_t>(zone.count, SAMPLE_WINDOW);
+            if (n == 0) continue;
+
+            sorted.assign(zone.durations.begin(), zone.durations.begin() + n);
+            std::sort(sorted.begin(), sorted.end());
+
+            out.push_back(ZoneStats {
+                .id = id,
+                .name = this->zoneName(id),
+                .count = zone.count,
+                .p50 = std::chrono::nanoseconds(sorted[n / 2]),
+                .p99 = std::chrono::nanoseconds(sorted[std::min(n - 1, n * 99 / 100)]),
+                .max = std::chrono::nanoseconds(sorted.back()),
+            });
+        }
+
+        std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+            return a.p99 > b.p99;
+        });
+
+        return out;
+    }
+
+    std::string Profiler::zoneName(uint32_t id) {
+        auto names = zoneNames.lock();
+        auto it = names->find(id);
+
+        return it == names->end() ? fmt::format("zone {:08x}", id) : it->second;
+    }
+
+    uint64_t Profiler::droppedEvents() {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::reset() {
+        this->collect();
+        samples.lock()->clear();
+        dropped = 0;
+    }
+}
+
+#endif // GLOBED_PROFILER
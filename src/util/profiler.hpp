@@ -0,0 +1,203 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <asp/sync.hpp>
+
+#include <util/adler32.hpp>
+#include <util/singleton.hpp>
+
+// Low overhead zone profiler, meant to be left in hot paths. A zone measures the scope it is declared in:
+//
+//     GLOBED_PROFILE_ZONE("PacketListenerPool::update");
+//
+// Zone ids are hashed from the name at compile time, and finished zones are pushed into a ring buffer owned by the
+// current thread, so recording one doesn't lock or allocate. `Profiler::collect` drains every thread's ring and keeps
+// the last `SAMPLE_WINDOW` durations of each zone, for percentiles.
+//
+// Everything compiles to nothing unless `GLOBED_PROFILER` is defined (see the `GLOBED_PROFILER` cmake option).
+
+#ifdef GLOBED_PROFILER
+
+namespace util::profiler {
+    using clock = std::chrono::steady_clock;
+
+    struct ZoneEvent {
+        uint32_t zoneId;
+        clock::time_point start;
+        clock::time_point end;
+        // instant events mark a point in time (`start == end`) and are left out of the zone statistics
+        bool instant = false;
+        // free-form values shown in traces, for example the id and size of a packet
+        uint32_t arg0 = 0;
+        uint32_t arg1 = 0;
+    };
+
+    // Written only by the thread that owns it, read only by whoever calls `Profiler::collect`.
+    // When the reader falls behind, the oldest events get overwritten and are counted as dropped.
+    class ThreadRing {
+    public:
+        static constexpr size_t CAPACITY = 8192;
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "ThreadRing capacity must be a power of two");
+
+        ThreadRing(size_t index, std::string name) : index(index), name(std::move(name)) {}
+
+        void push(const ZoneEvent& event) {
+            auto pos = head.load(std::memory_order_relaxed);
+            buffer[pos & (CAPACITY - 1)] = event;
+            head.store(pos + 1, std::memory_order_release);
+        }
+
+        // Calls `f` for every event pushed since the last drain, in order. Returns how many events were lost.
+        template <typename F>
+        size_t drain(F&& f) {
+            auto end = head.load(std::memory_order_acquire);
+            size_t dropped = 0;
+
+            if (end - tail > CAPACITY) {
+                dropped = end - CAPACITY - tail;
+                tail = end - CAPACITY;
+            }
+
+            for (; tail != end; tail++) {
+                ZoneEvent event = buffer[tail & (CAPACITY - 1)];
+
+                // the writer could have been reusing this slot while the event was being copied, in that case it's garbage
+                if (head.load(std::memory_order_acquire) - tail >= CAPACITY) {
+                    dropped++;
+                    continue;
+                }
+
+                f(event);
+            }
+
+            return dropped;
+        }
+
+        size_t index;
+        std::string name;
+
+    private:
+        std::array<ZoneEvent, CAPACITY> buffer;
+        std::atomic<uint64_t> head = 0;
+        uint64_t tail = 0;
+    };
+
+    class Profiler : public SingletonBase<Profiler> {
+    protected:
+        friend class SingletonBase;
+        Profiler() = default;
+
+    public:
+        // how many of the latest durations of each zone the percentiles are calculated from
+        static constexpr size_t SAMPLE_WINDOW = 1024;
+
+        struct ZoneStats {
+            uint32_t id;
+            std::string name;
+            // zones finished since the last `reset`
+            uint64_t count;
+            std::chrono::nanoseconds p50, p99, max;
+        };
+
+        void registerZone(uint32_t id, const char* name);
+        // Creates a new ring buffer, use `currentThreadRing` to get the one of the current thread
+        ThreadRing& createThreadRing();
+        // Name shown for the current thread, for example "Network Thread (in)". Call before it starts recording zones.
+        // Only allocates when the name changes.
+        void nameThisThread(std::string_view name);
+
+        // Drains the events of every thread, must only be called from one thread at a time (normally the main thread).
+        // `sink` also receives every raw event along with the thread that recorded it.
+        void collect(std::function<void(const ThreadRing&, const ZoneEvent&)> sink = {});
+        // Percentiles of every zone seen so far, sorted by p99, slowest first
+        std::vector<ZoneStats> stats();
+        std::string zoneName(uint32_t id);
+        uint64_t droppedEvents();
+        void reset();
+
+    private:
+        struct ZoneSamples {
+            std::array<uint32_t, SAMPLE_WINDOW> durations; // nanoseconds
+            uint64_t count = 0;
+        };
+
+        asp::Mutex<std::vector<std::shared_ptr<ThreadRing>>> rings;
+        asp::Mutex<std::unordered_map<uint32_t, std::string>> zoneNames;
+        // only touched by `collect` and the functions that read its results
+        asp::Mutex<std::unordered_map<uint32_t, ZoneSamples>> samples;
+        std::atomic<uint64_t> dropped = 0;
+    };
+
+    inline ThreadRing& currentThreadRing() {
+        static thread_local ThreadRing& ring = Profiler::get().createThreadRing();
+        return ring;
+    }
+
+    // Use `GLOBED_PROFILE_INSTANT` instead of this directly.
+    inline void instant(uint32_t id, uint32_t arg0, uint32_t arg1) {
+        auto now = clock::now();
+        currentThreadRing().push(ZoneEvent { id, now, now, true, arg0, arg1 });
+    }
+
+    // Records the time between its construction and destruction. Use `GLOBED_PROFILE_ZONE` instead of this directly.
+    class Zone {
+    public:
+        explicit Zone(uint32_t id) : id(id), start(clock::now()) {}
+
+        ~Zone() {
+            currentThreadRing().push(ZoneEvent { id, start, clock::now() });
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        uint32_t id;
+        clock::time_point start;
+    };
+
+    struct ZoneRegistration {
+        ZoneRegistration(uint32_t id, const char* name) {
+            Profiler::get().registerZone(id, name);
+        }
+    };
+}
+
+# define GLOBED_PROFILE_ZONE(name) \
+    static const ::util::profiler::ZoneRegistration GEODE_CONCAT(_globedZoneReg_, __LINE__) { \
+        std::integral_constant<uint32_t, ::util::crypto::adler32(name)>::value, name \
+    }; \
+    ::util::profiler::Zone GEODE_CONCAT(_globedZone_, __LINE__) { std::integral_constant<uint32_t, ::util::crypto::adler32(name)>::value }
+
+// Records a single point in time with two values attached, for example `GLOBED_PROFILE_INSTANT("net: packet sent", id, size)`
+# define GLOBED_PROFILE_INSTANT(name, arg0, arg1) \
+    do { \
+        static const ::util::profiler::ZoneRegistration _globedZoneReg { \
+            std::integral_constant<uint32_t, ::util::crypto::adler32(name)>::value, name \
+        }; \
+        ::util::profiler::instant( \
+            std::integral_constant<uint32_t, ::util::crypto::adler32(name)>::value, \
+            static_cast<uint32_t>(arg0), static_cast<uint32_t>(arg1) \
+        ); \
+    } while (0)
+
+// Cheap to call repeatedly with the same name, so it can be used in callbacks running on threads we don't own
+# define GLOBED_PROFILE_THREAD(name) ::util::profiler::Profiler::get().nameThisThread(name)
+
+#else
+
+# define GLOBED_PROFILE_ZONE(name) do {} while (0)
+# define GLOBED_PROFILE_INSTANT(name, arg0, arg1) do {} while (0)
+# define GLOBED_PROFILE_THREAD(name) do {} while (0)
+
+#endif
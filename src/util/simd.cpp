@@ -0,0 +1,185 @@
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <util/data.hpp>
+#include <util/misc.hpp>
+
+namespace util::simd {
+
+static constexpr uint32_t ADLER_MOD = 65521;
+static constexpr size_t ADLER_NMAX = 5552;
+
+static uint32_t adler32Scalar(const uint8_t* data, size_t len) {
+    uint32_t a = 1, b = 0;
+
+    // same as `util::crypto::adler32`, but only takes the modulo once the sums could overflow
+    while (len > 0) {
+        size_t n = std::min(len, ADLER_NMAX);
+        len -= n;
+
+        for (size_t i = 0; i < n; i++) {
+            a += data[i];
+            b += a;
+        }
+
+        data += n;
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+
+    return (b << 16) | a;
+}
+
+// `data` does not have to be aligned, byte buffers hand out pointers to arbitrary offsets
+template <typename T>
+static void byteswapScalar(T* data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        T value;
+        std::memcpy(&value, data + i, sizeof(T));
+        value = util::data::byteswap(value);
+        std::memcpy(data + i, &value, sizeof(T));
+    }
+}
+
+static void lerpScalar(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = from[i] + (to[i] - from[i]) * ratio[i];
+    }
+}
+
+static void lerpAngleScalar(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float diff = to[i] - from[i];
+        diff -= 360.f * std::nearbyint(diff / 360.f);
+        out[i] = from[i] + diff * ratio[i];
+    }
+}
+
+static void mixAddScalar(float* out, const float* in, float gain, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] += in[i] * gain;
+    }
+}
+
+static float dotScalar(const float* a, const float* b, size_t count) {
+    float sum = 0.f;
+    for (size_t i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+static void distanceScalar(const float* x, const float* y, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+    }
+}
+
+static void hermiteScalar(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float t = std::min(ratio[i], 1.f);
+        float past = ratio[i] - t;
+
+        float t2 = t * t;
+        float h01 = t2 * (3.f - 2.f * t);
+        float h10 = t * (t - 1.f) * (t - 1.f);
+        float h11 = t2 * (t - 1.f);
+
+        out[i] = from[i] + h01 * (to[i] - from[i]) + h10 * fromTangent[i] + (h11 + past) * toTangent[i];
+    }
+}
+
+// libsodium does the whole conversion
+static size_t hexEncodeScalar(const uint8_t*, size_t, char*) { return 0; }
+static size_t hexDecodeScalar(const char*, size_t, uint8_t*) { return 0; }
+static size_t base64EncodeScalar(const uint8_t*, size_t, char*, bool) { return 0; }
+static size_t base64DecodeScalar(const char*, size_t, uint8_t*, bool) { return 0; }
+
+const Kernels& scalarKernels() {
+    static const Kernels table = {
+        .name = "scalar",
+        .pcmVolume = util::misc::pcmVolumeSlow,
+        .adler32 = adler32Scalar,
+        .byteswap16 = byteswapScalar<uint16_t>,
+        .byteswap32 = byteswapScalar<uint32_t>,
+        .byteswap64 = byteswapScalar<uint64_t>,
+        .lerp = lerpScalar,
+        .lerpAngle = lerpAngleScalar,
+        .mixAdd = mixAddScalar,
+        .dot = dotScalar,
+        .distance = distanceScalar,
+        .hermite = hermiteScalar,
+        .hexEncodeBulk = hexEncodeScalar,
+        .hexDecodeBulk = hexDecodeScalar,
+        .base64EncodeBulk = base64EncodeScalar,
+        .base64DecodeBulk = base64DecodeScalar,
+    };
+
+    return table;
+}
+
+float calcPcmVolume(const float* pcm, size_t samples) {
+    return kernels().pcmVolume(pcm, samples);
+}
+
+uint32_t adler32(const uint8_t* data, size_t len) {
+    return kernels().adler32(data, len);
+}
+
+void byteswap16(uint16_t* data, size_t count) {
+    kernels().byteswap16(data, count);
+}
+
+void byteswap32(uint32_t* data, size_t count) {
+    kernels().byteswap32(data, count);
+}
+
+void byteswap64(uint64_t* data, size_t count) {
+    kernels().byteswap64(data, count);
+}
+
+void lerp(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    kernels().lerp(from, to, ratio, out, count);
+}
+
+void lerpAngle(const float* from, const float* to, const float* ratio, float* out, size_t count) {
+    kernels().lerpAngle(from, to, ratio, out, count);
+}
+
+void mixAdd(float* out, const float* in, float gain, size_t count) {
+    kernels().mixAdd(out, in, gain, count);
+}
+
+float dot(const float* a, const float* b, size_t count) {
+    return kernels().dot(a, b, count);
+}
+
+void distance(const float* x, const float* y, float* out, size_t count) {
+    kernels().distance(x, y, out, count);
+}
+
+void hermite(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count) {
+    kernels().hermite(from, to, fromTangent, toTangent, ratio, out, count);
+}
+
+size_t hexEncodeBulk(const uint8_t* src, size_t len, char* out) {
+    return kernels().hexEncodeBulk(src, len, out);
+}
+
+size_t hexDecodeBulk(const char* src, size_t len, uint8_t* out) {
+    return kernels().hexDecodeBulk(src, len, out);
+}
+
+size_t base64EncodeBulk(const uint8_t* src, size_t len, char* out, bool urlsafe) {
+    return kernels().base64EncodeBulk(src, len, out, urlsafe);
+}
+
+size_t base64DecodeBulk(const char* src, size_t len, uint8_t* out, bool urlsafe) {
+    return kernels().base64DecodeBulk(src, len, out, urlsafe);
+}
+
+}
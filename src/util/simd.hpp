@@ -5,5 +5,70 @@
 namespace util::simd {
     float calcPcmVolume(const float* pcm, size_t samples);
 
+    // Adler-32 checksum of `data`, gives the same result as `util::crypto::adler32` but much faster.
     uint32_t adler32(const uint8_t* data, size_t len);
-}
\ No newline at end of file
+
+    // Reverse the byte order of every element in place, using the fastest implementation the cpu supports.
+    // `data` may be unaligned.
+    void byteswap16(uint16_t* data, size_t count);
+    void byteswap32(uint32_t* data, size_t count);
+    void byteswap64(uint64_t* data, size_t count);
+
+    // out[i] = from[i] + (to[i] - from[i]) * ratio[i] for every element. The arrays may be unaligned.
+    void lerp(const float* from, const float* to, const float* ratio, float* out, size_t count);
+
+    // Same as `lerp`, but for angles in degrees, takes the shortest way around like `util::math::lerpAngle`
+    void lerpAngle(const float* from, const float* to, const float* ratio, float* out, size_t count);
+
+    // out[i] += in[i] * gain for every element, used for mixing audio. The arrays may be unaligned.
+    void mixAdd(float* out, const float* in, float gain, size_t count);
+
+    // Sum of a[i] * b[i] over every element, used for FIR filters. The arrays may be unaligned.
+    float dot(const float* a, const float* b, size_t count);
+
+    // out[i] = sqrt(x[i] * x[i] + y[i] * y[i]) for every element, the length of each (x, y) vector. The arrays may be unaligned.
+    void distance(const float* x, const float* y, float* out, size_t count);
+
+    // Cubic hermite interpolation from `from` to `to`, with tangents given in units of the whole segment.
+    // Ratios above 1 continue in a straight line along `toTangent`.
+    void hermite(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count);
+
+    // Bulk codecs used by `util::crypto`. Each one converts the longest prefix it can do with vector instructions
+    // and returns how much of the input it consumed, the caller is responsible for the rest (and for reporting errors).
+    // Encoders consume whole blocks of input, `out` must have room for the entire encoded input.
+    // Decoders stop at the first block with invalid characters, and never touch the last 4 characters of base64 (padding).
+    size_t hexEncodeBulk(const uint8_t* src, size_t len, char* out);
+    size_t hexDecodeBulk(const char* src, size_t len, uint8_t* out);
+    size_t base64EncodeBulk(const uint8_t* src, size_t len, char* out, bool urlsafe);
+    size_t base64DecodeBulk(const char* src, size_t len, uint8_t* out, bool urlsafe);
+
+    // Every kernel above, as picked for the current cpu. The table is resolved once, the first time any kernel is used,
+    // so calls go through a single function pointer instead of checking cpu features every time.
+    struct Kernels {
+        // widest instruction set used by the table, for logging
+        const char* name;
+
+        float (*pcmVolume)(const float* pcm, size_t samples);
+        uint32_t (*adler32)(const uint8_t* data, size_t len);
+        void (*byteswap16)(uint16_t* data, size_t count);
+        void (*byteswap32)(uint32_t* data, size_t count);
+        void (*byteswap64)(uint64_t* data, size_t count);
+        void (*lerp)(const float* from, const float* to, const float* ratio, float* out, size_t count);
+        void (*lerpAngle)(const float* from, const float* to, const float* ratio, float* out, size_t count);
+        void (*mixAdd)(float* out, const float* in, float gain, size_t count);
+        float (*dot)(const float* a, const float* b, size_t count);
+        void (*distance)(const float* x, const float* y, float* out, size_t count);
+        void (*hermite)(const float* from, const float* to, const float* fromTangent, const float* toTangent, const float* ratio, float* out, size_t count);
+        size_t (*hexEncodeBulk)(const uint8_t* src, size_t len, char* out);
+        size_t (*hexDecodeBulk)(const char* src, size_t len, uint8_t* out);
+        size_t (*base64EncodeBulk)(const uint8_t* src, size_t len, char* out, bool urlsafe);
+        size_t (*base64DecodeBulk)(const char* src, size_t len, uint8_t* out, bool urlsafe);
+    };
+
+    // Kernels for the current cpu, defined by the platform (see `platform/os/*/simd.cpp`).
+    const Kernels& kernels();
+
+    // Portable implementations of every kernel, used when the cpu lacks the instructions for a vector one, and as a baseline in benchmarks.
+    // The bulk codecs consume nothing and leave all of the input to the caller.
+    const Kernels& scalarKernels();
+}
@@ -1,12 +1,36 @@
 #include "singleton.hpp"
 
+#include <stdexcept>
+#include <vector>
+
 class singleton_use_after_dtor : public std::runtime_error {
 public:
     singleton_use_after_dtor() : std::runtime_error("attempting to use a singleton after static destruction") {}
 };
 
+namespace {
+    struct SingletonTeardown {
+        std::vector<void (*)()> steps;
+
+        ~SingletonTeardown() {
+            for (auto it = steps.rbegin(); it != steps.rend(); it++) {
+                (*it)();
+            }
+        }
+    };
+
+    SingletonTeardown& teardown() {
+        static SingletonTeardown instance;
+        return instance;
+    }
+}
+
 namespace globed {
     void destructedSingleton() {
         throw singleton_use_after_dtor();
     }
+
+    void registerSingletonTeardown(void (*step)()) {
+        teardown().steps.push_back(step);
+    }
 }
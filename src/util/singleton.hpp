@@ -4,9 +4,18 @@
 
 namespace globed {
     [[noreturn]] void destructedSingleton();
+
+    // Eagerly initialized singletons are destroyed by calling these in reverse order of registration, at static destruction.
+    void registerSingletonTeardown(void (*teardown)());
 }
 
 // there was no reason to do this other than for me to learn crtp
+//
+// Singletons come in two modes. By default the instance is a function-local static, created on first use.
+// Singletons that are called in hot paths, or that others rely on in their destructors, are instead created up front with `initialize()`
+// (see `initSingletons` in main.cpp for the order), after which `get()` is a single load of a plain pointer.
+// They are destroyed in reverse order of creation, so a singleton can use any singleton that was initialized before it,
+// including in its destructor.
 template <typename Derived>
 class SingletonBase {
 public:
@@ -18,13 +27,25 @@ public:
     SingletonBase& operator=(SingletonBase&&) = delete;
 
     static Derived& get() {
-        static Derived instance;
-
-        if (destructed) {
-            globed::destructedSingleton();
+        if (eagerInstance) [[likely]] {
+            return *eagerInstance;
         }
 
-        return instance;
+        return lazyGet();
+    }
+
+    // Must be called on the main thread, before any other thread could call `get()`.
+    // Does nothing if the singleton was already used before this, it stays lazily initialized then.
+    static void initialize() {
+        if (eagerInstance || lazyCreated) return;
+
+        // registered first, so the teardown list exists before anything the constructor creates
+        globed::registerSingletonTeardown([] {
+            delete eagerInstance;
+            eagerInstance = nullptr;
+        });
+
+        eagerInstance = new Derived();
     }
 
 protected:
@@ -34,4 +55,19 @@ protected:
     virtual ~SingletonBase() {
         destructed = true;
     }
+
+private:
+    static inline Derived* eagerInstance = nullptr;
+    static inline bool lazyCreated = false;
+
+    static Derived& lazyGet() {
+        if (destructed) {
+            globed::destructedSingleton();
+        }
+
+        static Derived instance;
+        lazyCreated = true;
+
+        return instance;
+    }
 };
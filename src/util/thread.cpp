@@ -0,0 +1,17 @@
+#include "thread.hpp"
+
+#include <defs/geode.hpp>
+
+using namespace geode::prelude;
+
+namespace util::thread {
+    void configureCurrent(Priority priority, CoreHint hint) {
+        if (auto res = setPriority(priority); !res) {
+            log::warn("Failed to set priority of thread {}: {}", geode::utils::thread::getName(), res.unwrapErr());
+        }
+
+        if (auto res = setCoreHint(hint); !res) {
+            log::warn("Failed to set core hint of thread {}: {}", geode::utils::thread::getName(), res.unwrapErr());
+        }
+    }
+}
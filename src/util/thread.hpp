@@ -0,0 +1,35 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+
+#include <util/time.hpp>
+
+namespace util::thread {
+    // Scheduling priority, mapped to the closest thing each platform has:
+    // nice values on Android, QoS classes on macOS and iOS, thread priorities on Windows.
+    enum class Priority {
+        Background,   // asset preloading and other work nobody is waiting on
+        Normal,
+        High,         // voice encoding and decoding, sending packets
+        TimeCritical, // audio callbacks and receiving packets, anything where a missed deadline is audible or visible
+    };
+
+    // Which cores a thread should prefer on CPUs that have two kinds of them (big.LITTLE, Intel hybrid).
+    enum class CoreHint {
+        Any,
+        Performance,
+        Efficiency,
+    };
+
+    // Change the priority of the calling thread. Fails if the OS refuses, for example due to missing permissions.
+    Result<> setPriority(Priority priority);
+
+    // Hint which cores the calling thread should run on. Ignored on macOS and iOS, where the QoS class decides that.
+    // Does nothing on CPUs where all cores are the same.
+    Result<> setCoreHint(CoreHint hint);
+
+    // `setPriority` and `setCoreHint`, with failures logged instead of returned. Meant to be called from `setStartFunction`.
+    void configureCurrent(Priority priority, CoreHint hint = CoreHint::Any);
+
+    // CPU time (user and kernel) the calling thread has used so far, zero if the OS can't tell
+    time::micros cpuTime();
+}
@@ -1,8 +1,53 @@
 #include "time.hpp"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
 namespace util::time {
+    void ClockSync::addSample(int64_t sent, int64_t remote, int64_t received) {
+        // a response that came before its request means the local clock went backwards, or the remote echoed garbage
+        if (received < sent) return;
+
+        // assume the remote time was taken halfway through the round trip
+        Sample sample {
+            .offset = remote - (sent + (received - sent) / 2),
+            .roundTrip = received - sent,
+        };
+
+        samples[head] = sample;
+        head = (head + 1) % WINDOW;
+        count = std::min(count + 1, WINDOW);
+        total++;
+
+        best = samples[0];
+        for (size_t i = 1; i < count; i++) {
+            if (samples[i].roundTrip < best.roundTrip) best = samples[i];
+        }
+    }
+
+    void ClockSync::reset() {
+        head = 0;
+        count = 0;
+        total = 0;
+        best = {};
+    }
+
+    size_t ClockSync::sampleCount() const {
+        return total;
+    }
+
+    bool ClockSync::synced() const {
+        return count > 0;
+    }
+
+    int64_t ClockSync::offset() const {
+        return best.offset;
+    }
+
+    int64_t ClockSync::roundTrip() const {
+        return best.roundTrip;
+    }
+
     std::string nowPretty() {
         auto time = chrono::system_clock::now();
         std::time_t curTime = chrono::system_clock::to_time_t(time);
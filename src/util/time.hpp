@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include <chrono>
+#include <cstdint>
 
 namespace chrono = std::chrono;
 
@@ -55,6 +57,103 @@ namespace util::time {
         return as<micros>(now().time_since_epoch());
     }
 
+    // Fires at a fixed rate according to a clock in seconds (e.g. `NetworkManager::serverTime`), independent of how often it is polled.
+    // Falling behind by more than a full interval (e.g. a long frame) resyncs instead of firing a burst of late ticks,
+    // and so does the clock jumping backwards (e.g. a new server time offset after reconnecting).
+    class FixedTimestep {
+    public:
+        FixedTimestep(double interval = 0.0) : interval(interval) {}
+
+        void setInterval(double newInterval) {
+            interval = newInterval;
+        }
+
+        double getInterval() const {
+            return interval;
+        }
+
+        // Returns `true` if a tick is due at `now`, and schedules the next one
+        bool poll(double now) {
+            // otherwise the next tick would be as far in the future as the clock went back
+            if (now < next - interval) {
+                next = now + interval;
+                return true;
+            }
+
+            if (now < next) return false;
+
+            next += interval;
+            if (now - next >= interval) {
+                next = now + interval;
+            }
+
+            return true;
+        }
+
+    private:
+        double interval;
+        double next = 0.0;
+    };
+
+    // One `FixedTimestep` for each value of `Key`, an enum that ends with `Count`. Periodic tasks that share a clock
+    // are all polled with the time read once, instead of each keeping its own timer or reading the clock again.
+    template <typename Key>
+    class FixedTimestepTable {
+    public:
+        static constexpr size_t SIZE = static_cast<size_t>(Key::Count);
+
+        void setInterval(Key key, double interval) {
+            timers[static_cast<size_t>(key)].setInterval(interval);
+        }
+
+        double getInterval(Key key) const {
+            return timers[static_cast<size_t>(key)].getInterval();
+        }
+
+        bool poll(Key key, double now) {
+            return timers[static_cast<size_t>(key)].poll(now);
+        }
+
+    private:
+        std::array<FixedTimestep, SIZE> timers;
+    };
+
+    // Microseconds on the steady clock, this is the local side of `ClockSync`
+    inline int64_t monotonicMicros() {
+        return as<micros>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Estimates how far a remote clock is ahead of `monotonicMicros`, from request/response exchanges like NTP does.
+    // Out of the last few exchanges the one with the shortest round trip is trusted, it spent the least time in queues
+    // so there was the least room for the two directions to take a different amount of time.
+    class ClockSync {
+    public:
+        // `sent` and `received` are the local times of the request and the response, `remote` is the remote time in the response
+        void addSample(int64_t sent, int64_t remote, int64_t received);
+        void reset();
+
+        size_t sampleCount() const;
+        bool synced() const;
+
+        // remote minus local, in microseconds
+        int64_t offset() const;
+        // round trip of the exchange the offset came from, in microseconds
+        int64_t roundTrip() const;
+
+    private:
+        struct Sample {
+            int64_t offset;
+            int64_t roundTrip;
+        };
+
+        // drift between the two clocks is a few ms per minute at worst, so the window has to stay short
+        static constexpr size_t WINDOW = 8;
+
+        std::array<Sample, WINDOW> samples{};
+        size_t head = 0, count = 0, total = 0;
+        Sample best{};
+    };
+
     std::string nowPretty();
 
     bool isAprilFools();
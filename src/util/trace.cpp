@@ -0,0 +1,146 @@
+#include "trace.hpp"
+
+#ifdef GLOBED_PROFILER
+
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <util/format.hpp>
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+// how often events are moved out of the profiler rings, well below the time it takes to fill one
+static constexpr float COLLECT_INTERVAL = 0.5f;
+
+// zone and thread names are known strings, but escape them anyway so a stray quote can't break the file
+static std::string jsonString(std::string_view str) {
+    std::string out;
+    out.reserve(str.size() + 2);
+    out.push_back('"');
+
+    for (char c : str) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+
+    out.push_back('"');
+    return out;
+}
+
+namespace util::profiler {
+    void TraceRecorder::start() {
+        if (started) return;
+        started = true;
+
+        CCScheduler::get()->scheduleSelector(schedule_selector(TraceRecorder::update), this, COLLECT_INTERVAL, false);
+    }
+
+    void TraceRecorder::update(float) {
+        this->collect();
+    }
+
+    void TraceRecorder::collect() {
+        Profiler::get().collect([this](const ThreadRing& ring, const ZoneEvent& event) {
+            events.push_back(TraceEvent { &ring, event });
+        });
+
+        // rings are drained one after another, so the deque is only roughly sorted, `dump` filters by time again
+        auto cutoff = clock::now() - WINDOW;
+        while (!events.empty() && (events.front().event.end < cutoff || events.size() > MAX_EVENTS)) {
+            events.pop_front();
+        }
+    }
+
+    Result<std::filesystem::path> TraceRecorder::dump(std::chrono::seconds last) {
+        this->collect();
+
+        auto folder = Mod::get()->getSaveDir() / "traces";
+        (void) geode::utils::file::createDirectoryAll(folder);
+
+        auto datetime = util::format::formatDateTime(util::time::systemNow());
+        auto filepath = folder / fmt::format("trace-{}.json", datetime);
+
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return Err(fmt::format("failed to open {}", filepath));
+        }
+
+        auto& profiler = Profiler::get();
+        auto cutoff = clock::now() - last;
+
+        auto origin = clock::time_point::max();
+        for (const auto& te : events) {
+            if (te.event.end >= cutoff) origin = std::min(origin, te.event.start);
+        }
+
+        auto micros = [&](clock::duration dur) {
+            return std::chrono::duration<double, std::micro>(dur).count();
+        };
+
+        std::unordered_map<uint32_t, std::string> names;
+        std::unordered_set<const ThreadRing*> threads;
+        bool first = true;
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        auto separator = [&] {
+            if (!first) file << ",\n";
+            first = false;
+        };
+
+        for (const auto& te : events) {
+            const auto& event = te.event;
+            if (event.end < cutoff) continue;
+
+            auto it = names.find(event.zoneId);
+            if (it == names.end()) {
+                it = names.emplace(event.zoneId, jsonString(profiler.zoneName(event.zoneId))).first;
+            }
+
+            if (threads.insert(te.ring).second) {
+                separator();
+                file << fmt::format(
+                    "{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":{}}}}}",
+                    te.ring->index, jsonString(te.ring->name)
+                );
+            }
+
+            separator();
+            if (event.instant) {
+                file << fmt::format(
+                    "{{\"ph\":\"i\",\"s\":\"t\",\"name\":{},\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"args\":{{\"arg0\":{},\"arg1\":{}}}}}",
+                    it->second, te.ring->index, micros(event.start - origin), event.arg0, event.arg1
+                );
+            } else {
+                file << fmt::format(
+                    "{{\"ph\":\"X\",\"name\":{},\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    it->second, te.ring->index, micros(event.start - origin), micros(event.end - event.start)
+                );
+            }
+        }
+
+        file << "]}\n";
+        file.close();
+
+        if (file.fail()) {
+            return Err(fmt::format("failed to write {}", filepath));
+        }
+
+        log::info("Wrote trace of the last {} to {}", util::format::formatDuration(last), filepath);
+
+        return Ok(filepath);
+    }
+}
+
+#endif // GLOBED_PROFILER
@@ -0,0 +1,51 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#include <deque>
+#include <filesystem>
+
+#include <util/profiler.hpp>
+#include <util/singleton.hpp>
+
+// Keeps the last `WINDOW` of profiler events around and writes them out in the Chrome trace event format,
+// which can be opened in https://ui.perfetto.dev or chrome://tracing. Every thread gets its own track.
+//
+// Like the profiler itself, this only exists when `GLOBED_PROFILER` is defined.
+
+#ifdef GLOBED_PROFILER
+
+namespace util::profiler {
+    class TraceRecorder : public cocos2d::CCObject, public SingletonBase<TraceRecorder> {
+    protected:
+        friend class SingletonBase;
+        TraceRecorder() = default;
+
+    public:
+        static constexpr auto WINDOW = std::chrono::seconds(30);
+        // upper bound on buffered events, in case something records far more than expected
+        static constexpr size_t MAX_EVENTS = 512 * 1024;
+
+        // Starts draining the profiler on the main thread periodically, so events don't get lost while the overlay is closed
+        void start();
+
+        // Drains the profiler, works like `Profiler::collect` but keeps the events for `dump`
+        void collect();
+
+        // Writes the events of the last `last` seconds into a new file in the `traces` folder, returns its path
+        Result<std::filesystem::path> dump(std::chrono::seconds last = WINDOW);
+
+    private:
+        struct TraceEvent {
+            // rings are never destroyed, so this stays valid
+            const ThreadRing* ring;
+            ZoneEvent event;
+        };
+
+        std::deque<TraceEvent> events;
+        bool started = false;
+
+        void update(float);
+    };
+}
+
+#endif // GLOBED_PROFILER
@@ -132,18 +132,22 @@ namespace util::ui {
     }
 
     void tryLoadDeathEffect(int id) {
-        if (id <= 1) return;
+        if (isDeathEffectLoaded(id)) return;
 
-        auto textureCache = CCTextureCache::sharedTextureCache();
-        auto sfCache  = CCSpriteFrameCache::sharedSpriteFrameCache();
+        auto sheet = deathEffectSheet(id);
+        CCTextureCache::sharedTextureCache()->addImage(fmt::format("{}.png", sheet).c_str(), false);
+        CCSpriteFrameCache::sharedSpriteFrameCache()->addSpriteFramesWithFile(fmt::format("{}.plist", sheet).c_str());
+    }
 
-        auto pngKey = fmt::format("PlayerExplosion_{:02}.png", id - 1);
-        auto plistKey = fmt::format("PlayerExplosion_{:02}.plist", id - 1);
+    bool isDeathEffectLoaded(int id) {
+        if (id <= 1) return true;
 
-        if (textureCache->textureForKey(pngKey.c_str()) == nullptr) {
-            textureCache->addImage(pngKey.c_str(), false);
-            sfCache->addSpriteFramesWithFile(plistKey.c_str());
-        }
+        auto pngKey = fmt::format("{}.png", deathEffectSheet(id));
+        return CCTextureCache::sharedTextureCache()->textureForKey(pngKey.c_str()) != nullptr;
+    }
+
+    std::string deathEffectSheet(int id) {
+        return fmt::format("PlayerExplosion_{:02}", id - 1);
     }
 
     static PopupLayout popupLayoutWith(const CCSize& popupSize, bool useWinSize) {
@@ -215,32 +219,28 @@ namespace util::ui {
         return spr1;
     }
 
-    static ComputedRole compute(const SpecialUserData& data) {
-        return RoleManager::get().compute(data.roles.value());
+    static const RoleManager::DisplayRole& display(const SpecialUserData& data) {
+        return RoleManager::get().getDisplay(data.roles.value());
     }
 
     CCSprite* createBadgeIfSpecial(const SpecialUserData& data) {
         if (!data.roles) return nullptr;
 
-        return createBadge(compute(data).badgeIcon);
+        // the frame was checked when it got cached, but the texture may have been unloaded since
+        auto spr = CCSprite::createWithSpriteFrameName(display(data).badgeFrame.c_str());
+        return spr ? spr : createBadge("");
     }
 
     ccColor3B getNameColor(const SpecialUserData& data) {
         if (!data.roles) return ccc3(255, 255, 255);
 
-        auto computed = compute(data);
-        if (computed.nameColor) return computed.nameColor->getAnyColor();
-
-        return ccc3(255, 255, 255);
+        return display(data).nameColor.getAnyColor();
     }
 
     RichColor getNameRichColor(const SpecialUserData& data) {
         if (!data.roles) return RichColor(ccc3(255, 255, 255));
 
-        auto computed = compute(data);
-        if (computed.nameColor) return computed.nameColor.value();
-
-        return RichColor(ccc3(255, 255, 255));
+        return display(data).nameColor;
     }
 
     void animateLabelColorTint(cocos2d::CCLabelBMFont* label, const RichColor& color) {
@@ -43,8 +43,15 @@ namespace util::ui {
     // scrolls to the top of the scroll layer
     void scrollToTop(geode::ScrollLayer* listView);
 
+    // Synchronously loads the sheet of a death effect, if it isn't loaded yet
     void tryLoadDeathEffect(int id);
 
+    // Whether the sheet of a death effect is loaded, the default effects have none
+    bool isDeathEffectLoaded(int id);
+
+    // Sheet name of a death effect without the extension (like `PlayerExplosion_01`)
+    std::string deathEffectSheet(int id);
+
     // small wrapper with precalculated sizes to make ui easier
     struct PopupLayout {
         cocos2d::CCSize winSize, popupSize;